@@ -444,6 +444,22 @@ void update_scene_bvh(scene_bvh& sbvh, const scene_data& scene,
   refit_bvh(sbvh.bvh, bboxes);
 }
 
+void rebuild_scene_bvh(
+    scene_bvh& sbvh, const scene_data& scene, bool highquality) {
+  // instance bboxes
+  auto bboxes = vector<bbox3f>(scene.instances.size());
+  for (auto idx : range(bboxes.size())) {
+    auto& instance = scene.instances[idx];
+    bboxes[idx]    = sbvh.shapes[instance.shape].bvh.nodes.empty()
+                         ? invalidb3f
+                         : transform_bbox(instance.frame,
+                               sbvh.shapes[instance.shape].bvh.nodes[0].bbox);
+  }
+
+  // build nodes
+  sbvh.bvh = make_bvh(bboxes, highquality);
+}
+
 }  // namespace yocto
 
 // -----------------------------------------------------------------------------
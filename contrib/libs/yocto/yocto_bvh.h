@@ -83,6 +83,10 @@ scene_bvh make_scene_bvh(
 void update_shape_bvh(shape_bvh& bvh, const shape_data& shape);
 void update_scene_bvh(scene_bvh& bvh, const scene_data& scene,
     const vector<int>& updated_instances, const vector<int>& updated_shapes);
+// Rebuild the instance bvh after instances were added or removed - the shape
+// bvhs must already match the scene shapes and are not touched
+void rebuild_scene_bvh(
+    scene_bvh& bvh, const scene_data& scene, bool highquality = false);
 
 // Results of intersect_xxx and overlap_xxx functions that include hit flag,
 // instance id, shape element id, shape element uv and intersection distance.
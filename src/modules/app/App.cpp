@@ -13,11 +13,13 @@
 #include "core/Log.h"
 #include "core/StringUtil.h"
 #include "core/Tokenizer.h"
+#include "core/TraceRecorder.h"
 #include "core/Var.h"
 #include "core/concurrent/ThreadPool.h"
 #include "app/I18N.h"
 #include "engine-config.h"
 #include "http/Request.h"
+#include "io/FileStream.h"
 #include "io/Filesystem.h"
 #include "io/StdoutWriteStream.h"
 #include "io/BufferedReadWriteStream.h"
@@ -710,6 +712,14 @@ AppState App::onConstruct() {
 	core::Var::registerVar(metricFlavor);
 	Log::init();
 
+	const core::VarDef coreTraceFile(cfg::CoreTraceFile, "", N_("Trace file"),
+									 N_("Record the trace zones of all threads and write them as chrome trace json to "
+										"this file on shutdown. If empty, the recorder is disabled."),
+									 core::CV_NOPERSIST);
+	if (!core::Var::registerVar(coreTraceFile)->strVal().empty()) {
+		core::traceRecorderStart();
+	}
+
 	command::Command::registerCommand("i18nlist")
 		.setHandler([&](const command::CommandArgs &args) {
 			_dict->foreach([](const core::String &key, const Dictionary::Entries::value_type &value) {
@@ -756,6 +766,23 @@ AppState App::onConstruct() {
 			requestQuit();
 		}).setHelp(_("Quit the application"));
 
+	command::Command::registerCommand("trace_dump")
+		.addArg({"file", command::ArgType::String, true, "", "The json file - defaults to the value of core_tracefile"})
+		.setHandler([this](const command::CommandArgs &args) {
+			core::String filename = args.str("file");
+			if (filename.empty()) {
+				filename = core::getVar(cfg::CoreTraceFile)->strVal();
+			}
+			if (filename.empty()) {
+				Log::error("No trace file given");
+				return;
+			}
+			if (!core::traceRecorderActive()) {
+				Log::warn("The trace recorder is not active - set %s at startup", cfg::CoreTraceFile);
+			}
+			dumpTrace(filename);
+		}).setHelp(_("Write the recorded trace events as chrome trace json"));
+
 #ifdef DEBUG
 	command::Command::registerCommand("assert")
 		.setHandler([&](const command::CommandArgs &args) {
@@ -1689,6 +1716,23 @@ App::Argument &App::registerArg(const core::String &arg) {
 	return _arguments.back();
 }
 
+bool App::dumpTrace(const core::String &filename) const {
+	const io::FilePtr &file = _filesystem->open(filename, io::FileMode::SysWrite);
+	io::FileStream stream(file);
+	if (!stream.valid()) {
+		Log::error("Failed to open trace file %s", filename.c_str());
+		return false;
+	}
+	if (!core::traceRecorderDump([&stream](const char *data, size_t size) {
+			return stream.write(data, size) == (int)size;
+		})) {
+		Log::error("Failed to write trace file %s", filename.c_str());
+		return false;
+	}
+	Log::info("Wrote trace to %s", file->name().c_str());
+	return true;
+}
+
 bool App::saveConfiguration() {
 	if (_organisation.empty() || _appname.empty()) {
 		Log::debug("don't save the config variables because organisation or appname is missing");
@@ -1751,6 +1795,11 @@ AppState App::onCleanup() {
 
 	_threadPool->shutdown();
 
+	if (core::traceRecorderActive()) {
+		core::traceRecorderStop();
+		dumpTrace(core::getVar(cfg::CoreTraceFile)->strVal());
+	}
+
 	command::Command::shutdown();
 	core::Var::shutdown();
 
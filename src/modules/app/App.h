@@ -209,6 +209,11 @@ public:
 	void remBlocker(AppState blockedState);
 
 	bool saveConfiguration();
+	/**
+	 * @brief Write the events of the trace recorder as chrome trace json
+	 * @sa core/TraceRecorder.h
+	 */
+	bool dumpTrace(const core::String &filename) const;
 
 	/**
 	 * @brief Returns the current used process memory in GB
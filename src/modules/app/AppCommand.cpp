@@ -5,6 +5,7 @@
 #include "AppCommand.h"
 #include "command/Command.h"
 #include "command/CommandCompleter.h"
+#include "core/MemoryAccounting.h"
 #include "core/StringUtil.h"
 #include "io/Filesystem.h"
 #include "util/VarUtil.h"
@@ -192,6 +193,52 @@ void init(const core::TimeProviderPtr& timeProvider) {
 			}, 0u);
 		}).setHelp(_("Show the list of known variables (wildcards supported)"));
 
+	command::Command::registerCommand("memstats")
+		.addArg({"tag", command::ArgType::String, true, "", "Print the allocation size histogram of this tag"})
+		.setHandler([timeProvider] (const command::CommandArgs& args) {
+			core::MemoryStats stats;
+			core::memoryStats(stats);
+			if (!stats.enabled) {
+				Log::info("Memory accounting is not available - build with USE_MEMORY_ACCOUNTING");
+				return;
+			}
+			// the allocation rate is measured between two calls
+			static int64_t lastAllocations = 0;
+			static uint64_t lastMillis = 0;
+			const uint64_t millis = timeProvider->tickNow();
+			if (lastMillis != 0 && millis > lastMillis) {
+				const double seconds = (double)(millis - lastMillis) / 1000.0;
+				Log::info("%.1f allocations/s in the last %.1fs", (double)(stats.total.allocations - lastAllocations) / seconds, seconds);
+			}
+			lastAllocations = stats.total.allocations;
+			lastMillis = millis;
+
+			const core::String &tagName = args.str("tag");
+			Log::info("%-20s %12s %12s %14s %14s", "tag", "live", "peak", "allocations", "frees");
+			auto print = [&] (const core::MemoryTagStats &tag) {
+				Log::info("%-20s %12s %12s %14" PRId64 " %14" PRId64, tag.name,
+						  core::string::humanSize(core_max(tag.liveBytes(), (int64_t)0)).c_str(),
+						  core::string::humanSize(tag.peakBytes).c_str(), tag.allocations, tag.frees);
+				if (tagName != tag.name) {
+					return;
+				}
+				for (int i = 0; i < core::MemoryHistogramBuckets; ++i) {
+					if (tag.histogram[i] == 0) {
+						continue;
+					}
+					if (i == core::MemoryHistogramBuckets - 1) {
+						Log::info("    > %10s: %" PRId64, core::string::humanSize((uint64_t)1 << (i + 3)).c_str(), tag.histogram[i]);
+					} else {
+						Log::info("   <= %10s: %" PRId64, core::string::humanSize((uint64_t)1 << (i + 4)).c_str(), tag.histogram[i]);
+					}
+				}
+			};
+			for (const core::MemoryTagStats &tag : stats.tags) {
+				print(tag);
+			}
+			print(stats.total);
+		}).setHelp(_("Show the memory statistics of the tagged subsystems"));
+
 	command::Command::registerCommand("cmdlist")
 		.addArg({"filter", command::ArgType::String, true, "", "Filter pattern (wildcards supported)"})
 		.setHandler([] (const command::CommandArgs& args) {
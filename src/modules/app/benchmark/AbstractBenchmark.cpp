@@ -4,6 +4,7 @@
 
 #include "AbstractBenchmark.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/Var.h"
 #include "command/Command.h"
 #include "io/Filesystem.h"
@@ -20,9 +21,28 @@ void AbstractBenchmark::SetUp(benchmark::State& st) {
 	const io::FilesystemPtr filesystem = core::make_shared<io::Filesystem>();
 	const core::TimeProviderPtr timeProvider = core::make_shared<core::TimeProvider>();
 	_benchmarkApp = new BenchmarkApp(filesystem, timeProvider, this, _threadPoolSize);
+	resetMemoryCounters();
+}
+
+void AbstractBenchmark::resetMemoryCounters() {
+	core::MemoryStats stats;
+	core::memoryStats(stats);
+	core::memoryResetPeak();
+	_allocations = stats.total.allocations;
+	_allocatedBytes = stats.total.allocatedBytes;
+	_liveBytes = stats.total.liveBytes();
 }
 
 void AbstractBenchmark::TearDown(benchmark::State& st) {
+	core::MemoryStats stats;
+	core::memoryStats(stats);
+	if (stats.enabled && st.iterations() > 0) {
+		const double iterations = (double)st.iterations();
+		st.counters["allocs_per_iter"] = (double)(stats.total.allocations - _allocations) / iterations;
+		st.counters["alloc_bytes_per_iter"] = (double)(stats.total.allocatedBytes - _allocatedBytes) / iterations;
+		st.counters["peak_heap_growth_mib"] = (double)(stats.total.peakBytes - _liveBytes) / (1024.0 * 1024.0);
+	}
+
 	// prevent cvars from begin saved and reloaded for the next fiture in the test
 	core::Var::shutdown();
 	delete _benchmarkApp;
@@ -41,6 +61,12 @@ AbstractBenchmark::BenchmarkApp::BenchmarkApp(const io::FilesystemPtr &filesyste
 	}
 }
 
+AppState AbstractBenchmark::BenchmarkApp::onRunning() {
+	Super::onRunning();
+	// stay in the running state - otherwise the code under benchmark sees a shutdown request
+	return AppState::Running;
+}
+
 AppState AbstractBenchmark::BenchmarkApp::onCleanup() {
 	_benchmark->onCleanupApp();
 	return Super::onCleanup();
@@ -60,6 +86,7 @@ AppState AbstractBenchmark::BenchmarkApp::onInit() {
 }
 
 AbstractBenchmark::BenchmarkApp::~BenchmarkApp() {
+	requestQuit();
 	while (AppState::InvalidAppState != _curState) {
 		core_trace_scoped(AppMainLoop);
 		onFrame();
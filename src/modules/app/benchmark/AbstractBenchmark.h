@@ -14,6 +14,10 @@ namespace app {
 class AbstractBenchmark : public benchmark::Fixture {
 private:
 	int _threadPoolSize;
+	// the memory counters when the benchmark case started
+	int64_t _allocations = 0;
+	int64_t _allocatedBytes = 0;
+	int64_t _liveBytes = 0;
 	class BenchmarkApp: public app::CommandlineApp {
 		friend class AbstractBenchmark;
 	protected:
@@ -25,12 +29,19 @@ private:
 		virtual ~BenchmarkApp();
 
 		virtual app::AppState onInit() override;
+		virtual app::AppState onRunning() override;
 		virtual app::AppState onCleanup() override;
 	};
 
 protected:
 	BenchmarkApp *_benchmarkApp = nullptr;
 
+	/**
+	 * @brief Start the memory counters of the benchmark case again - call this after preparing data in @c SetUp()
+	 * that should not be counted as allocations of the benchmark
+	 */
+	void resetMemoryCounters();
+
 	virtual void onCleanupApp() {
 	}
 
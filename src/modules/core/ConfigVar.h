@@ -77,6 +77,8 @@ constexpr const char *CoreLogLevel = "core_loglevel";
 constexpr const char *CorePath = "core_path";
 constexpr const char *CoreColorReduction = "core_colorreduction";
 constexpr const char *CoreLanguage = "core_language";
+// Record the trace zones and write them as chrome trace json to this file on shutdown
+constexpr const char *CoreTraceFile = "core_tracefile";
 
 constexpr const char *AppPipe = "app_pipe";
 constexpr const char *AppHomePath = "app_homepath";
@@ -88,6 +90,7 @@ constexpr const char *MetricHost = "metric_host";
 constexpr const char *MetricJsonUrl = "metric_json_url";
 constexpr const char *MetricFlavor = "metric_flavor";
 constexpr const char *MetricUUID = "metric_uuid";
+constexpr const char *MetricFlushInterval = "metric_flushinterval";
 
 constexpr const char *VoxelPalette = "palette";
 constexpr const char *NormalPalette = "normalpalette";
@@ -140,6 +143,7 @@ constexpr const char *VoxformatQBSaveLeftHanded = "voxformat_qbsavelefthanded";
 constexpr const char *VoxformatQBSaveCompressed = "voxformat_qbsavecompressed";
 constexpr const char *VoxformatGLTF_KHR_materials_pbrSpecularGlossiness = "voxformat_gltf_khr_materials_pbrspecularglossiness";
 constexpr const char *VoxformatGLTF_KHR_materials_specular = "voxformat_gltf_khr_materials_specular";
+constexpr const char *VoxformatGLTFStreaming = "voxformat_gltf_streaming";
 constexpr const char *VoxformatImageVolumeMaxDepth = "voxformat_imagevolumemaxdepth";
 constexpr const char *VoxformatImageHeightmapMinHeight = "voxformat_imageheightmapminheight";
 constexpr const char *VoxformatImageVolumeBothSides = "voxformat_imagevolumebothsides";
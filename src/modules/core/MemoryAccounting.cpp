@@ -0,0 +1,297 @@
+/**
+ * @file
+ */
+
+#include "MemoryAccounting.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_bits.h>
+#include <SDL3/SDL_stdinc.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define core_usable_size(ptr) _msize(ptr)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define core_usable_size(ptr) malloc_size(ptr)
+#elif defined(__linux__) || defined(__EMSCRIPTEN__) || defined(__FreeBSD__)
+#include <malloc.h>
+#define core_usable_size(ptr) malloc_usable_size(ptr)
+#endif
+
+namespace core {
+
+namespace {
+
+// the live bytes of a thread are published to the shared peak counters once they changed by this amount
+static constexpr int64_t PeakFlushBytes = 64 * 1024;
+
+/**
+ * @brief The counters of one thread - only written by the thread that owns them
+ *
+ * The blocks are never freed - the block of a thread that exited is reused by the next new thread. They are
+ * allocated with the c runtime to not account the accounting itself.
+ */
+struct ThreadCounters {
+	int64_t allocations[MemoryMaxTags];
+	int64_t frees[MemoryMaxTags];
+	int64_t allocatedBytes[MemoryMaxTags];
+	int64_t freedBytes[MemoryMaxTags];
+	int64_t histogram[MemoryMaxTags][MemoryHistogramBuckets];
+	/** the live bytes that were not yet published to the peak counters - the last entry is the total */
+	int64_t pending[MemoryMaxTags + 1];
+	SDL_AtomicInt used;
+	ThreadCounters *next;
+};
+
+// all of these are zero initialized before any static constructor runs - allocations happen during static init
+static void *_threads;
+static SDL_SpinLock _tagsLock;
+static const char *_tags[MemoryMaxTags];
+static int _tagCount;
+// the published live and peak KiB - the last entry is the total
+static SDL_AtomicInt _liveKiB[MemoryMaxTags + 1];
+static SDL_AtomicInt _peakKiB[MemoryMaxTags + 1];
+
+static thread_local ThreadCounters *_counters = nullptr;
+static thread_local int _tag = 0;
+
+struct ThreadCountersRelease {
+	~ThreadCountersRelease() {
+		if (_counters != nullptr) {
+			SDL_SetAtomicInt(&_counters->used, 0);
+		}
+	}
+};
+
+static ThreadCounters *acquireCounters() {
+	for (ThreadCounters *c = (ThreadCounters *)SDL_GetAtomicPointer(&_threads); c != nullptr; c = c->next) {
+		if (SDL_CompareAndSwapAtomicInt(&c->used, 0, 1)) {
+			return c;
+		}
+	}
+	ThreadCounters *c = (ThreadCounters *)calloc(1, sizeof(ThreadCounters));
+	if (c == nullptr) {
+		return nullptr;
+	}
+	SDL_SetAtomicInt(&c->used, 1);
+	void *head;
+	do {
+		head = SDL_GetAtomicPointer(&_threads);
+		c->next = (ThreadCounters *)head;
+	} while (!SDL_CompareAndSwapAtomicPointer(&_threads, head, c));
+	return c;
+}
+
+static void registerRelease() {
+	// registering the destructor might allocate - that is not attributed to the scope that caused it
+	const int tag = _tag;
+	_tag = 0;
+	static thread_local ThreadCountersRelease release;
+	(void)release;
+	_tag = tag;
+}
+
+inline ThreadCounters *counters() {
+	if (_counters == nullptr) {
+		_counters = acquireCounters();
+		if (_counters != nullptr) {
+			registerRelease();
+		}
+	}
+	return _counters;
+}
+
+inline int histogramBucket(size_t size) {
+	if (size <= 16u) {
+		return 0;
+	}
+	if (size > ((size_t)1 << (MemoryHistogramBuckets + 2))) {
+		return MemoryHistogramBuckets - 1;
+	}
+	// the index of the next power of two minus the first bucket (16 bytes)
+	return SDL_MostSignificantBitIndex32((uint32_t)(size - 1u)) + 1 - 4;
+}
+
+static void publish(int idx, int64_t &pending) {
+	const int kib = (int)(pending / 1024);
+	pending -= (int64_t)kib * 1024;
+	const int live = SDL_AddAtomicInt(&_liveKiB[idx], kib) + kib;
+	int peak = SDL_GetAtomicInt(&_peakKiB[idx]);
+	while (live > peak && !SDL_CompareAndSwapAtomicInt(&_peakKiB[idx], peak, live)) {
+		peak = SDL_GetAtomicInt(&_peakKiB[idx]);
+	}
+}
+
+inline void changeLive(ThreadCounters *c, int tag, int64_t bytes) {
+	int64_t &pending = c->pending[tag];
+	pending += bytes;
+	if (pending >= PeakFlushBytes || pending <= -PeakFlushBytes) {
+		publish(tag, pending);
+	}
+	int64_t &total = c->pending[MemoryMaxTags];
+	total += bytes;
+	if (total >= PeakFlushBytes || total <= -PeakFlushBytes) {
+		publish(MemoryMaxTags, total);
+	}
+}
+
+inline void accountAlloc(void *ptr) {
+#ifdef core_usable_size
+	ThreadCounters *c = counters();
+	if (c == nullptr) {
+		return;
+	}
+	const size_t size = core_usable_size(ptr);
+	const int tag = _tag;
+	++c->allocations[tag];
+	c->allocatedBytes[tag] += (int64_t)size;
+	++c->histogram[tag][histogramBucket(size)];
+	changeLive(c, tag, (int64_t)size);
+#else
+	(void)ptr;
+#endif
+}
+
+inline void accountFree(void *ptr) {
+#ifdef core_usable_size
+	ThreadCounters *c = counters();
+	if (c == nullptr) {
+		return;
+	}
+	const size_t size = core_usable_size(ptr);
+	const int tag = _tag;
+	++c->frees[tag];
+	c->freedBytes[tag] += (int64_t)size;
+	changeLive(c, tag, -(int64_t)size);
+#else
+	(void)ptr;
+#endif
+}
+
+} // namespace
+
+void *accountedMalloc(size_t size) {
+	void *ptr = SDL_malloc(size);
+	if (ptr != nullptr) {
+		accountAlloc(ptr);
+	}
+	return ptr;
+}
+
+void *accountedRealloc(void *ptr, size_t size) {
+	if (ptr == nullptr) {
+		return accountedMalloc(size);
+	}
+	// the old block must be measured before it is released
+	accountFree(ptr);
+	void *newPtr = SDL_realloc(ptr, size);
+	// on failure the old block is still valid
+	accountAlloc(newPtr != nullptr ? newPtr : ptr);
+	return newPtr;
+}
+
+void accountedFree(void *ptr) {
+	if (ptr == nullptr) {
+		return;
+	}
+	accountFree(ptr);
+	SDL_free(ptr);
+}
+
+char *accountedStrdup(const char *str) {
+	const size_t len = SDL_strlen(str) + 1;
+	char *copy = (char *)accountedMalloc(len);
+	if (copy != nullptr) {
+		SDL_memcpy(copy, str, len);
+	}
+	return copy;
+}
+
+int memoryTagId(const char *name) {
+	SDL_LockSpinlock(&_tagsLock);
+	if (_tagCount == 0) {
+		_tags[_tagCount++] = "untagged";
+	}
+	int id = 0;
+	for (int i = 1; i < _tagCount; ++i) {
+		if (SDL_strcmp(_tags[i], name) == 0) {
+			id = i;
+			break;
+		}
+	}
+	if (id == 0 && _tagCount < MemoryMaxTags) {
+		id = _tagCount;
+		_tags[_tagCount++] = name;
+	}
+	SDL_UnlockSpinlock(&_tagsLock);
+	return id;
+}
+
+static void addCounters(MemoryTagStats &stats, const ThreadCounters *c, int tag) {
+	// the counters of the other threads are read while they are written - they are aligned 64 bit values and each
+	// one is consistent on its own
+	stats.allocations += c->allocations[tag];
+	stats.frees += c->frees[tag];
+	stats.allocatedBytes += c->allocatedBytes[tag];
+	stats.freedBytes += c->freedBytes[tag];
+	for (int i = 0; i < MemoryHistogramBuckets; ++i) {
+		stats.histogram[i] += c->histogram[tag][i];
+	}
+}
+
+void memoryStats(MemoryStats &stats) {
+#ifdef core_usable_size
+	stats.enabled = CORE_MEMORY_ACCOUNTING != 0;
+#else
+	stats.enabled = false;
+#endif
+	SDL_LockSpinlock(&_tagsLock);
+	if (_tagCount == 0) {
+		_tags[_tagCount++] = "untagged";
+	}
+	const int tagCount = _tagCount;
+	SDL_UnlockSpinlock(&_tagsLock);
+
+	stats.total = MemoryTagStats();
+	stats.total.name = "total";
+	stats.tags.clear();
+	stats.tags.resize(tagCount);
+	for (int tag = 0; tag < tagCount; ++tag) {
+		MemoryTagStats &tagStats = stats.tags[tag];
+		tagStats = MemoryTagStats();
+		tagStats.name = _tags[tag];
+		for (const ThreadCounters *c = (const ThreadCounters *)SDL_GetAtomicPointer(&_threads); c != nullptr;
+			 c = c->next) {
+			addCounters(tagStats, c, tag);
+		}
+		tagStats.peakBytes = core_max(tagStats.liveBytes(), (int64_t)SDL_GetAtomicInt(&_peakKiB[tag]) * 1024);
+		stats.total.allocations += tagStats.allocations;
+		stats.total.frees += tagStats.frees;
+		stats.total.allocatedBytes += tagStats.allocatedBytes;
+		stats.total.freedBytes += tagStats.freedBytes;
+		for (int i = 0; i < MemoryHistogramBuckets; ++i) {
+			stats.total.histogram[i] += tagStats.histogram[i];
+		}
+	}
+	stats.total.peakBytes =
+		core_max(stats.total.liveBytes(), (int64_t)SDL_GetAtomicInt(&_peakKiB[MemoryMaxTags]) * 1024);
+}
+
+void memoryResetPeak() {
+	for (int i = 0; i <= MemoryMaxTags; ++i) {
+		SDL_SetAtomicInt(&_peakKiB[i], SDL_GetAtomicInt(&_liveKiB[i]));
+	}
+}
+
+MemoryScope::MemoryScope(int tag) : _previous(_tag) {
+	_tag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+	_tag = _previous;
+}
+
+} // namespace core
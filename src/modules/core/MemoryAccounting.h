@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Accounting of the allocations that go through @c core_malloc, @c core_realloc and @c core_free
+ *
+ * Every thread counts its allocations into its own counters - there is no lock in the allocation path. The
+ * allocations are attributed to the subsystem that is active on the current thread - see @c core_memory_scoped.
+ *
+ * @code
+ * void RawVolume::allocate() {
+ *   core_memory_scoped(Volume);
+ *   _data = (Voxel *)core_malloc(size);
+ * }
+ * @endcode
+ *
+ * @note A free is attributed to the scope that releases the memory. Tag the allocation and the release sites of the
+ * memory that a subsystem owns to get its live bytes.
+ * @note The accounting is only compiled in with the cmake option @c USE_MEMORY_ACCOUNTING - the functions are still
+ * available without it, but @c core_malloc doesn't go through them then.
+ * @note The sizes are the usable sizes that are reported by the allocator - this needs the default SDL allocator.
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace core {
+
+/** the sizes of the allocations are counted in power of two buckets - the last one contains everything above */
+static constexpr int MemoryHistogramBuckets = 24;
+/** the maximum amount of tags including the untagged allocations */
+static constexpr int MemoryMaxTags = 32;
+
+struct MemoryTagStats {
+	const char *name = "";
+	int64_t allocations = 0;
+	int64_t frees = 0;
+	int64_t allocatedBytes = 0;
+	int64_t freedBytes = 0;
+	/** the peak of @c liveBytes() - accurate to a few hundred KiB per thread */
+	int64_t peakBytes = 0;
+	/** the amount of allocations with a size of up to @c 2^(i+4) bytes */
+	int64_t histogram[MemoryHistogramBuckets]{};
+
+	inline int64_t liveBytes() const {
+		return allocatedBytes - freedBytes;
+	}
+};
+
+struct MemoryStats {
+	/** @c false if the accounting is not available on this platform or not compiled in */
+	bool enabled = false;
+	MemoryTagStats total;
+	/** the first entry are the allocations outside of any @c core_memory_scoped */
+	core::DynamicArray<MemoryTagStats> tags;
+};
+
+void *accountedMalloc(size_t size);
+void *accountedRealloc(void *ptr, size_t size);
+void accountedFree(void *ptr);
+char *accountedStrdup(const char *str);
+
+/**
+ * @brief Register a tag - registering the same name again returns the same id
+ * @param name Must stay valid for the lifetime of the process (string literal)
+ * @return The id of the tag or @c 0 (untagged) if there are too many tags
+ */
+int memoryTagId(const char *name);
+
+/**
+ * @brief Collect the counters of all threads
+ */
+void memoryStats(MemoryStats &stats);
+/**
+ * @brief Set the peak of all tags to the current live bytes
+ */
+void memoryResetPeak();
+
+/**
+ * @brief Attribute the allocations of the current thread to the given tag while the scope is alive
+ * @sa core_memory_scoped
+ */
+class MemoryScope {
+private:
+	int _previous;
+
+public:
+	MemoryScope(int tag);
+	~MemoryScope();
+};
+
+} // namespace core
+
+#define core_memory_scoped(name)                                                                                     \
+	static const int __memory_tag_##name = core::memoryTagId(#name);                                                 \
+	core::MemoryScope __memory_scope_##name(__memory_tag_##name)
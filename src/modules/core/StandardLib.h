@@ -31,6 +31,18 @@ extern "C" char *SDLCALL SDL_strdup(const char *str);
 #define core_strcasecmp strcasecmp
 #endif
 
+// count the allocations per thread and subsystem - see core/MemoryAccounting.h and the cmake option USE_MEMORY_ACCOUNTING
+#ifndef CORE_MEMORY_ACCOUNTING
+#define CORE_MEMORY_ACCOUNTING 0
+#endif
+
+namespace core {
+void *accountedMalloc(size_t size);
+void *accountedRealloc(void *ptr, size_t size);
+void accountedFree(void *ptr);
+char *accountedStrdup(const char *str);
+}
+
 #define DEBUG_MALLOC 0
 #ifndef core_malloc
 # if DEBUG_MALLOC
@@ -42,22 +54,36 @@ static inline void* debug_core_malloc(size_t size, const char* file, int line) {
 	return ptr;
 }
 #  define core_malloc(size) debug_core_malloc(size, __FILE__, __LINE__)
+# elif CORE_MEMORY_ACCOUNTING
+#  define core_malloc core::accountedMalloc
 # else
 #  define core_malloc SDL_malloc
 # endif
 #endif
 
 #ifndef core_realloc
+#if CORE_MEMORY_ACCOUNTING && !DEBUG_MALLOC
+#define core_realloc core::accountedRealloc
+#else
 #define core_realloc SDL_realloc
 #endif
+#endif
 
 #ifndef core_free
+#if CORE_MEMORY_ACCOUNTING && !DEBUG_MALLOC
+#define core_free core::accountedFree
+#else
 #define core_free SDL_free
 #endif
+#endif
 
 #ifndef core_strdup
+#if CORE_MEMORY_ACCOUNTING && !DEBUG_MALLOC
+#define core_strdup core::accountedStrdup
+#else
 #define core_strdup SDL_strdup
 #endif
+#endif
 
 #ifndef core_memset
 #define core_memset SDL_memset
@@ -3,6 +3,7 @@
  */
 
 #include "core/Trace.h"
+#include "core/TraceRecorder.h"
 #include "core/Var.h"
 #include "core/Log.h"
 #include "core/Common.h"
@@ -85,6 +86,7 @@ void traceInit() {
 }
 
 void traceShutdown() {
+	traceRecorderReset();
 }
 
 void traceBeginFrame() {
@@ -106,15 +108,31 @@ void traceEndFrame() {
 void traceBegin(const char* name) {
 #ifdef USE_EMTRACE
 	emscripten_trace_enter_context(name);
+#else
+	traceRecorderBegin(name);
+#endif
+}
+
+void traceBegin(const char* name, double value) {
+#ifdef USE_EMTRACE
+	emscripten_trace_enter_context(name);
+#else
+	traceRecorderBegin(name, value);
 #endif
 }
 
 void traceEnd() {
 #ifdef USE_EMTRACE
 	emscripten_trace_exit_context();
+#else
+	traceRecorderEnd();
 #endif
 }
 
+void tracePlot(const char* name, double value) {
+	traceRecorderPlot(name, value);
+}
+
 void traceMessage(const char* message) {
 	if (message == nullptr) {
 		return;
@@ -124,6 +142,7 @@ void traceMessage(const char* message) {
 
 void traceThread(const char* name) {
 	_threadName = name;
+	traceRecorderThread(name);
 }
 
 }
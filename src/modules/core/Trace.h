@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/Common.h"
 #include <stdint.h>
 
 #ifdef TRACY_ENABLE
@@ -24,18 +25,62 @@ extern void traceShutdown();
 extern void traceBeginFrame();
 extern void traceEndFrame();
 extern void traceBegin(const char* name);
+extern void traceBegin(const char* name, double value);
 extern void traceEnd();
+extern void tracePlot(const char* name, double value);
 extern void traceMessage(const char* name);
 extern void traceThread(const char* name);
 
+/**
+ * @brief Set while the built-in recorder is running - see @c traceRecorderStart()
+ * @note Only written by the recorder - use @c traceRecording()
+ */
+extern int _traceRecorderActive;
+
+/**
+ * @brief Inline check of the recorder state - the zones don't call into the recorder while it is stopped
+ */
+inline bool traceRecording() {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&_traceRecorderActive, __ATOMIC_RELAXED) != 0;
+#else
+	return *(const volatile int *)&_traceRecorderActive != 0;
+#endif
+}
+
 class TraceScoped {
+private:
+	// a zone that was opened before the recorder was started must not record an end event
+	bool _recording;
+
 public:
-	inline TraceScoped(const char *name, const char *msg = nullptr) {
-		traceBegin(name);
+	inline TraceScoped(const char *name) {
+#ifdef USE_EMTRACE
+		_recording = true;
+#else
+		_recording = core_unlikely(traceRecording());
+#endif
+		if (_recording) {
+			traceBegin(name);
+		}
+	}
+	inline TraceScoped(const char *name, const char *msg) : TraceScoped(name) {
 		traceMessage(msg);
 	}
+	inline TraceScoped(const char *name, double value) {
+#ifdef USE_EMTRACE
+		_recording = true;
+#else
+		_recording = core_unlikely(traceRecording());
+#endif
+		if (_recording) {
+			traceBegin(name, value);
+		}
+	}
 	inline ~TraceScoped() {
-		traceEnd();
+		if (_recording) {
+			traceEnd();
+		}
 	}
 };
 
@@ -77,19 +122,21 @@ public:
 #else
 #define TRACE_NULL_WHILE_LOOP_CONDITION (0)
 #endif
-#define core_trace_value_scoped(name, x) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_plot(name, x) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_init() do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_shutdown() do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
+
+// the built-in recorder - see core/TraceRecorder.h
+#define core_trace_value_scoped(name, x) core::TraceScoped __trace__##name(#name, (double)(x))
+#define core_trace_plot(name, x) core::tracePlot(name, (double)(x))
+#define core_trace_init() core::traceInit()
+#define core_trace_shutdown() core::traceShutdown()
 #define core_trace_msg(message) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_thread(name) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
+#define core_trace_thread(name) core::traceThread(name)
 #define core_trace_mutex(type, varname, name) type varname
 
-#define core_trace_begin_frame(name) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_end_frame(name) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_begin(name) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_end() do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
-#define core_trace_scoped(name) do { } while (TRACE_NULL_WHILE_LOOP_CONDITION)
+#define core_trace_begin_frame(name) core::traceBeginFrame()
+#define core_trace_end_frame(name) core::traceEndFrame()
+#define core_trace_begin(name) core::traceBegin(#name)
+#define core_trace_end() core::traceEnd()
+#define core_trace_scoped(name) core::TraceScoped __trace__##name(#name)
 #define core_trace_mutex_static(type, classname, name) type classname::name
 #endif
 
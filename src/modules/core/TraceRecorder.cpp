@@ -0,0 +1,299 @@
+/**
+ * @file
+ */
+
+#include "TraceRecorder.h"
+#include "core/Common.h"
+#include "core/String.h"
+#include "core/TimeProvider.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_stdinc.h>
+
+namespace core {
+
+namespace {
+
+enum class TraceEventType : uint8_t { Begin, BeginValue, End, Plot };
+
+struct TraceEvent {
+	const char *name;
+	uint64_t ticks;
+	double value;
+	TraceEventType type;
+};
+
+/**
+ * @brief A ring buffer slot that is guarded by a sequence number (seqlock)
+ *
+ * The sequence is the index of the event in the slot plus one - or @c 0 while the owning thread writes the event. The
+ * dump only uses the copy of an event if the sequence matches the expected index before and after copying it.
+ */
+struct TraceSlot {
+	AtomicInt sequence{0};
+	TraceEvent event;
+};
+
+/**
+ * @brief Single producer ring buffer - only the owning thread writes, the dump reads the published events
+ */
+struct TraceThreadBuffer {
+	TraceSlot *events;
+	uint32_t mask;
+	int tid;
+	/** the amount of events that were ever written - the index of the next event is @c write & @c mask */
+	AtomicInt write{0};
+	char name[32];
+};
+
+// incremented by a reset to let the threads allocate new buffers
+static AtomicInt _generation{0};
+static uint32_t _eventsPerThread = 65536u;
+static uint64_t _startTicks = 0u;
+static core_trace_mutex(core::Lock, _buffersLock, "TraceRecorder");
+static core::DynamicArray<TraceThreadBuffer *> _buffers;
+
+static thread_local TraceThreadBuffer *_threadBuffer = nullptr;
+static thread_local int _threadGeneration = -1;
+static thread_local char _threadName[32] = "";
+
+static TraceThreadBuffer *threadBuffer() {
+	const int generation = _generation;
+	if (_threadBuffer != nullptr && _threadGeneration == generation) {
+		return _threadBuffer;
+	}
+	TraceThreadBuffer *buffer = new TraceThreadBuffer();
+	buffer->events = new TraceSlot[_eventsPerThread];
+	buffer->mask = _eventsPerThread - 1u;
+	SDL_strlcpy(buffer->name, _threadName, sizeof(buffer->name));
+	{
+		core::ScopedLock lock(_buffersLock);
+		buffer->tid = (int)_buffers.size() + 1;
+		if (buffer->name[0] == '\0') {
+			SDL_snprintf(buffer->name, sizeof(buffer->name), "Thread %i", buffer->tid);
+		}
+		_buffers.push_back(buffer);
+	}
+	_threadBuffer = buffer;
+	_threadGeneration = generation;
+	return buffer;
+}
+
+static void record(TraceEventType type, const char *name, double value) {
+	TraceThreadBuffer *buffer = threadBuffer();
+	const uint32_t index = (uint32_t)(int)buffer->write;
+	TraceSlot &slot = buffer->events[index & buffer->mask];
+	// invalidate the slot before the event is overwritten - a concurrent dump skips it
+	slot.sequence = 0;
+	SDL_MemoryBarrierRelease();
+	slot.event.name = name;
+	slot.event.ticks = TimeProvider::highResTime();
+	slot.event.value = value;
+	slot.event.type = type;
+	// publish the event after it was written
+	SDL_MemoryBarrierRelease();
+	slot.sequence = (int)(index + 1u);
+	buffer->write = (int)(index + 1u);
+}
+
+/**
+ * @brief Copy the event with the given index out of the ring buffer
+ * @return @c false if the slot was overwritten (or is just being written) by the owning thread
+ */
+static bool readEvent(const TraceThreadBuffer *buffer, uint32_t index, TraceEvent &event) {
+	const TraceSlot &slot = buffer->events[index & buffer->mask];
+	const uint32_t expected = index + 1u;
+	if ((uint32_t)(int)slot.sequence != expected) {
+		return false;
+	}
+	SDL_MemoryBarrierAcquire();
+	event = slot.event;
+	SDL_MemoryBarrierAcquire();
+	if ((uint32_t)(int)slot.sequence != expected) {
+		return false;
+	}
+	// only the end events don't have a name
+	return event.type == TraceEventType::End || event.name != nullptr;
+}
+
+static void appendJsonString(core::String &out, const char *str) {
+	out += '"';
+	for (const char *c = str; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			out += '\\';
+			out += *c;
+		} else if ((uint8_t)*c < 0x20) {
+			out += core::String::format("\\u%04x", (int)(uint8_t)*c);
+		} else {
+			out += *c;
+		}
+	}
+	out += '"';
+}
+
+static void appendEvent(core::String &out, const char *name, char phase, double ts, int tid) {
+	out += ",\n{\"name\":";
+	appendJsonString(out, name);
+	out += core::String::format(",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%i", phase, ts, tid);
+}
+
+} // namespace
+
+int _traceRecorderActive = 0;
+
+static inline void setActive(bool active) {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(&_traceRecorderActive, active ? 1 : 0, __ATOMIC_RELEASE);
+#else
+	*(volatile int *)&_traceRecorderActive = active ? 1 : 0;
+#endif
+}
+
+void traceRecorderStart(uint32_t eventsPerThread) {
+	if (traceRecording()) {
+		return;
+	}
+	uint32_t capacity = 1024u;
+	while (capacity < eventsPerThread) {
+		capacity <<= 1;
+	}
+	{
+		core::ScopedLock lock(_buffersLock);
+		// the existing buffers keep the capacity they were created with
+		if (_buffers.empty()) {
+			_eventsPerThread = capacity;
+		}
+		if (_startTicks == 0u) {
+			_startTicks = TimeProvider::highResTime();
+		}
+	}
+	setActive(true);
+}
+
+void traceRecorderStop() {
+	setActive(false);
+}
+
+void traceRecorderReset() {
+	setActive(false);
+	core::ScopedLock lock(_buffersLock);
+	for (TraceThreadBuffer *buffer : _buffers) {
+		delete[] buffer->events;
+		delete buffer;
+	}
+	_buffers.clear();
+	_startTicks = 0u;
+	_generation.increment();
+}
+
+bool traceRecorderActive() {
+	return traceRecording();
+}
+
+bool traceRecorderDump(const TraceRecorderWriter &writer) {
+	const double ticksToMicros = 1000000.0 / (double)TimeProvider::highResTimeResolution();
+	core::String out;
+	out.reserve(128 * 1024);
+	out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"vengi\"}}";
+
+	core::ScopedLock lock(_buffersLock);
+	for (const TraceThreadBuffer *buffer : _buffers) {
+		out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,";
+		out += core::String::format("\"tid\":%i,\"args\":{\"name\":", buffer->tid);
+		appendJsonString(out, buffer->name);
+		out += "}}";
+
+		const uint32_t write = (uint32_t)(int)buffer->write;
+		const uint32_t capacity = buffer->mask + 1u;
+		const uint32_t count = write < capacity ? write : capacity;
+		// the end events of zones that were opened before the oldest event in the ring buffer are skipped
+		int depth = 0;
+		double ts = 0.0;
+		for (uint32_t i = write - count; i != write; ++i) {
+			TraceEvent event;
+			if (!readEvent(buffer, i, event)) {
+				continue;
+			}
+			ts = event.ticks > _startTicks ? (double)(event.ticks - _startTicks) * ticksToMicros : 0.0;
+			switch (event.type) {
+			case TraceEventType::Begin:
+				appendEvent(out, event.name, 'B', ts, buffer->tid);
+				out += "}";
+				++depth;
+				break;
+			case TraceEventType::BeginValue:
+				appendEvent(out, event.name, 'B', ts, buffer->tid);
+				out += core::String::format(",\"args\":{\"value\":%f}}", event.value);
+				++depth;
+				break;
+			case TraceEventType::End:
+				if (depth == 0) {
+					break;
+				}
+				out += core::String::format(",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}", ts, buffer->tid);
+				--depth;
+				break;
+			case TraceEventType::Plot:
+				appendEvent(out, event.name, 'C', ts, buffer->tid);
+				out += core::String::format(",\"args\":{\"value\":%f}}", event.value);
+				break;
+			}
+			if (out.size() >= 64u * 1024u) {
+				if (!writer(out.c_str(), out.size())) {
+					return false;
+				}
+				out.clear();
+			}
+		}
+		// close the zones that are still open - otherwise the viewers would drop them
+		for (; depth > 0; --depth) {
+			out += core::String::format(",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%i}", ts, buffer->tid);
+		}
+	}
+	out += "\n]}\n";
+	return writer(out.c_str(), out.size());
+}
+
+void traceRecorderBegin(const char *name) {
+	if (!traceRecording()) {
+		return;
+	}
+	record(TraceEventType::Begin, name, 0.0);
+}
+
+void traceRecorderBegin(const char *name, double value) {
+	if (!traceRecording()) {
+		return;
+	}
+	record(TraceEventType::BeginValue, name, value);
+}
+
+void traceRecorderEnd() {
+	if (!traceRecording()) {
+		return;
+	}
+	record(TraceEventType::End, nullptr, 0.0);
+}
+
+void traceRecorderPlot(const char *name, double value) {
+	if (!traceRecording()) {
+		return;
+	}
+	record(TraceEventType::Plot, name, value);
+}
+
+void traceRecorderThread(const char *name) {
+	if (name == nullptr) {
+		return;
+	}
+	SDL_strlcpy(_threadName, name, sizeof(_threadName));
+	if (_threadBuffer != nullptr && _threadGeneration == (int)_generation) {
+		SDL_strlcpy(_threadBuffer->name, name, sizeof(_threadBuffer->name));
+	}
+}
+
+} // namespace core
@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Built-in recorder for the @c core_trace_* macros that exports the zones as chrome trace event json
+ *
+ * This is the backend of the trace macros if neither tracy nor emtrace are compiled in. It doesn't need a profiler
+ * connection and is meant for headless servers and ci runs. The json can be loaded in @c chrome://tracing or in
+ * https://ui.perfetto.dev
+ */
+
+#pragma once
+
+#include "core/Function.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @brief Receives the json of @c traceRecorderDump() in chunks
+ * @return @c false to abort the dump
+ */
+using TraceRecorderWriter = core::Function<bool(const char *data, size_t size)>;
+
+/**
+ * @brief Start to record the trace events of all threads
+ *
+ * Every thread gets its own ring buffer on its first event - if the buffer is full, the oldest events are overwritten.
+ * @param eventsPerThread The capacity of the ring buffer of each thread - rounded up to the next power of two
+ */
+void traceRecorderStart(uint32_t eventsPerThread = 65536u);
+/**
+ * @brief Stop recording - the recorded events are kept until @c traceRecorderReset() is called
+ */
+void traceRecorderStop();
+/**
+ * @brief Free the buffers of all threads
+ * @note Must not be called while other threads are still recording
+ */
+void traceRecorderReset();
+bool traceRecorderActive();
+
+/**
+ * @brief Write the recorded events in the chrome trace event format
+ * @note It's safe to dump while the other threads keep recording - every ring buffer slot is guarded by a sequence
+ * number and the events that are overwritten while the dump is running are skipped.
+ */
+bool traceRecorderDump(const TraceRecorderWriter &writer);
+
+// called by the trace macros - the name must stay valid until the events are dumped (string literals)
+void traceRecorderBegin(const char *name);
+void traceRecorderBegin(const char *name, double value);
+void traceRecorderEnd();
+void traceRecorderPlot(const char *name, double value);
+/**
+ * @param name The name is copied
+ */
+void traceRecorderThread(const char *name);
+
+} // namespace core
@@ -54,6 +54,25 @@ public:
 
 	void set(size_t idx, bool value);
 
+	/**
+	 * @return The amount of @c Type words that are used to store the bits
+	 */
+	inline size_t words() const {
+		return requiredElements(_size);
+	}
+
+	inline Type word(size_t idx) const {
+		return _buffer[idx];
+	}
+
+	/**
+	 * @brief Set all bits of the given word at once
+	 * @note Different words can be written by different threads at the same time - this is not true for @c set()
+	 */
+	inline void setWord(size_t idx, Type value) {
+		_buffer[idx] = value;
+	}
+
 	bool operator[](size_t idx) const;
 	bool operator==(const DynamicBitSet &other) const;
 	bool operator!=(const DynamicBitSet &other) const;
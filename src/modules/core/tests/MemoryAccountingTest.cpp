@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/MemoryAccounting.h"
+#include "core/StandardLib.h"
+#include "core/concurrent/Thread.h"
+
+namespace core {
+
+class MemoryAccountingTest : public testing::Test {
+protected:
+	const MemoryTagStats *find(const MemoryStats &stats, const char *name) const {
+		for (const MemoryTagStats &tag : stats.tags) {
+			if (SDL_strcmp(tag.name, name) == 0) {
+				return &tag;
+			}
+		}
+		return nullptr;
+	}
+};
+
+TEST_F(MemoryAccountingTest, testTagId) {
+	const int id = memoryTagId("TestTagId");
+	EXPECT_GT(id, 0);
+	EXPECT_EQ(id, memoryTagId("TestTagId"));
+	EXPECT_NE(id, memoryTagId("TestTagIdOther"));
+}
+
+TEST_F(MemoryAccountingTest, testScopedAllocation) {
+	MemoryStats stats;
+	memoryStats(stats);
+	if (!stats.enabled) {
+		GTEST_SKIP() << "Memory accounting is not available";
+	}
+	void *ptr;
+	{
+		core_memory_scoped(TestScoped);
+		ptr = core_malloc(1000);
+	}
+	memoryStats(stats);
+	const MemoryTagStats *tag = find(stats, "TestScoped");
+	ASSERT_NE(nullptr, tag);
+	EXPECT_EQ(1, tag->allocations);
+	EXPECT_EQ(0, tag->frees);
+	EXPECT_GE(tag->allocatedBytes, 1000);
+	EXPECT_EQ(tag->allocatedBytes, tag->liveBytes());
+	EXPECT_GE(tag->peakBytes, tag->liveBytes());
+	// 1000 bytes end up in the bucket of up to 1024 bytes
+	EXPECT_EQ(1, tag->histogram[6]);
+	{
+		core_memory_scoped(TestScoped);
+		core_free(ptr);
+	}
+	memoryStats(stats);
+	tag = find(stats, "TestScoped");
+	ASSERT_NE(nullptr, tag);
+	EXPECT_EQ(1, tag->frees);
+	EXPECT_EQ(0, tag->liveBytes());
+}
+
+TEST_F(MemoryAccountingTest, testRealloc) {
+	MemoryStats stats;
+	memoryStats(stats);
+	if (!stats.enabled) {
+		GTEST_SKIP() << "Memory accounting is not available";
+	}
+	core_memory_scoped(TestRealloc);
+	void *ptr = core_malloc(16);
+	ptr = core_realloc(ptr, 4096);
+	memoryStats(stats);
+	const MemoryTagStats *tag = find(stats, "TestRealloc");
+	ASSERT_NE(nullptr, tag);
+	EXPECT_EQ(2, tag->allocations);
+	EXPECT_EQ(1, tag->frees);
+	EXPECT_GE(tag->liveBytes(), 4096);
+	core_free(ptr);
+	memoryStats(stats);
+	tag = find(stats, "TestRealloc");
+	EXPECT_EQ(0, tag->liveBytes());
+}
+
+TEST_F(MemoryAccountingTest, testThreads) {
+	MemoryStats stats;
+	memoryStats(stats);
+	if (!stats.enabled) {
+		GTEST_SKIP() << "Memory accounting is not available";
+	}
+	const int threads = 4;
+	const int allocations = 100;
+	core::Thread thread[threads];
+	for (int i = 0; i < threads; ++i) {
+		thread[i] = core::Thread(
+			[]() {
+				core_memory_scoped(TestThreads);
+				for (int n = 0; n < allocations; ++n) {
+					void *ptr = core_malloc(64 * 1024);
+					core_free(ptr);
+				}
+			},
+			"MemoryAccountingTest");
+	}
+	for (int i = 0; i < threads; ++i) {
+		thread[i].join();
+	}
+	memoryStats(stats);
+	const MemoryTagStats *tag = find(stats, "TestThreads");
+	ASSERT_NE(nullptr, tag);
+	EXPECT_EQ(threads * allocations, tag->allocations);
+	EXPECT_EQ(threads * allocations, tag->frees);
+	EXPECT_EQ(0, tag->liveBytes());
+	EXPECT_GE(tag->peakBytes, 64 * 1024);
+}
+
+} // namespace core
@@ -0,0 +1,133 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/String.h"
+#include "core/Trace.h"
+#include "core/TraceRecorder.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Thread.h"
+
+namespace core {
+
+class TraceRecorderTest : public testing::Test {
+protected:
+	core::String dump() {
+		core::String json;
+		EXPECT_TRUE(traceRecorderDump([&json](const char *data, size_t size) {
+			json.append(data, size);
+			return true;
+		}));
+		return json;
+	}
+
+	void TearDown() override {
+		traceRecorderReset();
+	}
+};
+
+TEST_F(TraceRecorderTest, testDisabled) {
+	traceRecorderBegin("NotRecorded");
+	traceRecorderEnd();
+	const core::String &json = dump();
+	EXPECT_EQ(core::String::npos, json.find("NotRecorded")) << json.c_str();
+}
+
+TEST_F(TraceRecorderTest, testZones) {
+	traceRecorderStart();
+	traceRecorderThread("TestMain");
+	traceRecorderBegin("Outer");
+	traceRecorderBegin("Inner", 42.0);
+	traceRecorderPlot("Counter", 3.0);
+	traceRecorderEnd();
+	traceRecorderEnd();
+	core::Thread thread(
+		[]() {
+			traceRecorderThread("TestWorker");
+			traceRecorderBegin("Worker");
+			traceRecorderEnd();
+		},
+		"TestWorker");
+	thread.join();
+	traceRecorderStop();
+	traceRecorderBegin("AfterStop");
+
+	const core::String &json = dump();
+	EXPECT_NE(core::String::npos, json.find("\"traceEvents\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"TestMain\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"TestWorker\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"Outer\",\"ph\":\"B\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"Inner\",\"ph\":\"B\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"args\":{\"value\":42.0")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"Counter\",\"ph\":\"C\"")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"Worker\",\"ph\":\"B\"")) << json.c_str();
+	EXPECT_EQ(core::String::npos, json.find("AfterStop")) << json.c_str();
+}
+
+static int count(const core::String &str, const char *needle) {
+	int n = 0;
+	for (size_t pos = str.find(needle); pos != core::String::npos; pos = str.find(needle, pos + 1)) {
+		++n;
+	}
+	return n;
+}
+
+TEST_F(TraceRecorderTest, testWrapAround) {
+	traceRecorderStart(1024u);
+	for (int i = 0; i < 10; ++i) {
+		traceRecorderBegin("Lost");
+	}
+	// overwrite the begin events of the outer zones - their end events must be dropped, too
+	for (int i = 0; i < 1024; ++i) {
+		traceRecorderBegin("Kept");
+		traceRecorderEnd();
+	}
+	for (int i = 0; i < 10; ++i) {
+		traceRecorderEnd();
+	}
+	const core::String &json = dump();
+	EXPECT_EQ(core::String::npos, json.find("Lost")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("Kept")) << json.c_str();
+	EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+}
+
+TEST_F(TraceRecorderTest, testScopedZones) {
+	{
+		TraceScoped stopped("Stopped");
+		EXPECT_FALSE(traceRecording());
+		traceRecorderStart();
+		EXPECT_TRUE(traceRecording());
+		// the zone that was opened before the start must not record its end event
+		TraceScoped zone("Scoped", 1.0);
+	}
+	const core::String &json = dump();
+	EXPECT_EQ(core::String::npos, json.find("Stopped")) << json.c_str();
+	EXPECT_NE(core::String::npos, json.find("\"name\":\"Scoped\",\"ph\":\"B\"")) << json.c_str();
+	EXPECT_EQ(1, count(json, "\"ph\":\"E\"")) << json.c_str();
+}
+
+TEST_F(TraceRecorderTest, testDumpWhileRecording) {
+	traceRecorderStart(1024u);
+	core::AtomicBool running(true);
+	core::Thread thread(
+		[&running]() {
+			traceRecorderThread("TestProducer");
+			while (running) {
+				traceRecorderBegin("Produced");
+				traceRecorderPlot("Counter", 1.0);
+				traceRecorderEnd();
+			}
+		},
+		"TestProducer");
+	// the producer wraps around the ring buffer while the dump is reading it
+	for (int i = 0; i < 50; ++i) {
+		const core::String &json = dump();
+		EXPECT_NE(core::String::npos, json.find("\"traceEvents\"")) << json.c_str();
+		EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+	}
+	running = false;
+	thread.join();
+}
+
+} // namespace core
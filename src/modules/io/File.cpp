@@ -161,6 +161,8 @@ SDL_IOStream* File::createRWops(FileMode mode) const {
 		fmode = "wb";
 	} else if (mode == FileMode::Append) {
 		fmode = "ab";
+	} else if (mode == FileMode::SysReadWrite) {
+		fmode = "w+b";
 	}
 	SDL_IOStream *rwops = SDL_IOFromFile(_rawPath.c_str(), fmode);
 	if (rwops == nullptr) {
@@ -24,6 +24,7 @@ enum class FileMode {
 	SysRead,	/**< reading from the given path - using virtual paths as fallback */
 	SysWrite,	/**< writing into the given path */
 	ReadNoHome,	/**< reading from the virtual file system but skip user setting files in the home directories */
+	SysReadWrite, /**< reading and writing the given path - the file is created or truncated */
 	Max
 };
 
@@ -33,7 +34,8 @@ static const char * FileModeStr[] = {
 	"Append",
 	"SysRead",
 	"SysWrite",
-	"ReadNoHome"
+	"ReadNoHome",
+	"SysReadWrite"
 };
 static_assert(lengthof(FileModeStr) == (size_t)FileMode::Max, "FileModeStr is incomplete");
 
@@ -0,0 +1,62 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "io/Archive.h"
+#include "io/Stream.h"
+
+namespace io {
+
+/**
+ * @brief Archive adapter that hands out an already opened stream for one file and forwards everything else
+ *
+ * Detecting the format of a file needs the first bytes of it - the stream that was opened for this is handed out on
+ * the first @c readStream() call for the same file instead of opening the file a second time. All other files and any
+ * further request for the same file are served by the wrapped archive.
+ *
+ * @ingroup IO
+ */
+class SniffedStreamArchive : public Archive {
+private:
+	ArchivePtr _archive;
+	core::String _filePath;
+	SeekableReadStream *_stream;
+
+public:
+	/**
+	 * @param stream The opened stream for @c filePath - the archive takes the ownership
+	 */
+	SniffedStreamArchive(const ArchivePtr &archive, const core::String &filePath, SeekableReadStream *stream)
+		: _archive(archive), _filePath(filePath), _stream(stream) {
+	}
+	~SniffedStreamArchive() override {
+		delete _stream;
+	}
+
+	bool exists(const core::String &file) const override {
+		return _archive->exists(file);
+	}
+	void list(const core::String &basePath, ArchiveFiles &out, const core::String &filter) const override {
+		_archive->list(basePath, out, filter);
+	}
+
+	SeekableReadStream *readStream(const core::String &filePath) override {
+		if (_stream != nullptr && filePath == _filePath) {
+			SeekableReadStream *stream = _stream;
+			_stream = nullptr;
+			stream->seek(0);
+			return stream;
+		}
+		return _archive->readStream(filePath);
+	}
+	SeekableWriteStream *writeStream(const core::String &filePath) override {
+		return _archive->writeStream(filePath);
+	}
+	bool write(const core::String &filePath, io::ReadStream &stream) override {
+		return _archive->write(filePath, stream);
+	}
+};
+
+} // namespace io
@@ -4,7 +4,10 @@
 
 #include "ZipWriteStream.h"
 #include "core/StandardLib.h"
+#include "core/Trace.h"
 #include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
 #if USE_LIBDEFLATE
 #include <libdeflate.h>
 #elif USE_ZLIB
@@ -13,16 +16,87 @@
 #define Z_DEFAULT_WINDOW_BITS 15
 #endif
 #include <zlib.h>
-#else // USE_ZLIB
+// miniz is only used for the blocks of the parallel mode
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#endif // USE_ZLIB
 #include "io/external/miniz.h"
-#endif
 #include "core/Assert.h"
 
 namespace io {
 
+/**
+ * the amount of uncompressed bytes that are deflated by one task in the parallel mode - the blocks don't share a
+ * dictionary, so they must not be too small
+ */
+static constexpr size_t ParallelBlockSize = 512u * 1024u;
+
+struct ZipWriteParallelState {
+	core::ThreadPool *threadPool = nullptr;
+	core::Buffer<uint8_t> inputBuffer;
+	uint32_t adler = 1u;
+	int level;
+	bool rawDeflate;
+	/** the zlib header was written - reset once the stream is finished */
+	bool started = false;
+};
+
+struct ZipWriteBlock {
+	core::Buffer<uint8_t> data;
+	uint32_t adler = 1u;
+	bool success = false;
+};
+
+/**
+ * @brief Deflate a block that ends on a byte boundary - the blocks of a stream can get concatenated
+ * @note libdeflate can only produce streams that end with a final block - that's why miniz is used here
+ */
+static void deflateBlock(const uint8_t *in, size_t size, int level, bool last, ZipWriteBlock &block) {
+	core_trace_scoped(ZipWriteDeflateBlock);
+	block.adler = (uint32_t)mz_adler32(MZ_ADLER32_INIT, in, size);
+	mz_stream stream;
+	core_memset(&stream, 0, sizeof(stream));
+	if (mz_deflateInit2(&stream, level, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS, 9, MZ_DEFAULT_STRATEGY) != MZ_OK) {
+		return;
+	}
+	// the sync flush adds an empty stored block
+	block.data.resize(mz_deflateBound(&stream, (mz_ulong)size) + 16u);
+	stream.next_in = in;
+	stream.avail_in = (unsigned int)size;
+	stream.next_out = block.data.data();
+	stream.avail_out = (unsigned int)block.data.size();
+	const int retVal = mz_deflate(&stream, last ? MZ_FINISH : MZ_SYNC_FLUSH);
+	block.success = (last ? retVal == MZ_STREAM_END : retVal == MZ_OK) && stream.avail_in == 0u;
+	block.data.resize(stream.total_out);
+	mz_deflateEnd(&stream);
+}
+
+/**
+ * @brief The adler32 checksum of the concatenation of two buffers - @c len2 is the size of the second buffer
+ */
+static uint32_t adler32Combine(uint32_t adler1, uint32_t adler2, size_t len2) {
+	const uint32_t base = 65521u;
+	const uint32_t rem = (uint32_t)(len2 % base);
+	uint32_t sum1 = adler1 & 0xffffu;
+	uint32_t sum2 = (uint32_t)(((uint64_t)rem * sum1) % base);
+	sum1 += (adler2 & 0xffffu) + base - 1u;
+	sum2 += ((adler1 >> 16) & 0xffffu) + ((adler2 >> 16) & 0xffffu) + base - rem;
+	if (sum1 >= base) {
+		sum1 -= base;
+	}
+	if (sum1 >= base) {
+		sum1 -= base;
+	}
+	if (sum2 >= (base << 1)) {
+		sum2 -= (base << 1);
+	}
+	if (sum2 >= base) {
+		sum2 -= base;
+	}
+	return sum1 | (sum2 << 16);
+}
+
 #if USE_LIBDEFLATE
 struct ZipWriteLibDeflateState {
-	libdeflate_compressor *compressor = nullptr;
 	core::Buffer<uint8_t> inputBuffer;
 	int level;
 	bool rawDeflate;
@@ -32,7 +106,6 @@ struct ZipWriteLibDeflateState {
 ZipWriteStream::ZipWriteStream(io::WriteStream &outStream, int level, bool rawDeflate) : _outStream(outStream) {
 #if USE_LIBDEFLATE
 	ZipWriteLibDeflateState *state = new ZipWriteLibDeflateState();
-	state->compressor = libdeflate_alloc_compressor(level);
 	state->level = level;
 	state->rawDeflate = rawDeflate;
 	_stream = state;
@@ -46,12 +119,23 @@ ZipWriteStream::ZipWriteStream(io::WriteStream &outStream, int level, bool rawDe
 #endif
 }
 
+ZipWriteStream::ZipWriteStream(io::WriteStream &outStream, core::ThreadPool &threadPool, int level, bool rawDeflate)
+	: _stream(nullptr), _outStream(outStream) {
+	ZipWriteParallelState *state = new ZipWriteParallelState();
+	state->threadPool = &threadPool;
+	state->level = level;
+	state->rawDeflate = rawDeflate;
+	_parallel = state;
+}
+
 ZipWriteStream::~ZipWriteStream() {
 	ZipWriteStream::flush();
+	if (_parallel != nullptr) {
+		delete (ZipWriteParallelState *)_parallel;
+		return;
+	}
 #if USE_LIBDEFLATE
-	ZipWriteLibDeflateState *state = (ZipWriteLibDeflateState *)_stream;
-	libdeflate_free_compressor(state->compressor);
-	delete state;
+	delete (ZipWriteLibDeflateState *)_stream;
 #else
 	const int retVal = deflateEnd(((z_stream *)_stream));
 	core_free(((z_stream *)_stream));
@@ -60,7 +144,176 @@ ZipWriteStream::~ZipWriteStream() {
 #endif
 }
 
+int64_t ZipWriteStream::compressBuffer(const void *buf, size_t size, io::WriteStream &outStream, int level,
+								 bool rawDeflate) {
+	core_trace_scoped(ZipWriteCompress);
+#if USE_LIBDEFLATE
+	libdeflate_compressor *compressor = libdeflate_alloc_compressor(level);
+	if (compressor == nullptr) {
+		return -1;
+	}
+	size_t bound;
+	if (rawDeflate) {
+		bound = libdeflate_deflate_compress_bound(compressor, size);
+	} else {
+		bound = libdeflate_zlib_compress_bound(compressor, size);
+	}
+	core::Buffer<uint8_t> outBuf;
+	outBuf.resize(bound);
+	size_t compressedSize;
+	if (rawDeflate) {
+		compressedSize = libdeflate_deflate_compress(compressor, buf, size, outBuf.data(), outBuf.size());
+	} else {
+		compressedSize = libdeflate_zlib_compress(compressor, buf, size, outBuf.data(), outBuf.size());
+	}
+	libdeflate_free_compressor(compressor);
+#else
+	z_stream stream;
+	core_memset(&stream, 0, sizeof(stream));
+	const int windowBits = rawDeflate ? -Z_DEFAULT_WINDOW_BITS : Z_DEFAULT_WINDOW_BITS;
+	if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return -1;
+	}
+	core::Buffer<uint8_t> outBuf;
+	outBuf.resize(deflateBound(&stream, (uLong)size));
+	stream.next_in = (const unsigned char *)buf;
+	stream.avail_in = (unsigned int)size;
+	stream.next_out = outBuf.data();
+	stream.avail_out = (unsigned int)outBuf.size();
+	const int retVal = deflate(&stream, Z_FINISH);
+	const size_t compressedSize = retVal == Z_STREAM_END ? (size_t)stream.total_out : 0u;
+	deflateEnd(&stream);
+#endif
+	if (compressedSize == 0) {
+		return -1;
+	}
+	if (outStream.write(outBuf.data(), compressedSize) != (int)compressedSize) {
+		return -1;
+	}
+	return (int64_t)compressedSize;
+}
+
+bool ZipWriteStream::deflateBlocks(const uint8_t *input, size_t size, bool last) {
+	core_trace_scoped(ZipWriteDeflateBlocks);
+	ZipWriteParallelState *state = (ZipWriteParallelState *)_parallel;
+	// a final stream needs at least one (maybe empty) block
+	const size_t blockCnt = core_max((size + ParallelBlockSize - 1) / ParallelBlockSize, (size_t)1);
+	core::DynamicArray<ZipWriteBlock> blocks;
+	blocks.resize(blockCnt);
+	core::DynamicArray<core::Future<void>> futures;
+	futures.reserve(blockCnt);
+	const int level = state->level;
+	for (size_t i = 0; i < blockCnt; ++i) {
+		const size_t offset = i * ParallelBlockSize;
+		const size_t blockSize = core_min(size - offset, ParallelBlockSize);
+		const bool lastBlock = last && i == blockCnt - 1;
+		ZipWriteBlock *block = &blocks[i];
+		core::Future<void> future = state->threadPool->enqueue(
+			[input, offset, blockSize, level, lastBlock, block]() {
+				deflateBlock(input + offset, blockSize, level, lastBlock, *block);
+			});
+		if (!future.valid()) {
+			// the thread pool is shutting down
+			deflateBlock(input + offset, blockSize, level, lastBlock, *block);
+			continue;
+		}
+		futures.emplace_back(core::move(future));
+	}
+	for (core::Future<void> &future : futures) {
+		future.wait();
+	}
+
+	if (!state->started) {
+		if (!state->rawDeflate) {
+			// CMF: deflate with a 32k window - FLG: the compression level hint and the check bits
+			const uint8_t cmf = 0x78;
+			const uint8_t flevel = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+			uint8_t flg = (uint8_t)(flevel << 6);
+			flg += (uint8_t)(31 - ((cmf * 256 + flg) % 31));
+			const uint8_t header[] = {cmf, flg};
+			if (_outStream.write(header, sizeof(header)) != (int)sizeof(header)) {
+				return false;
+			}
+			_pos += sizeof(header);
+		}
+		state->adler = 1u;
+		state->started = true;
+	}
+	for (size_t i = 0; i < blockCnt; ++i) {
+		const ZipWriteBlock &block = blocks[i];
+		if (!block.success) {
+			return false;
+		}
+		if (_outStream.write(block.data.data(), block.data.size()) != (int)block.data.size()) {
+			return false;
+		}
+		_pos += (int64_t)block.data.size();
+		const size_t blockSize = core_min(size - i * ParallelBlockSize, ParallelBlockSize);
+		state->adler = adler32Combine(state->adler, block.adler, blockSize);
+	}
+
+	if (last) {
+		if (!state->rawDeflate) {
+			const uint8_t trailer[] = {(uint8_t)(state->adler >> 24), (uint8_t)(state->adler >> 16),
+									   (uint8_t)(state->adler >> 8), (uint8_t)state->adler};
+			if (_outStream.write(trailer, sizeof(trailer)) != (int)sizeof(trailer)) {
+				return false;
+			}
+			_pos += sizeof(trailer);
+		}
+		state->started = false;
+	}
+	return true;
+}
+
+int ZipWriteStream::writeParallel(const void *buf, size_t size) {
+	ZipWriteParallelState *state = (ZipWriteParallelState *)_parallel;
+	// give every thread a few blocks - but keep data back for the final block that is written on flush()
+	const size_t batchSize = core_max(state->threadPool->size(), (size_t)1) * 2u * ParallelBlockSize;
+	const uint8_t *p = (const uint8_t *)buf;
+	size_t remaining = size;
+	while (state->inputBuffer.size() + remaining > batchSize) {
+		if (state->inputBuffer.empty()) {
+			// compress directly from the given buffer
+			if (!deflateBlocks(p, batchSize, false)) {
+				return -1;
+			}
+			p += batchSize;
+			remaining -= batchSize;
+			continue;
+		}
+		const size_t n = batchSize - state->inputBuffer.size();
+		state->inputBuffer.append(p, n);
+		p += n;
+		remaining -= n;
+		if (!deflateBlocks(state->inputBuffer.data(), batchSize, false)) {
+			return -1;
+		}
+		state->inputBuffer.clear();
+	}
+	if (state->inputBuffer.capacity() < batchSize) {
+		state->inputBuffer.reserve(batchSize);
+	}
+	state->inputBuffer.append(p, remaining);
+	return (int)size;
+}
+
+bool ZipWriteStream::flushParallel() {
+	ZipWriteParallelState *state = (ZipWriteParallelState *)_parallel;
+	if (state->inputBuffer.empty() && !state->started) {
+		return true;
+	}
+	if (!deflateBlocks(state->inputBuffer.data(), state->inputBuffer.size(), true)) {
+		return false;
+	}
+	state->inputBuffer.clear();
+	return true;
+}
+
 int ZipWriteStream::write(const void *buf, size_t size) {
+	if (_parallel != nullptr) {
+		return writeParallel(buf, size);
+	}
 #if USE_LIBDEFLATE
 	ZipWriteLibDeflateState *state = (ZipWriteLibDeflateState *)_stream;
 	const uint8_t *p = (const uint8_t *)buf;
@@ -98,34 +351,17 @@ int ZipWriteStream::write(const void *buf, size_t size) {
 }
 
 bool ZipWriteStream::flush() {
+	if (_parallel != nullptr) {
+		return flushParallel();
+	}
 #if USE_LIBDEFLATE
 	ZipWriteLibDeflateState *state = (ZipWriteLibDeflateState *)_stream;
 	if (state->inputBuffer.empty()) {
 		return true;
 	}
-	size_t bound = 0;
-	if (state->rawDeflate) {
-		bound = libdeflate_deflate_compress_bound(state->compressor, state->inputBuffer.size());
-	} else {
-		bound = libdeflate_zlib_compress_bound(state->compressor, state->inputBuffer.size());
-	}
-
-	core::Buffer<uint8_t> outBuf;
-	outBuf.resize(bound);
-	size_t compressedSize = 0;
-	if (state->rawDeflate) {
-		compressedSize = libdeflate_deflate_compress(state->compressor, state->inputBuffer.data(),
-													 state->inputBuffer.size(), outBuf.data(), outBuf.size());
-	} else {
-		compressedSize = libdeflate_zlib_compress(state->compressor, state->inputBuffer.data(),
-												  state->inputBuffer.size(), outBuf.data(), outBuf.size());
-	}
-
-	if (compressedSize == 0) {
-		return false;
-	}
-
-	if (_outStream.write(outBuf.data(), compressedSize) != (int)compressedSize) {
+	const int64_t compressedSize =
+		compressBuffer(state->inputBuffer.data(), state->inputBuffer.size(), _outStream, state->level, state->rawDeflate);
+	if (compressedSize == -1) {
 		return false;
 	}
 	_pos += compressedSize;
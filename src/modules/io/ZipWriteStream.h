@@ -7,9 +7,33 @@
 #include "Stream.h"
 #include "engine-config.h" // USE_ZLIB, USE_LIBDEFLATE
 
+namespace core {
+class ThreadPool;
+}
+
 namespace io {
 
 /**
+ * @brief Compression level presets for @c ZipWriteStream - pick the one that fits the use site
+ */
+namespace ZipLevel {
+/** no compression - the data is stored */
+constexpr int Store = 0;
+/** for transient data like undo states where the speed matters more than the size */
+constexpr int Fastest = 1;
+constexpr int Fast = 3;
+/** for files that are written to disk */
+constexpr int Default = 6;
+constexpr int Best = 9;
+} // namespace ZipLevel
+
+/**
+ * @brief Compresses the written data as zlib stream (or raw deflate)
+ *
+ * The parallel mode splits the input into independent blocks that are deflated on the given thread pool (like pigz
+ * does). Each block ends on a byte boundary, so the concatenated blocks form a standard stream that any inflater can
+ * read. The blocks don't share a dictionary - the compression ratio is slightly worse for highly redundant data.
+ *
  * @see ZipReadStream
  * @see WriteStream
  * @ingroup IO
@@ -22,15 +46,36 @@ private:
 	uint8_t _out[256 * 1024] {};
 #endif
 	int64_t _pos = 0;
+	/** the state of the parallel mode - @c nullptr if the stream compresses sequentially */
+	void *_parallel = nullptr;
+
+	int writeParallel(const void *buf, size_t size);
+	bool deflateBlocks(const uint8_t *input, size_t size, bool last);
+	bool flushParallel();
 
 public:
 	/**
 	 * @param outStream The buffer that receives the writes for the compressed data.
 	 * @param level The compression level (0 is no compression, 1 is the best speed, 9 is the best compression).
+	 * @see ZipLevel
 	 */
-	ZipWriteStream(io::WriteStream &outStream, int level = 6, bool rawDeflate = false);
+	ZipWriteStream(io::WriteStream &outStream, int level = ZipLevel::Default, bool rawDeflate = false);
+	/**
+	 * @brief Compress blocks of the written data in parallel on the given thread pool
+	 *
+	 * Only a few blocks per thread are buffered - the compressed blocks are written to the output stream in order.
+	 */
+	ZipWriteStream(io::WriteStream &outStream, core::ThreadPool &threadPool, int level = ZipLevel::Default,
+				   bool rawDeflate = false);
 	virtual ~ZipWriteStream();
 
+	/**
+	 * @brief Compress the given buffer in one go - use this if the whole input is known already
+	 * @return @c -1 on error - otherwise the amount of compressed bytes that were written to the output stream.
+	 */
+	static int64_t compressBuffer(const void *buf, size_t size, io::WriteStream &outStream, int level = ZipLevel::Default,
+							bool rawDeflate = false);
+
 	/**
 	 * @param buf The buffer to add to the output stream.
 	 * @param size The size of the buffer.
@@ -2,8 +2,12 @@
  * @file
  */
 
+#include "app/App.h"
 #include "app/benchmark/AbstractBenchmark.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Concurrency.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/Base64ReadStream.h"
 #include "io/Base64WriteStream.h"
 #include "io/BufferedReadWriteStream.h"
@@ -97,6 +101,92 @@ BENCHMARK_DEFINE_F(StreamBenchmark, BufferedStream)(benchmark::State &state) {
 	}
 }
 
+/**
+ * @brief Compresses 16MB of voxel like data with the given compression level - reports MB/s of the wall time
+ */
+class ZipBenchmark : public app::AbstractBenchmark {
+protected:
+	using Super = app::AbstractBenchmark;
+
+	core::Buffer<uint32_t> data;
+
+public:
+	ZipBenchmark() : Super(core::cpus()) {
+	}
+
+	void SetUp(::benchmark::State &state) override {
+		Super::SetUp(state);
+		data.resize(4 * 1024 * 1024);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = (uint32_t)(((i / 31) * 2654435761u) >> 28);
+		}
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		data.release();
+		Super::TearDown(state);
+	}
+
+	void finish(benchmark::State &state, int64_t compressedSize) {
+		const int64_t bytes = (int64_t)(data.size() * sizeof(uint32_t));
+		state.SetBytesProcessed(state.iterations() * bytes);
+		state.counters["ratio"] = compressedSize > 0 ? (double)bytes / (double)compressedSize : 0.0;
+	}
+};
+
+BENCHMARK_DEFINE_F(ZipBenchmark, Stream)(benchmark::State &state) {
+	int64_t compressedSize = 0;
+	for (auto _ : state) {
+		io::BufferedReadWriteStream outStream;
+		{
+			io::ZipWriteStream stream(outStream, (int)state.range(0));
+			stream.write(data.data(), data.size() * sizeof(uint32_t));
+		}
+		compressedSize = outStream.size();
+	}
+	finish(state, compressedSize);
+}
+
+BENCHMARK_DEFINE_F(ZipBenchmark, OneShot)(benchmark::State &state) {
+	int64_t compressedSize = 0;
+	for (auto _ : state) {
+		io::BufferedReadWriteStream outStream;
+		compressedSize =
+			io::ZipWriteStream::compressBuffer(data.data(), data.size() * sizeof(uint32_t), outStream, (int)state.range(0));
+	}
+	finish(state, compressedSize);
+}
+
+BENCHMARK_DEFINE_F(ZipBenchmark, Parallel)(benchmark::State &state) {
+	int64_t compressedSize = 0;
+	core::ThreadPool &threadPool = *app::App::getInstance()->threadPool().get();
+	for (auto _ : state) {
+		io::BufferedReadWriteStream outStream;
+		{
+			io::ZipWriteStream stream(outStream, threadPool, (int)state.range(0));
+			stream.write(data.data(), data.size() * sizeof(uint32_t));
+		}
+		compressedSize = outStream.size();
+	}
+	finish(state, compressedSize);
+}
+
+BENCHMARK_REGISTER_F(ZipBenchmark, Stream)
+	->Arg(io::ZipLevel::Fastest)
+	->Arg(io::ZipLevel::Default)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+BENCHMARK_REGISTER_F(ZipBenchmark, OneShot)
+	->Arg(io::ZipLevel::Fastest)
+	->Arg(io::ZipLevel::Default)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+BENCHMARK_REGISTER_F(ZipBenchmark, Parallel)
+	->Arg(io::ZipLevel::Fastest)
+	->Arg(io::ZipLevel::Default)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
 BENCHMARK_REGISTER_F(StreamBenchmark, ZipStreamRoundTrip);
 BENCHMARK_REGISTER_F(StreamBenchmark, Base64StreamRoundTrip);
 BENCHMARK_REGISTER_F(StreamBenchmark, ZipStreamWrite);
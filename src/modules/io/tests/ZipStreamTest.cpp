@@ -3,6 +3,8 @@
  */
 
 #include "app/tests/AbstractTest.h"
+#include "core/collection/Buffer.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/BufferedReadWriteStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
@@ -10,7 +12,94 @@
 
 namespace io {
 
-class ZipStreamTest : public app::AbstractTest {};
+class ZipStreamTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Some compressible data that is big enough to be split into several blocks in the parallel mode
+	 */
+	core::Buffer<uint32_t> createData(size_t n) const {
+		core::Buffer<uint32_t> data;
+		data.resize(n);
+		for (size_t i = 0; i < n; ++i) {
+			data[i] = (uint32_t)((i / 7) ^ (i % 13));
+		}
+		return data;
+	}
+
+	void readAndCompare(BufferedReadWriteStream &stream, const core::Buffer<uint32_t> &data) {
+		const int size = (int)stream.size();
+		stream.seek(0);
+		ZipReadStream r(stream, size);
+		core::Buffer<uint32_t> decompressed;
+		decompressed.resize(data.size());
+		const int bytes = (int)(data.size() * sizeof(uint32_t));
+		ASSERT_EQ(bytes, r.read(decompressed.data(), bytes));
+		for (size_t i = 0; i < data.size(); ++i) {
+			ASSERT_EQ(data[i], decompressed[i]) << "unexpected value at " << i;
+		}
+	}
+};
+
+TEST_F(ZipStreamTest, testCompress) {
+	const core::Buffer<uint32_t> data = createData(64 * 1024);
+	BufferedReadWriteStream stream;
+	const int64_t compressed =
+		ZipWriteStream::compressBuffer(data.data(), data.size() * sizeof(uint32_t), stream, ZipLevel::Fastest);
+	ASSERT_GT(compressed, 0);
+	EXPECT_EQ(compressed, stream.size());
+	readAndCompare(stream, data);
+}
+
+TEST_F(ZipStreamTest, testParallelWriteAndRead) {
+	core::ThreadPool threadPool(4, "ZipStreamTest");
+	threadPool.init();
+	// more than a batch of blocks to also write non final blocks before the stream is flushed
+	const core::Buffer<uint32_t> data = createData(4 * 1024 * 1024);
+	BufferedReadWriteStream stream;
+	{
+		ZipWriteStream w(stream, threadPool);
+		const size_t chunk = 100 * 1024 + 3;
+		for (size_t i = 0; i < data.size(); i += chunk) {
+			const size_t n = core_min(chunk, data.size() - i);
+			ASSERT_EQ((int)(n * sizeof(uint32_t)), w.write(data.data() + i, n * sizeof(uint32_t)));
+		}
+		ASSERT_TRUE(w.flush());
+		EXPECT_EQ(w.size(), stream.size());
+	}
+	readAndCompare(stream, data);
+	threadPool.shutdown(true);
+}
+
+TEST_F(ZipStreamTest, testParallelWriteAndReadDeflate) {
+	core::ThreadPool threadPool(2, "ZipStreamTest");
+	threadPool.init();
+	const core::Buffer<uint32_t> data = createData(1024 * 1024);
+	BufferedReadWriteStream stream;
+	{
+		ZipWriteStream w(stream, threadPool, ZipLevel::Fast, true);
+		ASSERT_EQ((int)(data.size() * sizeof(uint32_t)), w.write(data.data(), data.size() * sizeof(uint32_t)));
+	}
+	readAndCompare(stream, data);
+	threadPool.shutdown(true);
+}
+
+TEST_F(ZipStreamTest, testParallelWriteSmall) {
+	core::ThreadPool threadPool(2, "ZipStreamTest");
+	threadPool.init();
+	BufferedReadWriteStream stream;
+	{
+		ZipWriteStream w(stream, threadPool);
+		ASSERT_TRUE(w.writeUInt32(42));
+	}
+	stream.seek(0);
+	EXPECT_TRUE(ZipReadStream::isZipStream(stream));
+	stream.seek(0);
+	ZipReadStream r(stream, (int)stream.size());
+	uint32_t val;
+	ASSERT_EQ(0, r.readUInt32(val));
+	EXPECT_EQ(42u, val);
+	threadPool.shutdown(true);
+}
 
 TEST_F(ZipStreamTest, testZipStreamWrite) {
 	BufferedReadWriteStream stream(1024);
@@ -4,10 +4,12 @@
 
 #include "MementoHandler.h"
 
+#include "app/Async.h"
 #include "command/Command.h"
 #include "core/ArrayLength.h"
 #include "core/Assert.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/ScopedPtr.h"
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
@@ -154,12 +156,16 @@ MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region
 
 MementoData::MementoData(MementoData &&o) noexcept
 	: _compressedSize(o._compressedSize), _buffer(o._buffer), _dataRegion(o._dataRegion),
-	  _volumeRegion(o._volumeRegion), _modifiedRegion(o._modifiedRegion) {
+	  _volumeRegion(o._volumeRegion), _modifiedRegion(o._modifiedRegion), _journal(core::move(o._journal)),
+	  _journalOffset(o._journalOffset) {
 	o._compressedSize = 0;
 	o._buffer = nullptr;
+	o._journalOffset = -1;
 }
 
 MementoData::~MementoData() {
+	core_memory_scoped(Memento);
+	releaseJournal();
 	if (_buffer != nullptr) {
 		core_free(_buffer);
 		_buffer = nullptr;
@@ -169,17 +175,26 @@ MementoData::~MementoData() {
 MementoData::MementoData(const MementoData &o)
 	: _compressedSize(o._compressedSize), _dataRegion(o._dataRegion), _volumeRegion(o._volumeRegion),
 	  _modifiedRegion(o._modifiedRegion) {
+	core_memory_scoped(Memento);
 	if (o._buffer != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t *)core_malloc(_compressedSize);
 		core_memcpy(_buffer, o._buffer, _compressedSize);
+	} else if (o.spilled()) {
+		// copies are always resident - they are handed out for undo and redo
+		_buffer = o.pageIn();
+		if (_buffer == nullptr) {
+			_compressedSize = 0;
+		}
 	} else {
 		core_assert(_compressedSize == 0);
 	}
 }
 
 MementoData &MementoData::operator=(MementoData &&o) noexcept {
+	core_memory_scoped(Memento);
 	if (this != &o) {
+		releaseJournal();
 		_compressedSize = o._compressedSize;
 		o._compressedSize = 0;
 		if (_buffer) {
@@ -190,12 +205,17 @@ MementoData &MementoData::operator=(MementoData &&o) noexcept {
 		_dataRegion = o._dataRegion;
 		_volumeRegion = o._volumeRegion;
 		_modifiedRegion = o._modifiedRegion;
+		_journal = core::move(o._journal);
+		_journalOffset = o._journalOffset;
+		o._journalOffset = -1;
 	}
 	return *this;
 }
 
 MementoData &MementoData::operator=(const MementoData &o) noexcept {
+	core_memory_scoped(Memento);
 	if (this != &o) {
+		releaseJournal();
 		_compressedSize = o._compressedSize;
 		if (_buffer) {
 			core_free(_buffer);
@@ -205,6 +225,11 @@ MementoData &MementoData::operator=(const MementoData &o) noexcept {
 			core_assert(_compressedSize > 0);
 			_buffer = (uint8_t *)core_malloc(_compressedSize);
 			core_memcpy(_buffer, o._buffer, _compressedSize);
+		} else if (o.spilled()) {
+			_buffer = o.pageIn();
+			if (_buffer == nullptr) {
+				_compressedSize = 0;
+			}
 		} else {
 			core_assert(_compressedSize == 0);
 		}
@@ -215,7 +240,38 @@ MementoData &MementoData::operator=(const MementoData &o) noexcept {
 	return *this;
 }
 
+void MementoData::spill(const MementoJournalPtr &journal, int64_t offset) {
+	core_memory_scoped(Memento);
+	core_assert(_buffer != nullptr);
+	core_free(_buffer);
+	_buffer = nullptr;
+	_journal = journal;
+	_journalOffset = offset;
+}
+
+void MementoData::releaseJournal() {
+	if (!spilled()) {
+		return;
+	}
+	_journal->release(_journalOffset, _compressedSize);
+	_journal = {};
+	_journalOffset = -1;
+}
+
+uint8_t *MementoData::pageIn() const {
+	core_memory_scoped(Memento);
+	core_assert(spilled());
+	uint8_t *buf = (uint8_t *)core_malloc(_compressedSize);
+	if (!_journal->read(_journalOffset, buf, _compressedSize)) {
+		Log::error("Failed to read the memento volume data from the journal");
+		core_free(buf);
+		return nullptr;
+	}
+	return buf;
+}
+
 MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel::Region &region) {
+	core_memory_scoped(Memento);
 	if (volume == nullptr) {
 		return MementoData();
 	}
@@ -226,12 +282,12 @@ MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel:
 		voxel::RawVolume v(*volume, region);
 		const int64_t actualVoxels = v.region().voxels();
 		io::BufferedReadWriteStream outStream(actualVoxels * (int64_t)sizeof(voxel::Voxel));
-		io::ZipWriteStream stream(outStream);
-		if (stream.write(v.data(), actualVoxels * sizeof(voxel::Voxel)) == -1) {
+		// undo states favour the speed over the size
+		if (io::ZipWriteStream::compressBuffer(v.data(), actualVoxels * sizeof(voxel::Voxel), outStream,
+											    io::ZipLevel::Fastest) == -1) {
 			Log::error("Failed to compress memento volume data");
 			return MementoData();
 		}
-		stream.flush();
 		const size_t size = (size_t)outStream.size();
 		const voxel::Region actualRegion = v.region();
 		MementoData data(outStream.release(), size, actualRegion, volume->region());
@@ -244,20 +300,23 @@ MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel:
 		}
 		return data;
 	}
+	if (!volume->contiguous()) {
+		// the voxels of a grown volume have gaps between the rows - let the copy compact them
+		return fromVolume(volume, volume->region());
+	}
 	const int64_t allVoxels = volume->region().voxels();
 	io::BufferedReadWriteStream outStream(allVoxels * (int64_t)sizeof(voxel::Voxel));
-	io::ZipWriteStream stream(outStream);
-	if (stream.write(volume->data(), allVoxels * sizeof(voxel::Voxel)) == -1) {
+	if (io::ZipWriteStream::compressBuffer(volume->data(), allVoxels * sizeof(voxel::Voxel), outStream,
+									    io::ZipLevel::Fastest) == -1) {
 		Log::error("Failed to compress memento volume data");
 		return MementoData();
 	}
-	stream.flush();
 	const size_t size = (size_t)outStream.size();
 	return {outStream.release(), size, volume->region(), volume->region()};
 }
 
 bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoData, const voxel::Region &region) {
-	if (mementoData._buffer == nullptr) {
+	if (!mementoData.hasVolume()) {
 		return false;
 	}
 	core_assert_always(volume != nullptr);
@@ -268,8 +327,21 @@ bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoD
 		return false;
 	}
 
+	const uint8_t *buffer = mementoData._buffer;
+	uint8_t *pagedIn = nullptr;
+	if (buffer == nullptr) {
+		pagedIn = mementoData.pageIn();
+		if (pagedIn == nullptr) {
+			return false;
+		}
+		buffer = pagedIn;
+	}
 	core::ScopedPtr<voxel::RawVolume> v(
-		voxel::toVolume(mementoData._buffer, (uint32_t)mementoData._compressedSize, mementoData.dataRegion()));
+		voxel::toVolume(buffer, (uint32_t)mementoData._compressedSize, mementoData.dataRegion()));
+	if (pagedIn != nullptr) {
+		core_memory_scoped(Memento);
+		core_free(pagedIn);
+	}
 	if (!v) {
 		return false;
 	}
@@ -299,6 +371,134 @@ void MementoHandler::shutdown() {
 	_groupState = 0;
 	clearStates();
 	_listeners.clear();
+	if (_journal) {
+		_journal->close();
+		_journal = {};
+	}
+}
+
+void MementoHandler::update() {
+	finishSpill(false);
+}
+
+void MementoHandler::setMemoryBudget(size_t budgetBytes, int hotGroups) {
+	_memoryBudget = budgetBytes;
+	_hotGroups = core_max(1, hotGroups);
+	enforceBudget();
+}
+
+void MementoHandler::setJournalFile(const core::String &journalFile) {
+	if (_journalFile == journalFile) {
+		return;
+	}
+	if (_journal) {
+		// spilled states reference the old journal - it is deleted once the last of them is gone
+		finishSpill(true);
+		_journal = {};
+	}
+	_journalFile = journalFile;
+}
+
+MementoStatistics MementoHandler::statistics() const {
+	MementoStatistics stats;
+	for (const MementoStateGroup &group : _groups) {
+		for (const MementoState &state : group.states) {
+			if (state.data.spilled()) {
+				stats.spilledBytes += state.data.size();
+				++stats.spilledStates;
+			} else if (state.data._buffer != nullptr) {
+				stats.residentBytes += state.data.size();
+				++stats.residentStates;
+			}
+		}
+	}
+	if (_journal) {
+		stats.journalBytes = _journal->size();
+	}
+	stats.spilling = _spillFuture.valid();
+	return stats;
+}
+
+void MementoHandler::finishSpill(bool wait) {
+	if (!_spillFuture.valid()) {
+		return;
+	}
+	if (!wait && !_spillFuture.ready()) {
+		return;
+	}
+	core_trace_scoped(MementoFinishSpill);
+	const SpillEntries entries = _spillFuture.get();
+	_spillFuture = {};
+	for (const SpillEntry &entry : entries) {
+		if (entry.offset < 0) {
+			continue;
+		}
+		// the buffers were owned by the states during the write - identify the states by them
+		for (MementoStateGroup &group : _groups) {
+			for (MementoState &state : group.states) {
+				if (state.data._buffer == entry.buffer) {
+					state.data.spill(_journal, entry.offset);
+				}
+			}
+		}
+	}
+	Log::debug("Spilled %i memento states to disk", (int)entries.size());
+}
+
+void MementoHandler::enforceBudget() {
+	if (_memoryBudget == 0u || _journalFile.empty() || _groupState > 0 || _spillFuture.valid()) {
+		return;
+	}
+	core::ScopedLock lock(_mutex);
+	size_t resident = 0u;
+	for (const MementoStateGroup &group : _groups) {
+		for (const MementoState &state : group.states) {
+			if (state.data._buffer != nullptr) {
+				resident += state.data.size();
+			}
+		}
+	}
+	if (resident <= _memoryBudget) {
+		return;
+	}
+	core_trace_scoped(MementoEnforceBudget);
+	SpillEntries entries;
+	const int hotStart = (int)_groups.size() - _hotGroups;
+	for (int i = 0; i < hotStart && resident > _memoryBudget; ++i) {
+		// the current state is needed for the next undo step
+		if (i == (int)_groupStatePosition) {
+			continue;
+		}
+		for (const MementoState &state : _groups[i].states) {
+			if (state.data._buffer == nullptr) {
+				continue;
+			}
+			entries.push_back({state.data._buffer, state.data.size(), -1});
+			resident -= state.data.size();
+		}
+	}
+	if (entries.empty()) {
+		return;
+	}
+	if (!_journal) {
+		_journal = core::make_shared<MementoJournal>(_journalFile);
+		if (!_journal->open()) {
+			Log::warn("Can't enforce the memento memory budget without journal");
+			_journal = {};
+			_journalFile = "";
+			return;
+		}
+	}
+	Log::debug("Spill %i memento states to disk", (int)entries.size());
+	const MementoJournalPtr journal = _journal;
+	_spillFuture = app::async([journal, entries]() {
+		core_trace_scoped(MementoSpill);
+		SpillEntries written = entries;
+		for (SpillEntry &entry : written) {
+			entry.offset = journal->append(entry.buffer, entry.size);
+		}
+		return written;
+	});
 }
 
 void MementoHandler::registerListener(IMementoStateListener *listener) {
@@ -356,6 +556,7 @@ void MementoHandler::beginGroup(const core::String &name) {
 
 	Log::debug("Begin memento group: %i (%s)", _groupState, name.c_str());
 	if (_groupState <= 0) {
+		finishSpill(true);
 		cutFromGroupStatePosition();
 		_groups.emplace_back(MementoStateGroup{name, {}});
 		_groupStatePosition = stateSize() - 1;
@@ -377,6 +578,7 @@ void MementoHandler::endGroup() {
 		if (_groups.back().states.empty()) {
 			removeLast();
 		}
+		enforceBudget();
 	}
 }
 
@@ -442,7 +644,7 @@ void MementoHandler::printState(const MementoState &state) const {
 	const core::String &parentUUIDStr = state.parentUUID.str();
 	Log::info(" - parent: %s", parentUUIDStr.c_str());
 	Log::info(" - name: %s", state.name.c_str());
-	Log::info(" - volume: %s", state.data._buffer == nullptr ? "empty" : "volume");
+	Log::info(" - volume: %s", !state.data.hasVolume() ? "empty" : (state.data.spilled() ? "spilled" : "volume"));
 	const glm::ivec3 &dataMins = state.dataRegion().getLowerCorner();
 	const glm::ivec3 &dataMaxs = state.dataRegion().getUpperCorner();
 	Log::info(" - dataregion: mins(%i:%i:%i)/maxs(%i:%i:%i)", dataMins.x, dataMins.y, dataMins.z, dataMaxs.x,
@@ -501,8 +703,14 @@ void MementoHandler::construct() {
 
 void MementoHandler::clearStates() {
 	core_assert_msg(_groupState <= 0, "You should not clear the states while you are recording a group state");
+	finishSpill(true);
 	_groups.clear();
 	_groupStatePosition = 0u;
+	if (_journal) {
+		// no state references the journal anymore - a new one is created on the next spill
+		_journal->close();
+		_journal = {};
+	}
 }
 
 void MementoHandler::undoModification(MementoState &s) {
@@ -849,6 +1057,7 @@ bool MementoHandler::removeLast() {
 	if (_groups.empty()) {
 		return false;
 	}
+	finishSpill(true);
 	if (_groupStatePosition == stateSize() - 1) {
 		--_groupStatePosition;
 	}
@@ -898,25 +1107,29 @@ bool MementoHandler::addState(MementoState &&state) {
 		}
 		return false;
 	}
-	core::ScopedLock lock(_mutex);
-	if (_groupState > 0) {
-		Log::debug("add group state: %i", _groupState);
-		_groups.back().states.emplace_back(state);
+	{
+		core::ScopedLock lock(_mutex);
+		if (_groupState > 0) {
+			Log::debug("add group state: %i", _groupState);
+			_groups.back().states.emplace_back(state);
+			for (auto *listener : _listeners) {
+				listener->onMementoStateAdded(_groups.back().states.back());
+			}
+			return true;
+		}
+		finishSpill(true);
+		MementoStateGroup group;
+		group.name = "single";
+		group.states.emplace_back(state);
+		cutFromGroupStatePosition();
+		_groups.emplace_back(core::move(group));
+		_groupStatePosition = stateSize() - 1;
+
 		for (auto *listener : _listeners) {
 			listener->onMementoStateAdded(_groups.back().states.back());
 		}
-		return true;
-	}
-	MementoStateGroup group;
-	group.name = "single";
-	group.states.emplace_back(state);
-	cutFromGroupStatePosition();
-	_groups.emplace_back(core::move(group));
-	_groupStatePosition = stateSize() - 1;
-
-	for (auto *listener : _listeners) {
-		listener->onMementoStateAdded(_groups.back().states.back());
 	}
+	enforceBudget();
 	return true;
 }
 
@@ -5,11 +5,13 @@
 #pragma once
 
 #include "IMementoStateListener.h"
+#include "MementoJournal.h"
 #include "core/IComponent.h"
 #include "core/Optional.h"
 #include "core/String.h"
 #include "core/UUID.h"
 #include "core/collection/RingBuffer.h"
+#include "core/concurrent/Future.h"
 #include "core/concurrent/Lock.h"
 #include "core/Trace.h"
 #include "palette/NormalPalette.h"
@@ -142,6 +144,9 @@ enum class MementoType {
  * The class distinguishes between two regions:
  * - dataRegion: The specific area within the volume that contains actual voxel data
  * - volumeRegion: The full bounds of the volume, which may be larger than the data region
+ *
+ * If the @c MementoHandler exceeds its memory budget, the buffer is moved into the @c MementoJournal - a copy of
+ * the data or restoring the volume pages the buffer back in.
  */
 class MementoData {
 	friend struct MementoState;
@@ -183,9 +188,28 @@ private:
 	 */
 	voxel::Region _modifiedRegion{};
 
+	/**
+	 * @brief The journal that holds the compressed volume data if it was spilled to disk
+	 */
+	MementoJournalPtr _journal;
+	int64_t _journalOffset = -1;
+
 	MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &dataRegion, const voxel::Region &volumeRegion);
 	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &dataRegion, const voxel::Region &volumeRegion);
 
+	/**
+	 * @brief Release the buffer - it's read from the given journal entry if it's needed again
+	 */
+	void spill(const MementoJournalPtr &journal, int64_t offset);
+	/**
+	 * @return A newly allocated copy of the compressed data that is owned by the caller
+	 */
+	uint8_t *pageIn() const;
+	/**
+	 * @brief Give the journal entry back if the data was spilled - the range is reused by the journal
+	 */
+	void releaseJournal();
+
 public:
 	MementoData() {
 	}
@@ -225,12 +249,20 @@ public:
 	 * @return true if volume data is present, false if this is a metadata-only memento
 	 */
 	inline bool hasVolume() const {
-		return _buffer != nullptr;
+		return _buffer != nullptr || spilled();
+	}
+
+	/**
+	 * @return @c true if the compressed data was moved into the journal to free memory
+	 */
+	inline bool spilled() const {
+		return _journalOffset >= 0;
 	}
 
 	/**
 	 * @brief Get read-only access to the compressed data buffer
-	 * @return Pointer to the compressed data buffer, or nullptr if no data is present
+	 * @return Pointer to the compressed data buffer, or nullptr if no data is present or if the data was spilled to
+	 * disk - a copy of the data is always resident
 	 */
 	const uint8_t *buffer() const {
 		return _buffer;
@@ -392,7 +424,7 @@ struct MementoState {
 	 * @return true if compressed volume data is present, false for metadata-only changes
 	 */
 	inline bool hasVolumeData() const {
-		return data._buffer != nullptr;
+		return data.hasVolume();
 	}
 
 	/**
@@ -434,6 +466,23 @@ struct MementoStateGroup {
 };
 
 using MementoStates = core::RingBuffer<MementoStateGroup, 64u>;
+
+/**
+ * @brief Memory usage of the compressed volume data of all memento states
+ */
+struct MementoStatistics {
+	/** compressed volume data that is kept in memory */
+	size_t residentBytes = 0u;
+	/** compressed volume data that was moved into the journal */
+	size_t spilledBytes = 0u;
+	int residentStates = 0;
+	int spilledStates = 0;
+	/** the used size of the journal file - this includes released entries that are not yet reused */
+	int64_t journalBytes = 0;
+	/** a background task is currently writing states into the journal */
+	bool spilling = false;
+};
+
 /**
  * @brief Class that manages the undo and redo steps for the scene
  *
@@ -453,6 +502,40 @@ private:
 	// Network notification listeners
 	core::DynamicArray<IMementoStateListener *> _listeners;
 
+	/**
+	 * @brief The maximum amount of compressed volume data in bytes that is kept in memory - @c 0 means unlimited
+	 */
+	size_t _memoryBudget = 0u;
+	/**
+	 * @brief The amount of the most recent state groups that are never spilled to disk
+	 */
+	int _hotGroups = 8;
+	core::String _journalFile;
+	MementoJournalPtr _journal;
+
+	struct SpillEntry {
+		const uint8_t *buffer;
+		size_t size;
+		int64_t offset;
+	};
+	using SpillEntries = core::DynamicArray<SpillEntry>;
+	/**
+	 * @brief The buffers that are written into the journal in the background
+	 *
+	 * The buffers stay owned by the states - every operation that might delete a state waits for the task to finish.
+	 */
+	core::Future<SpillEntries> _spillFuture;
+
+	/**
+	 * @brief Write the older states into the journal if the resident data exceeds the memory budget
+	 */
+	void enforceBudget();
+	/**
+	 * @brief Release the buffers of the states that were written into the journal
+	 * @param[in] wait Block until the background task is done
+	 */
+	void finishSpill(bool wait);
+
 	void cutFromGroupStatePosition();
 	bool addState(MementoState &&state);
 	/**
@@ -501,6 +584,28 @@ public:
 	bool init() override;
 	void shutdown() override;
 
+	/**
+	 * @brief Picks up the results of the spill task - call this once per frame
+	 */
+	void update();
+
+	/**
+	 * @brief Limit the memory that is used by the compressed volume data of the undo states
+	 *
+	 * If the budget is exceeded, the volume data of older states is written to an on-disk journal in the background.
+	 * The data is read back transparently if an undo or redo step needs it.
+	 *
+	 * @param[in] budgetBytes The amount of compressed volume data to keep in memory - @c 0 disables the budget
+	 * @param[in] hotGroups The amount of the most recent state groups that are always kept in memory
+	 * @sa setJournalFile()
+	 */
+	void setMemoryBudget(size_t budgetBytes, int hotGroups);
+	/**
+	 * @brief The file that is used to spill states to disk - the budget is not enforced without a journal file
+	 */
+	void setJournalFile(const core::String &journalFile);
+	MementoStatistics statistics() const;
+
 	/**
 	 * @brief Add a listener for memento state changes
 	 * @param listener The listener to add (must remain valid until removed)
@@ -0,0 +1,149 @@
+/**
+ * @file
+ */
+
+#include "MementoJournal.h"
+#include "core/Log.h"
+#include "io/Filesystem.h"
+
+namespace memento {
+
+MementoJournal::MementoJournal(const core::String &path) : _path(path) {
+}
+
+MementoJournal::~MementoJournal() {
+	close();
+}
+
+bool MementoJournal::open() {
+	core::ScopedLock lock(_mutex);
+	_stream = nullptr;
+	_file = core::make_shared<io::File>(_path, io::FileMode::SysReadWrite);
+	if (!_file->validHandle()) {
+		Log::warn("Failed to open the memento journal %s", _path.c_str());
+		_file = {};
+		return false;
+	}
+	_stream = new io::FileStream(_file);
+	_size = 0;
+	_freeRanges.clear();
+	_freeBytes = 0;
+	Log::debug("Opened memento journal %s", _path.c_str());
+	return true;
+}
+
+void MementoJournal::close() {
+	core::ScopedLock lock(_mutex);
+	if (!_file) {
+		return;
+	}
+	_stream = nullptr;
+	_file = {};
+	_size = 0;
+	_freeRanges.clear();
+	_freeBytes = 0;
+	io::Filesystem::sysRemoveFile(_path);
+}
+
+int64_t MementoJournal::allocate(int64_t size) {
+	// first fit - the entries of an undo group have similar sizes
+	for (size_t i = 0; i < _freeRanges.size(); ++i) {
+		Range &range = _freeRanges[i];
+		if (range.size < size) {
+			continue;
+		}
+		const int64_t offset = range.offset;
+		range.offset += size;
+		range.size -= size;
+		_freeBytes -= size;
+		if (range.size == 0) {
+			_freeRanges.erase(i);
+		}
+		return offset;
+	}
+	const int64_t offset = _size;
+	_size += size;
+	return offset;
+}
+
+int64_t MementoJournal::append(const uint8_t *buf, size_t size) {
+	core::ScopedLock lock(_mutex);
+	if (_stream == nullptr) {
+		Log::error("The memento journal %s is not open", _path.c_str());
+		return -1;
+	}
+	const int64_t offset = allocate(entrySize(size));
+	if (_stream->seek(offset) == -1 || !_stream->writeUInt32((uint32_t)size) ||
+		_stream->write(buf, size) != (int)size) {
+		Log::error("Failed to write %i bytes into the memento journal", (int)size);
+		// the content of the file is unknown - don't hand out any further offsets
+		_stream = nullptr;
+		_file = {};
+		return -1;
+	}
+	return offset;
+}
+
+bool MementoJournal::read(int64_t offset, uint8_t *buf, size_t size) {
+	core::ScopedLock lock(_mutex);
+	if (_stream == nullptr) {
+		Log::error("The memento journal %s is not open", _path.c_str());
+		return false;
+	}
+	if (offset < 0 || offset + entrySize(size) > _size) {
+		Log::error("Invalid memento journal entry at %i", (int)offset);
+		return false;
+	}
+	if (_stream->seek(offset) == -1) {
+		Log::error("Failed to seek to the memento journal entry at %i", (int)offset);
+		return false;
+	}
+	uint32_t storedSize;
+	if (_stream->readUInt32(storedSize) != 0 || storedSize != (uint32_t)size) {
+		Log::error("Memento journal entry at %i doesn't match the expected size %i", (int)offset, (int)size);
+		return false;
+	}
+	if (_stream->read(buf, size) != (int)size) {
+		Log::error("Failed to read %i bytes from the memento journal", (int)size);
+		return false;
+	}
+	return true;
+}
+
+void MementoJournal::release(int64_t offset, size_t size) {
+	core::ScopedLock lock(_mutex);
+	if (_stream == nullptr) {
+		return;
+	}
+	const int64_t length = entrySize(size);
+	if (offset < 0 || offset + length > _size) {
+		Log::error("Invalid memento journal entry at %i", (int)offset);
+		return;
+	}
+	size_t idx = 0;
+	while (idx < _freeRanges.size() && _freeRanges[idx].offset < offset) {
+		++idx;
+	}
+	Range range{offset, length};
+	// merge with the adjacent ranges
+	if (idx < _freeRanges.size() && range.offset + range.size == _freeRanges[idx].offset) {
+		range.size += _freeRanges[idx].size;
+		_freeRanges.erase(idx);
+	}
+	if (idx > 0 && _freeRanges[idx - 1].offset + _freeRanges[idx - 1].size == range.offset) {
+		--idx;
+		range.offset = _freeRanges[idx].offset;
+		range.size += _freeRanges[idx].size;
+		_freeRanges.erase(idx);
+	}
+	_freeBytes += length;
+	if (range.offset + range.size == _size) {
+		// nothing follows - the next append writes at the end of the remaining entries
+		_size = range.offset;
+		_freeBytes -= range.size;
+		return;
+	}
+	_freeRanges.insert(_freeRanges.begin() + idx, range);
+}
+
+} // namespace memento
@@ -0,0 +1,111 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/ScopedPtr.h"
+#include "core/SharedPtr.h"
+#include "core/String.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
+#include "io/File.h"
+#include "io/FileStream.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace memento {
+
+/**
+ * @brief File that holds the compressed volume buffers of memento states that were spilled to disk
+ *
+ * The journal doesn't keep an index on its own - the offset that @c append() returns is stored in the spilled
+ * @c MementoData and used to page the buffer back in. Every entry is prefixed with its size to detect a mismatch
+ * between the index and the file.
+ *
+ * The entries of states that are gone are given back with @c release() - their ranges are reused by the following
+ * appends, and free ranges at the end of the journal shrink it.
+ *
+ * @note Appending, reading and releasing is thread safe - the buffers are written by a background task.
+ * @sa MementoHandler::setMemoryBudget()
+ */
+class MementoJournal {
+private:
+	struct Range {
+		int64_t offset;
+		int64_t size;
+	};
+	core::String _path;
+	io::FilePtr _file;
+	core::ScopedPtr<io::FileStream> _stream;
+	/** the end of the last entry */
+	int64_t _size = 0;
+	/** the released ranges sorted by their offset - adjacent ranges are merged */
+	core::DynamicArray<Range> _freeRanges;
+	int64_t _freeBytes = 0;
+	mutable core_trace_mutex(core::Lock, _mutex, "MementoJournal");
+
+	static inline int64_t entrySize(size_t size) {
+		return (int64_t)sizeof(uint32_t) + (int64_t)size;
+	}
+	/**
+	 * @return The offset of a released range that can hold the given amount of bytes or the end of the journal
+	 */
+	int64_t allocate(int64_t size);
+
+public:
+	MementoJournal(const core::String &path);
+	~MementoJournal();
+
+	/**
+	 * @brief Create or truncate the journal file
+	 */
+	bool open();
+	/**
+	 * @brief Close and delete the journal file
+	 */
+	void close();
+
+	/**
+	 * @return The offset of the entry that is needed to read the buffer back or @c -1 on error
+	 */
+	int64_t append(const uint8_t *buf, size_t size);
+	/**
+	 * @param[out] buf Must be able to hold @c size bytes
+	 */
+	bool read(int64_t offset, uint8_t *buf, size_t size);
+	/**
+	 * @brief Give the entry back - it's not read anymore and the range is reused
+	 * @param size The size that was given to @c append()
+	 */
+	void release(int64_t offset, size_t size);
+
+	/**
+	 * @return The size of the used part of the journal file in bytes - this includes the released ranges in between
+	 */
+	int64_t size() const;
+	/**
+	 * @return The bytes of the released ranges that are waiting to be reused
+	 */
+	int64_t freeBytes() const;
+	const core::String &path() const;
+};
+
+inline int64_t MementoJournal::size() const {
+	core::ScopedLock lock(_mutex);
+	return _size;
+}
+
+inline int64_t MementoJournal::freeBytes() const {
+	core::ScopedLock lock(_mutex);
+	return _freeBytes;
+}
+
+inline const core::String &MementoJournal::path() const {
+	return _path;
+}
+
+using MementoJournalPtr = core::SharedPtr<MementoJournal>;
+
+} // namespace memento
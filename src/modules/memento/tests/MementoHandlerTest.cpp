@@ -3,6 +3,7 @@
  */
 
 #include "../MementoHandler.h"
+#include "../MementoJournal.h"
 #include "app/tests/AbstractTest.h"
 #include "core/Pair.h"
 #include "core/StringUtil.h"
@@ -72,6 +73,12 @@ protected:
 		Super::TearDown();
 	}
 
+	void waitForSpill() {
+		while (_mementoHandler.statistics().spilling) {
+			_mementoHandler.update();
+		}
+	}
+
 	static inline MementoState firstState(const MementoStateGroup &group) {
 		core_assert(!group.states.empty());
 		return group.states[0];
@@ -1275,4 +1282,122 @@ TEST_F(MementoHandlerTest, testBeginEndGroupBothLocked) {
 	EXPECT_EQ(sizeBefore, (int)_mementoHandler.stateSize()) << "No state should be added when locked";
 }
 
+TEST_F(MementoHandlerTest, testJournal) {
+	const core::String &path = _testApp->filesystem()->homeWritePath("mementotest.journal");
+	MementoJournal journal(path);
+	ASSERT_TRUE(journal.open());
+	const uint8_t first[] = {1, 2, 3, 4, 5};
+	const uint8_t second[] = {6, 7, 8};
+	const int64_t firstOffset = journal.append(first, sizeof(first));
+	const int64_t secondOffset = journal.append(second, sizeof(second));
+	ASSERT_GE(firstOffset, 0);
+	ASSERT_GT(secondOffset, firstOffset);
+
+	uint8_t buf[5];
+	ASSERT_TRUE(journal.read(secondOffset, buf, sizeof(second)));
+	EXPECT_EQ(0, memcmp(buf, second, sizeof(second)));
+	EXPECT_FALSE(journal.read(secondOffset, buf, sizeof(first))) << "The size of the entry doesn't match";
+	// appending after reading must not overwrite the existing entries
+	const int64_t thirdOffset = journal.append(first, sizeof(first));
+	ASSERT_GT(thirdOffset, secondOffset);
+	ASSERT_TRUE(journal.read(firstOffset, buf, sizeof(first)));
+	EXPECT_EQ(0, memcmp(buf, first, sizeof(first)));
+	ASSERT_TRUE(journal.read(thirdOffset, buf, sizeof(first)));
+	EXPECT_EQ(0, memcmp(buf, first, sizeof(first)));
+	journal.close();
+	EXPECT_EQ(0, journal.size());
+}
+
+TEST_F(MementoHandlerTest, testJournalRelease) {
+	const core::String &path = _testApp->filesystem()->homeWritePath("mementotest.journal");
+	MementoJournal journal(path);
+	ASSERT_TRUE(journal.open());
+	const uint8_t first[] = {1, 2, 3, 4, 5};
+	const uint8_t second[] = {6, 7, 8};
+	const uint8_t third[] = {9, 10};
+	const int64_t firstOffset = journal.append(first, sizeof(first));
+	const int64_t secondOffset = journal.append(second, sizeof(second));
+	const int64_t thirdOffset = journal.append(third, sizeof(third));
+	ASSERT_GE(firstOffset, 0);
+	const int64_t size = journal.size();
+
+	// the released range is reused by an entry that fits into it
+	journal.release(firstOffset, sizeof(first));
+	EXPECT_EQ(size, journal.size());
+	EXPECT_GT(journal.freeBytes(), 0);
+	const int64_t reusedOffset = journal.append(second, sizeof(second));
+	EXPECT_EQ(firstOffset, reusedOffset);
+	EXPECT_EQ(size, journal.size());
+
+	uint8_t buf[5];
+	ASSERT_TRUE(journal.read(reusedOffset, buf, sizeof(second)));
+	EXPECT_EQ(0, memcmp(buf, second, sizeof(second)));
+	ASSERT_TRUE(journal.read(thirdOffset, buf, sizeof(third)));
+	EXPECT_EQ(0, memcmp(buf, third, sizeof(third)));
+
+	// releasing the entries at the end shrinks the journal - the free ranges are merged
+	journal.release(secondOffset, sizeof(second));
+	journal.release(thirdOffset, sizeof(third));
+	EXPECT_EQ(reusedOffset + (int64_t)sizeof(uint32_t) + (int64_t)sizeof(second), journal.size());
+	journal.release(reusedOffset, sizeof(second));
+	EXPECT_EQ(0, journal.size());
+	EXPECT_EQ(0, journal.freeBytes());
+	journal.close();
+	EXPECT_FALSE(_testApp->filesystem()->sysExists(path));
+}
+
+TEST_F(MementoHandlerTest, testUndoRedoSpilledStates) {
+	_mementoHandler.setJournalFile(_testApp->filesystem()->homeWritePath("mementotest.journal"));
+	// every state that is not hot exceeds the budget
+	_mementoHandler.setMemoryBudget(1u, 1);
+
+	const int n = 6;
+	for (int i = 0; i < n; ++i) {
+		core::SharedPtr<voxel::RawVolume> v = create(4);
+		v->setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 v.get(), MementoType::Modification));
+	}
+	waitForSpill();
+	MementoStatistics stats = _mementoHandler.statistics();
+	EXPECT_EQ(n - 1, stats.spilledStates);
+	EXPECT_EQ(1, stats.residentStates);
+	EXPECT_GT(stats.spilledBytes, 0u);
+	EXPECT_GT(stats.journalBytes, (int64_t)stats.spilledBytes);
+	EXPECT_TRUE(_mementoHandler.states()[0].states[0].hasVolumeData());
+	EXPECT_EQ(nullptr, _mementoHandler.states()[0].states[0].data.buffer());
+
+	// the undo states are paged in from the journal
+	for (int i = n - 1; i > 0; --i) {
+		ASSERT_TRUE(_mementoHandler.canUndo());
+		const MementoState &state = firstState(_mementoHandler.undo());
+		verifyVoxelState(state, core::String::format("undo %i", i), {{glm::ivec3(0), (uint8_t)i}});
+	}
+	EXPECT_FALSE(_mementoHandler.canUndo());
+	for (int i = 1; i < n; ++i) {
+		ASSERT_TRUE(_mementoHandler.canRedo());
+		const MementoState &state = firstState(_mementoHandler.redo());
+		verifyVoxelState(state, core::String::format("redo %i", i), {{glm::ivec3(0), (uint8_t)(i + 1)}});
+	}
+
+	_mementoHandler.clearStates();
+	stats = _mementoHandler.statistics();
+	EXPECT_EQ(0, stats.spilledStates);
+	EXPECT_EQ(0, stats.journalBytes);
+}
+
+TEST_F(MementoHandlerTest, testMemoryBudgetNotExceeded) {
+	_mementoHandler.setJournalFile(_testApp->filesystem()->homeWritePath("mementotest.journal"));
+	_mementoHandler.setMemoryBudget(1024u * 1024u, 1);
+	for (int i = 0; i < 4; ++i) {
+		core::SharedPtr<voxel::RawVolume> v = create(4);
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 v.get(), MementoType::Modification));
+	}
+	waitForSpill();
+	const MementoStatistics &stats = _mementoHandler.statistics();
+	EXPECT_EQ(0, stats.spilledStates);
+	EXPECT_EQ(4, stats.residentStates);
+}
+
 } // namespace memento
@@ -102,15 +102,28 @@ bool Metric::createTags(char *buffer, size_t len, const TagMap &tags, const char
 	return true;
 }
 
-bool Metric::assemble(const char *key, int value, const char *type, const TagMap &tags) const {
-	IMetricSenderPtr messageSender = _messageSender;
-	if (!messageSender) {
-		return false;
-	}
+bool Metric::format(core::DynamicArray<core::String> &lines, const char *key, int value, const char *type,
+					const TagMap &tags, float sampleRate) const {
 	constexpr int metricSize = 256;
 	char buffer[metricSize];
 	constexpr int tagsSize = 256;
 	char tagsBuffer[tagsSize] = "";
+	char rateBuffer[16] = "";
+	if (sampleRate < 1.0f) {
+		switch (_flavor) {
+		case Flavor::Etsy:
+		case Flavor::Datadog:
+		case Flavor::Telegraf:
+			SDL_snprintf(rateBuffer, sizeof(rateBuffer), "|@%g", sampleRate);
+			break;
+		default:
+			// no sample rate support in the format - scale the value up to the estimated total
+			if (sampleRate > 0.0f) {
+				value = (int)((float)value / sampleRate);
+			}
+			break;
+		}
+	}
 	int written;
 	switch (_flavor) {
 	case Flavor::JSON: {
@@ -132,21 +145,18 @@ bool Metric::assemble(const char *key, int value, const char *type, const TagMap
 		}
 		json.append("}");
 		json.append("}");
-		written = json.size();
-		if (!messageSender->send(json.c_str())) {
-			Log::warn("Failed to send metric - disable metrics for this session");
-			return false;
-		}
+		lines.push_back(json);
 		return true;
 	}
 	case Flavor::Etsy:
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s", _prefix.c_str(), key, value, type);
+		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s%s", _prefix.c_str(), key, value, type, rateBuffer);
 		break;
 	case Flavor::Datadog:
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, ":", "|#", ",")) {
 			return false;
 		}
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s%s", _prefix.c_str(), key, value, type, tagsBuffer);
+		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s%s%s", _prefix.c_str(), key, value, type,
+							   rateBuffer, tagsBuffer);
 		break;
 	case Flavor::Influx:
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, "=", ",", ",")) {
@@ -160,13 +170,76 @@ bool Metric::assemble(const char *key, int value, const char *type, const TagMap
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, "=", ",", ",")) {
 			return false;
 		}
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s%s:%i|%s", _prefix.c_str(), key, tagsBuffer, value, type);
+		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s%s:%i|%s%s", _prefix.c_str(), key, tagsBuffer, value,
+							   type, rateBuffer);
 		break;
 	}
 	if (written >= metricSize) {
 		return false;
 	}
-	return messageSender->send(buffer);
+	lines.push_back(buffer);
+	return true;
+}
+
+bool Metric::sendBatch(const core::DynamicArray<core::String> &lines) const {
+	IMetricSenderPtr messageSender = _messageSender;
+	if (!messageSender) {
+		return false;
+	}
+	if (_flavor == Flavor::JSON) {
+		core::String json;
+		json.append("[");
+		for (size_t i = 0; i < lines.size(); ++i) {
+			if (i > 0) {
+				json.append(",");
+			}
+			json.append(lines[i]);
+		}
+		json.append("]");
+		if (!messageSender->send(json.c_str())) {
+			Log::warn("Failed to send %i metrics", (int)lines.size());
+			return false;
+		}
+		return true;
+	}
+	bool success = true;
+	core::String batch;
+	for (const core::String &line : lines) {
+		if (!batch.empty() && batch.size() + 1 + line.size() > MaxBatchSize) {
+			success &= messageSender->send(batch.c_str());
+			batch.clear();
+		}
+		if (!batch.empty()) {
+			batch.append("\n");
+		}
+		batch.append(line);
+	}
+	if (!batch.empty()) {
+		success &= messageSender->send(batch.c_str());
+	}
+	return success;
+}
+
+bool Metric::assemble(const char *key, int value, const char *type, const TagMap &tags, float sampleRate) const {
+	IMetricSenderPtr messageSender = _messageSender;
+	if (!messageSender) {
+		return false;
+	}
+	if (sampleRate < 1.0f && SDL_randf() >= sampleRate) {
+		// not sampled - this is no error
+		return true;
+	}
+	core::DynamicArray<core::String> lines;
+	if (!format(lines, key, value, type, tags, sampleRate)) {
+		return false;
+	}
+	if (!messageSender->send(lines[0].c_str())) {
+		if (_flavor == Flavor::JSON) {
+			Log::warn("Failed to send metric - disable metrics for this session");
+		}
+		return false;
+	}
+	return true;
 }
 
 } // namespace metric
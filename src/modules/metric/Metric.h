@@ -13,6 +13,7 @@
 #include "IMetricSender.h"
 #include "core/NonCopyable.h"
 #include "core/SharedPtr.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicStringMap.h"
 #include "core/collection/StringMap.h"
 #include <stdint.h>
@@ -55,8 +56,13 @@ private:
 	 * @return @c false if not all tags could get written into the specified target buffer, @c true otherwise
 	 */
 	bool createTags(char *buffer, size_t len, const TagMap& tags, const char* sep, const char* preamble, const char *split = ",") const;
-	bool assemble(const char* key, int value, const char* type, const TagMap& tags = {}) const;
+	bool assemble(const char* key, int value, const char* type, const TagMap& tags = {}, float sampleRate = 1.0f) const;
 public:
+	/**
+	 * @brief The maximum size of a batch of metric lines that is sent as one udp datagram - this fits into the
+	 * ethernet mtu without fragmentation
+	 */
+	static constexpr size_t MaxBatchSize = 1432;
 	~Metric();
 
 	/**
@@ -66,6 +72,24 @@ public:
 	bool init(const char *prefix, const IMetricSenderPtr& messageSender);
 	void shutdown();
 
+	/**
+	 * @brief Format the metric line in the configured flavor without sending it
+	 * @param[out] lines The formatted line is appended here
+	 * @param[in] sampleRate The rate the value was sampled with - only the statsd flavors transmit it
+	 * @return @c false if the metric line could not get formatted
+	 */
+	bool format(core::DynamicArray<core::String> &lines, const char *key, int value, const char *type,
+				const TagMap &tags = {}, float sampleRate = 1.0f) const;
+
+	/**
+	 * @brief Send many formatted metric lines with as few requests as possible
+	 *
+	 * The json flavor sends all lines as one array. The other flavors join the lines with a newline into datagrams
+	 * of up to @c MaxBatchSize bytes.
+	 * @sa format()
+	 */
+	bool sendBatch(const core::DynamicArray<core::String> &lines) const;
+
 	/**
 	 * @brief Increments the key
 	 */
@@ -84,6 +108,7 @@ public:
 	 * of the number of samples per event count. For example, a sample rate of 1/10
 	 * would be exported as 0.1. Valid counter values are in the range (-2^63^, 2^63^).
 	 * @code <metric name>:<value>|c[|@<sample rate>] @endcode
+	 * A sample rate below @c 1 drops the calls on the client side - only the remaining ones are sent.
 	 * @note Record event counts
 	 */
 	bool count(const char* key, int delta, const TagMap& tags = {}, float sampleRate = 1.0f) const;
@@ -145,7 +170,7 @@ inline bool Metric::decrement(const char* key, const TagMap& tags) const {
 }
 
 inline bool Metric::count(const char* key, int delta, const TagMap& tags, float sampleRate) const {
-	return assemble(key, delta, "c", tags); // TODO:"|@%f", sampleRate
+	return assemble(key, delta, "c", tags, sampleRate);
 }
 
 inline bool Metric::gauge(const char* key, uint32_t value, const TagMap& tags) const {
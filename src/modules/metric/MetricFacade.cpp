@@ -4,6 +4,7 @@
 
 #include "MetricFacade.h"
 #include "app/I18N.h"
+#include "core/Common.h"
 #include "core/ConfigVar.h"
 #include "core/Log.h"
 #include "core/Var.h"
@@ -17,6 +18,7 @@ namespace metric {
 struct MetricState {
 	metric::IMetricSenderPtr _sender;
 	metric::Metric _metric;
+	metric::MetricRegistry _registry;
 	core::ThreadPool _threadPool{1, "metric"};
 
 	bool init(const core::String &appname);
@@ -56,11 +58,16 @@ bool MetricState::init(const core::String &appname) {
 		return false;
 	}
 	_threadPool.init();
+	const core::VarDef metricFlushInterval(cfg::MetricFlushInterval, 10000, N_("Metric flush interval"),
+										   N_("The milliseconds between sending the aggregated metrics"));
+	const int interval = core::Var::registerVar(metricFlushInterval)->intVal();
+	_registry.start(_metric, (uint32_t)core_max(interval, 100));
 	Log::info("Initialized metrics");
 	return true;
 }
 
 void MetricState::shutdown() {
+	_registry.stop();
 	_metric.shutdown();
 	_threadPool.shutdown(true);
 	if (_sender) {
@@ -75,6 +82,10 @@ bool count(const core::String &key, int delta, const TagMap &tags) {
 	return true;
 }
 
+MetricRegistry &registry() {
+	return MetricState::getInstance()._registry;
+}
+
 bool init(const core::String &appname) {
 	return MetricState::getInstance().init(appname);
 }
@@ -5,10 +5,16 @@
 #pragma once
 
 #include "Metric.h"
+#include "MetricRegistry.h"
 
 namespace metric {
 
 bool count(const core::String &key, int delta = 1, const TagMap &tags = {});
+/**
+ * @brief The registry of the aggregated metrics - they are flushed every @c metric_flushinterval milliseconds once
+ * the metrics are initialized
+ */
+MetricRegistry &registry();
 bool init(const core::String &appname);
 void shutdown();
 
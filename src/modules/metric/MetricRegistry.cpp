@@ -0,0 +1,255 @@
+/**
+ * @file
+ */
+
+#include "MetricRegistry.h"
+#include "core/Common.h"
+#include "core/Log.h"
+
+namespace metric {
+
+namespace {
+
+static core::AtomicInt _nextShard{0};
+static thread_local int _shard = -1;
+
+inline int threadShard(int shards) {
+	if (_shard == -1) {
+		_shard = _nextShard.increment() % shards;
+	}
+	return _shard;
+}
+
+inline const char *typeName(MetricType type) {
+	switch (type) {
+	case MetricType::Counter:
+		return "counter";
+	case MetricType::Gauge:
+		return "gauge";
+	case MetricType::Histogram:
+		break;
+	}
+	return "summary";
+}
+
+} // namespace
+
+MetricRegistry::MetricRegistry(int maxMetrics) : _maxMetrics(maxMetrics) {
+	_slots = new Slot[Shards * _maxMetrics];
+	_definitions.reserve(_maxMetrics);
+}
+
+MetricRegistry::~MetricRegistry() {
+	if (_running) {
+		Log::warn("The metric flusher is still running - call stop() before destroying the registry");
+		stop();
+	}
+	delete[] _slots;
+}
+
+MetricRegistry::Slot &MetricRegistry::slot(int shard, MetricId id) const {
+	return _slots[shard * _maxMetrics + id];
+}
+
+MetricId MetricRegistry::add(const core::String &name, const TagMap &tags, MetricType type) {
+	core::ScopedLock lock(_lock);
+	for (int i = 0; i < (int)_definitions.size(); ++i) {
+		const Definition &def = _definitions[i];
+		if (def.type != type || def.name != name || def.tags.size() != tags.size()) {
+			continue;
+		}
+		bool same = true;
+		for (const auto &e : tags) {
+			core::String value;
+			if (!def.tags.get(e->first, value) || value != e->second) {
+				same = false;
+				break;
+			}
+		}
+		if (same) {
+			return i;
+		}
+	}
+	if ((int)_definitions.size() >= _maxMetrics) {
+		Log::warn("Failed to register metric %s - the registry is full", name.c_str());
+		return InvalidMetricId;
+	}
+	_definitions.push_back({name, tags, type});
+	const int id = (int)_definitions.size() - 1;
+	_registered = id + 1;
+	return id;
+}
+
+MetricId MetricRegistry::counter(const core::String &name, const TagMap &tags) {
+	return add(name, tags, MetricType::Counter);
+}
+
+MetricId MetricRegistry::gauge(const core::String &name, const TagMap &tags) {
+	return add(name, tags, MetricType::Gauge);
+}
+
+MetricId MetricRegistry::histogram(const core::String &name, const TagMap &tags) {
+	return add(name, tags, MetricType::Histogram);
+}
+
+void MetricRegistry::add(MetricId id, int delta) {
+	if (id < 0 || id >= _maxMetrics) {
+		return;
+	}
+	slot(threadShard(Shards), id).value.increment(delta);
+}
+
+void MetricRegistry::set(MetricId id, int value) {
+	if (id < 0 || id >= _maxMetrics) {
+		return;
+	}
+	Slot &s = slot(0, id);
+	s.value = value;
+	s.count = 1;
+}
+
+void MetricRegistry::record(MetricId id, int value) {
+	if (id < 0 || id >= _maxMetrics) {
+		return;
+	}
+	Slot &s = slot(threadShard(Shards), id);
+	s.value.increment(value);
+	s.count.increment(1);
+	int current = s.min;
+	while (value < current && !s.min.compare_exchange(current, value)) {
+		current = s.min;
+	}
+	current = s.max;
+	while (value > current && !s.max.compare_exchange(current, value)) {
+		current = s.max;
+	}
+}
+
+MetricRegistry::Aggregate MetricRegistry::aggregate(MetricId id, MetricType type, bool reset) const {
+	Aggregate a;
+	if (type == MetricType::Gauge) {
+		Slot &s = slot(0, id);
+		a.count = reset ? s.count.exchange(0) : (int)s.count;
+		a.value = (int)s.value;
+		return a;
+	}
+	// values that are added while the shards are collected might end up in the next interval
+	for (int shard = 0; shard < Shards; ++shard) {
+		Slot &s = slot(shard, id);
+		if (reset) {
+			a.value += s.value.exchange(0);
+			a.count += s.count.exchange(0);
+			const int min = s.min.exchange(INT32_MAX);
+			const int max = s.max.exchange(INT32_MIN);
+			a.min = core_min(a.min, min);
+			a.max = core_max(a.max, max);
+		} else {
+			a.value += (int)s.value;
+			a.count += (int)s.count;
+			a.min = core_min(a.min, (int)s.min);
+			a.max = core_max(a.max, (int)s.max);
+		}
+	}
+	return a;
+}
+
+bool MetricRegistry::flush(const Metric &metric) {
+	core_trace_scoped(MetricRegistryFlush);
+	core::DynamicArray<core::String> lines;
+	core::ScopedLock lock(_lock);
+	for (int i = 0; i < (int)_definitions.size(); ++i) {
+		const Definition &def = _definitions[i];
+		const Aggregate &a = aggregate(i, def.type, true);
+		const char *name = def.name.c_str();
+		switch (def.type) {
+		case MetricType::Counter:
+			if (a.value != 0) {
+				metric.format(lines, name, (int)a.value, "c", def.tags);
+			}
+			break;
+		case MetricType::Gauge:
+			if (a.count > 0) {
+				metric.format(lines, name, (int)a.value, "g", def.tags);
+			}
+			break;
+		case MetricType::Histogram:
+			if (a.count > 0) {
+				metric.format(lines, (def.name + ".count").c_str(), (int)a.count, "c", def.tags);
+				metric.format(lines, (def.name + ".min").c_str(), a.min, "g", def.tags);
+				metric.format(lines, (def.name + ".max").c_str(), a.max, "g", def.tags);
+				metric.format(lines, (def.name + ".avg").c_str(), (int)(a.value / a.count), "g", def.tags);
+			}
+			break;
+		}
+	}
+	if (lines.empty()) {
+		return true;
+	}
+	return metric.sendBatch(lines);
+}
+
+bool MetricRegistry::start(const Metric &metric, uint32_t intervalMillis) {
+	if (_running.exchange(true)) {
+		return false;
+	}
+	const Metric *m = &metric;
+	_thread = core::Thread(
+		[this, m, intervalMillis]() {
+			while (_running) {
+				_flushLock.lock();
+				if (_running) {
+					_flushCondition.waitTimeout(_flushLock, intervalMillis);
+				}
+				_flushLock.unlock();
+				flush(*m);
+			}
+		},
+		"MetricFlush");
+	return true;
+}
+
+void MetricRegistry::stop() {
+	_flushLock.lock();
+	const bool running = _running.exchange(false);
+	_flushCondition.notify_all();
+	_flushLock.unlock();
+	if (running) {
+		// the thread flushes one last time before it quits
+		_thread.join();
+	}
+}
+
+core::String MetricRegistry::dump() const {
+	core::String out;
+	core::ScopedLock lock(_lock);
+	for (int i = 0; i < (int)_definitions.size(); ++i) {
+		const Definition &def = _definitions[i];
+		core::String labels;
+		for (const auto &e : def.tags) {
+			labels += labels.empty() ? "{" : ",";
+			labels += core::String::format("%s=\"%s\"", e->first.c_str(), e->second.c_str());
+		}
+		if (!labels.empty()) {
+			labels += "}";
+		}
+		out += core::String::format("# TYPE %s %s\n", def.name.c_str(), typeName(def.type));
+		const Aggregate &a = aggregate(i, def.type, false);
+		if (def.type == MetricType::Histogram) {
+			out += core::String::format("%s_count%s %i\n", def.name.c_str(), labels.c_str(), (int)a.count);
+			out += core::String::format("%s_sum%s %i\n", def.name.c_str(), labels.c_str(), (int)a.value);
+			if (a.count > 0) {
+				out += core::String::format("%s_min%s %i\n", def.name.c_str(), labels.c_str(), a.min);
+				out += core::String::format("%s_max%s %i\n", def.name.c_str(), labels.c_str(), a.max);
+			}
+		} else {
+			out += core::String::format("%s%s %i\n", def.name.c_str(), labels.c_str(), (int)a.value);
+		}
+	}
+	return out;
+}
+
+int MetricRegistry::size() const {
+	return _registered;
+}
+
+} // namespace metric
@@ -0,0 +1,141 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Metric.h"
+#include "core/NonCopyable.h"
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/Thread.h"
+#include "core/Trace.h"
+
+namespace metric {
+
+enum class MetricType : uint8_t { Counter, Gauge, Histogram };
+
+/**
+ * @brief The handle of a registered metric - @c InvalidMetricId if the registry is full
+ */
+using MetricId = int;
+static constexpr MetricId InvalidMetricId = -1;
+
+/**
+ * @brief Aggregates pre-registered metrics on the client side and sends them in batches
+ *
+ * The metrics are registered once and updated by their handle. Updating a metric doesn't allocate, doesn't format
+ * anything and doesn't lock - every thread writes into one of a few shards of atomic slots. The flush sums up the
+ * shards, resets them and sends all metrics of the interval in as few datagrams or requests as possible.
+ *
+ * @code
+ * static const metric::MetricId extractions = registry.counter("mesh_extractions");
+ * registry.add(extractions);
+ * @endcode
+ *
+ * @ingroup Metric
+ */
+class MetricRegistry : public core::NonCopyable {
+private:
+	static constexpr int Shards = 16;
+
+	struct Definition {
+		core::String name;
+		TagMap tags;
+		MetricType type;
+	};
+
+	/**
+	 * @brief The values of one metric in one shard
+	 *
+	 * Counters use @c value, histograms all members. Gauges only use the first shard - @c count marks the gauge as
+	 * set since the last flush.
+	 */
+	struct Slot {
+		core::AtomicInt value{0};
+		core::AtomicInt count{0};
+		core::AtomicInt min{INT32_MAX};
+		core::AtomicInt max{INT32_MIN};
+	};
+
+	/** the aggregated values of all shards */
+	struct Aggregate {
+		int64_t value = 0;
+		int64_t count = 0;
+		int min = INT32_MAX;
+		int max = INT32_MIN;
+	};
+
+	const int _maxMetrics;
+	Slot *_slots;
+	core::DynamicArray<Definition> _definitions;
+	core::AtomicInt _registered{0};
+	mutable core_trace_mutex(core::Lock, _lock, "MetricRegistry");
+
+	// background flusher
+	core::Thread _thread;
+	core::ConditionVariable _flushCondition;
+	core_trace_mutex(core::Lock, _flushLock, "MetricRegistryFlush");
+	core::AtomicBool _running{false};
+
+	MetricId add(const core::String &name, const TagMap &tags, MetricType type);
+	Slot &slot(int shard, MetricId id) const;
+	Aggregate aggregate(MetricId id, MetricType type, bool reset) const;
+
+public:
+	/**
+	 * @param maxMetrics The amount of metrics that can be registered
+	 */
+	MetricRegistry(int maxMetrics = 256);
+	~MetricRegistry();
+
+	/**
+	 * @brief Register a counter - the deltas of an interval are summed up and sent as one count
+	 * @note Registering the same name and tags again returns the same handle
+	 */
+	MetricId counter(const core::String &name, const TagMap &tags = {});
+	/**
+	 * @brief Register a gauge - only the last value of an interval is sent
+	 */
+	MetricId gauge(const core::String &name, const TagMap &tags = {});
+	/**
+	 * @brief Register a histogram - the count, min, max and average of the values of an interval are sent
+	 */
+	MetricId histogram(const core::String &name, const TagMap &tags = {});
+
+	void add(MetricId id, int delta = 1);
+	void set(MetricId id, int value);
+	void record(MetricId id, int value);
+
+	/**
+	 * @brief Send the values of the metrics that changed since the last flush and reset them
+	 */
+	bool flush(const Metric &metric);
+
+	/**
+	 * @brief Flush the metrics every @c intervalMillis milliseconds in a background thread
+	 * @note The metric instance must outlive the flusher - see @c stop()
+	 */
+	bool start(const Metric &metric, uint32_t intervalMillis);
+	/**
+	 * @brief Stop the background flusher - the remaining values are flushed one last time
+	 */
+	void stop();
+
+	/**
+	 * @brief Text exposition of the values that were not yet flushed - the values are not reset
+	 *
+	 * @code
+	 * # TYPE mesh_extractions counter
+	 * mesh_extractions{node="1"} 42
+	 * @endcode
+	 */
+	core::String dump() const;
+
+	int size() const;
+};
+
+} // namespace metric
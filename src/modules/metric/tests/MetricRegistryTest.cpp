@@ -0,0 +1,202 @@
+/**
+ * @file
+ */
+
+#include "metric/MetricRegistry.h"
+#include "core/Var.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Thread.h"
+#include "core/tests/TestHelper.h"
+#include "metric/IMetricSender.h"
+#include "metric/UDPMetricSender.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace metric {
+
+class BatchSender : public IMetricSender {
+private:
+	mutable core::DynamicArray<core::String> _buffers;
+
+public:
+	bool send(const char *buffer) const override {
+		_buffers.push_back(buffer);
+		return true;
+	}
+
+	inline const core::DynamicArray<core::String> &buffers() const {
+		return _buffers;
+	}
+};
+
+class MetricRegistryTest : public testing::Test {
+protected:
+	void SetUp() override {
+		const core::VarDef metricUUID(cfg::MetricUUID, "fake", "", "");
+		core::Var::registerVar(metricUUID);
+		const core::VarDef metricFlavor("metric_flavor", "", "", "");
+		core::Var::registerVar(metricFlavor)->setVal("etsy");
+	}
+};
+
+TEST_F(MetricRegistryTest, testRegisterSameHandle) {
+	MetricRegistry registry;
+	const MetricId id = registry.counter("count", {{"key", "value"}});
+	EXPECT_NE(InvalidMetricId, id);
+	EXPECT_EQ(id, registry.counter("count", {{"key", "value"}}));
+	EXPECT_NE(id, registry.counter("count", {{"key", "other"}}));
+	EXPECT_NE(id, registry.gauge("count", {{"key", "value"}}));
+	EXPECT_EQ(3, registry.size());
+}
+
+TEST_F(MetricRegistryTest, testRegistryFull) {
+	MetricRegistry registry(1);
+	EXPECT_NE(InvalidMetricId, registry.counter("first"));
+	EXPECT_EQ(InvalidMetricId, registry.counter("second"));
+	// updating an invalid handle is ignored
+	registry.add(InvalidMetricId);
+}
+
+TEST_F(MetricRegistryTest, testShardedCounter) {
+	MetricRegistry registry;
+	const MetricId id = registry.counter("extractions");
+	constexpr int Threads = 4;
+	constexpr int Increments = 10000;
+	core::Thread threads[Threads];
+	for (int i = 0; i < Threads; ++i) {
+		threads[i] = core::Thread(
+			[&registry, id]() {
+				for (int n = 0; n < Increments; ++n) {
+					registry.add(id);
+				}
+			},
+			"MetricRegistryTest");
+	}
+	for (int i = 0; i < Threads; ++i) {
+		threads[i].join();
+	}
+	EXPECT_EQ("# TYPE extractions counter\nextractions 40000\n", registry.dump());
+}
+
+TEST_F(MetricRegistryTest, testDump) {
+	MetricRegistry registry;
+	const MetricId gauge = registry.gauge("memory", {{"node", "1"}});
+	const MetricId histogram = registry.histogram("brush");
+	registry.set(gauge, 5);
+	registry.set(gauge, 7);
+	registry.record(histogram, 3);
+	registry.record(histogram, 9);
+	EXPECT_EQ("# TYPE memory gauge\n"
+			  "memory{node=\"1\"} 7\n"
+			  "# TYPE brush summary\n"
+			  "brush_count 2\n"
+			  "brush_sum 12\n"
+			  "brush_min 3\n"
+			  "brush_max 9\n",
+			  registry.dump());
+}
+
+TEST_F(MetricRegistryTest, testFlushBatch) {
+	const core::SharedPtr<BatchSender> sender = core::make_shared<BatchSender>();
+	Metric metric;
+	ASSERT_TRUE(metric.init("test", sender));
+	MetricRegistry registry;
+	const MetricId counter = registry.counter("counter");
+	const MetricId unused = registry.counter("unused");
+	const MetricId histogram = registry.histogram("histogram");
+	registry.add(counter, 2);
+	registry.add(counter, 3);
+	registry.record(histogram, 2);
+	registry.record(histogram, 6);
+	(void)unused;
+	ASSERT_TRUE(registry.flush(metric));
+	ASSERT_EQ(1u, sender->buffers().size());
+	EXPECT_EQ("test.counter:5|c\n"
+			  "test.histogram.count:2|c\n"
+			  "test.histogram.min:2|g\n"
+			  "test.histogram.max:6|g\n"
+			  "test.histogram.avg:4|g",
+			  sender->buffers()[0]);
+
+	// the values are reset by the flush - nothing to send
+	ASSERT_TRUE(registry.flush(metric));
+	EXPECT_EQ(1u, sender->buffers().size());
+}
+
+TEST_F(MetricRegistryTest, testFlushSplitsBatches) {
+	const core::SharedPtr<BatchSender> sender = core::make_shared<BatchSender>();
+	Metric metric;
+	ASSERT_TRUE(metric.init("test", sender));
+	MetricRegistry registry;
+	for (int i = 0; i < 200; ++i) {
+		registry.add(registry.counter(core::String::format("counter%i", i)));
+	}
+	ASSERT_TRUE(registry.flush(metric));
+	ASSERT_GT(sender->buffers().size(), 1u);
+	int lines = 0;
+	for (const core::String &buffer : sender->buffers()) {
+		EXPECT_LE(buffer.size(), Metric::MaxBatchSize);
+		lines += 1;
+		for (char c : buffer) {
+			lines += c == '\n' ? 1 : 0;
+		}
+	}
+	EXPECT_EQ(200, lines);
+}
+
+TEST_F(MetricRegistryTest, testSampleRate) {
+	const core::SharedPtr<BatchSender> sender = core::make_shared<BatchSender>();
+	Metric metric;
+	ASSERT_TRUE(metric.init("test", sender));
+	core::DynamicArray<core::String> lines;
+	ASSERT_TRUE(metric.format(lines, "sampled", 1, "c", {}, 0.5f));
+	ASSERT_EQ(1u, lines.size());
+	EXPECT_EQ("test.sampled:1|c|@0.5", lines[0]);
+}
+
+#ifndef _WIN32
+TEST_F(MetricRegistryTest, testUDPBatching) {
+	const int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	ASSERT_NE(-1, fd);
+	struct sockaddr_in addr;
+	SDL_memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	ASSERT_EQ(0, bind(fd, (struct sockaddr *)&addr, sizeof(addr)));
+	socklen_t addrLen = sizeof(addr);
+	ASSERT_EQ(0, getsockname(fd, (struct sockaddr *)&addr, &addrLen));
+	struct timeval timeout;
+	timeout.tv_sec = 2;
+	timeout.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	const core::SharedPtr<UDPMetricSender> sender =
+		core::make_shared<UDPMetricSender>("127.0.0.1", (int)ntohs(addr.sin_port));
+	ASSERT_TRUE(sender->init());
+	Metric metric;
+	ASSERT_TRUE(metric.init("test", sender));
+	MetricRegistry registry;
+	const MetricId counter = registry.counter("counter");
+	const MetricId gauge = registry.gauge("gauge");
+	registry.add(counter, 42);
+	registry.set(gauge, 3);
+	ASSERT_TRUE(registry.flush(metric));
+
+	char buffer[2048];
+	const ssize_t received = recv(fd, buffer, sizeof(buffer) - 1, 0);
+	close(fd);
+	sender->shutdown();
+	ASSERT_GT(received, 0) << "Didn't receive the metric datagram";
+	buffer[received] = '\0';
+	EXPECT_STREQ("test.counter:42|c\ntest.gauge:3|g", buffer);
+}
+#endif
+
+} // namespace metric
@@ -0,0 +1,363 @@
+/**
+ * @file
+ */
+
+#include "NoiseGrid.h"
+#include "Noise.h"
+#include "Simplex.h"
+#include "app/ForParallel.h"
+#include "core/ArrayLength.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include <SDL3/SDL_stdinc.h>
+
+namespace noise {
+
+namespace {
+
+// the samples of a row are evaluated in batches of this size - the loops over the lanes are written to be
+// vectorized by the compiler, only the permutation table lookups are gathered one by one
+static constexpr int Lanes = 8;
+
+// the same (double) constants as in Simplex.h - the intermediate results are promoted the same way to get the
+// same values as the per point functions
+static constexpr double F2 = 0.366025403;
+static constexpr double G2 = 0.211324865;
+static constexpr double F3 = 0.333333333;
+static constexpr double G3 = 0.166666667;
+
+using Perm = details::LutType;
+
+inline int fastFloor(float x) {
+	return x > 0 ? (int)x : ((int)x) - 1;
+}
+
+struct Batch {
+	float x[Lanes];
+	float y[Lanes];
+	float z[Lanes];
+};
+
+void simplex2(const Perm *perm, const float *vx, const float *vy, float *out) {
+	float x0[Lanes], y0[Lanes];
+	int ii[Lanes], jj[Lanes], i1[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		const float s = (vx[l] + vy[l]) * F2;
+		const float xs = vx[l] + s;
+		const float ys = vy[l] + s;
+		const int i = fastFloor(xs);
+		const int j = fastFloor(ys);
+		const float t = (float)(i + j) * G2;
+		const float X0 = i - t;
+		const float Y0 = j - t;
+		x0[l] = vx[l] - X0;
+		y0[l] = vy[l] - Y0;
+		i1[l] = x0[l] > y0[l] ? 1 : 0;
+		ii[l] = i & 0xff;
+		jj[l] = j & 0xff;
+	}
+	int h0[Lanes], h1[Lanes], h2[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		const int j1 = 1 - i1[l];
+		h0[l] = perm[ii[l] + perm[jj[l]]];
+		h1[l] = perm[ii[l] + i1[l] + perm[jj[l] + j1]];
+		h2[l] = perm[ii[l] + 1 + perm[jj[l] + 1]];
+	}
+	for (int l = 0; l < Lanes; ++l) {
+		const int j1 = 1 - i1[l];
+		const float x1 = x0[l] - i1[l] + G2;
+		const float y1 = y0[l] - j1 + G2;
+		const float x2 = x0[l] - 1.0f + 2.0f * G2;
+		const float y2 = y0[l] - 1.0f + 2.0f * G2;
+		float t0 = 0.5f - x0[l] * x0[l] - y0[l] * y0[l];
+		float t1 = 0.5f - x1 * x1 - y1 * y1;
+		float t2 = 0.5f - x2 * x2 - y2 * y2;
+		t0 = t0 < 0.0f ? 0.0f : t0 * t0;
+		t1 = t1 < 0.0f ? 0.0f : t1 * t1;
+		t2 = t2 < 0.0f ? 0.0f : t2 * t2;
+		const float n0 = t0 * t0 * details::grad(h0[l], x0[l], y0[l]);
+		const float n1 = t1 * t1 * details::grad(h1[l], x1, y1);
+		const float n2 = t2 * t2 * details::grad(h2[l], x2, y2);
+		out[l] = 40.0f * (n0 + n1 + n2);
+	}
+}
+
+void simplex3(const Perm *perm, const float *vx, const float *vy, const float *vz, float *out) {
+	float x0[Lanes], y0[Lanes], z0[Lanes];
+	int ii[Lanes], jj[Lanes], kk[Lanes];
+	int i1[Lanes], j1[Lanes], k1[Lanes], i2[Lanes], j2[Lanes], k2[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		const float s = (vx[l] + vy[l] + vz[l]) * F3;
+		const float xs = vx[l] + s;
+		const float ys = vy[l] + s;
+		const float zs = vz[l] + s;
+		const int i = fastFloor(xs);
+		const int j = fastFloor(ys);
+		const int k = fastFloor(zs);
+		const float t = (float)(i + j + k) * G3;
+		const float X0 = i - t;
+		const float Y0 = j - t;
+		const float Z0 = k - t;
+		const float x = vx[l] - X0;
+		const float y = vy[l] - Y0;
+		const float z = vz[l] - Z0;
+		x0[l] = x;
+		y0[l] = y;
+		z0[l] = z;
+		// the offsets of the second and third corner of the simplex - the six branches of the per point
+		// function expressed by the order of the components
+		const int xy = x >= y;
+		const int yz = y >= z;
+		const int xz = x >= z;
+		i1[l] = xy & xz;
+		j1[l] = (1 - xy) & yz;
+		k1[l] = (1 - xz) & (1 - yz);
+		i2[l] = xy | xz;
+		j2[l] = (1 - xy) | yz;
+		k2[l] = (1 - xz) | (1 - yz);
+		ii[l] = i & 0xff;
+		jj[l] = j & 0xff;
+		kk[l] = k & 0xff;
+	}
+	int h0[Lanes], h1[Lanes], h2[Lanes], h3[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		h0[l] = perm[ii[l] + perm[jj[l] + perm[kk[l]]]];
+		h1[l] = perm[ii[l] + i1[l] + perm[jj[l] + j1[l] + perm[kk[l] + k1[l]]]];
+		h2[l] = perm[ii[l] + i2[l] + perm[jj[l] + j2[l] + perm[kk[l] + k2[l]]]];
+		h3[l] = perm[ii[l] + 1 + perm[jj[l] + 1 + perm[kk[l] + 1]]];
+	}
+	for (int l = 0; l < Lanes; ++l) {
+		const float x1 = x0[l] - i1[l] + G3;
+		const float y1 = y0[l] - j1[l] + G3;
+		const float z1 = z0[l] - k1[l] + G3;
+		const float x2 = x0[l] - i2[l] + 2.0f * G3;
+		const float y2 = y0[l] - j2[l] + 2.0f * G3;
+		const float z2 = z0[l] - k2[l] + 2.0f * G3;
+		const float x3 = x0[l] - 1.0f + 3.0f * G3;
+		const float y3 = y0[l] - 1.0f + 3.0f * G3;
+		const float z3 = z0[l] - 1.0f + 3.0f * G3;
+		float t0 = 0.6f - x0[l] * x0[l] - y0[l] * y0[l] - z0[l] * z0[l];
+		float t1 = 0.6f - x1 * x1 - y1 * y1 - z1 * z1;
+		float t2 = 0.6f - x2 * x2 - y2 * y2 - z2 * z2;
+		float t3 = 0.6f - x3 * x3 - y3 * y3 - z3 * z3;
+		t0 = t0 < 0.0f ? 0.0f : t0 * t0;
+		t1 = t1 < 0.0f ? 0.0f : t1 * t1;
+		t2 = t2 < 0.0f ? 0.0f : t2 * t2;
+		t3 = t3 < 0.0f ? 0.0f : t3 * t3;
+		const float n0 = t0 * t0 * details::grad(h0[l], x0[l], y0[l], z0[l]);
+		const float n1 = t1 * t1 * details::grad(h1[l], x1, y1, z1);
+		const float n2 = t2 * t2 * details::grad(h2[l], x2, y2, z2);
+		const float n3 = t3 * t3 * details::grad(h3[l], x3, y3, z3);
+		out[l] = 32.0f * (n0 + n1 + n2 + n3);
+	}
+}
+
+void simplex(const Perm *perm, int dims, const Batch &in, float *out) {
+	if (dims == 2) {
+		simplex2(perm, in.x, in.y, out);
+	} else {
+		simplex3(perm, in.x, in.y, in.z, out);
+	}
+}
+
+void fBm(const Perm *perm, int dims, const Batch &in, const NoiseGrid &grid, float *out) {
+	float sum[Lanes]{};
+	float freq = 1.0f;
+	float amp = 0.5f;
+	Batch scaled;
+	float n[Lanes];
+	for (uint8_t i = 0; i < grid.octaves; ++i) {
+		for (int l = 0; l < Lanes; ++l) {
+			scaled.x[l] = in.x[l] * freq;
+			scaled.y[l] = in.y[l] * freq;
+			scaled.z[l] = in.z[l] * freq;
+		}
+		simplex(perm, dims, scaled, n);
+		for (int l = 0; l < Lanes; ++l) {
+			sum[l] += n[l] * amp;
+		}
+		freq *= grid.lacunarity;
+		amp *= grid.gain;
+	}
+	SDL_memcpy(out, sum, sizeof(sum));
+}
+
+void ridgedMF(const Perm *perm, int dims, const Batch &in, const NoiseGrid &grid, float *out) {
+	float sum[Lanes]{};
+	float prev[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		prev[l] = 1.0f;
+	}
+	float freq = 1.0f;
+	float amp = 0.5f;
+	Batch scaled;
+	float n[Lanes];
+	for (uint8_t i = 0; i < grid.octaves; ++i) {
+		for (int l = 0; l < Lanes; ++l) {
+			scaled.x[l] = in.x[l] * freq;
+			scaled.y[l] = in.y[l] * freq;
+			scaled.z[l] = in.z[l] * freq;
+		}
+		simplex(perm, dims, scaled, n);
+		for (int l = 0; l < Lanes; ++l) {
+			float h = grid.ridgeOffset - glm::abs(n[l]);
+			h = h * h;
+			sum[l] += h * amp * prev[l];
+			prev[l] = h;
+		}
+		freq *= grid.lacunarity;
+		amp *= grid.gain;
+	}
+	for (int l = 0; l < Lanes; ++l) {
+		out[l] = sum[l] * 2.0f - 0.5f;
+	}
+}
+
+void worley(const Perm *perm, int dims, const Batch &in, float *out) {
+	Batch p;
+	Batch f;
+	for (int l = 0; l < Lanes; ++l) {
+		p.x[l] = glm::floor(in.x[l]);
+		p.y[l] = glm::floor(in.y[l]);
+		p.z[l] = glm::floor(in.z[l]);
+		f.x[l] = in.x[l] - p.x[l];
+		f.y[l] = in.y[l] - p.y[l];
+		f.z[l] = in.z[l] - p.z[l];
+	}
+	float res[Lanes];
+	for (int l = 0; l < Lanes; ++l) {
+		res[l] = 8.0f;
+	}
+	const int kmin = dims == 2 ? 0 : -1;
+	const int kmax = dims == 2 ? 0 : 1;
+	Batch cell;
+	float n[Lanes];
+	for (int k = kmin; k <= kmax; ++k) {
+		for (int j = -1; j <= 1; ++j) {
+			for (int i = -1; i <= 1; ++i) {
+				for (int l = 0; l < Lanes; ++l) {
+					cell.x[l] = p.x[l] + (float)i;
+					cell.y[l] = p.y[l] + (float)j;
+					cell.z[l] = p.z[l] + (float)k;
+				}
+				simplex(perm, dims, cell, n);
+				for (int l = 0; l < Lanes; ++l) {
+					const float o = n[l] * 0.5f + 0.5f;
+					const float rx = (float)i - f.x[l] + o;
+					const float ry = (float)j - f.y[l] + o;
+					float d;
+					if (dims == 2) {
+						d = rx * rx + ry * ry;
+					} else {
+						const float rz = (float)k - f.z[l] + o;
+						d = rx * rx + ry * ry + rz * rz;
+					}
+					res[l] = (glm::min)(res[l], d);
+				}
+			}
+		}
+	}
+	for (int l = 0; l < Lanes; ++l) {
+		out[l] = sqrt(res[l]) * 2.0f - 1.0f;
+	}
+}
+
+void evaluate(const Perm *perm, const Noise &voronoi, int dims, const Batch &in, const NoiseGrid &grid, float *out) {
+	switch (grid.type) {
+	case NoiseGridType::Simplex:
+		simplex(perm, dims, in, out);
+		break;
+	case NoiseGridType::FBm:
+		fBm(perm, dims, in, grid, out);
+		break;
+	case NoiseGridType::RidgedMF:
+		ridgedMF(perm, dims, in, grid, out);
+		break;
+	case NoiseGridType::Worley:
+		worley(perm, dims, in, out);
+		break;
+	case NoiseGridType::Voronoi:
+		// integer hashing in double precision - there is no batched version of this
+		for (int l = 0; l < Lanes; ++l) {
+			const glm::dvec3 pos(in.x[l], in.y[l], in.z[l]);
+			out[l] = (float)voronoi.voronoi(pos, grid.enableDistance, grid.frequency, grid.seed);
+		}
+		break;
+	case NoiseGridType::Max:
+		break;
+	}
+}
+
+/**
+ * @brief Evaluate one row of @c width samples along the x axis
+ */
+void fillRow(const Perm *perm, const Noise &voronoi, int dims, float *out, int width, float y, float z,
+			 const NoiseGrid &grid) {
+	Batch in;
+	float values[Lanes];
+	for (int x = 0; x < width; x += Lanes) {
+		const int count = core_min(Lanes, width - x);
+		for (int l = 0; l < Lanes; ++l) {
+			// the lanes after the end of the row repeat the last sample
+			const int lx = x + core_min(l, count - 1);
+			in.x[l] = grid.origin.x + (float)lx * grid.step.x;
+			in.y[l] = y;
+			in.z[l] = z;
+		}
+		evaluate(perm, voronoi, dims, in, grid, values);
+		core_memcpy(out + x, values, count * sizeof(float));
+	}
+}
+
+} // namespace
+
+NoiseGridType toNoiseGridType(const char *name) {
+	static const char *names[] = {"simplex", "fbm", "ridgedmf", "worley", "voronoi"};
+	static_assert(lengthof(names) == (int)NoiseGridType::Max, "Array size doesn't match enum values");
+	for (int i = 0; i < lengthof(names); ++i) {
+		if (SDL_strcasecmp(names[i], name) == 0) {
+			return (NoiseGridType)i;
+		}
+	}
+	return NoiseGridType::Max;
+}
+
+void fillNoise2D(float *out, int width, int height, const NoiseGrid &grid) {
+	core_trace_scoped(FillNoise2D);
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	// the permutation table is thread local - all rows use the one of the calling thread
+	Perm perm[512];
+	core_memcpy(perm, details::perm, sizeof(perm));
+	const Noise voronoi;
+	app::for_parallel(0, height, [&](int start, int end) {
+		for (int y = start; y < end; ++y) {
+			const float py = grid.origin.y + (float)y * grid.step.y;
+			fillRow(perm, voronoi, 2, out + (size_t)y * width, width, py, grid.origin.z, grid);
+		}
+	});
+}
+
+void fillNoise3D(float *out, int width, int height, int depth, const NoiseGrid &grid) {
+	core_trace_scoped(FillNoise3D);
+	if (width <= 0 || height <= 0 || depth <= 0) {
+		return;
+	}
+	Perm perm[512];
+	core_memcpy(perm, details::perm, sizeof(perm));
+	const Noise voronoi;
+	// split the rows of all slabs - a thin volume still uses all threads
+	app::for_parallel(0, height * depth, [&](int start, int end) {
+		for (int row = start; row < end; ++row) {
+			const int y = row % height;
+			const int z = row / height;
+			const float py = grid.origin.y + (float)y * grid.step.y;
+			const float pz = grid.origin.z + (float)z * grid.step.z;
+			fillRow(perm, voronoi, 3, out + (size_t)row * width, width, py, pz, grid);
+		}
+	});
+}
+
+} // namespace noise
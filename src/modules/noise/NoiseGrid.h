@@ -0,0 +1,64 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace noise {
+
+enum class NoiseGridType : uint8_t { Simplex, FBm, RidgedMF, Worley, Voronoi, Max };
+
+/**
+ * @brief Parameters for evaluating a noise function over a whole grid of sample positions
+ *
+ * The sample at the grid coordinate @c (x,y,z) is taken at @c origin+(x,y,z)*step. The parameters have the same
+ * meaning and defaults as the per point functions in @c Simplex.h and @c Noise::voronoi().
+ */
+struct NoiseGrid {
+	NoiseGridType type = NoiseGridType::FBm;
+	/** the position of the first sample */
+	glm::vec3 origin{0.0f};
+	/** the distance between two samples on each axis */
+	glm::vec3 step{1.0f};
+	uint8_t octaves = 4;
+	float lacunarity = 2.0f;
+	float gain = 0.5f;
+	/** @c NoiseGridType::RidgedMF only */
+	float ridgeOffset = 1.0f;
+	/** @c NoiseGridType::Voronoi only */
+	float frequency = 1.0f;
+	/** @c NoiseGridType::Voronoi only */
+	int seed = 0;
+	/** @c NoiseGridType::Voronoi only */
+	bool enableDistance = true;
+};
+
+/**
+ * @brief Parse the lower case name of a noise type - e.g. @c fbm or @c ridgedmf
+ * @return @c NoiseGridType::Max if the name is unknown
+ */
+NoiseGridType toNoiseGridType(const char *name);
+
+/**
+ * @brief Evaluate the 2d noise for @c width * @c height samples
+ *
+ * The rows are split over the thread pool and the samples of a row are evaluated in batches of 8 lanes. The
+ * results match the per point functions like @c noise::fBm(glm::vec2) - the simplex permutation table of the
+ * calling thread is used for all rows.
+ *
+ * @param[out] out Receives the sample @c (x,y) at @c out[y*width+x] - must be able to hold @c width*height values
+ * @note Voronoi is only available in 3d - the 2d grid uses @c origin.z as third component.
+ */
+void fillNoise2D(float *out, int width, int height, const NoiseGrid &grid);
+
+/**
+ * @brief Evaluate the 3d noise for @c width * @c height * @c depth samples
+ * @param[out] out Receives the sample @c (x,y,z) at @c out[(z*height+y)*width+x]
+ * @sa fillNoise2D()
+ */
+void fillNoise3D(float *out, int width, int height, int depth, const NoiseGrid &grid);
+
+} // namespace noise
@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/collection/DynamicArray.h"
+#include "noise/NoiseGrid.h"
+#include "noise/Simplex.h"
+
+class NoiseGridBenchmark : public app::AbstractBenchmark {};
+
+BENCHMARK_DEFINE_F(NoiseGridBenchmark, PerPoint2D)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	core::DynamicArray<float> out;
+	out.resize(size * size);
+	for (auto _ : state) {
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				out[y * size + x] = noise::fBm(glm::vec2(x, y) * 0.01f);
+			}
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK_DEFINE_F(NoiseGridBenchmark, Grid2D)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	core::DynamicArray<float> out;
+	out.resize(size * size);
+	noise::NoiseGrid grid;
+	grid.step = glm::vec3(0.01f);
+	for (auto _ : state) {
+		noise::fillNoise2D(out.data(), size, size, grid);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK_DEFINE_F(NoiseGridBenchmark, PerPoint3D)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	core::DynamicArray<float> out;
+	out.resize(size * size * size);
+	for (auto _ : state) {
+		for (int z = 0; z < size; ++z) {
+			for (int y = 0; y < size; ++y) {
+				for (int x = 0; x < size; ++x) {
+					out[(z * size + y) * size + x] = noise::fBm(glm::vec3(x, y, z) * 0.01f);
+				}
+			}
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+BENCHMARK_DEFINE_F(NoiseGridBenchmark, Grid3D)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	core::DynamicArray<float> out;
+	out.resize(size * size * size);
+	noise::NoiseGrid grid;
+	grid.step = glm::vec3(0.01f);
+	for (auto _ : state) {
+		noise::fillNoise3D(out.data(), size, size, size, grid);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+BENCHMARK_REGISTER_F(NoiseGridBenchmark, PerPoint2D)->Arg(256);
+BENCHMARK_REGISTER_F(NoiseGridBenchmark, Grid2D)->Arg(256);
+BENCHMARK_REGISTER_F(NoiseGridBenchmark, PerPoint3D)->Arg(64);
+BENCHMARK_REGISTER_F(NoiseGridBenchmark, Grid3D)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#include "noise/NoiseGrid.h"
+#include "app/tests/AbstractTest.h"
+#include "core/collection/DynamicArray.h"
+#include "noise/Noise.h"
+#include "noise/Simplex.h"
+
+namespace noise {
+
+class NoiseGridTest : public app::AbstractTest {
+protected:
+	static constexpr float Epsilon = 0.00001f;
+
+	float expected2D(const NoiseGrid &grid, const glm::vec2 &pos) const {
+		switch (grid.type) {
+		case NoiseGridType::Simplex:
+			return noise::noise(pos);
+		case NoiseGridType::FBm:
+			return noise::fBm(pos, grid.octaves, grid.lacunarity, grid.gain);
+		case NoiseGridType::RidgedMF:
+			return noise::ridgedMF(pos, grid.ridgeOffset, grid.octaves, grid.lacunarity, grid.gain);
+		case NoiseGridType::Worley:
+			return noise::worleyNoise(pos);
+		default:
+			return expected3D(grid, glm::vec3(pos, grid.origin.z));
+		}
+	}
+
+	float expected3D(const NoiseGrid &grid, const glm::vec3 &pos) const {
+		switch (grid.type) {
+		case NoiseGridType::Simplex:
+			return noise::noise(pos);
+		case NoiseGridType::FBm:
+			return noise::fBm(pos, grid.octaves, grid.lacunarity, grid.gain);
+		case NoiseGridType::RidgedMF:
+			return noise::ridgedMF(pos, grid.ridgeOffset, grid.octaves, grid.lacunarity, grid.gain);
+		case NoiseGridType::Worley:
+			return noise::worleyNoise(pos);
+		default:
+			break;
+		}
+		Noise noise;
+		return (float)noise.voronoi(glm::dvec3(pos), grid.enableDistance, grid.frequency, grid.seed);
+	}
+
+	void check2D(NoiseGridType type) {
+		NoiseGrid grid;
+		grid.type = type;
+		grid.origin = glm::vec3(-3.7f, 1.3f, 0.5f);
+		grid.step = glm::vec3(0.173f, 0.291f, 0.1f);
+		// not a multiple of the batch size
+		const int width = 19;
+		const int height = 7;
+		core::DynamicArray<float> out;
+		out.resize(width * height);
+		fillNoise2D(out.data(), width, height, grid);
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				const glm::vec2 pos(grid.origin.x + (float)x * grid.step.x, grid.origin.y + (float)y * grid.step.y);
+				ASSERT_NEAR(expected2D(grid, pos), out[y * width + x], Epsilon) << "at " << x << ":" << y;
+			}
+		}
+	}
+
+	void check3D(NoiseGridType type) {
+		NoiseGrid grid;
+		grid.type = type;
+		grid.origin = glm::vec3(2.1f, -0.6f, 5.3f);
+		grid.step = glm::vec3(0.217f, 0.151f, 0.389f);
+		const int width = 13;
+		const int height = 5;
+		const int depth = 3;
+		core::DynamicArray<float> out;
+		out.resize(width * height * depth);
+		fillNoise3D(out.data(), width, height, depth, grid);
+		for (int z = 0; z < depth; ++z) {
+			for (int y = 0; y < height; ++y) {
+				for (int x = 0; x < width; ++x) {
+					const glm::vec3 pos = grid.origin + glm::vec3(x, y, z) * grid.step;
+					ASSERT_NEAR(expected3D(grid, pos), out[(z * height + y) * width + x], Epsilon)
+						<< "at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(NoiseGridTest, testSimplex) {
+	check2D(NoiseGridType::Simplex);
+	check3D(NoiseGridType::Simplex);
+}
+
+TEST_F(NoiseGridTest, testFBm) {
+	check2D(NoiseGridType::FBm);
+	check3D(NoiseGridType::FBm);
+}
+
+TEST_F(NoiseGridTest, testRidgedMF) {
+	check2D(NoiseGridType::RidgedMF);
+	check3D(NoiseGridType::RidgedMF);
+}
+
+TEST_F(NoiseGridTest, testWorley) {
+	check2D(NoiseGridType::Worley);
+	check3D(NoiseGridType::Worley);
+}
+
+TEST_F(NoiseGridTest, testVoronoi) {
+	check2D(NoiseGridType::Voronoi);
+	check3D(NoiseGridType::Voronoi);
+}
+
+TEST_F(NoiseGridTest, testToNoiseGridType) {
+	EXPECT_EQ(NoiseGridType::FBm, toNoiseGridType("fbm"));
+	EXPECT_EQ(NoiseGridType::RidgedMF, toNoiseGridType("ridgedmf"));
+	EXPECT_EQ(NoiseGridType::Max, toNoiseGridType("unknown"));
+}
+
+} // namespace noise
@@ -3,16 +3,19 @@
  */
 
 #include "PaletteCache.h"
+#include "core/MemoryAccounting.h"
 #include "io/Filesystem.h"
 #include "palette/Palette.h"
 
 namespace palette {
 
 void PaletteCache::clear() {
+	core_memory_scoped(PaletteCache);
 	_availablePalettes.clear();
 }
 
 void PaletteCache::detectPalettes(bool includeBuiltIn) {
+	core_memory_scoped(PaletteCache);
 	core::DynamicArray<io::FilesystemEntry> entities;
 	_filesystem->list("", entities, "palette-*.png");
 	for (const io::FilesystemEntry &file : entities) {
@@ -31,6 +34,7 @@ void PaletteCache::detectPalettes(bool includeBuiltIn) {
 }
 
 void PaletteCache::add(const core::String &paletteName) {
+	core_memory_scoped(PaletteCache);
 	_availablePalettes.push_back(paletteName);
 }
 
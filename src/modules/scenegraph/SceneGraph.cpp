@@ -30,6 +30,7 @@
 #include <SDL3/SDL_stdinc.h>
 #include "voxel/Voxel.h"
 #include "voxel/external/stb_rect_pack.h"
+#include "voxelutil/Raycast.h"
 #include "voxelutil/VolumeMerger.h"
 #include "voxelutil/VolumeRotator.h"
 #include "voxelutil/VolumeVisitor.h"
@@ -1430,6 +1431,90 @@ const voxel::RawVolume *SceneGraph::resolveVolume(const SceneGraphNode &n) const
 	return n.volume();
 }
 
+const voxel::VolumeOccupancy *SceneGraph::resolveOccupancy(const SceneGraphNode &n) const {
+	if (n.type() == SceneGraphNodeType::ModelReference) {
+		int refId = InvalidNodeId;
+		if (!resolveModelReferenceTarget(*this, n, refId)) {
+			return nullptr;
+		}
+		return resolveOccupancy(node(refId));
+	}
+	core_assert_msg(n.type() == SceneGraphNodeType::Model, "Trying to resolve occupancy for node of type %i", (int)n.type());
+	if (n.volume() == nullptr) {
+		return nullptr;
+	}
+	return &n.occupancy();
+}
+
+bool SceneGraph::raycast(const math::Ray &ray, float rayLength, FrameIndex frameIdx, SceneGraphRaycastHit &hit,
+						 bool skipHidden) const {
+	core_trace_scoped(SceneGraphRaycast);
+	struct Candidate {
+		int nodeId;
+		float distance;
+	};
+	core::DynamicArray<Candidate> candidates;
+	candidates.reserve(_nodes.size());
+	for (const auto &entry : nodes()) {
+		const SceneGraphNode &node = entry->second;
+		if (!node.isAnyModelNode()) {
+			continue;
+		}
+		if (skipHidden && !node.visible()) {
+			continue;
+		}
+		float distance = 0.0f;
+		const math::OBBF &obb = sceneOBB(node, frameIdx);
+		if (obb.intersect(ray.origin, ray.direction, distance) && distance <= rayLength) {
+			candidates.push_back({node.id(), distance});
+		}
+	}
+	candidates.sort([](const Candidate &a, const Candidate &b) { return a.distance > b.distance; });
+
+	bool found = false;
+	for (const Candidate &candidate : candidates) {
+		if (found && candidate.distance > hit.distance) {
+			// all remaining boxes start behind the closest hit
+			break;
+		}
+		const SceneGraphNode &node = this->node(candidate.nodeId);
+		const voxel::RawVolume *volume = resolveVolume(node);
+		const voxel::VolumeOccupancy *occupancy = resolveOccupancy(node);
+		if (volume == nullptr || occupancy == nullptr) {
+			continue;
+		}
+		const glm::mat4 &model = worldMatrix(node, frameIdx, true);
+		const glm::mat4 &invModel = glm::inverse(model);
+		const glm::vec3 localOrigin(invModel * glm::vec4(ray.origin, 1.0f));
+		const glm::vec3 localDir = glm::normalize(glm::vec3(invModel * glm::vec4(ray.direction, 0.0f)));
+		bool didHit = false;
+		glm::ivec3 hitVoxel(0);
+		const voxelutil::RaycastResult &result = voxelutil::raycastWithEndpoints(
+			volume, *occupancy, localOrigin, localOrigin + localDir * rayLength,
+			[&](voxel::RawVolume::Sampler &sampler) {
+				if (voxel::isAir(sampler.voxel().getMaterial())) {
+					return true;
+				}
+				didHit = true;
+				hitVoxel = sampler.position();
+				return false;
+			});
+		if (!didHit) {
+			continue;
+		}
+		const glm::vec3 &localHit = localOrigin + localDir * result.length;
+		const float distance = glm::distance(ray.origin, glm::vec3(model * glm::vec4(localHit, 1.0f)));
+		if (!found || distance < hit.distance) {
+			found = true;
+			hit.nodeId = candidate.nodeId;
+			hit.distance = distance;
+			hit.voxel = hitVoxel;
+			hit.normal = result.normal;
+		}
+	}
+	return found;
+}
+
 voxel::RawVolume *SceneGraph::resolveVolume(SceneGraphNode &n) {
 	if (n.type() == SceneGraphNodeType::ModelReference) {
 		int refId = InvalidNodeId;
@@ -18,6 +18,7 @@
 #include "core/concurrent/Lock.h"
 #include "math/AABB.h"
 #include "math/OBB.h"
+#include "math/Ray.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
 #include "scenegraph/CollisionNode.h"
@@ -46,6 +47,20 @@ enum class NodeMoveFlag : uint8_t {
 	Max
 };
 
+/**
+ * @brief The closest voxel that was hit by a ray
+ * @sa SceneGraph::raycast()
+ */
+struct SceneGraphRaycastHit {
+	int nodeId = InvalidNodeId;
+	/** the world space distance from the ray origin to the hit face */
+	float distance = 0.0f;
+	/** the position of the hit voxel in the volume of the node */
+	glm::ivec3 voxel{0};
+	/** the normal of the hit face in the volume of the node */
+	glm::ivec3 normal{0};
+};
+
 /**
  * @brief The internal format for the save/load methods.
  *
@@ -339,6 +354,23 @@ public:
 	 */
 	const voxel::RawVolume *resolveVolume(const SceneGraphNode &node) const;
 	voxel::RawVolume *resolveVolume(SceneGraphNode &node);
+	/**
+	 * Performs the recursive lookup in case of model references
+	 * @return The occupancy of the resolved volume or @c nullptr if there is no volume
+	 */
+	const voxel::VolumeOccupancy *resolveOccupancy(const SceneGraphNode &node) const;
+
+	/**
+	 * @brief Find the closest voxel of all model nodes that is hit by the given ray
+	 *
+	 * The nodes are visited in the order in which the ray enters their oriented bounding boxes. This stops as soon as
+	 * the next box starts behind the closest hit. The volumes are traversed with their occupancy to skip the empty
+	 * space.
+	 * @param ray The world space ray - the direction must be normalized
+	 * @param skipHidden Ignore the nodes that are not visible
+	 */
+	bool raycast(const math::Ray &ray, float rayLength, FrameIndex frameIdx, SceneGraphRaycastHit &hit,
+				 bool skipHidden = true) const;
 
 	/**
 	 * @brief Delete the owned volumes
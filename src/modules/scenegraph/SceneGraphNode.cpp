@@ -34,6 +34,13 @@ SceneGraphNode::SceneGraphNode(SceneGraphNode &&move) noexcept {
 	_palette = core::move(move._palette);
 	_normalPalette = core::move(move._normalPalette);
 	_ikConstraint = core::move(move._ikConstraint);
+	_selection = core::move(move._selection);
+	_selectionVolumeRegion = move._selectionVolumeRegion;
+	move._selectionVolumeRegion = voxel::Region::InvalidRegion;
+	_occupancy = core::move(move._occupancy);
+	_occupancyDirtyRegion = move._occupancyDirtyRegion;
+	_occupancyVolumeRegion = move._occupancyVolumeRegion;
+	move._occupancyVolumeRegion = voxel::Region::InvalidRegion;
 	_color = move._color;
 	_opacity = move._opacity;
 	_parent = move._parent;
@@ -73,6 +80,13 @@ SceneGraphNode &SceneGraphNode::operator=(SceneGraphNode &&move) noexcept {
 	_palette = core::move(move._palette);
 	_normalPalette = core::move(move._normalPalette);
 	_ikConstraint = core::move(move._ikConstraint);
+	_selection = core::move(move._selection);
+	_selectionVolumeRegion = move._selectionVolumeRegion;
+	move._selectionVolumeRegion = voxel::Region::InvalidRegion;
+	_occupancy = core::move(move._occupancy);
+	_occupancyDirtyRegion = move._occupancyDirtyRegion;
+	_occupancyVolumeRegion = move._occupancyVolumeRegion;
+	move._occupancyVolumeRegion = voxel::Region::InvalidRegion;
 	_color = move._color;
 	_opacity = move._opacity;
 	_parent = move._parent;
@@ -376,6 +390,8 @@ void SceneGraphNode::release() {
 		releaseOwnership();
 	}
 	_volume = nullptr;
+	_selectionVolumeRegion = voxel::Region::InvalidRegion;
+	_occupancyVolumeRegion = voxel::Region::InvalidRegion;
 }
 
 void SceneGraphNode::releaseOwnership() {
@@ -500,25 +516,92 @@ const voxel::Region &SceneGraphNode::region() const {
 	return _volume->region();
 }
 
-bool SceneGraphNode::hasSelection() const {
+voxel::SelectionMask &SceneGraphNode::syncSelection() const {
+	if (!_selection.hasValue()) {
+		_selection.setValue(voxel::SelectionMask());
+	}
+	voxel::SelectionMask &mask = *_selection.value();
 	if (_volume == nullptr) {
-		return false;
+		mask.clear();
+		_selectionVolumeRegion = voxel::Region::InvalidRegion;
+		return mask;
+	}
+	const voxel::Region &region = _volume->region();
+	if (_selectionVolumeRegion != region) {
+		mask.clear();
+		mask.readFlags(*_volume, region, voxel::FlagOutline);
+		_selectionVolumeRegion = region;
+	}
+	return mask;
+}
+
+const voxel::SelectionMask &SceneGraphNode::selection() const {
+	return syncSelection();
+}
+
+void SceneGraphNode::selectionFromFlags(const voxel::Region &region) {
+	if (_volume == nullptr || !region.isValid()) {
+		return;
+	}
+	syncSelection().readFlags(*_volume, region, voxel::FlagOutline);
+}
+
+const voxel::VolumeOccupancy &SceneGraphNode::occupancy() const {
+	if (!_occupancy.hasValue()) {
+		_occupancy.setValue(voxel::VolumeOccupancy());
+	}
+	voxel::VolumeOccupancy &occupancy = *_occupancy.value();
+	if (_volume == nullptr) {
+		occupancy.init(voxel::Region::InvalidRegion);
+		_occupancyVolumeRegion = voxel::Region::InvalidRegion;
+		_occupancyDirtyRegion = voxel::Region::InvalidRegion;
+		return occupancy;
+	}
+	const voxel::Region &region = _volume->region();
+	if (_occupancyVolumeRegion != region) {
+		occupancy.build(*_volume);
+		_occupancyVolumeRegion = region;
+		_occupancyDirtyRegion = voxel::Region::InvalidRegion;
+	} else if (_occupancyDirtyRegion.isValid()) {
+		occupancy.update(*_volume, _occupancyDirtyRegion);
+		_occupancyDirtyRegion = voxel::Region::InvalidRegion;
+	}
+	return occupancy;
+}
+
+void SceneGraphNode::occupancyModified(const voxel::Region &region) {
+	if (!region.isValid()) {
+		_occupancyVolumeRegion = voxel::Region::InvalidRegion;
+	} else if (_occupancyDirtyRegion.isValid()) {
+		_occupancyDirtyRegion.accumulate(region);
+	} else {
+		_occupancyDirtyRegion = region;
 	}
-	return _volume->hasFlags(_volume->region(), voxel::FlagOutline);
+}
+
+bool SceneGraphNode::hasSelection() const {
+	return !syncSelection().empty();
 }
 
 void SceneGraphNode::invertSelection() {
 	if (_volume == nullptr) {
 		return;
 	}
+	voxel::SelectionMask &mask = syncSelection();
 	_volume->toggleFlags(_volume->region(), voxel::FlagOutline);
+	mask.invert(_volume->region());
 }
 
 void SceneGraphNode::clearSelection() {
 	if (_volume == nullptr) {
 		return;
 	}
-	_volume->removeFlags(_volume->region(), voxel::FlagOutline);
+	voxel::SelectionMask &mask = syncSelection();
+	// only the bricks with selected voxels are touched
+	mask.visitBricks(_volume->region(), [this](const voxel::Region &brickRegion) {
+		_volume->removeFlags(brickRegion, voxel::FlagOutline);
+	});
+	mask.clear();
 }
 
 void SceneGraphNode::select(const voxel::Region &region) {
@@ -532,7 +615,9 @@ void SceneGraphNode::select(const voxel::Region &region) {
 	if (!clamped.cropTo(_volume->region())) {
 		return;
 	}
+	voxel::SelectionMask &mask = syncSelection();
 	_volume->setFlags(clamped, voxel::FlagOutline);
+	mask.set(clamped);
 }
 
 void SceneGraphNode::unselect(const voxel::Region &region) {
@@ -546,7 +631,81 @@ void SceneGraphNode::unselect(const voxel::Region &region) {
 	if (!clamped.cropTo(_volume->region())) {
 		return;
 	}
+	voxel::SelectionMask &mask = syncSelection();
 	_volume->removeFlags(clamped, voxel::FlagOutline);
+	mask.unset(clamped);
+}
+
+bool SceneGraphNode::select(const glm::ivec3 &pos) {
+	if (_volume == nullptr || !_volume->region().containsPoint(pos)) {
+		return false;
+	}
+	if (!syncSelection().set(pos)) {
+		return false;
+	}
+	voxel::Voxel v = _volume->voxel(pos);
+	v.setFlags(v.getFlags() | voxel::FlagOutline);
+	_volume->setVoxel(pos, v);
+	return true;
+}
+
+bool SceneGraphNode::unselect(const glm::ivec3 &pos) {
+	if (_volume == nullptr || !_volume->region().containsPoint(pos)) {
+		return false;
+	}
+	if (!syncSelection().unset(pos)) {
+		return false;
+	}
+	voxel::Voxel v = _volume->voxel(pos);
+	v.setFlags(v.getFlags() & ~voxel::FlagOutline);
+	_volume->setVoxel(pos, v);
+	return true;
+}
+
+voxel::Region SceneGraphNode::growSelection() {
+	if (_volume == nullptr) {
+		return voxel::Region::InvalidRegion;
+	}
+	voxel::SelectionMask &mask = syncSelection();
+	voxel::SelectionMask added = mask;
+	added.grow();
+	added.subtract(mask);
+	const voxel::Region &region = _volume->region();
+	voxel::Region dirtyRegion = voxel::Region::InvalidRegion;
+	added.visit([&](int x, int y, int z) {
+		if (!region.containsPoint(x, y, z)) {
+			return;
+		}
+		voxel::Voxel v = _volume->voxel(x, y, z);
+		if (voxel::isAir(v.getMaterial())) {
+			return;
+		}
+		v.setFlags(v.getFlags() | voxel::FlagOutline);
+		_volume->setVoxel(x, y, z, v);
+		mask.set(x, y, z);
+		if (dirtyRegion.isValid()) {
+			dirtyRegion.accumulate(x, y, z);
+		} else {
+			dirtyRegion = voxel::Region(x, y, z, x, y, z);
+		}
+	});
+	return dirtyRegion;
+}
+
+voxel::Region SceneGraphNode::shrinkSelection() {
+	if (_volume == nullptr) {
+		return voxel::Region::InvalidRegion;
+	}
+	voxel::SelectionMask &mask = syncSelection();
+	voxel::SelectionMask removed = mask;
+	mask.shrink();
+	removed.subtract(mask);
+	removed.visit([this](int x, int y, int z) {
+		voxel::Voxel v = _volume->voxel(x, y, z);
+		v.setFlags(v.getFlags() & ~voxel::FlagOutline);
+		_volume->setVoxel(x, y, z, v);
+	});
+	return removed.region();
 }
 
 bool SceneGraphNode::isLeaf() const {
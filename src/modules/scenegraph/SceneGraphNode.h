@@ -16,6 +16,8 @@
 #include "scenegraph/SceneGraphNodeProperties.h"
 #include "scenegraph/IKConstraint.h"
 #include "voxel/Region.h"
+#include "voxel/SelectionMask.h"
+#include "voxel/VolumeOccupancy.h"
 
 namespace voxel {
 class RawVolume;
@@ -84,6 +86,17 @@ protected:
 	mutable core::Optional<palette::Palette> _palette;
 	mutable core::Optional<palette::NormalPalette> _normalPalette;
 	core::Optional<IKConstraint> _ikConstraint;
+	mutable core::Optional<voxel::SelectionMask> _selection;
+	/** the volume region that the selection mask was read for - a new volume needs to read the selection again */
+	mutable voxel::Region _selectionVolumeRegion = voxel::Region::InvalidRegion;
+
+	mutable core::Optional<voxel::VolumeOccupancy> _occupancy;
+	/** the part of the volume that must be scanned again before the occupancy is used again */
+	mutable voxel::Region _occupancyDirtyRegion = voxel::Region::InvalidRegion;
+	/** the volume region that the occupancy was built for - any other region needs a full build */
+	mutable voxel::Region _occupancyVolumeRegion = voxel::Region::InvalidRegion;
+
+	voxel::SelectionMask &syncSelection() const;
 
 	/**
 	 * @brief Called in emplace() if a parent is given
@@ -248,12 +261,59 @@ public:
 	float opacity() const;
 	void setOpacity(float opacity);
 
+	/**
+	 * @brief The selected voxels of the volume
+	 *
+	 * The sparse mask is the selection - all queries and all selection functions of the node work on it. The
+	 * @c voxel::FlagOutline of the voxels is only written for the renderer and the file formats. The mask is read from
+	 * these flags once if a new volume is set.
+	 */
+	const voxel::SelectionMask &selection() const;
+	/**
+	 * @brief Replace the selection in the given region with the voxels that have @c voxel::FlagOutline set
+	 *
+	 * Only needed if voxel data with selection flags was copied into the volume without the selection functions of
+	 * this node - e.g. by restoring an undo state.
+	 */
+	void selectionFromFlags(const voxel::Region &region);
 	bool hasSelection() const;
 
+	/**
+	 * @brief The coarse occupancy of the volume to skip the empty space in raycasts
+	 *
+	 * It's built on the first access and only the modified regions are scanned again after that.
+	 * @note Only valid for model nodes with a volume
+	 */
+	const voxel::VolumeOccupancy &occupancy() const;
+	/**
+	 * @brief Mark the voxels in the given region as modified - the occupancy is updated for this region on the next
+	 * access
+	 * @param region An invalid region builds the occupancy for the whole volume again
+	 */
+	void occupancyModified(const voxel::Region &region);
+
 	void invertSelection();
 	void clearSelection();
 	void select(const voxel::Region &region);
 	void unselect(const voxel::Region &region);
+	/**
+	 * @return @c false if the position is outside of the volume or was already selected
+	 */
+	bool select(const glm::ivec3 &pos);
+	/**
+	 * @return @c false if the position is outside of the volume or wasn't selected
+	 */
+	bool unselect(const glm::ivec3 &pos);
+	/**
+	 * @brief Add the solid face neighbours of the selected voxels to the selection
+	 * @return The region of the voxels that were added
+	 */
+	voxel::Region growSelection();
+	/**
+	 * @brief Remove the selected voxels that have an unselected face neighbour from the selection
+	 * @return The region of the voxels that were removed
+	 */
+	voxel::Region shrinkSelection();
 
 	const SceneGraphNodeChildren &children() const;
 	const SceneGraphNodeProperties &properties() const;
@@ -1606,4 +1606,108 @@ TEST_F(SceneGraphTest, testGetCollisionNodesWithGroupRotation) {
 	EXPECT_EQ(1, validNodes) << "Node under rotated group should be found at its rotated world position";
 }
 
+TEST_F(SceneGraphTest, testNodeSelection) {
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolume(new voxel::RawVolume(voxel::Region(0, 15)));
+	const voxel::Voxel solid = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	node.volume()->fill(solid);
+	EXPECT_FALSE(node.hasSelection());
+
+	node.select(voxel::Region(2, 5));
+	EXPECT_TRUE(node.hasSelection());
+	EXPECT_EQ(voxel::Region(2, 5), node.selection().region());
+	EXPECT_TRUE((node.volume()->voxel(3, 3, 3).getFlags() & voxel::FlagOutline) != 0);
+
+	node.unselect(voxel::Region(2, 3));
+	EXPECT_EQ(64 - 8, node.selection().count());
+
+	node.clearSelection();
+	EXPECT_FALSE(node.hasSelection());
+	EXPECT_FALSE(node.volume()->hasFlags(node.region(), voxel::FlagOutline));
+
+	// the mask is the selection - flags that are written behind the back of the node are ignored until they are read
+	voxel::Voxel selected = solid;
+	selected.setFlags(voxel::FlagOutline);
+	node.volume()->setVoxel(7, 7, 7, selected);
+	EXPECT_FALSE(node.hasSelection());
+	node.selectionFromFlags(voxel::Region(7, 7));
+	EXPECT_EQ(1, node.selection().count());
+
+	EXPECT_TRUE(node.select(glm::ivec3(1, 1, 1)));
+	EXPECT_FALSE(node.select(glm::ivec3(1, 1, 1)));
+	EXPECT_TRUE((node.volume()->voxel(1, 1, 1).getFlags() & voxel::FlagOutline) != 0);
+	EXPECT_FALSE(node.select(glm::ivec3(16, 1, 1)));
+	EXPECT_TRUE(node.unselect(glm::ivec3(1, 1, 1)));
+	EXPECT_FALSE(node.unselect(glm::ivec3(1, 1, 1)));
+	EXPECT_FALSE((node.volume()->voxel(1, 1, 1).getFlags() & voxel::FlagOutline) != 0);
+	EXPECT_EQ(1, node.selection().count());
+
+	EXPECT_EQ(voxel::Region(6, 8), node.growSelection());
+	EXPECT_EQ(7, node.selection().count());
+	EXPECT_TRUE((node.volume()->voxel(7, 8, 7).getFlags() & voxel::FlagOutline) != 0);
+	EXPECT_EQ(voxel::Region(6, 8), node.shrinkSelection());
+	EXPECT_EQ(1, node.selection().count());
+	EXPECT_FALSE((node.volume()->voxel(7, 8, 7).getFlags() & voxel::FlagOutline) != 0);
+
+	node.invertSelection();
+	EXPECT_EQ(node.region().voxels() - 1, node.selection().count());
+
+	// a new volume is synced completely
+	node.setVolume(new voxel::RawVolume(voxel::Region(0, 3)));
+	EXPECT_FALSE(node.hasSelection());
+}
+
+TEST_F(SceneGraphTest, testNodeOccupancy) {
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolume(new voxel::RawVolume(voxel::Region(0, 31)));
+	EXPECT_EQ(0, node.occupancy().occupiedBricks());
+
+	node.volume()->setVoxel(20, 3, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	// not yet marked as modified
+	EXPECT_EQ(0, node.occupancy().occupiedBricks());
+	node.occupancyModified(voxel::Region(20, 3, 3, 20, 3, 3));
+	EXPECT_EQ(1, node.occupancy().occupiedBricks());
+	EXPECT_FALSE(node.occupancy().isBrickEmpty(glm::ivec3(20, 3, 3)));
+
+	// a new volume is scanned completely
+	voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 31));
+	volume->setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	volume->setVoxel(31, 31, 31, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	node.setVolume(volume);
+	EXPECT_EQ(2, node.occupancy().occupiedBricks());
+}
+
+TEST_F(SceneGraphTest, testRaycast) {
+	SceneGraph sceneGraph;
+	int nodeIds[3];
+	for (int i = 0; i < 3; ++i) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 15));
+		v->setVoxel(10, 8, 8, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		node.setVolume(v);
+		SceneGraphTransform transform;
+		// the first node is the farthest
+		transform.setWorldTranslation(glm::vec3((2 - i) * 40, 0, 0));
+		node.setTransform(0, transform);
+		nodeIds[i] = sceneGraph.emplace(core::move(node));
+	}
+	sceneGraph.updateTransforms();
+
+	const math::Ray ray(glm::vec3(-100.0f, 8.5f, 8.5f), glm::vec3(1.0f, 0.0f, 0.0f));
+	SceneGraphRaycastHit hit;
+	ASSERT_TRUE(sceneGraph.raycast(ray, 1000.0f, 0, hit));
+	EXPECT_EQ(nodeIds[2], hit.nodeId);
+	EXPECT_EQ(glm::ivec3(10, 8, 8), hit.voxel);
+	EXPECT_EQ(glm::ivec3(-1, 0, 0), hit.normal);
+	EXPECT_NEAR(110.0f, hit.distance, 0.01f);
+
+	sceneGraph.node(nodeIds[2]).setVisible(false);
+	ASSERT_TRUE(sceneGraph.raycast(ray, 1000.0f, 0, hit));
+	EXPECT_EQ(nodeIds[1], hit.nodeId);
+	EXPECT_NEAR(150.0f, hit.distance, 0.01f);
+
+	// the ray is too short to reach the voxel
+	EXPECT_FALSE(sceneGraph.raycast(ray, 140.0f, 0, hit));
+}
+
 } // namespace scenegraph
@@ -182,6 +182,17 @@ public:
 	inline size_t bytes() const {
 		return _data.bytes();
 	}
+
+	/**
+	 * @brief Access to the raw bits - the bit index is given by @c Region::index()
+	 */
+	inline const core::DynamicBitSet &data() const {
+		return _data;
+	}
+
+	inline core::DynamicBitSet &data() {
+		return _data;
+	}
 };
 
 } // namespace voxel
@@ -0,0 +1,216 @@
+/**
+ * @file
+ */
+
+#include "BrickedVolume.h"
+#include "app/ForParallel.h"
+#include "core/Assert.h"
+#include "core/Log.h"
+#include "core/MemoryAccounting.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "voxel/RawVolume.h"
+#include <SDL3/SDL_stdinc.h>
+
+namespace voxel {
+
+static inline glm::ivec3 brickCount(const Region &region) {
+	if (!region.isValid()) {
+		return glm::ivec3(0);
+	}
+	return (region.getDimensionsInVoxels() + BrickedVolume::BrickMask) >> BrickedVolume::BrickShift;
+}
+
+size_t BrickedVolume::size(const Region &region) {
+	const glm::ivec3 &bricks = brickCount(region);
+	return (size_t)bricks.x * bricks.y * bricks.z * BrickVoxels * sizeof(Voxel);
+}
+
+BrickedVolume::BrickedVolume(const Region &region) : _region(region), _bricks(brickCount(region)) {
+	core_memory_scoped(Volume);
+	core_assert_msg(region.isValid(), "Volume region must be valid");
+	const size_t size = BrickedVolume::size(_region);
+	_data = (Voxel *)core_malloc(size);
+	if (_data == nullptr) {
+		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for a bricked volume with the dimensions %i:%i:%i",
+				   (uint64_t)size, width(), height(), depth());
+		return;
+	}
+	clear();
+}
+
+BrickedVolume::BrickedVolume(const RawVolume &volume) : BrickedVolume(volume.region()) {
+	_borderVoxel = volume.borderValue();
+	copyFrom(volume);
+}
+
+BrickedVolume::BrickedVolume(const BrickedVolume &copy) : _region(copy._region), _bricks(copy._bricks) {
+	core_memory_scoped(Volume);
+	_borderVoxel = copy._borderVoxel;
+	const size_t size = BrickedVolume::size(_region);
+	_data = (Voxel *)core_malloc(size);
+	if (_data == nullptr) {
+		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for bricked volume copy", (uint64_t)size);
+		return;
+	}
+	core_memcpy((void *)_data, (const void *)copy._data, size);
+}
+
+BrickedVolume::BrickedVolume(BrickedVolume &&move) noexcept
+	: _region(move._region), _bricks(move._bricks), _borderVoxel(move._borderVoxel), _data(move._data) {
+	move._data = nullptr;
+}
+
+BrickedVolume::~BrickedVolume() {
+	core_memory_scoped(Volume);
+	core_free(_data);
+	_data = nullptr;
+}
+
+bool BrickedVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
+	if (!_region.containsPoint(x, y, z)) {
+		return false;
+	}
+	Voxel &v = _data[index(x, y, z)];
+	if (v == voxel) {
+		return false;
+	}
+	v = voxel;
+	return true;
+}
+
+void BrickedVolume::clear() {
+	Voxel voxel;
+	fill(voxel);
+}
+
+void BrickedVolume::fill(const Voxel &voxel) {
+	if (_data == nullptr) {
+		return;
+	}
+	// the padding is filled, too - it's never visible anyway
+	uint32_t val;
+	core_memcpy(&val, &voxel, sizeof(val));
+	core_memset4((void *)_data, val, BrickedVolume::size(_region) / sizeof(Voxel));
+	static_assert(sizeof(Voxel) == sizeof(uint32_t), "Voxel is expected to be 4 bytes");
+}
+
+bool BrickedVolume::isEmpty(const Region &region) const {
+	core_trace_scoped(BrickedVolumeIsEmpty);
+	if (!intersects(_region, region)) {
+		return true;
+	}
+	Region r = region;
+	r.cropTo(_region);
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 &mins = (r.getLowerCorner() - lower) >> BrickShift;
+	const glm::ivec3 &maxs = (r.getUpperCorner() - lower) >> BrickShift;
+	for (int bz = mins.z; bz <= maxs.z; ++bz) {
+		for (int by = mins.y; by <= maxs.y; ++by) {
+			for (int bx = mins.x; bx <= maxs.x; ++bx) {
+				const glm::ivec3 brickMins = lower + (glm::ivec3(bx, by, bz) << BrickShift);
+				Region brickRegion(brickMins, brickMins + BrickMask);
+				brickRegion.cropTo(r);
+				const Voxel *data = brick(bx, by, bz);
+				const glm::ivec3 &localMins = brickRegion.getLowerCorner() - brickMins;
+				const glm::ivec3 &localMaxs = brickRegion.getUpperCorner() - brickMins;
+				for (int z = localMins.z; z <= localMaxs.z; ++z) {
+					for (int y = localMins.y; y <= localMaxs.y; ++y) {
+						for (int x = localMins.x; x <= localMaxs.x; ++x) {
+							if (!isAir(data[brickOffset(x, y, z)].getMaterial())) {
+								return false;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Copy the given region between the linear and the bricked layout
+ *
+ * Each row of the linear volume is split at the brick boundaries - the brick pointer and the row offset inside the
+ * brick are only computed once per brick row.
+ */
+template<bool ToBricks>
+static void copyRows(Voxel *bricked, const glm::ivec3 &bricks, const Region &brickedRegion, const RawVolume &linearVolume,
+					 const Region &region) {
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const glm::ivec3 &brickedLower = brickedRegion.getLowerCorner();
+	const glm::ivec3 &linearLower = linearVolume.region().getLowerCorner();
+	Voxel *linear = linearVolume.voxels();
+	const int64_t linearWidth = linearVolume.strideY();
+	const int64_t linearStride = linearVolume.strideZ();
+	app::for_parallel(mins.z, maxs.z + 1, [&](int start, int end) {
+		for (int z = start; z < end; ++z) {
+			const int lz = z - brickedLower.z;
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				const int ly = y - brickedLower.y;
+				const int64_t brickRow = ((int64_t)(lz >> BrickedVolume::BrickShift) * bricks.y +
+										  (ly >> BrickedVolume::BrickShift)) *
+										 bricks.x;
+				const uint32_t rowOffset =
+					BrickedVolume::brickOffset(0, ly & BrickedVolume::BrickMask, lz & BrickedVolume::BrickMask);
+				Voxel *linearRow = linear + (int64_t)(z - linearLower.z) * linearStride +
+								   (int64_t)(y - linearLower.y) * linearWidth - linearLower.x;
+				int x = mins.x;
+				while (x <= maxs.x) {
+					const int lx = x - brickedLower.x;
+					Voxel *brick = bricked + (brickRow + (lx >> BrickedVolume::BrickShift)) * BrickedVolume::BrickVoxels;
+					const int brickEnd = core_min(maxs.x, x + (BrickedVolume::BrickMask - (lx & BrickedVolume::BrickMask)));
+					for (int bx = lx & BrickedVolume::BrickMask; x <= brickEnd; ++x, ++bx) {
+						Voxel &b = brick[rowOffset | BrickedVolume::brickOffset(bx, 0, 0)];
+						if (ToBricks) {
+							b = linearRow[x];
+						} else {
+							linearRow[x] = b;
+						}
+					}
+				}
+			}
+		}
+	});
+}
+
+void BrickedVolume::copyFrom(const RawVolume &src) {
+	copyFrom(src, src.region());
+}
+
+void BrickedVolume::copyFrom(const RawVolume &src, const Region &region) {
+	core_trace_scoped(BrickedVolumeCopyFrom);
+	Region r = region;
+	r.cropTo(_region);
+	r.cropTo(src.region());
+	if (!r.isValid() || _data == nullptr) {
+		return;
+	}
+	copyRows<true>(_data, _bricks, _region, src, r);
+}
+
+void BrickedVolume::copyTo(RawVolume &target) const {
+	copyTo(target, target.region());
+}
+
+void BrickedVolume::copyTo(RawVolume &target, const Region &region) const {
+	core_trace_scoped(BrickedVolumeCopyTo);
+	Region r = region;
+	r.cropTo(_region);
+	r.cropTo(target.region());
+	if (!r.isValid() || _data == nullptr) {
+		return;
+	}
+	copyRows<false>(_data, _bricks, _region, target, r);
+}
+
+RawVolume *BrickedVolume::toRawVolume() const {
+	RawVolume *volume = new RawVolume(_region);
+	volume->setBorderValue(_borderVoxel);
+	copyTo(*volume);
+	return volume;
+}
+
+} // namespace voxel
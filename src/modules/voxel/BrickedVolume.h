@@ -0,0 +1,435 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "math/Axis.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include <glm/common.hpp>
+#include <stdint.h>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Fixed size volume that stores the voxels in bricks of @c BrickSide^3 voxels
+ *
+ * The bricks are laid out linearly (x, then y, then z) starting at the lower corner of the region - the voxels inside
+ * a brick are stored in morton order. Other than the linear layout of the @c RawVolume, the neighbours of a voxel along
+ * y and z are usually in the same cache lines. This pays off for algorithms that look at all neighbours of a voxel -
+ * like the surface extraction with ambient occlusion or sculpting.
+ *
+ * The bricks at the upper end of the region are padded - the padding is never visible to the caller.
+ *
+ * Use @c copyFrom() and @c copyTo() to convert from and to the linear @c RawVolume layout.
+ *
+ * @sa RawVolume
+ * @ingroup Voxel
+ */
+class BrickedVolume {
+public:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickSide = 1 << BrickShift;
+	static constexpr int BrickMask = BrickSide - 1;
+	static constexpr int BrickVoxels = BrickSide * BrickSide * BrickSide;
+	/** the bits of a brick local coordinate spread to every third bit - see @c brickOffset() */
+	static constexpr uint32_t SpreadBits[BrickSide] = {0u, 1u, 8u, 9u, 64u, 65u, 72u, 73u};
+
+	/**
+	 * @brief Offset of the brick local position in the morton ordered brick
+	 * @note This is the same as @c mortonIndex() from @c Morton.h for the 3 bits of a brick local coordinate
+	 */
+	static CORE_FORCE_INLINE constexpr uint32_t brickOffset(int x, int y, int z) {
+		return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+	}
+
+	/**
+	 * @brief Same api as @c VolumeSampler
+	 *
+	 * The offsets to the neighbours along each axis are maintained while moving - they already include the jump into the
+	 * next brick. A peek is a single pointer offset as long as the neighbour is inside the region.
+	 */
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_CANGO_NEGX = 1 << 0;
+		static const uint8_t SAMPLER_CANGO_POSX = 1 << 1;
+		static const uint8_t SAMPLER_CANGO_NEGY = 1 << 2;
+		static const uint8_t SAMPLER_CANGO_POSY = 1 << 3;
+		static const uint8_t SAMPLER_CANGO_NEGZ = 1 << 4;
+		static const uint8_t SAMPLER_CANGO_POSZ = 1 << 5;
+
+	public:
+		Sampler(const BrickedVolume *volume) : Sampler(*volume) {
+		}
+		Sampler(const BrickedVolume &volume)
+			: _volume(const_cast<BrickedVolume *>(&volume)), _region(volume.region()) {
+			_brickStride[0] = BrickVoxels;
+			_brickStride[1] = (intptr_t)BrickVoxels * volume.bricks().x;
+			_brickStride[2] = (intptr_t)BrickVoxels * volume.bricks().x * volume.bricks().y;
+		}
+
+		CORE_FORCE_INLINE const Region &region() const {
+			return _region;
+		}
+
+		CORE_FORCE_INLINE const glm::ivec3 &position() const {
+			return _posInVolume;
+		}
+
+		CORE_FORCE_INLINE bool currentPositionValid() const {
+			return _currentVoxel != nullptr;
+		}
+
+		CORE_FORCE_INLINE const Voxel &voxel() const {
+			if (core_likely(currentPositionValid())) {
+				return *_currentVoxel;
+			}
+			return _volume->voxel(_posInVolume.x, _posInVolume.y, _posInVolume.z);
+		}
+
+		CORE_FORCE_INLINE bool setVoxel(const Voxel &voxel) {
+			if (!currentPositionValid()) {
+				return false;
+			}
+			*_currentVoxel = voxel;
+			return true;
+		}
+
+		CORE_FORCE_INLINE bool setPosition(const glm::ivec3 &pos) {
+			return setPosition(pos.x, pos.y, pos.z);
+		}
+
+		bool setPosition(int32_t x, int32_t y, int32_t z) {
+			_posInVolume = glm::ivec3(x, y, z);
+			if (!_region.containsPoint(x, y, z)) {
+				_currentVoxel = nullptr;
+				return false;
+			}
+			const glm::ivec3 local = _posInVolume - _region.getLowerCorner();
+			const glm::ivec3 brick = local >> BrickShift;
+			_local = local & BrickMask;
+			_currentVoxel = _volume->brick(brick.x, brick.y, brick.z) + brickOffset(_local.x, _local.y, _local.z);
+			updateAxis<0>();
+			updateAxis<1>();
+			updateAxis<2>();
+			return true;
+		}
+
+		void movePositive(math::Axis axis, uint32_t offset = 1u) {
+			switch (axis) {
+			case math::Axis::X:
+				movePositiveX(offset);
+				break;
+			case math::Axis::Y:
+				movePositiveY(offset);
+				break;
+			case math::Axis::Z:
+				movePositiveZ(offset);
+				break;
+			default:
+				break;
+			}
+		}
+
+		void moveNegative(math::Axis axis, uint32_t offset = 1u) {
+			switch (axis) {
+			case math::Axis::X:
+				moveNegativeX(offset);
+				break;
+			case math::Axis::Y:
+				moveNegativeY(offset);
+				break;
+			case math::Axis::Z:
+				moveNegativeZ(offset);
+				break;
+			default:
+				break;
+			}
+		}
+
+		CORE_FORCE_INLINE void movePositiveX(uint32_t offset = 1) {
+			moveAxis<0, 1>(offset);
+		}
+		CORE_FORCE_INLINE void movePositiveY(uint32_t offset = 1) {
+			moveAxis<1, 1>(offset);
+		}
+		CORE_FORCE_INLINE void movePositiveZ(uint32_t offset = 1) {
+			moveAxis<2, 1>(offset);
+		}
+		CORE_FORCE_INLINE void moveNegativeX(uint32_t offset = 1) {
+			moveAxis<0, -1>(offset);
+		}
+		CORE_FORCE_INLINE void moveNegativeY(uint32_t offset = 1) {
+			moveAxis<1, -1>(offset);
+		}
+		CORE_FORCE_INLINE void moveNegativeZ(uint32_t offset = 1) {
+			moveAxis<2, -1>(offset);
+		}
+
+		// clang-format off
+		inline const Voxel &peekVoxel1nx1ny1nz() const { return peek<-1, -1, -1>(); }
+		inline const Voxel &peekVoxel1nx1ny0pz() const { return peek<-1, -1,  0>(); }
+		inline const Voxel &peekVoxel1nx1ny1pz() const { return peek<-1, -1,  1>(); }
+		inline const Voxel &peekVoxel1nx0py1nz() const { return peek<-1,  0, -1>(); }
+		inline const Voxel &peekVoxel1nx0py0pz() const { return peek<-1,  0,  0>(); }
+		inline const Voxel &peekVoxel1nx0py1pz() const { return peek<-1,  0,  1>(); }
+		inline const Voxel &peekVoxel1nx1py1nz() const { return peek<-1,  1, -1>(); }
+		inline const Voxel &peekVoxel1nx1py0pz() const { return peek<-1,  1,  0>(); }
+		inline const Voxel &peekVoxel1nx1py1pz() const { return peek<-1,  1,  1>(); }
+
+		inline const Voxel &peekVoxel0px1ny1nz() const { return peek< 0, -1, -1>(); }
+		inline const Voxel &peekVoxel0px1ny0pz() const { return peek< 0, -1,  0>(); }
+		inline const Voxel &peekVoxel0px1ny1pz() const { return peek< 0, -1,  1>(); }
+		inline const Voxel &peekVoxel0px0py1nz() const { return peek< 0,  0, -1>(); }
+		inline const Voxel &peekVoxel0px0py0pz() const { return voxel(); }
+		inline const Voxel &peekVoxel0px0py1pz() const { return peek< 0,  0,  1>(); }
+		inline const Voxel &peekVoxel0px1py1nz() const { return peek< 0,  1, -1>(); }
+		inline const Voxel &peekVoxel0px1py0pz() const { return peek< 0,  1,  0>(); }
+		inline const Voxel &peekVoxel0px1py1pz() const { return peek< 0,  1,  1>(); }
+
+		inline const Voxel &peekVoxel1px1ny1nz() const { return peek< 1, -1, -1>(); }
+		inline const Voxel &peekVoxel1px1ny0pz() const { return peek< 1, -1,  0>(); }
+		inline const Voxel &peekVoxel1px1ny1pz() const { return peek< 1, -1,  1>(); }
+		inline const Voxel &peekVoxel1px0py1nz() const { return peek< 1,  0, -1>(); }
+		inline const Voxel &peekVoxel1px0py0pz() const { return peek< 1,  0,  0>(); }
+		inline const Voxel &peekVoxel1px0py1pz() const { return peek< 1,  0,  1>(); }
+		inline const Voxel &peekVoxel1px1py1nz() const { return peek< 1,  1, -1>(); }
+		inline const Voxel &peekVoxel1px1py0pz() const { return peek< 1,  1,  0>(); }
+		inline const Voxel &peekVoxel1px1py1pz() const { return peek< 1,  1,  1>(); }
+		// clang-format on
+
+	private:
+		template<int D>
+		static constexpr uint8_t canGoMask(int axis) {
+			return D < 0 ? (uint8_t)(SAMPLER_CANGO_NEGX << (axis * 2))
+						 : (D > 0 ? (uint8_t)(SAMPLER_CANGO_POSX << (axis * 2)) : (uint8_t)0u);
+		}
+
+		template<int Axis, int D>
+		CORE_FORCE_INLINE intptr_t neighbourOffset() const {
+			return D < 0 ? _negOffset[Axis] : (D > 0 ? _posOffset[Axis] : 0);
+		}
+
+		template<int DX, int DY, int DZ>
+		CORE_FORCE_INLINE const Voxel &peek() const {
+			constexpr uint8_t mask = canGoMask<DX>(0) | canGoMask<DY>(1) | canGoMask<DZ>(2);
+			if (core_likely(currentPositionValid() && (_canGo & mask) == mask)) {
+				return *(_currentVoxel + neighbourOffset<0, DX>() + neighbourOffset<1, DY>() + neighbourOffset<2, DZ>());
+			}
+			return _volume->voxel(_posInVolume.x + DX, _posInVolume.y + DY, _posInVolume.z + DZ);
+		}
+
+		/**
+		 * @brief Update the offsets to the neighbours along the given axis - stepping over the brick border means
+		 * wrapping the local coordinate and jumping to the next brick
+		 */
+		template<int Axis>
+		CORE_FORCE_INLINE void updateAxis() {
+			const int l = _local[Axis];
+			const intptr_t center = (intptr_t)(SpreadBits[l] << Axis);
+			if (l > 0) {
+				_negOffset[Axis] = (intptr_t)(SpreadBits[l - 1] << Axis) - center;
+			} else {
+				_negOffset[Axis] = (intptr_t)(SpreadBits[BrickMask] << Axis) - center - _brickStride[Axis];
+			}
+			if (l < BrickMask) {
+				_posOffset[Axis] = (intptr_t)(SpreadBits[l + 1] << Axis) - center;
+			} else {
+				_posOffset[Axis] = -center + _brickStride[Axis];
+			}
+			const uint8_t neg = SAMPLER_CANGO_NEGX << (Axis * 2);
+			const uint8_t pos = SAMPLER_CANGO_POSX << (Axis * 2);
+			_canGo &= ~(neg | pos);
+			if (_posInVolume[Axis] > _region.getLowerCorner()[Axis]) {
+				_canGo |= neg;
+			}
+			if (_posInVolume[Axis] < _region.getUpperCorner()[Axis]) {
+				_canGo |= pos;
+			}
+		}
+
+		template<int Axis, int Dir>
+		CORE_FORCE_INLINE void moveAxis(uint32_t offset) {
+			const uint8_t neg = SAMPLER_CANGO_NEGX << (Axis * 2);
+			const uint8_t pos = SAMPLER_CANGO_POSX << (Axis * 2);
+			if (core_likely(offset == 1u && currentPositionValid() && (_canGo & (Dir > 0 ? pos : neg)))) {
+				_posInVolume[Axis] += Dir;
+				const int l = (_local[Axis] + Dir) & BrickMask;
+				_local[Axis] = l;
+				const intptr_t center = (intptr_t)(SpreadBits[l] << Axis);
+				// the way back is the inverse of the step we just did - only the other side has to be looked up
+				if (Dir > 0) {
+					_currentVoxel += _posOffset[Axis];
+					_negOffset[Axis] = -_posOffset[Axis];
+					if (l < BrickMask) {
+						_posOffset[Axis] = (intptr_t)(SpreadBits[l + 1] << Axis) - center;
+					} else {
+						_posOffset[Axis] = -center + _brickStride[Axis];
+					}
+					_canGo |= neg;
+					if (_posInVolume[Axis] >= _region.getUpperCorner()[Axis]) {
+						_canGo &= ~pos;
+					}
+				} else {
+					_currentVoxel += _negOffset[Axis];
+					_posOffset[Axis] = -_negOffset[Axis];
+					if (l > 0) {
+						_negOffset[Axis] = (intptr_t)(SpreadBits[l - 1] << Axis) - center;
+					} else {
+						_negOffset[Axis] = (intptr_t)(SpreadBits[BrickMask] << Axis) - center - _brickStride[Axis];
+					}
+					_canGo |= pos;
+					if (_posInVolume[Axis] <= _region.getLowerCorner()[Axis]) {
+						_canGo &= ~neg;
+					}
+				}
+				return;
+			}
+			glm::ivec3 newPos = _posInVolume;
+			newPos[Axis] += Dir * (int32_t)offset;
+			setPosition(newPos);
+		}
+
+		BrickedVolume *_volume;
+		Region _region;
+		glm::ivec3 _posInVolume{0};
+		/** the position inside the current brick */
+		glm::ivec3 _local{0};
+		/** the voxel offsets of the neighbours in negative and positive direction along each axis */
+		intptr_t _negOffset[3]{0, 0, 0};
+		intptr_t _posOffset[3]{0, 0, 0};
+		/** the amount of voxels between two neighbouring bricks along each axis */
+		intptr_t _brickStride[3]{0, 0, 0};
+		/** the voxel at the current position or @c nullptr if the position is outside of the region */
+		Voxel *_currentVoxel = nullptr;
+		/** whether the neighbours in negative and positive direction along each axis are inside the region */
+		uint8_t _canGo = 0u;
+	};
+
+	BrickedVolume(const Region &region);
+	/**
+	 * @brief Convert the given linear volume
+	 */
+	explicit BrickedVolume(const RawVolume &volume);
+	BrickedVolume(const BrickedVolume &copy);
+	BrickedVolume(BrickedVolume &&move) noexcept;
+	~BrickedVolume();
+
+	BrickedVolume &operator=(const BrickedVolume &) = delete;
+
+	/**
+	 * @brief Calculate the amount of bytes a volume with the given region would consume - including the padding
+	 */
+	static size_t size(const Region &region);
+
+	inline const Region &region() const {
+		return _region;
+	}
+	inline int32_t width() const {
+		return _region.getWidthInVoxels();
+	}
+	inline int32_t height() const {
+		return _region.getHeightInVoxels();
+	}
+	inline int32_t depth() const {
+		return _region.getDepthInVoxels();
+	}
+	/**
+	 * @return The amount of bricks per axis
+	 */
+	inline const glm::ivec3 &bricks() const {
+		return _bricks;
+	}
+
+	inline const Voxel &borderValue() const {
+		return _borderVoxel;
+	}
+	void setBorderValue(const Voxel &voxel) {
+		_borderVoxel = voxel;
+	}
+
+	CORE_FORCE_INLINE const Voxel &voxel(int32_t x, int32_t y, int32_t z) const {
+		if (_region.containsPoint(x, y, z)) {
+			return _data[index(x, y, z)];
+		}
+		return _borderVoxel;
+	}
+	CORE_FORCE_INLINE const Voxel &voxel(const glm::ivec3 &pos) const {
+		return voxel(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * @return @c true if the voxel was placed, @c false if it was already the same voxel or the position is outside
+	 * of the volume
+	 */
+	bool setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel);
+	bool setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
+		return setVoxel(pos.x, pos.y, pos.z, voxel);
+	}
+
+	void clear();
+	void fill(const Voxel &voxel);
+	/**
+	 * @brief Checks if the volume is empty in the given region
+	 */
+	bool isEmpty(const Region &region) const;
+
+	/**
+	 * @brief Shift the region of the volume by the given coordinates
+	 */
+	void translate(const glm::ivec3 &t) {
+		_region.shift(t.x, t.y, t.z);
+	}
+
+	/**
+	 * @brief Copy the voxels of the intersection of both volumes from the linear layout
+	 */
+	void copyFrom(const RawVolume &src);
+	/**
+	 * @brief Copy the voxels of the given region from the linear layout - the region is cropped to both volumes
+	 */
+	void copyFrom(const RawVolume &src, const Region &region);
+	/**
+	 * @brief Copy the voxels of the intersection of both volumes into the linear layout
+	 */
+	void copyTo(RawVolume &target) const;
+	/**
+	 * @brief Copy the voxels of the given region into the linear layout - the region is cropped to both volumes
+	 */
+	void copyTo(RawVolume &target, const Region &region) const;
+	/**
+	 * @brief Create a volume with the linear layout
+	 * @note It's the callers responsibility to properly release the memory.
+	 */
+	RawVolume *toRawVolume() const;
+
+private:
+	static CORE_FORCE_INLINE constexpr uint32_t spread(int v) {
+		return ((uint32_t)v & 1u) | (((uint32_t)v & 2u) << 2) | (((uint32_t)v & 4u) << 4);
+	}
+
+	CORE_FORCE_INLINE Voxel *brick(int bx, int by, int bz) const {
+		return _data + (((int64_t)bz * _bricks.y + by) * _bricks.x + bx) * BrickVoxels;
+	}
+
+	CORE_FORCE_INLINE int64_t index(int32_t x, int32_t y, int32_t z) const {
+		const int32_t lx = x - _region.getLowerX();
+		const int32_t ly = y - _region.getLowerY();
+		const int32_t lz = z - _region.getLowerZ();
+		const int64_t brickIdx =
+			((int64_t)(lz >> BrickShift) * _bricks.y + (ly >> BrickShift)) * _bricks.x + (lx >> BrickShift);
+		return brickIdx * BrickVoxels + brickOffset(lx & BrickMask, ly & BrickMask, lz & BrickMask);
+	}
+
+	Region _region;
+	/** the amount of bricks per axis */
+	glm::ivec3 _bricks{0};
+	Voxel _borderVoxel;
+	Voxel *_data = nullptr;
+};
+
+} // namespace voxel
@@ -0,0 +1,186 @@
+/**
+ * @file
+ */
+
+#include "DirtyChunks.h"
+#include "core/Trace.h"
+
+namespace voxel {
+
+DirtyChunks::DirtyChunks(const Region &volumeRegion) {
+	init(volumeRegion);
+}
+
+void DirtyChunks::init(const Region &volumeRegion) {
+	_region = Region::InvalidRegion;
+	_dirtyChunks = 0;
+	_overflow = false;
+	if (!volumeRegion.isValid()) {
+		_origin = glm::ivec3(0);
+		_size = glm::ivec3(0);
+		_chunks.resize(0);
+		return;
+	}
+	_origin = volumeRegion.getLowerCorner();
+	_size = ((volumeRegion.getDimensionsInVoxels() - 1) >> ChunkSizeShift) + 1;
+	_chunks.resize((size_t)_size.x * _size.y * _size.z);
+	_chunks.clear();
+}
+
+void DirtyChunks::reset() {
+	_region = Region::InvalidRegion;
+	_dirtyChunks = 0;
+	_overflow = false;
+	_chunks.clear();
+}
+
+void DirtyChunks::markChunk(int x, int y, int z) {
+	const size_t idx = index(x, y, z);
+	if (!_chunks[idx]) {
+		_chunks.set(idx, true);
+		++_dirtyChunks;
+	}
+}
+
+void DirtyChunks::add(const glm::ivec3 &pos) {
+	if (_region.isValid()) {
+		_region.accumulate(pos);
+	} else {
+		_region = Region(pos, pos);
+	}
+	const glm::ivec3 &delta = pos - _origin;
+	if (delta.x < 0 || delta.y < 0 || delta.z < 0) {
+		_overflow = true;
+		return;
+	}
+	const glm::ivec3 &chunk = delta >> ChunkSizeShift;
+	if (chunk.x >= _size.x || chunk.y >= _size.y || chunk.z >= _size.z) {
+		_overflow = true;
+		return;
+	}
+	markChunk(chunk.x, chunk.y, chunk.z);
+}
+
+void DirtyChunks::add(const Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	if (_region.isValid()) {
+		_region.accumulate(region);
+	} else {
+		_region = region;
+	}
+	const glm::ivec3 &lower = region.getLowerCorner() - _origin;
+	const glm::ivec3 &upper = region.getUpperCorner() - _origin;
+	if (lower.x < 0 || lower.y < 0 || lower.z < 0) {
+		_overflow = true;
+		return;
+	}
+	const glm::ivec3 &mins = lower >> ChunkSizeShift;
+	const glm::ivec3 &maxs = upper >> ChunkSizeShift;
+	if (maxs.x >= _size.x || maxs.y >= _size.y || maxs.z >= _size.z) {
+		_overflow = true;
+		return;
+	}
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				markChunk(x, y, z);
+			}
+		}
+	}
+}
+
+bool DirtyChunks::isDirty(const glm::ivec3 &pos) const {
+	if (_overflow) {
+		return _region.containsPoint(pos);
+	}
+	const glm::ivec3 &delta = pos - _origin;
+	if (delta.x < 0 || delta.y < 0 || delta.z < 0) {
+		return false;
+	}
+	const glm::ivec3 &chunk = delta >> ChunkSizeShift;
+	if (chunk.x >= _size.x || chunk.y >= _size.y || chunk.z >= _size.z) {
+		return false;
+	}
+	return _chunks[index(chunk.x, chunk.y, chunk.z)];
+}
+
+core::DynamicArray<Region> DirtyChunks::regions(int maxRegions) const {
+	core_trace_scoped(DirtyChunksRegions);
+	core::DynamicArray<Region> regions;
+	if (!_region.isValid()) {
+		return regions;
+	}
+	if (_overflow || _dirtyChunks <= 1) {
+		regions.push_back(_region);
+		return regions;
+	}
+
+	// only walk the chunks of the bounding box
+	const glm::ivec3 &mins = (_region.getLowerCorner() - _origin) >> ChunkSizeShift;
+	const glm::ivec3 &maxs = (_region.getUpperCorner() - _origin) >> ChunkSizeShift;
+	core::DynamicBitSet remaining(_chunks);
+	auto isSet = [&](int x, int y, int z) { return remaining[index(x, y, z)]; };
+
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				if (!isSet(x, y, z)) {
+					continue;
+				}
+				// grow the box along x, then y, then z as long as all chunks of the next row/slice are touched
+				int ex = x;
+				while (ex + 1 <= maxs.x && isSet(ex + 1, y, z)) {
+					++ex;
+				}
+				int ey = y;
+				for (bool grow = true; grow && ey + 1 <= maxs.y;) {
+					for (int ix = x; ix <= ex; ++ix) {
+						if (!isSet(ix, ey + 1, z)) {
+							grow = false;
+							break;
+						}
+					}
+					if (grow) {
+						++ey;
+					}
+				}
+				int ez = z;
+				for (bool grow = true; grow && ez + 1 <= maxs.z;) {
+					for (int iy = y; grow && iy <= ey; ++iy) {
+						for (int ix = x; ix <= ex; ++ix) {
+							if (!isSet(ix, iy, ez + 1)) {
+								grow = false;
+								break;
+							}
+						}
+					}
+					if (grow) {
+						++ez;
+					}
+				}
+				for (int iz = z; iz <= ez; ++iz) {
+					for (int iy = y; iy <= ey; ++iy) {
+						for (int ix = x; ix <= ex; ++ix) {
+							remaining.set(index(ix, iy, iz), false);
+						}
+					}
+				}
+				if ((int)regions.size() >= maxRegions) {
+					regions.clear();
+					regions.push_back(_region);
+					return regions;
+				}
+				const glm::ivec3 lower = _origin + glm::ivec3(x, y, z) * ChunkSize;
+				const glm::ivec3 upper = _origin + (glm::ivec3(ex, ey, ez) + 1) * ChunkSize - 1;
+				Region box(lower, upper);
+				box.cropTo(_region);
+				regions.push_back(box);
+			}
+		}
+	}
+	return regions;
+}
+
+} // namespace voxel
@@ -0,0 +1,102 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicBitSet.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+/**
+ * @brief Tracks the modified parts of a volume as a set of touched chunks
+ *
+ * A single bounding box of all modified positions degenerates to the whole volume if two edits happen in opposite
+ * corners. This keeps one bit per chunk of @c ChunkSize voxels per axis and is able to hand out a list of coalesced
+ * boxes that only cover the touched chunks. The boxes are cropped to the bounding box of the modified positions.
+ *
+ * @note This is not thread safe
+ * @ingroup Voxel
+ */
+class DirtyChunks {
+public:
+	static constexpr int ChunkSizeShift = 5;
+	static constexpr int ChunkSize = 1 << ChunkSizeShift;
+	/**
+	 * @brief If the touched chunks can't be described with this amount of boxes, only the bounding box is returned
+	 * by @c regions()
+	 */
+	static constexpr int MaxRegions = 32;
+
+private:
+	/** the lower corner of the volume region - this is the origin of the chunk grid */
+	glm::ivec3 _origin{0};
+	/** the amount of chunks per axis */
+	glm::ivec3 _size{0};
+	core::DynamicBitSet _chunks;
+	/** the bounding box of all modified positions */
+	Region _region = Region::InvalidRegion;
+	int _dirtyChunks = 0;
+	/** a position outside of the chunk grid was added - only the bounding box is available */
+	bool _overflow = false;
+
+	inline size_t index(int x, int y, int z) const {
+		return ((size_t)z * _size.y + y) * _size.x + x;
+	}
+	inline glm::ivec3 chunkPos(const glm::ivec3 &pos) const {
+		return (pos - _origin) >> ChunkSizeShift;
+	}
+	void markChunk(int x, int y, int z);
+
+public:
+	DirtyChunks() = default;
+	explicit DirtyChunks(const Region &volumeRegion);
+
+	/**
+	 * @brief Set up the chunk grid for the given volume region and reset the dirty state
+	 */
+	void init(const Region &volumeRegion);
+	/**
+	 * @brief Forget about all modifications but keep the chunk grid
+	 */
+	void reset();
+
+	void add(const glm::ivec3 &pos);
+	void add(const Region &region);
+
+	inline bool empty() const {
+		return !_region.isValid();
+	}
+
+	/**
+	 * @return The bounding box of all modified positions or @c Region::InvalidRegion
+	 */
+	inline const Region &region() const {
+		return _region;
+	}
+
+	/**
+	 * @return The amount of chunks that were touched
+	 */
+	inline int chunks() const {
+		return _dirtyChunks;
+	}
+
+	/**
+	 * @return @c true if the chunk the given position belongs to was touched
+	 */
+	bool isDirty(const glm::ivec3 &pos) const;
+
+	/**
+	 * @brief Merge the touched chunks into a list of non overlapping boxes
+	 *
+	 * Neighbouring chunks are greedily merged along x, then y and then z. The boxes are cropped to the bounding box of
+	 * the modified positions. If more than @c maxRegions boxes would be needed, the bounding box is returned.
+	 */
+	core::DynamicArray<Region> regions(int maxRegions = MaxRegions) const;
+};
+
+} // namespace voxel
@@ -9,6 +9,7 @@
 #include "core/Common.h"
 #include "core/ConfigVar.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/Trace.h"
 #include "meshoptimizer.h"
 #include "util/BufferUtil.h"
@@ -120,6 +121,9 @@ Mesh &Mesh::operator=(Mesh &&other) noexcept {
 }
 
 Mesh::~Mesh() {
+	core_memory_scoped(Mesh);
+	// release the buffers here - the member destructors would run outside of the memory scope
+	clear();
 	if (_compressedIndices != nullptr) {
 		core_free(_compressedIndices);
 	}
@@ -190,6 +194,7 @@ void Mesh::setOffset(const glm::ivec3 &offset) {
 }
 
 void Mesh::clear() {
+	core_memory_scoped(Mesh);
 	_vecVertices.release();
 	_vecIndices.release();
 	_normals.release();
@@ -8,6 +8,7 @@
 #include "core/Assert.h"
 #include "core/Common.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/StandardLib.h"
 #include "core/Trace.h"
 #include <SDL3/SDL_stdinc.h>
@@ -31,28 +32,39 @@ RawVolume::RawVolume(const Region &regValid) : _region(regValid) {
 	initialise(regValid);
 }
 
-RawVolume::RawVolume(const RawVolume *copy) : _region(copy->region()) {
-	setBorderValue(copy->borderValue());
-	const size_t size = RawVolume::size(_region);
-	_data = (Voxel *)core_malloc(size);
-	if (_data == nullptr) {
-		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for volume copy", (uint64_t)size);
+/**
+ * Copies the rows of a box with the given dimensions - the pointers are the lower corners of the box in the arrays
+ */
+static void copyRows(Voxel *dst, int64_t dstStrideY, int64_t dstStrideZ, const Voxel *src, int64_t srcStrideY,
+					 int64_t srcStrideZ, const glm::ivec3 &dimensions) {
+	const size_t lineSize = sizeof(Voxel) * dimensions.x;
+	if (dstStrideY == dimensions.x && srcStrideY == dimensions.x && dstStrideZ == srcStrideZ &&
+		dstStrideZ == (int64_t)dimensions.x * dimensions.y) {
+		core_memcpy((void *)dst, (const void *)src, lineSize * dimensions.y * dimensions.z);
 		return;
 	}
-	_borderVoxel = copy->_borderVoxel;
-	core_memcpy((void*)_data, (const void*)copy->_data, size);
+	for (int z = 0; z < dimensions.z; ++z) {
+		for (int y = 0; y < dimensions.y; ++y) {
+			core_memcpy((void *)(dst + z * dstStrideZ + y * dstStrideY),
+						(const void *)(src + z * srcStrideZ + y * srcStrideY), lineSize);
+		}
+	}
+}
+
+RawVolume::RawVolume(const RawVolume *copy) : RawVolume(*copy) {
 }
 
 RawVolume::RawVolume(const RawVolume &copy) : _region(copy.region()) {
+	core_memory_scoped(Volume);
 	setBorderValue(copy.borderValue());
 	const size_t size = RawVolume::size(_region);
-	_data = (Voxel *)core_malloc(size);
-	if (_data == nullptr) {
+	Voxel *buffer = (Voxel *)core_malloc(size);
+	if (buffer == nullptr) {
 		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for volume copy", (uint64_t)size);
 		return;
 	}
-	_borderVoxel = copy._borderVoxel;
-	core_memcpy((void*)_data, (const void*)copy._data, size);
+	setBuffer(buffer, _region.getDimensionsInVoxels(), glm::ivec3(0));
+	copyRows(_data, _strideY, _strideZ, copy._data, copy._strideY, copy._strideZ, _region.getDimensionsInVoxels());
 }
 
 static inline voxel::Region accumulate(const core::Buffer<Region> &regions) {
@@ -79,6 +91,7 @@ RawVolume::RawVolume(const RawVolume &src, const core::Buffer<Region> &copyRegio
 }
 
 RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir) : _region(region) {
+	core_memory_scoped(Volume);
 	core_trace_scoped(RawVolumeCopyRegion);
 	core_assert(region.isValid());
 	setBorderValue(src.borderValue());
@@ -87,20 +100,22 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 			*onlyAir = true;
 		}
 		const size_t size = RawVolume::size(_region);
-		_data = (Voxel *)core_malloc(size);
-		if (_data == nullptr) {
+		Voxel *buffer = (Voxel *)core_malloc(size);
+		if (buffer == nullptr) {
 			Log::error("Failed to allocate %" SDL_PRIu64 " bytes for volume copy", (uint64_t)size);
 			return;
 		}
+		setBuffer(buffer, _region.getDimensionsInVoxels(), glm::ivec3(0));
 		core_memset((void *)_data, 0, size);
 	} else if (src.region() == _region) {
 		const size_t size = RawVolume::size(_region);
-		_data = (Voxel *)core_malloc(size);
-		if (_data == nullptr) {
+		Voxel *buffer = (Voxel *)core_malloc(size);
+		if (buffer == nullptr) {
 			Log::error("Failed to allocate %" SDL_PRIu64 " bytes for volume copy", (uint64_t)size);
 			return;
 		}
-		core_memcpy((void *)_data, (const void *)src._data, size);
+		setBuffer(buffer, _region.getDimensionsInVoxels(), glm::ivec3(0));
+		copyRows(_data, _strideY, _strideZ, src._data, src._strideY, src._strideZ, _region.getDimensionsInVoxels());
 		if (onlyAir) {
 			*onlyAir = false;
 		}
@@ -112,24 +127,21 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 			*onlyAir = true;
 		}
 		const size_t size = RawVolume::size(_region);
-		_data = (Voxel *)core_malloc(size);
-		if (_data == nullptr) {
+		Voxel *buffer = (Voxel *)core_malloc(size);
+		if (buffer == nullptr) {
 			Log::error("Failed to allocate %" SDL_PRIu64 " bytes for volume copy", (uint64_t)size);
 			return;
 		}
+		setBuffer(buffer, _region.getDimensionsInVoxels(), glm::ivec3(0));
 		const glm::ivec3 &tgtMins = _region.getLowerCorner();
 		const glm::ivec3 &tgtMaxs = _region.getUpperCorner();
 		const glm::ivec3 &srcMins = src._region.getLowerCorner();
 
-		const int64_t tgtWidth = _region.getWidthInVoxels();
-		const int64_t tgtHeight = _region.getHeightInVoxels();
-		const int64_t tgtYStride = tgtWidth;
-		const int64_t tgtZStride = tgtWidth * tgtHeight;
+		const int64_t tgtYStride = _strideY;
+		const int64_t tgtZStride = _strideZ;
 
-		const int64_t srcWidth = src._region.getWidthInVoxels();
-		const int64_t srcHeight = src._region.getHeightInVoxels();
-		const int64_t srcYStride = srcWidth;
-		const int64_t srcZStride = srcWidth * srcHeight;
+		const int64_t srcYStride = src._strideY;
+		const int64_t srcZStride = src._strideZ;
 
 		const int lineLength = tgtMaxs.x - tgtMins.x + 1;
 		const size_t lineSize = sizeof(voxel::Voxel) * lineLength;
@@ -201,21 +213,20 @@ bool RawVolume::hasFlags(const Region &region, uint8_t flags) const {
 	const int scanDepth = r.getDepthInVoxels();
 
 	// When scanning full width and height, all z-slices are contiguous - single linear scan
-	if (scanWidth == width && scanHeight == height) {
+	if (scanWidth == width && scanHeight == height && contiguous()) {
 		const int zStart = r.getLowerZ() - _region.getLowerZ();
-		const Voxel *start = _data + (int64_t)zStart * width * height;
+		const Voxel *start = _data + (int64_t)zStart * _strideZ;
 		const int64_t total = (int64_t)scanDepth * width * height;
 		return scanFlagsLinear(start, total, flagsMask);
 	}
 
 	// When scanning full width, rows within each z-slice are contiguous
-	if (scanWidth == width) {
+	if (scanWidth == width && _strideY == width) {
 		const int yStart = r.getLowerY() - _region.getLowerY();
-		const int64_t zStride = (int64_t)width * height;
 		const int64_t rowsPerSlice = (int64_t)scanHeight * width;
 		for (int z = 0; z < scanDepth; ++z) {
 			const int zPos = r.getLowerZ() - _region.getLowerZ() + z;
-			const Voxel *start = _data + zPos * zStride + (int64_t)yStart * width;
+			const Voxel *start = _data + zPos * _strideZ + (int64_t)yStart * width;
 			if (scanFlagsLinear(start, rowsPerSlice, flagsMask)) {
 				return true;
 			}
@@ -224,8 +235,8 @@ bool RawVolume::hasFlags(const Region &region, uint8_t flags) const {
 	}
 
 	// Non-full-width: per-row scanning
-	const int64_t yStride = width;
-	const int64_t zStride = (int64_t)width * height;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 	const int xStart = r.getLowerX() - _region.getLowerX();
 	const glm::ivec3 &mins = r.getLowerCorner();
 	const glm::ivec3 &maxs = r.getUpperCorner();
@@ -248,15 +259,21 @@ Region RawVolume::regionForFlag(uint8_t flag) const {
 	const int w = _region.getWidthInVoxels();
 	const int h = _region.getHeightInVoxels();
 	const int d = _region.getDepthInVoxels();
-	const int64_t yStride = w;
-	const int64_t zStride = (int64_t)w * h;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 	// See voxel::Voxel::_flags
 	const uint32_t flagsMask = (uint32_t)(flag & 0x3) << 2;
 
+	// the voxels of the array outside of the region are air - scan the rows of a slice including the gaps
+	const int64_t sliceLength = (int64_t)(h - 1) * yStride + w;
+	auto scanSlice = [this, zStride, sliceLength, flagsMask](int z) {
+		return scanFlagsLinear(_data + z * zStride, sliceLength, flagsMask);
+	};
+
 	// Phase 1: Find Z bounds by scanning slices from both ends
 	int minZ = -1;
 	for (int z = 0; z < d; ++z) {
-		if (scanFlagsLinear(_data + z * zStride, zStride, flagsMask)) {
+		if (scanSlice(z)) {
 			minZ = z;
 			break;
 		}
@@ -267,7 +284,7 @@ Region RawVolume::regionForFlag(uint8_t flag) const {
 
 	int maxZ = minZ;
 	for (int z = d - 1; z > minZ; --z) {
-		if (scanFlagsLinear(_data + z * zStride, zStride, flagsMask)) {
+		if (scanSlice(z)) {
 			maxZ = z;
 			break;
 		}
@@ -281,7 +298,7 @@ Region RawVolume::regionForFlag(uint8_t flag) const {
 		const int64_t zBase = z * zStride;
 
 		// Skip empty z-slices (minZ/maxZ are known to have flags)
-		if (z != minZ && z != maxZ && !scanFlagsLinear(_data + zBase, zStride, flagsMask)) {
+		if (z != minZ && z != maxZ && !scanSlice(z)) {
 			continue;
 		}
 
@@ -378,10 +395,8 @@ void RawVolume::removeFlags(const Region &region, uint8_t flags) {
 
 	const glm::ivec3 &mins = r.getLowerCorner();
 	const glm::ivec3 &maxs = r.getUpperCorner();
-	const int64_t width = _region.getWidthInVoxels();
-	const int64_t height = _region.getHeightInVoxels();
-	const int64_t yStride = width;
-	const int64_t zStride = width * height;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 
 	const int64_t xStart = mins.x - _region.getLowerX();
 	const int lineLength = maxs.x - mins.x + 1;
@@ -396,8 +411,8 @@ void RawVolume::removeFlags(const Region &region, uint8_t flags) {
 			int offset = 0;
 			int remaining = lineLength;
 
-			// Handle misaligned start (baseIndex is odd means not 8-byte aligned for 4-byte Voxels)
-			if ((baseIndex & 1) && remaining > 0) {
+			// Handle misaligned start (not 8-byte aligned for 4-byte Voxels)
+			if ((((uintptr_t)&_data[baseIndex]) & 7u) && remaining > 0) {
 				uint32_t *data32 = (uint32_t *)&_data[baseIndex];
 				*data32 &= clearMask32;
 				offset = 1;
@@ -438,10 +453,8 @@ void RawVolume::toggleFlags(const Region &region, uint8_t flags) {
 
 	const glm::ivec3 &mins = r.getLowerCorner();
 	const glm::ivec3 &maxs = r.getUpperCorner();
-	const int64_t width = _region.getWidthInVoxels();
-	const int64_t height = _region.getHeightInVoxels();
-	const int64_t yStride = width;
-	const int64_t zStride = width * height;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 
 	const int64_t xStart = mins.x - _region.getLowerX();
 	const int lineLength = maxs.x - mins.x + 1;
@@ -456,8 +469,8 @@ void RawVolume::toggleFlags(const Region &region, uint8_t flags) {
 			int offset = 0;
 			int remaining = lineLength;
 
-			// Handle misaligned start (baseIndex is odd means not 8-byte aligned for 4-byte Voxels)
-			if ((baseIndex & 1) && remaining > 0) {
+			// Handle misaligned start (not 8-byte aligned for 4-byte Voxels)
+			if ((((uintptr_t)&_data[baseIndex]) & 7u) && remaining > 0) {
 				uint32_t *data32 = (uint32_t *)&_data[baseIndex];
 				*data32 ^= flagsMask32;
 				offset = 1;
@@ -498,10 +511,8 @@ void RawVolume::setFlags(const Region &region, uint8_t flags) {
 
 	const glm::ivec3 &mins = r.getLowerCorner();
 	const glm::ivec3 &maxs = r.getUpperCorner();
-	const int64_t width = _region.getWidthInVoxels();
-	const int64_t height = _region.getHeightInVoxels();
-	const int64_t yStride = width;
-	const int64_t zStride = width * height;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 
 	const int64_t xStart = mins.x - _region.getLowerX();
 	const int lineLength = maxs.x - mins.x + 1;
@@ -516,8 +527,8 @@ void RawVolume::setFlags(const Region &region, uint8_t flags) {
 			int offset = 0;
 			int remaining = lineLength;
 
-			// Handle misaligned start (baseIndex is odd means not 8-byte aligned for 4-byte Voxels)
-			if ((baseIndex & 1) && remaining > 0) {
+			// Handle misaligned start (not 8-byte aligned for 4-byte Voxels)
+			if ((((uintptr_t)&_data[baseIndex]) & 7u) && remaining > 0) {
 				uint32_t *data32 = (uint32_t *)&_data[baseIndex];
 				*data32 |= flagsMask32;
 				offset = 1;
@@ -553,10 +564,8 @@ bool RawVolume::isEmpty(const Region &region) const {
 
 	const glm::ivec3 &mins = r.getLowerCorner();
 	const glm::ivec3 &maxs = r.getUpperCorner();
-	const int64_t width = _region.getWidthInVoxels();
-	const int64_t height = _region.getHeightInVoxels();
-	const int64_t yStride = width;
-	const int64_t zStride = width * height;
+	const int64_t yStride = _strideY;
+	const int64_t zStride = _strideZ;
 
 	const int lineLength = maxs.x - mins.x + 1;
 	const int voxelLineSize = sizeof(voxel::Voxel) * lineLength;
@@ -580,7 +589,7 @@ bool RawVolume::isEmpty(const Region &region) const {
 
 bool RawVolume::copyInto(const RawVolume &src) {
 	if (_region == src.region()) {
-		core_memcpy((void *)_data, (const void *)src._data, RawVolume::size(_region));
+		copyRows(_data, _strideY, _strideZ, src._data, src._strideY, src._strideZ, _region.getDimensionsInVoxels());
 		return true;
 	}
 	voxel::Region srcRegion = src.region();
@@ -604,19 +613,14 @@ bool RawVolume::copyInto(const RawVolume &src, const voxel::Region &region) {
 		const glm::ivec3 &mins = srcRegion.getLowerCorner();
 		const glm::ivec3 &maxs = srcRegion.getUpperCorner();
 		const voxel::Region &fullSrcRegion = src.region();
-		const int64_t width = _region.getWidthInVoxels();
-		const int64_t height = _region.getHeightInVoxels();
-
-		const int64_t tgtYStride = width;
-		const int64_t tgtZStride = width * height;
+		const int64_t tgtYStride = _strideY;
+		const int64_t tgtZStride = _strideZ;
 
-		const int64_t srcWidth = fullSrcRegion.getWidthInVoxels();
-		const int64_t srcHeight = fullSrcRegion.getHeightInVoxels();
 		const int64_t srcXOffset = mins.x - fullSrcRegion.getLowerX();
 		const int64_t srcYOffset = mins.y - fullSrcRegion.getLowerY();
 		const int64_t srcZOffset = mins.z - fullSrcRegion.getLowerZ();
-		const int64_t srcYStride = srcWidth;
-		const int64_t srcZStride = srcWidth * srcHeight;
+		const int64_t srcYStride = src._strideY;
+		const int64_t srcZStride = src._strideZ;
 		const int64_t tgtXOffset = mins.x - _region.getLowerX();
 
 		const int lineLength = maxs.x - mins.x + 1;
@@ -645,10 +649,16 @@ bool RawVolume::copyInto(const RawVolume &src, const voxel::Region &region) {
 }
 
 RawVolume::RawVolume(RawVolume &&move) noexcept {
+	_buffer = move._buffer;
 	_data = move._data;
+	move._buffer = nullptr;
 	move._data = nullptr;
 	_region = move._region;
 	_borderVoxel = move._borderVoxel;
+	_capacity = move._capacity;
+	_offset = move._offset;
+	_strideY = move._strideY;
+	_strideZ = move._strideZ;
 }
 
 RawVolume::RawVolume(const Voxel *data, const voxel::Region &region) {
@@ -657,18 +667,131 @@ RawVolume::RawVolume(const Voxel *data, const voxel::Region &region) {
 	core_memcpy((void *)_data, (const void *)data, size);
 }
 
-RawVolume::RawVolume(Voxel *data, const voxel::Region &region) : _region(region), _data(data) {
+RawVolume::RawVolume(Voxel *data, const voxel::Region &region) : _region(region) {
 	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
 	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
 	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+	setBuffer(data, _region.getDimensionsInVoxels(), glm::ivec3(0));
 }
 
 RawVolume::~RawVolume() {
-	core_free(_data);
+	core_memory_scoped(Volume);
+	core_free(_buffer);
+	_buffer = nullptr;
 	_data = nullptr;
 }
 
+void RawVolume::setBuffer(Voxel *buffer, const glm::ivec3 &capacity, const glm::ivec3 &offset) {
+	_buffer = buffer;
+	_capacity = capacity;
+	_offset = offset;
+	_strideY = capacity.x;
+	_strideZ = (int64_t)capacity.x * capacity.y;
+	_data = _buffer + offset.x + offset.y * _strideY + offset.z * _strideZ;
+}
+
+bool RawVolume::reallocate(const Region &region, const Region &bufferRegion) {
+	core_memory_scoped(Volume);
+	core_trace_scoped(RawVolumeReallocate);
+	const size_t size = RawVolume::size(bufferRegion);
+	Voxel *buffer = (Voxel *)core_malloc(size);
+	if (buffer == nullptr) {
+		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for a volume with the dimensions %i:%i:%i",
+				   (uint64_t)size, bufferRegion.getWidthInVoxels(), bufferRegion.getHeightInVoxels(),
+				   bufferRegion.getDepthInVoxels());
+		return false;
+	}
+	core_memset((void *)buffer, 0, size);
+
+	Voxel *oldBuffer = _buffer;
+	const Voxel *oldData = _data;
+	const int64_t oldStrideY = _strideY;
+	const int64_t oldStrideZ = _strideZ;
+	const Region oldRegion = _region;
+
+	_region = region;
+	setBuffer(buffer, bufferRegion.getDimensionsInVoxels(), region.getLowerCorner() - bufferRegion.getLowerCorner());
+
+	Region keep = oldRegion;
+	keep.cropTo(region);
+	if (intersects(oldRegion, region) && keep.isValid()) {
+		const glm::ivec3 &lower = keep.getLowerCorner();
+		const glm::ivec3 src = lower - oldRegion.getLowerCorner();
+		copyRows(_data + index(lower.x, lower.y, lower.z), _strideY, _strideZ,
+				 oldData + src.x + src.y * oldStrideY + src.z * oldStrideZ, oldStrideY, oldStrideZ,
+				 keep.getDimensionsInVoxels());
+	}
+	core_free(oldBuffer);
+	return true;
+}
+
+void RawVolume::clearOutside(const Region &region) {
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	const glm::ivec3 &maxs = _region.getUpperCorner();
+	const int lowerX = core_max(mins.x, region.getLowerX());
+	const int upperX = core_min(maxs.x, region.getUpperX());
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			Voxel *row = _data + index(mins.x, y, z);
+			if (!region.containsPointInZ(z) || !region.containsPointInY(y) || lowerX > upperX) {
+				core_memset((void *)row, 0, sizeof(Voxel) * _region.getWidthInVoxels());
+				continue;
+			}
+			if (lowerX > mins.x) {
+				core_memset((void *)row, 0, sizeof(Voxel) * (lowerX - mins.x));
+			}
+			if (upperX < maxs.x) {
+				core_memset((void *)(row + (upperX + 1 - mins.x)), 0, sizeof(Voxel) * (maxs.x - upperX));
+			}
+		}
+	}
+}
+
+bool RawVolume::resize(const Region &region) {
+	if (!region.isValid()) {
+		return false;
+	}
+	if (region == _region) {
+		return true;
+	}
+	core_trace_scoped(RawVolumeResize);
+	const glm::ivec3 bufferLower = _region.getLowerCorner() - _offset;
+	const Region bufferRegion(bufferLower, bufferLower + _capacity - 1);
+	if (bufferRegion.containsRegion(region)) {
+		if (RawVolume::size(bufferRegion) > 4u * RawVolume::size(region) && reallocate(region, region)) {
+			return true;
+		}
+		// all voxels of the array outside of the region must be air
+		clearOutside(region);
+		_region = region;
+		setBuffer(_buffer, _capacity, region.getLowerCorner() - bufferLower);
+		return true;
+	}
+
+	// add some headroom to the sides that grew out of the array - the next resize steps don't need to copy then
+	glm::ivec3 lower = region.getLowerCorner();
+	glm::ivec3 upper = region.getUpperCorner();
+	const glm::ivec3 &dimensions = region.getDimensionsInVoxels();
+	for (int i = 0; i < 3; ++i) {
+		const int headroom = core_max(dimensions[i] / 2, 16);
+		if (lower[i] < bufferRegion.getLowerCorner()[i]) {
+			lower[i] -= headroom;
+		}
+		if (upper[i] > bufferRegion.getUpperCorner()[i]) {
+			upper[i] += headroom;
+		}
+	}
+	if (reallocate(region, Region(lower, upper))) {
+		return true;
+	}
+	// try again without the headroom
+	return reallocate(region, region);
+}
+
 bool RawVolume::move(const glm::ivec3 &shift) {
+	if (!contiguous() && !reallocate(_region, _region)) {
+		return false;
+	}
 	const int w = width();
 	const int h = height();
 	const int d = depth();
@@ -700,7 +823,8 @@ bool RawVolume::move(const glm::ivec3 &shift) {
 Voxel *RawVolume::copyVoxels() const {
 	const size_t size = RawVolume::size(_region);
 	Voxel *rawCopy = (Voxel *)core_malloc(size);
-	core_memcpy((void *)rawCopy, (const void *)_data, size);
+	const glm::ivec3 &dimensions = _region.getDimensionsInVoxels();
+	copyRows(rawCopy, dimensions.x, (int64_t)dimensions.x * dimensions.y, _data, _strideY, _strideZ, dimensions);
 	return rawCopy;
 }
 
@@ -714,11 +838,7 @@ Voxel *RawVolume::copyVoxels() const {
  */
 const Voxel &RawVolume::voxel(int32_t x, int32_t y, int32_t z) const {
 	if (_region.containsPoint(x, y, z)) {
-		const int32_t iLocalXPos = x - _region.getLowerX();
-		const int32_t iLocalYPos = y - _region.getLowerY();
-		const int32_t iLocalZPos = z - _region.getLowerZ();
-
-		return _data[(int64_t)iLocalXPos + (int64_t)iLocalYPos * width() + (int64_t)iLocalZPos * _region.stride()];
+		return _data[index(x, y, z)];
 	}
 	return _borderVoxel;
 }
@@ -741,10 +861,19 @@ bool RawVolume::setVoxel(int32_t x, int32_t y, int32_t z, const Voxel &voxel) {
 	return setVoxel(glm::ivec3(x, y, z), voxel);
 }
 
+/**
+ * @param idx the index of the voxel in the region - x running fastest, followed by y and last z
+ */
 bool RawVolume::setVoxel(int64_t idx, const Voxel &voxel) {
 	if (idx < 0 || idx >= _region.stride() * depth()) {
 		return false; // Index out of bounds
 	}
+	if (!contiguous()) {
+		const int64_t w = width();
+		const int64_t z = idx / _region.stride();
+		const int64_t y = (idx % _region.stride()) / w;
+		idx = idx % w + y * _strideY + z * _strideZ;
+	}
 	if (_data[idx] == voxel) {
 		return false;
 	}
@@ -765,27 +894,23 @@ bool RawVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
 	if (!inside) {
 		return false;
 	}
-	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
-	const glm::ivec3 localPos = pos - lowerCorner;
-	const int64_t index = (int64_t)localPos.x + (int64_t)localPos.y * width() + (int64_t)localPos.z * _region.stride();
-	if (_data[index] == voxel) {
+	const int64_t idx = index(pos.x, pos.y, pos.z);
+	if (_data[idx] == voxel) {
 		return false;
 	}
-	_data[index] = voxel;
+	_data[idx] = voxel;
 	return true;
 }
 
 void RawVolume::setVoxelUnsafe(const glm::ivec3 &pos, const Voxel &voxel) {
-	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
-	const glm::ivec3 localPos = pos - lowerCorner;
-	const int64_t index = (int64_t)localPos.x + (int64_t)localPos.y * width() + (int64_t)localPos.z * _region.stride();
-	_data[index] = voxel;
+	_data[index(pos.x, pos.y, pos.z)] = voxel;
 }
 
 /**
  * This function should probably be made internal...
  */
 void RawVolume::initialise(const Region &regValidRegion) {
+	core_memory_scoped(Volume);
 	_region = regValidRegion;
 
 	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
@@ -794,31 +919,44 @@ void RawVolume::initialise(const Region &regValidRegion) {
 
 	// Create the data
 	const size_t size = RawVolume::size(_region);
-	_data = (Voxel *)core_malloc(size);
-	if (_data == nullptr) {
+	Voxel *buffer = (Voxel *)core_malloc(size);
+	if (buffer == nullptr) {
 		Log::error("Failed to allocate %" SDL_PRIu64 " bytes for a volume with the dimensions %i:%i:%i",
 				   (uint64_t)size, width(), height(), depth());
 		return;
 	}
+	setBuffer(buffer, _region.getDimensionsInVoxels(), glm::ivec3(0));
 
 	// Clear to zeros
 	clear();
 }
 
 void RawVolume::clear() {
-	Voxel voxel;
-	fill(voxel);
+	if (_buffer == nullptr) {
+		return;
+	}
+	// this includes the voxels outside of the region
+	core_memset((void *)_buffer, 0, sizeof(Voxel) * (size_t)_strideZ * _capacity.z);
 }
 
 void RawVolume::fill(const voxel::Voxel &voxel) {
 	if (!_region.isValid()) {
 		return;
 	}
-	const size_t size = _region.stride() * depth();
 	uint32_t val;
 	core_memcpy(&val, &voxel, sizeof(val));
-	core_memset4((void *)_data, val, size);
 	static_assert(sizeof(Voxel) == sizeof(uint32_t), "Voxel is expected to be 4 bytes");
+	if (contiguous()) {
+		const size_t size = _region.stride() * depth();
+		core_memset4((void *)_data, val, size);
+		return;
+	}
+	// the voxels outside of the region must stay air
+	for (int z = 0; z < depth(); ++z) {
+		for (int y = 0; y < height(); ++y) {
+			core_memset4((void *)(_data + z * _strideZ + y * _strideY), val, width());
+		}
+	}
 }
 
 } // namespace voxel
@@ -14,6 +14,10 @@ namespace voxel {
 
 /**
  * Simple volume implementation which stores data in a single large 3D array.
+ *
+ * The array might be bigger than the region of the volume if the volume was grown with @c resize() - all voxels
+ * of the array that are outside of the region are air. Use @c strideY() and @c strideZ() to address the voxels
+ * in the array that is returned by @c voxels().
  */
 class RawVolume {
 private:
@@ -70,7 +74,7 @@ public:
 	~RawVolume();
 
 	/**
-	 * Copy the raw data of the volume
+	 * Copy the raw data of the volume - the copy has no gaps between the rows and slices of the region
 	 * @note It's the callers responsibility to properly release the memory.
 	 */
 	Voxel *copyVoxels() const;
@@ -87,6 +91,40 @@ public:
 	 */
 	const Region &region() const;
 
+	/**
+	 * @brief Changes the region of the volume without creating a new volume. The voxels of the old region that are
+	 * part of the new region are kept - all other voxels of the new region are air.
+	 *
+	 * Growing only touches the new voxels as long as they fit into the allocated array. Otherwise the array is
+	 * reallocated with some headroom on the grown sides, so growing the volume step by step only copies the voxels
+	 * a few times. Shrinking releases the memory once the array is more than four times bigger than the region.
+	 *
+	 * @note Samplers and pointers into the voxel array are no longer valid after this call.
+	 * @return @c false if the region is invalid or the memory couldn't get allocated - the volume is not changed then
+	 */
+	bool resize(const Region &region);
+
+	/**
+	 * @return The dimensions of the allocated voxel array - this is bigger than the region if the volume was grown
+	 * with @c resize()
+	 */
+	const glm::ivec3 &capacity() const;
+
+	/**
+	 * @return @c true if the array returned by @c voxels() has no gaps between the rows and slices of the region
+	 */
+	bool contiguous() const;
+
+	/**
+	 * @return The distance between two voxels on the y axis in the array returned by @c voxels()
+	 */
+	int64_t strideY() const;
+
+	/**
+	 * @return The distance between two voxels on the z axis in the array returned by @c voxels()
+	 */
+	int64_t strideZ() const;
+
 	/**
 	 * @return A Region representing the extent of the volume.
 	 */
@@ -154,20 +192,23 @@ public:
 	void clear();
 	void fill(const voxel::Voxel &voxel);
 
-	// TODO: we should not rely on this data to be a linear array.
-	//       We might add chunks to the RawVolume to reduce the memory
-	//       usage for big volumes that are empty - and in that case
-	//       the data is no longer linear.
+	/**
+	 * @note This is only a linear array of the region if @c contiguous() returns @c true
+	 * @sa voxels()
+	 */
 	inline const uint8_t *data() const {
 		return (const uint8_t *)_data;
 	}
 
+	/**
+	 * @return The voxel at the lower corner of the region - use @c strideY() and @c strideZ() to address the others
+	 */
 	inline Voxel *voxels() const {
 		return _data;
 	}
 
 	/**
-	 * @brief Shift the region of the volume by the given coordinates
+	 * @brief Shift the region of the volume by the given coordinates - the voxels are not touched
 	 */
 	void translate(const glm::ivec3 &t) {
 		_region.shift(t.x, t.y, t.z);
@@ -188,6 +229,14 @@ public:
 
 private:
 	void initialise(const Region &region);
+	void setBuffer(Voxel *buffer, const glm::ivec3 &capacity, const glm::ivec3 &offset);
+	/**
+	 * @brief Moves the voxels into a new array that covers @c bufferRegion and changes the volume region to
+	 * @c region
+	 */
+	bool reallocate(const Region &region, const Region &bufferRegion);
+	void clearOutside(const Region &region);
+	int64_t index(int32_t x, int32_t y, int32_t z) const;
 
 	/** The size of the volume */
 	Region _region;
@@ -195,14 +244,44 @@ private:
 	/** The border value */
 	Voxel _borderVoxel;
 
-	/** The voxel data */
-	Voxel *_data;
+	/** The dimensions of the allocated voxel array */
+	glm::ivec3 _capacity{0};
+	/** The position of the lower corner of the region in the allocated voxel array */
+	glm::ivec3 _offset{0};
+	int64_t _strideY = 0;
+	int64_t _strideZ = 0;
+
+	/** The allocated voxel array */
+	Voxel *_buffer = nullptr;
+	/** The voxel at the lower corner of the region */
+	Voxel *_data = nullptr;
 };
 
 inline const Region &RawVolume::region() const {
 	return _region;
 }
 
+inline const glm::ivec3 &RawVolume::capacity() const {
+	return _capacity;
+}
+
+inline bool RawVolume::contiguous() const {
+	return _capacity == _region.getDimensionsInVoxels();
+}
+
+inline int64_t RawVolume::strideY() const {
+	return _strideY;
+}
+
+inline int64_t RawVolume::strideZ() const {
+	return _strideZ;
+}
+
+inline int64_t RawVolume::index(int32_t x, int32_t y, int32_t z) const {
+	return (int64_t)(x - _region.getLowerX()) + (int64_t)(y - _region.getLowerY()) * _strideY +
+		   (int64_t)(z - _region.getLowerZ()) * _strideZ;
+}
+
 inline const Voxel &RawVolume::borderValue() const {
 	return _borderVoxel;
 }
@@ -57,6 +57,14 @@ public:
 		return _volume->depth();
 	}
 
+	inline int64_t strideY() const {
+		return _volume->strideY();
+	}
+
+	inline int64_t strideZ() const {
+		return _volume->strideZ();
+	}
+
 	inline operator RawVolume& () const {
 		return *_volume;
 	}
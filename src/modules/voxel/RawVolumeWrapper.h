@@ -8,20 +8,50 @@
 #include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
 #include "core/concurrent/Lock.h"
+#include "voxel/DirtyChunks.h"
 #include "voxel/RawVolume.h"
 
 namespace voxel {
 
 /**
  * @brief A wrapper for a RawVolume that performs a sanity check for the setVoxel call.
+ *
+ * The modified positions are tracked as bounding box (@c dirtyRegion()) and as set of touched chunks
+ * (@c dirtyChunks()) - use @c dirtyRegions() to only process what was actually changed.
  */
 class RawVolumeWrapper {
 protected:
 	RawVolume* _volume;
 	Region _region;
-	Region _dirtyRegion = Region::InvalidRegion;
+	DirtyChunks _dirtyChunks;
+	/** the bounding box of the modified positions since the last @c takeModifiedRegion() call */
+	Region _modifiedRegion = Region::InvalidRegion;
 	mutable core_trace_mutex(core::Lock, _lock, "RawVolumeWrapper");
 
+	/**
+	 * @note Not locked - use @c addToDirtyRegion() if other threads might modify the volume, too
+	 */
+	inline void markDirty(const glm::ivec3 &pos) {
+		_dirtyChunks.add(pos);
+		if (_modifiedRegion.isValid()) {
+			_modifiedRegion.accumulate(pos);
+		} else {
+			_modifiedRegion = Region(pos, pos);
+		}
+	}
+
+	/**
+	 * @note Not locked - use @c addToDirtyRegion() if other threads might modify the volume, too
+	 */
+	inline void markDirty(const Region &region) {
+		_dirtyChunks.add(region);
+		if (_modifiedRegion.isValid()) {
+			_modifiedRegion.accumulate(region);
+		} else {
+			_modifiedRegion = region;
+		}
+	}
+
 public:
 	class Sampler : public VolumeSampler<RawVolumeWrapper> {
 	private:
@@ -53,11 +83,11 @@ public:
 	};
 
 	RawVolumeWrapper(voxel::RawVolume* volume) :
-			_volume(volume), _region(volume->region()) {
+			_volume(volume), _region(volume->region()), _dirtyChunks(volume->region()) {
 	}
 
 	RawVolumeWrapper(voxel::RawVolume* volume, const voxel::Region &region) :
-			_volume(volume), _region(region) {
+			_volume(volume), _region(region), _dirtyChunks(volume->region()) {
 		_region.cropTo(volume->region());
 	}
 
@@ -76,6 +106,12 @@ public:
 	inline int depth() const {
 		return _volume->depth();
 	}
+	inline int64_t strideY() const {
+		return _volume->strideY();
+	}
+	inline int64_t strideZ() const {
+		return _volume->strideZ();
+	}
 
 	inline operator RawVolume& () const {
 		return *_volume;
@@ -99,11 +135,12 @@ public:
 
 	inline void addToDirtyRegion(const glm::ivec3 &pos) {
 		core::ScopedLock lock(_lock);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(pos);
-		} else {
-			_dirtyRegion = Region(pos, pos);
-		}
+		markDirty(pos);
+	}
+
+	inline void addToDirtyRegion(const Region &region) {
+		core::ScopedLock lock(_lock);
+		markDirty(region);
 	}
 
 	template<class COLLECTION>
@@ -112,33 +149,54 @@ public:
 			return;
 		}
 		core::ScopedLock lock(_lock);
-		if (!_dirtyRegion.isValid()) {
-			_dirtyRegion = Region(positions[0], positions[0]);
-		}
 		for (const glm::ivec3 &pos : positions) {
-			_dirtyRegion.accumulate(pos);
+			markDirty(pos);
 		}
 	}
 
 	void fill(const voxel::Voxel &voxel) {
 		_volume->fill(voxel);
-		_dirtyRegion = _volume->region();
+		markDirty(_volume->region());
 	}
 
 	void clear() {
-		_dirtyRegion = _volume->region();
+		markDirty(_volume->region());
 		_volume->clear();
 	}
 
+	/**
+	 * @brief Changes the region of the wrapped volume in place
+	 * @sa RawVolume::resize()
+	 */
+	bool resize(const Region &region) {
+		const bool fullVolume = _region == _volume->region();
+		if (!_volume->resize(region)) {
+			return false;
+		}
+		_dirtyChunks.init(_volume->region());
+		// everything is new for the caches that were derived from the old region
+		_modifiedRegion = _volume->region();
+		if (fullVolume) {
+			_region = _volume->region();
+		} else {
+			_region.cropTo(_volume->region());
+		}
+		return true;
+	}
+
 	inline void setVolume(RawVolume* v) {
 		if (_volume == v) {
 			return;
 		}
 		_volume = v;
-		_dirtyRegion = Region::InvalidRegion;
 		if (_volume == nullptr) {
 			_region = Region::InvalidRegion;
+			_dirtyChunks.init(Region::InvalidRegion);
+			_modifiedRegion = Region::InvalidRegion;
 		} else {
+			_dirtyChunks.init(_volume->region());
+			// everything is new for the caches that were derived from the old volume
+			_modifiedRegion = _volume->region();
 			if (_region.isValid()) {
 				_region.cropTo(_volume->region());
 			} else {
@@ -167,8 +225,34 @@ public:
 		return setVoxel(pos.x, pos.y, pos.z, voxel);
 	}
 
+	/**
+	 * @return The bounding box of all modified positions
+	 */
 	inline const Region& dirtyRegion() const {
-		return _dirtyRegion;
+		return _dirtyChunks.region();
+	}
+
+	inline const DirtyChunks& dirtyChunks() const {
+		return _dirtyChunks;
+	}
+
+	/**
+	 * @return The bounding box of the modified positions since the last call - this is for caches that are derived
+	 * from the volume and are updated incrementally. Contrary to @c dirtyRegion() this is reset by every call.
+	 */
+	Region takeModifiedRegion() {
+		core::ScopedLock lock(_lock);
+		const Region modified = _modifiedRegion;
+		_modifiedRegion = Region::InvalidRegion;
+		return modified;
+	}
+
+	/**
+	 * @return The modified parts of the volume as list of boxes that only cover the touched chunks
+	 * @sa DirtyChunks::regions()
+	 */
+	inline core::DynamicArray<Region> dirtyRegions() const {
+		return _dirtyChunks.regions();
 	}
 
 	/**
@@ -0,0 +1,456 @@
+/**
+ * @file
+ */
+
+#include "SelectionMask.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/RawVolume.h"
+
+namespace voxel {
+
+namespace {
+
+// the bits of the x = 0 and x = 7 columns of a slice word
+static constexpr uint64_t ColumnX0 = 0x0101010101010101ull;
+static constexpr uint64_t ColumnX7 = ColumnX0 << 7;
+
+inline int countBits(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(v);
+#else
+	v = v - ((v >> 1) & 0x5555555555555555ull);
+	v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+	v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (int)((v * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+inline int lowestBit(uint32_t v) {
+	int i = 0;
+	while ((v & 1u) == 0u) {
+		v >>= 1;
+		++i;
+	}
+	return i;
+}
+
+inline int highestBit(uint32_t v) {
+	int i = -1;
+	while (v != 0u) {
+		v >>= 1;
+		++i;
+	}
+	return i;
+}
+
+/**
+ * @brief The bits of the slice word that are inside the given local x and y range
+ */
+inline uint64_t sliceMask(int x0, int x1, int y0, int y1) {
+	const uint64_t row = (((uint64_t)1 << (x1 - x0 + 1)) - 1) << x0;
+	uint64_t mask = 0u;
+	for (int y = y0; y <= y1; ++y) {
+		mask |= row << (y * SelectionMask::BrickSide);
+	}
+	return mask;
+}
+
+inline uint64_t bitIndex(const glm::ivec3 &pos) {
+	return (uint64_t)1 << ((pos.x & 7) + (pos.y & 7) * SelectionMask::BrickSide);
+}
+
+} // namespace
+
+void SelectionMask::Brick::updateCount() {
+	count = 0;
+	for (int z = 0; z < BrickSide; ++z) {
+		count += countBits(bits[z]);
+	}
+}
+
+SelectionMask::Brick *SelectionMask::findBrick(const glm::ivec3 &brick) const {
+	auto iter = _bricks.find(brick);
+	if (iter == _bricks.end()) {
+		return nullptr;
+	}
+	return &iter->value;
+}
+
+SelectionMask::Brick &SelectionMask::findOrCreateBrick(const glm::ivec3 &brick) {
+	auto iter = _bricks.find(brick);
+	if (iter != _bricks.end()) {
+		return iter->value;
+	}
+	_bricks.put(brick, Brick());
+	return _bricks.find(brick)->value;
+}
+
+void SelectionMask::compact() {
+	core::DynamicArray<glm::ivec3> empty;
+	_count = 0;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		Brick &brick = iter->value;
+		brick.updateCount();
+		if (brick.empty()) {
+			empty.push_back(iter->key);
+		}
+		_count += brick.count;
+	}
+	for (const glm::ivec3 &key : empty) {
+		_bricks.remove(key);
+	}
+	_regionDirty = true;
+}
+
+void SelectionMask::updateRegion() const {
+	_region = Region::InvalidRegion;
+	_regionDirty = false;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const Brick &brick = iter->value;
+		uint64_t plane = 0u;
+		int z0 = BrickSide;
+		int z1 = -1;
+		for (int z = 0; z < BrickSide; ++z) {
+			if (brick.bits[z] == 0u) {
+				continue;
+			}
+			plane |= brick.bits[z];
+			z0 = core_min(z0, z);
+			z1 = z;
+		}
+		if (plane == 0u) {
+			continue;
+		}
+		uint32_t rows = 0u;
+		uint32_t columns = 0u;
+		for (int y = 0; y < BrickSide; ++y) {
+			const uint32_t row = (uint32_t)(plane >> (y * BrickSide)) & 0xffu;
+			if (row != 0u) {
+				rows |= 1u << y;
+				columns |= row;
+			}
+		}
+		const glm::ivec3 mins = iter->key * BrickSide;
+		const Region region(mins + glm::ivec3(lowestBit(columns), lowestBit(rows), z0),
+							mins + glm::ivec3(highestBit(columns), highestBit(rows), z1));
+		if (_region.isValid()) {
+			_region.accumulate(region);
+		} else {
+			_region = region;
+		}
+	}
+}
+
+const Region &SelectionMask::region() const {
+	if (_regionDirty) {
+		updateRegion();
+	}
+	return _region;
+}
+
+bool SelectionMask::set(const glm::ivec3 &pos) {
+	Brick &brick = findOrCreateBrick(brickPos(pos));
+	uint64_t &word = brick.bits[pos.z & 7];
+	const uint64_t bit = bitIndex(pos);
+	if (word & bit) {
+		return false;
+	}
+	word |= bit;
+	++brick.count;
+	++_count;
+	if (!_regionDirty) {
+		if (_region.isValid()) {
+			_region.accumulate(pos);
+		} else {
+			_region = Region(pos, pos);
+		}
+	}
+	return true;
+}
+
+bool SelectionMask::unset(const glm::ivec3 &pos) {
+	const glm::ivec3 key = brickPos(pos);
+	Brick *brick = findBrick(key);
+	if (brick == nullptr) {
+		return false;
+	}
+	uint64_t &word = brick->bits[pos.z & 7];
+	const uint64_t bit = bitIndex(pos);
+	if ((word & bit) == 0u) {
+		return false;
+	}
+	word &= ~bit;
+	--_count;
+	if (--brick->count == 0) {
+		_bricks.remove(key);
+	}
+	// only a position on the bounds can shrink them
+	if (!_regionDirty) {
+		const glm::ivec3 &mins = _region.getLowerCorner();
+		const glm::ivec3 &maxs = _region.getUpperCorner();
+		if (glm::any(glm::equal(pos, mins)) || glm::any(glm::equal(pos, maxs))) {
+			_regionDirty = true;
+		}
+	}
+	return true;
+}
+
+bool SelectionMask::test(const glm::ivec3 &pos) const {
+	const Brick *brick = findBrick(brickPos(pos));
+	if (brick == nullptr) {
+		return false;
+	}
+	return (brick->bits[pos.z & 7] & bitIndex(pos)) != 0u;
+}
+
+void SelectionMask::applyRegion(const Region &region, RegionOp op) {
+	if (!region.isValid()) {
+		return;
+	}
+	auto apply = [op](Brick &brick, const Region &local) {
+		const glm::ivec3 &mins = local.getLowerCorner();
+		const glm::ivec3 &maxs = local.getUpperCorner();
+		const uint64_t mask = sliceMask(mins.x & 7, maxs.x & 7, mins.y & 7, maxs.y & 7);
+		for (int z = mins.z & 7; z <= (maxs.z & 7); ++z) {
+			switch (op) {
+			case RegionOp::Set:
+				brick.bits[z] |= mask;
+				break;
+			case RegionOp::Unset:
+				brick.bits[z] &= ~mask;
+				break;
+			case RegionOp::Toggle:
+				brick.bits[z] ^= mask;
+				break;
+			}
+		}
+	};
+	if (op == RegionOp::Unset) {
+		// only the allocated bricks can change
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			Region local = brickRegion(iter->key);
+			if (!intersects(local, region)) {
+				continue;
+			}
+			local.cropTo(region);
+			apply(iter->value, local);
+		}
+	} else {
+		const glm::ivec3 &first = brickPos(region.getLowerCorner());
+		const glm::ivec3 &last = brickPos(region.getUpperCorner());
+		for (int z = first.z; z <= last.z; ++z) {
+			for (int y = first.y; y <= last.y; ++y) {
+				for (int x = first.x; x <= last.x; ++x) {
+					const glm::ivec3 key(x, y, z);
+					Region local = brickRegion(key);
+					local.cropTo(region);
+					apply(findOrCreateBrick(key), local);
+				}
+			}
+		}
+	}
+	const bool wasValid = !_regionDirty && _region.isValid();
+	compact();
+	if (op == RegionOp::Set) {
+		// adding positions can only grow the bounds
+		_regionDirty = false;
+		if (wasValid) {
+			_region.accumulate(region);
+		} else if (_count == (int64_t)region.voxels()) {
+			_region = region;
+		} else {
+			_regionDirty = true;
+		}
+	}
+}
+
+void SelectionMask::set(const Region &region) {
+	core_trace_scoped(SelectionMaskSetRegion);
+	applyRegion(region, RegionOp::Set);
+}
+
+void SelectionMask::unset(const Region &region) {
+	core_trace_scoped(SelectionMaskUnsetRegion);
+	applyRegion(region, RegionOp::Unset);
+}
+
+void SelectionMask::invert(const Region &region) {
+	core_trace_scoped(SelectionMaskInvert);
+	applyRegion(region, RegionOp::Toggle);
+}
+
+void SelectionMask::clear() {
+	_bricks.clear();
+	_count = 0;
+	_region = Region::InvalidRegion;
+	_regionDirty = false;
+}
+
+void SelectionMask::unite(const SelectionMask &other) {
+	core_trace_scoped(SelectionMaskUnite);
+	if (other.empty()) {
+		return;
+	}
+	const bool wasValid = !_regionDirty && _region.isValid();
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		Brick &brick = findOrCreateBrick(iter->key);
+		for (int z = 0; z < BrickSide; ++z) {
+			brick.bits[z] |= iter->value.bits[z];
+		}
+	}
+	compact();
+	if (wasValid) {
+		_regionDirty = false;
+		_region.accumulate(other.region());
+	}
+}
+
+void SelectionMask::intersect(const SelectionMask &other) {
+	core_trace_scoped(SelectionMaskIntersect);
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		Brick &brick = iter->value;
+		const Brick *otherBrick = other.findBrick(iter->key);
+		for (int z = 0; z < BrickSide; ++z) {
+			brick.bits[z] &= otherBrick == nullptr ? 0u : otherBrick->bits[z];
+		}
+	}
+	compact();
+}
+
+void SelectionMask::subtract(const SelectionMask &other) {
+	core_trace_scoped(SelectionMaskSubtract);
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const Brick *otherBrick = other.findBrick(iter->key);
+		if (otherBrick == nullptr) {
+			continue;
+		}
+		Brick &brick = iter->value;
+		for (int z = 0; z < BrickSide; ++z) {
+			brick.bits[z] &= ~otherBrick->bits[z];
+		}
+	}
+	compact();
+}
+
+void SelectionMask::grow() {
+	core_trace_scoped(SelectionMaskGrow);
+	SelectionMask result;
+	auto spill = [&result](const glm::ivec3 &key, const uint64_t *bits) {
+		uint64_t any = 0u;
+		for (int z = 0; z < BrickSide; ++z) {
+			any |= bits[z];
+		}
+		if (any == 0u) {
+			return;
+		}
+		Brick &brick = result.findOrCreateBrick(key);
+		for (int z = 0; z < BrickSide; ++z) {
+			brick.bits[z] |= bits[z];
+		}
+	};
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const glm::ivec3 &key = iter->key;
+		const uint64_t *w = iter->value.bits;
+		uint64_t grown[BrickSide];
+		uint64_t px[BrickSide], nx[BrickSide], py[BrickSide], ny[BrickSide];
+		uint64_t pz[BrickSide]{}, nz[BrickSide]{};
+		for (int z = 0; z < BrickSide; ++z) {
+			uint64_t v = w[z] | ((w[z] << 1) & ~ColumnX0) | ((w[z] >> 1) & ~ColumnX7) | (w[z] << 8) | (w[z] >> 8);
+			if (z > 0) {
+				v |= w[z - 1];
+			}
+			if (z < BrickSide - 1) {
+				v |= w[z + 1];
+			}
+			grown[z] = v;
+			// the positions on the faces of the brick grow into the neighbour bricks
+			px[z] = (w[z] & ColumnX7) >> 7;
+			nx[z] = (w[z] & ColumnX0) << 7;
+			py[z] = w[z] >> 56;
+			ny[z] = w[z] << 56;
+		}
+		pz[0] = w[BrickSide - 1];
+		nz[BrickSide - 1] = w[0];
+		spill(key, grown);
+		spill(key + glm::ivec3(1, 0, 0), px);
+		spill(key - glm::ivec3(1, 0, 0), nx);
+		spill(key + glm::ivec3(0, 1, 0), py);
+		spill(key - glm::ivec3(0, 1, 0), ny);
+		spill(key + glm::ivec3(0, 0, 1), pz);
+		spill(key - glm::ivec3(0, 0, 1), nz);
+	}
+	result.compact();
+	*this = core::move(result);
+}
+
+void SelectionMask::shrink() {
+	core_trace_scoped(SelectionMaskShrink);
+	SelectionMask result;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const glm::ivec3 &key = iter->key;
+		const uint64_t *w = iter->value.bits;
+		const Brick *bxp = findBrick(key + glm::ivec3(1, 0, 0));
+		const Brick *bxm = findBrick(key - glm::ivec3(1, 0, 0));
+		const Brick *byp = findBrick(key + glm::ivec3(0, 1, 0));
+		const Brick *bym = findBrick(key - glm::ivec3(0, 1, 0));
+		const Brick *bzp = findBrick(key + glm::ivec3(0, 0, 1));
+		const Brick *bzm = findBrick(key - glm::ivec3(0, 0, 1));
+		uint64_t shrunk[BrickSide];
+		uint64_t any = 0u;
+		for (int z = 0; z < BrickSide; ++z) {
+			// the neighbour bit of each position in the same slot - positions outside of the mask are unselected
+			const uint64_t xp = ((w[z] >> 1) & ~ColumnX7) | ((bxp ? bxp->bits[z] & ColumnX0 : 0u) << 7);
+			const uint64_t xm = ((w[z] << 1) & ~ColumnX0) | ((bxm ? bxm->bits[z] & ColumnX7 : 0u) >> 7);
+			const uint64_t yp = (w[z] >> 8) | ((byp ? byp->bits[z] : 0u) << 56);
+			const uint64_t ym = (w[z] << 8) | ((bym ? bym->bits[z] : 0u) >> 56);
+			const uint64_t zp = z < BrickSide - 1 ? w[z + 1] : (bzp ? bzp->bits[0] : 0u);
+			const uint64_t zm = z > 0 ? w[z - 1] : (bzm ? bzm->bits[BrickSide - 1] : 0u);
+			shrunk[z] = w[z] & xp & xm & yp & ym & zp & zm;
+			any |= shrunk[z];
+		}
+		if (any == 0u) {
+			continue;
+		}
+		Brick &brick = result.findOrCreateBrick(key);
+		for (int z = 0; z < BrickSide; ++z) {
+			brick.bits[z] = shrunk[z];
+		}
+	}
+	result.compact();
+	*this = core::move(result);
+}
+
+void SelectionMask::readFlags(const RawVolume &volume, const Region &region, uint8_t flags) {
+	core_trace_scoped(SelectionMaskReadFlags);
+	Region r = region;
+	if (!r.cropTo(volume.region())) {
+		return;
+	}
+	unset(r);
+	const glm::ivec3 &mins = r.getLowerCorner();
+	const glm::ivec3 &maxs = r.getUpperCorner();
+	RawVolume::Sampler sampler(volume);
+	glm::ivec3 cachedKey(INT32_MAX);
+	Brick *cachedBrick = nullptr;
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			sampler.setPosition(mins.x, y, z);
+			for (int x = mins.x; x <= maxs.x; ++x, sampler.movePositiveX()) {
+				if ((sampler.voxel().getFlags() & flags) != flags) {
+					continue;
+				}
+				const glm::ivec3 pos(x, y, z);
+				const glm::ivec3 key = brickPos(pos);
+				if (cachedBrick == nullptr || key != cachedKey) {
+					cachedBrick = &findOrCreateBrick(key);
+					cachedKey = key;
+				}
+				cachedBrick->bits[z & 7] |= bitIndex(pos);
+			}
+		}
+	}
+	compact();
+}
+
+} // namespace voxel
@@ -0,0 +1,181 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/GLM.h"
+#include "core/collection/DynamicMap.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Sparse set of selected voxel positions
+ *
+ * The positions are stored as bitmasks of 8x8x8 bricks - only bricks with at least one selected position are
+ * allocated. The amount of selected positions and the bounds are maintained while the mask is modified. Copying,
+ * clearing and the set operations scale with the amount of selected bricks and not with the size of the volume.
+ *
+ * This is NOT thread safe - but concurrent calls to @c test() are fine.
+ *
+ * @ingroup Voxel
+ */
+class SelectionMask {
+public:
+	static constexpr int BrickSide = 8;
+
+private:
+	/**
+	 * @brief One word per z slice - bit @c x+y*8 is the position @c (x,y) of the slice
+	 */
+	struct Brick {
+		uint64_t bits[BrickSide]{};
+		int count = 0;
+
+		void updateCount();
+		bool empty() const {
+			return count == 0;
+		}
+	};
+
+	using BrickMap = core::DynamicMap<glm::ivec3, Brick, 1031, glm::hash<glm::ivec3>>;
+	BrickMap _bricks;
+	int64_t _count = 0;
+	mutable Region _region = Region::InvalidRegion;
+	mutable bool _regionDirty = false;
+
+	static inline glm::ivec3 brickPos(const glm::ivec3 &pos) {
+		return glm::ivec3(pos.x >> 3, pos.y >> 3, pos.z >> 3);
+	}
+	static inline Region brickRegion(const glm::ivec3 &brick) {
+		const glm::ivec3 mins = brick * BrickSide;
+		return Region(mins, mins + (BrickSide - 1));
+	}
+
+	Brick *findBrick(const glm::ivec3 &brick) const;
+	Brick &findOrCreateBrick(const glm::ivec3 &brick);
+	/**
+	 * @brief Remove all empty bricks and recalculate the amount of selected positions
+	 */
+	void compact();
+	void updateRegion() const;
+	enum class RegionOp : uint8_t { Set, Unset, Toggle };
+	/**
+	 * @brief Apply the operation to the bits of all bricks that intersect the given region
+	 */
+	void applyRegion(const Region &region, RegionOp op);
+
+public:
+	bool set(const glm::ivec3 &pos);
+	bool set(int x, int y, int z) {
+		return set(glm::ivec3(x, y, z));
+	}
+	bool unset(const glm::ivec3 &pos);
+	bool unset(int x, int y, int z) {
+		return unset(glm::ivec3(x, y, z));
+	}
+	bool test(const glm::ivec3 &pos) const;
+	bool test(int x, int y, int z) const {
+		return test(glm::ivec3(x, y, z));
+	}
+
+	/**
+	 * @brief Select all positions of the given region
+	 */
+	void set(const Region &region);
+	/**
+	 * @brief Unselect all positions of the given region
+	 */
+	void unset(const Region &region);
+	/**
+	 * @brief Toggle the selection of all positions of the given region
+	 * @note Other than the other operations this scales with the size of the region
+	 */
+	void invert(const Region &region);
+	void clear();
+
+	/**
+	 * @brief Add all positions that are selected in @c other
+	 */
+	void unite(const SelectionMask &other);
+	/**
+	 * @brief Keep only the positions that are also selected in @c other
+	 */
+	void intersect(const SelectionMask &other);
+	/**
+	 * @brief Remove all positions that are selected in @c other
+	 */
+	void subtract(const SelectionMask &other);
+	/**
+	 * @brief Add the face neighbours of all selected positions
+	 */
+	void grow();
+	/**
+	 * @brief Remove all selected positions that have an unselected face neighbour
+	 */
+	void shrink();
+
+	/**
+	 * @brief Replace the selection in the given region with the voxels of the volume that have the given flags
+	 */
+	void readFlags(const RawVolume &volume, const Region &region, uint8_t flags);
+
+	/**
+	 * @brief The amount of selected positions
+	 */
+	inline int64_t count() const {
+		return _count;
+	}
+	inline bool empty() const {
+		return _count == 0;
+	}
+	inline size_t bricks() const {
+		return _bricks.size();
+	}
+	/**
+	 * @return The bounding box of all selected positions or @c Region::InvalidRegion if nothing is selected
+	 */
+	const Region &region() const;
+
+	/**
+	 * @brief Call @c func(const Region&) for the part of the given region that is covered by each allocated brick
+	 */
+	template<class FUNC>
+	void visitBricks(const Region &region, FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			Region r = brickRegion(iter->key);
+			if (!intersects(r, region)) {
+				continue;
+			}
+			r.cropTo(region);
+			func(r);
+		}
+	}
+
+	/**
+	 * @brief Call @c func(int x, int y, int z) for each selected position
+	 */
+	template<class FUNC>
+	void visit(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			const glm::ivec3 mins = iter->key * BrickSide;
+			const Brick &brick = iter->value;
+			for (int z = 0; z < BrickSide; ++z) {
+				const uint64_t word = brick.bits[z];
+				if (word == 0u) {
+					continue;
+				}
+				for (int i = 0; i < 64; ++i) {
+					if (word & ((uint64_t)1 << i)) {
+						func(mins.x + (i & 7), mins.y + (i >> 3), mins.z + z);
+					}
+				}
+			}
+		}
+	}
+};
+
+} // namespace voxel
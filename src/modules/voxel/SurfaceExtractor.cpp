@@ -5,8 +5,10 @@
 #include "SurfaceExtractor.h"
 #include "core/ConfigVar.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/Var.h"
 #include "palette/Palette.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Region.h"
@@ -26,6 +28,16 @@ SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region
 									mergeQuads, reuseVertices, ambientOcclusion, optimize);
 }
 
+SurfaceExtractionContext buildCubicContext(const BrickedVolume *volume, const Region &region, ChunkMesh &mesh,
+										   const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices,
+										   bool ambientOcclusion, bool optimize) {
+	SurfaceExtractionContext ctx =
+		buildCubicContext((const RawVolume *)nullptr, region, mesh, translate, mergeQuads, reuseVertices,
+						  ambientOcclusion, optimize);
+	ctx.brickedVolume = volume;
+	return ctx;
+}
+
 SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 												   const palette::Palette &palette, bool optimize) {
 	return SurfaceExtractionContext(volume, palette, region, mesh, glm::ivec3(0), SurfaceExtractionType::MarchingCubes,
@@ -47,7 +59,10 @@ SurfaceExtractionContext buildBinaryContext(const RawVolume *volume, const Regio
 }
 
 void extractSurface(voxel::SurfaceExtractionContext &ctx) {
-	core_assert_msg(ctx.volume != nullptr, "Provided volume cannot be null");
+	core_memory_scoped(Mesh);
+	core_assert_msg(ctx.volume != nullptr || ctx.brickedVolume != nullptr, "Provided volume cannot be null");
+	core_assert_msg(ctx.brickedVolume == nullptr || ctx.type == voxel::SurfaceExtractionType::Cubic,
+					"The bricked volume is only supported by the cubic extractor");
 	const glm::ivec3 &mins = ctx.region.getLowerCorner();
 	const glm::ivec3 &maxs = ctx.region.getUpperCorner();
 	Log::debug("Extracting surface with mode %i in region [%d, %d, %d] - [%d, %d, %d]", (int)ctx.type, mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
@@ -68,6 +83,9 @@ void extractSurface(voxel::SurfaceExtractionContext &ctx) {
 		} else {
 			voxel::extractBinaryGreedyMesh(ctx.volume, ctx.region.getLowerCorner(), &ctx.mesh, ctx.translate, ctx.ambientOcclusion);
 		}
+	} else if (ctx.brickedVolume != nullptr) {
+		voxel::extractCubicMesh(ctx.brickedVolume, ctx.region, &ctx.mesh, ctx.translate, ctx.ambientOcclusion,
+								ctx.mergeQuads, ctx.reuseVertices);
 	} else {
 		voxel::extractCubicMesh(ctx.volume, ctx.region, &ctx.mesh, ctx.translate, ctx.ambientOcclusion, ctx.mergeQuads,
 								ctx.reuseVertices);
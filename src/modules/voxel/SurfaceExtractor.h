@@ -12,6 +12,7 @@ class Palette;
 }
 
 namespace voxel {
+class BrickedVolume;
 class RawVolume;
 class Region;
 struct ChunkMesh;
@@ -38,6 +39,11 @@ struct SurfaceExtractionContext {
 	const bool ambientOcclusion; // used only for Cubic and Binary
 	const bool optimize;
 	const bool textureDedupe;	 // used only for GreedyTexture
+	/**
+	 * if set, the voxels are sampled from this volume instead of @c volume - only supported for Cubic
+	 * @sa buildCubicContext()
+	 */
+	const BrickedVolume *brickedVolume = nullptr;
 
 	// used only for GreedyTexture
 	int textureWidth = 0;
@@ -52,6 +58,13 @@ SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region
 										   const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
 										   bool reuseVertices = true, bool ambientOcclusion = true,
 										   bool optimize = false);
+/**
+ * @brief Cubic surface extraction on the bricked storage layout - see @c BrickedVolume
+ */
+SurfaceExtractionContext buildCubicContext(const BrickedVolume *volume, const Region &region, ChunkMesh &mesh,
+										   const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
+										   bool reuseVertices = true, bool ambientOcclusion = true,
+										   bool optimize = false);
 SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 												   const palette::Palette &palette, bool optimize = false);
 SurfaceExtractionContext buildGreedyTextureContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
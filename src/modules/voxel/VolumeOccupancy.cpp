@@ -0,0 +1,71 @@
+/**
+ * @file
+ */
+
+#include "VolumeOccupancy.h"
+
+namespace voxel {
+
+VolumeOccupancy::VolumeOccupancy(const Region &region) {
+	init(region);
+}
+
+void VolumeOccupancy::init(const Region &region) {
+	_occupiedBricks = 0;
+	if (!region.isValid()) {
+		_region = Region::InvalidRegion;
+		_origin = glm::ivec3(0);
+		_bricks = glm::ivec3(0);
+		_superBricks = glm::ivec3(0);
+		_brickBits.resize(0);
+		_superBrickBits.resize(0);
+		return;
+	}
+	_region = region;
+	_origin = region.getLowerCorner();
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	_bricks = ((dim - 1) >> BrickShift) + 1;
+	_superBricks = ((dim - 1) >> SuperBrickShift) + 1;
+	_brickBits.resize((size_t)_bricks.x * _bricks.y * _bricks.z);
+	_brickBits.clear();
+	_superBrickBits.resize((size_t)_superBricks.x * _superBricks.y * _superBricks.z);
+	_superBrickBits.clear();
+}
+
+void VolumeOccupancy::setBrick(const glm::ivec3 &brick, bool occupied) {
+	const size_t idx = brickIndex(brick);
+	if (_brickBits[idx] == occupied) {
+		return;
+	}
+	_brickBits.set(idx, occupied);
+	_occupiedBricks += occupied ? 1 : -1;
+}
+
+void VolumeOccupancy::updateSuperBricks(const glm::ivec3 &brickMins, const glm::ivec3 &brickMaxs) {
+	static constexpr int Shift = SuperBrickShift - BrickShift;
+	const glm::ivec3 superMins = brickMins >> Shift;
+	const glm::ivec3 superMaxs = brickMaxs >> Shift;
+	for (int sz = superMins.z; sz <= superMaxs.z; ++sz) {
+		for (int sy = superMins.y; sy <= superMaxs.y; ++sy) {
+			for (int sx = superMins.x; sx <= superMaxs.x; ++sx) {
+				const glm::ivec3 superBrick(sx, sy, sz);
+				const glm::ivec3 mins = superBrick << Shift;
+				const glm::ivec3 maxs = glm::min(mins + ((1 << Shift) - 1), _bricks - 1);
+				bool occupied = false;
+				for (int z = mins.z; z <= maxs.z && !occupied; ++z) {
+					for (int y = mins.y; y <= maxs.y && !occupied; ++y) {
+						for (int x = mins.x; x <= maxs.x; ++x) {
+							if (_brickBits[brickIndex(glm::ivec3(x, y, z))]) {
+								occupied = true;
+								break;
+							}
+						}
+					}
+				}
+				_superBrickBits.set(superBrickIndex(superBrick), occupied);
+			}
+		}
+	}
+}
+
+} // namespace voxel
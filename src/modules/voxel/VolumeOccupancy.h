@@ -0,0 +1,176 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/ForParallel.h"
+#include "core/GLM.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicBitSet.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+/**
+ * @brief Coarse occupancy of a volume that allows to skip the empty space
+ *
+ * Keeps one bit per brick of @c BrickSize voxels per axis and one bit per super brick of @c SuperBrickSize voxels per
+ * axis. A bit is set if at least one voxel in the brick is not air. The grid starts at the lower corner of the volume
+ * region. Edits only need to update the bricks of the modified region - see @c update().
+ *
+ * @note This is not thread safe - but concurrent queries are fine.
+ * @sa voxelutil::raycastWithEndpoints()
+ * @ingroup Voxel
+ */
+class VolumeOccupancy {
+public:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickSize = 1 << BrickShift;
+	static constexpr int SuperBrickShift = 6;
+	static constexpr int SuperBrickSize = 1 << SuperBrickShift;
+
+private:
+	Region _region = Region::InvalidRegion;
+	glm::ivec3 _origin{0};
+	/** the amount of bricks per axis */
+	glm::ivec3 _bricks{0};
+	/** the amount of super bricks per axis */
+	glm::ivec3 _superBricks{0};
+	core::DynamicBitSet _brickBits;
+	core::DynamicBitSet _superBrickBits;
+	int _occupiedBricks = 0;
+
+	inline size_t brickIndex(const glm::ivec3 &brick) const {
+		return ((size_t)brick.z * _bricks.y + brick.y) * _bricks.x + brick.x;
+	}
+	inline size_t superBrickIndex(const glm::ivec3 &superBrick) const {
+		return ((size_t)superBrick.z * _superBricks.y + superBrick.y) * _superBricks.x + superBrick.x;
+	}
+	void setBrick(const glm::ivec3 &brick, bool occupied);
+	/**
+	 * @brief Recalculate the super brick bits from the brick bits for the given inclusive range of bricks
+	 */
+	void updateSuperBricks(const glm::ivec3 &brickMins, const glm::ivec3 &brickMaxs);
+
+public:
+	VolumeOccupancy() = default;
+	explicit VolumeOccupancy(const Region &region);
+
+	/**
+	 * @brief Set up the bricks for the given volume region - all of them are empty
+	 */
+	void init(const Region &region);
+
+	/**
+	 * @brief Scan all bricks that intersect the given region again
+	 *
+	 * The whole brick is scanned - not only the part that is covered by the region.
+	 */
+	template<class Volume>
+	void update(const Volume &volume, const Region &region);
+
+	/**
+	 * @brief Set up the bricks for the region of the given volume and scan all of them
+	 */
+	template<class Volume>
+	void build(const Volume &volume) {
+		init(volume.region());
+		update(volume, volume.region());
+	}
+
+	inline const Region &region() const {
+		return _region;
+	}
+
+	/**
+	 * @return The amount of bricks with at least one voxel that is not air
+	 */
+	inline int occupiedBricks() const {
+		return _occupiedBricks;
+	}
+
+	/**
+	 * @param pos Must be inside the region
+	 */
+	inline bool isBrickEmpty(const glm::ivec3 &pos) const {
+		return !_brickBits[brickIndex((pos - _origin) >> BrickShift)];
+	}
+
+	/**
+	 * @param pos Must be inside the region
+	 */
+	inline bool isSuperBrickEmpty(const glm::ivec3 &pos) const {
+		return !_superBrickBits[superBrickIndex((pos - _origin) >> SuperBrickShift)];
+	}
+
+	/**
+	 * @return The region of the brick the given position belongs to - this might exceed the volume region
+	 */
+	inline Region brickRegion(const glm::ivec3 &pos) const {
+		const glm::ivec3 mins = (((pos - _origin) >> BrickShift) << BrickShift) + _origin;
+		return Region(mins, mins + (BrickSize - 1));
+	}
+
+	/**
+	 * @return The region of the super brick the given position belongs to - this might exceed the volume region
+	 */
+	inline Region superBrickRegion(const glm::ivec3 &pos) const {
+		const glm::ivec3 mins = (((pos - _origin) >> SuperBrickShift) << SuperBrickShift) + _origin;
+		return Region(mins, mins + (SuperBrickSize - 1));
+	}
+};
+
+template<class Volume>
+void VolumeOccupancy::update(const Volume &volume, const Region &region) {
+	Region dirty = region;
+	if (!_region.isValid() || !dirty.cropTo(_region)) {
+		return;
+	}
+	const glm::ivec3 brickMins = (dirty.getLowerCorner() - _origin) >> BrickShift;
+	const glm::ivec3 brickMaxs = (dirty.getUpperCorner() - _origin) >> BrickShift;
+	const glm::ivec3 brickSize = brickMaxs - brickMins + 1;
+	// one byte per brick - the bricks are scanned in parallel and the bits are written afterwards
+	core::Buffer<uint8_t> occupied;
+	occupied.resize((size_t)brickSize.x * brickSize.y * brickSize.z);
+	const Region &volumeRegion = _region;
+	const glm::ivec3 origin = _origin;
+	app::for_parallel(0, brickSize.z, [&](int start, int end) {
+		typename Volume::Sampler sampler(volume);
+		for (int bz = start; bz < end; ++bz) {
+			for (int by = 0; by < brickSize.y; ++by) {
+				for (int bx = 0; bx < brickSize.x; ++bx) {
+					const glm::ivec3 brick = brickMins + glm::ivec3(bx, by, bz);
+					const glm::ivec3 mins = origin + (brick << BrickShift);
+					const glm::ivec3 maxs = glm::min(mins + (BrickSize - 1), volumeRegion.getUpperCorner());
+					bool solid = false;
+					for (int z = mins.z; z <= maxs.z && !solid; ++z) {
+						for (int y = mins.y; y <= maxs.y && !solid; ++y) {
+							sampler.setPosition(mins.x, y, z);
+							for (int x = mins.x; x <= maxs.x; ++x) {
+								if (!isAir(sampler.voxel().getMaterial())) {
+									solid = true;
+									break;
+								}
+								sampler.movePositiveX();
+							}
+						}
+					}
+					occupied[((size_t)bz * brickSize.y + by) * brickSize.x + bx] = solid ? 1 : 0;
+				}
+			}
+		}
+	});
+	size_t idx = 0;
+	for (int bz = 0; bz < brickSize.z; ++bz) {
+		for (int by = 0; by < brickSize.y; ++by) {
+			for (int bx = 0; bx < brickSize.x; ++bx) {
+				setBrick(brickMins + glm::ivec3(bx, by, bz), occupied[idx++] != 0);
+			}
+		}
+	}
+	updateSuperBricks(brickMins, brickMaxs);
+}
+
+} // namespace voxel
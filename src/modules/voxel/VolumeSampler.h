@@ -71,13 +71,19 @@ private:
 	static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
 
 public:
-	VolumeSampler(const Volume *volume) : _volume(const_cast<Volume *>(volume)), _region(volume->region()) {
+	VolumeSampler(const Volume *volume)
+		: _volume(const_cast<Volume *>(volume)), _region(volume->region()), _strideY(volume->strideY()),
+		  _strideZ(volume->strideZ()) {
 	}
-	VolumeSampler(const Volume &volume) : _volume(const_cast<Volume *>(&volume)), _region(volume.region()) {
+	VolumeSampler(const Volume &volume)
+		: _volume(const_cast<Volume *>(&volume)), _region(volume.region()), _strideY(volume.strideY()),
+		  _strideZ(volume.strideZ()) {
 	}
-	VolumeSampler(Volume *volume) : _volume(volume), _region(volume->region()) {
+	VolumeSampler(Volume *volume)
+		: _volume(volume), _region(volume->region()), _strideY(volume->strideY()), _strideZ(volume->strideZ()) {
 	}
-	VolumeSampler(Volume &volume) : _volume(&volume), _region(volume.region()) {
+	VolumeSampler(Volume &volume)
+		: _volume(&volume), _region(volume.region()), _strideY(volume.strideY()), _strideZ(volume.strideZ()) {
 	}
 	~VolumeSampler() {
 	}
@@ -109,7 +115,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 			CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 - region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel - 1 - _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 	}
@@ -117,7 +123,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1nx1ny0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel - 1 - region.getWidthInVoxels());
+			return *(_currentVoxel - 1 - _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z);
 	}
@@ -126,7 +132,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 			CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 - region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel - 1 - _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 	}
@@ -134,7 +140,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1nx0py1nz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 - region.stride());
+			return *(_currentVoxel - 1 - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z - 1);
 	}
@@ -150,7 +156,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1nx0py1pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 + region.stride());
+			return *(_currentVoxel - 1 + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z + 1);
 	}
@@ -159,7 +165,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 			CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 + region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel - 1 + _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 	}
@@ -167,7 +173,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1nx1py0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel - 1 + region.getWidthInVoxels());
+			return *(_currentVoxel - 1 + _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z);
 	}
@@ -176,7 +182,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 			CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - 1 + region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel - 1 + _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 	}
@@ -184,7 +190,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1ny1nz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel - _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 	}
@@ -192,7 +198,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1ny0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel - region.getWidthInVoxels());
+			return *(_currentVoxel - _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z);
 	}
@@ -200,7 +206,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1ny1pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel - _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 	}
@@ -208,7 +214,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px0py1nz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel - region.stride());
+			return *(_currentVoxel - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z - 1);
 	}
@@ -223,7 +229,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px0py1pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + region.stride());
+			return *(_currentVoxel + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z + 1);
 	}
@@ -231,7 +237,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1py1nz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel + _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 	}
@@ -239,7 +245,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1py0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel + region.getWidthInVoxels());
+			return *(_currentVoxel + _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z);
 	}
@@ -247,7 +253,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel0px1py1pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel + _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 	}
@@ -256,7 +262,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 			CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 - region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel + 1 - _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 	}
@@ -264,7 +270,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1px1ny0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel + 1 - region.getWidthInVoxels());
+			return *(_currentVoxel + 1 - _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z);
 	}
@@ -273,7 +279,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 			CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 - region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel + 1 - _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 	}
@@ -281,7 +287,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1px0py1nz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 - region.stride());
+			return *(_currentVoxel + 1 - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z - 1);
 	}
@@ -297,7 +303,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1px0py1pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 + region.stride());
+			return *(_currentVoxel + 1 + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z + 1);
 	}
@@ -306,7 +312,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 			CAN_GO_NEG_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 + region.getWidthInVoxels() - region.stride());
+			return *(_currentVoxel + 1 + _strideY - _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 	}
@@ -314,7 +320,7 @@ public:
 	CORE_NO_SANITIZE_ADDRESS inline const Voxel &peekVoxel1px1py0pz() const {
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-			return *(_currentVoxel + 1 + region.getWidthInVoxels());
+			return *(_currentVoxel + 1 + _strideY);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z);
 	}
@@ -323,7 +329,7 @@ public:
 		const Region &region = this->region();
 		if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 			CAN_GO_POS_Z(this->_posInVolume.z)) {
-			return *(_currentVoxel + 1 + region.getWidthInVoxels() + region.stride());
+			return *(_currentVoxel + 1 + _strideY + _strideZ);
 		}
 		return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 	}
@@ -349,7 +355,7 @@ public:
 		if (currentPositionValid()) {
 			const glm::aligned_ivec4 localPos = _posInVolume - region.getLowerCorner4();
 			const int64_t uVoxelIndex =
-				(int64_t)localPos.x + (int64_t)localPos.y * _volume->width() + (int64_t)localPos.z * region.stride();
+				(int64_t)localPos.x + (int64_t)localPos.y * _strideY + (int64_t)localPos.z * _strideZ;
 
 			_currentVoxel = _volume->voxels() + uVoxelIndex;
 			return true;
@@ -410,7 +416,7 @@ public:
 		if (core_unlikely(!bIsOldPositionValid)) {
 			setPosition(_posInVolume);
 		} else if (core_likely(currentPositionValid())) {
-			_currentVoxel += (int64_t)_volume->width() * offset;
+			_currentVoxel += _strideY * offset;
 		} else {
 			_currentVoxel = nullptr;
 		}
@@ -431,7 +437,7 @@ public:
 		if (core_unlikely(!bIsOldPositionValid)) {
 			setPosition(_posInVolume);
 		} else if (core_likely(currentPositionValid())) {
-			_currentVoxel += region().stride() * offset;
+			_currentVoxel += _strideZ * offset;
 		} else {
 			_currentVoxel = nullptr;
 		}
@@ -489,7 +495,7 @@ public:
 		if (core_unlikely(!bIsOldPositionValid)) {
 			setPosition(_posInVolume);
 		} else if (core_likely(currentPositionValid())) {
-			_currentVoxel -= (int64_t)_volume->width() * offset;
+			_currentVoxel -= _strideY * offset;
 		} else {
 			_currentVoxel = nullptr;
 		}
@@ -510,7 +516,7 @@ public:
 		if (core_unlikely(!bIsOldPositionValid)) {
 			setPosition(_posInVolume);
 		} else if (core_likely(currentPositionValid())) {
-			_currentVoxel -= region().stride() * offset;
+			_currentVoxel -= _strideZ * offset;
 		} else {
 			_currentVoxel = nullptr;
 		}
@@ -520,6 +526,9 @@ protected:
 	Volume *_volume;
 
 	voxel::Region _region;
+	/** The distance between two voxels on the y and z axis in the voxel array of the volume */
+	int64_t _strideY;
+	int64_t _strideZ;
 
 	// The current position in the volume
 	glm::aligned_ivec4 _posInVolume{0, 0, 0, 0};
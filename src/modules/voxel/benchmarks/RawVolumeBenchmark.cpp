@@ -4,6 +4,7 @@
 
 #include "app/benchmark/AbstractBenchmark.h"
 #include "core/collection/Vector.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/VolumeSamplerUtil.h"
 
@@ -97,6 +98,76 @@ BENCHMARK_DEFINE_F(RawVolumeBenchmark, HasFlagsSubRegion)(benchmark::State &stat
 	}
 }
 
+// sum up the face neighbours of each voxel - the y and z neighbours are far apart in the linear layout
+template<class Volume>
+static uint32_t neighbourSum(const Volume &volume) {
+	const voxel::Region &region = volume.region();
+	typename Volume::Sampler sampler(volume);
+	sampler.setPosition(region.getLowerCorner());
+	uint32_t sum = 0;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		typename Volume::Sampler sampler2 = sampler;
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			typename Volume::Sampler sampler3 = sampler2;
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				sum += sampler3.peekVoxel1nx0py0pz().getColor() + sampler3.peekVoxel1px0py0pz().getColor() +
+					   sampler3.peekVoxel0px1ny0pz().getColor() + sampler3.peekVoxel0px1py0pz().getColor() +
+					   sampler3.peekVoxel0px0py1nz().getColor() + sampler3.peekVoxel0px0py1pz().getColor();
+				sampler3.movePositiveX();
+			}
+			sampler2.movePositiveY();
+		}
+		sampler.movePositiveZ();
+	}
+	return sum;
+}
+
+static void fillLarge(voxel::RawVolume &volume) {
+	const voxel::Region &region = volume.region();
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (uint8_t)((x ^ y ^ z) & 0xFF)));
+			}
+		}
+	}
+}
+
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, NeighbourSumLinear)(benchmark::State &state) {
+	voxel::RawVolume in(voxel::Region{0, 127});
+	fillLarge(in);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(neighbourSum(in));
+	}
+}
+
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, NeighbourSumBricked)(benchmark::State &state) {
+	voxel::RawVolume in(voxel::Region{0, 127});
+	fillLarge(in);
+	const voxel::BrickedVolume bricked(in);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(neighbourSum(bricked));
+	}
+}
+
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, ConvertToBricked)(benchmark::State &state) {
+	voxel::RawVolume in(voxel::Region{0, 127});
+	fillLarge(in);
+	voxel::BrickedVolume bricked(in.region());
+	for (auto _ : state) {
+		bricked.copyFrom(in);
+	}
+}
+
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, ConvertFromBricked)(benchmark::State &state) {
+	voxel::RawVolume in(voxel::Region{0, 127});
+	fillLarge(in);
+	const voxel::BrickedVolume bricked(in);
+	for (auto _ : state) {
+		bricked.copyTo(in);
+	}
+}
+
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, SetVoxel);
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, SetVoxelSampler);
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, IsEmpty);
@@ -106,3 +177,7 @@ BENCHMARK_REGISTER_F(RawVolumeBenchmark, RegionForFlag);
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, HasFlagsSubRegion);
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, HasFlagsNoFlags);
 BENCHMARK_REGISTER_F(RawVolumeBenchmark, HasFlagsWithFlags);
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, NeighbourSumLinear);
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, NeighbourSumBricked);
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, ConvertToBricked);
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, ConvertFromBricked);
@@ -3,6 +3,7 @@
  */
 
 #include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/VolumeSamplerUtil.h"
 #include "voxel/VoxelSampling.h"
@@ -11,6 +12,7 @@ class VolumeSamplerBenchmark : public app::AbstractBenchmark {
 protected:
 	static constexpr int Size = 31;
 	voxel::RawVolume v{voxel::Region{0, 0, 0, Size, Size, Size}};
+	voxel::BrickedVolume b{voxel::Region{0, 0, 0, Size, Size, Size}};
 
 	void SetUp(benchmark::State &state) override {
 		app::AbstractBenchmark::SetUp(state);
@@ -22,6 +24,7 @@ protected:
 				}
 			}
 		}
+		b.copyFrom(v);
 	}
 };
 
@@ -49,6 +52,72 @@ BENCHMARK_DEFINE_F(VolumeSamplerBenchmark, SampleCubic)(benchmark::State &state)
 	}
 }
 
+BENCHMARK_DEFINE_F(VolumeSamplerBenchmark, SampleLinearBricked)(benchmark::State &state) {
+	voxel::BrickedVolume::Sampler sampler(&b);
+	const glm::vec3 pos(15.3f, 15.7f, 15.1f);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(voxel::sampleVoxel(sampler, voxel::VoxelSampling::Linear, pos));
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeSamplerBenchmark, SampleCubicBricked)(benchmark::State &state) {
+	voxel::BrickedVolume::Sampler sampler(&b);
+	const glm::vec3 pos(15.3f, 15.7f, 15.1f);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(voxel::sampleVoxel(sampler, voxel::VoxelSampling::Cubic, pos));
+	}
+}
+
+// all 26 neighbours of each voxel - this is the access pattern of the cubic surface extractor with ambient occlusion
+template<class Volume>
+static uint32_t peekAll(const Volume &volume) {
+	const voxel::Region &region = volume.region();
+	typename Volume::Sampler sampler(volume);
+	sampler.setPosition(region.getLowerCorner());
+	uint32_t sum = 0;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		typename Volume::Sampler sampler2 = sampler;
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			typename Volume::Sampler sampler3 = sampler2;
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				sum += sampler3.peekVoxel1nx1ny1nz().getColor() + sampler3.peekVoxel1nx1ny0pz().getColor() +
+					   sampler3.peekVoxel1nx1ny1pz().getColor() + sampler3.peekVoxel1nx0py1nz().getColor() +
+					   sampler3.peekVoxel1nx0py0pz().getColor() + sampler3.peekVoxel1nx0py1pz().getColor() +
+					   sampler3.peekVoxel1nx1py1nz().getColor() + sampler3.peekVoxel1nx1py0pz().getColor() +
+					   sampler3.peekVoxel1nx1py1pz().getColor() + sampler3.peekVoxel0px1ny1nz().getColor() +
+					   sampler3.peekVoxel0px1ny0pz().getColor() + sampler3.peekVoxel0px1ny1pz().getColor() +
+					   sampler3.peekVoxel0px0py1nz().getColor() + sampler3.peekVoxel0px0py1pz().getColor() +
+					   sampler3.peekVoxel0px1py1nz().getColor() + sampler3.peekVoxel0px1py0pz().getColor() +
+					   sampler3.peekVoxel0px1py1pz().getColor() + sampler3.peekVoxel1px1ny1nz().getColor() +
+					   sampler3.peekVoxel1px1ny0pz().getColor() + sampler3.peekVoxel1px1ny1pz().getColor() +
+					   sampler3.peekVoxel1px0py1nz().getColor() + sampler3.peekVoxel1px0py0pz().getColor() +
+					   sampler3.peekVoxel1px0py1pz().getColor() + sampler3.peekVoxel1px1py1nz().getColor() +
+					   sampler3.peekVoxel1px1py0pz().getColor() + sampler3.peekVoxel1px1py1pz().getColor();
+				sampler3.movePositiveX();
+			}
+			sampler2.movePositiveY();
+		}
+		sampler.movePositiveZ();
+	}
+	return sum;
+}
+
+BENCHMARK_DEFINE_F(VolumeSamplerBenchmark, PeekAll)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(peekAll(v));
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeSamplerBenchmark, PeekAllBricked)(benchmark::State &state) {
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(peekAll(b));
+	}
+}
+
 BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, SampleNearest);
 BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, SampleLinear);
 BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, SampleCubic);
+BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, SampleLinearBricked);
+BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, SampleCubicBricked);
+BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, PeekAll);
+BENCHMARK_REGISTER_F(VolumeSamplerBenchmark, PeekAllBricked);
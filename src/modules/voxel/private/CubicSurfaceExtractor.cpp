@@ -7,6 +7,7 @@
 #include "core/Common.h"
 #include "core/concurrent/Atomic.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxel/VoxelVertex.h"
@@ -402,8 +403,9 @@ static IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t
 	return 0; //Should never happen.
 }
 
-void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
-					  const glm::ivec3 &translate, bool ambientOcclusion, bool mergeQuads, bool reuseVertices) {
+template<class Volume>
+static void extractCubicMeshImpl(const Volume *volData, const Region &region, ChunkMesh *result,
+								 const glm::ivec3 &translate, bool ambientOcclusion, bool mergeQuads, bool reuseVertices) {
 	core_trace_scoped(ExtractCubicMesh);
 
 	const glm::ivec3& offset = region.getLowerCorner();
@@ -442,7 +444,7 @@ void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, Chu
 	vecQuadsT[core::enumVal(FaceNames::NegativeZ)].resize(zSize);
 	vecQuadsT[core::enumVal(FaceNames::PositiveZ)].resize(zSize);
 
-	voxel::RawVolume::Sampler volumeSampler(volData);
+	typename Volume::Sampler volumeSampler(volData);
 
 	{
 	core_trace_scoped(QuadGeneration);
@@ -459,9 +461,9 @@ void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, Chu
 	const uint32_t d = upper.z - offset.z;
 
 	for (uint32_t regZ = 0; regZ <= d; ++regZ) {
-		voxel::RawVolume::Sampler volumeSampler2 = volumeSampler;
+		typename Volume::Sampler volumeSampler2 = volumeSampler;
 		for (uint32_t regY = 0; regY <= h; ++regY) {
-			voxel::RawVolume::Sampler volumeSampler3 = volumeSampler2;
+			typename Volume::Sampler volumeSampler3 = volumeSampler2;
 			for (uint32_t regX = 0; regX <= w; ++regX) {
 
 				/**
@@ -748,4 +750,15 @@ void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, Chu
 		}
 	}
 }
+
+void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+					  const glm::ivec3 &translate, bool ambientOcclusion, bool mergeQuads, bool reuseVertices) {
+	extractCubicMeshImpl(volData, region, result, translate, ambientOcclusion, mergeQuads, reuseVertices);
+}
+
+void extractCubicMesh(const voxel::BrickedVolume *volData, const Region &region, ChunkMesh *result,
+					  const glm::ivec3 &translate, bool ambientOcclusion, bool mergeQuads, bool reuseVertices) {
+	extractCubicMeshImpl(volData, region, result, translate, ambientOcclusion, mergeQuads, reuseVertices);
+}
+
 }
@@ -8,6 +8,7 @@
 
 namespace voxel {
 
+class BrickedVolume;
 class RawVolume;
 class Region;
 struct ChunkMesh;
@@ -98,5 +99,12 @@ struct ChunkMesh;
 void extractCubicMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
 					  const glm::ivec3 &translate, bool ambientOcclusion = true, bool mergeQuads = true,
 					  bool reuseVertices = true);
+/**
+ * @brief Same as above but samples the bricked storage layout
+ * @sa BrickedVolume
+ */
+void extractCubicMesh(const voxel::BrickedVolume *volData, const Region &region, ChunkMesh *result,
+					  const glm::ivec3 &translate, bool ambientOcclusion = true, bool mergeQuads = true,
+					  bool reuseVertices = true);
 
 } // namespace voxel
@@ -205,8 +205,8 @@ static void collectFacePair(SurfaceExtractionContext &ctx, core::Buffer<PendingQ
 	// Direct volume access with precomputed strides
 	const Voxel *volData = volume->voxels();
 	const Region &volRegion = volume->region();
-	const int64_t volW = volume->width();
-	const int64_t volStride = volRegion.stride();
+	const int64_t volW = volume->strideY();
+	const int64_t volStride = volume->strideZ();
 
 	const int64_t dimStrides[3] = {1, volW, volStride};
 	const int64_t uVolStride = dimStrides[axes.x];
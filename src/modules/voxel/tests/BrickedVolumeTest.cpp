@@ -0,0 +1,227 @@
+/**
+ * @file
+ */
+
+#include "voxel/BrickedVolume.h"
+#include "app/tests/AbstractTest.h"
+#include "core/ScopedPtr.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/Morton.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class BrickedVolumeTest : public app::AbstractTest {
+protected:
+	// not aligned to the bricks and with negative coordinates to cover the padding and the local offsets
+	const Region _region{-5, -3, 2, 13, 9, 20};
+
+	static Voxel voxelFor(int x, int y, int z) {
+		if ((x * 7 + y * 3 + z * 5) % 4 == 0) {
+			return Voxel();
+		}
+		return createVoxel(VoxelType::Generic, (uint8_t)((x * 31 + y * 17 + z * 13) & 0xFF));
+	}
+
+	void fill(RawVolume &volume) {
+		const Region &region = volume.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					volume.setVoxel(x, y, z, voxelFor(x, y, z));
+				}
+			}
+		}
+	}
+};
+
+TEST_F(BrickedVolumeTest, testBrickOffsetIsMorton) {
+	for (int z = 0; z < BrickedVolume::BrickSide; ++z) {
+		for (int y = 0; y < BrickedVolume::BrickSide; ++y) {
+			for (int x = 0; x < BrickedVolume::BrickSide; ++x) {
+				EXPECT_EQ(mortonIndex(x, y, z), BrickedVolume::brickOffset(x, y, z));
+			}
+		}
+	}
+}
+
+TEST_F(BrickedVolumeTest, testSetVoxel) {
+	BrickedVolume volume(_region);
+	EXPECT_EQ(glm::ivec3(3, 2, 3), volume.bricks());
+	EXPECT_TRUE(volume.isEmpty(_region));
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	EXPECT_TRUE(volume.setVoxel(-5, -3, 2, voxel));
+	EXPECT_FALSE(volume.setVoxel(-5, -3, 2, voxel));
+	EXPECT_TRUE(volume.setVoxel(13, 9, 20, voxel));
+	EXPECT_FALSE(volume.setVoxel(14, 9, 20, voxel));
+	EXPECT_EQ(voxel, volume.voxel(-5, -3, 2));
+	EXPECT_EQ(voxel, volume.voxel(13, 9, 20));
+	EXPECT_TRUE(isAir(volume.voxel(12, 9, 20).getMaterial()));
+	EXPECT_FALSE(volume.isEmpty(_region));
+	EXPECT_TRUE(volume.isEmpty(Region(0, 0, 2, 12, 9, 20)));
+
+	const Voxel border = createVoxel(VoxelType::Generic, 2);
+	volume.setBorderValue(border);
+	EXPECT_EQ(border, volume.voxel(14, 9, 20));
+	EXPECT_EQ(border, volume.voxel(-6, -3, 2));
+}
+
+TEST_F(BrickedVolumeTest, testConvert) {
+	RawVolume raw(_region);
+	fill(raw);
+	BrickedVolume bricked(raw);
+	for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+		for (int y = _region.getLowerY(); y <= _region.getUpperY(); ++y) {
+			for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+				ASSERT_EQ(raw.voxel(x, y, z), bricked.voxel(x, y, z)) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	core::ScopedPtr<RawVolume> back(bricked.toRawVolume());
+	EXPECT_EQ(_region, back->region());
+	EXPECT_EQ(0, memcmp(raw.data(), back->data(), RawVolume::size(_region)));
+}
+
+TEST_F(BrickedVolumeTest, testCopyRegion) {
+	RawVolume raw(_region);
+	fill(raw);
+	BrickedVolume bricked(_region);
+	const Region copyRegion(-1, 0, 6, 10, 20, 9);
+	bricked.copyFrom(raw, copyRegion);
+	for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+		for (int y = _region.getLowerY(); y <= _region.getUpperY(); ++y) {
+			for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+				if (copyRegion.containsPoint(x, y, z)) {
+					ASSERT_EQ(raw.voxel(x, y, z), bricked.voxel(x, y, z)) << x << ":" << y << ":" << z;
+				} else {
+					ASSERT_TRUE(isAir(bricked.voxel(x, y, z).getMaterial())) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+
+	// the target is smaller and shifted - only the intersection is written
+	RawVolume target(Region(5, 5, 5, 30, 30, 30));
+	bricked.copyTo(target);
+	EXPECT_EQ(raw.voxel(5, 5, 6), target.voxel(5, 5, 6));
+	EXPECT_EQ(raw.voxel(10, 9, 9), target.voxel(10, 9, 9));
+	EXPECT_TRUE(isAir(target.voxel(5, 5, 5).getMaterial()));
+	EXPECT_TRUE(isAir(target.voxel(11, 9, 9).getMaterial()));
+}
+
+TEST_F(BrickedVolumeTest, testSamplerPeeks) {
+	RawVolume raw(_region);
+	fill(raw);
+	raw.setBorderValue(createVoxel(VoxelType::Generic, 3));
+	BrickedVolume bricked(raw);
+
+	Region sampleRegion = _region;
+	sampleRegion.grow(1);
+	RawVolume::Sampler rawSampler(raw);
+	BrickedVolume::Sampler brickedSampler(bricked);
+	rawSampler.setPosition(sampleRegion.getLowerCorner());
+	brickedSampler.setPosition(sampleRegion.getLowerCorner());
+	for (int z = sampleRegion.getLowerZ(); z <= sampleRegion.getUpperZ(); ++z) {
+		RawVolume::Sampler rawSampler2 = rawSampler;
+		BrickedVolume::Sampler brickedSampler2 = brickedSampler;
+		for (int y = sampleRegion.getLowerY(); y <= sampleRegion.getUpperY(); ++y) {
+			RawVolume::Sampler rawSampler3 = rawSampler2;
+			BrickedVolume::Sampler brickedSampler3 = brickedSampler2;
+			for (int x = sampleRegion.getLowerX(); x <= sampleRegion.getUpperX(); ++x) {
+				ASSERT_EQ(glm::ivec3(x, y, z), brickedSampler3.position());
+				ASSERT_EQ(rawSampler3.currentPositionValid(), brickedSampler3.currentPositionValid());
+				ASSERT_EQ(rawSampler3.voxel(), brickedSampler3.voxel());
+#define CHECK_PEEK(name) ASSERT_EQ(rawSampler3.name(), brickedSampler3.name()) << #name << " " << x << ":" << y << ":" << z
+				CHECK_PEEK(peekVoxel1nx1ny1nz);
+				CHECK_PEEK(peekVoxel1nx1ny0pz);
+				CHECK_PEEK(peekVoxel1nx1ny1pz);
+				CHECK_PEEK(peekVoxel1nx0py1nz);
+				CHECK_PEEK(peekVoxel1nx0py0pz);
+				CHECK_PEEK(peekVoxel1nx0py1pz);
+				CHECK_PEEK(peekVoxel1nx1py1nz);
+				CHECK_PEEK(peekVoxel1nx1py0pz);
+				CHECK_PEEK(peekVoxel1nx1py1pz);
+				CHECK_PEEK(peekVoxel0px1ny1nz);
+				CHECK_PEEK(peekVoxel0px1ny0pz);
+				CHECK_PEEK(peekVoxel0px1ny1pz);
+				CHECK_PEEK(peekVoxel0px0py1nz);
+				CHECK_PEEK(peekVoxel0px0py0pz);
+				CHECK_PEEK(peekVoxel0px0py1pz);
+				CHECK_PEEK(peekVoxel0px1py1nz);
+				CHECK_PEEK(peekVoxel0px1py0pz);
+				CHECK_PEEK(peekVoxel0px1py1pz);
+				CHECK_PEEK(peekVoxel1px1ny1nz);
+				CHECK_PEEK(peekVoxel1px1ny0pz);
+				CHECK_PEEK(peekVoxel1px1ny1pz);
+				CHECK_PEEK(peekVoxel1px0py1nz);
+				CHECK_PEEK(peekVoxel1px0py0pz);
+				CHECK_PEEK(peekVoxel1px0py1pz);
+				CHECK_PEEK(peekVoxel1px1py1nz);
+				CHECK_PEEK(peekVoxel1px1py0pz);
+				CHECK_PEEK(peekVoxel1px1py1pz);
+#undef CHECK_PEEK
+				rawSampler3.movePositiveX();
+				brickedSampler3.movePositiveX();
+			}
+			rawSampler2.movePositiveY();
+			brickedSampler2.movePositiveY();
+		}
+		rawSampler.movePositiveZ();
+		brickedSampler.movePositiveZ();
+	}
+}
+
+TEST_F(BrickedVolumeTest, testSamplerMoveNegative) {
+	RawVolume raw(_region);
+	fill(raw);
+	BrickedVolume bricked(raw);
+	BrickedVolume::Sampler sampler(bricked);
+	sampler.setPosition(_region.getUpperCorner());
+	for (int z = _region.getUpperZ(); z >= _region.getLowerZ(); --z) {
+		ASSERT_TRUE(sampler.currentPositionValid());
+		ASSERT_EQ(raw.voxel(_region.getUpperX(), _region.getUpperY(), z), sampler.voxel());
+		sampler.moveNegativeZ();
+	}
+	EXPECT_FALSE(sampler.currentPositionValid());
+	sampler.movePositiveZ(3);
+	EXPECT_TRUE(sampler.currentPositionValid());
+	EXPECT_EQ(raw.voxel(_region.getUpperX(), _region.getUpperY(), _region.getLowerZ() + 2), sampler.voxel());
+	EXPECT_TRUE(sampler.setVoxel(createVoxel(VoxelType::Generic, 99)));
+	EXPECT_EQ(createVoxel(VoxelType::Generic, 99),
+			  bricked.voxel(_region.getUpperX(), _region.getUpperY(), _region.getLowerZ() + 2));
+}
+
+TEST_F(BrickedVolumeTest, testCubicExtraction) {
+	RawVolume raw(_region);
+	fill(raw);
+	BrickedVolume bricked(raw);
+	Region region = _region;
+	region.shiftUpperCorner(1, 1, 1);
+
+	ChunkMesh rawMesh;
+	SurfaceExtractionContext rawCtx = buildCubicContext(&raw, region, rawMesh);
+	extractSurface(rawCtx);
+
+	ChunkMesh brickedMesh;
+	SurfaceExtractionContext brickedCtx = buildCubicContext(&bricked, region, brickedMesh);
+	extractSurface(brickedCtx);
+
+	for (int i = 0; i < 2; ++i) {
+		const Mesh &a = rawMesh.mesh[i];
+		const Mesh &b = brickedMesh.mesh[i];
+		ASSERT_EQ(a.getNoOfVertices(), b.getNoOfVertices());
+		ASSERT_EQ(a.getNoOfIndices(), b.getNoOfIndices());
+		for (size_t v = 0; v < a.getNoOfVertices(); ++v) {
+			const VoxelVertex &va = a.getVertexVector()[v];
+			const VoxelVertex &vb = b.getVertexVector()[v];
+			ASSERT_EQ(va.position, vb.position);
+			ASSERT_EQ(va.colorIndex, vb.colorIndex);
+			ASSERT_EQ(va.ambientOcclusion, vb.ambientOcclusion);
+		}
+	}
+	EXPECT_GT(rawMesh.mesh[0].getNoOfVertices(), 0u);
+}
+
+} // namespace voxel
@@ -0,0 +1,87 @@
+/**
+ * @file
+ */
+
+#include "voxel/DirtyChunks.h"
+#include "app/tests/AbstractTest.h"
+
+namespace voxel {
+
+class DirtyChunksTest : public app::AbstractTest {};
+
+TEST_F(DirtyChunksTest, testEmpty) {
+	DirtyChunks dirty(Region(0, 63));
+	EXPECT_TRUE(dirty.empty());
+	EXPECT_EQ(0, dirty.chunks());
+	EXPECT_TRUE(dirty.regions().empty());
+}
+
+TEST_F(DirtyChunksTest, testSingleChunk) {
+	DirtyChunks dirty(Region(-10, 63));
+	dirty.add(glm::ivec3(-5, 0, 3));
+	dirty.add(glm::ivec3(0, 1, 4));
+	EXPECT_EQ(1, dirty.chunks());
+	EXPECT_TRUE(dirty.isDirty(glm::ivec3(-10)));
+	EXPECT_FALSE(dirty.isDirty(glm::ivec3(22)));
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(1u, regions.size());
+	EXPECT_EQ(Region(-5, 0, 3, 0, 1, 4), regions[0]);
+}
+
+TEST_F(DirtyChunksTest, testOppositeCorners) {
+	DirtyChunks dirty(Region(0, 255));
+	dirty.add(glm::ivec3(0));
+	dirty.add(glm::ivec3(255));
+	EXPECT_EQ(Region(0, 255), dirty.region());
+	EXPECT_EQ(2, dirty.chunks());
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(2u, regions.size());
+	EXPECT_EQ(Region(0, 31), regions[0]);
+	EXPECT_EQ(Region(224, 255), regions[1]);
+}
+
+TEST_F(DirtyChunksTest, testCoalesce) {
+	DirtyChunks dirty(Region(0, 127));
+	// a 2x2x2 block of chunks and a single chunk that isn't connected
+	dirty.add(Region(0, 0, 0, 63, 63, 63));
+	dirty.add(glm::ivec3(100, 0, 0));
+	EXPECT_EQ(9, dirty.chunks());
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(2u, regions.size());
+	EXPECT_EQ(Region(0, 0, 0, 63, 63, 63), regions[0]);
+	// the boxes are cropped to the bounding box of all modifications
+	EXPECT_EQ(Region(96, 0, 0, 100, 31, 31), regions[1]);
+}
+
+TEST_F(DirtyChunksTest, testMaxRegions) {
+	DirtyChunks dirty(Region(0, 255));
+	for (int i = 0; i < 8; ++i) {
+		dirty.add(glm::ivec3(i * 32, 0, i * 32));
+	}
+	EXPECT_EQ(8u, dirty.regions().size());
+	const core::DynamicArray<Region> &regions = dirty.regions(4);
+	ASSERT_EQ(1u, regions.size());
+	EXPECT_EQ(dirty.region(), regions[0]);
+}
+
+TEST_F(DirtyChunksTest, testOutsideGrid) {
+	DirtyChunks dirty(Region(0, 63));
+	dirty.add(glm::ivec3(0));
+	dirty.add(glm::ivec3(100));
+	EXPECT_TRUE(dirty.isDirty(glm::ivec3(50)));
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(1u, regions.size());
+	EXPECT_EQ(Region(0, 100), regions[0]);
+}
+
+TEST_F(DirtyChunksTest, testReset) {
+	DirtyChunks dirty(Region(0, 63));
+	dirty.add(Region(0, 63));
+	EXPECT_EQ(8, dirty.chunks());
+	dirty.reset();
+	EXPECT_TRUE(dirty.empty());
+	EXPECT_EQ(0, dirty.chunks());
+	EXPECT_FALSE(dirty.isDirty(glm::ivec3(0)));
+}
+
+} // namespace voxel
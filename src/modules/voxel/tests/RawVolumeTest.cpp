@@ -472,4 +472,92 @@ TEST_F(RawVolumeTest, testRegionForFlagMultipleVoxels) {
 	EXPECT_EQ(result.getUpperCorner(), glm::ivec3(7, 8, 6));
 }
 
+TEST_F(RawVolumeTest, testResizeGrow) {
+	RawVolume v(Region(0, 9));
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	v.setVoxel(0, 0, 0, voxel);
+	v.setVoxel(9, 9, 9, voxel);
+	ASSERT_TRUE(v.contiguous());
+
+	ASSERT_TRUE(v.resize(Region(glm::ivec3(-2, 0, 0), glm::ivec3(12, 9, 9))));
+	EXPECT_EQ(Region(glm::ivec3(-2, 0, 0), glm::ivec3(12, 9, 9)), v.region());
+	EXPECT_FALSE(v.contiguous());
+	EXPECT_EQ(voxel, v.voxel(0, 0, 0));
+	EXPECT_EQ(voxel, v.voxel(9, 9, 9));
+	EXPECT_EQ(2, countVoxels(v));
+	EXPECT_FALSE(v.isEmpty(Region(0, 0)));
+	EXPECT_TRUE(v.isEmpty(Region(glm::ivec3(10, 0, 0), glm::ivec3(12, 9, 9))));
+
+	// the headroom of the last resize is used - the voxel array is not reallocated
+	const Voxel *voxels = v.voxels();
+	const glm::ivec3 capacity = v.capacity();
+	ASSERT_TRUE(v.resize(Region(glm::ivec3(-2, 0, 0), glm::ivec3(14, 9, 9))));
+	EXPECT_EQ(capacity, v.capacity());
+	EXPECT_EQ(voxels, v.voxels());
+	EXPECT_EQ(voxel, v.voxel(9, 9, 9));
+	EXPECT_TRUE(v.setVoxel(14, 9, 9, voxel));
+	EXPECT_EQ(3, countVoxels(v));
+}
+
+TEST_F(RawVolumeTest, testResizeShrink) {
+	RawVolume v(Region(0, 9));
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	v.setVoxel(2, 2, 2, voxel);
+	v.setVoxel(8, 8, 8, voxel);
+	ASSERT_TRUE(v.resize(Region(0, 15)));
+	ASSERT_TRUE(v.resize(Region(0, 5)));
+	EXPECT_EQ(voxel, v.voxel(2, 2, 2));
+	EXPECT_EQ(1, countVoxels(v));
+	// the voxels that were cropped are air if the volume grows again
+	ASSERT_TRUE(v.resize(Region(0, 9)));
+	EXPECT_TRUE(isAir(v.voxel(8, 8, 8).getMaterial()));
+	EXPECT_EQ(1, countVoxels(v));
+}
+
+TEST_F(RawVolumeTest, testResizeReleasesMemory) {
+	RawVolume v(Region(0, 31));
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	v.setVoxel(1, 1, 1, voxel);
+	ASSERT_TRUE(v.resize(Region(0, 3)));
+	EXPECT_TRUE(v.contiguous());
+	EXPECT_EQ(glm::ivec3(4), v.capacity());
+	EXPECT_EQ(voxel, v.voxel(1, 1, 1));
+}
+
+TEST_F(RawVolumeTest, testGrownVolumeOperations) {
+	RawVolume v(Region(0, 9));
+	ASSERT_TRUE(v.resize(Region(glm::ivec3(0), glm::ivec3(12, 11, 10))));
+	ASSERT_FALSE(v.contiguous());
+	Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	voxel.setOutline();
+	v.setVoxel(2, 3, 4, voxel);
+	v.setVoxel(12, 11, 10, voxel);
+	const Region flagRegion = v.regionForFlag(FlagOutline);
+	EXPECT_EQ(glm::ivec3(2, 3, 4), flagRegion.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(12, 11, 10), flagRegion.getUpperCorner());
+	v.removeFlags(v.region(), FlagOutline);
+	EXPECT_FALSE(v.hasFlags(v.region(), FlagOutline));
+
+	// the copy is compacted
+	RawVolume copy(v);
+	EXPECT_TRUE(copy.contiguous());
+	EXPECT_EQ(v.voxel(12, 11, 10), copy.voxel(12, 11, 10));
+	EXPECT_EQ(2, countVoxels(copy));
+
+	RawVolume::Sampler sampler(v);
+	sampler.setPosition(12, 11, 9);
+	EXPECT_EQ(v.voxel(12, 11, 10), sampler.peekVoxel0px0py1pz());
+	sampler.moveNegativeY();
+	EXPECT_EQ(v.voxel(12, 11, 10), sampler.peekVoxel0px1py1pz());
+
+	v.fill(createVoxel(VoxelType::Generic, 2));
+	EXPECT_EQ(v.region().voxels(), countVoxels(v));
+	// the voxels outside of the region stay air
+	ASSERT_TRUE(v.resize(Region(glm::ivec3(0), glm::ivec3(13, 11, 10))));
+	EXPECT_TRUE(v.isEmpty(Region(glm::ivec3(13, 0, 0), glm::ivec3(13, 11, 10))));
+
+	v.translate(glm::ivec3(5));
+	EXPECT_EQ(createVoxel(VoxelType::Generic, 2), v.voxel(5, 5, 5));
+}
+
 }
@@ -63,4 +63,19 @@ TEST_F(RawVolumeWrapperTest, testSampler) {
 
 }
 
+TEST_F(RawVolumeWrapperTest, testDirtyRegions) {
+	Region region(0, 127);
+	RawVolume v(region);
+	RawVolumeWrapper w(&v);
+	EXPECT_TRUE(w.dirtyRegions().empty());
+	EXPECT_TRUE(w.setVoxel(1, 2, 3, voxel::createVoxel(VoxelType::Generic, 0)));
+	EXPECT_TRUE(w.setVoxel(126, 125, 124, voxel::createVoxel(VoxelType::Generic, 0)));
+	EXPECT_EQ(w.dirtyRegion(), voxel::Region(1, 2, 3, 126, 125, 124));
+	EXPECT_EQ(2, w.dirtyChunks().chunks());
+	const core::DynamicArray<Region> &regions = w.dirtyRegions();
+	ASSERT_EQ(2u, regions.size());
+	EXPECT_EQ(voxel::Region(1, 2, 3, 31, 31, 31), regions[0]);
+	EXPECT_EQ(voxel::Region(96, 96, 96, 126, 125, 124), regions[1]);
+}
+
 }
@@ -0,0 +1,177 @@
+/**
+ * @file
+ */
+
+#include "voxel/SelectionMask.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class SelectionMaskTest : public app::AbstractTest {};
+
+TEST_F(SelectionMaskTest, testSetUnset) {
+	SelectionMask mask;
+	EXPECT_TRUE(mask.empty());
+	EXPECT_FALSE(mask.region().isValid());
+	EXPECT_TRUE(mask.set(1, 2, 3));
+	EXPECT_FALSE(mask.set(1, 2, 3));
+	EXPECT_TRUE(mask.set(-9, -1, 7));
+	EXPECT_TRUE(mask.test(1, 2, 3));
+	EXPECT_TRUE(mask.test(-9, -1, 7));
+	EXPECT_FALSE(mask.test(2, 2, 3));
+	EXPECT_EQ(2, mask.count());
+	EXPECT_EQ(2u, mask.bricks());
+	EXPECT_EQ(Region(-9, -1, 3, 1, 2, 7), mask.region());
+
+	EXPECT_TRUE(mask.unset(-9, -1, 7));
+	EXPECT_FALSE(mask.unset(-9, -1, 7));
+	EXPECT_EQ(1, mask.count());
+	EXPECT_EQ(1u, mask.bricks());
+	EXPECT_EQ(Region(1, 2, 3, 1, 2, 3), mask.region());
+
+	mask.clear();
+	EXPECT_TRUE(mask.empty());
+	EXPECT_EQ(0u, mask.bricks());
+}
+
+TEST_F(SelectionMaskTest, testRegion) {
+	SelectionMask mask;
+	const Region region(-3, 2, 5, 12, 9, 20);
+	mask.set(region);
+	EXPECT_EQ(region.voxels(), mask.count());
+	EXPECT_EQ(region, mask.region());
+	EXPECT_TRUE(mask.test(-3, 2, 5));
+	EXPECT_TRUE(mask.test(12, 9, 20));
+	EXPECT_FALSE(mask.test(13, 9, 20));
+	EXPECT_FALSE(mask.test(-4, 2, 5));
+
+	const Region cut(-3, 2, 5, 12, 9, 15);
+	mask.unset(cut);
+	EXPECT_EQ(region.voxels() - cut.voxels(), mask.count());
+	EXPECT_EQ(Region(-3, 2, 16, 12, 9, 20), mask.region());
+	EXPECT_FALSE(mask.test(0, 5, 10));
+	EXPECT_TRUE(mask.test(0, 5, 16));
+}
+
+TEST_F(SelectionMaskTest, testInvert) {
+	SelectionMask mask;
+	mask.set(1, 1, 1);
+	const Region region(0, 0, 0, 3, 3, 3);
+	mask.invert(region);
+	EXPECT_EQ(region.voxels() - 1, mask.count());
+	EXPECT_FALSE(mask.test(1, 1, 1));
+	EXPECT_TRUE(mask.test(0, 0, 0));
+	EXPECT_EQ(region, mask.region());
+	mask.invert(region);
+	EXPECT_EQ(1, mask.count());
+	EXPECT_TRUE(mask.test(1, 1, 1));
+}
+
+TEST_F(SelectionMaskTest, testSetOperations) {
+	SelectionMask a;
+	a.set(Region(0, 0, 0, 9, 0, 0));
+	SelectionMask b;
+	b.set(Region(5, 0, 0, 14, 0, 0));
+
+	SelectionMask united = a;
+	united.unite(b);
+	EXPECT_EQ(15, united.count());
+	EXPECT_EQ(Region(0, 0, 0, 14, 0, 0), united.region());
+
+	SelectionMask intersected = a;
+	intersected.intersect(b);
+	EXPECT_EQ(5, intersected.count());
+	EXPECT_EQ(Region(5, 0, 0, 9, 0, 0), intersected.region());
+
+	SelectionMask subtracted = a;
+	subtracted.subtract(b);
+	EXPECT_EQ(5, subtracted.count());
+	EXPECT_EQ(Region(0, 0, 0, 4, 0, 0), subtracted.region());
+	EXPECT_FALSE(subtracted.test(5, 0, 0));
+}
+
+TEST_F(SelectionMaskTest, testGrowAcrossBricks) {
+	SelectionMask mask;
+	// the corner of a brick - all neighbours except the ones at x-1, y-1 and z-1 are in other bricks
+	mask.set(7, 7, 7);
+	mask.grow();
+	EXPECT_EQ(7, mask.count());
+	EXPECT_EQ(4u, mask.bricks());
+	EXPECT_TRUE(mask.test(8, 7, 7));
+	EXPECT_TRUE(mask.test(6, 7, 7));
+	EXPECT_TRUE(mask.test(7, 8, 7));
+	EXPECT_TRUE(mask.test(7, 6, 7));
+	EXPECT_TRUE(mask.test(7, 7, 8));
+	EXPECT_TRUE(mask.test(7, 7, 6));
+	EXPECT_FALSE(mask.test(8, 8, 7));
+	EXPECT_EQ(Region(6, 6, 6, 8, 8, 8), mask.region());
+
+	SelectionMask negative;
+	negative.set(0, 0, 0);
+	negative.grow();
+	EXPECT_EQ(7, negative.count());
+	EXPECT_TRUE(negative.test(-1, 0, 0));
+	EXPECT_TRUE(negative.test(0, -1, 0));
+	EXPECT_TRUE(negative.test(0, 0, -1));
+}
+
+TEST_F(SelectionMaskTest, testShrink) {
+	SelectionMask mask;
+	// a 3x3x3 cube around a brick corner
+	mask.set(Region(6, 6, 6, 8, 8, 8));
+	mask.shrink();
+	EXPECT_EQ(1, mask.count());
+	EXPECT_TRUE(mask.test(7, 7, 7));
+
+	mask.clear();
+	mask.set(Region(-1, -1, -1, 1, 1, 1));
+	mask.shrink();
+	EXPECT_EQ(1, mask.count());
+	EXPECT_TRUE(mask.test(0, 0, 0));
+	mask.shrink();
+	EXPECT_TRUE(mask.empty());
+	EXPECT_EQ(0u, mask.bricks());
+}
+
+TEST_F(SelectionMaskTest, testGrowShrink) {
+	SelectionMask mask;
+	mask.set(Region(-5, 3, 2, 20, 17, 11));
+	const int64_t count = mask.count();
+	mask.grow();
+	EXPECT_GT(mask.count(), count);
+	EXPECT_EQ(Region(-6, 2, 1, 21, 18, 12), mask.region());
+	mask.shrink();
+	// the corners and edges of the grown box are missing - shrinking restores the box
+	EXPECT_EQ(count, mask.count());
+	EXPECT_EQ(Region(-5, 3, 2, 20, 17, 11), mask.region());
+}
+
+TEST_F(SelectionMaskTest, testReadFlags) {
+	RawVolume volume(Region(0, 0, 0, 15, 15, 15));
+	Voxel selected = createVoxel(VoxelType::Generic, 1);
+	selected.setFlags(FlagOutline);
+	volume.setVoxel(1, 2, 3, selected);
+	volume.setVoxel(10, 12, 14, selected);
+	volume.setVoxel(4, 4, 4, createVoxel(VoxelType::Generic, 1));
+
+	SelectionMask mask;
+	mask.set(0, 0, 0);
+	mask.readFlags(volume, volume.region(), FlagOutline);
+	EXPECT_EQ(2, mask.count());
+	EXPECT_FALSE(mask.test(0, 0, 0));
+	EXPECT_TRUE(mask.test(1, 2, 3));
+	EXPECT_TRUE(mask.test(10, 12, 14));
+	EXPECT_EQ(Region(1, 2, 3, 10, 12, 14), mask.region());
+
+	// only the given region is synced
+	volume.setVoxel(10, 12, 14, createVoxel(VoxelType::Generic, 1));
+	volume.setVoxel(5, 5, 5, selected);
+	mask.readFlags(volume, Region(8, 8, 8, 15, 15, 15), FlagOutline);
+	EXPECT_EQ(1, mask.count());
+	EXPECT_FALSE(mask.test(5, 5, 5));
+	EXPECT_FALSE(mask.test(10, 12, 14));
+}
+
+} // namespace voxel
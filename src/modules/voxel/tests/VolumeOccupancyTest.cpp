@@ -0,0 +1,74 @@
+/**
+ * @file
+ */
+
+#include "voxel/VolumeOccupancy.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SparseVolume.h"
+
+namespace voxel {
+
+class VolumeOccupancyTest : public app::AbstractTest {};
+
+TEST_F(VolumeOccupancyTest, testEmpty) {
+	RawVolume volume(Region(0, 31));
+	VolumeOccupancy occupancy;
+	occupancy.build(volume);
+	EXPECT_EQ(0, occupancy.occupiedBricks());
+	EXPECT_TRUE(occupancy.isBrickEmpty(glm::ivec3(0)));
+	EXPECT_TRUE(occupancy.isSuperBrickEmpty(glm::ivec3(31)));
+}
+
+TEST_F(VolumeOccupancyTest, testBuild) {
+	RawVolume volume(Region(-10, 100));
+	volume.setVoxel(glm::ivec3(-10), createVoxel(VoxelType::Generic, 1));
+	volume.setVoxel(glm::ivec3(100, 0, 50), createVoxel(VoxelType::Generic, 1));
+	VolumeOccupancy occupancy;
+	occupancy.build(volume);
+	EXPECT_EQ(2, occupancy.occupiedBricks());
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(-10)));
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(-3)));
+	EXPECT_TRUE(occupancy.isBrickEmpty(glm::ivec3(-2)));
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(100, 0, 50)));
+	EXPECT_FALSE(occupancy.isSuperBrickEmpty(glm::ivec3(53)));
+	EXPECT_TRUE(occupancy.isSuperBrickEmpty(glm::ivec3(54)));
+	// the grid starts at the lower corner of the volume
+	EXPECT_EQ(Region(-10, -3), occupancy.brickRegion(glm::ivec3(-5)));
+	EXPECT_EQ(Region(54, 117), occupancy.superBrickRegion(glm::ivec3(60)));
+}
+
+TEST_F(VolumeOccupancyTest, testUpdate) {
+	RawVolume volume(Region(0, 127));
+	VolumeOccupancy occupancy;
+	occupancy.build(volume);
+	volume.setVoxel(glm::ivec3(70, 3, 9), createVoxel(VoxelType::Generic, 1));
+	volume.setVoxel(glm::ivec3(71, 3, 9), createVoxel(VoxelType::Generic, 1));
+	occupancy.update(volume, Region(70, 3, 9, 71, 3, 9));
+	EXPECT_EQ(1, occupancy.occupiedBricks());
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(64, 0, 8)));
+	EXPECT_FALSE(occupancy.isSuperBrickEmpty(glm::ivec3(127, 0, 0)));
+
+	// the brick is scanned completely - the other voxel keeps it occupied
+	volume.setVoxel(glm::ivec3(70, 3, 9), Voxel());
+	occupancy.update(volume, Region(70, 3, 9, 70, 3, 9));
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(70, 3, 9)));
+
+	volume.setVoxel(glm::ivec3(71, 3, 9), Voxel());
+	occupancy.update(volume, Region(71, 3, 9, 71, 3, 9));
+	EXPECT_EQ(0, occupancy.occupiedBricks());
+	EXPECT_TRUE(occupancy.isSuperBrickEmpty(glm::ivec3(127, 0, 0)));
+}
+
+TEST_F(VolumeOccupancyTest, testSparseVolume) {
+	const Region region(0, 1023);
+	SparseVolume volume(region);
+	volume.setVoxel(glm::ivec3(512, 600, 1000), createVoxel(VoxelType::Generic, 1));
+	VolumeOccupancy occupancy(region);
+	occupancy.update(volume, Region(500, 1010));
+	EXPECT_EQ(1, occupancy.occupiedBricks());
+	EXPECT_FALSE(occupancy.isBrickEmpty(glm::ivec3(519, 607, 1007)));
+	EXPECT_TRUE(occupancy.isBrickEmpty(glm::ivec3(520, 607, 1007)));
+}
+
+} // namespace voxel
@@ -0,0 +1,256 @@
+/**
+ * @file
+ */
+
+#include "CollectionIndex.h"
+#include "core/FourCC.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/collection/DynamicSet.h"
+#include "io/Stream.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxelformat/Format.h"
+
+namespace voxelcollection {
+
+#define INDEX_MAGIC FourCC('V', 'C', 'I', 'X')
+#define INDEX_VERSION 2
+
+#define wrap(read)                                                                                                     \
+	if ((read) != 0) {                                                                                                 \
+		Log::error("Failed to read collection index: " CORE_STRINGIFY(read) " (line %i)", (int)__LINE__);              \
+		return false;                                                                                                  \
+	}
+
+#define wrapBool(read)                                                                                                 \
+	if (!(read)) {                                                                                                     \
+		Log::error("Failed to handle collection index: " CORE_STRINGIFY(read) " (line %i)", (int)__LINE__);            \
+		return false;                                                                                                  \
+	}
+
+bool CollectionIndexFilter::matches(const CollectionIndexEntry &entry) const {
+	if (!format.empty() && entry.format != format) {
+		return false;
+	}
+	if (minSize > 0u && entry.size < minSize) {
+		return false;
+	}
+	if (maxSize > 0u && entry.size > maxSize) {
+		return false;
+	}
+	if (minNodes > 0u && entry.nodes < minNodes) {
+		return false;
+	}
+	if (maxNodes > 0u && entry.nodes > maxNodes) {
+		return false;
+	}
+	if (maxDimension > 0) {
+		if (entry.dimensions.x > maxDimension || entry.dimensions.y > maxDimension ||
+			entry.dimensions.z > maxDimension) {
+			return false;
+		}
+	}
+	if (!name.empty() && !core::string::icontains(entry.fullPath, name)) {
+		return false;
+	}
+	return true;
+}
+
+bool CollectionIndex::update(const io::FilesystemEntry &entry) {
+	core::ScopedLock lock(_lock);
+	auto iter = _entries.find(entry.fullPath);
+	if (iter != _entries.end() && iter->value.matches(entry)) {
+		return !iter->value.metadata;
+	}
+	CollectionIndexEntry indexEntry;
+	indexEntry.fullPath = entry.fullPath;
+	indexEntry.mtime = entry.mtime;
+	indexEntry.size = entry.size;
+	indexEntry.format = core::string::extractExtension(entry.name).toLower();
+	_entries.put(entry.fullPath, indexEntry);
+	_dirty = true;
+	return true;
+}
+
+void CollectionIndex::setMetadata(const core::String &fullPath, const scenegraph::SceneGraph &sceneGraph) {
+	voxelformat::FormatMetadata metadata;
+	metadata.setSceneGraph(sceneGraph);
+	setMetadata(fullPath, metadata);
+}
+
+void CollectionIndex::setMetadata(const core::String &fullPath, const voxelformat::FormatMetadata &metadata) {
+	core::ScopedLock lock(_lock);
+	auto iter = _entries.find(fullPath);
+	if (iter == _entries.end()) {
+		return;
+	}
+	CollectionIndexEntry &entry = iter->value;
+	entry.nodes = metadata.nodes;
+	entry.dimensions = metadata.dimensions;
+	entry.palette = metadata.palette;
+	entry.metadata = true;
+	_dirty = true;
+}
+
+void CollectionIndex::setThumbnail(const core::String &fullPath, const core::String &thumbnail) {
+	core::ScopedLock lock(_lock);
+	auto iter = _entries.find(fullPath);
+	if (iter == _entries.end() || iter->value.thumbnail == thumbnail) {
+		return;
+	}
+	iter->value.thumbnail = thumbnail;
+	_dirty = true;
+}
+
+int CollectionIndex::prune(const core::String &dir, const core::DynamicArray<io::FilesystemEntry> &entries) {
+	core::DynamicSet<core::String, 4096, core::StringHash> existing;
+	for (const io::FilesystemEntry &entry : entries) {
+		existing.insert(entry.fullPath);
+	}
+	core::DynamicArray<core::String> removals;
+	core::ScopedLock lock(_lock);
+	for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+		if (!core::string::startsWith(iter->key, dir)) {
+			continue;
+		}
+		if (!existing.has(iter->key)) {
+			removals.push_back(iter->key);
+		}
+	}
+	for (const core::String &path : removals) {
+		_entries.remove(path);
+	}
+	if (!removals.empty()) {
+		_dirty = true;
+	}
+	return (int)removals.size();
+}
+
+bool CollectionIndex::get(const core::String &fullPath, CollectionIndexEntry &entry) const {
+	core::ScopedLock lock(_lock);
+	return _entries.get(fullPath, entry);
+}
+
+bool CollectionIndex::has(const core::String &fullPath) const {
+	core::ScopedLock lock(_lock);
+	return _entries.hasKey(fullPath);
+}
+
+int CollectionIndex::query(const CollectionIndexFilter &filter, core::DynamicArray<CollectionIndexEntry> &result) const {
+	core_trace_scoped(CollectionIndexQuery);
+	core::ScopedLock lock(_lock);
+	int n = 0;
+	for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+		if (!filter.matches(iter->value)) {
+			continue;
+		}
+		result.push_back(iter->value);
+		++n;
+	}
+	return n;
+}
+
+size_t CollectionIndex::size() const {
+	core::ScopedLock lock(_lock);
+	return _entries.size();
+}
+
+void CollectionIndex::clear() {
+	core::ScopedLock lock(_lock);
+	_dirty = !_entries.empty();
+	_entries.clear();
+}
+
+bool CollectionIndex::dirty() const {
+	core::ScopedLock lock(_lock);
+	return _dirty;
+}
+
+bool CollectionIndex::load(io::SeekableReadStream &stream) {
+	core_trace_scoped(CollectionIndexLoad);
+	uint32_t magic;
+	wrap(stream.readUInt32(magic))
+	if (magic != INDEX_MAGIC) {
+		Log::warn("Invalid collection index magic");
+		return false;
+	}
+	uint32_t version;
+	wrap(stream.readUInt32(version))
+	if (version != INDEX_VERSION) {
+		Log::info("Collection index version %u is outdated - rebuild the index", version);
+		return false;
+	}
+	uint32_t count;
+	wrap(stream.readUInt32(count))
+	Entries entries;
+	for (uint32_t i = 0; i < count; ++i) {
+		CollectionIndexEntry entry;
+		wrapBool(stream.readPascalStringUInt16LE(entry.fullPath))
+		wrap(stream.readUInt64(entry.mtime))
+		wrap(stream.readUInt64(entry.size))
+		wrapBool(stream.readPascalStringUInt8(entry.format))
+		wrap(stream.readUInt32(entry.nodes))
+		wrap(stream.readInt32(entry.dimensions.x))
+		wrap(stream.readInt32(entry.dimensions.y))
+		wrap(stream.readInt32(entry.dimensions.z))
+		uint16_t colors;
+		wrap(stream.readUInt16(colors))
+		if (colors > palette::PaletteMaxColors) {
+			Log::error("Invalid palette color count %u in collection index", colors);
+			return false;
+		}
+		entry.palette.reserve(colors);
+		for (uint16_t c = 0; c < colors; ++c) {
+			uint32_t rgba;
+			wrap(stream.readUInt32(rgba))
+			entry.palette.push_back(color::RGBA(rgba));
+		}
+		uint8_t flags;
+		wrap(stream.readUInt8(flags))
+		entry.metadata = (flags & 1u) != 0u;
+		wrapBool(stream.readPascalStringUInt16LE(entry.thumbnail))
+		entries.put(entry.fullPath, entry);
+	}
+	core::ScopedLock lock(_lock);
+	_entries = core::move(entries);
+	_dirty = false;
+	Log::debug("Loaded %u entries from the collection index", count);
+	return true;
+}
+
+bool CollectionIndex::save(io::SeekableWriteStream &stream) {
+	core_trace_scoped(CollectionIndexSave);
+	core::ScopedLock lock(_lock);
+	wrapBool(stream.writeUInt32(INDEX_MAGIC))
+	wrapBool(stream.writeUInt32(INDEX_VERSION))
+	wrapBool(stream.writeUInt32((uint32_t)_entries.size()))
+	for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+		const CollectionIndexEntry &entry = iter->value;
+		wrapBool(stream.writePascalStringUInt16LE(entry.fullPath))
+		wrapBool(stream.writeUInt64(entry.mtime))
+		wrapBool(stream.writeUInt64(entry.size))
+		wrapBool(stream.writePascalStringUInt8(entry.format))
+		wrapBool(stream.writeUInt32(entry.nodes))
+		wrapBool(stream.writeInt32(entry.dimensions.x))
+		wrapBool(stream.writeInt32(entry.dimensions.y))
+		wrapBool(stream.writeInt32(entry.dimensions.z))
+		wrapBool(stream.writeUInt16((uint16_t)entry.palette.size()))
+		for (const color::RGBA &rgba : entry.palette) {
+			wrapBool(stream.writeUInt32(rgba.rgba))
+		}
+		uint8_t flags = 0u;
+		if (entry.metadata) {
+			flags |= 1u;
+		}
+		wrapBool(stream.writeUInt8(flags))
+		wrapBool(stream.writePascalStringUInt16LE(entry.thumbnail))
+	}
+	_dirty = false;
+	return true;
+}
+
+#undef wrapBool
+#undef wrap
+
+} // namespace voxelcollection
@@ -0,0 +1,135 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "color/RGBA.h"
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicStringMap.h"
+#include "core/concurrent/Lock.h"
+#include "core/Trace.h"
+#include "io/FilesystemEntry.h"
+#include <glm/vec3.hpp>
+
+namespace io {
+class SeekableReadStream;
+class SeekableWriteStream;
+} // namespace io
+
+namespace scenegraph {
+class SceneGraph;
+}
+
+namespace voxelformat {
+struct FormatMetadata;
+}
+
+namespace voxelcollection {
+
+/**
+ * @brief Cached information about a single local voxel file
+ *
+ * The entry is keyed by the full path and considered up to date as long as the modification time and the file size
+ * match the values of the filesystem.
+ */
+struct CollectionIndexEntry {
+	core::String fullPath;
+	uint64_t mtime = 0u;
+	uint64_t size = 0u;
+	/** lower case file extension */
+	core::String format;
+	/** the amount of model nodes in the scene graph */
+	uint32_t nodes = 0u;
+	/** the dimensions of the whole scene */
+	glm::ivec3 dimensions{0};
+	core::DynamicArray<color::RGBA> palette;
+	/** @c true if the metadata (nodes, dimensions, palette) was extracted from the file */
+	bool metadata = false;
+	/** the path of the cached thumbnail image - empty if no thumbnail was created for the current file */
+	core::String thumbnail;
+
+	inline bool matches(const io::FilesystemEntry &entry) const {
+		return mtime == entry.mtime && size == entry.size;
+	}
+};
+
+/**
+ * @brief Filter for @c CollectionIndex::query()
+ * @note Empty strings and zero values don't filter
+ */
+struct CollectionIndexFilter {
+	/** case insensitive substring match on the full path */
+	core::String name;
+	/** lower case file extension */
+	core::String format;
+	uint64_t minSize = 0u;
+	uint64_t maxSize = 0u;
+	uint32_t minNodes = 0u;
+	uint32_t maxNodes = 0u;
+	/** maximum dimension of the scene on any axis */
+	int maxDimension = 0;
+
+	bool matches(const CollectionIndexEntry &entry) const;
+};
+
+/**
+ * @brief Persistent index of local voxel files with their metadata and thumbnail state
+ *
+ * The index is written to disk and allows incremental rescans of the local directory. Only files that were added or
+ * changed (mtime or size differ) since the last scan must be loaded again to extract the metadata.
+ *
+ * @note This class is thread safe
+ */
+class CollectionIndex {
+public:
+	using Entries = core::DynamicStringMap<CollectionIndexEntry, 4096>;
+
+private:
+	Entries _entries;
+	mutable core_trace_mutex(core::Lock, _lock, "CollectionIndex");
+	bool _dirty = false;
+
+public:
+	/**
+	 * @brief Update the index with the given filesystem entry
+	 * @return @c true if the entry is new or was changed since the last scan - the metadata must be updated in this case
+	 */
+	bool update(const io::FilesystemEntry &entry);
+	/**
+	 * @brief Extract the metadata of the given loaded scene graph and store it for the given file
+	 */
+	void setMetadata(const core::String &fullPath, const scenegraph::SceneGraph &sceneGraph);
+	/**
+	 * @brief Store the metadata that was loaded without the voxels for the given file
+	 * @sa voxelformat::loadMetadata()
+	 */
+	void setMetadata(const core::String &fullPath, const voxelformat::FormatMetadata &metadata);
+	/**
+	 * @brief Remember the cached thumbnail image of the given file
+	 * @note The thumbnail is forgotten if the file was changed - see @c update()
+	 */
+	void setThumbnail(const core::String &fullPath, const core::String &thumbnail);
+	/**
+	 * @brief Remove all entries below the given directory that are not part of the given set of files
+	 * @return the amount of removed entries
+	 */
+	int prune(const core::String &dir, const core::DynamicArray<io::FilesystemEntry> &entries);
+
+	bool get(const core::String &fullPath, CollectionIndexEntry &entry) const;
+	bool has(const core::String &fullPath) const;
+	/**
+	 * @brief Collect all entries that match the given filter
+	 * @return the amount of matching entries
+	 */
+	int query(const CollectionIndexFilter &filter, core::DynamicArray<CollectionIndexEntry> &result) const;
+	size_t size() const;
+	void clear();
+	bool dirty() const;
+
+	bool load(io::SeekableReadStream &stream);
+	bool save(io::SeekableWriteStream &stream);
+};
+
+} // namespace voxelcollection
@@ -30,6 +30,8 @@ CollectionManager::CollectionManager(const io::FilesystemPtr &filesystem, const
 	_newVoxelFiles = core::make_shared<QueuePtr::value_type>();
 	_imageQueue = core::make_shared<ImageQueuePtr::value_type>();
 	_voxelSourceQueue = core::make_shared<VoxelSourceQueuePtr::value_type>();
+	_index = core::make_shared<CollectionIndexPtr::value_type>();
+	_pendingMetadata = core::make_shared<PendingCounterPtr::value_type>(0);
 }
 
 CollectionManager::~CollectionManager() {
@@ -56,6 +58,44 @@ bool CollectionManager::init() {
 	if (_localDir.empty()) {
 		var->setVal(documents);
 	}
+	loadIndex();
+	return true;
+}
+
+core::String CollectionManager::indexFile() const {
+	return _filesystem->homeWritePath("collection-index.dat");
+}
+
+bool CollectionManager::loadIndex() {
+	const core::String &path = indexFile();
+	if (!_archive->exists(path)) {
+		Log::debug("No collection index found at %s", path.c_str());
+		return false;
+	}
+	core::ScopedPtr<io::SeekableReadStream> stream(_archive->readStream(path));
+	if (!stream) {
+		Log::warn("Failed to open collection index %s", path.c_str());
+		return false;
+	}
+	if (!_index->load(*stream)) {
+		_index->clear();
+		return false;
+	}
+	Log::debug("Loaded collection index with %i entries", (int)_index->size());
+	return true;
+}
+
+bool CollectionManager::saveIndex() {
+	if (!_index->dirty()) {
+		return true;
+	}
+	const core::String &path = indexFile();
+	core::ScopedPtr<io::SeekableWriteStream> stream(_archive->writeStream(path));
+	if (!stream || !_index->save(*stream)) {
+		Log::warn("Failed to write collection index %s", path.c_str());
+		return false;
+	}
+	Log::debug("Saved collection index with %i entries to %s", (int)_index->size(), path.c_str());
 	return true;
 }
 
@@ -82,6 +122,7 @@ bool CollectionManager::setLocalDir(const core::String &dir) {
 }
 
 void CollectionManager::shutdown() {
+	saveIndex();
 }
 
 bool CollectionManager::local() {
@@ -96,12 +137,18 @@ bool CollectionManager::local() {
 	Log::info("Local document scanning (%s)...", localDir.c_str());
 	_archive->list(localDir, entities, "");
 	Log::debug("Found %i entries in %s", (int)entities.size(), localDir.c_str());
-	app::for_parallel(0, entities.size(), [entities, localDir, voxelFiles = _newVoxelFiles](int start, int end) {
+	const int pruned = _index->prune(localDir, entities);
+	Log::debug("Removed %i vanished entries from the collection index", pruned);
+	core::ConcurrentQueue<core::String> changed;
+	app::for_parallel(0, entities.size(), [&entities, &changed, localDir, index = _index, voxelFiles = _newVoxelFiles](int start, int end) {
 		for (int i = start; i < end; ++i) {
 			const io::FilesystemEntry &entry  = entities[i];
 			if (!io::isA(entry.name, voxelformat::voxelLoad())) {
 				continue;
 			}
+			if (index->update(entry)) {
+				changed.push(entry.fullPath);
+			}
 			VoxelFile voxelFile;
 			voxelFile.name = entry.fullPath.substr(localDir.size());
 			voxelFile.fullPath = entry.fullPath;
@@ -117,6 +164,27 @@ bool CollectionManager::local() {
 	VoxelCollection collection{{}, 0.0, true};
 	_voxelFilesMap.put(LOCAL_SOURCE, collection);
 
+	// only new or modified files are checked to extract the metadata for the index - without loading the voxels
+	core::DynamicArray<core::String> changedFiles;
+	changed.popAll(changedFiles);
+	Log::info("Updating the collection index for %i new or modified files", (int)changedFiles.size());
+	_pendingMetadata->increment((int)changedFiles.size());
+	_saveIndexAfterScan = true;
+	for (const core::String &fullPath : changedFiles) {
+		app::schedule([archive = _archive, index = _index, pending = _pendingMetadata, fullPath]() {
+			voxelformat::FormatMetadata metadata;
+			io::FileDescription fileDesc;
+			fileDesc.set(fullPath);
+			voxelformat::LoadContext loadCtx;
+			if (!voxelformat::loadMetadata(fileDesc, archive, metadata, loadCtx)) {
+				Log::debug("Failed to load the metadata of %s for the collection index", fullPath.c_str());
+			}
+			// also store failed loads to not retry them before the file was modified
+			index->setMetadata(fullPath, metadata);
+			pending->decrement();
+		});
+	}
+
 	return true;
 }
 
@@ -133,7 +201,13 @@ void CollectionManager::loadThumbnail(const VoxelFile &voxelFile) {
 		return;
 	}
 	const core::String &targetImageFile = voxelFile.targetFile() + ".png";
-	if (_archive->exists(targetImageFile)) {
+	bool cached = _archive->exists(targetImageFile);
+	if (cached && voxelFile.isLocal()) {
+		// the thumbnail of a local file that was modified since the thumbnail was created must be created again
+		CollectionIndexEntry entry;
+		cached = _index->get(voxelFile.fullPath, entry) && entry.thumbnail == targetImageFile;
+	}
+	if (cached) {
 		app::schedule([voxelFile, targetImageFile, archive = _archive, imageQueue = _imageQueue]() {
 			core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(targetImageFile));
 			image::ImagePtr image = image::loadImage(targetImageFile, *stream);
@@ -150,7 +224,7 @@ void CollectionManager::loadThumbnail(const VoxelFile &voxelFile) {
 			imageQueue->push(image::loadImage(voxelFile.name, stream));
 		});
 	} else {
-		app::schedule([archive = _archive, voxelFile, targetImageFile, imageQueue = _imageQueue]() {
+		app::schedule([archive = _archive, voxelFile, targetImageFile, imageQueue = _imageQueue, index = _index]() {
 			http::HttpCacheStream stream(archive, voxelFile.targetFile(), voxelFile.url);
 			stream.close();
 			voxelformat::LoadContext loadCtx;
@@ -165,6 +239,9 @@ void CollectionManager::loadThumbnail(const VoxelFile &voxelFile) {
 				Log::warn("Failed to save thumbnail for %s to %s", voxelFile.name.c_str(), targetImageFile.c_str());
 			} else {
 				Log::debug("Created thumbnail for %s at %s", voxelFile.name.c_str(), targetImageFile.c_str());
+				if (voxelFile.isLocal()) {
+					index->setThumbnail(voxelFile.fullPath, targetImageFile);
+				}
 			}
 			imageQueue->push(thumbnailImage);
 		});
@@ -193,6 +270,8 @@ bool CollectionManager::createThumbnail(const VoxelFile &voxelFile) {
 	core::ScopedPtr<io::SeekableWriteStream> writeStream(_archive->writeStream(targetImageFile));
 	if (!writeStream || !image::writePNG(image, *writeStream)) {
 		Log::warn("Failed to write thumbnail to %s - no caching", targetImageFile.c_str());
+	} else if (voxelFile.isLocal()) {
+		_index->setThumbnail(voxelFile.fullPath, targetImageFile);
 	}
 	Log::info("Created thumbnail for %s at %s", fileName.c_str(), targetImageFile.c_str());
 	return true;
@@ -263,6 +342,11 @@ void CollectionManager::update(double nowSeconds, int n) {
 		collection.sorted = true;
 	}
 	_count += voxelFiles.size();
+
+	if (_saveIndexAfterScan && *_pendingMetadata.get() == 0) {
+		_saveIndexAfterScan = false;
+		saveIndex();
+	}
 }
 
 bool CollectionManager::download(const io::ArchivePtr &archive, VoxelFile &voxelFile) {
@@ -286,4 +370,9 @@ int CollectionManager::allEntries() const {
 	return _count;
 }
 
+int CollectionManager::query(const CollectionIndexFilter &filter,
+							 core::DynamicArray<CollectionIndexEntry> &result) const {
+	return _index->query(filter, result);
+}
+
 } // namespace voxelcollection
@@ -6,12 +6,14 @@
 
 #include "core/IComponent.h"
 #include "core/SharedPtr.h"
+#include "core/concurrent/Atomic.h"
 #include "core/collection/ConcurrentQueue.h"
 #include "core/collection/StringSet.h"
 #include "io/Archive.h"
 #include "io/Filesystem.h"
 #include "video/Texture.h"
 #include "video/TexturePool.h"
+#include "voxelcollection/CollectionIndex.h"
 #include "voxelcollection/Downloader.h"
 
 namespace voxelcollection {
@@ -30,6 +32,13 @@ private:
 	VoxelSourceQueuePtr _voxelSourceQueue;
 	video::TexturePoolPtr _texturePool;
 	io::FilesystemPtr _filesystem;
+	using CollectionIndexPtr = core::SharedPtr<CollectionIndex>;
+	CollectionIndexPtr _index;
+	/** the amount of files of the last local scan whose metadata is still extracted */
+	using PendingCounterPtr = core::SharedPtr<core::AtomicInt>;
+	PendingCounterPtr _pendingMetadata;
+	/** the index is saved once all metadata of the last local scan was extracted */
+	bool _saveIndexAfterScan = false;
 
 	int _count = 0;
 
@@ -38,6 +47,7 @@ private:
 	core::StringSet _onlineResolvedSources;
 	VoxelSources _sources;
 	static bool download(const io::ArchivePtr &archive, VoxelFile &voxelFile);
+	core::String indexFile() const;
 
 public:
 	CollectionManager(const io::FilesystemPtr &filesystem, const video::TexturePoolPtr &texturePool);
@@ -53,6 +63,10 @@ public:
 	const core::String &localDir() const;
 	bool setLocalDir(const core::String &dir);
 
+	/**
+	 * @brief Scan the local directory. Only new or changed files (compared to the persisted index) are loaded in the
+	 * background to extract their metadata.
+	 */
 	bool local();
 	bool online();
 	void resolve(const VoxelSource &source, bool async = true);
@@ -71,6 +85,15 @@ public:
 	const VoxelSources &sources() const;
 	int allEntries() const;
 
+	/**
+	 * @brief Query the persisted index of the local files
+	 * @return the amount of matching entries
+	 */
+	int query(const CollectionIndexFilter &filter, core::DynamicArray<CollectionIndexEntry> &result) const;
+	const CollectionIndex &index() const;
+	bool loadIndex();
+	bool saveIndex();
+
 	core::String absolutePath(const VoxelFile &voxelFile) const;
 };
 
@@ -82,6 +105,10 @@ inline const VoxelSources &CollectionManager::sources() const {
 	return _sources;
 }
 
+inline const CollectionIndex &CollectionManager::index() const {
+	return *_index.get();
+}
+
 typedef core::SharedPtr<CollectionManager> CollectionManagerPtr;
 
 }; // namespace voxelcollection
@@ -0,0 +1,137 @@
+/**
+ * @file
+ */
+
+#include "voxelcollection/CollectionIndex.h"
+#include "app/tests/AbstractTest.h"
+#include "core/StringUtil.h"
+#include "io/BufferedReadWriteStream.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/Region.h"
+
+namespace voxelcollection {
+
+class CollectionIndexTest : public app::AbstractTest {
+protected:
+	io::FilesystemEntry entry(const core::String &fullPath, uint64_t size, uint64_t mtime = 1000u) const {
+		io::FilesystemEntry e;
+		e.fullPath = fullPath;
+		e.name = core::string::extractFilenameWithExtension(fullPath);
+		e.type = io::FilesystemEntry::Type::file;
+		e.size = size;
+		e.mtime = mtime;
+		return e;
+	}
+
+	void fillSceneGraph(scenegraph::SceneGraph &sceneGraph, int nodes) const {
+		for (int i = 0; i < nodes; ++i) {
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.createVolume(voxel::Region(0, 0, 0, 7, 3, 1));
+			sceneGraph.emplace(core::move(node));
+		}
+	}
+};
+
+TEST_F(CollectionIndexTest, testUpdate) {
+	CollectionIndex index;
+	EXPECT_TRUE(index.update(entry("/models/a.vox", 100u))) << "New entries need metadata";
+	EXPECT_TRUE(index.update(entry("/models/a.vox", 100u))) << "Entries without metadata still need metadata";
+	scenegraph::SceneGraph sceneGraph;
+	fillSceneGraph(sceneGraph, 2);
+	index.setMetadata("/models/a.vox", sceneGraph);
+	index.setThumbnail("/models/a.vox", "/cache/a.vox.png");
+	EXPECT_FALSE(index.update(entry("/models/a.vox", 100u))) << "Unchanged entries must not be loaded again";
+	EXPECT_TRUE(index.update(entry("/models/a.vox", 100u, 2000u))) << "A changed mtime must invalidate the entry";
+
+	CollectionIndexEntry indexEntry;
+	ASSERT_TRUE(index.get("/models/a.vox", indexEntry));
+	EXPECT_FALSE(indexEntry.metadata);
+	EXPECT_TRUE(indexEntry.thumbnail.empty()) << "The thumbnail of a changed file must be created again";
+	EXPECT_EQ("vox", indexEntry.format);
+}
+
+TEST_F(CollectionIndexTest, testMetadata) {
+	CollectionIndex index;
+	index.update(entry("/models/a.vox", 100u));
+	scenegraph::SceneGraph sceneGraph;
+	fillSceneGraph(sceneGraph, 3);
+	index.setMetadata("/models/a.vox", sceneGraph);
+
+	CollectionIndexEntry indexEntry;
+	ASSERT_TRUE(index.get("/models/a.vox", indexEntry));
+	EXPECT_TRUE(indexEntry.metadata);
+	EXPECT_EQ(3u, indexEntry.nodes);
+	EXPECT_EQ(glm::ivec3(8, 4, 2), indexEntry.dimensions);
+	EXPECT_FALSE(indexEntry.palette.empty());
+}
+
+TEST_F(CollectionIndexTest, testSaveLoad) {
+	CollectionIndex index;
+	index.update(entry("/models/a.vox", 100u));
+	index.update(entry("/models/b.qb", 200u));
+	scenegraph::SceneGraph sceneGraph;
+	fillSceneGraph(sceneGraph, 1);
+	index.setMetadata("/models/a.vox", sceneGraph);
+	index.setThumbnail("/models/b.qb", "/cache/b.qb.png");
+	EXPECT_TRUE(index.dirty());
+
+	io::BufferedReadWriteStream stream;
+	ASSERT_TRUE(index.save(stream));
+	EXPECT_FALSE(index.dirty());
+	stream.seek(0);
+
+	CollectionIndex loaded;
+	ASSERT_TRUE(loaded.load(stream));
+	ASSERT_EQ(2u, loaded.size());
+	CollectionIndexEntry a;
+	ASSERT_TRUE(loaded.get("/models/a.vox", a));
+	EXPECT_TRUE(a.metadata);
+	EXPECT_TRUE(a.thumbnail.empty());
+	EXPECT_EQ(1u, a.nodes);
+	EXPECT_EQ(100u, a.size);
+	EXPECT_EQ(sceneGraph.firstPalette().colorCount(), (int)a.palette.size());
+	CollectionIndexEntry b;
+	ASSERT_TRUE(loaded.get("/models/b.qb", b));
+	EXPECT_FALSE(b.metadata);
+	EXPECT_EQ("/cache/b.qb.png", b.thumbnail);
+	EXPECT_FALSE(loaded.update(entry("/models/a.vox", 100u)));
+}
+
+TEST_F(CollectionIndexTest, testQuery) {
+	CollectionIndex index;
+	index.update(entry("/models/Tree.vox", 100u));
+	index.update(entry("/models/tree2.qb", 5000u));
+	index.update(entry("/models/house.vox", 200u));
+
+	core::DynamicArray<CollectionIndexEntry> result;
+	CollectionIndexFilter filter;
+	filter.name = "tree";
+	EXPECT_EQ(2, index.query(filter, result));
+
+	result.clear();
+	filter.format = "vox";
+	EXPECT_EQ(1, index.query(filter, result));
+	ASSERT_EQ(1u, result.size());
+	EXPECT_EQ("/models/Tree.vox", result[0].fullPath);
+
+	result.clear();
+	CollectionIndexFilter sizeFilter;
+	sizeFilter.maxSize = 1000u;
+	EXPECT_EQ(2, index.query(sizeFilter, result));
+}
+
+TEST_F(CollectionIndexTest, testPrune) {
+	CollectionIndex index;
+	index.update(entry("/models/a.vox", 100u));
+	index.update(entry("/models/b.vox", 100u));
+	index.update(entry("/other/c.vox", 100u));
+	core::DynamicArray<io::FilesystemEntry> entries;
+	entries.push_back(entry("/models/a.vox", 100u));
+	EXPECT_EQ(1, index.prune("/models/", entries));
+	EXPECT_TRUE(index.has("/models/a.vox"));
+	EXPECT_FALSE(index.has("/models/b.vox"));
+	EXPECT_TRUE(index.has("/other/c.vox")) << "Entries outside of the scanned directory must be kept";
+}
+
+} // namespace voxelcollection
@@ -161,6 +161,35 @@ size_t PaletteFormat::loadPalette(const core::String &filename, const io::Archiv
 	return palette.size();
 }
 
+void FormatMetadata::setSceneGraph(const scenegraph::SceneGraph &sceneGraph) {
+	nodes = (uint32_t)sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels);
+	dimensions = glm::ivec3(0);
+	palette.clear();
+	if (nodes == 0u) {
+		return;
+	}
+	const voxel::Region &region = sceneGraph.sceneRegion();
+	if (region.isValid()) {
+		dimensions = region.getDimensionsInVoxels();
+	}
+	const palette::Palette &scenePalette = sceneGraph.firstPalette();
+	palette.reserve(scenePalette.colorCount());
+	for (int i = 0; i < scenePalette.colorCount(); ++i) {
+		palette.push_back(scenePalette.color(i));
+	}
+}
+
+bool Format::loadMetadata(const core::String &filename, const io::ArchivePtr &archive, FormatMetadata &metadata,
+						  const LoadContext &ctx) {
+	Log::debug("%s doesn't support loading the metadata only - load the whole scene", filename.c_str());
+	scenegraph::SceneGraph sceneGraph;
+	if (!load(filename, archive, sceneGraph, ctx)) {
+		return false;
+	}
+	metadata.setSceneGraph(sceneGraph);
+	return true;
+}
+
 image::ImagePtr Format::loadScreenshot(const core::String &filename, const io::ArchivePtr &, const LoadContext &) {
 	Log::debug("%s doesn't have a supported embedded screenshot", filename.c_str());
 	return image::ImagePtr();
@@ -13,7 +13,9 @@
 #include "io/FormatDescription.h"
 #include "voxelformat/FormatThumbnailFwd.h"
 #include "core/IProgress.h"
+#include "core/collection/DynamicArray.h"
 #include <glm/fwd.hpp>
+#include <glm/vec3.hpp>
 
 namespace palette {
 class Palette;
@@ -34,6 +36,19 @@ namespace voxelformat {
 
 struct LoadContext {
 	core::IProgress *progress = nullptr;
+	/**
+	 * @brief Optional world space box (inclusive) to limit the import to. Only formats that are able to skip parts of
+	 * their data (e.g. minecraft regions and worlds) support this - all others load everything.
+	 */
+	bool hasRegionFilter = false;
+	glm::ivec3 regionMins{0};
+	glm::ivec3 regionMaxs{0};
+
+	void setRegionFilter(const glm::ivec3 &mins, const glm::ivec3 &maxs) {
+		hasRegionFilter = true;
+		regionMins = mins;
+		regionMaxs = maxs;
+	}
 
 	core::IProgress &progressRef() const {
 		return core::progressOrNull(progress);
@@ -68,10 +83,19 @@ struct LoadContext {
 	 * @brief Child context that writes into @p childProgress (e.g. a @c ProgressRange).
 	 */
 	LoadContext nested(core::IProgress &childProgress) const {
-		LoadContext child;
+		LoadContext child = *this;
 		child.progress = &childProgress;
 		return child;
 	}
+
+	/**
+	 * @brief Copy of the load options without any progress reporting (e.g. for parallel sub-loads)
+	 */
+	LoadContext withoutProgress() const {
+		LoadContext child = *this;
+		child.progress = nullptr;
+		return child;
+	}
 };
 
 struct SaveContext {
@@ -114,6 +138,20 @@ struct SaveContext {
 	ThumbnailCreator thumbnailCreator = nullptr;
 };
 
+/**
+ * @brief The information about a file that is extracted by @c Format::loadMetadata()
+ */
+struct FormatMetadata {
+	/** the amount of model nodes - including the model references */
+	uint32_t nodes = 0u;
+	/** the dimensions of the whole scene */
+	glm::ivec3 dimensions{0};
+	/** the colors of the palette - empty if the format doesn't store a palette */
+	core::DynamicArray<color::RGBA> palette;
+
+	void setSceneGraph(const scenegraph::SceneGraph &sceneGraph);
+};
+
 // the max amount of voxels - [0-255]
 static constexpr int MaxRegionSize = 256;
 
@@ -251,6 +289,12 @@ public:
 	 */
 	virtual size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 							   const LoadContext &ctx);
+	/**
+	 * @brief Only load the amount of nodes, the scene dimensions and the palette - but not the voxels
+	 * @note Formats that don't implement this will load the whole scene graph - see @c loadPalette()
+	 */
+	virtual bool loadMetadata(const core::String &filename, const io::ArchivePtr &archive, FormatMetadata &metadata,
+							  const LoadContext &ctx);
 	/**
 	 * @todo don't use a stream, but an archive for formats that are split over several files
 	 */
@@ -184,6 +184,11 @@ bool FormatConfig::init() {
 		cfg::VoxformatGLTF_KHR_materials_specular, true, N_("KHR_materials_specular"),
 		N_("Apply KHR_materials_specular when saving into the glTF format"), core::CV_NOPERSIST);
 	core::registerVar(voxformatGLTF_KHR_materials_specular);
+	const core::VarDef voxformatGLTFStreaming(
+		cfg::VoxformatGLTFStreaming, true, N_("Streaming glb export"),
+		N_("Write the geometry of glb files while the models are meshed to keep the memory usage low"),
+		core::CV_NOPERSIST);
+	core::registerVar(voxformatGLTFStreaming);
 	const core::VarDef voxformatWithMaterials(cfg::VoxformatWithMaterials, true, N_("Export materials"),
 											  N_("Try to export material properties if the formats support it"),
 											  core::CV_NOPERSIST);
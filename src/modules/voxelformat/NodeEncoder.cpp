@@ -0,0 +1,72 @@
+/**
+ * @file
+ */
+
+#include "NodeEncoder.h"
+#include "app/App.h"
+#include "app/ForParallel.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
+
+namespace voxelformat {
+
+NodeEncoder::NodeEncoder(EncodeFunc &&func, size_t maxWindowBytes)
+	: _func(core::move(func)), _maxWindowBytes(maxWindowBytes) {
+}
+
+void NodeEncoder::add(const scenegraph::SceneGraphNode &node, size_t sizeHint) {
+	_jobs.push_back({&node, sizeHint});
+}
+
+bool NodeEncoder::encodeWindow() {
+	core_trace_scoped(NodeEncoderWindow);
+	// give every worker a few jobs to balance nodes of different sizes - but stay in the memory budget
+	const int maxJobs = core_max(1, app::App::getInstance()->threads()) * 4;
+	_windowStart = _next;
+	_windowEnd = _windowStart;
+	size_t bytes = 0u;
+	while (_windowEnd < (int)_jobs.size() && _windowEnd - _windowStart < maxJobs) {
+		const size_t sizeHint = _jobs[_windowEnd].sizeHint;
+		if (_windowEnd > _windowStart && bytes + sizeHint > _maxWindowBytes) {
+			break;
+		}
+		bytes += sizeHint;
+		++_windowEnd;
+	}
+
+	_buffers.clear();
+	_buffers.reserve(_windowEnd - _windowStart);
+	for (int i = _windowStart; i < _windowEnd; ++i) {
+		_buffers.emplace_back(io::BufferedReadWriteStream((int64_t)_jobs[i].sizeHint));
+	}
+	core::AtomicBool failed{false};
+	app::for_parallel(_windowStart, _windowEnd, [this, &failed](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			if (!_func(*_jobs[i].node, _buffers[i - _windowStart])) {
+				failed = true;
+			}
+		}
+	});
+	if (failed) {
+		Log::error("Failed to encode the node payloads %i-%i", _windowStart, _windowEnd - 1);
+		return false;
+	}
+	return true;
+}
+
+const io::BufferedReadWriteStream *NodeEncoder::next() {
+	if (_next >= (int)_jobs.size()) {
+		Log::error("No node payload left to write");
+		return nullptr;
+	}
+	if (_next >= _windowEnd) {
+		if (!encodeWindow()) {
+			return nullptr;
+		}
+	}
+	return &_buffers[_next++ - _windowStart];
+}
+
+} // namespace voxelformat
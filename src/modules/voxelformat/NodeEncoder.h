@@ -0,0 +1,85 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Function.h"
+#include "core/collection/DynamicArray.h"
+#include "io/BufferedReadWriteStream.h"
+
+namespace scenegraph {
+class SceneGraphNode;
+}
+
+namespace voxelformat {
+
+/**
+ * @brief Encodes independent per-node payloads of a format on all cores
+ *
+ * A format registers one job per node in the order the payloads are written to the file. The jobs are encoded
+ * concurrently into private buffers and are handed out by @c next() in the order of registration - the output is
+ * the same as for a sequential save. The jobs are executed in windows and only the buffers of the current window are
+ * kept in memory.
+ *
+ * @code
+ * NodeEncoder encoder([](const scenegraph::SceneGraphNode &node, io::SeekableWriteStream &stream) {
+ *   return encodePayload(node, stream);
+ * });
+ * for (const scenegraph::SceneGraphNode *node : nodes) {
+ *   encoder.add(*node, sizeHint);
+ * }
+ * for (const scenegraph::SceneGraphNode *node : nodes) {
+ *   writeHeader(*node, stream);
+ *   const io::BufferedReadWriteStream *payload = encoder.next();
+ *   stream.write(payload->getBuffer(), payload->size());
+ * }
+ * @endcode
+ */
+class NodeEncoder {
+public:
+	/**
+	 * @note Called concurrently for different nodes - must not modify shared state
+	 */
+	using EncodeFunc = core::Function<bool(const scenegraph::SceneGraphNode &node, io::SeekableWriteStream &stream)>;
+
+private:
+	struct Job {
+		const scenegraph::SceneGraphNode *node;
+		size_t sizeHint;
+	};
+	EncodeFunc _func;
+	core::DynamicArray<Job> _jobs;
+	core::DynamicArray<io::BufferedReadWriteStream> _buffers;
+	size_t _maxWindowBytes;
+	int _windowStart = 0;
+	int _windowEnd = 0;
+	int _next = 0;
+
+	bool encodeWindow();
+
+public:
+	/**
+	 * @param maxWindowBytes The estimated amount of bytes of all jobs that are encoded at the same time - see the size
+	 * hint of @c add()
+	 */
+	NodeEncoder(EncodeFunc &&func, size_t maxWindowBytes = 64u * 1024u * 1024u);
+
+	/**
+	 * @param sizeHint The estimated size of the encoded payload in bytes - used to reserve the buffer and to limit
+	 * the memory of a window
+	 */
+	void add(const scenegraph::SceneGraphNode &node, size_t sizeHint = 0u);
+
+	/**
+	 * @return The encoded payload of the next job in the order of @c add() or @c nullptr if the encoding failed or
+	 * there are no jobs left. The buffer stays valid until the next call.
+	 */
+	const io::BufferedReadWriteStream *next();
+
+	inline int jobs() const {
+		return (int)_jobs.size();
+	}
+};
+
+} // namespace voxelformat
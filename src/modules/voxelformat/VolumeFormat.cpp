@@ -4,15 +4,20 @@
 
 #include "VolumeFormat.h"
 #include "app/App.h"
+#include "core/FourCC.h"
 #include "core/Log.h"
+#include "core/MemoryAccounting.h"
 #include "core/ScopedPtr.h"
 #include "core/SharedPtr.h"
 #include "core/StringUtil.h"
 #include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include "core/collection/DynamicStringMap.h"
 #include "io/Archive.h"
 #include "io/File.h"
 #include "io/FilesystemArchive.h"
+#include "io/SniffedStreamArchive.h"
 #include "scenegraph/SceneGraph.h"
 #include "io/FormatDescription.h"
 #include "io/Stream.h"
@@ -194,166 +199,304 @@ const io::FormatDescription *voxelSave() {
 	return desc.data();
 }
 
-static core::SharedPtr<Format> getFormat(const io::FormatDescription &desc, uint32_t magic) {
-	for (const core::String &ext : desc.exts) {
-		// you only have to check one of the supported extensions
-		// here
-		if (io::isA(VENGIFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VENGIFormat>();
-		} else if (io::isA(QBFormat::format(), desc, ext, magic)) {
-			return core::make_shared<QBFormat>();
-		} else if (io::isA(VoxFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VoxFormat>();
-		} else if (io::isA(SLAB6VoxFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SLAB6VoxFormat>();
-		} else if (io::isA(QBTFormat::format(), desc, ext, magic)) {
-			return core::make_shared<QBTFormat>();
-		} else if (io::isA(KVXFormat::format(), desc, ext, magic)) {
-			return core::make_shared<KVXFormat>();
-		} else if (io::isA(KV6Format::format(), desc, ext, magic)) {
-			return core::make_shared<KV6Format>();
-		} else if (io::isA(SproxelFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SproxelFormat>();
-		} else if (io::isA(CubFormat::format(), desc, ext, magic)) {
-			return core::make_shared<CubFormat>();
-		} else if (io::isA(GoxFormat::format(), desc, ext, magic)) {
-			return core::make_shared<GoxFormat>();
-		} else if (io::isA(GoxTxtFormat::format(), desc, ext, magic)) {
-			return core::make_shared<GoxTxtFormat>();
-		} else if (io::isA(VelorenTerrainFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VelorenTerrainFormat>();
-		} else if (io::isA(AnimaToonFormat::format(), desc, ext, magic)) {
-			return core::make_shared<AnimaToonFormat>();
-		} else if (io::isA(MCRFormat::format(), desc, ext, magic)) {
-			return core::make_shared<MCRFormat>();
-		} else if (io::isA(MTSFormat::format(), desc, ext, magic)) {
-			return core::make_shared<MTSFormat>();
-		} else if (io::isA(DatFormat::format(), desc, ext, magic)) {
-			return core::make_shared<DatFormat>();
-		} else if (io::isA(MCWorldFormat::format(), desc, ext, magic)) {
-			return core::make_shared<MCWorldFormat>();
-		} else if (io::isA(SMFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SMFormat>();
-		} else if (io::isA(SMTPLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SMTPLFormat>();
-		} else if (io::isA(VXMFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXMFormat>();
-		} else if (io::isA(VXRFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXRFormat>();
-		} else if (io::isA(VXBFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXBFormat>();
-		} else if (io::isA(VMaxFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VMaxFormat>();
-		} else if (io::isA(BlockbenchFormat::format(), desc, ext, magic)) {
-			return core::make_shared<BlockbenchFormat>();
-		} else if (io::isA(CrocotileFormat::format(), desc, ext, magic)) {
-			return core::make_shared<CrocotileFormat>();
-		} else if (io::isA(VXCFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXCFormat>();
-		} else if (io::isA(VXTFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXTFormat>();
-		} else if (io::isA(VXLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VXLFormat>();
-		} else if (io::isA(AoSVXLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<AoSVXLFormat>();
-		} else if (io::isA(CSMFormat::formatNVM(), desc, ext, magic) || isA(CSMFormat::format(), desc, ext, magic)) {
-			return core::make_shared<CSMFormat>();
-		} else if (io::isA(BinVoxFormat::format(), desc, ext, magic)) {
-			return core::make_shared<BinVoxFormat>();
-		} else if (io::isA(QEFFormat::format(), desc, ext, magic)) {
-			return core::make_shared<QEFFormat>();
-		} else if (io::isA(QBCLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<QBCLFormat>();
-		} else if (io::isA(OBJFormat::format(), desc, ext, magic)) {
-			return core::make_shared<OBJFormat>();
-		} else if (io::isA(SkinFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SkinFormat>();
-		} else if (io::isA(STLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<STLFormat>();
-		} else if (io::isA(LDrawFormat::format(), desc, ext, magic)) {
-			return core::make_shared<LDrawFormat>();
-		} else if (io::isA(LXFFormat::format(), desc, ext, magic)) {
-			return core::make_shared<LXFFormat>();
-		} else if (io::isA(StudioIOFormat::format(), desc, ext, magic)) {
-			return core::make_shared<StudioIOFormat>();
-		} else if (io::isA(QuakeBSPFormat::formatUFOAI(), desc, ext, magic) || isA(QuakeBSPFormat::formatQuake1(), desc, ext, magic)) {
-			return core::make_shared<QuakeBSPFormat>();
-		} else if (io::isA(MapFormat::format(), desc, ext, magic)) {
-			return core::make_shared<MapFormat>();
-		} else if (io::isA(PLYFormat::format(), desc, ext, magic)) {
-			return core::make_shared<PLYFormat>();
-		} else if (io::isA(TeardownFormat::format(), desc, ext, magic)) {
-			return core::make_shared<TeardownFormat>();
-		} else if (io::isA(LuantiWorldEditFormat::format(), desc, ext, magic)) {
-			return core::make_shared<LuantiWorldEditFormat>();
-		} else if (io::isA(FBXFormat::format(), desc, ext, magic)) {
-			return core::make_shared<FBXFormat>();
-		} else if (io::isA(Autodesk3DSFormat::format(), desc, ext, magic)) {
-			return core::make_shared<Autodesk3DSFormat>();
-		} else if (io::isA(MDLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<MDLFormat>();
-		} else if (io::isA(MD2Format::format(), desc, ext, magic)) {
-			return core::make_shared<MD2Format>();
-		} else if (io::isA(MD3Format::format(), desc, ext, magic)) {
-			return core::make_shared<MD3Format>();
-		} else if (io::isA(SchematicFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SchematicFormat>();
-		} else if (io::isA(VBXFormat::format(), desc, ext, magic)) {
-			return core::make_shared<VBXFormat>();
-		} else if (io::isA(XRawFormat::format(), desc, ext, magic)) {
-			return core::make_shared<XRawFormat>();
-		} else if (io::isA(V3AFormat::format(), desc, ext, magic)) {
-			return core::make_shared<V3AFormat>();
-		} else if (io::isA(PCubesFormat::format(), desc, ext, magic)) {
-			return core::make_shared<PCubesFormat>();
-		} else if (io::isA(CubzhFormat::format(), desc, ext, magic)) {
-			return core::make_shared<CubzhFormat>();
-		} else if (io::isA(CubzhB64Format::format(), desc, ext, magic)) {
-			return core::make_shared<CubzhB64Format>();
-		} else if (io::isA(AsepriteFormat::format(), desc, ext, magic)) {
-			return core::make_shared<AsepriteFormat>();
-		} else if (io::isA(ThingFormat::format(), desc, ext, magic)) {
-			return core::make_shared<ThingFormat>();
-		} else if (io::isA(io::format::png(), desc, ext, magic)) {
-			return core::make_shared<PNGFormat>();
-		} else if (io::isA(GodotSceneFormat::format(), desc, ext, magic)) {
-			return core::make_shared<GodotSceneFormat>();
-		} else if (io::isA(KenShapeFormat::format(), desc, ext, magic)) {
-			return core::make_shared<KenShapeFormat>();
-		} else if (io::isA(GLTFFormat::format(), desc, ext, magic)) {
-			return core::make_shared<GLTFFormat>();
-		} else if (io::isA(SpriteStackFormat::format(), desc, ext, magic)) {
-			return core::make_shared<SpriteStackFormat>();
-		} else if (io::isA(BenVoxelFormat::format(), desc, ext, magic)) {
-			return core::make_shared<BenVoxelFormat>();
-		} else if (io::isA(AniVoxelFormat::format(), desc, ext, magic)) {
-			return core::make_shared<AniVoxelFormat>();
-		} else if (io::isA(GMLFormat::format(), desc, ext, magic)) {
-			return core::make_shared<GMLFormat>();
-		} else if (io::isA(OSMFormat::format(), desc, ext, magic)) {
-			return core::make_shared<OSMFormat>();
+using FormatFactory = core::SharedPtr<Format> (*)();
+
+template<class FORMAT>
+static core::SharedPtr<Format> createFormat() {
+	return core::make_shared<FORMAT>();
+}
+
+struct FormatFactoryEntry {
+	io::FormatDescription desc;
+	FormatFactory create;
+};
+
+/**
+ * @brief The format implementations for the format descriptions - if the magic bytes of a file match several
+ * entries, the first one wins
+ */
+static const FormatFactoryEntry *formatFactories() {
+	static const FormatFactoryEntry factories[] = {
+		{VENGIFormat::format(), createFormat<VENGIFormat>},
+		{QBFormat::format(), createFormat<QBFormat>},
+		{VoxFormat::format(), createFormat<VoxFormat>},
+		{SLAB6VoxFormat::format(), createFormat<SLAB6VoxFormat>},
+		{QBTFormat::format(), createFormat<QBTFormat>},
+		{KVXFormat::format(), createFormat<KVXFormat>},
+		{KV6Format::format(), createFormat<KV6Format>},
+		{SproxelFormat::format(), createFormat<SproxelFormat>},
+		{CubFormat::format(), createFormat<CubFormat>},
+		{GoxFormat::format(), createFormat<GoxFormat>},
+		{GoxTxtFormat::format(), createFormat<GoxTxtFormat>},
+		{VelorenTerrainFormat::format(), createFormat<VelorenTerrainFormat>},
+		{AnimaToonFormat::format(), createFormat<AnimaToonFormat>},
+		{MCRFormat::format(), createFormat<MCRFormat>},
+		{MTSFormat::format(), createFormat<MTSFormat>},
+		{DatFormat::format(), createFormat<DatFormat>},
+		{MCWorldFormat::format(), createFormat<MCWorldFormat>},
+		{SMFormat::format(), createFormat<SMFormat>},
+		{SMTPLFormat::format(), createFormat<SMTPLFormat>},
+		{VXMFormat::format(), createFormat<VXMFormat>},
+		{VXRFormat::format(), createFormat<VXRFormat>},
+		{VXBFormat::format(), createFormat<VXBFormat>},
+		{VMaxFormat::format(), createFormat<VMaxFormat>},
+		{BlockbenchFormat::format(), createFormat<BlockbenchFormat>},
+		{CrocotileFormat::format(), createFormat<CrocotileFormat>},
+		{VXCFormat::format(), createFormat<VXCFormat>},
+		{VXTFormat::format(), createFormat<VXTFormat>},
+		{VXLFormat::format(), createFormat<VXLFormat>},
+		{AoSVXLFormat::format(), createFormat<AoSVXLFormat>},
+		{CSMFormat::formatNVM(), createFormat<CSMFormat>},
+		{CSMFormat::format(), createFormat<CSMFormat>},
+		{BinVoxFormat::format(), createFormat<BinVoxFormat>},
+		{QEFFormat::format(), createFormat<QEFFormat>},
+		{QBCLFormat::format(), createFormat<QBCLFormat>},
+		{OBJFormat::format(), createFormat<OBJFormat>},
+		{SkinFormat::format(), createFormat<SkinFormat>},
+		{STLFormat::format(), createFormat<STLFormat>},
+		{LDrawFormat::format(), createFormat<LDrawFormat>},
+		{LXFFormat::format(), createFormat<LXFFormat>},
+		{StudioIOFormat::format(), createFormat<StudioIOFormat>},
+		{QuakeBSPFormat::formatUFOAI(), createFormat<QuakeBSPFormat>},
+		{QuakeBSPFormat::formatQuake1(), createFormat<QuakeBSPFormat>},
+		{MapFormat::format(), createFormat<MapFormat>},
+		{PLYFormat::format(), createFormat<PLYFormat>},
+		{TeardownFormat::format(), createFormat<TeardownFormat>},
+		{LuantiWorldEditFormat::format(), createFormat<LuantiWorldEditFormat>},
+		{FBXFormat::format(), createFormat<FBXFormat>},
+		{Autodesk3DSFormat::format(), createFormat<Autodesk3DSFormat>},
+		{MDLFormat::format(), createFormat<MDLFormat>},
+		{MD2Format::format(), createFormat<MD2Format>},
+		{MD3Format::format(), createFormat<MD3Format>},
+		{SchematicFormat::format(), createFormat<SchematicFormat>},
+		{VBXFormat::format(), createFormat<VBXFormat>},
+		{XRawFormat::format(), createFormat<XRawFormat>},
+		{V3AFormat::format(), createFormat<V3AFormat>},
+		{PCubesFormat::format(), createFormat<PCubesFormat>},
+		{CubzhFormat::format(), createFormat<CubzhFormat>},
+		{CubzhB64Format::format(), createFormat<CubzhB64Format>},
+		{AsepriteFormat::format(), createFormat<AsepriteFormat>},
+		{ThingFormat::format(), createFormat<ThingFormat>},
+		{io::format::png(), createFormat<PNGFormat>},
+		{GodotSceneFormat::format(), createFormat<GodotSceneFormat>},
+		{KenShapeFormat::format(), createFormat<KenShapeFormat>},
+		{GLTFFormat::format(), createFormat<GLTFFormat>},
+		{SpriteStackFormat::format(), createFormat<SpriteStackFormat>},
+		{BenVoxelFormat::format(), createFormat<BenVoxelFormat>},
+		{AniVoxelFormat::format(), createFormat<AniVoxelFormat>},
+		{GMLFormat::format(), createFormat<GMLFormat>},
+		{OSMFormat::format(), createFormat<OSMFormat>},
+		{io::FormatDescription::END, nullptr}};
+	return factories;
+}
+
+static inline uint32_t magicCode(const io::Magic &m) {
+	// same as io::isA() - the magic bytes are compared as four character code
+	const int l = m.size();
+	return FourCC(l > 0 ? m.data.u8[0] : '\0', l > 1 ? m.data.u8[1] : '\0', l > 2 ? m.data.u8[2] : '\0',
+				  l > 3 ? m.data.u8[3] : '\0');
+}
+
+/**
+ * @brief Lookup tables for the format detection and the format instantiation
+ *
+ * This replaces walking the format lists and comparing every extension of every format for each loaded file. The
+ * extensions are indexed in lower case, the magic bytes as four character code - the results are the same as the ones
+ * of @c io::getDescription() for @c voxelLoad() and the order of @c formatFactories().
+ */
+class FormatRegistry {
+private:
+	const io::FormatDescription *_load;
+	/** indices into @c voxelLoad() in ascending order */
+	core::DynamicStringMap<core::DynamicArray<int>, 257> _loadByExt;
+	/** the first entry of @c voxelLoad() with the given magic */
+	core::DynamicMap<uint32_t, int, 127> _loadByMagic;
+	/** indices into @c formatFactories() by main extension - the names of the formats are not unique */
+	core::DynamicStringMap<core::DynamicArray<int>, 257> _factoryByExt;
+	core::DynamicMap<uint32_t, int, 127> _factoryByMagic;
+
+	int firstAccepted(const core::DynamicArray<int> *indices, uint32_t magic, int best) const {
+		if (indices == nullptr) {
+			return best;
+		}
+		for (int idx : *indices) {
+			if (idx >= best) {
+				break;
+			}
+			const io::FormatDescription &desc = _load[idx];
+			if (magic > 0 && !desc.magics.empty() && !io::isA(desc, magic)) {
+				Log::debug("File doesn't have the expected magic number for %s", desc.name.c_str());
+				continue;
+			}
+			return idx;
+		}
+		return best;
+	}
+
+	const core::DynamicArray<int> *byExtension(const core::String &ext) const {
+		if (ext.empty()) {
+			return nullptr;
+		}
+		auto iter = _loadByExt.find(ext);
+		if (iter == _loadByExt.end()) {
+			return nullptr;
+		}
+		return &iter->value;
+	}
+
+public:
+	FormatRegistry() : _load(voxelLoad()) {
+		for (int i = 0; _load[i].valid(); ++i) {
+			for (const core::String &ext : _load[i].exts) {
+				const core::String &lowerExt = ext.toLower();
+				auto iter = _loadByExt.find(lowerExt);
+				if (iter == _loadByExt.end()) {
+					core::DynamicArray<int> indices;
+					indices.push_back(i);
+					_loadByExt.emplace(lowerExt, core::move(indices));
+				} else if (iter->value.back() != i) {
+					iter->value.push_back(i);
+				}
+			}
+			for (const io::Magic &m : _load[i].magics) {
+				if (!_loadByMagic.hasKey(magicCode(m))) {
+					_loadByMagic.put(magicCode(m), i);
+				}
+			}
+		}
+		const FormatFactoryEntry *factories = formatFactories();
+		for (int i = 0; factories[i].desc.valid(); ++i) {
+			const core::String &mainExt = factories[i].desc.mainExtension();
+			auto iter = _factoryByExt.find(mainExt);
+			if (iter == _factoryByExt.end()) {
+				core::DynamicArray<int> indices;
+				indices.push_back(i);
+				_factoryByExt.emplace(mainExt, core::move(indices));
+			} else {
+				iter->value.push_back(i);
+			}
+			for (const io::Magic &m : factories[i].desc.magics) {
+				if (!_factoryByMagic.hasKey(magicCode(m))) {
+					_factoryByMagic.put(magicCode(m), i);
+				}
+			}
+		}
+	}
+
+	const io::FormatDescription *description(const core::String &filename, uint32_t magic) const {
+		const core::String &ext = core::string::extractExtension(filename).toLower();
+		const core::String &extFull = core::string::extractAllExtensions(filename).toLower();
+		// both lists are sorted - the first format in the load list that matches one of the extensions wins
+		int best = firstAccepted(byExtension(ext), magic, INT32_MAX);
+		if (extFull != ext) {
+			best = firstAccepted(byExtension(extFull), magic, best);
+		}
+		if (best != INT32_MAX) {
+			Log::debug("Found format %s for file %s", _load[best].name.c_str(), filename.c_str());
+			return &_load[best];
+		}
+		int idx;
+		if (magic > 0 && _loadByMagic.get(magic, idx)) {
+			return &_load[idx];
+		}
+		if (extFull.empty()) {
+			Log::debug("Could not identify the format");
 		} else {
-			Log::warn("Unknown extension %s", ext.c_str());
+			Log::debug("Could not find a supported format description for '%s' ('%s')", extFull.c_str(),
+					   filename.c_str());
 		}
+		return nullptr;
+	}
+
+	const io::FormatDescription *description(const io::FileDescription &fileDesc, uint32_t magic) const {
+		if (fileDesc.desc.valid()) {
+			return &fileDesc.desc;
+		}
+		return description(fileDesc.name, magic);
+	}
+
+	/**
+	 * @return The index into @c formatFactories() or @c -1 if no format implementation was found
+	 */
+	int factory(const io::FormatDescription &desc, uint32_t magic) const {
+		int idx = -1;
+		if (magic != 0u) {
+			_factoryByMagic.get(magic, idx);
+		}
+		// the same as io::isA() - the extension must be the main extension of a format with the same name
+		const FormatFactoryEntry *factories = formatFactories();
+		for (const core::String &ext : desc.exts) {
+			auto iter = _factoryByExt.find(ext);
+			if (iter == _factoryByExt.end()) {
+				continue;
+			}
+			for (int i : iter->value) {
+				if (idx != -1 && i >= idx) {
+					break;
+				}
+				if (factories[i].desc.name == desc.name) {
+					idx = i;
+					break;
+				}
+			}
+		}
+		return idx;
+	}
+};
+
+static const FormatRegistry &formatRegistry() {
+	static const FormatRegistry registry;
+	return registry;
+}
+
+const io::FormatDescription *findLoadFormat(const core::String &filename, uint32_t magic) {
+	return formatRegistry().description(filename, magic);
+}
+
+static core::SharedPtr<Format> getFormat(const io::FormatDescription &desc, uint32_t magic) {
+	const int idx = formatRegistry().factory(desc, magic);
+	if (idx == -1) {
+		Log::warn("Unknown extension %s", desc.mainExtension().c_str());
+		return {};
 	}
-	return {};
+	return formatFactories()[idx].create();
 }
 
-static uint32_t loadMagic(const core::String &filename, const io::ArchivePtr &archive) {
-	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
-	if (!stream) {
+/**
+ * @brief Open the given file and read the magic bytes
+ * @return The opened stream or @c nullptr if the file couldn't get opened - the caller takes the ownership
+ */
+static io::SeekableReadStream *sniffFile(const core::String &filename, const io::ArchivePtr &archive,
+										  uint32_t &magic) {
+	io::SeekableReadStream *stream = archive->readStream(filename);
+	if (stream == nullptr) {
 		Log::warn("Failed to open file at %s", filename.c_str());
-		return false;
+		magic = 0u;
+		return nullptr;
+	}
+	magic = loadMagic(*stream);
+	return stream;
+}
+
+/**
+ * @brief Wrap the archive to hand out the already opened stream to the format implementation instead of opening the
+ * file again
+ */
+static io::ArchivePtr sniffedArchive(const io::ArchivePtr &archive, const core::String &filename,
+									 io::SeekableReadStream *stream) {
+	if (stream == nullptr) {
+		return archive;
 	}
-	const uint32_t magic = loadMagic(*stream);
-	return magic;
+	return core::make_shared<io::SniffedStreamArchive>(archive, filename, stream);
 }
 
 image::ImagePtr loadScreenshot(const core::String &filename, const io::ArchivePtr &archive, const LoadContext &ctx) {
 	core_trace_scoped(LoadVolumeScreenshot);
-	const uint32_t magic = loadMagic(filename, archive);
+	uint32_t magic;
+	io::SeekableReadStream *stream = sniffFile(filename, archive, magic);
+	const io::ArchivePtr &loadArchive = sniffedArchive(archive, filename, stream);
 
-	const io::FormatDescription *desc = io::getDescription(filename, magic, voxelLoad());
+	const io::FormatDescription *desc = formatRegistry().description(filename, magic);
 	if (desc == nullptr) {
 		Log::warn("Format %s isn't supported for loading screenshots", filename.c_str());
 		return image::ImagePtr();
@@ -364,7 +507,7 @@ image::ImagePtr loadScreenshot(const core::String &filename, const io::ArchivePt
 	}
 	const core::SharedPtr<Format> &f = getFormat(*desc, magic);
 	if (f) {
-		return f->loadScreenshot(filename, archive, ctx);
+		return f->loadScreenshot(filename, loadArchive, ctx);
 	}
 	Log::error("Failed to load model screenshot from file %s - "
 			   "unsupported file format",
@@ -392,8 +535,10 @@ bool importPalette(const core::String &filename, palette::Palette &palette) {
 size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 				   const LoadContext &ctx) {
 	core_trace_scoped(LoadVolumePalette);
-	const uint32_t magic = loadMagic(filename, archive);
-	const io::FormatDescription *desc = io::getDescription(filename, magic, voxelLoad());
+	uint32_t magic;
+	io::SeekableReadStream *stream = sniffFile(filename, archive, magic);
+	const io::ArchivePtr &loadArchive = sniffedArchive(archive, filename, stream);
+	const io::FormatDescription *desc = formatRegistry().description(filename, magic);
 	if (desc == nullptr) {
 		Log::warn("Format %s isn't supported", filename.c_str());
 		return 0;
@@ -401,7 +546,7 @@ size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive,
 	palette.setName(desc->name);
 	palette.setFilename(filename);
 	if (const core::SharedPtr<Format> &f = getFormat(*desc, magic)) {
-		const size_t n = f->loadPalette(filename, archive, palette, ctx);
+		const size_t n = f->loadPalette(filename, loadArchive, palette, ctx);
 		palette.markDirty();
 		return n;
 	}
@@ -411,11 +556,32 @@ size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive,
 	return 0;
 }
 
+bool loadMetadata(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, FormatMetadata &metadata,
+				  const LoadContext &ctx) {
+	core_trace_scoped(LoadVolumeMetadata);
+	uint32_t magic;
+	io::SeekableReadStream *stream = sniffFile(fileDesc.name, archive, magic);
+	const io::ArchivePtr &loadArchive = sniffedArchive(archive, fileDesc.name, stream);
+	const io::FormatDescription *desc = formatRegistry().description(fileDesc, magic);
+	if (desc == nullptr) {
+		Log::warn("Format %s isn't supported", fileDesc.name.c_str());
+		return false;
+	}
+	if (const core::SharedPtr<Format> &f = getFormat(*desc, magic)) {
+		return f->loadMetadata(fileDesc.name, loadArchive, metadata, ctx);
+	}
+	Log::error("Failed to load the metadata from file %s - unsupported file format", fileDesc.name.c_str());
+	return false;
+}
+
 bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive,
 				scenegraph::SceneGraph &newSceneGraph, const LoadContext &ctx) {
 	core_trace_scoped(LoadVolumeFormat);
-	const uint32_t magic = loadMagic(fileDesc.name, archive);
-	const io::FormatDescription *desc = io::getDescription(fileDesc, magic, voxelLoad());
+	core_memory_scoped(FormatLoad);
+	uint32_t magic;
+	io::SeekableReadStream *stream = sniffFile(fileDesc.name, archive, magic);
+	const io::ArchivePtr &loadArchive = sniffedArchive(archive, fileDesc.name, stream);
+	const io::FormatDescription *desc = formatRegistry().description(fileDesc, magic);
 	if (desc == nullptr) {
 		return false;
 	}
@@ -426,7 +592,7 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 	ctx.setProgress(0.0f);
 	const core::SharedPtr<Format> &f = getFormat(*desc, magic);
 	if (f) {
-		if (!f->load(filename, archive, newSceneGraph, ctx)) {
+		if (!f->load(filename, loadArchive, newSceneGraph, ctx)) {
 			Log::error("Error while loading %s", filename.c_str());
 			newSceneGraph.clear();
 		}
@@ -497,13 +663,16 @@ bool isModelFormat(const core::String &filename) {
 
 bool saveFormat(scenegraph::SceneGraph &sceneGraph, const core::String &filename, const io::FormatDescription *desc,
 				const io::ArchivePtr &archive, const SaveContext &ctx) {
+	core_memory_scoped(FormatSave);
 	if (sceneGraph.empty()) {
 		Log::error("Failed to save model file %s - no volumes given", filename.c_str());
 		return false;
 	}
 	const core::String &ext = core::string::extractExtension(filename);
+	// multi part extensions like ben.json
+	const core::String &extFull = core::string::extractAllExtensions(core::string::extractFilenameWithExtension(filename));
 	if (desc) {
-		if (!desc->matchesExtension(ext)) {
+		if (!desc->matchesExtension(ext) && !desc->matchesExtension(extFull)) {
 			desc = nullptr;
 		}
 	}
@@ -528,7 +697,7 @@ bool saveFormat(scenegraph::SceneGraph &sceneGraph, const core::String &filename
 		}
 	}
 	for (desc = voxelformat::voxelSave(); desc->valid(); ++desc) {
-		if (!desc->matchesExtension(ext)) {
+		if (!desc->matchesExtension(ext) && !desc->matchesExtension(extFull)) {
 			continue;
 		}
 		core::SharedPtr<Format> f = getFormat(*desc, 0u);
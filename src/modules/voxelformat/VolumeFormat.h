@@ -19,6 +19,12 @@ const io::FormatDescription *voxelFormats();
 const io::FormatDescription *voxelLoad();
 const io::FormatDescription *voxelSave();
 
+/**
+ * @brief Detect the format of the given file for loading by the extension and the magic bytes
+ * @note This is a lookup in precomputed tables - the result is the same as @c io::getDescription() for @c voxelLoad()
+ */
+const io::FormatDescription *findLoadFormat(const core::String &filename, uint32_t magic);
+
 /**
  * @brief Tries to load a palette from the given file. This can either be an image which is reduced to 256 colors or a
  * volume format with an embedded palette
@@ -31,6 +37,13 @@ bool importPalette(const core::String &filename, palette::Palette &palette);
 size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 				   const LoadContext &ctx);
 image::ImagePtr loadScreenshot(const core::String &filename, const io::ArchivePtr &archive, const LoadContext &ctx);
+/**
+ * @brief Load the amount of nodes, the scene dimensions and the palette of the given file without loading the voxels
+ * if the format supports it
+ * @sa Format::loadMetadata()
+ */
+bool loadMetadata(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, FormatMetadata &metadata,
+				  const LoadContext &ctx);
 bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 				const LoadContext &ctx);
 
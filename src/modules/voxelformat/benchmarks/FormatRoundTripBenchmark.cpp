@@ -0,0 +1,245 @@
+/**
+ * @file
+ * @brief Saves and loads a synthetic scene with every format that supports saving
+ *
+ * The benchmarks are registered at runtime - one per format. The generated scene is given by the benchmark arguments
+ * size (edge length of each node volume), nodes, fill (percentage of solid voxels) and colors (palette size). Use
+ * @c --scene=size,nodes,fill,colors (can be given multiple times) to replace the default scenes and the google
+ * benchmark options to get results that can be compared between builds:
+ *
+ * @code
+ * vengi-benchmarks-voxelformat --benchmark_filter=FormatRoundTrip --scene=128,4,20,64 --benchmark_out=formats.json --benchmark_out_format=json
+ * @endcode
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "app/system/System.h"
+#include "color/RGBA.h"
+#include "core/ScopedPtr.h"
+#include "core/StringUtil.h"
+#include "core/collection/DynamicArray.h"
+#include "core/TimeProvider.h"
+#include "core/concurrent/Concurrency.h"
+#include "io/FormatDescription.h"
+#include "io/MemoryArchive.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/Format.h"
+#include "voxelformat/FormatConfig.h"
+#include "voxelformat/VolumeFormat.h"
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+/**
+ * @brief The parameters of the generated scene - these are the benchmark arguments
+ */
+struct SceneConfig {
+	/** the edge length of the volume of each node */
+	int size;
+	int nodes;
+	/** the percentage of solid voxels */
+	int fill;
+	int paletteColors;
+};
+
+// many small nodes and one bigger sparse volume - keep them small enough to run all formats in a few minutes
+const SceneConfig DefaultSceneConfigs[] = {{16, 32, 50, 16}, {64, 1, 30, 255}};
+
+/**
+ * @brief Parse the scene configuration of a @c --scene=size,nodes,fill,colors argument
+ */
+bool parseSceneConfig(const char *arg, SceneConfig &config) {
+	core::DynamicArray<core::String> tokens;
+	core::string::splitString(arg, tokens, ",");
+	if (tokens.size() != 4) {
+		return false;
+	}
+	config.size = tokens[0].toInt();
+	config.nodes = tokens[1].toInt();
+	config.fill = tokens[2].toInt();
+	config.paletteColors = tokens[3].toInt();
+	return config.size > 0 && config.nodes > 0 && config.fill >= 0 && config.fill <= 100 &&
+		   config.paletteColors > 0 && config.paletteColors <= palette::PaletteMaxColors;
+}
+
+inline uint32_t hash(int x, int y, int z, int node) {
+	uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u ^ (uint32_t)z * 83492791u ^ (uint32_t)node * 2654435761u;
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return h;
+}
+
+class FormatRoundTripBenchmark : public app::AbstractBenchmark {
+private:
+	using Super = app::AbstractBenchmark;
+
+	const io::FormatDescription &_desc;
+	scenegraph::SceneGraph _sceneGraph;
+	int64_t _voxels = 0;
+
+	void createScene(const SceneConfig &config) {
+		palette::Palette palette;
+		palette.setSize(config.paletteColors);
+		for (int i = 0; i < config.paletteColors; ++i) {
+			const uint32_t h = hash(i, 0, 0, 0);
+			palette.setColor(i, color::RGBA(h & 0xFF, (h >> 8) & 0xFF, (h >> 16) & 0xFF, 255));
+		}
+		const voxel::Region region(0, config.size - 1);
+		for (int n = 0; n < config.nodes; ++n) {
+			voxel::RawVolume *volume = new voxel::RawVolume(region);
+			for (int z = 0; z < config.size; ++z) {
+				for (int y = 0; y < config.size; ++y) {
+					for (int x = 0; x < config.size; ++x) {
+						if ((int)(hash(x, y, z, n) % 100u) >= config.fill) {
+							continue;
+						}
+						// the colors form small blocks - like real models do
+						const int color = (x / 4 + y / 4 + z / 4 + n) % config.paletteColors;
+						volume->setVoxel(x, y, z, voxel::createVoxel(palette, color));
+						++_voxels;
+					}
+				}
+			}
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.setVolume(volume);
+			node.setPalette(palette);
+			node.setName(core::String::format("node%i", n));
+			_sceneGraph.emplace(core::move(node));
+		}
+	}
+
+public:
+	FormatRoundTripBenchmark(const io::FormatDescription &desc) : Super(core::cpus()), _desc(desc) {
+		core::String name =
+			core::String::format("FormatRoundTrip/%s/%s", desc.mainExtension().c_str(), desc.name.c_str());
+		core::string::replaceAllChars(name, ' ', '_');
+		SetName(name.c_str());
+		Unit(benchmark::kMillisecond);
+		// the iteration time is only the time of saving and loading - see BenchmarkCase()
+		UseManualTime();
+	}
+
+	void SetUp(::benchmark::State &state) override {
+		Super::SetUp(state);
+		voxelformat::FormatConfig::init();
+		_voxels = 0;
+		SceneConfig config;
+		config.size = (int)state.range(0);
+		config.nodes = (int)state.range(1);
+		config.fill = (int)state.range(2);
+		config.paletteColors = (int)state.range(3);
+		createScene(config);
+		resetMemoryCounters();
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_sceneGraph.clear();
+		Super::TearDown(state);
+	}
+
+	void BenchmarkCase(benchmark::State &state) override {
+		const core::String filename = "benchmark." + _desc.mainExtension();
+		const bool load = (_desc.flags & FORMAT_FLAG_NO_LOAD) == 0;
+		const double rssStart = app::systemProcessMemoryGB();
+		double rssMax = rssStart;
+		uint64_t saveTicks = 0u;
+		uint64_t loadTicks = 0u;
+		int64_t outputSize = 0;
+		voxelformat::SaveContext saveCtx;
+		voxelformat::LoadContext loadCtx;
+		const double resolution = (double)core::TimeProvider::highResTimeResolution();
+		for (auto _ : state) {
+			io::MemoryArchivePtr archive = io::openMemoryArchive();
+			const uint64_t saveStart = core::TimeProvider::highResTime();
+			if (!voxelformat::saveFormat(_sceneGraph, filename, &_desc, archive, saveCtx)) {
+				state.SkipWithError("Failed to save the scene");
+				return;
+			}
+			const uint64_t iterationSaveTicks = core::TimeProvider::highResTime() - saveStart;
+			saveTicks += iterationSaveTicks;
+			rssMax = core_max(rssMax, app::systemProcessMemoryGB());
+			core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+			outputSize = stream ? stream->size() : 0;
+			if (!load) {
+				state.SetIterationTime((double)iterationSaveTicks / resolution);
+				continue;
+			}
+			scenegraph::SceneGraph sceneGraph;
+			io::FileDescription fileDesc;
+			fileDesc.set(filename, &_desc);
+			const uint64_t loadStart = core::TimeProvider::highResTime();
+			if (!voxelformat::loadFormat(fileDesc, archive, sceneGraph, loadCtx)) {
+				state.SkipWithError("Failed to load the scene");
+				return;
+			}
+			const uint64_t iterationLoadTicks = core::TimeProvider::highResTime() - loadStart;
+			loadTicks += iterationLoadTicks;
+			rssMax = core_max(rssMax, app::systemProcessMemoryGB());
+			state.SetIterationTime((double)(iterationSaveTicks + iterationLoadTicks) / resolution);
+		}
+		const double iterations = (double)state.iterations();
+		const double saveSeconds = (double)saveTicks / resolution;
+		const double loadSeconds = (double)loadTicks / resolution;
+		state.counters["voxels"] = (double)_voxels;
+		state.counters["save_ms"] = saveSeconds * 1000.0 / iterations;
+		state.counters["save_voxels_per_s"] = saveSeconds > 0.0 ? (double)_voxels * iterations / saveSeconds : 0.0;
+		if (load) {
+			state.counters["load_ms"] = loadSeconds * 1000.0 / iterations;
+			state.counters["load_voxels_per_s"] = loadSeconds > 0.0 ? (double)_voxels * iterations / loadSeconds : 0.0;
+		}
+		state.counters["output_bytes"] = (double)outputSize;
+		// sampled after each phase - the growth of the resident set of the process
+		state.counters["rss_growth_mib"] = (rssMax - rssStart) * 1024.0;
+	}
+};
+
+void registerFormatRoundTripBenchmarks(const core::DynamicArray<SceneConfig> &configs) {
+	for (const io::FormatDescription *desc = voxelformat::voxelSave(); desc->valid(); ++desc) {
+		benchmark::Benchmark *bench =
+			benchmark::internal::RegisterBenchmarkInternal(std::make_unique<FormatRoundTripBenchmark>(*desc));
+		bench->ArgNames({"size", "nodes", "fill", "colors"});
+		for (const SceneConfig &config : configs) {
+			bench->Args({config.size, config.nodes, config.fill, config.paletteColors});
+		}
+	}
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	benchmark::Initialize(&argc, argv);
+	// the scene arguments are removed before the remaining arguments are checked
+	core::DynamicArray<SceneConfig> configs;
+	int remaining = 1;
+	for (int i = 1; i < argc; ++i) {
+		if (strncmp(argv[i], "--scene=", 8) != 0) {
+			argv[remaining++] = argv[i];
+			continue;
+		}
+		SceneConfig config;
+		if (!parseSceneConfig(argv[i] + 8, config)) {
+			fprintf(stderr, "Invalid scene %s - expected --scene=size,nodes,fill,colors\n", argv[i] + 8);
+			return 1;
+		}
+		configs.push_back(config);
+	}
+	argc = remaining;
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	if (configs.empty()) {
+		for (const SceneConfig &config : DefaultSceneConfigs) {
+			configs.push_back(config);
+		}
+	}
+	registerFormatRoundTripBenchmarks(configs);
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
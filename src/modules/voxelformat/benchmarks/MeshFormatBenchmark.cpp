@@ -3,14 +3,23 @@
  */
 
 #include "app/benchmark/AbstractBenchmark.h"
+#include "core/ConfigVar.h"
+#include "core/MemoryAccounting.h"
+#include "core/Var.h"
+#include "io/Filesystem.h"
 #include "io/FilesystemArchive.h"
+#include "io/MemoryArchive.h"
+#include "palette/Palette.h"
 #include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
 #include "voxelformat/Format.h"
 #include "voxelformat/FormatConfig.h"
 #include "voxelformat/private/mesh/FBXFormat.h"
 #include "voxelformat/private/mesh/GLTFFormat.h"
 #include "voxelformat/private/mesh/MeshFormat.h"
 #include "voxelformat/private/mesh/MeshMaterial.h"
+#include "voxelformat/private/mesh/OBJFormat.h"
 
 class MeshFormatBenchmark : public app::AbstractBenchmark {
 private:
@@ -55,6 +64,95 @@ protected:
 		_archive = io::openFilesystemArchive(_benchmarkApp->filesystem());
 		voxelformat::FormatConfig::init();
 	}
+
+	/**
+	 * @brief One model node and @c references model reference nodes of it - this is what the user gets when placing
+	 * the same prop over and over again in a scene
+	 */
+	void createInstancedScene(scenegraph::SceneGraph &sceneGraph, voxel::RawVolume &volume, int references) {
+		palette::Palette pal;
+		pal.nippon();
+		const voxel::Region &region = volume.region();
+		const glm::ivec3 &center = region.getCenter();
+		const int radius = region.getWidthInVoxels() / 2;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					const glm::ivec3 delta = glm::ivec3(x, y, z) - center;
+					if (delta.x * delta.x + delta.y * delta.y + delta.z * delta.z <= radius * radius) {
+						volume.setVoxel(x, y, z, voxel::createVoxel(pal, 1 + (x + y + z) % 8));
+					}
+				}
+			}
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setUnownedVolume(&volume);
+		node.setPalette(pal);
+		const int modelNodeId = sceneGraph.emplace(core::move(node));
+		for (int i = 0; i < references; ++i) {
+			scenegraph::SceneGraphNode refNode(scenegraph::SceneGraphNodeType::ModelReference);
+			refNode.setReference(sceneGraph.node(modelNodeId));
+			refNode.setPalette(pal);
+			scenegraph::SceneGraphTransform transform;
+			transform.setWorldTranslation(glm::vec3((i % 16) * 40, 0, (i / 16) * 40));
+			refNode.setTransform(0, transform);
+			sceneGraph.emplace(core::move(refNode));
+		}
+		sceneGraph.updateTransforms();
+	}
+
+	/**
+	 * @brief Scene with @c models different models - no instancing possible
+	 */
+	void createScene(scenegraph::SceneGraph &sceneGraph, int models, int size) {
+		palette::Palette pal;
+		pal.nippon();
+		for (int i = 0; i < models; ++i) {
+			voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, size - 1));
+			const voxel::Region &region = volume->region();
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+					for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+						// a different pattern per model with a lot of faces
+						if (((x * 7 + y * 13 + z * 3 + i) % 5) < 2) {
+							volume->setVoxel(x, y, z, voxel::createVoxel(pal, 1 + (x + y + z + i) % 16));
+						}
+					}
+				}
+			}
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.setVolume(volume);
+			node.setPalette(pal);
+			scenegraph::SceneGraphTransform transform;
+			transform.setWorldTranslation(glm::vec3((i % 8) * size, 0, (i / 8) * size));
+			node.setTransform(0, transform);
+			sceneGraph.emplace(core::move(node));
+		}
+		sceneGraph.updateTransforms();
+	}
+
+	void saveInstanced(benchmark::State &state, voxelformat::Format &format, const core::String &filename) {
+		scenegraph::SceneGraph sceneGraph;
+		voxel::RawVolume volume(voxel::Region(0, 31));
+		createInstancedScene(sceneGraph, volume, (int)state.range(0));
+		voxelformat::SaveContext saveCtx;
+		int64_t bytes = 0;
+		for (auto _ : state) {
+			io::MemoryArchivePtr archive = io::openMemoryArchive();
+			if (!format.save(sceneGraph, filename, archive, saveCtx)) {
+				state.SkipWithError("Failed to save the scene");
+				return;
+			}
+			io::ArchiveFiles files;
+			archive->list("", files, "");
+			bytes = 0;
+			for (const io::FilesystemEntry &entry : files) {
+				bytes += (int64_t)entry.size;
+			}
+		}
+		state.counters["nodes"] = (double)sceneGraph.size(scenegraph::SceneGraphNodeType::AllModels);
+		state.counters["file_kb"] = (double)bytes / 1024.0;
+	}
 };
 
 BENCHMARK_DEFINE_F(MeshFormatBenchmark, GLTF)(benchmark::State &state) {
@@ -104,10 +202,56 @@ BENCHMARK_DEFINE_F(MeshFormatBenchmark, transformTrisAxisAligned)(benchmark::Sta
 	}
 }
 
+BENCHMARK_DEFINE_F(MeshFormatBenchmark, SaveInstancedGLTF)(benchmark::State &state) {
+	voxelformat::GLTFFormat f;
+	saveInstanced(state, f, "instanced.gltf");
+}
+
+BENCHMARK_DEFINE_F(MeshFormatBenchmark, SaveInstancedOBJ)(benchmark::State &state) {
+	voxelformat::OBJFormat f;
+	saveInstanced(state, f, "instanced.obj");
+}
+
+// the peak heap counters only include the saving - not the scene
+BENCHMARK_DEFINE_F(MeshFormatBenchmark, SaveGLB)(benchmark::State &state) {
+	core::getVar(cfg::VoxformatGLTFStreaming)->setVal(state.range(0) != 0);
+	scenegraph::SceneGraph sceneGraph;
+	createScene(sceneGraph, 16, 32);
+	voxelformat::SaveContext saveCtx;
+	voxelformat::GLTFFormat f;
+	// write into a file - a memory archive would keep the whole output in memory
+	const core::String filename = _benchmarkApp->filesystem()->homeWritePath("benchmark-savescene.glb");
+	resetMemoryCounters();
+	int64_t peakBytes = 0;
+	int64_t meshPeakBytes = 0;
+	const int meshTag = core::memoryTagId("Mesh");
+	for (auto _ : state) {
+		core::MemoryStats before;
+		core::memoryStats(before);
+		core::memoryResetPeak();
+		if (!f.save(sceneGraph, filename, _archive, saveCtx)) {
+			state.SkipWithError("Failed to save the scene");
+			break;
+		}
+		core::MemoryStats after;
+		core::memoryStats(after);
+		peakBytes = core_max(peakBytes, after.total.peakBytes - before.total.liveBytes());
+		if (meshTag < (int)before.tags.size() && meshTag < (int)after.tags.size()) {
+			meshPeakBytes =
+				core_max(meshPeakBytes, after.tags[meshTag].peakBytes - before.tags[meshTag].liveBytes());
+		}
+	}
+	state.counters["save_peak_heap_mib"] = (double)peakBytes / (1024.0 * 1024.0);
+	state.counters["save_peak_mesh_mib"] = (double)meshPeakBytes / (1024.0 * 1024.0);
+	io::Filesystem::sysRemoveFile(filename);
+	core::getVar(cfg::VoxformatGLTFStreaming)->setVal(true);
+}
+
 BENCHMARK_REGISTER_F(MeshFormatBenchmark, GLTF);
 BENCHMARK_REGISTER_F(MeshFormatBenchmark, FBX);
 BENCHMARK_REGISTER_F(MeshFormatBenchmark, voxelizePointCloud);
 BENCHMARK_REGISTER_F(MeshFormatBenchmark, transformTris);
 BENCHMARK_REGISTER_F(MeshFormatBenchmark, transformTrisAxisAligned);
-
-BENCHMARK_MAIN();
+BENCHMARK_REGISTER_F(MeshFormatBenchmark, SaveInstancedGLTF)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MeshFormatBenchmark, SaveInstancedOBJ)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MeshFormatBenchmark, SaveGLB)->ArgName("streaming")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,141 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ScopedPtr.h"
+#include "core/StringUtil.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/FilesystemArchive.h"
+#include "io/MemoryReadStream.h"
+#include "io/ZipReadStream.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxelformat/Format.h"
+#include "voxelformat/FormatConfig.h"
+#include "voxelformat/private/minecraft/NamedBinaryTag.h"
+#include "voxelformat/private/minecraft/NamedBinaryTagView.h"
+#include "voxelformat/private/minecraft/SchematicFormat.h"
+
+namespace voxelformat {
+
+/**
+ * @brief Compares building the full nbt tree with the lazy view
+ *
+ * The first argument selects the data: @c 0 is a synthetic sponge schematic like structure with a large palette and a
+ * lot of block entities that the loaders are not interested in, @c 1 is the inflated nbt data of a real litematic
+ * file. The allocation counters of @c app::AbstractBenchmark only include the parsing - not the preparation of the
+ * data.
+ */
+class NamedBinaryTagBenchmark : public app::AbstractBenchmark {
+private:
+	using Super = app::AbstractBenchmark;
+
+	void createSynthetic() {
+		priv::NBTCompound compound;
+		compound.put("Width", priv::NamedBinaryTag((int16_t)256));
+		compound.put("Height", priv::NamedBinaryTag((int16_t)64));
+		compound.put("Length", priv::NamedBinaryTag((int16_t)256));
+		priv::NBTCompound palette;
+		for (int i = 0; i < 2048; ++i) {
+			palette.put(core::String::format("minecraft:block_%i[facing=north]", i), priv::NamedBinaryTag((int32_t)i));
+		}
+		compound.put("Palette", priv::NamedBinaryTag(core::move(palette)));
+		priv::NBTList blockEntities;
+		for (int i = 0; i < 20000; ++i) {
+			priv::NBTCompound entity;
+			entity.put("Id", priv::NamedBinaryTag(core::String("minecraft:chest")));
+			entity.put("Pos", priv::NamedBinaryTag((int64_t)i));
+			entity.put("CustomName", priv::NamedBinaryTag(core::String::format("Chest %i", i)));
+			blockEntities.push_back(priv::NamedBinaryTag(core::move(entity)));
+		}
+		compound.put("BlockEntities", priv::NamedBinaryTag(core::move(blockEntities)));
+		core::Buffer<int8_t> blockData;
+		blockData.resize(256 * 64 * 256);
+		for (size_t i = 0; i < blockData.size(); ++i) {
+			blockData[i] = (int8_t)(i % 127);
+		}
+		compound.put("BlockData", priv::NamedBinaryTag(core::move(blockData)));
+		const priv::NamedBinaryTag root(core::move(compound));
+		priv::NamedBinaryTag::write(root, "Schematic", _stream);
+	}
+
+	bool inflate(const core::String &filename) {
+		core::ScopedPtr<io::SeekableReadStream> stream(_archive->readStream(filename));
+		if (!stream) {
+			return false;
+		}
+		io::ZipReadStream zipStream(*stream);
+		return _stream.writeStream(zipStream);
+	}
+
+protected:
+	io::ArchivePtr _archive;
+	io::BufferedReadWriteStream _stream;
+
+	void SetUp(::benchmark::State &state) override {
+		Super::SetUp(state);
+		_archive = io::openFilesystemArchive(_benchmarkApp->filesystem());
+		voxelformat::FormatConfig::init();
+		_stream.reset();
+		if (state.range(0) == 0) {
+			createSynthetic();
+		} else if (!inflate("test.litematic")) {
+			state.SkipWithError("Failed to load test.litematic");
+		}
+		resetMemoryCounters();
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_archive = io::ArchivePtr();
+		Super::TearDown(state);
+	}
+
+	/**
+	 * @brief Look up the keys that the loaders need - the width or the litematic regions and their block states
+	 */
+	template<class Tag>
+	static void lookup(const Tag &root) {
+		int width = root.get("Width").int16();
+		benchmark::DoNotOptimize(width);
+		auto blockData = root.get("BlockData").byteArray();
+		benchmark::DoNotOptimize(blockData);
+		size_t regions = root.get("Regions").valid() ? 1u : 0u;
+		benchmark::DoNotOptimize(regions);
+	}
+};
+
+BENCHMARK_DEFINE_F(NamedBinaryTagBenchmark, ParseTree)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::MemoryReadStream stream(_stream.getBuffer(), _stream.size());
+		priv::NamedBinaryTagContext ctx;
+		ctx.stream = &stream;
+		const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
+		lookup(root);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * _stream.size());
+}
+
+BENCHMARK_DEFINE_F(NamedBinaryTagBenchmark, View)(benchmark::State &state) {
+	for (auto _ : state) {
+		const priv::NamedBinaryTagView root = priv::NamedBinaryTagView::parse(_stream.getBuffer(), _stream.size());
+		lookup(root);
+	}
+	state.SetBytesProcessed((int64_t)state.iterations() * _stream.size());
+}
+
+// the complete litematic loader on top of the view - including the inflating of the file
+BENCHMARK_DEFINE_F(NamedBinaryTagBenchmark, LoadLitematic)(benchmark::State &state) {
+	LoadContext ctx;
+	for (auto _ : state) {
+		scenegraph::SceneGraph sceneGraph;
+		SchematicFormat format;
+		bool loaded = format.load("test.litematic", _archive, sceneGraph, ctx);
+		benchmark::DoNotOptimize(loaded);
+	}
+}
+
+BENCHMARK_REGISTER_F(NamedBinaryTagBenchmark, ParseTree)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(NamedBinaryTagBenchmark, View)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(NamedBinaryTagBenchmark, LoadLitematic)->Arg(1);
+
+} // namespace voxelformat
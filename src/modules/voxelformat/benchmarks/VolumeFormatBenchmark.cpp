@@ -3,14 +3,21 @@
  */
 
 #include "app/benchmark/AbstractBenchmark.h"
+#include "core/concurrent/Concurrency.h"
 #include "io/FilesystemArchive.h"
+#include "io/MemoryArchive.h"
 #include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
 #include "voxelformat/Format.h"
 #include "voxelformat/FormatConfig.h"
+#include "voxelformat/VolumeFormat.h"
 #include "voxelformat/private/goxel/GoxFormat.h"
+#include "voxelformat/private/magicavoxel/VoxFormat.h"
 #include "voxelformat/private/minecraft/MCRFormat.h"
 #include "voxelformat/private/qubicle/QBCLFormat.h"
 #include "voxelformat/private/qubicle/QBFormat.h"
+#include "voxelformat/private/qubicle/QBTFormat.h"
 #include "voxelformat/private/vengi/VENGIFormat.h"
 
 class VolumeFormatBenchmark : public app::AbstractBenchmark {
@@ -28,6 +35,66 @@ protected:
 	}
 };
 
+/**
+ * @brief Saves a scene with many small model nodes - the per node payloads are encoded in parallel
+ */
+class VolumeFormatSaveBenchmark : public app::AbstractBenchmark {
+private:
+	using Super = app::AbstractBenchmark;
+
+protected:
+	voxelformat::SaveContext _ctx;
+	scenegraph::SceneGraph _sceneGraph;
+	io::MemoryArchivePtr _archive;
+
+public:
+	VolumeFormatSaveBenchmark() : Super(core::cpus()) {
+	}
+
+protected:
+
+	void SetUp(::benchmark::State &state) override {
+		Super::SetUp(state);
+		_archive = io::openMemoryArchive();
+		voxelformat::FormatConfig::init();
+		const int nodes = (int)state.range(0);
+		const voxel::Region region(0, 31);
+		for (int i = 0; i < nodes; ++i) {
+			voxel::RawVolume *volume = new voxel::RawVolume(region);
+			for (int z = 0; z < 32; ++z) {
+				for (int y = 0; y < 32; ++y) {
+					for (int x = 0; x < 32; ++x) {
+						if ((x ^ y ^ z ^ i) & 1) {
+							volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + y + z + i) % 255 + 1));
+						}
+					}
+				}
+			}
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.setVolume(volume);
+			node.setName(core::String::format("node%i", i));
+			_sceneGraph.emplace(core::move(node));
+		}
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_sceneGraph.clear();
+		_archive = {};
+		Super::TearDown(state);
+	}
+
+	void save(benchmark::State &state, voxelformat::Format &format, const core::String &filename) {
+		for (auto _ : state) {
+			_archive->remove(filename);
+			if (!format.save(_sceneGraph, filename, _archive, _ctx)) {
+				state.SkipWithError("Failed to save the scene");
+				return;
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+};
+
 BENCHMARK_DEFINE_F(VolumeFormatBenchmark, chr_knight_QB)(benchmark::State &state) {
 	for (auto _ : state) {
 		voxelformat::QBFormat f;
@@ -73,8 +140,72 @@ BENCHMARK_DEFINE_F(VolumeFormatBenchmark, MCR)(benchmark::State &state) {
 	}
 }
 
+static const char *DispatchFiles[] = {"chr_knight.qb",	"chr_knight.vengi", "minecraft_110.mca", "model.vox",
+									  "model.glb",		"model.ply",		"model.vxl",		 "model.unknown"};
+
+BENCHMARK_DEFINE_F(VolumeFormatBenchmark, DispatchLinear)(benchmark::State &state) {
+	for (auto _ : state) {
+		for (const char *filename : DispatchFiles) {
+			benchmark::DoNotOptimize(io::getDescription(filename, 0u, voxelformat::voxelLoad()));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * lengthof(DispatchFiles));
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatBenchmark, DispatchRegistry)(benchmark::State &state) {
+	for (auto _ : state) {
+		for (const char *filename : DispatchFiles) {
+			benchmark::DoNotOptimize(voxelformat::findLoadFormat(filename, 0u));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * lengthof(DispatchFiles));
+}
+
+// detection and loading through the public api - the file is only opened once
+BENCHMARK_DEFINE_F(VolumeFormatBenchmark, LoadFormat_chr_knight_QB)(benchmark::State &state) {
+	io::FileDescription fileDesc;
+	fileDesc.set("chr_knight.qb");
+	for (auto _ : state) {
+		voxelformat::loadFormat(fileDesc, _archive, _sceneGraph, _ctx);
+		_sceneGraph.clear();
+	}
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatSaveBenchmark, QBT)(benchmark::State &state) {
+	voxelformat::QBTFormat f;
+	save(state, f, "save.qbt");
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatSaveBenchmark, QBCL)(benchmark::State &state) {
+	voxelformat::QBCLFormat f;
+	save(state, f, "save.qbcl");
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatSaveBenchmark, GOX)(benchmark::State &state) {
+	voxelformat::GoxFormat f;
+	save(state, f, "save.gox");
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatSaveBenchmark, VENGI)(benchmark::State &state) {
+	voxelformat::VENGIFormat f;
+	save(state, f, "save.vengi");
+}
+
+BENCHMARK_DEFINE_F(VolumeFormatSaveBenchmark, VOX)(benchmark::State &state) {
+	voxelformat::VoxFormat f;
+	save(state, f, "save.vox");
+}
+
 BENCHMARK_REGISTER_F(VolumeFormatBenchmark, chr_knight_QB);
 BENCHMARK_REGISTER_F(VolumeFormatBenchmark, chr_knight_QBCL);
 BENCHMARK_REGISTER_F(VolumeFormatBenchmark, chr_knight_GOX);
 BENCHMARK_REGISTER_F(VolumeFormatBenchmark, chr_knight_VENGI);
 BENCHMARK_REGISTER_F(VolumeFormatBenchmark, MCR);
+BENCHMARK_REGISTER_F(VolumeFormatBenchmark, DispatchLinear);
+BENCHMARK_REGISTER_F(VolumeFormatBenchmark, DispatchRegistry);
+BENCHMARK_REGISTER_F(VolumeFormatBenchmark, LoadFormat_chr_knight_QB);
+BENCHMARK_REGISTER_F(VolumeFormatSaveBenchmark, QBT)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VolumeFormatSaveBenchmark, QBCL)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VolumeFormatSaveBenchmark, GOX)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VolumeFormatSaveBenchmark, VENGI)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VolumeFormatSaveBenchmark, VOX)->Arg(256)->Unit(benchmark::kMillisecond);
@@ -473,6 +473,7 @@
     static const uint32_t k_read_scene_flags_keyframes                   = 1 << 1; // if specified, all instances and groups will contain keyframe data.
     static const uint32_t k_read_scene_flags_keep_empty_models_instances = 1 << 2; // if specified, all empty models and instances referencing those will be kept rather than culled.
     static const uint32_t k_read_scene_flags_keep_duplicate_models       = 1 << 3; // if specified, we do not de-duplicate models.
+    static const uint32_t k_read_scene_flags_skip_voxel_data             = 1 << 4; // if specified, only the sizes of the models are read - their voxel_data is NULL and models are not de-duplicated.
 
     // creates a scene from a vox file within a memory buffer of a given size.
     // you can destroy the input buffer once you have the scene as this function will allocate separate memory for the scene objecvt.
@@ -1569,7 +1570,18 @@
                     // read the number of voxels to process for this moodel
                     uint32_t num_voxels_in_chunk = 0;
                     _vox_file_read_uint32(fp, &num_voxels_in_chunk);
-                    if (num_voxels_in_chunk != 0 || (read_flags & k_read_scene_flags_keep_empty_models_instances)) {
+                    if ((num_voxels_in_chunk != 0 || (read_flags & k_read_scene_flags_keep_empty_models_instances)) && (read_flags & k_read_scene_flags_skip_voxel_data)) {
+                        ogt_vox_model * model = (ogt_vox_model*)_vox_calloc(sizeof(ogt_vox_model));
+                        if (!model)
+                            return NULL;
+                        model_ptrs.push_back(model);
+                        model->size_x = size_x;
+                        model->size_y = size_y;
+                        model->size_z = size_z;
+                        model->voxel_data = NULL;
+                        _vox_file_seek_forwards(fp, num_voxels_in_chunk * 4);
+                    }
+                    else if (num_voxels_in_chunk != 0 || (read_flags & k_read_scene_flags_keep_empty_models_instances)) {
                         uint32_t voxel_count = size_x * size_y * size_z;
                         ogt_vox_model * model = (ogt_vox_model*)_vox_calloc(sizeof(ogt_vox_model) + voxel_count);        // 1 byte for each voxel
                         if (!model)
@@ -1620,6 +1632,19 @@
                     _vox_file_read_uint32(fp, &size_z);
                     ogt_assert(size_x && size_y && size_z, "TDCZ chunk has zero size");
 
+                    if (read_flags & k_read_scene_flags_skip_voxel_data) {
+                        ogt_vox_model * model = (ogt_vox_model*)_vox_calloc(sizeof(ogt_vox_model));
+                        if (!model)
+                            return NULL;
+                        model_ptrs.push_back(model);
+                        model->size_x = size_x;
+                        model->size_y = size_y;
+                        model->size_z = size_z;
+                        model->voxel_data = NULL;
+                        _vox_file_seek_forwards(fp, _vox_min(_vox_file_bytes_remaining(fp), chunk_size - 3 * sizeof(uint32_t)));
+                        break;
+                    }
+
                     uint32_t voxel_count = size_x * size_y * size_z;
                     ogt_vox_model * model = (ogt_vox_model*)_vox_calloc(sizeof(ogt_vox_model) + voxel_count);        // 1 byte for each voxel
                     if (!model)
@@ -2286,7 +2311,7 @@
             // ensure that all models are remapped so they are using display order palette indices.
             for (uint32_t i = 0; i < model_ptrs.size(); i++) {
                 ogt_vox_model* model = model_ptrs[i];
-                if (model) {
+                if (model && model->voxel_data) {
                     uint32_t num_voxels = model->size_x * model->size_y * model->size_z;
                     uint8_t* voxels = (uint8_t*)&model[1];
                     for (uint32_t j = 0; j < num_voxels; j++)
@@ -2307,7 +2332,7 @@
         // check for models that are identical by doing a pair-wise compare. If we find identical
         // models, we'll end up with NULL gaps in the model_ptrs array, but instances will have
         // been remapped to keep the earlier model.
-        if (0 == (read_flags & k_read_scene_flags_keep_duplicate_models)) {
+        if (0 == (read_flags & (k_read_scene_flags_keep_duplicate_models | k_read_scene_flags_skip_voxel_data))) {
             for (uint32_t i = 0; i < model_ptrs.size(); i++) {
                 if (!model_ptrs[i])
                     continue;
@@ -24,6 +24,7 @@
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxelformat/FormatThumbnail.h"
+#include "voxelformat/NodeEncoder.h"
 #include "math/SDF.h"
 #include "voxelutil/VolumeCropper.h"
 #include "voxelutil/VolumeMerger.h"
@@ -1138,63 +1139,90 @@ bool GoxFormat::saveChunk_LAYR(io::SeekableWriteStream &stream, const scenegraph
 	return true;
 }
 
-bool GoxFormat::saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int &blocks) {
-	blocks = 0;
-	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
-		const scenegraph::SceneGraphNode &node = *iter;
-		const voxel::Region &region = sceneGraph.resolveRegion(node);
-		glm::ivec3 mins, maxs;
-		calcMinsMaxs(region, glm::ivec3(BlockSize), mins, maxs);
-
-		const voxel::RawVolume *vol = sceneGraph.resolveVolume(node);
-		for (int by = mins.y; by <= maxs.y; by += BlockSize) {
-			for (int bz = mins.z; bz <= maxs.z; bz += BlockSize) {
-				for (int bx = mins.x; bx <= maxs.x; bx += BlockSize) {
-					if (isEmptyBlock(vol, glm::ivec3(BlockSize), bx, by, bz)) {
-						continue;
-					}
-					GoxScopedChunkWriter scoped(stream, FourCC('B', 'L', '1', '6'));
-					const voxel::Region blockRegion(bx, by, bz, bx + BlockSize - 1, by + BlockSize - 1,
-													bz + BlockSize - 1);
-					const size_t size = (size_t)BlockSize * BlockSize * BlockSize * 4;
-					uint32_t *data = (uint32_t *)core_malloc(size);
-					core_memset(data, 0, size);
-					const palette::Palette &palette = node.palette();
-					// vengi Y-up to goxel Z-up with handedness fix:
-					// goxel data[goxZ][goxY][goxX] where goxY = -(vengiZ - bz) + (BlockSize-1)
-					auto func = [&](int x, int y, int z, const voxel::Voxel &voxel) {
-						if (voxel::isAir(voxel.getMaterial())) {
-							return;
-						}
-						const int lx = x - bx;
-						const int ly = y - by; // vengi Y = goxel Z
-						const int lz = z - bz; // vengi Z = -goxel Y
-						const int goxY = BlockSize - 1 - lz;
-						const int offset = lx + goxY * BlockSize + ly * BlockSize * BlockSize;
-						data[offset] = palette.color(voxel.getColor());
-					};
-					voxelutil::visitVolume(*vol, blockRegion, func, voxelutil::VisitAll());
-
-					image::Image image2("##");
-					if (!image2.loadRGBA((const uint8_t *)data, 64, 64)) {
-						Log::error("Could not load image data");
-						core_free(data);
-						return false;
+bool GoxFormat::saveBlocks(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+						   const scenegraph::SceneGraphNode &node, int &blocks) const {
+	const voxel::Region &region = sceneGraph.resolveRegion(node);
+	glm::ivec3 mins, maxs;
+	calcMinsMaxs(region, glm::ivec3(BlockSize), mins, maxs);
+
+	const voxel::RawVolume *vol = sceneGraph.resolveVolume(node);
+	for (int by = mins.y; by <= maxs.y; by += BlockSize) {
+		for (int bz = mins.z; bz <= maxs.z; bz += BlockSize) {
+			for (int bx = mins.x; bx <= maxs.x; bx += BlockSize) {
+				if (isEmptyBlock(vol, glm::ivec3(BlockSize), bx, by, bz)) {
+					continue;
+				}
+				GoxScopedChunkWriter scoped(stream, FourCC('B', 'L', '1', '6'));
+				const voxel::Region blockRegion(bx, by, bz, bx + BlockSize - 1, by + BlockSize - 1,
+												bz + BlockSize - 1);
+				const size_t size = (size_t)BlockSize * BlockSize * BlockSize * 4;
+				uint32_t *data = (uint32_t *)core_malloc(size);
+				core_memset(data, 0, size);
+				const palette::Palette &palette = node.palette();
+				// vengi Y-up to goxel Z-up with handedness fix:
+				// goxel data[goxZ][goxY][goxX] where goxY = -(vengiZ - bz) + (BlockSize-1)
+				auto func = [&](int x, int y, int z, const voxel::Voxel &voxel) {
+					if (voxel::isAir(voxel.getMaterial())) {
+						return;
 					}
+					const int lx = x - bx;
+					const int ly = y - by; // vengi Y = goxel Z
+					const int lz = z - bz; // vengi Z = -goxel Y
+					const int goxY = BlockSize - 1 - lz;
+					const int offset = lx + goxY * BlockSize + ly * BlockSize * BlockSize;
+					data[offset] = palette.color(voxel.getColor());
+				};
+				voxelutil::visitVolume(*vol, blockRegion, func, voxelutil::VisitAll());
+
+				image::Image image2("##");
+				if (!image2.loadRGBA((const uint8_t *)data, 64, 64)) {
+					Log::error("Could not load image data");
 					core_free(data);
-					if (!image2.writePNG(stream)) {
-						Log::error("Could not write png into gox stream");
-						return false;
-					}
-					Log::debug("Saved BL16 chunk %i", blocks);
-					++blocks;
+					return false;
+				}
+				core_free(data);
+				if (!image2.writePNG(stream)) {
+					Log::error("Could not write png into gox stream");
+					return false;
 				}
+				++blocks;
 			}
 		}
 	}
 	return true;
 }
 
+bool GoxFormat::saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int &blocks) {
+	// the blocks of the models are encoded in parallel - the block ids are assigned in the order of the models
+	core::AtomicInt blockCount{0};
+	NodeEncoder encoder([this, &sceneGraph, &blockCount](const scenegraph::SceneGraphNode &node,
+														 io::SeekableWriteStream &out) {
+		int nodeBlocks = 0;
+		if (!saveBlocks(out, sceneGraph, node, nodeBlocks)) {
+			return false;
+		}
+		blockCount.increment(nodeBlocks);
+		return true;
+	});
+	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		encoder.add(node, (size_t)sceneGraph.resolveRegion(node).voxels());
+	}
+	for (int i = 0; i < encoder.jobs(); ++i) {
+		const io::BufferedReadWriteStream *payload = encoder.next();
+		if (payload == nullptr) {
+			return false;
+		}
+		if (stream.write(payload->getBuffer(), payload->size()) == -1) {
+			Log::error("Could not write BL16 chunks");
+			return false;
+		}
+	}
+	blocks = blockCount;
+	Log::debug("Saved %i BL16 chunks", blocks);
+	return true;
+}
+
 bool GoxFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 						   const io::ArchivePtr &archive, const SaveContext &ctx) {
 	core::ScopedPtr<io::SeekableWriteStream> stream(archive->writeStream(filename));
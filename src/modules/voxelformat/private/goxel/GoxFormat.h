@@ -147,6 +147,12 @@ private:
 	bool saveChunk_LIGH(io::SeekableWriteStream &stream);
 
 	// Write all the blocks chunks.
+	/**
+	 * @brief Write the non-empty BL16 blocks of a single model node
+	 * @note Called concurrently for different nodes
+	 */
+	bool saveBlocks(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+					const scenegraph::SceneGraphNode &node, int &blocks) const;
 	bool saveChunk_BL16(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph, int &blocks);
 	// Write all the materials.
 	bool saveChunk_MATE(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph);
@@ -42,6 +42,15 @@ static int extractLayerFromFilename(const core::String &filename) {
 	return layer;
 }
 
+static image::ImagePtr loadArchiveImage(const io::ArchivePtr &archive, const core::String &filename) {
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	if (!stream) {
+		Log::debug("Failed to open file at %s", filename.c_str());
+		return image::ImagePtr();
+	}
+	return image::loadImage(filename, *stream, stream->size());
+}
+
 static bool hasSameBasename(const core::String &originalFilename, const core::String &layerFilename) {
 	core::String o = core::string::extractFilename(originalFilename);
 	size_t n = o.rfind("-");
@@ -59,10 +68,10 @@ static bool hasSameBasename(const core::String &originalFilename, const core::St
 }
 
 bool PNGFormat::importSlices(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
-							 const io::ArchiveFiles &entities) const {
+							 const io::ArchiveFiles &entities, const io::ArchivePtr &archive) const {
 	const core::String filename = entities.front().fullPath;
 	Log::debug("Use %s as reference image", filename.c_str());
-	image::ImagePtr referenceImage = image::loadImage(filename);
+	image::ImagePtr referenceImage = loadArchiveImage(archive, filename);
 	if (!referenceImage || !referenceImage->isLoaded()) {
 		Log::error("Failed to load first image as reference %s", filename.c_str());
 		return false;
@@ -101,11 +110,11 @@ bool PNGFormat::importSlices(scenegraph::SceneGraph &sceneGraph, const palette::
 	node.setPalette(palette);
 
 	palette::PaletteLookup palLookup(palette);
-	auto fn = [&filteredEntites, &palLookup, &palette, &volume, imageHeight, imageWidth, this] (int start, int end) {
+	auto fn = [&filteredEntites, &palLookup, &palette, &volume, &archive, imageHeight, imageWidth, this] (int start, int end) {
 		for (int i = start; i < end; ++i) {
 			const auto &entity = *filteredEntites[i];
 			const core::String &layerFilename = entity.fullPath;
-			const image::ImagePtr &image = image::loadImage(layerFilename);
+			const image::ImagePtr &image = loadArchiveImage(archive, layerFilename);
 			if (!image || !image->isLoaded()) {
 				Log::error("Failed to load image %s", layerFilename.c_str());
 				continue;
@@ -150,7 +159,11 @@ bool PNGFormat::importSlices(scenegraph::SceneGraph &sceneGraph, const palette::
 
 bool PNGFormat::importAsHeightmap(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 								  const core::String &filename, const io::ArchivePtr &archive) const {
-	image::ImagePtr image = image::loadImage(filename);
+	image::ImagePtr image = loadArchiveImage(archive, filename);
+	if (!image || !image->isLoaded()) {
+		Log::error("Failed to load image %s", filename.c_str());
+		return false;
+	}
 	if (image->width() > MaxHeightmapWidth || image->height() >= MaxHeightmapHeight) {
 		Log::warn("Skip creating heightmap - image dimensions exceeds the max allowed boundaries");
 		return false;
@@ -185,12 +198,15 @@ bool PNGFormat::importAsHeightmap(scenegraph::SceneGraph &sceneGraph, const pale
 
 bool PNGFormat::importAsVolume(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 							   const core::String &filename, const io::ArchivePtr &archive) const {
-	const image::ImagePtr &image = image::loadImage(filename);
+	const image::ImagePtr &image = loadArchiveImage(archive, filename);
+	if (!image || !image->isLoaded()) {
+		Log::error("Failed to load image %s", filename.c_str());
+		return false;
+	}
 	const int maxDepth = core::getVar(cfg::VoxformatImageVolumeMaxDepth)->intVal();
 	const bool bothSides = core::getVar(cfg::VoxformatImageVolumeBothSides)->boolVal();
 	const core::String &depthMapFilename = voxelutil::getDefaultDepthMapFile(filename);
-	core::ScopedPtr<io::SeekableReadStream> depthMapStream(archive->readStream(depthMapFilename));
-	const image::ImagePtr &depthMapImage = image::loadImage(depthMapFilename, *depthMapStream, depthMapStream->size());
+	const image::ImagePtr &depthMapImage = loadArchiveImage(archive, depthMapFilename);
 	voxel::RawVolume *v;
 	if (depthMapImage && depthMapImage->isLoaded()) {
 		Log::debug("Found depth map %s", depthMapFilename.c_str());
@@ -212,7 +228,11 @@ bool PNGFormat::importAsVolume(scenegraph::SceneGraph &sceneGraph, const palette
 
 bool PNGFormat::importAsPlane(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 							  const core::String &filename, const io::ArchivePtr &archive) const {
-	image::ImagePtr image = image::loadImage(filename);
+	image::ImagePtr image = loadArchiveImage(archive, filename);
+	if (!image || !image->isLoaded()) {
+		Log::error("Failed to load image %s", filename.c_str());
+		return false;
+	}
 	voxel::RawVolume *v = voxelutil::importAsPlane(image, palette);
 	if (v == nullptr) {
 		Log::warn("Failed to import image as plane: '%s'", image->name().c_str());
@@ -264,7 +284,7 @@ bool PNGFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 
 	bool loaded;
 	if (entities.size() > 1u) {
-		loaded = importSlices(sceneGraph, palette, entities);
+		loaded = importSlices(sceneGraph, palette, entities, archive);
 	} else {
 		loaded = importAsPlane(sceneGraph, palette, filename, archive);
 	}
@@ -276,9 +296,9 @@ bool PNGFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 
 size_t PNGFormat::loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 							  const LoadContext &ctx) {
-	const image::ImagePtr &image = image::loadImage(filename);
+	const image::ImagePtr &image = loadArchiveImage(archive, filename);
 	const int type = core::getVar(cfg::VoxformatImageImportType)->intVal();
-	if (type == ImageType::Heightmap) {
+	if (type == ImageType::Heightmap && image) {
 		image->makeOpaque();
 	}
 
@@ -300,7 +320,7 @@ size_t PNGFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 	archive->list(directory, entities, core::String::format("%s-*.png", basename.c_str()));
 	core::Set<color::RGBA, 521> colorSet;
 	for (const auto &entity : entities) {
-		const image::ImagePtr &sliceImage = image::loadImage(entity.fullPath);
+		const image::ImagePtr &sliceImage = loadArchiveImage(archive, entity.fullPath);
 		if (!sliceImage || !sliceImage->isLoaded()) {
 			continue;
 		}
@@ -14,7 +14,7 @@ namespace voxelformat {
 class PNGFormat : public RGBAFormat {
 private:
 	bool importSlices(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
-					  const io::ArchiveFiles &entities) const;
+					  const io::ArchiveFiles &entities, const io::ArchivePtr &archive) const;
 	bool importAsHeightmap(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 						   const core::String &filename, const io::ArchivePtr &archive) const;
 	bool importAsVolume(scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
@@ -119,8 +119,7 @@ glm::mat4 ogtInstanceBakeMatrix(const ogt_vox_instance &instance, uint32_t frame
 	return computeBakeMatrix(ogtToMat(t), glm::vec3(ogtVolumePivot(model)));
 }
 
-voxel::RawVolume *bakeOgtModel(const ogt_vox_model *model, const glm::mat4 &bakeMat, const palette::Palette &palette,
-							   glm::ivec3 &outShift) {
+voxel::Region ogtModelRegion(const ogt_vox_model *model, const glm::mat4 &bakeMat) {
 	const glm::vec3 volSize = ogtVolumeSize(model);
 	const glm::vec3 corners[8] = {glm::vec3(0),
 								  glm::vec3(volSize.x, 0, 0),
@@ -138,7 +137,12 @@ voxel::RawVolume *bakeOgtModel(const ogt_vox_model *model, const glm::mat4 &bake
 		mins = glm::min(mins, pos);
 		maxs = glm::max(maxs, pos);
 	}
-	voxel::Region region(mins, maxs);
+	return voxel::Region(mins, maxs);
+}
+
+voxel::RawVolume *bakeOgtModel(const ogt_vox_model *model, const glm::mat4 &bakeMat, const palette::Palette &palette,
+							   glm::ivec3 &outShift) {
+	voxel::Region region = ogtModelRegion(model, bakeMat);
 	outShift = region.getLowerCorner();
 	region.shift(-outShift);
 	voxel::RawVolume *v = new voxel::RawVolume(region);
@@ -31,6 +31,8 @@ namespace voxelformat {
 struct MVSceneContext {
 	core::Buffer<ogt_vox_group> groups;
 	core::Buffer<ogt_vox_model> models;
+	/** the nodes the voxel data of @c models is filled from - see @c VoxFormat::fillModels() */
+	core::Buffer<const scenegraph::SceneGraphNode *> modelNodes;
 	core::Buffer<ogt_vox_layer> layers;
 	core::Buffer<ogt_vox_instance> instances;
 	core::Buffer<ogt_vox_keyframe_transform> keyframeTransforms;
@@ -116,6 +118,12 @@ inline glm::ivec3 calcTransform(const glm::mat4x4 &mat, const glm::vec3 &pos) {
 glm::mat4 ogtInstanceBakeMatrix(const ogt_vox_instance &instance, uint32_t frameIdx, const ogt_vox_scene *scene,
 								const ogt_vox_model *model);
 
+/**
+ * @brief The vengi world region of an ogt model baked through @p bakeMat - only the model size is needed
+ * @sa bakeOgtModel()
+ */
+voxel::Region ogtModelRegion(const ogt_vox_model *model, const glm::mat4 &bakeMat);
+
 /**
  * @brief Bake an ogt model through @p bakeMat into a vengi volume (region mins at 0).
  * @p outShift is the world translation that places the volume (former region lower corner).
@@ -3,11 +3,13 @@
  */
 
 #include "VoxFormat.h"
+#include "app/ForParallel.h"
 #include "color/ColorUtil.h"
 #include "core/ConfigVar.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/Var.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
@@ -55,6 +57,97 @@ size_t VoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 	return palette.colorCount();
 }
 
+bool VoxFormat::loadMetadata(const core::String &filename, const io::ArchivePtr &archive, FormatMetadata &metadata,
+							 const LoadContext &ctx) {
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	if (!stream) {
+		Log::error("Could not open file %s", filename.c_str());
+		return false;
+	}
+	const size_t size = stream->size();
+	uint8_t *buffer = (uint8_t *)core_malloc(size);
+	if (stream->read(buffer, size) == -1) {
+		core_free(buffer);
+		return false;
+	}
+	// the models only contain the sizes - the voxels are skipped
+	const uint32_t ogt_vox_flags = k_read_scene_flags_groups | k_read_scene_flags_keep_empty_models_instances |
+								   k_read_scene_flags_keep_duplicate_models | k_read_scene_flags_skip_voxel_data;
+	const ogt_vox_scene *scene = ogt_vox_read_scene_with_flags(buffer, (uint32_t)size, ogt_vox_flags);
+	core_free(buffer);
+	if (scene == nullptr) {
+		Log::error("Could not load scene %s", filename.c_str());
+		return false;
+	}
+
+	palette::Palette palette;
+	loadPaletteFromScene(scene, palette);
+	metadata.palette.clear();
+	metadata.palette.reserve(palette.colorCount());
+	for (int i = 0; i < palette.colorCount(); ++i) {
+		metadata.palette.push_back(palette.color(i));
+	}
+
+	// the regions are not cropped to the voxels like in loadInstance()
+	voxel::Region sceneRegion = voxel::Region::InvalidRegion;
+	uint32_t nodes = 0u;
+	auto addModel = [&](const ogt_vox_model *model, const glm::mat4 &bakeMat) {
+		const voxel::Region &region = ogtModelRegion(model, bakeMat);
+		if (sceneRegion.isValid()) {
+			sceneRegion.accumulate(region);
+		} else {
+			sceneRegion = region;
+		}
+		++nodes;
+	};
+	const bool animAsNodes = core::getVar(cfg::VoxformatVOXAnimAsNodes)->boolVal();
+	for (uint32_t n = 0; n < scene->num_instances; ++n) {
+		const ogt_vox_instance &ogtInstance = scene->instances[n];
+		if (ogtInstance.model_index >= scene->num_models || scene->models[ogtInstance.model_index] == nullptr) {
+			continue;
+		}
+		if (animAsNodes && ogtInstance.model_anim.num_keyframes > 0) {
+			for (uint32_t k = 0; k < ogtInstance.model_anim.num_keyframes; ++k) {
+				const ogt_vox_keyframe_model &kfModel = ogtInstance.model_anim.keyframes[k];
+				if (kfModel.model_index >= scene->num_models || scene->models[kfModel.model_index] == nullptr) {
+					continue;
+				}
+				const ogt_vox_model *frameModel = scene->models[kfModel.model_index];
+				addModel(frameModel, ogtInstanceBakeMatrix(ogtInstance, kfModel.frame_index, scene, frameModel));
+			}
+			continue;
+		}
+		const ogt_vox_model *ogtModel = scene->models[ogtInstance.model_index];
+		addModel(ogtModel, ogtInstanceBakeMatrix(ogtInstance, 0, scene, ogtModel));
+	}
+	if (scene->num_instances == 0) {
+		for (uint32_t i = 0; i < scene->num_models; ++i) {
+			const ogt_vox_model *ogtModel = scene->models[i];
+			if (ogtModel == nullptr) {
+				continue;
+			}
+			const voxel::Region region(glm::ivec3(0),
+									   glm::ivec3(ogtModel->size_x - 1, ogtModel->size_z - 1, ogtModel->size_y - 1));
+			if (sceneRegion.isValid()) {
+				sceneRegion.accumulate(region);
+			} else {
+				sceneRegion = region;
+			}
+			++nodes;
+		}
+	}
+	ogt_vox_destroy_scene(scene);
+
+	if (nodes == 0u && palette.colorCount() > 0) {
+		// see loadGroupsPalette()
+		nodes = 1u;
+		sceneRegion = voxel::Region(0, 31);
+	}
+	metadata.nodes = nodes;
+	metadata.dimensions = sceneRegion.isValid() ? sceneRegion.getDimensionsInVoxels() : glm::ivec3(0);
+	return true;
+}
+
 static void applyInstanceMetadata(scenegraph::SceneGraphNode &node, const ogt_vox_scene *scene,
 								  const ogt_vox_instance &ogtInstance) {
 	node.setColor(instanceColor(scene, ogtInstance));
@@ -414,15 +507,28 @@ uint32_t VoxFormat::saveModel(const scenegraph::SceneGraph &sceneGraph, scenegra
 	ogt_model.size_x = region.getWidthInVoxels();
 	ogt_model.size_y = region.getDepthInVoxels();
 	ogt_model.size_z = region.getHeightInVoxels();
-	const int voxelSize = (int)(ogt_model.size_x * ogt_model.size_y * ogt_model.size_z);
-	uint8_t *dataptr = (uint8_t *)core_malloc(voxelSize);
-	ogt_model.voxel_data = dataptr;
-	auto func = [&](int, int, int, const voxel::Voxel &voxel) { *dataptr++ = voxel.getColor(); };
-	voxelutil::visitVolume(*sceneGraph.resolveVolume(node), func, voxelutil::VisitAll(), voxelutil::VisitorOrder::YZmX);
+	// the voxel data is filled by fillModels()
+	ogt_model.voxel_data = nullptr;
 	ctx.models.push_back(ogt_model);
+	ctx.modelNodes.push_back(&node);
 	return (uint32_t)(ctx.models.size() - 1);
 }
 
+void VoxFormat::fillModels(const scenegraph::SceneGraph &sceneGraph, MVSceneContext &ctx) const {
+	core_trace_scoped(VoxFillModels);
+	app::for_parallel(0, (int)ctx.models.size(), [&sceneGraph, &ctx](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			ogt_vox_model &ogt_model = ctx.models[i];
+			const int voxelSize = (int)(ogt_model.size_x * ogt_model.size_y * ogt_model.size_z);
+			uint8_t *dataptr = (uint8_t *)core_malloc(voxelSize);
+			ogt_model.voxel_data = dataptr;
+			auto func = [&](int, int, int, const voxel::Voxel &voxel) { *dataptr++ = voxel.getColor(); };
+			voxelutil::visitVolume(*sceneGraph.resolveVolume(*ctx.modelNodes[i]), func, voxelutil::VisitAll(),
+								   voxelutil::VisitorOrder::YZmX);
+		}
+	});
+}
+
 void VoxFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node,
 						 MVSceneContext &ctx, uint32_t parentGroupIdx, uint32_t layerIdx) {
 	Log::debug("Save node '%s' with parent group %u and layer %u", node.name().c_str(), parentGroupIdx, layerIdx);
@@ -617,6 +723,7 @@ bool VoxFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 
 	const scenegraph::SceneGraphNode &root = sceneGraph.root();
 	saveNode(sceneGraph, sceneGraph.node(root.id()), ctx, k_invalid_group_index, 0);
+	fillModels(sceneGraph, ctx);
 
 	core::Buffer<const ogt_vox_model *> modelPtr;
 	modelPtr.reserve(ctx.models.size());
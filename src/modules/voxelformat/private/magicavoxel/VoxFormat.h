@@ -45,6 +45,10 @@ private:
 	void saveInstance(const scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, MVSceneContext &ctx,
 					  uint32_t parentGroupIdx, uint32_t layerIdx, uint32_t modelIdx);
 	uint32_t saveModel(const scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, MVSceneContext &ctx);
+	/**
+	 * @brief Convert the volumes of all models that were registered by @c saveModel() in parallel
+	 */
+	void fillModels(const scenegraph::SceneGraph &sceneGraph, MVSceneContext &ctx) const;
 	bool loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 				   const LoadContext &ctx);
 	bool loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceIdx, scenegraph::SceneGraph &sceneGraph,
@@ -65,6 +69,8 @@ public:
 	VoxFormat();
 	size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 					   const LoadContext &ctx) override;
+	bool loadMetadata(const core::String &filename, const io::ArchivePtr &archive, FormatMetadata &metadata,
+					  const LoadContext &ctx) override;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{"MagicaVoxel",
@@ -3,6 +3,8 @@
  */
 
 #include "GLTFFormat.h"
+#include "app/App.h"
+#include "app/Async.h"
 #include "color/ColorUtil.h"
 #include "core/Common.h"
 #include "core/ConfigVar.h"
@@ -12,11 +14,13 @@
 #include "core/StandardLib.h"
 #include "core/String.h"
 #include "core/StringUtil.h"
+#include "core/UUID.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "core/collection/Buffer.h"
 #include "core/collection/Map.h"
+#include "core/concurrent/Future.h"
 #include "engine-config.h"
 #include "image/Image.h"
 #include "image/ImageType.h"
@@ -24,6 +28,9 @@
 #include "io/Base64.h"
 #include "io/Base64ReadStream.h"
 #include "io/BufferedReadWriteStream.h"
+#include "io/File.h"
+#include "io/FileStream.h"
+#include "io/Filesystem.h"
 #include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "palette/Palette.h"
@@ -54,7 +61,7 @@
 namespace voxelformat {
 
 static bool writeGltfBuffer(const core::String &filename, const io::ArchivePtr &archive, bool isGlb,
-							const char *jsonBuf, size_t jsonSize, const void *binBuf, size_t binSize) {
+							const char *jsonBuf, size_t jsonSize, io::ReadStream &binStream, size_t binSize) {
 	bool success = false;
 	if (isGlb) {
 		core::ScopedPtr<io::SeekableWriteStream> stream(archive->writeStream(filename));
@@ -82,11 +89,10 @@ static bool writeGltfBuffer(const core::String &filename, const io::ArchivePtr &
 			// BIN chunk
 			stream->writeUInt32(binPadded);
 			stream->writeUInt32(0x004E4942); // "BIN\0"
-			stream->write(binBuf, binLen);
+			success = stream->writeStream(binStream);
 			for (uint32_t p = binLen; p < binPadded; ++p) {
 				stream->writeUInt8(0);
 			}
-			success = true;
 		}
 	} else {
 		core::ScopedPtr<io::SeekableWriteStream> stream(archive->writeStream(filename));
@@ -96,9 +102,9 @@ static bool writeGltfBuffer(const core::String &filename, const io::ArchivePtr &
 		}
 		// Write binary buffer
 		const core::String binPath = core::string::replaceExtension(filename, "bin");
-		core::ScopedPtr<io::SeekableWriteStream> binStream(archive->writeStream(binPath));
-		if (binStream) {
-			binStream->write(binBuf, binSize);
+		core::ScopedPtr<io::SeekableWriteStream> binOutStream(archive->writeStream(binPath));
+		if (binOutStream) {
+			binOutStream->writeStream(binStream);
 		}
 	}
 	return success;
@@ -722,142 +728,208 @@ bool GLTFFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 	return !sceneGraph.empty();
 }
 
-bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const scenegraph::SceneGraph &sceneGraph,
-							const ChunkMeshes &meshes, const core::String &filename, const io::ArchivePtr &archive,
-							const glm::vec3 &scale, bool quad, bool withColor, bool withTexCoords) {
+/**
+ * @brief Layout of one sub mesh in the binary buffer
+ */
+struct GLTFFormat::MeshInfo {
+	int meshExtIdx;
+	int subMeshIdx;
+	size_t vertexOffset;
+	size_t vertexSize;
+	size_t indexOffset;
+	size_t indexSize;
+	int vertexCount;
+	int indexCount;
+	bool hasTexture;
+	bool useGreedyTexture; // true = use meshExt.texture + UVs, false = palette texture + paletteUV
+	int floatsPerVertex;
+	bool perColorMaterials; // true = split into per-color primitives with per-color materials
+	int sourceInfoIdx; // -1 = own buffer data, otherwise the mesh info of the gltf mesh that is instanced
+	int gltfMeshIdx;
+	float min[3]; // position bounds for the accessor
+	float max[3];
+};
+
+struct GLTFFormat::PerColorIndexInfo {
+	uint8_t colorIdx;
+	int indexCount;
+	size_t bufferOffset; // offset in the main buffer
+};
 
-	if (quad) {
-		Log::warn("glTF format does not support quads - exporting as triangles");
+/**
+ * @brief The binary buffer of the glTF file and the layout of the meshes in it
+ *
+ * The geometry of a mesh is converted and written to the stream when the mesh is added - afterwards the mesh is not
+ * needed anymore to build the document. The buffer is either kept in memory or written to a temporary file for the
+ * streaming glb writer.
+ */
+struct GLTFFormat::MeshBuffer {
+	core::DynamicArray<MeshInfo> meshInfos;
+	// Per mesh info: the index buffers per color - only used for perColorMaterials
+	core::DynamicArray<core::DynamicArray<PerColorIndexInfo>> perColorIndices;
+	// Model references share the extracted mesh with the referenced node (see MeshFormat::saveGroups()). If the
+	// vertex data would be the same, the gltf mesh is written once and all the nodes are pointing to it.
+	core::DynamicMap<const voxel::Mesh *, core::DynamicArray<int>, 1031> meshInstances;
+	int uniqueMeshes = 0;
+	size_t size = 0;
+
+	glm::vec3 scale{1.0f};
+	bool withColor = true;
+	bool withTexCoords = true;
+	bool withMaterials = true;
+
+	io::BufferedReadWriteStream memoryStream;
+	core::String tempPath;
+	io::FilePtr tempFile;
+	core::ScopedPtr<io::FileStream> tempStream;
+	io::SeekableWriteStream *stream = &memoryStream;
+
+	~MeshBuffer() {
+		tempStream = nullptr;
+		tempFile = {};
+		if (!tempPath.empty()) {
+			io::Filesystem::sysRemoveFile(tempPath);
+		}
 	}
-	(void)quad; // glTF only supports triangles
-
-	const bool withMaterials = core::getVar(cfg::VoxformatWithMaterials)->boolVal();
 
-	// Count total meshes
-	int totalMeshes = 0;
-	int totalAccessors = 0;
-	int totalBufferViews = 0;
-	for (const ChunkMeshExt &meshExt : meshes) {
-		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			if (!meshExt.mesh->mesh[i].isEmpty()) {
-				++totalMeshes;
-			}
+	bool openTempFile(const core::String &path) {
+		tempPath = path;
+		tempFile = core::make_shared<io::File>(path, io::FileMode::SysWrite);
+		if (!tempFile->validHandle()) {
+			Log::error("Failed to open the temporary glTF buffer file %s", path.c_str());
+			tempFile = {};
+			return false;
 		}
+		tempStream = new io::FileStream(tempFile);
+		stream = tempStream;
+		return true;
 	}
-	if (totalMeshes == 0) {
-		Log::error("No meshes to export");
-		return false;
+
+	bool write(const void *buf, size_t len) {
+		if (len == 0) {
+			return true;
+		}
+		if (stream->write(buf, len) != (int)len) {
+			Log::error("Failed to write %i bytes into the glTF buffer", (int)len);
+			return false;
+		}
+		size += len;
+		return true;
 	}
 
-	// Calculate buffer size needed
-	size_t bufferSize = 0;
-	struct MeshInfo {
-		int meshExtIdx;
-		int subMeshIdx;
-		size_t vertexOffset;
-		size_t vertexSize;
-		size_t indexOffset;
-		size_t indexSize;
-		int vertexCount;
-		int indexCount;
-		bool hasTexture;
-		bool useGreedyTexture; // true = use meshExt.texture + UVs, false = palette texture + paletteUV
-		int floatsPerVertex;
-		bool perColorMaterials; // true = split into per-color primitives with per-color materials
-	};
-	core::DynamicArray<MeshInfo> meshInfos;
-	meshInfos.reserve(totalMeshes);
+	/**
+	 * @return The stream to read the whole buffer from - no further data can be added
+	 */
+	io::SeekableReadStream *readStream() {
+		if (tempStream == nullptr) {
+			memoryStream.seek(0);
+			return &memoryStream;
+		}
+		// a file may only be opened once
+		tempStream = nullptr;
+		tempFile = {};
+		tempFile = core::make_shared<io::File>(tempPath, io::FileMode::SysRead);
+		if (!tempFile->validHandle()) {
+			Log::error("Failed to read the temporary glTF buffer file %s", tempPath.c_str());
+			tempFile = {};
+			return nullptr;
+		}
+		tempStream = new io::FileStream(tempFile);
+		stream = nullptr;
+		return tempStream;
+	}
 
-	for (int mi = 0; mi < (int)meshes.size(); ++mi) {
-		const ChunkMeshExt &meshExt = meshes[mi];
+	/**
+	 * @brief Forget the sub meshes of the given mesh for instancing - must be called before the mesh is freed
+	 */
+	void release(const voxel::ChunkMesh *mesh) {
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
-			if (mesh->isEmpty()) {
-				continue;
-			}
-			MeshInfo info;
-			info.meshExtIdx = mi;
-			info.subMeshIdx = i;
-			info.vertexCount = (int)mesh->getNoOfVertices();
-			info.indexCount = (int)mesh->getNoOfIndices();
-			info.useGreedyTexture =
-				withTexCoords && meshExt.texture && meshExt.texture->isLoaded() && !mesh->getUVVector().empty();
-			info.hasTexture = info.useGreedyTexture || withTexCoords;
-			info.floatsPerVertex = 3 + (withColor ? 4 : 0) + (info.hasTexture ? 2 : 0); // pos(3) [+ color(4)] [+ uv(2)]
-			info.perColorMaterials = withMaterials && !info.useGreedyTexture && info.hasTexture;
-			info.vertexOffset = bufferSize;
-			info.vertexSize = info.vertexCount * info.floatsPerVertex * sizeof(float);
-			bufferSize += info.vertexSize;
-			// index data
-			info.indexOffset = bufferSize;
-			info.indexSize = info.indexCount * sizeof(uint32_t);
-			bufferSize += info.indexSize;
-			meshInfos.push_back(info);
+			meshInstances.remove(&mesh->mesh[i]);
 		}
 	}
 
-	// Pre-scan: for meshes with perColorMaterials, determine used colors and per-color index counts
-	// We store indices grouped by color in the buffer (after the original indices)
-	struct PerColorIndexInfo {
-		uint8_t colorIdx;
-		int indexCount;
-		size_t bufferOffset; // offset in the main buffer
-	};
-	// Per mesh: array of per-color index infos
-	core::DynamicArray<core::DynamicArray<PerColorIndexInfo>> perColorIndices;
-	perColorIndices.resize(totalMeshes);
+	bool add(const scenegraph::SceneGraph &sceneGraph, const ChunkMeshes &meshes, int meshExtIdx);
+};
 
-	size_t perColorBufferSize = 0;
-	for (int mi = 0; mi < (int)meshInfos.size(); ++mi) {
-		const MeshInfo &info = meshInfos[mi];
-		if (!info.perColorMaterials) {
+bool GLTFFormat::MeshBuffer::add(const scenegraph::SceneGraph &sceneGraph, const ChunkMeshes &meshes, int meshExtIdx) {
+	const ChunkMeshExt &meshExt = meshes[meshExtIdx];
+	const scenegraph::SceneGraphNode &graphNode = sceneGraph.node(meshExt.nodeId);
+	const palette::Palette &palette = graphNode.palette();
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
+		if (mesh->isEmpty()) {
 			continue;
 		}
-		const ChunkMeshExt &meshExt = meshes[info.meshExtIdx];
-		const voxel::Mesh *mesh = &meshExt.mesh->mesh[info.subMeshIdx];
-		const voxel::VoxelVertex *vertices = mesh->getRawVertexData();
-		const voxel::IndexType *indices = mesh->getRawIndexData();
-
-		// Count indices per color (a triangle belongs to a color if its first vertex has that color)
-		int colorCounts[palette::PaletteMaxColors];
-		core_memset(colorCounts, 0, sizeof(colorCounts));
-		for (int t = 0; t < info.indexCount; t += 3) {
-			uint8_t ci = vertices[indices[t]].colorIndex;
-			colorCounts[ci] += 3;
-		}
-		for (int c = 0; c < palette::PaletteMaxColors; ++c) {
-			if (colorCounts[c] > 0) {
-				PerColorIndexInfo pci;
-				pci.colorIdx = (uint8_t)c;
-				pci.indexCount = colorCounts[c];
-				pci.bufferOffset = bufferSize + perColorBufferSize;
-				perColorBufferSize += colorCounts[c] * sizeof(uint32_t);
-				perColorIndices[mi].push_back(pci);
+		MeshInfo info;
+		info.meshExtIdx = meshExtIdx;
+		info.subMeshIdx = i;
+		info.sourceInfoIdx = -1;
+		auto instanceIter = meshInstances.find(mesh);
+		if (instanceIter != meshInstances.end()) {
+			const uint64_t paletteHash = palette.hash();
+			for (int si : instanceIter->value) {
+				const ChunkMeshExt &sourceExt = meshes[meshInfos[si].meshExtIdx];
+				if (sourceExt.applyTransform != meshExt.applyTransform || sourceExt.texture != meshExt.texture) {
+					continue;
+				}
+				if (meshExt.applyTransform && sourceExt.pivot * sourceExt.size != meshExt.pivot * meshExt.size) {
+					continue;
+				}
+				if (sceneGraph.node(sourceExt.nodeId).palette().hash() != paletteHash) {
+					continue;
+				}
+				info = meshInfos[si];
+				info.meshExtIdx = meshExtIdx;
+				info.sourceInfoIdx = si;
+				break;
 			}
 		}
-	}
-	bufferSize += perColorBufferSize;
+		if (info.sourceInfoIdx != -1) {
+			meshInfos.push_back(info);
+			perColorIndices.emplace_back();
+			continue;
+		}
+		if (instanceIter != meshInstances.end()) {
+			instanceIter->value.push_back((int)meshInfos.size());
+		} else {
+			core::DynamicArray<int> sources;
+			sources.push_back((int)meshInfos.size());
+			meshInstances.put(mesh, sources);
+		}
+		info.gltfMeshIdx = uniqueMeshes++;
+		info.vertexCount = (int)mesh->getNoOfVertices();
+		info.indexCount = (int)mesh->getNoOfIndices();
+		info.useGreedyTexture =
+			withTexCoords && meshExt.texture && meshExt.texture->isLoaded() && !mesh->getUVVector().empty();
+		info.hasTexture = info.useGreedyTexture || withTexCoords;
+		info.floatsPerVertex = 3 + (withColor ? 4 : 0) + (info.hasTexture ? 2 : 0); // pos(3) [+ color(4)] [+ uv(2)]
+		info.perColorMaterials = withMaterials && !info.useGreedyTexture && info.hasTexture;
+		info.vertexSize = info.vertexCount * info.floatsPerVertex * sizeof(float);
+		info.indexSize = info.indexCount * sizeof(uint32_t);
 
-	// Allocate and fill buffer
-	uint8_t *buffer = (uint8_t *)core_malloc(bufferSize);
-	for (const MeshInfo &info : meshInfos) {
-		const ChunkMeshExt &meshExt = meshes[info.meshExtIdx];
-		const voxel::Mesh *mesh = &meshExt.mesh->mesh[info.subMeshIdx];
 		const voxel::VoxelVertex *vertices = mesh->getRawVertexData();
 		const voxel::IndexType *indices = mesh->getRawIndexData();
-		const scenegraph::SceneGraphNode &graphNode = sceneGraph.node(meshExt.nodeId);
-		const palette::Palette &palette = graphNode.palette();
 
-		float *vBuf = (float *)(buffer + info.vertexOffset);
+		// vertex data
+		core::DynamicArray<float> vBuf;
+		vBuf.resize(info.vertexCount * info.floatsPerVertex);
 		const int stride = info.floatsPerVertex;
 		const voxel::UVArray &uvs = mesh->getUVVector();
 		const glm::vec3 pivotOffset = glm::vec3(mesh->getOffset()) - meshExt.pivot * meshExt.size;
+		info.min[0] = info.min[1] = info.min[2] = FLT_MAX;
+		info.max[0] = info.max[1] = info.max[2] = -FLT_MAX;
 		for (int j = 0; j < info.vertexCount; ++j) {
 			glm::vec3 pos = vertices[j].position;
 			if (meshExt.applyTransform) {
 				pos += pivotOffset;
 			}
 			pos *= scale;
+			for (int k = 0; k < 3; ++k) {
+				if (pos[k] < info.min[k])
+					info.min[k] = pos[k];
+				if (pos[k] > info.max[k])
+					info.max[k] = pos[k];
+			}
 			int off = 0;
 			vBuf[j * stride + off++] = pos.x;
 			vBuf[j * stride + off++] = pos.y;
@@ -880,52 +952,103 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 				}
 			}
 		}
-
-		uint32_t *iBuf = (uint32_t *)(buffer + info.indexOffset);
-		for (int j = 0; j < info.indexCount; ++j) {
-			iBuf[j] = (uint32_t)indices[j];
+		info.vertexOffset = size;
+		if (!write(vBuf.data(), info.vertexSize)) {
+			return false;
 		}
-	}
 
-	// Fill per-color index buffers
-	for (int mi = 0; mi < (int)meshInfos.size(); ++mi) {
-		const MeshInfo &info = meshInfos[mi];
-		if (!info.perColorMaterials) {
-			continue;
+		// index data
+		static_assert(sizeof(voxel::IndexType) == sizeof(uint32_t), "Index type must match the accessor type");
+		info.indexOffset = size;
+		if (!write(indices, info.indexSize)) {
+			return false;
 		}
-		const ChunkMeshExt &meshExt = meshes[info.meshExtIdx];
-		const voxel::Mesh *mesh = &meshExt.mesh->mesh[info.subMeshIdx];
-		const voxel::VoxelVertex *vertices = mesh->getRawVertexData();
-		const voxel::IndexType *indices = mesh->getRawIndexData();
 
-		// Write per-color index arrays
-		// First set up write pointers for each color
-		core::DynamicArray<uint32_t *> colorWritePtrs;
-		colorWritePtrs.resize(perColorIndices[mi].size());
-		for (int ci = 0; ci < (int)perColorIndices[mi].size(); ++ci) {
-			colorWritePtrs[ci] = (uint32_t *)(buffer + perColorIndices[mi][ci].bufferOffset);
-		}
-		// Build a lookup from colorIdx -> index in perColorIndices[mi]
-		int colorToSlot[palette::PaletteMaxColors];
-		core_memset(colorToSlot, -1, sizeof(colorToSlot));
-		for (int ci = 0; ci < (int)perColorIndices[mi].size(); ++ci) {
-			colorToSlot[perColorIndices[mi][ci].colorIdx] = ci;
+		// For meshes with perColorMaterials the indices are grouped by color (a triangle belongs to a color if its
+		// first vertex has that color) and stored after the original indices
+		core::DynamicArray<PerColorIndexInfo> colorIndexInfos;
+		if (info.perColorMaterials) {
+			int colorCounts[palette::PaletteMaxColors];
+			core_memset(colorCounts, 0, sizeof(colorCounts));
+			for (int t = 0; t < info.indexCount; t += 3) {
+				uint8_t ci = vertices[indices[t]].colorIndex;
+				colorCounts[ci] += 3;
+			}
+			int colorStart[palette::PaletteMaxColors];
+			int colorIndexCount = 0;
+			for (int c = 0; c < palette::PaletteMaxColors; ++c) {
+				colorStart[c] = colorIndexCount;
+				if (colorCounts[c] > 0) {
+					PerColorIndexInfo pci;
+					pci.colorIdx = (uint8_t)c;
+					pci.indexCount = colorCounts[c];
+					pci.bufferOffset = size + colorIndexCount * sizeof(uint32_t);
+					colorIndexCount += colorCounts[c];
+					colorIndexInfos.push_back(pci);
+				}
+			}
+			// Distribute triangles
+			core::DynamicArray<uint32_t> colorIndices;
+			colorIndices.resize(colorIndexCount);
+			for (int t = 0; t < info.indexCount; t += 3) {
+				const uint8_t c = vertices[indices[t]].colorIndex;
+				uint32_t *ptr = &colorIndices[colorStart[c]];
+				ptr[0] = (uint32_t)indices[t];
+				ptr[1] = (uint32_t)indices[t + 1];
+				ptr[2] = (uint32_t)indices[t + 2];
+				colorStart[c] += 3;
+			}
+			if (!write(colorIndices.data(), colorIndices.size() * sizeof(uint32_t))) {
+				return false;
+			}
 		}
-		// Distribute triangles
-		for (int t = 0; t < info.indexCount; t += 3) {
-			uint8_t c = vertices[indices[t]].colorIndex;
-			int slot = colorToSlot[c];
-			uint32_t *ptr = colorWritePtrs[slot];
-			ptr[0] = (uint32_t)indices[t];
-			ptr[1] = (uint32_t)indices[t + 1];
-			ptr[2] = (uint32_t)indices[t + 2];
-			colorWritePtrs[slot] += 3;
+		meshInfos.push_back(info);
+		perColorIndices.emplace_back(core::move(colorIndexInfos));
+	}
+	return true;
+}
+
+bool GLTFFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &sceneGraph,
+							const ChunkMeshes &meshes, const core::String &filename, const io::ArchivePtr &archive,
+							const glm::vec3 &scale, bool quad, bool withColor, bool withTexCoords) {
+
+	if (quad) {
+		Log::warn("glTF format does not support quads - exporting as triangles");
+	}
+
+	MeshBuffer meshBuffer;
+	meshBuffer.scale = scale;
+	meshBuffer.withColor = withColor;
+	meshBuffer.withTexCoords = withTexCoords;
+	meshBuffer.withMaterials = core::getVar(cfg::VoxformatWithMaterials)->boolVal();
+	for (int mi = 0; mi < (int)meshes.size(); ++mi) {
+		if (!meshBuffer.add(sceneGraph, meshes, mi)) {
+			return false;
 		}
 	}
+	return saveDocument(meshBuffer, sceneGraph, meshes, filename, archive);
+}
+
+bool GLTFFormat::saveDocument(MeshBuffer &meshBuffer, const scenegraph::SceneGraph &sceneGraph,
+							  const ChunkMeshes &meshes, const core::String &filename,
+							  const io::ArchivePtr &archive) const {
+	const core::DynamicArray<MeshInfo> &meshInfos = meshBuffer.meshInfos;
+	const core::DynamicArray<core::DynamicArray<PerColorIndexInfo>> &perColorIndices = meshBuffer.perColorIndices;
+	const bool withColor = meshBuffer.withColor;
+	const bool withMaterials = meshBuffer.withMaterials;
+	const int totalMeshes = (int)meshInfos.size();
+	const int uniqueMeshes = meshBuffer.uniqueMeshes;
+	if (totalMeshes == 0) {
+		Log::error("No meshes to export");
+		return false;
+	}
 
 	// Count total primitives (for perColorMaterials meshes, one per used color; otherwise 1)
 	int totalPrimitives = 0;
 	for (int mi = 0; mi < (int)meshInfos.size(); ++mi) {
+		if (meshInfos[mi].sourceInfoIdx != -1) {
+			continue;
+		}
 		if (meshInfos[mi].perColorMaterials) {
 			totalPrimitives += (int)perColorIndices[mi].size();
 		} else {
@@ -936,7 +1059,7 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	// Build cgltf_data
 	int texturedMeshCount = 0;
 	for (const MeshInfo &info : meshInfos) {
-		if (info.hasTexture)
+		if (info.hasTexture && info.sourceInfoIdx == -1)
 			++texturedMeshCount;
 	}
 
@@ -968,7 +1091,7 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	// Materials: per-color materials + one per non-perColorMaterials textured mesh
 	int nonPerColorTexturedCount = 0;
 	for (const MeshInfo &info : meshInfos) {
-		if (info.hasTexture && !info.perColorMaterials) {
+		if (info.hasTexture && !info.perColorMaterials && info.sourceInfoIdx == -1) {
 			++nonPerColorTexturedCount;
 		}
 	}
@@ -978,30 +1101,33 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	// For perColorMaterials meshes, we still need the vertex BVs but replace the single index BV+acc
 	// with N per-color index BV+accs. The original index BV is not needed for those meshes.
 	// So: vertex BVs/accs stay the same, but index BVs/accs change.
-	int vertexBVCount = totalMeshes + (withColor ? totalMeshes : 0) + texturedMeshCount;
+	int vertexBVCount = uniqueMeshes + (withColor ? uniqueMeshes : 0) + texturedMeshCount;
 	int indexBVCount = 0;
 	for (int mi = 0; mi < (int)meshInfos.size(); ++mi) {
+		if (meshInfos[mi].sourceInfoIdx != -1) {
+			continue;
+		}
 		if (meshInfos[mi].perColorMaterials) {
 			indexBVCount += (int)perColorIndices[mi].size();
 		} else {
 			indexBVCount += 1;
 		}
 	}
-	totalBufferViews = vertexBVCount + indexBVCount;
-	totalAccessors = vertexBVCount + indexBVCount;
+	int totalBufferViews = vertexBVCount + indexBVCount;
+	int totalAccessors = vertexBVCount + indexBVCount;
 
+	// the data of the buffer is not needed for writing the document - it's written from the mesh buffer stream
 	cgltf_buffer gltfBuffer;
 	core_memset(&gltfBuffer, 0, sizeof(gltfBuffer));
-	gltfBuffer.size = bufferSize;
-	gltfBuffer.data = buffer;
+	gltfBuffer.size = meshBuffer.size;
 
 	// Allocate arrays
 	cgltf_buffer_view *bufferViews = (cgltf_buffer_view *)core_malloc(totalBufferViews * sizeof(cgltf_buffer_view));
 	core_memset(bufferViews, 0, totalBufferViews * sizeof(cgltf_buffer_view));
 	cgltf_accessor *accessors = (cgltf_accessor *)core_malloc(totalAccessors * sizeof(cgltf_accessor));
 	core_memset(accessors, 0, totalAccessors * sizeof(cgltf_accessor));
-	cgltf_mesh *gltfMeshes = (cgltf_mesh *)core_malloc(totalMeshes * sizeof(cgltf_mesh));
-	core_memset(gltfMeshes, 0, totalMeshes * sizeof(cgltf_mesh));
+	cgltf_mesh *gltfMeshes = (cgltf_mesh *)core_malloc(uniqueMeshes * sizeof(cgltf_mesh));
+	core_memset(gltfMeshes, 0, uniqueMeshes * sizeof(cgltf_mesh));
 	cgltf_primitive *primitives = (cgltf_primitive *)core_malloc(totalPrimitives * sizeof(cgltf_primitive));
 	core_memset(primitives, 0, totalPrimitives * sizeof(cgltf_primitive));
 	int maxAttrsPerPrimitive = 3; // POSITION, COLOR_0, TEXCOORD_0
@@ -1184,6 +1310,13 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	int texIdx = totalPerColorMaterials; // non-perColor materials start after per-color ones
 	for (int mi = 0; mi < (int)meshInfos.size(); ++mi) {
 		const MeshInfo &info = meshInfos[mi];
+		if (info.sourceInfoIdx != -1) {
+			nodes[mi].mesh = &gltfMeshes[info.gltfMeshIdx];
+			nodes[mi].name = (char *)meshes[info.meshExtIdx].name.c_str();
+			const scenegraph::SceneGraphNode &graphNode = sceneGraph.node(meshes[info.meshExtIdx].nodeId);
+			setGltfNodeTRS(nodes[mi], graphNode.transform(0));
+			continue;
+		}
 		const int stride = info.floatsPerVertex;
 		const int strideBytes = stride * (int)sizeof(float);
 
@@ -1201,17 +1334,9 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 		accessors[accIdx].count = info.vertexCount;
 		accessors[accIdx].has_min = true;
 		accessors[accIdx].has_max = true;
-		float *vBuf = (float *)(buffer + info.vertexOffset);
-		accessors[accIdx].min[0] = accessors[accIdx].min[1] = accessors[accIdx].min[2] = FLT_MAX;
-		accessors[accIdx].max[0] = accessors[accIdx].max[1] = accessors[accIdx].max[2] = -FLT_MAX;
-		for (int j = 0; j < info.vertexCount; ++j) {
-			for (int k = 0; k < 3; ++k) {
-				float v = vBuf[j * stride + k];
-				if (v < accessors[accIdx].min[k])
-					accessors[accIdx].min[k] = v;
-				if (v > accessors[accIdx].max[k])
-					accessors[accIdx].max[k] = v;
-			}
+		for (int k = 0; k < 3; ++k) {
+			accessors[accIdx].min[k] = info.min[k];
+			accessors[accIdx].max[k] = info.max[k];
 		}
 		int posAccIdx = accIdx;
 		++bvIdx;
@@ -1459,11 +1584,12 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 		}
 
 		// Mesh
-		gltfMeshes[mi].primitives = &primitives[firstPrimIdx];
-		gltfMeshes[mi].primitives_count = primIdx - firstPrimIdx;
+		cgltf_mesh &gltfMesh = gltfMeshes[info.gltfMeshIdx];
+		gltfMesh.primitives = &primitives[firstPrimIdx];
+		gltfMesh.primitives_count = primIdx - firstPrimIdx;
 
 		// Node
-		nodes[mi].mesh = &gltfMeshes[mi];
+		nodes[mi].mesh = &gltfMesh;
 		nodes[mi].name = (char *)meshes[info.meshExtIdx].name.c_str();
 		{
 			const scenegraph::SceneGraphNode &graphNode = sceneGraph.node(meshes[info.meshExtIdx].nodeId);
@@ -1575,7 +1701,7 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	gltfData.asset.version = (char *)"2.0";
 	gltfData.asset.generator = (char *)"vengi " PROJECT_VERSION;
 	gltfData.meshes = gltfMeshes;
-	gltfData.meshes_count = totalMeshes;
+	gltfData.meshes_count = uniqueMeshes;
 	gltfData.accessors = accessors;
 	gltfData.accessors_count = totalAccessors;
 	gltfData.buffer_views = bufferViews;
@@ -1630,6 +1756,7 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	cgltf_buffer_view *animBufferViews = nullptr;
 	uint8_t *animBuffer = nullptr;
 	size_t animBufferSize = 0;
+	bool animBufferWritten = true;
 	int animCount = 0;
 	core::DynamicArray<core::String> uniqueAnims;
 
@@ -1868,14 +1995,10 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 				gltfAnimations[ai].channels_count = chanI - firstChannel;
 			}
 
-			// Merge animation buffer into main buffer
-			size_t newBufferSize = bufferSize + animBufferSize;
-			uint8_t *newBuffer = (uint8_t *)core_malloc(newBufferSize);
-			core_memcpy(newBuffer, buffer, bufferSize);
-			core_memcpy(newBuffer + bufferSize, animBuffer, animBufferSize);
-			core_free(buffer);
+			// Append animation buffer to the main buffer
+			const size_t bufferSize = meshBuffer.size;
+			animBufferWritten = meshBuffer.write(animBuffer, animBufferSize);
 			core_free(animBuffer);
-			buffer = newBuffer;
 			animBuffer = nullptr;
 
 			// Fix animation buffer view offsets (they're relative to animBuffer, need to add bufferSize)
@@ -1883,9 +2006,7 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 				animBufferViews[i].offset += bufferSize;
 				animBufferViews[i].buffer = &gltfBuffer;
 			}
-			bufferSize = newBufferSize;
-			gltfBuffer.size = bufferSize;
-			gltfBuffer.data = buffer;
+			gltfBuffer.size = meshBuffer.size;
 
 			// Merge accessors and buffer views into gltfData
 			int newTotalAccessors = totalAccessors + totalAnimAccs;
@@ -1962,7 +2083,6 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	// Get JSON size
 	cgltf_size jsonSize = cgltf_write(&writeOptions, nullptr, 0, &gltfData);
 	if (jsonSize == 0) {
-		core_free(buffer);
 		core_free(bufferViews);
 		core_free(accessors);
 		core_free(gltfMeshes);
@@ -1985,10 +2105,15 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	char *jsonBuf = (char *)core_malloc(jsonSize);
 	cgltf_write(&writeOptions, jsonBuf, jsonSize, &gltfData);
 
-	bool success = writeGltfBuffer(filename, archive, isGlb, jsonBuf, jsonSize, buffer, bufferSize);
+	bool success = false;
+	io::SeekableReadStream *binStream = animBufferWritten ? meshBuffer.readStream() : nullptr;
+	if (binStream != nullptr) {
+		success = writeGltfBuffer(filename, archive, isGlb, jsonBuf, jsonSize, *binStream, meshBuffer.size);
+	} else {
+		Log::error("Failed to write the gltf buffer");
+	}
 
 	core_free(jsonBuf);
-	core_free(buffer);
 	core_free(bufferViews);
 	core_free(accessors);
 	core_free(gltfMeshes);
@@ -2019,6 +2144,143 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	return success;
 }
 
+bool GLTFFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
+							const io::ArchivePtr &archive, const SaveContext &ctx) {
+	const bool isGlb = core::string::extractExtension(filename) == "glb";
+	if (isGlb && core::getVar(cfg::VoxformatGLTFStreaming)->boolVal() &&
+		!core::getVar(cfg::VoxformatPointCloud)->boolVal()) {
+		return saveGroupsStreamed(sceneGraph, filename, archive, ctx);
+	}
+	return Super::saveGroups(sceneGraph, filename, archive, ctx);
+}
+
+bool GLTFFormat::saveGroupsStreamed(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
+									const io::ArchivePtr &archive, const SaveContext &ctx) {
+	core::IProgress &progress = ctx.progressRef();
+	progress.setText("mesh");
+	core::ProgressRange extractRange(progress, 0.0f, 0.9f);
+	core::ProgressRange writeRange(progress, 0.9f, 1.0f);
+	extractRange.setProgress(0.0f);
+
+	const voxel::SurfaceExtractionType type =
+		(voxel::SurfaceExtractionType)core::getVar(cfg::VoxformatMeshMode)->intVal();
+	if (type == voxel::SurfaceExtractionType::Cubic && core::getVar(cfg::VoxformatQuads)->boolVal()) {
+		Log::warn("glTF format does not support quads - exporting as triangles");
+	}
+	const bool applyTransform = core::getVar(cfg::VoxformatTransform)->boolVal();
+
+	// the nodes are written in the order of their ids - like the in-memory path does. The mesh of an owner is kept
+	// until the last node that references it was written and freed afterwards.
+	core::DynamicArray<int> meshOwners;
+	findMeshOwners(sceneGraph, meshOwners);
+	const int nodeCount = (int)meshOwners.size();
+	core::DynamicArray<int> owners;
+	core::DynamicArray<int> ownerSlots;
+	core::DynamicArray<int> lastUsers;
+	ownerSlots.resize(nodeCount);
+	for (int i = 0; i < nodeCount; ++i) {
+		const int owner = meshOwners[i];
+		if (owner == -1) {
+			continue;
+		}
+		if (owner == i) {
+			ownerSlots[i] = (int)owners.size();
+			owners.push_back(i);
+			lastUsers.push_back(i);
+		} else {
+			lastUsers[ownerSlots[owner]] = i;
+		}
+	}
+
+	MeshBuffer meshBuffer;
+	meshBuffer.withColor = core::getVar(cfg::VoxformatWithColor)->boolVal();
+	meshBuffer.withTexCoords = core::getVar(cfg::VoxformatWithtexcoords)->boolVal();
+	meshBuffer.withMaterials = core::getVar(cfg::VoxformatWithMaterials)->boolVal();
+	const core::String tempPath =
+		io::filesystem()->homeWritePath(core::String::format("gltf-%s.bin", core::UUID::generate().str().c_str()));
+	if (!meshBuffer.openTempFile(tempPath)) {
+		return false;
+	}
+
+	// the meshes are extracted in parallel ahead of the writer - only these and the meshes that are still
+	// referenced by nodes that are not yet written are kept in memory
+	const int ownerCount = (int)owners.size();
+	const int threads = app::App::getInstance()->threads();
+	core::DynamicArray<core::Future<ChunkMeshExt>> futures;
+	futures.reserve(ownerCount);
+	int scheduled = 0;
+	auto extract = [&sceneGraph, &owners, type, applyTransform](int slot) {
+		return extractMesh(sceneGraph, sceneGraph.node(owners[slot]), type, applyTransform);
+	};
+	ChunkMeshes ownerMeshes;
+	ownerMeshes.resize(ownerCount);
+	auto freeOwnerMesh = [&meshBuffer, &ownerMeshes](int slot) {
+		if (ownerMeshes[slot].mesh == nullptr) {
+			return;
+		}
+		meshBuffer.release(ownerMeshes[slot].mesh);
+		delete ownerMeshes[slot].mesh;
+		ownerMeshes[slot].mesh = nullptr;
+	};
+
+	ChunkMeshes meshes;
+	bool state = true;
+	int written = 0;
+	for (int i = 0; i < nodeCount && state; ++i) {
+		const int owner = meshOwners[i];
+		if (owner == -1) {
+			continue;
+		}
+		const int slot = ownerSlots[owner];
+		if (owner == i) {
+			if (threads <= 1) {
+				ownerMeshes[slot] = extract(slot);
+			} else {
+				for (; scheduled < ownerCount && scheduled <= slot + threads; ++scheduled) {
+					const int s = scheduled;
+					futures.emplace_back(app::async([&extract, s]() { return extract(s); }));
+				}
+				ownerMeshes[slot] = futures[slot].get();
+				futures[slot] = {};
+			}
+			++written;
+			extractRange.setProgress((float)written / (float)ownerCount);
+		}
+		const ChunkMeshExt &ownerMesh = ownerMeshes[slot];
+		if (!ownerMesh.mesh->isEmpty()) {
+			ChunkMeshExt meshExt(ownerMesh.mesh, sceneGraph.node(i), applyTransform);
+			meshExt.texture = ownerMesh.texture;
+			meshes.push_back(meshExt);
+			state = meshBuffer.add(sceneGraph, meshes, (int)meshes.size() - 1);
+			// the geometry is in the buffer now
+			meshes.back().mesh = nullptr;
+		}
+		if (lastUsers[slot] == i) {
+			freeOwnerMesh(slot);
+		}
+	}
+	// an error occurred - free the meshes that are still referenced and wait for the scheduled extractions
+	for (int slot = 0; slot < ownerCount; ++slot) {
+		freeOwnerMesh(slot);
+	}
+	for (int slot = 0; slot < scheduled; ++slot) {
+		if (futures[slot].valid()) {
+			delete futures[slot].get().mesh;
+		}
+	}
+	if (!state) {
+		return false;
+	}
+	writeRange.setProgress(0.0f);
+	if (meshes.empty() && sceneGraph.empty(scenegraph::SceneGraphNodeType::Point)) {
+		Log::warn("Empty scene can't get saved as mesh");
+		return false;
+	}
+	state = saveDocument(meshBuffer, sceneGraph, meshes, filename, archive);
+	writeRange.setProgress(1.0f);
+	return state;
+}
+
 bool GLTFFormat::savePointCloud(const scenegraph::SceneGraph &sceneGraph, const PointCloud &pointCloud,
 								const core::String &filename, const io::ArchivePtr &archive, const glm::vec3 &scale,
 								bool withColor) const {
@@ -2175,7 +2437,8 @@ bool GLTFFormat::savePointCloud(const scenegraph::SceneGraph &sceneGraph, const
 	char *jsonBuf = (char *)core_malloc(jsonSize);
 	cgltf_write(&writeOptions, jsonBuf, jsonSize, &gltfData);
 
-	bool success = writeGltfBuffer(filename, archive, isGlb, jsonBuf, jsonSize, buffer, bufferSize);
+	io::MemoryReadStream binStream(buffer, bufferSize);
+	bool success = writeGltfBuffer(filename, archive, isGlb, jsonBuf, jsonSize, binStream, bufferSize);
 
 	core_free(jsonBuf);
 	core_free(buffer);
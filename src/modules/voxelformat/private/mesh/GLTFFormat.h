@@ -25,6 +25,25 @@ namespace voxelformat {
  */
 class GLTFFormat : public MeshFormat {
 private:
+	using Super = MeshFormat;
+	struct MeshInfo;
+	struct PerColorIndexInfo;
+	struct MeshBuffer;
+
+	/**
+	 * @brief Build the glTF document for the meshes that were added to the given buffer and write the file
+	 *
+	 * The geometry is taken from the @c MeshBuffer - the @c ChunkMeshExt::mesh pointers are not accessed anymore and
+	 * might already be freed.
+	 */
+	bool saveDocument(MeshBuffer &meshBuffer, const scenegraph::SceneGraph &sceneGraph, const ChunkMeshes &meshes,
+					  const core::String &filename, const io::ArchivePtr &archive) const;
+	/**
+	 * @brief Streaming glb writer - the meshes are extracted in parallel ahead of the writer and the geometry is
+	 * spilled into a temporary file. Only the meshes that are currently extracted are kept in memory.
+	 */
+	bool saveGroupsStreamed(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
+							const io::ArchivePtr &archive, const SaveContext &ctx);
 	bool voxelizeGroups(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 						const LoadContext &ctx) override;
 	int addNode_r(const cgltf_data *data, const cgltf_node *node, const core::String &filename,
@@ -37,6 +56,8 @@ private:
 						  const core::Map<const cgltf_node *, int> &nodeMap) const;
 
 public:
+	bool saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
+					const io::ArchivePtr &archive, const SaveContext &ctx) override;
 	bool saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const scenegraph::SceneGraph &sceneGraph,
 					const ChunkMeshes &meshes, const core::String &filename, const io::ArchivePtr &archive,
 					const glm::vec3 &scale, bool quad, bool withColor, bool withTexCoords) override;
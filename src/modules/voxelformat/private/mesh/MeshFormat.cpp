@@ -14,6 +14,7 @@
 #include "core/UUID.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
 #include "core/collection/Map.h"
 #include "core/concurrent/Atomic.h"
 #include "io/Archive.h"
@@ -1323,6 +1324,79 @@ bool MeshFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 	return false;
 }
 
+void MeshFormat::findMeshOwners(const scenegraph::SceneGraph &sceneGraph, core::DynamicArray<int> &meshOwners) {
+	const int nodeCount = (int)sceneGraph.nodes().size();
+	// Model references and models that share a volume are only extracted once. The first node that resolves to a
+	// volume (with the same palette) is the owner of the mesh, all other nodes are instances that reuse it.
+	meshOwners.resize(nodeCount);
+	core::DynamicMap<const voxel::RawVolume *, core::DynamicArray<int>, 1031> volumeOwners;
+	for (int i = 0; i < nodeCount; ++i) {
+		meshOwners[i] = -1;
+		const scenegraph::SceneGraphNode &node = sceneGraph.node(i);
+		if (!node.isAnyModelNode()) {
+			continue;
+		}
+		meshOwners[i] = i;
+		const voxel::RawVolume *volume = sceneGraph.resolveVolume(node);
+		if (volume == nullptr) {
+			continue;
+		}
+		auto iter = volumeOwners.find(volume);
+		if (iter == volumeOwners.end()) {
+			core::DynamicArray<int> owners;
+			owners.push_back(i);
+			volumeOwners.put(volume, owners);
+			continue;
+		}
+		const uint64_t paletteHash = node.palette().hash();
+		for (int owner : iter->value) {
+			if (sceneGraph.node(owner).palette().hash() == paletteHash) {
+				meshOwners[i] = owner;
+				break;
+			}
+		}
+		if (meshOwners[i] == i) {
+			iter->value.push_back(i);
+		}
+	}
+}
+
+MeshFormat::ChunkMeshExt MeshFormat::extractMesh(const scenegraph::SceneGraph &sceneGraph,
+												  const scenegraph::SceneGraphNode &node,
+												  voxel::SurfaceExtractionType type, bool applyTransform) {
+	const bool withNormals = core::getVar(cfg::VoxformatWithNormals)->boolVal();
+	const bool optimizeMesh = core::getVar(cfg::VoxformatOptimize)->boolVal();
+	const bool mergeQuads = core::getVar(cfg::VoxformatMergequads)->boolVal();
+	const bool reuseVertices = core::getVar(cfg::VoxformatReusevertices)->boolVal();
+	const bool ambientOcclusion = core::getVar(cfg::VoxformatAmbientocclusion)->boolVal();
+	auto volume = sceneGraph.resolveVolume(node);
+	auto region = sceneGraph.resolveRegion(node);
+	voxel::ChunkMesh *mesh = new voxel::ChunkMesh();
+	voxel::Region regionExt = region;
+	// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
+	regionExt.shiftUpperCorner(1, 1, 1);
+	voxel::SurfaceExtractionContext ctx = voxel::createContext(
+		type, volume, regionExt, node.palette(), *mesh, {0, 0, 0}, mergeQuads, reuseVertices, ambientOcclusion, optimizeMesh);
+	voxel::extractSurface(ctx);
+	if (withNormals) {
+		Log::debug("Calculate normals");
+		mesh->calculateNormals();
+	}
+
+	ChunkMeshExt meshExt(mesh, node, applyTransform);
+	if (!ctx.textureData.empty()) {
+		core::String texName = node.name();
+		if (texName.empty()) {
+			texName = core::String::format("texture%i", node.id());
+		}
+		texName = core::string::sanitizeFilename(texName);
+		texName += ".png";
+		meshExt.texture = image::createEmptyImage(texName);
+		meshExt.texture->loadRGBA(ctx.textureData.data(), ctx.textureWidth, ctx.textureHeight);
+	}
+	return meshExt;
+}
+
 bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 							const io::ArchivePtr &archive, const SaveContext &saveCtx) {
 	const bool withColor = core::getVar(cfg::VoxformatWithColor)->boolVal();
@@ -1344,49 +1418,34 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 	core::ProgressRange writeRange(progress, 0.85f, 1.0f);
 	extractRange.setProgress(0.0f);
 
+	const int nodeCount = (int)sceneGraph.nodes().size();
+	const bool applyTransform = core::getVar(cfg::VoxformatTransform)->boolVal();
+	core::DynamicArray<int> meshOwners;
+	findMeshOwners(sceneGraph, meshOwners);
+
 	ChunkMeshes meshes;
-	meshes.resize(sceneGraph.nodes().size());
-	// TODO: VOXELFORMAT: this could get optimized by re-using the same mesh for multiple nodes (in case of reference
-	// nodes)
-	app::for_parallel(0, sceneGraph.nodes().size(), [&sceneGraph, type, &meshes] (int start, int end) {
-		const bool withNormals = core::getVar(cfg::VoxformatWithNormals)->boolVal();
-		const bool optimizeMesh = core::getVar(cfg::VoxformatOptimize)->boolVal();
-		const bool mergeQuads = core::getVar(cfg::VoxformatMergequads)->boolVal();
-		const bool reuseVertices = core::getVar(cfg::VoxformatReusevertices)->boolVal();
-		const bool ambientOcclusion = core::getVar(cfg::VoxformatAmbientocclusion)->boolVal();
-		const bool applyTransform = core::getVar(cfg::VoxformatTransform)->boolVal();
+	meshes.resize(nodeCount);
+	app::for_parallel(0, nodeCount, [&sceneGraph, type, applyTransform, &meshOwners, &meshes] (int start, int end) {
 		for (int i = start; i < end; ++i) {
-			const scenegraph::SceneGraphNode &node = sceneGraph.node(i);
-			if (!node.isAnyModelNode()) {
+			if (meshOwners[i] != i) {
 				continue;
 			}
-			auto volume = sceneGraph.resolveVolume(node);
-			auto region = sceneGraph.resolveRegion(node);
-			voxel::ChunkMesh *mesh = new voxel::ChunkMesh();
-			voxel::Region regionExt = region;
-			// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
-			regionExt.shiftUpperCorner(1, 1, 1);
-			voxel::SurfaceExtractionContext ctx = voxel::createContext(
-				type, volume, regionExt, node.palette(), *mesh, {0, 0, 0}, mergeQuads, reuseVertices, ambientOcclusion, optimizeMesh);
-			voxel::extractSurface(ctx);
-			if (withNormals) {
-				Log::debug("Calculate normals");
-				mesh->calculateNormals();
-			}
-
-			meshes[i] = core::move(ChunkMeshExt(mesh, node, applyTransform));
-			if (!ctx.textureData.empty()) {
-				core::String texName = node.name();
-				if (texName.empty()) {
-					texName = core::String::format("texture%i", i);
-				}
-				texName = core::string::sanitizeFilename(texName);
-				texName += ".png";
-				meshes[i].texture = image::createEmptyImage(texName);
-				meshes[i].texture->loadRGBA(ctx.textureData.data(), ctx.textureWidth, ctx.textureHeight);
-			}
+			meshes[i] = extractMesh(sceneGraph, sceneGraph.node(i), type, applyTransform);
 		}
 	});
+	// the instances get their own node properties but point to the mesh of the owner - formats that can't
+	// instance a mesh just write the geometry again for every node
+	int instances = 0;
+	for (int i = 0; i < nodeCount; ++i) {
+		const int owner = meshOwners[i];
+		if (owner == -1 || owner == i) {
+			continue;
+		}
+		meshes[i] = core::move(ChunkMeshExt(meshes[owner].mesh, sceneGraph.node(i), applyTransform));
+		meshes[i].texture = meshes[owner].texture;
+		++instances;
+	}
+	Log::debug("Extracted %i meshes for %i instances", nodeCount - instances, instances);
 	extractRange.setProgress(1.0f);
 	ChunkMeshes nonEmptyMeshes;
 	nonEmptyMeshes.reserve(meshes.size());
@@ -1411,8 +1470,10 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 						   type == voxel::SurfaceExtractionType::Cubic ? quads : false, withColor, withTexCoords);
 	}
 	writeRange.setProgress(1.0f);
-	for (ChunkMeshExt &meshext : meshes) {
-		delete meshext.mesh;
+	for (int i = 0; i < nodeCount; ++i) {
+		if (meshOwners[i] == i) {
+			delete meshes[i].mesh;
+		}
 	}
 	return state;
 }
@@ -14,6 +14,7 @@
 #include "palette/NormalPalette.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/Mesh.h"
+#include "voxel/SurfaceExtractor.h"
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include "voxelformat/Format.h"
@@ -87,7 +88,7 @@ protected:
 	struct ChunkMeshExt {
 		ChunkMeshExt() = default;
 		ChunkMeshExt(voxel::ChunkMesh *mesh, const scenegraph::SceneGraphNode &node, bool applyTransform);
-		voxel::ChunkMesh *mesh;
+		voxel::ChunkMesh *mesh = nullptr;
 		core::String name;
 		image::ImagePtr texture;
 		bool applyTransform = false;
@@ -111,6 +112,20 @@ protected:
 	}
 
 	static ChunkMeshExt *getParent(const scenegraph::SceneGraph &sceneGraph, ChunkMeshes &meshes, int nodeId);
+	/**
+	 * @brief Find the node that owns the extracted mesh for every model node
+	 *
+	 * Nodes that resolve to the same volume with the same palette (e.g. model references) share the mesh of the
+	 * first of these nodes.
+	 * @param[out] meshOwners Indexed by node id - @c -1 for nodes without a mesh
+	 */
+	static void findMeshOwners(const scenegraph::SceneGraph &sceneGraph, core::DynamicArray<int> &meshOwners);
+	/**
+	 * @brief Extract the surface of the (resolved) volume of the given model node
+	 * @note The caller owns the @c voxel::ChunkMesh of the returned @c ChunkMeshExt
+	 */
+	static ChunkMeshExt extractMesh(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+									voxel::SurfaceExtractionType type, bool applyTransform);
 	static glm::vec3 getInputScale(const glm::vec3 &meshMins, const glm::vec3 &meshMaxs);
 	bool savePointClouds(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 							 const io::ArchivePtr &archive, const glm::vec3 &scale = glm::vec3(1.0f),
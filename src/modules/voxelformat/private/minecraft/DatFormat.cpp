@@ -190,10 +190,20 @@ static bool load(const core::String &filename, priv::NamedBinaryTagContext &ctx,
 				regionsDone.increment();
 				continue;
 			}
+			int regionX = 0;
+			int regionZ = 0;
+			if (SDL_sscanf(e.name.c_str(), "r.%i.%i.mc", &regionX, &regionZ) == 2 &&
+				!MCRFormat::chunkInRegionFilter(loadctx, regionX * MCRFormat::REGION_CHUNKS,
+												regionZ * MCRFormat::REGION_CHUNKS, MCRFormat::REGION_CHUNKS)) {
+				Log::debug("Skip region file %s - outside of the region filter", e.name.c_str());
+				const int completed = regionsDone.increment() + 1;
+				loadctx.report(e.name.c_str(), completed, regionCount);
+				continue;
+			}
 			const core::String &regionFilename = core::string::path(baseName, "region", e.name);
 			// Nested MCR progress would race across parallel regions; report by completed
 			// region count on the shared parent sink instead.
-			LoadContext regionCtx;
+			const LoadContext &regionCtx = loadctx.withoutProgress();
 			nodes[i] = loadRegionNode(regionFilename, archive, regionCtx);
 			const int completed = regionsDone.increment() + 1;
 			loadctx.report(e.name.c_str(), completed, regionCount);
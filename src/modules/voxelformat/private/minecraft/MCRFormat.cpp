@@ -29,6 +29,7 @@
 #include "voxelutil/VolumeVisitor.h"
 #include "MinecraftPaletteMap.h"
 #include "NamedBinaryTag.h"
+#include "NamedBinaryTagView.h"
 
 #include <glm/common.hpp>
 
@@ -36,20 +37,25 @@ namespace voxelformat {
 
 namespace {
 
-core::String blockStateFromCompound(const priv::NamedBinaryTag &block) {
-	const core::String *name = block.get("Name").string();
+core::String blockStateFromCompound(const priv::NamedBinaryTagView &block) {
+	size_t nameLength;
+	const char *name = block.get("Name").string(nameLength);
 	if (name == nullptr) {
 		return {};
 	}
-	core::String state = *name;
-	const priv::NamedBinaryTag &props = block.get("Properties");
-	if (props.valid() && props.type() == priv::TagType::COMPOUND) {
-		for (const auto &entry : *props.compound()) {
-			const core::String *val = entry->value.string();
+	core::String state(name, nameLength);
+	const priv::NamedBinaryTagView &props = block.get("Properties");
+	if (props.type() == priv::TagType::COMPOUND) {
+		for (const priv::NamedBinaryTagView &entry : props) {
+			size_t valLength;
+			const char *val = entry.string(valLength);
 			if (val == nullptr) {
 				continue;
 			}
-			state.append(",").append(entry->key).append("=").append(*val);
+			state.append(",");
+			state.append(entry.name(), entry.nameLength());
+			state.append("=");
+			state.append(val, valLength);
 		}
 	}
 	return state;
@@ -139,6 +145,32 @@ scenegraph::SceneGraphNode MCRFormat::createWaterNode(voxel::RawVolume *water, c
 	return waterNode;
 }
 
+bool MCRFormat::chunkInRegionFilter(const LoadContext &ctx, int chunkX, int chunkZ, int chunks) {
+	if (!ctx.hasRegionFilter) {
+		return true;
+	}
+	const int minX = chunkX * MAX_SIZE;
+	const int minZ = chunkZ * MAX_SIZE;
+	const int maxX = minX + chunks * MAX_SIZE - 1;
+	const int maxZ = minZ + chunks * MAX_SIZE - 1;
+	if (maxX < ctx.regionMins.x || minX > ctx.regionMaxs.x) {
+		return false;
+	}
+	if (maxZ < ctx.regionMins.z || minZ > ctx.regionMaxs.z) {
+		return false;
+	}
+	return true;
+}
+
+bool MCRFormat::sectionInRegionFilter(const LoadContext &ctx, int sectionY) {
+	if (!ctx.hasRegionFilter) {
+		return true;
+	}
+	const int minY = sectionY * MAX_SIZE;
+	const int maxY = minY + MAX_SIZE - 1;
+	return maxY >= ctx.regionMins.y && minY <= ctx.regionMaxs.y;
+}
+
 #define wrap(expression)                                                                                               \
 	do {                                                                                                               \
 		if ((expression) != 0) {                                                                                       \
@@ -178,9 +210,17 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	int chunkX = 0;
 	int chunkZ = 0;
 	char type = 'a';
+	// the region coordinates are needed to skip chunks outside of the region filter before decompressing them
+	bool regionCoordinates = true;
 	if (SDL_sscanf(name.c_str(), "r.%i.%i.mc%c", &chunkX, &chunkZ, &type) != 3) {
 		Log::warn("Failed to parse the region chunk boundaries from filename %s (%i.%i.%c)", name.c_str(), chunkX,
 				  chunkZ, type);
+		regionCoordinates = false;
+	}
+	if (regionCoordinates && !chunkInRegionFilter(ctx, chunkX * REGION_CHUNKS, chunkZ * REGION_CHUNKS, REGION_CHUNKS)) {
+		// this is not an error - a world import loads all region files and most of them are skipped by the filter
+		Log::debug("Region file %s is outside of the region filter", name.c_str());
+		return true;
 	}
 
 	palette.minecraft();
@@ -217,7 +257,8 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 
 		voxel::RawVolume *volumes[SECTOR_INTS]{};
 		core::AtomicInt sectorsDone{0};
-		auto fn = [&volumes, &offsets, palette, &bufferedStream, &ctx, &sectorsDone, this](int start, int end) {
+		auto fn = [&volumes, &offsets, palette, &bufferedStream, &ctx, &sectorsDone, regionCoordinates, chunkX, chunkZ,
+				   this](int start, int end) {
 			io::MemoryReadStream memStream(bufferedStream.getBuffer(), bufferedStream.size());
 			Log::debug("Loading sectors from %i to %i", start, end);
 			for (int i = start; i < end; ++i) {
@@ -231,12 +272,20 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 					ctx.report("chunk", completed, SECTOR_INTS);
 					continue;
 				}
+				// the offset table is indexed by the chunk position inside the region - this allows us to skip the
+				// decompression and parsing of all chunks that are not part of the region filter
+				if (regionCoordinates && !chunkInRegionFilter(ctx, chunkX * REGION_CHUNKS + i % REGION_CHUNKS,
+															  chunkZ * REGION_CHUNKS + i / REGION_CHUNKS)) {
+					const int completed = sectorsDone.increment() + 1;
+					ctx.report("chunk", completed, SECTOR_INTS);
+					continue;
+				}
 				if (memStream.seek(offsets[i].offset) == -1) {
 					const int completed = sectorsDone.increment() + 1;
 					ctx.report("chunk", completed, SECTOR_INTS);
 					continue;
 				}
-				volumes[i] = readCompressedNBT(memStream, i, palette);
+				volumes[i] = readCompressedNBT(memStream, i, palette, ctx);
 				const int completed = sectorsDone.increment() + 1;
 				ctx.report("chunk", completed, SECTOR_INTS);
 			}
@@ -291,7 +340,7 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 }
 
 voxel::RawVolume *MCRFormat::readCompressedNBT(io::SeekableReadStream &stream, int sector,
-											   const palette::Palette &palette) const {
+											   const palette::Palette &palette, const LoadContext &loadCtx) const {
 	uint32_t nbtSize;
 	wrapNull(stream.readUInt32BE(nbtSize));
 	if (nbtSize == 0) {
@@ -314,10 +363,15 @@ voxel::RawVolume *MCRFormat::readCompressedNBT(io::SeekableReadStream &stream, i
 	// the version is included in the length
 	--nbtSize;
 
+	// the chunk is inflated into one buffer and only the tags that are needed are looked up directly in that buffer
+	// instead of building the full nbt tree with an allocation for every tag
 	io::ZipReadStream zipStream(stream, (int)nbtSize);
-	priv::NamedBinaryTagContext ctx;
-	ctx.stream = &zipStream;
-	const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
+	io::BufferedReadWriteStream nbtData((int64_t)nbtSize * 4);
+	if (!nbtData.writeStream(zipStream)) {
+		Log::error("Could not decompress nbt data");
+		return nullptr;
+	}
+	const priv::NamedBinaryTagView &root = priv::NamedBinaryTagView::parse(nbtData.getBuffer(), nbtData.size());
 	if (!root.valid()) {
 		Log::error("Could not parse nbt structure");
 		return nullptr;
@@ -327,18 +381,34 @@ voxel::RawVolume *MCRFormat::readCompressedNBT(io::SeekableReadStream &stream, i
 	const int32_t dataVersion = root.get("DataVersion").int32();
 	Log::debug("Found data version %i", dataVersion);
 	if (dataVersion >= 2844) {
-		return parseSections(dataVersion, root, sector, palette);
+		return parseSections(dataVersion, root, sector, palette, loadCtx);
+	}
+	return parseLevelCompound(dataVersion, root, sector, palette, loadCtx);
+}
+
+MCRFormat::SectionBlockData::SectionBlockData(const priv::NamedBinaryTag &tag) : type(tag.type()) {
+	if (type == priv::TagType::BYTE_ARRAY) {
+		bytes = tag.byteArray();
+	} else if (type == priv::TagType::LONG_ARRAY) {
+		longs = tag.longArray();
 	}
-	return parseLevelCompound(dataVersion, root, sector, palette);
 }
 
-int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, int x, int y, int z) {
+MCRFormat::SectionBlockData::SectionBlockData(const priv::NamedBinaryTagView &tag) : type(tag.type()) {
+	if (type == priv::TagType::BYTE_ARRAY) {
+		bytes = tag.byteArray();
+	} else if (type == priv::TagType::LONG_ARRAY) {
+		longs = tag.longArray();
+	}
+}
+
+int MCRFormat::getVoxel(int dataVersion, const SectionBlockData &data, int x, int y, int z) {
 	const uint32_t i = y * MAX_SIZE * MAX_SIZE + z * MAX_SIZE + x;
-	if (i >= data.byteArray()->size()) {
-		Log::error("Byte array index out of bounds: %u/%i", i, (int)data.byteArray()->size());
+	if (i >= data.bytes.size()) {
+		Log::error("Byte array index out of bounds: %u/%i", i, (int)data.bytes.size());
 		return -1;
 	}
-	const int val = (int)(uint8_t)(*data.byteArray())[i];
+	const int val = (int)(uint8_t)data.bytes[i];
 	if (val < 0) {
 		Log::error("Invalid value: %i", val);
 		return -1;
@@ -353,7 +423,7 @@ voxel::RawVolume *MCRFormat::error(SectionVolumes &volumes) const {
 	return nullptr;
 }
 
-voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPos) const {
+voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPos, const LoadContext &ctx) const {
 	if (volumes.empty()) {
 		Log::debug("No volumes found at %i:%i", xPos, zPos);
 		return nullptr;
@@ -363,6 +433,18 @@ voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPo
 		delete v;
 	}
 	merged->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
+	if (ctx.hasRegionFilter) {
+		voxel::Region region = merged->region();
+		if (!region.cropTo(voxel::Region(ctx.regionMins, ctx.regionMaxs))) {
+			delete merged;
+			return nullptr;
+		}
+		if (region != merged->region()) {
+			voxel::RawVolume *filtered = new voxel::RawVolume(*merged, region);
+			delete merged;
+			merged = filtered;
+		}
+	}
 	if (voxel::RawVolume *cropped = voxelutil::cropVolume(merged)) {
 		delete merged;
 		return cropped;
@@ -370,10 +452,10 @@ voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPo
 	return merged;
 }
 
-bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
+bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palette, const SectionBlockData &data,
 								 SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal) const {
 	Log::debug("Parse block states");
-	const bool hasData = data.type() == priv::TagType::LONG_ARRAY && !data.longArray()->empty();
+	const bool hasData = data.type == priv::TagType::LONG_ARRAY && !data.longs.empty();
 
 	const glm::ivec3 mins(0, 0, 0);
 	const glm::ivec3 maxs(MAX_SIZE - 1, MAX_SIZE - 1, MAX_SIZE - 1);
@@ -392,8 +474,8 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 	};
 
 	if (secPal.pal.empty()) {
-		if (data.type() != priv::TagType::BYTE_ARRAY) {
-			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
+		if (data.type != priv::TagType::BYTE_ARRAY) {
+			Log::error("Unknown block data type: %i for version %i", (int)data.type, dataVersion);
 			delete v;
 			return false;
 		}
@@ -438,13 +520,13 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 			return false;
 		}
 	} else if (hasData) {
-		if (data.type() != priv::TagType::LONG_ARRAY) {
-			Log::error("Unknown block data type: %i for version %i", (int)data.type(), dataVersion);
+		if (data.type != priv::TagType::LONG_ARRAY) {
+			Log::error("Unknown block data type: %i for version %i", (int)data.type, dataVersion);
 			delete v;
 			return false;
 		}
 
-		const core::Buffer<int64_t> &blockStates = *data.longArray();
+		const priv::NBTLongArrayView &blockStates = data.longs;
 
 		constexpr int blockCount = MAX_SIZE * MAX_SIZE * MAX_SIZE;
 		uint8_t blocks[blockCount];
@@ -452,7 +534,7 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 		int bsCnt = 0;
 		size_t bitCnt = 0;
 		if (dataVersion < 2529) {
-			const size_t bitSize = (data.longArray()->size()) * 64 / blockCount;
+			const size_t bitSize = blockStates.size() * 64 / blockCount;
 			const uint32_t bitMask = (1 << bitSize) - 1;
 			for (int i = 0; i < blockCount; i++) {
 				if (bitCnt + bitSize <= 64) {
@@ -593,9 +675,9 @@ bool MCRFormat::parseBlockStates(int dataVersion, const palette::Palette &palett
 	return true;
 }
 
-voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-										   const palette::Palette &pal) const {
-	const priv::NamedBinaryTag &sections = root.get("sections");
+voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBinaryTagView &root, int sector,
+										   const palette::Palette &pal, const LoadContext &ctx) const {
+	const priv::NamedBinaryTagView &sections = root.get("sections");
 	if (!sections.valid()) {
 		Log::error("Could not find 'sections' tag");
 		return nullptr;
@@ -610,20 +692,19 @@ voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBin
 
 	Log::debug("xpos: %i, zpos: %i", xPos, zPos);
 
-	const priv::NBTList &sectionsList = *sections.list();
-	Log::debug("Found %i sections", (int)sectionsList.size());
-	if (sectionsList.empty()) {
+	Log::debug("Found %i sections", (int)sections.size());
+	if (sections.size() == 0u) {
 		Log::warn("Empty region - no sections found - version: %i", dataVersion);
 		return nullptr;
 	}
 	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &blockStates = section.get("block_states");
+	for (const priv::NamedBinaryTagView &section : sections) {
+		const priv::NamedBinaryTagView &blockStates = section.get("block_states");
 		if (!blockStates.valid()) {
 			Log::debug("Could not find 'block_states'");
 			continue;
 		}
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
+		const priv::NamedBinaryTagView &ylvl = section.get("Y");
 		if (!ylvl.valid()) {
 			Log::debug("Could not find Y int in section compound");
 		}
@@ -632,8 +713,11 @@ voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBin
 			Log::debug("Skip empty section compound");
 		}
 		Log::debug("Y level for section compound: %i", (int)sectionY);
+		if (!sectionInRegionFilter(ctx, sectionY)) {
+			continue;
+		}
 
-		const priv::NamedBinaryTag &paletteTag = blockStates.get("palette");
+		const priv::NamedBinaryTagView &paletteTag = blockStates.get("palette");
 		MinecraftSectionPalette secPal;
 		if (paletteTag.valid()) {
 			if (!parsePaletteList(dataVersion, paletteTag, secPal)) {
@@ -645,18 +729,18 @@ voxel::RawVolume *MCRFormat::parseSections(int dataVersion, const priv::NamedBin
 			secPal.pal[0] = (uint8_t)findPaletteIndex("minecraft:air", 0);
 			secPal.numBits = 0u;
 		}
-		const priv::NamedBinaryTag &data = blockStates.get("data");
+		const priv::NamedBinaryTagView &data = blockStates.get("data");
 		if (!parseBlockStates(dataVersion, pal, data, volumes, sectionY, secPal)) {
 			Log::error("Failed to parse 'data' tag");
 			return error(volumes);
 		}
 	}
-	return finalize(volumes, xPos, zPos);
+	return finalize(volumes, xPos, zPos, ctx);
 }
 
-voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-												const palette::Palette &pal) const {
-	const priv::NamedBinaryTag &levels = root.get("Level");
+voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::NamedBinaryTagView &root, int sector,
+												const palette::Palette &pal, const LoadContext &ctx) const {
+	const priv::NamedBinaryTagView &levels = root.get("Level");
 	if (!levels.valid()) {
 		Log::error("Could not find 'Level' tag");
 		return nullptr;
@@ -669,23 +753,24 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 	const int32_t zPos = levels.get("zPos").int32();
 
 	if (dataVersion >= 1976) {
-		const core::String *tagStatus = root.get("Status").string();
-		if (tagStatus == nullptr) {
+		const priv::NamedBinaryTagView &tagStatus = root.get("Status");
+		if (tagStatus.type() != priv::TagType::STRING) {
 			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "full") {
-			Log::debug("Status for level node is not full but %s (version: %i)", tagStatus->c_str(), dataVersion);
+		} else if (!tagStatus.isString("full")) {
+			Log::debug("Status for level node is not full but %s (version: %i)", tagStatus.stringValue().c_str(),
+					   dataVersion);
 		}
 	} else if (dataVersion >= 1628) {
-		const core::String *tagStatus = levels.get("Status").string();
-		if (tagStatus == nullptr) {
+		const priv::NamedBinaryTagView &tagStatus = levels.get("Status");
+		if (tagStatus.type() != priv::TagType::STRING) {
 			Log::debug("Status for level node wasn't found (version: %i)", dataVersion);
-		} else if (*tagStatus != "postprocessed") {
-			Log::debug("Status for level node is not postprocessed but %s (version: %i)", tagStatus->c_str(),
-					   dataVersion);
+		} else if (!tagStatus.isString("postprocessed")) {
+			Log::debug("Status for level node is not postprocessed but %s (version: %i)",
+					   tagStatus.stringValue().c_str(), dataVersion);
 		}
 	}
 
-	const priv::NamedBinaryTag &sections = levels.get("Sections");
+	const priv::NamedBinaryTagView &sections = levels.get("Sections");
 	if (!sections.valid()) {
 		Log::error("Could not find 'Sections' tag");
 		return nullptr;
@@ -694,15 +779,14 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 		Log::error("Invalid type for 'Sections' tag: %i", (int)sections.type());
 		return nullptr;
 	}
-	const priv::NBTList &sectionsList = *sections.list();
-	Log::debug("Found %i sections", (int)sectionsList.size());
-	if (sectionsList.empty()) {
+	Log::debug("Found %i sections", (int)sections.size());
+	if (sections.size() == 0u) {
 		Log::warn("Empty region - no sections found - version: %i", dataVersion);
 		return nullptr;
 	}
 	SectionVolumes volumes;
-	for (const priv::NamedBinaryTag &section : sectionsList) {
-		const priv::NamedBinaryTag &ylvl = section.get("Y");
+	for (const priv::NamedBinaryTagView &section : sections) {
+		const priv::NamedBinaryTagView &ylvl = section.get("Y");
 		if (!ylvl.valid()) {
 			Log::debug("Could not find Y int in section compound");
 		}
@@ -711,10 +795,13 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 			Log::debug("Skip empty section compound");
 		}
 		Log::debug("Y level for section compound: %i", (int)sectionY);
+		if (!sectionInRegionFilter(ctx, sectionY)) {
+			continue;
+		}
 
 		MinecraftSectionPalette secPal;
 
-		const priv::NamedBinaryTag &palette = section.get("Palette");
+		const priv::NamedBinaryTagView &palette = section.get("Palette");
 		if (palette.valid()) {
 			if (!parsePaletteList(dataVersion, palette, secPal)) {
 				Log::error("Failed to parse 'Palette' tag");
@@ -726,28 +813,27 @@ voxel::RawVolume *MCRFormat::parseLevelCompound(int dataVersion, const priv::Nam
 
 		// TODO:"Data"(byte_array)
 		// const priv::NamedBinaryTag &data = section.get("Data");
-		const core::String &tagId = dataVersion <= 1343 ? "Blocks" : "BlockStates";
-		const priv::NamedBinaryTag &blockStates = section.get(tagId);
+		const char *tagId = dataVersion <= 1343 ? "Blocks" : "BlockStates";
+		const priv::NamedBinaryTagView &blockStates = section.get(tagId);
 		if (!blockStates.valid()) {
-			Log::debug("Could not find '%s'", tagId.c_str());
+			Log::debug("Could not find '%s'", tagId);
 			continue;
 		}
 		if (!parseBlockStates(dataVersion, pal, blockStates, volumes, sectionY, secPal)) {
-			Log::error("Failed to parse '%s' tag", tagId.c_str());
+			Log::error("Failed to parse '%s' tag", tagId);
 			return error(volumes);
 		}
 	}
-	return finalize(volumes, xPos, zPos);
+	return finalize(volumes, xPos, zPos, ctx);
 }
 
-bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette,
+bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTagView &palette,
 								 MinecraftSectionPalette &sectionPal) const {
 	if (palette.type() != priv::TagType::LIST) {
 		Log::error("Invalid type for palette: %i", (int)palette.type());
 		return false;
 	}
-	const priv::NBTList &paletteList = *palette.list();
-	const size_t paletteCount = paletteList.size();
+	const size_t paletteCount = palette.size();
 	if (paletteCount > 4096u) {
 		Log::error("Palette overflow");
 		return false;
@@ -761,7 +847,7 @@ bool MCRFormat::parsePaletteList(int dataVersion, const priv::NamedBinaryTag &pa
 	}
 
 	int paletteEntry = 0;
-	for (const priv::NamedBinaryTag &block : paletteList) {
+	for (const priv::NamedBinaryTagView &block : palette) {
 		if (block.type() != priv::TagType::COMPOUND) {
 			Log::error("Invalid block type %i", (int)block.type());
 			return false;
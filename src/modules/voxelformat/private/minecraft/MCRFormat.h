@@ -9,6 +9,7 @@
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "NamedBinaryTag.h"
+#include "NamedBinaryTagView.h"
 
 namespace io {
 class ZipReadStream;
@@ -65,6 +66,8 @@ class MCRFormat : public PaletteFormat {
 public:
 	static constexpr int SECTOR_BYTES = 4096;
 	static constexpr int SECTOR_INTS = SECTOR_BYTES / 4;
+	/** chunks per region file on the x and z axis */
+	static constexpr int REGION_CHUNKS = 32;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{"Minecraft region", "", {"mca", "mcr"}, {}, VOX_FORMAT_FLAG_PALETTE_EMBEDDED};
@@ -83,7 +86,19 @@ protected:
 
 	using SectionVolumes = core::Buffer<voxel::RawVolume *>;
 
-	bool parseBlockStates(int dataVersion, const palette::Palette &palette, const priv::NamedBinaryTag &data,
+	/**
+	 * @brief The block data of a section - either from a parsed @c priv::NamedBinaryTag or directly from the nbt buffer
+	 */
+	struct SectionBlockData {
+		priv::TagType type = priv::TagType::MAX;
+		priv::NBTByteArrayView bytes;
+		priv::NBTLongArrayView longs;
+
+		SectionBlockData(const priv::NamedBinaryTag &tag);
+		SectionBlockData(const priv::NamedBinaryTagView &tag);
+	};
+
+	bool parseBlockStates(int dataVersion, const palette::Palette &palette, const SectionBlockData &data,
 						  SectionVolumes &volumes, int sectionY, const MinecraftSectionPalette &secPal) const;
 
 public:
@@ -96,6 +111,17 @@ public:
 	static voxel::RawVolume *extractWaterVolume(voxel::RawVolume *terrain);
 	static void applyWaterTransparency(palette::Palette &palette, const voxel::RawVolume *water);
 	static scenegraph::SceneGraphNode createWaterNode(voxel::RawVolume *water, const palette::Palette &palette);
+	/**
+	 * @brief Check whether the given chunk columns intersect the region filter of the load context
+	 * @param[in] chunkX The chunk x coordinate (world space divided by the chunk size)
+	 * @param[in] chunkZ The chunk z coordinate (world space divided by the chunk size)
+	 * @param[in] chunks The amount of chunks on the x and z axis - use @c REGION_CHUNKS for a whole region file
+	 */
+	static bool chunkInRegionFilter(const LoadContext &ctx, int chunkX, int chunkZ, int chunks = 1);
+	/**
+	 * @brief Check whether the given section (in section coordinates) intersects the region filter of the load context
+	 */
+	static bool sectionInRegionFilter(const LoadContext &ctx, int sectionY);
 
 private:
 	static constexpr int VERSION_GZIP = 1;
@@ -108,24 +134,24 @@ private:
 	using Offsets = core::Array<Offset, SECTOR_INTS>;
 
 	voxel::RawVolume *error(SectionVolumes &volumes) const;
-	voxel::RawVolume *finalize(SectionVolumes &volumes, int xPos, int zPos) const;
+	voxel::RawVolume *finalize(SectionVolumes &volumes, int xPos, int zPos, const LoadContext &ctx) const;
 
-	static int getVoxel(int dataVersion, const priv::NamedBinaryTag &data, int x, int y, int z);
+	static int getVoxel(int dataVersion, const SectionBlockData &data, int x, int y, int z);
 
 	// shared across versions
-	bool parsePaletteList(int dataVersion, const priv::NamedBinaryTag &palette,
+	bool parsePaletteList(int dataVersion, const priv::NamedBinaryTagView &palette,
 						  MinecraftSectionPalette &sectionPal) const;
 
 	// new version (>= 2844)
-	voxel::RawVolume *parseSections(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-									const palette::Palette &palette) const;
+	voxel::RawVolume *parseSections(int dataVersion, const priv::NamedBinaryTagView &root, int sector,
+									const palette::Palette &palette, const LoadContext &ctx) const;
 
 	// old version (< 2844)
-	voxel::RawVolume *parseLevelCompound(int dataVersion, const priv::NamedBinaryTag &root, int sector,
-										 const palette::Palette &palette) const;
+	voxel::RawVolume *parseLevelCompound(int dataVersion, const priv::NamedBinaryTagView &root, int sector,
+										 const palette::Palette &palette, const LoadContext &ctx) const;
 
-	voxel::RawVolume *readCompressedNBT(io::SeekableReadStream &stream, int sector,
-										const palette::Palette &palette) const;
+	voxel::RawVolume *readCompressedNBT(io::SeekableReadStream &stream, int sector, const palette::Palette &palette,
+										const LoadContext &ctx) const;
 
 	bool saveSections(const scenegraph::SceneGraph &sceneGraph, priv::NBTList &sections, int sector);
 	bool saveCompressedNBT(const scenegraph::SceneGraph &sceneGraph, io::SeekableWriteStream &stream, int sector);
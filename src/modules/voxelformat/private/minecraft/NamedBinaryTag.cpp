@@ -291,7 +291,7 @@ bool NamedBinaryTag::writeType(io::WriteStream &stream, const NamedBinaryTag &ta
 			return false;
 		}
 		for (size_t i = 0; i < length; i++) {
-			if (!stream.writeInt32((*tag.intArray())[i])) {
+			if (!stream.writeInt32BE((*tag.intArray())[i])) {
 				return false;
 			}
 		}
@@ -303,7 +303,7 @@ bool NamedBinaryTag::writeType(io::WriteStream &stream, const NamedBinaryTag &ta
 			return false;
 		}
 		for (size_t i = 0; i < length; i++) {
-			if (!stream.writeInt64((*tag.longArray())[i])) {
+			if (!stream.writeInt64BE((*tag.longArray())[i])) {
 				return false;
 			}
 		}
@@ -0,0 +1,387 @@
+/**
+ * @file
+ */
+
+#include "NamedBinaryTagView.h"
+#include "core/Endian.h"
+#include "core/Log.h"
+
+namespace voxelformat {
+
+namespace priv {
+
+uint16_t NamedBinaryTagView::readUInt16(const uint8_t *ptr) const {
+	uint16_t val;
+	memcpy(&val, ptr, sizeof(val));
+	return _bedrock ? core_swap16le(val) : core_swap16be(val);
+}
+
+uint32_t NamedBinaryTagView::readUInt32(const uint8_t *ptr) const {
+	uint32_t val;
+	memcpy(&val, ptr, sizeof(val));
+	return _bedrock ? core_swap32le(val) : core_swap32be(val);
+}
+
+uint64_t NamedBinaryTagView::readUInt64(const uint8_t *ptr) const {
+	uint64_t val;
+	memcpy(&val, ptr, sizeof(val));
+	return _bedrock ? core_swap64le(val) : core_swap64be(val);
+}
+
+bool NamedBinaryTagView::has(const uint8_t *ptr, size_t bytes) const {
+	return ptr != nullptr && ptr <= _end && (size_t)(_end - ptr) >= bytes;
+}
+
+static size_t primitiveSize(TagType type) {
+	switch (type) {
+	case TagType::BYTE:
+		return 1u;
+	case TagType::SHORT:
+		return 2u;
+	case TagType::INT:
+	case TagType::FLOAT:
+		return 4u;
+	case TagType::LONG:
+	case TagType::DOUBLE:
+		return 8u;
+	default:
+		return 0u;
+	}
+}
+
+bool NamedBinaryTagView::payloadSize(TagType type, const uint8_t *ptr, size_t &size, int depth) const {
+	if (depth > MaxDepth) {
+		Log::debug("Max nbt depth exceeded");
+		return false;
+	}
+	switch (type) {
+	case TagType::END:
+		size = 0u;
+		return true;
+	case TagType::BYTE:
+	case TagType::SHORT:
+	case TagType::INT:
+	case TagType::FLOAT:
+	case TagType::LONG:
+	case TagType::DOUBLE:
+		size = primitiveSize(type);
+		return has(ptr, size);
+	case TagType::BYTE_ARRAY:
+	case TagType::INT_ARRAY:
+	case TagType::LONG_ARRAY: {
+		if (!has(ptr, 4u)) {
+			return false;
+		}
+		const size_t elementSize = type == TagType::BYTE_ARRAY ? 1u : (type == TagType::INT_ARRAY ? 4u : 8u);
+		size = 4u + (size_t)readUInt32(ptr) * elementSize;
+		return has(ptr, size);
+	}
+	case TagType::STRING:
+		if (!has(ptr, 2u)) {
+			return false;
+		}
+		size = 2u + readUInt16(ptr);
+		return has(ptr, size);
+	case TagType::LIST: {
+		if (!has(ptr, 5u)) {
+			return false;
+		}
+		const TagType elementType = (TagType)ptr[0];
+		const uint32_t count = readUInt32(ptr + 1);
+		size = 5u;
+		if (elementType >= TagType::MAX) {
+			return false;
+		}
+		if (count == 0u || elementType == TagType::END) {
+			return true;
+		}
+		const size_t elementSize = primitiveSize(elementType);
+		if (elementSize > 0u) {
+			// fast path - no need to visit the elements of lists of primitives
+			size += (size_t)count * elementSize;
+			return has(ptr, size);
+		}
+		for (uint32_t i = 0u; i < count; ++i) {
+			size_t elementPayload;
+			if (!payloadSize(elementType, ptr + size, elementPayload, depth + 1)) {
+				return false;
+			}
+			size += elementPayload;
+		}
+		return true;
+	}
+	case TagType::COMPOUND: {
+		size = 0u;
+		for (;;) {
+			if (!has(ptr, size + 1u)) {
+				return false;
+			}
+			const TagType childType = (TagType)ptr[size];
+			++size;
+			if (childType == TagType::END) {
+				return true;
+			}
+			if (childType >= TagType::MAX || !has(ptr, size + 2u)) {
+				return false;
+			}
+			size += 2u + readUInt16(ptr + size);
+			size_t childPayload;
+			if (!payloadSize(childType, ptr + size, childPayload, depth + 1)) {
+				return false;
+			}
+			size += childPayload;
+		}
+	}
+	case TagType::MAX:
+		break;
+	}
+	return false;
+}
+
+NamedBinaryTagView NamedBinaryTagView::namedTag(const uint8_t *ptr) const {
+	if (!has(ptr, 1u)) {
+		return NamedBinaryTagView{};
+	}
+	const TagType type = (TagType)ptr[0];
+	if (type == TagType::END || type >= TagType::MAX || !has(ptr + 1, 2u)) {
+		return NamedBinaryTagView{};
+	}
+	const uint16_t nameLength = readUInt16(ptr + 1);
+	if (!has(ptr + 3, nameLength)) {
+		return NamedBinaryTagView{};
+	}
+	NamedBinaryTagView view;
+	view._tagType = type;
+	view._name = (const char *)ptr + 3;
+	view._nameLength = nameLength;
+	view._payload = ptr + 3 + nameLength;
+	view._end = _end;
+	view._bedrock = _bedrock;
+	return view;
+}
+
+NamedBinaryTagView NamedBinaryTagView::listElement(TagType type, const uint8_t *ptr) const {
+	if (type == TagType::END || type >= TagType::MAX || !has(ptr, 0u)) {
+		return NamedBinaryTagView{};
+	}
+	NamedBinaryTagView view;
+	view._tagType = type;
+	view._payload = ptr;
+	view._end = _end;
+	view._bedrock = _bedrock;
+	return view;
+}
+
+NamedBinaryTagView NamedBinaryTagView::parse(const uint8_t *buf, size_t size, bool bedrock) {
+	NamedBinaryTagView root;
+	root._end = buf + size;
+	root._bedrock = bedrock;
+	NamedBinaryTagView view = root.namedTag(buf);
+	if (!view.valid()) {
+		Log::debug("Failed to read the root tag");
+		return NamedBinaryTagView{};
+	}
+	if (view.type() != TagType::COMPOUND) {
+		Log::debug("Root tag is not a compound but %i", (int)view.type());
+		return NamedBinaryTagView{};
+	}
+	return view;
+}
+
+NamedBinaryTagView::iterator NamedBinaryTagView::begin() const {
+	if (_tagType == TagType::COMPOUND) {
+		return iterator(*this, namedTag(_payload), 0u);
+	}
+	if (_tagType == TagType::LIST) {
+		if (!has(_payload, 5u)) {
+			return end();
+		}
+		const uint32_t count = readUInt32(_payload + 1);
+		if (count == 0u) {
+			return end();
+		}
+		return iterator(*this, listElement(listType(), _payload + 5), count);
+	}
+	return end();
+}
+
+NamedBinaryTagView::iterator NamedBinaryTagView::end() const {
+	return iterator();
+}
+
+NamedBinaryTagView::iterator &NamedBinaryTagView::iterator::operator++() {
+	size_t size;
+	if (!_current.valid() || !_current.payloadSize(_current._tagType, _current._payload, size, 0)) {
+		_current = NamedBinaryTagView{};
+		return *this;
+	}
+	const uint8_t *next = _current._payload + size;
+	if (_parent._tagType == TagType::COMPOUND) {
+		_current = _parent.namedTag(next);
+	} else if (--_remaining == 0u) {
+		_current = NamedBinaryTagView{};
+	} else {
+		_current = _parent.listElement(_current._tagType, next);
+	}
+	return *this;
+}
+
+bool NamedBinaryTagView::isName(const char *name) const {
+	const size_t len = SDL_strlen(name);
+	return len == _nameLength && (len == 0u || memcmp(_name, name, len) == 0);
+}
+
+size_t NamedBinaryTagView::size() const {
+	switch (_tagType) {
+	case TagType::LIST:
+	case TagType::BYTE_ARRAY:
+	case TagType::INT_ARRAY:
+	case TagType::LONG_ARRAY: {
+		const uint8_t *ptr = _tagType == TagType::LIST ? _payload + 1 : _payload;
+		if (!has(ptr, 4u)) {
+			return 0u;
+		}
+		return readUInt32(ptr);
+	}
+	case TagType::COMPOUND: {
+		size_t n = 0u;
+		for (iterator iter = begin(); iter != end(); ++iter) {
+			++n;
+		}
+		return n;
+	}
+	default:
+		return 0u;
+	}
+}
+
+TagType NamedBinaryTagView::listType() const {
+	if (_tagType != TagType::LIST || !has(_payload, 1u)) {
+		return TagType::MAX;
+	}
+	return (TagType)_payload[0];
+}
+
+NamedBinaryTagView NamedBinaryTagView::get(const char *name) const {
+	if (_tagType != TagType::COMPOUND) {
+		return NamedBinaryTagView{};
+	}
+	for (iterator iter = begin(); iter != end(); ++iter) {
+		if (iter->isName(name)) {
+			return *iter;
+		}
+	}
+	return NamedBinaryTagView{};
+}
+
+int8_t NamedBinaryTagView::int8(int8_t defaultVal) const {
+	if (_tagType != TagType::BYTE || !has(_payload, 1u)) {
+		return defaultVal;
+	}
+	return (int8_t)_payload[0];
+}
+
+int16_t NamedBinaryTagView::int16(int16_t defaultVal) const {
+	if (_tagType != TagType::SHORT || !has(_payload, 2u)) {
+		return defaultVal;
+	}
+	return (int16_t)readUInt16(_payload);
+}
+
+int32_t NamedBinaryTagView::int32(int32_t defaultVal) const {
+	if (_tagType != TagType::INT || !has(_payload, 4u)) {
+		return defaultVal;
+	}
+	return (int32_t)readUInt32(_payload);
+}
+
+int64_t NamedBinaryTagView::int64(int64_t defaultVal) const {
+	if (_tagType != TagType::LONG || !has(_payload, 8u)) {
+		return defaultVal;
+	}
+	return (int64_t)readUInt64(_payload);
+}
+
+float NamedBinaryTagView::float32(float defaultVal) const {
+	if (_tagType != TagType::FLOAT || !has(_payload, 4u)) {
+		return defaultVal;
+	}
+	const uint32_t val = readUInt32(_payload);
+	float f;
+	memcpy(&f, &val, sizeof(f));
+	return f;
+}
+
+double NamedBinaryTagView::float64(double defaultVal) const {
+	if (_tagType != TagType::DOUBLE || !has(_payload, 8u)) {
+		return defaultVal;
+	}
+	const uint64_t val = readUInt64(_payload);
+	double d;
+	memcpy(&d, &val, sizeof(d));
+	return d;
+}
+
+const char *NamedBinaryTagView::string(size_t &length) const {
+	length = 0u;
+	if (_tagType != TagType::STRING || !has(_payload, 2u)) {
+		return nullptr;
+	}
+	const uint16_t len = readUInt16(_payload);
+	if (!has(_payload + 2, len)) {
+		return nullptr;
+	}
+	length = len;
+	return (const char *)_payload + 2;
+}
+
+core::String NamedBinaryTagView::stringValue() const {
+	size_t length;
+	const char *str = string(length);
+	if (str == nullptr) {
+		return core::String();
+	}
+	return core::String(str, length);
+}
+
+bool NamedBinaryTagView::isString(const char *str) const {
+	size_t length;
+	const char *val = string(length);
+	if (val == nullptr) {
+		return false;
+	}
+	const size_t len = SDL_strlen(str);
+	return len == length && (len == 0u || memcmp(val, str, len) == 0);
+}
+
+template<class T>
+NBTArrayView<T> NamedBinaryTagView::array(TagType type) const {
+	if (_tagType != type || !has(_payload, 4u)) {
+		return NBTArrayView<T>();
+	}
+	const uint32_t count = readUInt32(_payload);
+	if (!has(_payload + 4, (size_t)count * sizeof(T))) {
+		return NBTArrayView<T>();
+	}
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	const bool swap = !_bedrock;
+#else
+	const bool swap = _bedrock;
+#endif
+	return NBTArrayView<T>(_payload + 4, count, swap && sizeof(T) > 1u);
+}
+
+NBTByteArrayView NamedBinaryTagView::byteArray() const {
+	return array<int8_t>(TagType::BYTE_ARRAY);
+}
+
+NBTIntArrayView NamedBinaryTagView::intArray() const {
+	return array<int32_t>(TagType::INT_ARRAY);
+}
+
+NBTLongArrayView NamedBinaryTagView::longArray() const {
+	return array<int64_t>(TagType::LONG_ARRAY);
+}
+
+} // namespace priv
+} // namespace voxelformat
@@ -0,0 +1,224 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "NamedBinaryTag.h"
+#include "core/String.h"
+#include "core/collection/Buffer.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace voxelformat {
+
+namespace priv {
+
+/**
+ * @brief Read only view onto an array of the nbt data - the values are converted to the host byte order on access.
+ *
+ * This can either point into the raw nbt buffer or onto the already converted data of a @c NamedBinaryTag.
+ */
+template<class T>
+class NBTArrayView {
+private:
+	const uint8_t *_data = nullptr;
+	size_t _size = 0u;
+	bool _swap = false;
+
+public:
+	NBTArrayView() {
+	}
+
+	/**
+	 * @param[in] swap @c true if the byte order of the data doesn't match the host byte order
+	 */
+	NBTArrayView(const uint8_t *data, size_t size, bool swap) : _data(data), _size(size), _swap(swap) {
+	}
+
+	NBTArrayView(const core::Buffer<T> *buffer) {
+		if (buffer != nullptr) {
+			_data = (const uint8_t *)buffer->data();
+			_size = buffer->size();
+		}
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	T operator[](size_t idx) const {
+		T val;
+		memcpy(&val, _data + idx * sizeof(T), sizeof(T));
+		if (_swap) {
+			uint8_t *bytes = (uint8_t *)&val;
+			for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+				const uint8_t tmp = bytes[i];
+				bytes[i] = bytes[sizeof(T) - 1 - i];
+				bytes[sizeof(T) - 1 - i] = tmp;
+			}
+		}
+		return val;
+	}
+};
+
+using NBTByteArrayView = NBTArrayView<int8_t>;
+using NBTIntArrayView = NBTArrayView<int32_t>;
+using NBTLongArrayView = NBTArrayView<int64_t>;
+
+/**
+ * @brief Zero allocation cursor over a contiguous buffer of (uncompressed) nbt data.
+ *
+ * Contrary to @c NamedBinaryTag no tree is built - compounds and lists are iterated directly on the buffer and
+ * subtrees that are not needed are skipped. Use this if you only need to look up a few keys of large nbt files.
+ *
+ * @note The buffer must outlive the view and all views that were created from it.
+ * @sa NamedBinaryTag
+ */
+class NamedBinaryTagView {
+private:
+	const uint8_t *_payload = nullptr;
+	const uint8_t *_end = nullptr;
+	const char *_name = nullptr;
+	uint16_t _nameLength = 0u;
+	TagType _tagType = TagType::MAX;
+	bool _bedrock = false;
+
+	static constexpr int MaxDepth = 512;
+
+	uint16_t readUInt16(const uint8_t *ptr) const;
+	uint32_t readUInt32(const uint8_t *ptr) const;
+	uint64_t readUInt64(const uint8_t *ptr) const;
+	bool has(const uint8_t *ptr, size_t bytes) const;
+	/**
+	 * @brief Compute the size of the payload of the given type at the given position
+	 * @return @c false if the data is truncated or invalid
+	 */
+	bool payloadSize(TagType type, const uint8_t *ptr, size_t &size, int depth) const;
+	/**
+	 * @brief Read a named tag header (type, name) at the given position of a compound
+	 */
+	NamedBinaryTagView namedTag(const uint8_t *ptr) const;
+	NamedBinaryTagView listElement(TagType type, const uint8_t *ptr) const;
+	template<class T>
+	NBTArrayView<T> array(TagType type) const;
+
+public:
+	NamedBinaryTagView() {
+	}
+
+	/**
+	 * @brief Parse the root tag of the given buffer
+	 * @param[in] bedrock Bedrock edition nbt data is little endian - java edition is big endian
+	 */
+	static NamedBinaryTagView parse(const uint8_t *buf, size_t size, bool bedrock = false);
+
+	class iterator;
+	friend class iterator;
+
+	iterator begin() const;
+	iterator end() const;
+
+	inline bool valid() const {
+		return _tagType != TagType::MAX;
+	}
+
+	inline TagType type() const {
+		return _tagType;
+	}
+
+	/**
+	 * @brief The name of the tag if this is a child of a compound - not null terminated
+	 */
+	inline const char *name() const {
+		return _name;
+	}
+
+	inline size_t nameLength() const {
+		return _nameLength;
+	}
+
+	bool isName(const char *name) const;
+
+	/**
+	 * @brief The amount of children of a compound (this has to iterate the compound) or elements of a list and arrays
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief The element type of a list
+	 */
+	TagType listType() const;
+
+	/**
+	 * @brief Look up the child of a compound by its name - the compound is iterated and all other subtrees are skipped
+	 * @return An invalid view if the tag is not a compound or the key was not found
+	 */
+	NamedBinaryTagView get(const char *name) const;
+
+	int8_t int8(int8_t defaultVal = 0) const;
+	int16_t int16(int16_t defaultVal = 0) const;
+	int32_t int32(int32_t defaultVal = 0) const;
+	int64_t int64(int64_t defaultVal = 0) const;
+	float float32(float defaultVal = 0.0f) const;
+	double float64(double defaultVal = 0.0) const;
+
+	/**
+	 * @brief Access the string payload without allocating - the data is not null terminated
+	 * @return @c nullptr if this is no string tag
+	 */
+	const char *string(size_t &length) const;
+	/**
+	 * @note This allocates - use @c string(size_t&) or @c isString() if possible
+	 */
+	core::String stringValue() const;
+	bool isString(const char *str) const;
+
+	NBTByteArrayView byteArray() const;
+	NBTIntArrayView intArray() const;
+	NBTLongArrayView longArray() const;
+};
+
+/**
+ * @brief Iterator over the children of a compound or the elements of a list
+ */
+class NamedBinaryTagView::iterator {
+private:
+	// the parent compound or list - this is a copy to allow iterating over temporary views
+	NamedBinaryTagView _parent;
+	NamedBinaryTagView _current;
+	uint32_t _remaining = 0u;
+
+public:
+	iterator() {
+	}
+	iterator(const NamedBinaryTagView &parent, const NamedBinaryTagView &current, uint32_t remaining)
+		: _parent(parent), _current(current), _remaining(remaining) {
+	}
+
+	inline const NamedBinaryTagView &operator*() const {
+		return _current;
+	}
+
+	inline const NamedBinaryTagView *operator->() const {
+		return &_current;
+	}
+
+	iterator &operator++();
+
+	inline bool operator!=(const iterator &rhs) const {
+		return _current._payload != rhs._current._payload;
+	}
+
+	inline bool operator==(const iterator &rhs) const {
+		return _current._payload == rhs._current._payload;
+	}
+};
+
+} // namespace priv
+} // namespace voxelformat
@@ -6,6 +6,7 @@
 #include "MCRFormat.h"
 #include "MinecraftPaletteMap.h"
 #include "NamedBinaryTag.h"
+#include "NamedBinaryTagView.h"
 #include "core/Common.h"
 #include "core/ConfigVar.h"
 #include "core/Log.h"
@@ -13,6 +14,7 @@
 #include "core/StringUtil.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
+#include "io/BufferedReadWriteStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "palette/Palette.h"
@@ -97,28 +99,34 @@ bool SchematicFormat::loadGroupsPalette(const core::String &filename, const io::
 		return loaded;
 	}
 
+	// inflate the nbt data into one buffer and look up the tags directly in that buffer instead of building the full
+	// nbt tree with an allocation for every tag
 	io::ZipReadStream zipStream(*stream);
-	priv::NamedBinaryTagContext ctx;
-	ctx.stream = &zipStream;
-	priv::NamedBinaryTag root(priv::NamedBinaryTag::parse(ctx));
-	const priv::NamedBinaryTag *schematic = &root;
-	if (root.get("Schematic").valid()) {
-		schematic = &root.get("Schematic");
+	io::BufferedReadWriteStream nbtData(stream->size() * 4);
+	if (!nbtData.writeStream(zipStream)) {
+		Log::error("Could not decompress nbt data");
+		return false;
+	}
+	const priv::NamedBinaryTagView &root = priv::NamedBinaryTagView::parse(nbtData.getBuffer(), nbtData.size());
+	priv::NamedBinaryTagView schematic = root;
+	const priv::NamedBinaryTagView &schematicTag = root.get("Schematic");
+	if (schematicTag.valid()) {
+		schematic = schematicTag;
 	}
-	if (!schematic->valid()) {
+	if (!schematic.valid()) {
 		Log::error("Could not find 'Schematic' tag");
 		return false;
 	}
 
 	if (extension == "nbt") {
-		const int dataVersion = schematic->get("DataVersion").int32(-1);
-		if (nbt::loadGroupsPalette(*schematic, sceneGraph, palette, dataVersion)) {
+		const int dataVersion = schematic.get("DataVersion").int32(-1);
+		if (nbt::loadGroupsPalette(schematic, sceneGraph, palette, dataVersion)) {
 			separateWaterVolumes(sceneGraph);
 			loadctx.setProgress(1.0f);
 			return true;
 		}
 	} else if (extension == "litematic") {
-		const bool loaded = litematic::loadGroupsPalette(*schematic, sceneGraph, palette);
+		const bool loaded = litematic::loadGroupsPalette(schematic, sceneGraph, palette);
 		if (loaded) {
 			separateWaterVolumes(sceneGraph);
 			loadctx.setProgress(1.0f);
@@ -126,15 +134,15 @@ bool SchematicFormat::loadGroupsPalette(const core::String &filename, const io::
 		return loaded;
 	}
 
-	int version = schematic->get("Version").int32(-1);
+	int version = schematic.get("Version").int32(-1);
 	if (version >= 3) {
-		if (sponge::loadGroupsPaletteSponge3(*schematic, sceneGraph, palette, version)) {
+		if (sponge::loadGroupsPaletteSponge3(schematic, sceneGraph, palette, version)) {
 			separateWaterVolumes(sceneGraph);
 			loadctx.setProgress(1.0f);
 			return true;
 		}
 	}
-	const bool loaded = sponge::loadGroupsPaletteSponge1And2(*schematic, sceneGraph, palette);
+	const bool loaded = sponge::loadGroupsPaletteSponge1And2(schematic, sceneGraph, palette);
 	if (loaded) {
 		separateWaterVolumes(sceneGraph);
 		loadctx.setProgress(1.0f);
@@ -4,22 +4,22 @@
 
 #pragma once
 
-#include "core/collection/Buffer.h"
+#include "../NamedBinaryTagView.h"
 
 namespace voxelformat {
 namespace schematic {
 
 class IntReader {
 private:
-	const core::Buffer<int8_t> *_blocks;
+	priv::NBTByteArrayView _blocks;
 	int _index = 0;
 
 public:
-	IntReader(const core::Buffer<int8_t> *blocks) : _blocks(blocks) {
+	IntReader(const priv::NBTByteArrayView &blocks) : _blocks(blocks) {
 	}
 
 	bool eos() const {
-		if (_index >= (int)_blocks->size()) {
+		if (_index >= (int)_blocks.size()) {
 			return true;
 		}
 		return false;
@@ -31,10 +31,10 @@ public:
 		}
 		int value = 0;
 		for (int bitsRead = 0;; bitsRead += 7) {
-			if (_index >= (int)_blocks->size()) {
+			if (_index >= (int)_blocks.size()) {
 				return -1;
 			}
-			uint8_t next = (*_blocks)[_index];
+			uint8_t next = _blocks[_index];
 			_index++;
 			value |= (next & 0x7F) << bitsRead;
 			if (bitsRead > 7 * 5) {
@@ -12,10 +12,10 @@ namespace voxelformat {
 namespace litematic {
 
 static bool readLitematicBlockStates(const glm::ivec3 &size, int nbtPaletteSize,
-									 const priv::NamedBinaryTag &blockStates, scenegraph::SceneGraphNode &node,
+									 const priv::NamedBinaryTagView &blockStates, scenegraph::SceneGraphNode &node,
 									 const schematic::SchematicPalette &mcpal, const schematic::SchematicWaterPalette &waterPal) {
-	const core::Buffer<int64_t> *data = blockStates.longArray();
-	if (data == nullptr) {
+	const priv::NBTLongArrayView &data = blockStates.longArray();
+	if (data.empty()) {
 		Log::error("Invalid BlockStates - expected long array");
 		return false;
 	}
@@ -45,17 +45,17 @@ static bool readLitematicBlockStates(const glm::ivec3 &size, int nbtPaletteSize,
 					const uint64_t rshiftVal = startBit & 63;
 					const uint64_t endIdx = startBit % 64 + bits;
 					uint64_t id = 0;
-					if (endIdx <= 64 && startIdx < data->size()) {
-						id = (uint64_t)((*data)[startIdx]) >> rshiftVal & mask;
+					if (endIdx <= 64 && startIdx < data.size()) {
+						id = (uint64_t)(data[startIdx]) >> rshiftVal & mask;
 					} else {
-						if (startIdx >= data->size() || startIdx + 1 >= data->size()) {
+						if (startIdx >= data.size() || startIdx + 1 >= data.size()) {
 							Log::error("Invalid BlockStates, out of bounds, start_state: %i, max size: %i, endnum: %i",
-									   (int)startIdx, (int)data->size(), (int)endIdx);
+									   (int)startIdx, (int)data.size(), (int)endIdx);
 							success = false;
 							return;
 						}
 						uint64_t move_num_2 = 64 - rshiftVal;
-						id = (((uint64_t)(*data)[startIdx]) >> rshiftVal | ((uint64_t)(*data)[startIdx + 1])
+						id = (((uint64_t)data[startIdx]) >> rshiftVal | ((uint64_t)data[startIdx + 1])
 																			   << move_num_2) &
 							 mask;
 					}
@@ -77,21 +77,19 @@ static bool readLitematicBlockStates(const glm::ivec3 &size, int nbtPaletteSize,
 	return success;
 }
 
-bool loadGroupsPalette(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPalette(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 					   palette::Palette &palette) {
-	const priv::NamedBinaryTag &versionNbt = schematic.get("Version");
+	const priv::NamedBinaryTagView &versionNbt = schematic.get("Version");
 	if (versionNbt.valid() && versionNbt.type() == priv::TagType::INT) {
 		const int version = versionNbt.int32();
 		Log::debug("version: %i", version);
-		const priv::NamedBinaryTag &regions = schematic.get("Regions");
-		if (!regions.compound()) {
+		const priv::NamedBinaryTagView &regions = schematic.get("Regions");
+		if (regions.type() != priv::TagType::COMPOUND) {
 			Log::error("Could not find valid 'Regions' compound tag");
 			return false;
 		}
-		const priv::NBTCompound regionsCompound = *regions.compound();
-		for (const auto &regionEntry : regionsCompound) {
-			const priv::NamedBinaryTag &regionCompound = regionEntry->second;
-			const core::String &name = regionEntry->first;
+		for (const priv::NamedBinaryTagView &regionCompound : regions) {
+			const core::String name(regionCompound.name(), regionCompound.nameLength());
 			const glm::ivec3 &pos = schematic::parsePosList(regionCompound, "Position");
 			const glm::ivec3 &size = glm::abs(schematic::parsePosList(regionCompound, "Size"));
 			const voxel::Region region({0, 0, 0}, size - 1);
@@ -99,25 +97,23 @@ bool loadGroupsPalette(const priv::NamedBinaryTag &schematic, scenegraph::SceneG
 				Log::error("Invalid region mins: %i %i %i maxs: %i %i %i", pos.x, pos.y, pos.z, size.x, size.y, size.z);
 				return false;
 			}
-			const priv::NamedBinaryTag &blockStatesPalette = regionCompound.get("BlockStatePalette");
+			const priv::NamedBinaryTagView &blockStatesPalette = regionCompound.get("BlockStatePalette");
 			if (!blockStatesPalette.valid() || blockStatesPalette.type() != priv::TagType::LIST) {
 				Log::error("Could not find 'BlockStatePalette'");
 				return false;
 			}
 
-			const priv::NBTList &blockStatePaletteNbt = *blockStatesPalette.list();
+			const int n = (int)blockStatesPalette.size();
 			schematic::SchematicPalette mcpal;
 			schematic::SchematicWaterPalette waterPal;
-			mcpal.resize(blockStatePaletteNbt.size());
-			waterPal.resize(blockStatePaletteNbt.size());
+			mcpal.resize(n);
+			waterPal.resize(n);
 			int paletteSize = 0;
-			for (const auto &palNbt : blockStatePaletteNbt) {
-				const priv::NamedBinaryTag &materialName = palNbt.get("Name");
-				schematic::setSchematicPaletteEntry(mcpal, waterPal, paletteSize++, materialName.string()->c_str());
+			for (const priv::NamedBinaryTagView &palNbt : blockStatesPalette) {
+				schematic::setSchematicPaletteEntry(mcpal, waterPal, paletteSize++, palNbt.get("Name").stringValue());
 			}
-			const int n = (int)blockStatePaletteNbt.size();
 
-			const priv::NamedBinaryTag &blockStates = regionCompound.get("BlockStates");
+			const priv::NamedBinaryTagView &blockStates = regionCompound.get("BlockStates");
 			if (!blockStates.valid() || blockStates.type() != priv::TagType::LONG_ARRAY) {
 				Log::error("Could not find 'BlockStates'");
 				return false;
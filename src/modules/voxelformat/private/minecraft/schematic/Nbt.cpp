@@ -11,14 +11,13 @@
 namespace voxelformat {
 namespace nbt {
 
-bool loadGroupsPalette(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPalette(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 					   palette::Palette &palette, int dataVersion) {
-	const priv::NamedBinaryTag &blocks = schematic.get("blocks");
+	const priv::NamedBinaryTagView &blocks = schematic.get("blocks");
 	if (blocks.valid() && blocks.type() == priv::TagType::LIST) {
-		const priv::NBTList &list = *blocks.list();
 		glm::ivec3 mins((std::numeric_limits<int32_t>::max)() / 2);
 		glm::ivec3 maxs((std::numeric_limits<int32_t>::min)() / 2);
-		for (const priv::NamedBinaryTag &compound : list) {
+		for (const priv::NamedBinaryTagView &compound : blocks) {
 			if (compound.type() != priv::TagType::COMPOUND) {
 				Log::error("Unexpected nbt type: %i", (int)compound.type());
 				return false;
@@ -29,15 +28,15 @@ bool loadGroupsPalette(const priv::NamedBinaryTag &schematic, scenegraph::SceneG
 		}
 		const voxel::Region region(mins, maxs);
 		voxel::RawVolume *volume = new voxel::RawVolume(region);
-		for (const priv::NamedBinaryTag &compound : list) {
+		for (const priv::NamedBinaryTagView &compound : blocks) {
 			const int state = compound.get("state").int32();
 			const glm::ivec3 v = schematic::parsePosList(compound, "pos");
 			volume->setVoxel(v, voxel::createVoxel(palette, state));
 		}
 		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-		const priv::NamedBinaryTag &author = schematic.get("author");
+		const priv::NamedBinaryTagView &author = schematic.get("author");
 		if (author.valid() && author.type() == priv::TagType::STRING) {
-			node.setProperty(scenegraph::PropAuthor, author.string());
+			node.setProperty(scenegraph::PropAuthor, author.stringValue());
 		}
 		node.setVolume(volume);
 		node.setPalette(palette);
@@ -4,13 +4,13 @@
 
 #pragma once
 
-#include "../NamedBinaryTag.h"
+#include "../NamedBinaryTagView.h"
 #include "scenegraph/SceneGraph.h"
 
 namespace voxelformat {
 namespace nbt {
 
-bool loadGroupsPalette(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPalette(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 					   palette::Palette &palette, int dataVersion);
 
 } // namespace nbt
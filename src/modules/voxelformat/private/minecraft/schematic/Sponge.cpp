@@ -13,9 +13,9 @@
 namespace voxelformat {
 namespace sponge {
 
-static int loadMCEdit2Palette(const priv::NamedBinaryTag &schematic, schematic::SchematicPalette &mcpal,
+static int loadMCEdit2Palette(const priv::NamedBinaryTagView &schematic, schematic::SchematicPalette &mcpal,
 							  schematic::SchematicWaterPalette &waterPal) {
-	const priv::NamedBinaryTag &blockIds = schematic.get("BlockIDs");
+	const priv::NamedBinaryTagView &blockIds = schematic.get("BlockIDs");
 	if (!blockIds.valid()) {
 		return -1;
 	}
@@ -23,40 +23,46 @@ static int loadMCEdit2Palette(const priv::NamedBinaryTag &schematic, schematic::
 	mcpal.resize(palette::PaletteMaxColors);
 	waterPal.resize(palette::PaletteMaxColors);
 	int paletteEntry = 0;
-	const int blockCnt = (int)blockIds.compound()->size();
+	const int blockCnt = (int)blockIds.size();
 	Log::debug("Loading BlockIDs with %i entries", blockCnt);
-	// TODO: FOR_PARALLEL
-	for (int i = 0; i < blockCnt; ++i) {
-		const priv::NamedBinaryTag &nbt = blockIds.get(core::String::format("%i", i));
-		const core::String *value = nbt.string();
-		if (value == nullptr) {
+	// the keys are the block ids - iterate the compound once instead of looking up every id
+	for (const priv::NamedBinaryTagView &nbt : blockIds) {
+		const core::String key(nbt.name(), nbt.nameLength());
+		if (!core::string::isInteger(key)) {
+			continue;
+		}
+		const int i = core::string::toInt(key);
+		if (i < 0 || i >= blockCnt) {
+			continue;
+		}
+		if (nbt.type() != priv::TagType::STRING) {
 			Log::warn("Empty string in BlockIDs for %i", i);
 			continue;
 		}
-		schematic::setSchematicPaletteEntry(mcpal, waterPal, i, *value);
+		schematic::setSchematicPaletteEntry(mcpal, waterPal, i, nbt.stringValue());
 		++paletteEntry;
 	}
 	return paletteEntry;
 }
 
-static int loadWorldEditPalette(const priv::NamedBinaryTag &schematic, schematic::SchematicPalette &mcpal,
+static int loadWorldEditPalette(const priv::NamedBinaryTagView &schematic, schematic::SchematicPalette &mcpal,
 								schematic::SchematicWaterPalette &waterPal) {
 	const int paletteMax = schematic.get("PaletteMax").int32(-1);
 	if (paletteMax == -1) {
 		return -1;
 	}
 	Log::debug("Found WorldEdit PaletteMax %i", paletteMax);
-	const priv::NamedBinaryTag &palette = schematic.get("Palette");
+	const priv::NamedBinaryTagView &palette = schematic.get("Palette");
 	if (palette.valid() && palette.type() == priv::TagType::COMPOUND) {
-		if ((int)palette.compound()->size() != paletteMax) {
+		if ((int)palette.size() != paletteMax) {
 			return -1;
 		}
 		mcpal.resize(paletteMax);
 		waterPal.resize(paletteMax);
 		int paletteEntry = 0;
-		for (const auto &c : *palette.compound()) {
-			const core::String &key = c->key;
-			const int palIdx = c->second.int32(-1);
+		for (const priv::NamedBinaryTagView &c : palette) {
+			const core::String key(c.name(), c.nameLength());
+			const int palIdx = c.int32(-1);
 			if (palIdx < 0) {
 				Log::warn("Failed to get int value for %s", key.c_str());
 				continue;
@@ -74,9 +80,9 @@ static int loadWorldEditPalette(const priv::NamedBinaryTag &schematic, schematic
 }
 
 // https://github.com/Lunatrius/Schematica/
-static int loadSchematicaPalette(const priv::NamedBinaryTag &schematic, schematic::SchematicPalette &mcpal,
+static int loadSchematicaPalette(const priv::NamedBinaryTagView &schematic, schematic::SchematicPalette &mcpal,
 								 schematic::SchematicWaterPalette &waterPal) {
-	const priv::NamedBinaryTag &schematicaMapping = schematic.get("SchematicaMapping");
+	const priv::NamedBinaryTagView &schematicaMapping = schematic.get("SchematicaMapping");
 	if (!schematicaMapping.valid()) {
 		return -1;
 	}
@@ -85,9 +91,9 @@ static int loadSchematicaPalette(const priv::NamedBinaryTag &schematic, schemati
 	}
 	Log::debug("Found SchematicaMapping");
 	int paletteEntry = 0;
-	for (const auto &c : *schematicaMapping.compound()) {
-		core::String key = c->key;
-		const int palIdx = c->second.int16(-1);
+	for (const priv::NamedBinaryTagView &c : schematicaMapping) {
+		const core::String key(c.name(), c.nameLength());
+		const int palIdx = c.int16(-1);
 		if (palIdx < 0) {
 			Log::warn("Failed to get int value for %s", key.c_str());
 			continue;
@@ -98,7 +104,7 @@ static int loadSchematicaPalette(const priv::NamedBinaryTag &schematic, schemati
 	return paletteEntry;
 }
 
-static int parsePalette(const priv::NamedBinaryTag &schematic, schematic::SchematicPalette &mcpal,
+static int parsePalette(const priv::NamedBinaryTagView &schematic, schematic::SchematicPalette &mcpal,
 						schematic::SchematicWaterPalette &waterPal) {
 	int paletteEntry = loadMCEdit2Palette(schematic, mcpal, waterPal);
 	if (paletteEntry != -1) {
@@ -116,15 +122,15 @@ static int parsePalette(const priv::NamedBinaryTag &schematic, schematic::Schema
 	return -1;
 }
 
-static void addMetadata_r(const core::String &key, const priv::NamedBinaryTag &nbt, scenegraph::SceneGraph &sceneGraph,
+static void addMetadata_r(const core::String &key, const priv::NamedBinaryTagView &nbt, scenegraph::SceneGraph &sceneGraph,
 						  scenegraph::SceneGraphNode &node) {
 	switch (nbt.type()) {
 	case priv::TagType::COMPOUND: {
 		scenegraph::SceneGraphNode compoundNode(scenegraph::SceneGraphNodeType::Group);
 		compoundNode.setName(key);
 		int nodeId = sceneGraph.emplace(core::move(compoundNode), node.id());
-		for (const auto &e : *nbt.compound()) {
-			addMetadata_r(e->key, e->value, sceneGraph, sceneGraph.node(nodeId));
+		for (const priv::NamedBinaryTagView &e : nbt) {
+			addMetadata_r(core::String(e.name(), e.nameLength()), e, sceneGraph, sceneGraph.node(nodeId));
 		}
 		break;
 	}
@@ -148,14 +154,13 @@ static void addMetadata_r(const core::String &key, const priv::NamedBinaryTag &n
 		node.setProperty(key, core::string::toString(nbt.float64()));
 		break;
 	case priv::TagType::STRING:
-		node.setProperty(key, nbt.string());
+		node.setProperty(key, nbt.stringValue());
 		break;
 	case priv::TagType::LIST: {
-		const priv::NBTList &list = *nbt.list();
 		scenegraph::SceneGraphNode listNode(scenegraph::SceneGraphNodeType::Group);
-		listNode.setName(core::String::format("%s: %i", key.c_str(), (int)list.size()));
+		listNode.setName(core::String::format("%s: %i", key.c_str(), (int)nbt.size()));
 		int nodeId = sceneGraph.emplace(core::move(listNode), node.id());
-		for (const priv::NamedBinaryTag &e : list) {
+		for (const priv::NamedBinaryTagView &e : nbt) {
 			addMetadata_r(key, e, sceneGraph, sceneGraph.node(nodeId));
 		}
 		break;
@@ -174,15 +179,17 @@ static void addMetadata_r(const core::String &key, const priv::NamedBinaryTag &n
 	}
 }
 
-static void parseMetadata(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+static void parseMetadata(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 						  scenegraph::SceneGraphNode &node) {
-	const priv::NamedBinaryTag &metadata = schematic.get("Metadata");
+	const priv::NamedBinaryTagView &metadata = schematic.get("Metadata");
 	if (metadata.valid()) {
-		if (const core::String *str = metadata.get("Name").string()) {
-			node.setName(*str);
+		const priv::NamedBinaryTagView &name = metadata.get("Name");
+		if (name.type() == priv::TagType::STRING) {
+			node.setName(name.stringValue());
 		}
-		if (const core::String *str = metadata.get("Author").string()) {
-			node.setProperty(scenegraph::PropAuthor, *str);
+		const priv::NamedBinaryTagView &author = metadata.get("Author");
+		if (author.type() == priv::TagType::STRING) {
+			node.setProperty(scenegraph::PropAuthor, author.stringValue());
 		}
 	}
 	const int version = schematic.get("Version").int32(-1);
@@ -190,13 +197,13 @@ static void parseMetadata(const priv::NamedBinaryTag &schematic, scenegraph::Sce
 		node.setProperty(scenegraph::PropVersion, core::string::toString(version));
 	}
 	core_assert_msg(node.id() != -1, "The node should already be part of the scene graph");
-	for (const auto &e : *schematic.compound()) {
-		addMetadata_r(e->key, e->value, sceneGraph, node);
+	for (const priv::NamedBinaryTagView &e : schematic) {
+		addMetadata_r(core::String(e.name(), e.nameLength()), e, sceneGraph, node);
 	}
 }
 
-static bool parseVarIntBlockData(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
-								 palette::Palette &palette, const core::Buffer<int8_t> *blocks,
+static bool parseVarIntBlockData(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
+								 palette::Palette &palette, const priv::NBTByteArrayView &blocks,
 								 const schematic::SchematicPalette &mcpal, const schematic::SchematicWaterPalette &waterPal,
 								 int paletteEntry) {
 	const int16_t width = schematic.get("Width").int16();
@@ -258,21 +265,20 @@ static bool parseVarIntBlockData(const priv::NamedBinaryTag &schematic, scenegra
 	return true;
 }
 
-static bool parseBlockData(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
-						   palette::Palette &palette, const priv::NamedBinaryTag &blockData) {
-	const core::Buffer<int8_t> *blocks = blockData.byteArray();
-	if (blocks == nullptr) {
+static bool parseBlockData(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
+						   palette::Palette &palette, const priv::NamedBinaryTagView &blockData) {
+	if (blockData.type() != priv::TagType::BYTE_ARRAY) {
 		Log::error("Invalid BlockData - expected byte array");
 		return false;
 	}
 	schematic::SchematicPalette mcpal;
 	schematic::SchematicWaterPalette waterPal;
 	const int paletteEntry = parsePalette(schematic, mcpal, waterPal);
-	return parseVarIntBlockData(schematic, sceneGraph, palette, blocks, mcpal, waterPal, paletteEntry);
+	return parseVarIntBlockData(schematic, sceneGraph, palette, blockData.byteArray(), mcpal, waterPal, paletteEntry);
 }
 
-static bool parseBlocks(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
-						palette::Palette &palette, const priv::NamedBinaryTag &blocks, int version) {
+static bool parseBlocks(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
+						palette::Palette &palette, const priv::NamedBinaryTagView &blocks, int version) {
 	schematic::SchematicPalette mcpal;
 	schematic::SchematicWaterPalette waterPal;
 	const int paletteEntry = parsePalette(schematic, mcpal, waterPal);
@@ -288,7 +294,8 @@ static bool parseBlocks(const priv::NamedBinaryTag &schematic, scenegraph::Scene
 
 	const voxel::Region region(0, 0, 0, width - 1, height - 1, depth - 1);
 	voxel::RawVolume *volume = new voxel::RawVolume(region);
-	auto fn = [volume, depth, height, width, blocks, paletteEntry, &mcpal, &waterPal, &palette](int start, int end) {
+	const priv::NBTByteArrayView &blockData = blocks.byteArray();
+	auto fn = [volume, depth, height, width, &blockData, paletteEntry, &mcpal, &waterPal, &palette](int start, int end) {
 		voxel::RawVolume::Sampler sampler(volume);
 		sampler.setPosition(0, 0, start);
 		for (int z = start; z < end; ++z) {
@@ -298,7 +305,7 @@ static bool parseBlocks(const priv::NamedBinaryTag &schematic, scenegraph::Scene
 				const int64_t stride = ((int64_t)y * depth + z) * width;
 				for (int x = 0; x < width; ++x) {
 					const int64_t idx = stride + x;
-					const uint8_t palIdx = (*blocks.byteArray())[idx];
+					const uint8_t palIdx = blockData[idx];
 					if (palIdx != 0u) {
 						uint8_t currentPalIdx;
 						if (paletteEntry == 0 || palIdx > (uint8_t)paletteEntry) {
@@ -336,10 +343,10 @@ static bool parseBlocks(const priv::NamedBinaryTag &schematic, scenegraph::Scene
 	return true;
 }
 
-bool loadGroupsPaletteSponge1And2(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPaletteSponge1And2(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 								  palette::Palette &palette) {
 	Log::debug("WorldEdit legacy");
-	const priv::NamedBinaryTag &blockData = schematic.get("BlockData");
+	const priv::NamedBinaryTagView &blockData = schematic.get("BlockData");
 	if (blockData.valid() && blockData.type() == priv::TagType::BYTE_ARRAY) {
 		return parseBlockData(schematic, sceneGraph, palette, blockData);
 	}
@@ -347,28 +354,28 @@ bool loadGroupsPaletteSponge1And2(const priv::NamedBinaryTag &schematic, scenegr
 	return false;
 }
 
-bool loadGroupsPaletteSponge3(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPaletteSponge3(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 							  palette::Palette &palette, int version) {
 	Log::debug("Sponge 3");
-	const priv::NamedBinaryTag &blocks = schematic.get("Blocks");
+	const priv::NamedBinaryTagView &blocks = schematic.get("Blocks");
 	if (blocks.valid() && blocks.type() == priv::TagType::BYTE_ARRAY) {
 		return parseBlocks(schematic, sceneGraph, palette, blocks, version);
 	}
 	// Sponge v3 stores Blocks as a compound with Data (byte array) and Palette (compound)
 	if (blocks.valid() && blocks.type() == priv::TagType::COMPOUND) {
-		const priv::NamedBinaryTag &data = blocks.get("Data");
+		const priv::NamedBinaryTagView &data = blocks.get("Data");
 		if (!data.valid() || data.type() != priv::TagType::BYTE_ARRAY) {
 			Log::error("Could not find valid 'Data' tag in 'Blocks' compound");
 			return false;
 		}
-		const priv::NamedBinaryTag &blockPalette = blocks.get("Palette");
+		const priv::NamedBinaryTagView &blockPalette = blocks.get("Palette");
 		schematic::SchematicPalette mcpal;
 		schematic::SchematicWaterPalette waterPal;
 		int paletteEntry = 0;
 		if (blockPalette.valid() && blockPalette.type() == priv::TagType::COMPOUND) {
-			for (const auto &c : *blockPalette.compound()) {
-				const core::String &key = c->key;
-				const int palIdx = c->second.int32(-1);
+			for (const priv::NamedBinaryTagView &c : blockPalette) {
+				const core::String key(c.name(), c.nameLength());
+				const int palIdx = c.int32(-1);
 				if (palIdx < 0) {
 					Log::warn("Failed to get int value for %s", key.c_str());
 					continue;
@@ -4,15 +4,15 @@
 
 #pragma once
 
-#include "../NamedBinaryTag.h"
+#include "../NamedBinaryTagView.h"
 #include "scenegraph/SceneGraph.h"
 
 namespace voxelformat {
 namespace sponge {
 
-bool loadGroupsPaletteSponge1And2(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPaletteSponge1And2(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 								  palette::Palette &palette);
-bool loadGroupsPaletteSponge3(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
+bool loadGroupsPaletteSponge3(const priv::NamedBinaryTagView &schematic, scenegraph::SceneGraph &sceneGraph,
 							  palette::Palette &palette, int version);
 
 } // namespace sponge
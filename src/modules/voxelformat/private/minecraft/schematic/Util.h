@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include "../NamedBinaryTag.h"
+#include "../NamedBinaryTagView.h"
 #include "core/collection/Buffer.h"
 #include <glm/fwd.hpp>
 
@@ -22,7 +22,7 @@ namespace schematic {
 using SchematicPalette = core::Buffer<int>;
 using SchematicWaterPalette = core::Buffer<uint8_t>;
 
-glm::ivec3 parsePosList(const priv::NamedBinaryTag &compound, const core::String &key);
+glm::ivec3 parsePosList(const priv::NamedBinaryTagView &compound, const char *key);
 void setSchematicPaletteEntry(SchematicPalette &colors, SchematicWaterPalette &water, int idx, const core::String &blockName);
 bool schematicPaletteEntryIsWater(const SchematicWaterPalette &water, int paletteIdx);
 voxel::Voxel createSchematicVoxel(const palette::Palette &palette, uint8_t colorIdx, bool water);
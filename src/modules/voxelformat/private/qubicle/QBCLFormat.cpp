@@ -23,6 +23,7 @@
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
+#include "voxelformat/NodeEncoder.h"
 #include <glm/gtc/type_ptr.hpp>
 
 namespace voxelformat {
@@ -140,39 +141,16 @@ static bool writeRLE(io::WriteStream &stream, color::RGBA color, uint8_t count)
 	return true;
 }
 
-bool QBCLFormat::saveMatrix(io::SeekableWriteStream &outStream, const scenegraph::SceneGraph &sceneGraph,
-							const scenegraph::SceneGraphNode &node) const {
+// the rle encoded and zlib compressed voxel data of a matrix - encoded concurrently for all matrices
+static bool encodeMatrix(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+						 io::SeekableWriteStream &outStream) {
 	const voxel::Region &region = sceneGraph.resolveRegion(node);
-	const scenegraph::SceneGraphTransform &transform = node.transform(0);
-	const glm::ivec3 &translation = transform.localTranslation();
 	const glm::ivec3 &mins = region.getLowerCorner();
 	const glm::ivec3 &maxs = region.getUpperCorner();
 	const glm::ivec3 size = region.getDimensionsInVoxels();
 
-	wrapSave(outStream.writeUInt32(1)) // unknown
-	wrapSave(outStream.writePascalStringUInt32LE(node.name()))
-	wrapSave(outStream.writeBool(node.visible()))
-	wrapSave(outStream.writeBool(true)) // unknown
-	wrapSave(outStream.writeBool(node.locked()))
-
-	wrapSave(outStream.writeUInt32(size.x))
-	wrapSave(outStream.writeUInt32(size.y))
-	wrapSave(outStream.writeUInt32(size.z))
-
-	wrapSave(outStream.writeInt32(translation.x))
-	wrapSave(outStream.writeInt32(translation.y))
-	wrapSave(outStream.writeInt32(translation.z))
-
-	const glm::vec3 &normalizedPivot = node.pivot();
-	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.x +*/ normalizedPivot.x * size.x))
-	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.y +*/ normalizedPivot.y * size.y))
-	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.z +*/ normalizedPivot.z * size.z))
-
 	constexpr voxel::Voxel Empty;
 
-	uint32_t voxelDataSizePos = outStream.pos();
-	wrapSave(outStream.writeUInt32(0));
-
 	io::BufferedReadWriteStream rleDataStream(size.x * size.y * size.z * 32);
 
 	const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
@@ -222,30 +200,81 @@ bool QBCLFormat::saveMatrix(io::SeekableWriteStream &outStream, const scenegraph
 		return false;
 	}
 	wrapSave(zipStream.flush())
-	const int64_t compressedDataSize = zipStream.size();
-	wrapSaveNegative(outStream.seek(voxelDataSizePos))
-	wrapSave(outStream.writeUInt32(compressedDataSize))
-	wrapSaveNegative(outStream.seek(0, SEEK_END))
+	return true;
+}
+
+void QBCLFormat::addMatrixJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+							   const scenegraph::SceneGraphNode &node) const {
+	const scenegraph::SceneGraphNodeType type = node.type();
+	if (node.isAnyModelNode()) {
+		const voxel::Region &region = sceneGraph.resolveRegion(node);
+		encoder.add(node, (size_t)region.voxels() * sizeof(uint32_t));
+	} else if (type != scenegraph::SceneGraphNodeType::Group && type != scenegraph::SceneGraphNodeType::Root) {
+		return;
+	}
+	for (const core::UUID &childUUID : node.children()) {
+		const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
+		if (child == nullptr) {
+			continue;
+		}
+		addMatrixJobs(encoder, sceneGraph, *child);
+	}
+}
+
+bool QBCLFormat::saveMatrix(io::SeekableWriteStream &outStream, const scenegraph::SceneGraph &sceneGraph,
+							const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
+	const voxel::Region &region = sceneGraph.resolveRegion(node);
+	const scenegraph::SceneGraphTransform &transform = node.transform(0);
+	const glm::ivec3 &translation = transform.localTranslation();
+	const glm::ivec3 size = region.getDimensionsInVoxels();
+
+	const io::BufferedReadWriteStream *compressed = encoder.next();
+	if (compressed == nullptr) {
+		Log::error("Could not save qbcl file: failed to compress the matrix %s", node.name().c_str());
+		return false;
+	}
+
+	wrapSave(outStream.writeUInt32(1)) // unknown
+	wrapSave(outStream.writePascalStringUInt32LE(node.name()))
+	wrapSave(outStream.writeBool(node.visible()))
+	wrapSave(outStream.writeBool(true)) // unknown
+	wrapSave(outStream.writeBool(node.locked()))
+
+	wrapSave(outStream.writeUInt32(size.x))
+	wrapSave(outStream.writeUInt32(size.y))
+	wrapSave(outStream.writeUInt32(size.z))
+
+	wrapSave(outStream.writeInt32(translation.x))
+	wrapSave(outStream.writeInt32(translation.y))
+	wrapSave(outStream.writeInt32(translation.z))
+
+	const glm::vec3 &normalizedPivot = node.pivot();
+	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.x +*/ normalizedPivot.x * size.x))
+	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.y +*/ normalizedPivot.y * size.y))
+	wrapSave(outStream.writeFloat(/* TODO: VOXELFORMAT: mins.z +*/ normalizedPivot.z * size.z))
+
+	wrapSave(outStream.writeUInt32((uint32_t)compressed->size()))
+	wrapSaveNegative(outStream.write(compressed->getBuffer(), compressed->size()))
 
 	return true;
 }
 
 bool QBCLFormat::saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-							  const scenegraph::SceneGraphNode &node) const {
-	wrapSave(saveMatrix(stream, sceneGraph, node))
+							  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
+	wrapSave(saveMatrix(stream, sceneGraph, node, encoder))
 	wrapSave(stream.writeUInt32((int)node.children().size()));
 	for (const core::UUID &childUUID : node.children()) {
 		const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
 		if (child == nullptr) {
 			continue;
 		}
-		wrapSave(saveNode(stream, sceneGraph, *child))
+		wrapSave(saveNode(stream, sceneGraph, *child, encoder))
 	}
 	return true;
 }
 
 bool QBCLFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						   const scenegraph::SceneGraphNode &node) const {
+						   const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
 	const uint32_t children = (uint32_t)node.children().size();
 	qbcl::ScopedQBCLHeader header(stream, node.type());
 	wrapSave(stream.writeUInt32(1)) // unknown
@@ -266,25 +295,25 @@ bool QBCLFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::Sc
 		if (child == nullptr) {
 			continue;
 		}
-		wrapSave(saveNode(stream, sceneGraph, *child))
+		wrapSave(saveNode(stream, sceneGraph, *child, encoder))
 	}
 
 	return true;
 }
 
 bool QBCLFormat::saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						  const scenegraph::SceneGraphNode &node) const {
+						  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
 	const scenegraph::SceneGraphNodeType type = node.type();
 	if (node.isAnyModelNode()) {
 		if (node.children().empty()) {
 			qbcl::ScopedQBCLHeader header(stream, node.type());
-			wrapSave(saveMatrix(stream, sceneGraph, node) && header.success())
+			wrapSave(saveMatrix(stream, sceneGraph, node, encoder) && header.success())
 		} else {
 			qbcl::ScopedQBCLHeader scoped(stream, qbcl::NODE_TYPE_COMPOUND);
-			wrapSave(saveCompound(stream, sceneGraph, node) && scoped.success())
+			wrapSave(saveCompound(stream, sceneGraph, node, encoder) && scoped.success())
 		}
 	} else if (type == scenegraph::SceneGraphNodeType::Group || type == scenegraph::SceneGraphNodeType::Root) {
-		wrapSave(saveModel(stream, sceneGraph, node))
+		wrapSave(saveModel(stream, sceneGraph, node, encoder))
 	}
 	return true;
 }
@@ -338,7 +367,11 @@ bool QBCLFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 	wrapSave(stream->writePascalStringUInt32LE(rootNode.property(scenegraph::PropCopyright)))
 	wrapSave(stream->writeUInt64(0)) // timestamp1
 	wrapSave(stream->writeUInt64(0)) // timestamp2
-	return saveNode(*stream, sceneGraph, sceneGraph.root());
+	NodeEncoder encoder([&sceneGraph](const scenegraph::SceneGraphNode &node, io::SeekableWriteStream &out) {
+		return encodeMatrix(sceneGraph, node, out);
+	});
+	addMatrixJobs(encoder, sceneGraph, sceneGraph.root());
+	return saveNode(*stream, sceneGraph, sceneGraph.root(), encoder);
 }
 
 size_t QBCLFormat::loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
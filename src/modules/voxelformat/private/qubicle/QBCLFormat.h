@@ -9,6 +9,8 @@
 
 namespace voxelformat {
 
+class NodeEncoder;
+
 /**
  * @brief Qubicle project file (qbcl) format.
  *
@@ -44,14 +46,19 @@ private:
 		bool unknown;
 		bool locked;
 	};
+	/**
+	 * @brief Register the matrix payloads in the order @c saveNode() writes them
+	 */
+	void addMatrixJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+					   const scenegraph::SceneGraphNode &node) const;
 	bool saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					const scenegraph::SceneGraphNode &node) const;
+					const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				   const scenegraph::SceneGraphNode &node) const;
+				   const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				  const scenegraph::SceneGraphNode &node) const;
+				  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					  const scenegraph::SceneGraphNode &node) const;
+					  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 
 	bool readHeader(io::SeekableReadStream &stream, Header &header);
 	bool readMatrix(const core::String &filename, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
@@ -17,6 +17,7 @@
 #include "io/ZipWriteStream.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxelformat/NodeEncoder.h"
 #include "voxel/MaterialColor.h"
 #include "palette/Palette.h"
 #include "voxel/RawVolume.h"
@@ -130,18 +131,18 @@ public:
 		return false;                                                                                                  \
 	}
 
-bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						   const scenegraph::SceneGraphNode &node, bool colorMap) const {
+namespace qbt {
+
+// the zlib compressed voxel data of a matrix - encoded concurrently for all matrices
+bool encodeMatrix(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node, bool colorMap,
+				  io::SeekableWriteStream &stream) {
 	const voxel::Region &region = sceneGraph.resolveRegion(node);
 	const glm::ivec3 &mins = region.getLowerCorner();
 	const glm::ivec3 &maxs = region.getUpperCorner();
-	const glm::ivec3 size = region.getDimensionsInVoxels();
 
 	const palette::Palette &palette = node.palette();
 
-	const int zlibBufSize = size.x * size.y * size.z * (int)sizeof(uint32_t);
-	io::BufferedReadWriteStream bufferStream(zlibBufSize);
-	io::ZipWriteStream zipStream(bufferStream);
+	io::ZipWriteStream zipStream(stream);
 
 	const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
 	for (int x = mins.x; x <= maxs.x; ++x) {
@@ -173,7 +174,37 @@ bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::Sc
 		}
 	}
 
-	zipStream.flush();
+	return zipStream.flush();
+}
+
+} // namespace qbt
+
+void QBTFormat::addMatrixJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+							  const scenegraph::SceneGraphNode &node) const {
+	const scenegraph::SceneGraphNodeType type = node.type();
+	if (node.isAnyModelNode()) {
+		const voxel::Region &region = sceneGraph.resolveRegion(node);
+		encoder.add(node, (size_t)region.voxels() * sizeof(uint32_t));
+	} else if (type != scenegraph::SceneGraphNodeType::Group && type != scenegraph::SceneGraphNodeType::Root) {
+		return;
+	}
+	for (const core::UUID &childUUID : node.children()) {
+		const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
+		if (child == nullptr) {
+			continue;
+		}
+		addMatrixJobs(encoder, sceneGraph, *child);
+	}
+}
+
+bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
+						   const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
+	const glm::ivec3 size = sceneGraph.resolveRegion(node).getDimensionsInVoxels();
+	const io::BufferedReadWriteStream *bufferStream = encoder.next();
+	if (bufferStream == nullptr) {
+		Log::error("Could not save qbt file: failed to compress the matrix %s", node.name().c_str());
+		return false;
+	}
 
 	wrapSave(stream.writePascalStringUInt32LE(node.name()));
 	Log::debug("Save matrix with name %s", node.name().c_str());
@@ -199,9 +230,9 @@ bool QBTFormat::saveMatrix(io::SeekableWriteStream &stream, const scenegraph::Sc
 	wrapSave(stream.writeUInt32(size.y));
 	wrapSave(stream.writeUInt32(size.z));
 
-	Log::debug("save %i compressed bytes", (int)bufferStream.size());
-	wrapSave(stream.writeUInt32(bufferStream.size()));
-	if (stream.write(bufferStream.getBuffer(), bufferStream.size()) == -1) {
+	Log::debug("save %i compressed bytes", (int)bufferStream->size());
+	wrapSave(stream.writeUInt32(bufferStream->size()));
+	if (stream.write(bufferStream->getBuffer(), bufferStream->size()) == -1) {
 		Log::error("Could not save qbt file: failed to write the compressed buffer");
 		return false;
 	}
@@ -223,45 +254,45 @@ bool QBTFormat::saveColorMap(io::SeekableWriteStream &stream, const palette::Pal
 }
 
 bool QBTFormat::saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-							 const scenegraph::SceneGraphNode &node, bool colorMap) const {
-	wrapSave(saveMatrix(stream, sceneGraph, node, colorMap))
+							 const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
+	wrapSave(saveMatrix(stream, sceneGraph, node, encoder))
 	wrapSave(stream.writeUInt32((int)node.children().size()));
 	for (const core::UUID &childUUID : node.children()) {
 		const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
 		if (child == nullptr) {
 			continue;
 		}
-		wrapSave(saveNode(stream, sceneGraph, *child, colorMap))
+		wrapSave(saveNode(stream, sceneGraph, *child, encoder))
 	}
 	return true;
 }
 
 bool QBTFormat::saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						 const scenegraph::SceneGraphNode &node, bool colorMap) const {
+						 const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
 	const scenegraph::SceneGraphNodeType type = node.type();
 	if (node.isAnyModelNode()) {
 		if (node.children().empty()) {
 			qbt::ScopedQBTHeader header(stream, type);
-			wrapSave(saveMatrix(stream, sceneGraph, node, colorMap) && header.success())
+			wrapSave(saveMatrix(stream, sceneGraph, node, encoder) && header.success())
 		} else {
 			qbt::ScopedQBTHeader scoped(stream, qbt::NODE_TYPE_COMPOUND);
-			wrapSave(saveCompound(stream, sceneGraph, node, colorMap) && scoped.success())
+			wrapSave(saveCompound(stream, sceneGraph, node, encoder) && scoped.success())
 		}
 	} else if (type == scenegraph::SceneGraphNodeType::Group || type == scenegraph::SceneGraphNodeType::Root) {
-		wrapSave(saveModel(stream, sceneGraph, node, colorMap))
+		wrapSave(saveModel(stream, sceneGraph, node, encoder))
 	}
 	return true;
 }
 
 bool QBTFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-						  const scenegraph::SceneGraphNode &node, bool colorMap) const {
+						  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const {
 	if (node.children().size() == 1) {
 		for (const core::UUID &childUUID : node.children()) {
 			const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
 			if (child == nullptr) {
 				continue;
 			}
-			wrapSave(saveNode(stream, sceneGraph, *child, colorMap))
+			wrapSave(saveNode(stream, sceneGraph, *child, encoder))
 		}
 		return true;
 	}
@@ -273,7 +304,7 @@ bool QBTFormat::saveModel(io::SeekableWriteStream &stream, const scenegraph::Sce
 		if (child == nullptr) {
 			continue;
 		}
-		wrapSave(saveNode(stream, sceneGraph, *child, colorMap))
+		wrapSave(saveNode(stream, sceneGraph, *child, encoder))
 	}
 	return scoped.success();
 }
@@ -314,7 +345,11 @@ bool QBTFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core:
 	if (!stream->writeString("DATATREE", false)) {
 		return false;
 	}
-	return saveNode(*stream, sceneGraph, sceneGraph.root(), colorMap);
+	NodeEncoder encoder([&sceneGraph, colorMap](const scenegraph::SceneGraphNode &node, io::SeekableWriteStream &out) {
+		return qbt::encodeMatrix(sceneGraph, node, colorMap, out);
+	});
+	addMatrixJobs(encoder, sceneGraph, sceneGraph.root());
+	return saveNode(*stream, sceneGraph, sceneGraph.root(), encoder);
 }
 
 bool QBTFormat::skipNode(io::SeekableReadStream &stream) {
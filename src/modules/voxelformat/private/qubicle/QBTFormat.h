@@ -9,6 +9,8 @@
 
 namespace voxelformat {
 
+class NodeEncoder;
+
 /**
  * @brief Qubicle Binary Tree (qbt) is the successor of the widespread voxel exchange format Qubicle Binary. It supports
  * palette and RGBA mode
@@ -47,15 +49,20 @@ private:
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 						   const LoadContext &ctx) override;
 
+	/**
+	 * @brief Register the matrix payloads in the order @c saveNode() writes them
+	 */
+	void addMatrixJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+					   const scenegraph::SceneGraphNode &node) const;
 	bool saveNode(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				  const scenegraph::SceneGraphNode &node, bool colorMap) const;
+				  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveCompound(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					  const scenegraph::SceneGraphNode &node, bool colorMap) const;
+					  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveMatrix(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-					const scenegraph::SceneGraphNode &node, bool colorMap) const;
+					const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveColorMap(io::SeekableWriteStream &stream, const palette::Palette &palette) const;
 	bool saveModel(io::SeekableWriteStream &stream, const scenegraph::SceneGraph &sceneGraph,
-				   const scenegraph::SceneGraphNode &node, bool colorMap) const;
+				   const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) const;
 	bool saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 					const io::ArchivePtr &archive, const SaveContext &ctx) override;
 
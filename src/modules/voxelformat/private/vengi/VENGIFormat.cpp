@@ -3,6 +3,7 @@
  */
 
 #include "VENGIFormat.h"
+#include "app/App.h"
 #include "core/ArrayLength.h"
 #include "core/FourCC.h"
 #include "core/ConfigVar.h"
@@ -10,6 +11,7 @@
 #include "core/ScopedPtr.h"
 #include "core/Var.h"
 #include "core/collection/Array.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/BufferedReadWriteStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
@@ -21,6 +23,7 @@
 #include "palette/Palette.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
+#include "voxelformat/NodeEncoder.h"
 #include "voxelutil/VolumeVisitor.h"
 
 #include <glm/gtc/type_ptr.hpp>
@@ -257,8 +260,23 @@ bool VENGIFormat::saveNodePaletteIdentifier(const scenegraph::SceneGraph &sceneG
 	return true;
 }
 
+void VENGIFormat::addNodeDataJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+								  const scenegraph::SceneGraphNode &node) const {
+	if (node.type() == scenegraph::SceneGraphNodeType::Model) {
+		const voxel::RawVolume *v = node.volume();
+		encoder.add(node, v != nullptr ? (size_t)v->region().voxels() * 4u : 0u);
+	}
+	for (const core::UUID &childUUID : node.children()) {
+		const scenegraph::SceneGraphNode *child = sceneGraph.findNodeByUUID(childUUID);
+		if (child == nullptr) {
+			continue;
+		}
+		addNodeDataJobs(encoder, sceneGraph, *child);
+	}
+}
+
 bool VENGIFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteStream &stream,
-						   const scenegraph::SceneGraphNode &node) {
+						   const scenegraph::SceneGraphNode &node, NodeEncoder &encoder) {
 	wrapBool(stream.writeUInt32(FourCC('N', 'O', 'D', 'E')))
 	wrapBool(stream.writePascalStringUInt16LE(node.name()))
 	wrapBool(stream.writePascalStringUInt16LE(scenegraph::SceneGraphNodeTypeStr[(int)node.type()]))
@@ -281,7 +299,15 @@ bool VENGIFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteSt
 		wrapBool(saveNodePaletteColors(sceneGraph, node, stream))
 	}
 	wrapBool(saveNodePaletteNormals(sceneGraph, node, stream))
-	wrapBool(saveNodeData(sceneGraph, node, stream))
+	if (node.type() == scenegraph::SceneGraphNodeType::Model) {
+		// the voxel data was already encoded by saveNodeData() - see addNodeDataJobs()
+		const io::BufferedReadWriteStream *data = encoder.next();
+		if (data == nullptr) {
+			Log::error("Failed to encode the voxel data of node %s", node.name().c_str());
+			return false;
+		}
+		wrapBool(stream.write(data->getBuffer(), data->size()) != -1)
+	}
 	wrapBool(saveIKConstraint(sceneGraph, node, stream))
 	for (const core::String &animation : sceneGraph.animations()) {
 		wrapBool(saveAnimation(node, animation, stream))
@@ -291,7 +317,7 @@ bool VENGIFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteSt
 		if (child == nullptr) {
 			continue;
 		}
-		wrapBool(saveNode(sceneGraph, stream, *child))
+		wrapBool(saveNode(sceneGraph, stream, *child, encoder))
 	}
 	wrapBool(stream.writeUInt32(FourCC('E', 'N', 'D', 'N')))
 	return true;
@@ -655,9 +681,14 @@ bool VENGIFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const cor
 	}
 	Log::debug("Save scenegraph as vengi");
 	wrapBool(stream->writeUInt32(FourCC('V', 'E', 'N', 'G')))
-	io::ZipWriteStream zipStream(*stream, stream->size());
+	// the zlib stream is compressed in blocks on all cores
+	io::ZipWriteStream zipStream(*stream, *app::App::getInstance()->threadPool().get(), io::ZipLevel::Default);
 	wrapBool(zipStream.writeUInt32(9))
-	if (!saveNode(sceneGraph, zipStream, sceneGraph.root())) {
+	NodeEncoder encoder([this, &sceneGraph](const scenegraph::SceneGraphNode &node, io::SeekableWriteStream &out) {
+		return saveNodeData(sceneGraph, node, out);
+	});
+	addNodeDataJobs(encoder, sceneGraph, sceneGraph.root());
+	if (!saveNode(sceneGraph, zipStream, sceneGraph.root(), encoder)) {
 		return false;
 	}
 	return true;
@@ -12,6 +12,8 @@ class SceneGraphKeyFrame;
 
 namespace voxelformat {
 
+class NodeEncoder;
+
 /**
  * This format is our own format which stores a scene graph node hierarchy.
  *
@@ -48,8 +50,13 @@ private:
 								io::WriteStream &stream);
 	bool saveIKConstraint(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 						  io::WriteStream &stream);
+	/**
+	 * @brief Register the voxel data of the model nodes in the order @c saveNode() writes them
+	 */
+	void addNodeDataJobs(NodeEncoder &encoder, const scenegraph::SceneGraph &sceneGraph,
+						 const scenegraph::SceneGraphNode &node) const;
 	bool saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteStream &stream,
-				  const scenegraph::SceneGraphNode &node);
+				  const scenegraph::SceneGraphNode &node, NodeEncoder &encoder);
 
 	bool loadNodeProperties(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 							io::ReadStream &stream);
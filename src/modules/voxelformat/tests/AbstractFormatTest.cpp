@@ -280,6 +280,29 @@ void AbstractFormatTest::testLoadScreenshot(const core::String &filename, int wi
 									<< image::print(image);
 }
 
+void AbstractFormatTest::testLoadMetadata(const core::String &filename) {
+	SCOPED_TRACE(filename.c_str());
+	io::FileDescription fileDesc;
+	fileDesc.set(filename);
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	FormatMetadata metadata;
+	ASSERT_TRUE(voxelformat::loadMetadata(fileDesc, archive, metadata, testLoadCtx));
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, testLoadCtx));
+	FormatMetadata expected;
+	expected.setSceneGraph(sceneGraph);
+	EXPECT_EQ(expected.nodes, metadata.nodes);
+	EXPECT_GE(metadata.dimensions.x, expected.dimensions.x);
+	EXPECT_GE(metadata.dimensions.y, expected.dimensions.y);
+	EXPECT_GE(metadata.dimensions.z, expected.dimensions.z);
+	if (!metadata.palette.empty()) {
+		ASSERT_EQ(expected.palette.size(), metadata.palette.size());
+		for (size_t i = 0; i < metadata.palette.size(); ++i) {
+			EXPECT_EQ(expected.palette[i], metadata.palette[i]) << "palette index " << i;
+		}
+	}
+}
+
 void AbstractFormatTest::testRGBSmallSaveLoad(const core::String &filename, const core::String &saveFilename) {
 	SCOPED_TRACE(filename.c_str());
 	scenegraph::SceneGraph sceneGraph;
@@ -57,6 +57,10 @@ protected:
 	void testLoadScreenshot(const core::String &filename, int width, int height, const color::RGBA expectedColor,
 							int expectedX, int expectedY);
 
+	// compare the metadata of the given file with the full loaded scene - the dimensions of the metadata might be
+	// bigger if the format crops the volumes on load
+	void testLoadMetadata(const core::String &filename);
+
 	// load test_material.vox and check the material for the given target format (identified by the filename)
 	void testMaterial(scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 					  const core::Buffer<palette::MaterialProperty> &ignoredMaterials = {}, bool ignoreType = false);
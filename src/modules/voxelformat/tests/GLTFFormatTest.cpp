@@ -6,6 +6,7 @@
 #include "AbstractFormatTest.h"
 #include "core/ConfigVar.h"
 #include "core/ScopedPtr.h"
+#include "core/collection/Buffer.h"
 #include "io/Stream.h"
 #include "palette/Material.h"
 #include "scenegraph/SceneGraph.h"
@@ -17,7 +18,38 @@
 
 namespace voxelformat {
 
-class GLTFFormatTest : public AbstractFormatTest {};
+class GLTFFormatTest : public AbstractFormatTest {
+protected:
+	// the streaming writer must produce the same file as the in-memory path
+	void testSaveGlbStreamedIdentical(const scenegraph::SceneGraph &sceneGraph, const core::String &name) {
+		GLTFFormat f;
+		const io::ArchivePtr &archive = helper_archive();
+		const core::String memoryFile = name + "-memory.glb";
+		const core::String streamedFile = name + "-streamed.glb";
+		{
+			util::ScopedVarChange streaming(cfg::VoxformatGLTFStreaming, false);
+			ASSERT_TRUE(f.save(sceneGraph, memoryFile, archive, testSaveCtx));
+		}
+		{
+			util::ScopedVarChange streaming(cfg::VoxformatGLTFStreaming, true);
+			ASSERT_TRUE(f.save(sceneGraph, streamedFile, archive, testSaveCtx));
+		}
+
+		core::ScopedPtr<io::SeekableReadStream> memoryStream(archive->readStream(memoryFile));
+		core::ScopedPtr<io::SeekableReadStream> streamedStream(archive->readStream(streamedFile));
+		ASSERT_TRUE(memoryStream);
+		ASSERT_TRUE(streamedStream);
+		const int64_t size = memoryStream->size();
+		ASSERT_EQ(size, streamedStream->size());
+		core::Buffer<uint8_t> memoryBuf;
+		core::Buffer<uint8_t> streamedBuf;
+		memoryBuf.resize(size);
+		streamedBuf.resize(size);
+		ASSERT_EQ((int)size, memoryStream->read(memoryBuf.data(), size));
+		ASSERT_EQ((int)size, streamedStream->read(streamedBuf.data(), size));
+		EXPECT_EQ(0, core_memcmp(memoryBuf.data(), streamedBuf.data(), size));
+	}
+};
 
 TEST_F(GLTFFormatTest, testExportMesh) {
 	scenegraph::SceneGraph sceneGraph;
@@ -168,6 +200,103 @@ TEST_F(GLTFFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("bv-smallvolumesavetest.gltf", &f, 0, 10, flags);
 }
 
+TEST_F(GLTFFormatTest, testSaveReferencesInstanced) {
+	palette::Palette pal;
+	pal.nippon();
+	voxel::RawVolume volume(voxel::Region(0, 3));
+	for (int i = 0; i < 4; ++i) {
+		volume.setVoxel(i, i, i, voxel::createVoxel(pal, 1));
+	}
+	scenegraph::SceneGraph sceneGraph;
+	int modelNodeId;
+	{
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setUnownedVolume(&volume);
+		node.setPalette(pal);
+		node.setName("model");
+		modelNodeId = sceneGraph.emplace(core::move(node));
+		ASSERT_NE(InvalidNodeId, modelNodeId);
+	}
+	for (int i = 1; i <= 3; ++i) {
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::ModelReference);
+		ASSERT_TRUE(node.setReference(sceneGraph.node(modelNodeId)));
+		node.setPalette(pal);
+		node.setName(core::String::format("reference %i", i));
+		scenegraph::SceneGraphTransform transform;
+		transform.setWorldTranslation(glm::vec3(i * 8, 0, 0));
+		node.setTransform(0, transform);
+		ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node)));
+	}
+	sceneGraph.updateTransforms();
+
+	GLTFFormat f;
+	const io::ArchivePtr &archive = helper_archive();
+	const core::String filename = "instanced.gltf";
+	ASSERT_TRUE(f.save(sceneGraph, filename, archive, testSaveCtx));
+
+	// all nodes must point to the same mesh
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	ASSERT_TRUE(stream);
+	core::String json;
+	ASSERT_TRUE(stream->readString((int)stream->size(), json));
+	size_t meshCount = 0;
+	for (size_t pos = json.find("\"primitives\""); pos != core::String::npos;
+		 pos = json.find("\"primitives\"", pos + 1)) {
+		++meshCount;
+	}
+	EXPECT_EQ(1u, meshCount) << json.c_str();
+
+	scenegraph::SceneGraph loadedSceneGraph;
+	ASSERT_TRUE(f.load(filename, archive, loadedSceneGraph, testLoadCtx));
+	EXPECT_EQ(4u, loadedSceneGraph.size(scenegraph::SceneGraphNodeType::AllModels));
+}
+
+TEST_F(GLTFFormatTest, testSaveGlbStreamed) {
+	scenegraph::SceneGraph sceneGraph;
+	testLoad(sceneGraph, "chr_oldman.vengi", 10);
+
+	testSaveGlbStreamedIdentical(sceneGraph, "chr_oldman");
+
+	GLTFFormat f;
+	scenegraph::SceneGraph loadedSceneGraph;
+	ASSERT_TRUE(f.load("chr_oldman-streamed.glb", helper_archive(), loadedSceneGraph, testLoadCtx));
+	const voxel::ValidateFlags flags =
+		(voxel::ValidateFlags::Mesh & ~voxel::ValidateFlags::Color & ~voxel::ValidateFlags::Pivot);
+	voxel::sceneGraphComparator(sceneGraph, loadedSceneGraph, flags);
+}
+
+// the references are not next to the node they reference - the nodes must still be written in the order of their ids
+TEST_F(GLTFFormatTest, testSaveGlbStreamedReferences) {
+	palette::Palette pal;
+	pal.nippon();
+	scenegraph::SceneGraph sceneGraph;
+	int modelNodeIds[2];
+	for (int m = 0; m < 2; ++m) {
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 3));
+		for (int i = 0; i < 4; ++i) {
+			volume->setVoxel(i, m == 0 ? i : 0, i, voxel::createVoxel(pal, 1 + m));
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume);
+		node.setPalette(pal);
+		node.setName(core::String::format("model %i", m));
+		modelNodeIds[m] = sceneGraph.emplace(core::move(node));
+		ASSERT_NE(InvalidNodeId, modelNodeIds[m]);
+	}
+	for (int i = 1; i <= 4; ++i) {
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::ModelReference);
+		ASSERT_TRUE(node.setReference(sceneGraph.node(modelNodeIds[i % 2])));
+		node.setPalette(pal);
+		node.setName(core::String::format("reference %i", i));
+		scenegraph::SceneGraphTransform transform;
+		transform.setWorldTranslation(glm::vec3(i * 8, 0, 0));
+		node.setTransform(0, transform);
+		ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node)));
+	}
+	sceneGraph.updateTransforms();
+	testSaveGlbStreamedIdentical(sceneGraph, "references");
+}
+
 TEST_F(GLTFFormatTest, testMaterial) {
 	scenegraph::SceneGraph sceneGraph;
 	// Stock glTF has no MagicaVoxel MaterialType, flux, density, media, phase, sp, or ldr.
@@ -98,6 +98,54 @@ TEST_F(MCRFormatTest, testLoad117SeparateWater) {
 	EXPECT_FALSE(foundWaterInTerrain);
 }
 
+TEST_F(MCRFormatTest, testRegionFilter) {
+	LoadContext ctx;
+	EXPECT_TRUE(MCRFormat::chunkInRegionFilter(ctx, 100, 100)) << "No filter means everything is visible";
+	ctx.setRegionFilter(glm::ivec3(0, 0, -576), glm::ivec3(15, 63, -561));
+	EXPECT_TRUE(MCRFormat::chunkInRegionFilter(ctx, 0, -36));
+	EXPECT_FALSE(MCRFormat::chunkInRegionFilter(ctx, 1, -36));
+	EXPECT_FALSE(MCRFormat::chunkInRegionFilter(ctx, 0, -35));
+	EXPECT_TRUE(MCRFormat::chunkInRegionFilter(ctx, 0, -64, MCRFormat::REGION_CHUNKS));
+	EXPECT_FALSE(MCRFormat::chunkInRegionFilter(ctx, 32, -64, MCRFormat::REGION_CHUNKS));
+	EXPECT_TRUE(MCRFormat::sectionInRegionFilter(ctx, 0));
+	EXPECT_TRUE(MCRFormat::sectionInRegionFilter(ctx, 3));
+	EXPECT_FALSE(MCRFormat::sectionInRegionFilter(ctx, 4));
+	EXPECT_FALSE(MCRFormat::sectionInRegionFilter(ctx, -1));
+}
+
+TEST_F(MCRFormatTest, testLoad117RegionFilter) {
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	if (!archive->exists("r.0.-2.mca")) {
+		GTEST_SKIP() << "Could not open r.0.-2.mca";
+	}
+	scenegraph::SceneGraph sceneGraph;
+	io::FileDescription fileDesc;
+	fileDesc.set("r.0.-2.mca");
+	LoadContext ctx;
+	const voxel::Region filter(0, 0, -576, 15, 63, -561);
+	ctx.setRegionFilter(filter.getLowerCorner(), filter.getUpperCorner());
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, ctx));
+	EXPECT_EQ(1u, sceneGraph.size()) << "Only a single chunk should intersect the region filter";
+	const scenegraph::SceneGraphNode &node = *sceneGraph.begin(scenegraph::SceneGraphNodeType::Model);
+	const voxel::RawVolume *v = node.volume();
+	EXPECT_TRUE(filter.containsRegion(v->region()));
+	EXPECT_EQ(22u, v->voxel(0, 62, -576).getColor());
+}
+
+TEST_F(MCRFormatTest, testLoadRegionOutsideOfFilter) {
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	if (!archive->exists("r.0.-2.mca")) {
+		GTEST_SKIP() << "Could not open r.0.-2.mca";
+	}
+	scenegraph::SceneGraph sceneGraph;
+	LoadContext ctx;
+	ctx.setRegionFilter(glm::ivec3(1024, 0, 1024), glm::ivec3(1040, 63, 1040));
+	MCRFormat format;
+	ASSERT_TRUE(format.load("r.0.-2.mca", archive, sceneGraph, ctx))
+		<< "A region file outside of the filter should be skipped - not fail";
+	EXPECT_TRUE(sceneGraph.empty());
+}
+
 TEST_F(MCRFormatTest, testExtractWaterVolume) {
 	const voxel::Region region(0, 0, 0, 3, 3, 3);
 	voxel::RawVolume terrain(region);
@@ -29,4 +29,45 @@ TEST_F(NamedBinaryTagTest, testWriteRead) {
 	}
 }
 
+TEST_F(NamedBinaryTagTest, testWriteReadArrays) {
+	io::BufferedReadWriteStream stream;
+	{
+		priv::NBTCompound compound;
+		core::Buffer<int32_t> ints;
+		ints.push_back(1);
+		ints.push_back(-2);
+		compound.put("Ints", priv::NamedBinaryTag(core::move(ints)));
+		core::Buffer<int64_t> longs;
+		longs.push_back(0x0102030405060708LL);
+		compound.put("Longs", priv::NamedBinaryTag(core::move(longs)));
+		priv::NamedBinaryTag root(core::move(compound));
+		ASSERT_TRUE(priv::NamedBinaryTag::write(root, "rootTagName", stream));
+	}
+	// nbt stores all values in big endian byte order - the array elements, too
+	const uint8_t expectedInts[] = {0, 0, 0, 1, 0xff, 0xff, 0xff, 0xfe};
+	bool foundInts = false;
+	for (int64_t i = 0; i + (int64_t)sizeof(expectedInts) <= stream.size(); ++i) {
+		if (memcmp(stream.getBuffer() + i, expectedInts, sizeof(expectedInts)) == 0) {
+			foundInts = true;
+			break;
+		}
+	}
+	EXPECT_TRUE(foundInts);
+	stream.seek(0);
+	{
+		priv::NamedBinaryTagContext ctx;
+		ctx.stream = &stream;
+		const priv::NamedBinaryTag &root = priv::NamedBinaryTag::parse(ctx);
+		const core::Buffer<int32_t> *ints = root.get("Ints").intArray();
+		ASSERT_NE(nullptr, ints);
+		ASSERT_EQ(2u, ints->size());
+		EXPECT_EQ(1, (*ints)[0]);
+		EXPECT_EQ(-2, (*ints)[1]);
+		const core::Buffer<int64_t> *longs = root.get("Longs").longArray();
+		ASSERT_NE(nullptr, longs);
+		ASSERT_EQ(1u, longs->size());
+		EXPECT_EQ(0x0102030405060708LL, (*longs)[0]);
+	}
+}
+
 } // namespace voxelformat
@@ -0,0 +1,113 @@
+/**
+ * @file
+ */
+
+#include "voxelformat/private/minecraft/NamedBinaryTagView.h"
+#include "app/tests/AbstractTest.h"
+#include "io/BufferedReadWriteStream.h"
+
+namespace voxelformat {
+
+class NamedBinaryTagViewTest : public app::AbstractTest {
+protected:
+	void writeTestData(io::BufferedReadWriteStream &stream) {
+		priv::NBTCompound compound;
+		compound.put("Byte", priv::NamedBinaryTag((int8_t)-3));
+		compound.put("Short", priv::NamedBinaryTag((int16_t)1234));
+		compound.put("Int", priv::NamedBinaryTag((int32_t)-123456));
+		compound.put("Long", priv::NamedBinaryTag((int64_t)0x123456789ALL));
+		compound.put("Float", priv::NamedBinaryTag(1.5f));
+		compound.put("Double", priv::NamedBinaryTag(2.25));
+		compound.put("String", priv::NamedBinaryTag(core::String("minecraft:stone")));
+		core::Buffer<int64_t> longs;
+		longs.push_back(1);
+		longs.push_back(-2);
+		longs.push_back(0x0102030405060708LL);
+		compound.put("Longs", priv::NamedBinaryTag(core::move(longs)));
+		core::Buffer<int8_t> bytes;
+		bytes.push_back(7);
+		bytes.push_back(-1);
+		compound.put("Bytes", priv::NamedBinaryTag(core::move(bytes)));
+		priv::NBTList list;
+		for (int i = 0; i < 3; ++i) {
+			priv::NBTCompound entry;
+			entry.put("Index", priv::NamedBinaryTag((int32_t)i));
+			list.push_back(priv::NamedBinaryTag(core::move(entry)));
+		}
+		compound.put("List", priv::NamedBinaryTag(core::move(list)));
+		priv::NBTCompound nested;
+		nested.put("Name", priv::NamedBinaryTag(core::String("nested")));
+		compound.put("Nested", priv::NamedBinaryTag(core::move(nested)));
+		const priv::NamedBinaryTag root(core::move(compound));
+		ASSERT_TRUE(priv::NamedBinaryTag::write(root, "Root", stream));
+	}
+};
+
+TEST_F(NamedBinaryTagViewTest, testPrimitives) {
+	io::BufferedReadWriteStream stream;
+	writeTestData(stream);
+	const priv::NamedBinaryTagView root = priv::NamedBinaryTagView::parse(stream.getBuffer(), stream.size());
+	ASSERT_TRUE(root.valid());
+	EXPECT_TRUE(root.isName("Root"));
+	EXPECT_EQ(11u, root.size());
+	EXPECT_EQ(-3, root.get("Byte").int8());
+	EXPECT_EQ(1234, root.get("Short").int16());
+	EXPECT_EQ(-123456, root.get("Int").int32());
+	EXPECT_EQ(0x123456789ALL, root.get("Long").int64());
+	EXPECT_FLOAT_EQ(1.5f, root.get("Float").float32());
+	EXPECT_DOUBLE_EQ(2.25, root.get("Double").float64());
+	EXPECT_TRUE(root.get("String").isString("minecraft:stone"));
+	EXPECT_EQ("minecraft:stone", root.get("String").stringValue());
+	EXPECT_EQ("nested", root.get("Nested").get("Name").stringValue());
+	EXPECT_EQ(42, root.get("Int").int8(42)) << "Type mismatch must return the default value";
+	EXPECT_FALSE(root.get("Missing").valid());
+}
+
+TEST_F(NamedBinaryTagViewTest, testArrays) {
+	io::BufferedReadWriteStream stream;
+	writeTestData(stream);
+	const priv::NamedBinaryTagView root = priv::NamedBinaryTagView::parse(stream.getBuffer(), stream.size());
+	ASSERT_TRUE(root.valid());
+	const priv::NBTLongArrayView longs = root.get("Longs").longArray();
+	ASSERT_EQ(3u, longs.size());
+	EXPECT_EQ(1, longs[0]);
+	EXPECT_EQ(-2, longs[1]);
+	EXPECT_EQ(0x0102030405060708LL, longs[2]);
+	const priv::NBTByteArrayView bytes = root.get("Bytes").byteArray();
+	ASSERT_EQ(2u, bytes.size());
+	EXPECT_EQ(7, bytes[0]);
+	EXPECT_EQ(-1, bytes[1]);
+	EXPECT_TRUE(root.get("Bytes").longArray().empty());
+}
+
+TEST_F(NamedBinaryTagViewTest, testList) {
+	io::BufferedReadWriteStream stream;
+	writeTestData(stream);
+	const priv::NamedBinaryTagView root = priv::NamedBinaryTagView::parse(stream.getBuffer(), stream.size());
+	ASSERT_TRUE(root.valid());
+	const priv::NamedBinaryTagView list = root.get("List");
+	ASSERT_EQ(priv::TagType::LIST, list.type());
+	EXPECT_EQ(priv::TagType::COMPOUND, list.listType());
+	ASSERT_EQ(3u, list.size());
+	int expected = 0;
+	for (const priv::NamedBinaryTagView &entry : list) {
+		EXPECT_EQ(expected, entry.get("Index").int32());
+		++expected;
+	}
+	EXPECT_EQ(3, expected);
+}
+
+TEST_F(NamedBinaryTagViewTest, testTruncated) {
+	io::BufferedReadWriteStream stream;
+	writeTestData(stream);
+	for (int64_t size = 0; size < stream.size(); size += 7) {
+		// must not crash or read out of bounds
+		const priv::NamedBinaryTagView root = priv::NamedBinaryTagView::parse(stream.getBuffer(), size);
+		for (const priv::NamedBinaryTagView &child : root) {
+			(void)child.size();
+			(void)child.longArray();
+		}
+	}
+}
+
+} // namespace voxelformat
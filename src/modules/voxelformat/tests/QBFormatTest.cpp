@@ -15,6 +15,11 @@ TEST_F(QBFormatTest, testLoad) {
 	testLoad("qubicle.qb", 10);
 }
 
+// no metadata support - falls back to a full load
+TEST_F(QBFormatTest, testLoadMetadata) {
+	testLoadMetadata("chr_knight.qb");
+}
+
 TEST_F(QBFormatTest, testLoadRGB) {
 	testRGB("rgb.qb");
 }
@@ -4,7 +4,9 @@
 
 #include "voxelformat/VolumeFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/FourCC.h"
 #include "io/FilesystemArchive.h"
+#include "voxel/RawVolume.h"
 
 namespace voxelformat {
 
@@ -30,6 +32,53 @@ TEST_F(VolumeFormatTest, testLoadFormat) {
 	}
 }
 
+TEST_F(VolumeFormatTest, testFindLoadFormat) {
+	core::DynamicArray<uint32_t> magics;
+	magics.push_back(0u);
+	magics.push_back(FourCC('x', 'x', 'x', 'x'));
+	for (const io::FormatDescription *desc = voxelLoad(); desc->valid(); ++desc) {
+		for (const io::Magic &m : desc->magics) {
+			magics.push_back(FourCC(m.size() > 0 ? m.data.u8[0] : '\0', m.size() > 1 ? m.data.u8[1] : '\0',
+									m.size() > 2 ? m.data.u8[2] : '\0', m.size() > 3 ? m.data.u8[3] : '\0'));
+		}
+	}
+	core::DynamicArray<core::String> filenames;
+	filenames.push_back("foo.unknown");
+	filenames.push_back("foo");
+	for (const io::FormatDescription *desc = voxelLoad(); desc->valid(); ++desc) {
+		for (const core::String &ext : desc->exts) {
+			filenames.push_back("foo." + ext);
+			filenames.push_back("foo." + ext.toUpper());
+		}
+	}
+	for (const core::String &filename : filenames) {
+		for (uint32_t magic : magics) {
+			const io::FormatDescription *expected = io::getDescription(filename, magic, voxelLoad());
+			const io::FormatDescription *found = findLoadFormat(filename, magic);
+			ASSERT_EQ(expected, found) << filename.c_str() << " with magic " << magic << ": expected "
+									   << (expected ? expected->name.c_str() : "none") << " but got "
+									   << (found ? found->name.c_str() : "none");
+		}
+	}
+}
+
+TEST_F(VolumeFormatTest, testSaveFormatMultiPartExtension) {
+	scenegraph::SceneGraph sceneGraph;
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 1));
+	volume->setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	node.setVolume(volume);
+	sceneGraph.emplace(core::move(node));
+	const io::ArchivePtr &archive = helper_archive();
+	SaveContext saveCtx;
+	ASSERT_TRUE(saveFormat(sceneGraph, "foo.ben.json", nullptr, archive, saveCtx));
+	io::FileDescription fileDesc;
+	fileDesc.set("foo.ben.json");
+	scenegraph::SceneGraph newSceneGraph;
+	EXPECT_TRUE(loadFormat(fileDesc, archive, newSceneGraph, testLoadCtx));
+	EXPECT_GT(newSceneGraph.size(), 0u);
+}
+
 TEST_F(VolumeFormatTest, testIsMeshFormat) {
 	EXPECT_TRUE(isMeshFormat("foo.obj", false));
 	EXPECT_TRUE(isMeshFormat("foo.glb", false));
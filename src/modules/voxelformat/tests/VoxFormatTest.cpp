@@ -43,6 +43,12 @@ TEST_F(VoxFormatTest, DISABLED_testTeardownLoad) {
 	testLoad("teardown.vox");
 }
 
+TEST_F(VoxFormatTest, testLoadMetadata) {
+	testLoadMetadata("robo.vox");
+	testLoadMetadata("test-transform.vox");
+	testLoadMetadata("rgb.vox");
+}
+
 TEST_F(VoxFormatTest, testLoadMaterials) {
 	VoxFormat f;
 	scenegraph::SceneGraph mvSceneGraph;
@@ -21,6 +21,7 @@
  */
 
 #include "Genland.h"
+#include "app/App.h"
 #include "app/ForParallel.h"
 #include "core/Common.h"
 #include "core/Log.h"
@@ -28,13 +29,14 @@
 #include "math/Random.h"
 #include "palette/Palette.h"
 #include "palette/PaletteLookup.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SparseVolume.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/ext/scalar_integer.hpp>
-#include <glm/ext/scalar_constants.hpp>
-#include <glm/ext/scalar_integer.hpp>
 
 namespace voxelgenerator {
 
@@ -83,319 +85,387 @@ static CORE_FORCE_INLINE float fgrad(long h, float x, float y, float z) {
 	return (0);
 }
 
-static uint8_t noisep[512];
-static uint8_t noisep15[512];
+struct GenlandNoise {
+	uint8_t noisep[512];
+	uint8_t noisep15[512];
 
-static void noiseinit(math::Random &rand) {
-	for (long i = (lengthof(noisep) / 2) - 1; i >= 0; i--) {
-		noisep[i] = i;
-	}
-	for (long i = (lengthof(noisep) / 2) - 1; i > 0; i--) {
-		const long n = rand.random(0, 32767);
-		const long j = ((n * (i + 1)) >> 15);
-		const long k = noisep[i];
-		noisep[i] = noisep[j];
-		noisep[j] = k;
-	}
-	for (long i = (lengthof(noisep) / 2) - 1; i >= 0; i--) {
-		noisep[i + (lengthof(noisep) / 2)] = noisep[i];
-	}
-	for (long i = lengthof(noisep15) - 1; i >= 0; i--) {
-		noisep15[i] = noisep[i] & 15;
+	void init(math::Random &rand) {
+		for (long i = (lengthof(noisep) / 2) - 1; i >= 0; i--) {
+			noisep[i] = i;
+		}
+		for (long i = (lengthof(noisep) / 2) - 1; i > 0; i--) {
+			const long n = rand.random(0, 32767);
+			const long j = ((n * (i + 1)) >> 15);
+			const long k = noisep[i];
+			noisep[i] = noisep[j];
+			noisep[j] = k;
+		}
+		for (long i = (lengthof(noisep) / 2) - 1; i >= 0; i--) {
+			noisep[i + (lengthof(noisep) / 2)] = noisep[i];
+		}
+		for (long i = lengthof(noisep15) - 1; i >= 0; i--) {
+			noisep15[i] = noisep[i] & 15;
+		}
 	}
-}
 
-static double noise3d(double fx, double fy, double fz, long mask) {
-	long i, l[6], a[4];
-	float p[3], f[8];
-
-	// if (mask > 255) mask = 255; //Checked before call
-	l[0] = floor(fx);
-	p[0] = fx - ((float)l[0]);
-	l[0] &= mask;
-	l[3] = (l[0] + 1) & mask;
-	l[1] = floor(fy);
-	p[1] = fy - ((float)l[1]);
-	l[1] &= mask;
-	l[4] = (l[1] + 1) & mask;
-	l[2] = floor(fz);
-	p[2] = fz - ((float)l[2]);
-	l[2] &= mask;
-	l[5] = (l[2] + 1) & mask;
-	i = noisep[l[0]];
-	a[0] = noisep[i + l[1]];
-	a[2] = noisep[i + l[4]];
-	i = noisep[l[3]];
-	a[1] = noisep[i + l[1]];
-	a[3] = noisep[i + l[4]];
-	f[0] = fgrad(noisep15[a[0] + l[2]], p[0], p[1], p[2]);
-	f[1] = fgrad(noisep15[a[1] + l[2]], p[0] - 1, p[1], p[2]);
-	f[2] = fgrad(noisep15[a[2] + l[2]], p[0], p[1] - 1, p[2]);
-	f[3] = fgrad(noisep15[a[3] + l[2]], p[0] - 1, p[1] - 1, p[2]);
-	p[2]--;
-	f[4] = fgrad(noisep15[a[0] + l[5]], p[0], p[1], p[2]);
-	f[5] = fgrad(noisep15[a[1] + l[5]], p[0] - 1, p[1], p[2]);
-	f[6] = fgrad(noisep15[a[2] + l[5]], p[0], p[1] - 1, p[2]);
-	f[7] = fgrad(noisep15[a[3] + l[5]], p[0] - 1, p[1] - 1, p[2]);
-	p[2]++;
-	p[2] = (3.0 - 2.0 * p[2]) * p[2] * p[2];
-	p[1] = (3.0 - 2.0 * p[1]) * p[1] * p[1];
-	p[0] = (3.0 - 2.0 * p[0]) * p[0] * p[0];
-	f[0] = (f[4] - f[0]) * p[2] + f[0];
-	f[1] = (f[5] - f[1]) * p[2] + f[1];
-	f[2] = (f[6] - f[2]) * p[2] + f[2];
-	f[3] = (f[7] - f[3]) * p[2] + f[3];
-	f[0] = (f[2] - f[0]) * p[1] + f[0];
-	f[1] = (f[3] - f[1]) * p[1] + f[1];
-	return ((f[1] - f[0]) * p[0] + f[0]);
-}
+	double noise3d(double fx, double fy, double fz, long mask) const {
+		long i, l[6], a[4];
+		float p[3], f[8];
+
+		// if (mask > 255) mask = 255; //Checked before call
+		l[0] = floor(fx);
+		p[0] = fx - ((float)l[0]);
+		l[0] &= mask;
+		l[3] = (l[0] + 1) & mask;
+		l[1] = floor(fy);
+		p[1] = fy - ((float)l[1]);
+		l[1] &= mask;
+		l[4] = (l[1] + 1) & mask;
+		l[2] = floor(fz);
+		p[2] = fz - ((float)l[2]);
+		l[2] &= mask;
+		l[5] = (l[2] + 1) & mask;
+		i = noisep[l[0]];
+		a[0] = noisep[i + l[1]];
+		a[2] = noisep[i + l[4]];
+		i = noisep[l[3]];
+		a[1] = noisep[i + l[1]];
+		a[3] = noisep[i + l[4]];
+		f[0] = fgrad(noisep15[a[0] + l[2]], p[0], p[1], p[2]);
+		f[1] = fgrad(noisep15[a[1] + l[2]], p[0] - 1, p[1], p[2]);
+		f[2] = fgrad(noisep15[a[2] + l[2]], p[0], p[1] - 1, p[2]);
+		f[3] = fgrad(noisep15[a[3] + l[2]], p[0] - 1, p[1] - 1, p[2]);
+		p[2]--;
+		f[4] = fgrad(noisep15[a[0] + l[5]], p[0], p[1], p[2]);
+		f[5] = fgrad(noisep15[a[1] + l[5]], p[0] - 1, p[1], p[2]);
+		f[6] = fgrad(noisep15[a[2] + l[5]], p[0], p[1] - 1, p[2]);
+		f[7] = fgrad(noisep15[a[3] + l[5]], p[0] - 1, p[1] - 1, p[2]);
+		p[2]++;
+		p[2] = (3.0 - 2.0 * p[2]) * p[2] * p[2];
+		p[1] = (3.0 - 2.0 * p[1]) * p[1] * p[1];
+		p[0] = (3.0 - 2.0 * p[0]) * p[0] * p[0];
+		f[0] = (f[4] - f[0]) * p[2] + f[0];
+		f[1] = (f[5] - f[1]) * p[2] + f[1];
+		f[2] = (f[6] - f[2]) * p[2] + f[2];
+		f[3] = (f[7] - f[3]) * p[2] + f[3];
+		f[0] = (f[2] - f[0]) * p[1] + f[0];
+		f[1] = (f[3] - f[1]) * p[1] + f[1];
+		return ((f[1] - f[0]) * p[0] + f[0]);
+	}
+};
 
-class TempBuffer {
+/**
+ * @brief The state that is shared by all tiles of one map - read-only once it is set up
+ *
+ * Every column only depends on its own position. The shadows and their smoothing need the heights of the columns
+ * around a tile - the map wraps around after @c size columns.
+ */
+class GenlandContext {
 private:
-	const int _bufSize;
+	static constexpr double EPS = 0.1;
+	static constexpr double freq = (1.0 / 64.0);
+
+	GenlandNoise _noise;
+	core::Buffer<double> _amplut;
+	core::Buffer<long> _msklut;
+	palette::Palette _palette;
 
 public:
-	color::RGBA *buf; // 2d heightmap colors for writing out the voxels or the heightmap image
-	color::RGBA *amb; // ambient
-	float *hgt;		 // height values for shadow rays
-	int *heights;	 // clipped column heights for voxel fill
-	uint8_t *sh;	 // shadows
-	TempBuffer(int size) : _bufSize(size * size) {
-		buf = new color::RGBA[_bufSize];
-		amb = new color::RGBA[_bufSize];
-		hgt = new float[_bufSize];
-		heights = new int[_bufSize];
-		sh = new uint8_t[_bufSize];
-	}
-	~TempBuffer() {
-		delete[] buf;
-		delete[] amb;
-		delete[] hgt;
-		delete[] heights;
-		delete[] sh;
-	}
-	void clearShadow() {
-		core_memset(sh, 0, sizeof(uint8_t) * _bufSize);
-	}
-};
+	const GenlandSettings &settings;
+	const int mask;
+	const bool wantRivers;
+	// the amount of columns a shadow ray travels
+	int shadowReach = 0;
+	// the amount of smoothing iterations - this is the overlap of the shadows at the positive sides of a tile
+	int smoothing = 0;
+	// the lookup caches the colors it found
+	mutable palette::PaletteLookup paletteLookup;
 
-voxel::RawVolume *genland(GenlandSettings &settings) {
-	if (!glm::isPowerOfTwo(settings.size)) {
-		Log::error("Size must be a power of two, got %d", settings.size);
-		return nullptr;
-	}
+	struct Column {
+		color::RGBA color;
+		color::RGBA amb;
+		int height;
+		float hgt;
+	};
 
-	if (settings.octaves < 1) {
-		Log::error("Octaves must be at least 1, got %d", settings.octaves);
-		return nullptr;
-	}
+	GenlandContext(const GenlandSettings &s)
+		: settings(s), mask(s.size - 1), wantRivers(s.river && s.numRivers >= 1 && s.riverWidth != 0.0),
+		  paletteLookup(_palette) {
+		math::Random rand;
+		rand.setSeed(settings.seed);
+		_noise.init(rand);
 
-	if (settings.height < 1) {
-		Log::error("Height must be at least 1, got %d", settings.height);
-		return nullptr;
+		_amplut.resize(settings.octaves);
+		_msklut.resize(settings.octaves);
+		// Tom's algorithm from 12/04/2005 (more or less)
+		double d = 1.0;
+		for (int i = 0; i < settings.octaves; i++) {
+			_amplut[i] = d;
+			d *= settings.persistence;
+			_msklut[i] = core_min((1 << (i + 2)) - 1, 255);
+		}
+		if (settings.shadow) {
+			shadowReach = settings.size >> 2;
+			if (settings.shadowDistance > 0) {
+				shadowReach = core_min(shadowReach, settings.shadowDistance + 1);
+			}
+			smoothing = core_max(settings.smoothing, 0);
+		}
+		_palette.nippon();
 	}
 
-	if (settings.offset[0] < 0) {
-		Log::error("Offset X must be at least 0, got %d", settings.offset[0]);
-		return nullptr;
+	/**
+	 * @brief Get the terrain height and the height with the rivers carved in for one of the 3 samples of a column
+	 */
+	void sample(int x, int z, int i, double &samp, double &csamp) const {
+		double dx = ((settings.offset[0] + x) * (256.0 / (double)(settings.offset[0] + settings.size)) + (double)(i & 1) * EPS) * freq;
+		double dy = ((settings.offset[1] + z) * (256.0 / (double)(settings.offset[1] + settings.size)) + (double)(i >> 1) * EPS) * freq;
+		double temp1 = 0.0;
+		double river = 0.0;
+		for (long o = 0; o < settings.octaves; o++) {
+			temp1 += _noise.noise3d(dx, dy, settings.freqGround, _msklut[o]) * _amplut[o] * (temp1 * 1.6 + 1.0); // multi-fractal
+			river += _noise.noise3d(dx, dy, settings.freqRiver, _msklut[o]) * _amplut[o];
+			dx *= 2.0;
+			dy *= 2.0;
+		}
+		samp = (temp1 * -settings.amplitude) + settings.baseHeight;
+		if (wantRivers) {
+			const double twoPi = 2.0 * glm::pi<double>();
+			temp1 = sin((settings.offset[0] + x) * ((twoPi * (double)settings.numRivers) / (double)settings.size) +
+						river * settings.riverMeander +
+						(((1.0 - settings.riverPhase) * twoPi) + (1.5 * glm::pi<double>()))) *
+						(0.5 + settings.riverWidth) +
+					(0.5 - settings.riverWidth);
+			if (temp1 > 1.0) {
+				temp1 = 1.0;
+			}
+			csamp = samp * temp1;
+			if (temp1 < 0.0) {
+				temp1 = 0.0;
+			}
+			samp *= temp1;
+		} else {
+			csamp = samp;
+		}
+		if (csamp < samp) {
+			csamp = -log(1.0 - csamp); // simulate water normal ;)
+		}
 	}
-	if (settings.offset[1] < 0) {
-		Log::error("Offset Y must be at least 0, got %d", settings.offset[1]);
-		return nullptr;
+
+	/**
+	 * @brief The height the shadow rays are tested against - only needs the first sample
+	 */
+	float shadowHeight(int x, int z) const {
+		double samp, csamp;
+		sample(x & mask, z & mask, 0, samp, csamp);
+		return csamp;
 	}
 
-	TempBuffer tempBuffer(settings.size);
-	math::Random rand;
-	rand.setSeed(settings.seed);
+	void column(int x, int z, Column &out) const {
+		x &= mask;
+		z &= mask;
+		double samp[3];
+		double csamp[3];
+		// Get 3 samples (0,0), (EPS,0), (0,EPS):
+		for (int i = 0; i < lengthof(samp); i++) {
+			sample(x, z, i, samp[i], csamp[i]);
+		}
+		// Get normal using cross-product
+		double nx = csamp[1] - csamp[0];
+		double ny = csamp[2] - csamp[0];
+		double nz = -EPS;
+		const double temp2 = 1.0 / sqrt(nx * nx + ny * ny + nz * nz);
+		nx *= temp2;
+		ny *= temp2;
+		nz *= temp2;
 
-	constexpr double EPS = 0.1;
-	core::Buffer<double> amplut;
-	core::Buffer<long> msklut;
+		// Ground colors
+		double gr = settings.ground.r;
+		double gg = settings.ground.g;
+		double gb = settings.ground.b;
+		// blend factor
+		double g = core_min(core_max(core_max(-nz, 0.0) * 1.4 - csamp[0] / 32.0 +
+										 _noise.noise3d((settings.offset[0] + x) * freq, (settings.offset[1] + z) * freq, 0.3, 15) * 0.3 +
+										 settings.grassBias,
+									 0),
+							1);
+		// Grass
+		gr += (settings.grass.r - gr) * g;
+		gg += (settings.grass.g - gg) * g;
+		gb += (settings.grass.b - gb) * g;
 
-	amplut.resize(settings.octaves);
-	msklut.resize(settings.octaves);
+		// Grass2
+		double g2 = (1.0 - fabs(g - 0.5) * 2.0) * 0.7;
+		gr += (settings.grass2.r - gr) * g2;
+		gg += (settings.grass2.g - gg) * g2;
+		gb += (settings.grass2.b - gb) * g2;
 
-	noiseinit(rand);
+		// Water
+		g2 = core_max(core_min((samp[0] - csamp[0]) * 1.5, 1), 0);
+		g = 1.0 - g2 * 0.2;
+		gr += (settings.water.r * g - gr) * g2;
+		gg += (settings.water.g * g - gg) * g2;
+		gb += (settings.water.b * g - gb) * g2;
 
-	// Tom's algorithm from 12/04/2005 (more or less)
-	Log::debug("Generating landscape with seed %d, height %d, octaves %d", settings.seed, settings.height,
-			   settings.octaves);
-	double d = 1.0;
-	for (int i = 0; i < settings.octaves; i++) {
-		amplut[i] = d;
-		d *= settings.persistence;
-		msklut[i] = core_min((1 << (i + 2)) - 1, 255);
+		const double ambScale = settings.ambience ? settings.ambienceFactor : 0.0;
+		out.amb.r = (uint8_t)core_min(core_max(gr * ambScale, 0), 255);
+		out.amb.g = (uint8_t)core_min(core_max(gg * ambScale, 0), 255);
+		out.amb.b = (uint8_t)core_min(core_max(gb * ambScale, 0), 255);
+		const uint8_t maxa = core_max(core_max(out.amb.r, out.amb.g), out.amb.b);
+
+		// lighting
+		double temp3 = (nx * 0.5 + ny * 0.25 - nz) / sqrt(0.5 * 0.5 + 0.25 * 0.25 + 1.0 * 1.0);
+		temp3 *= 1.2;
+		// Clip to volume height; never wrap via uint8 storage.
+		out.height = glm::clamp((int)samp[0], 0, settings.height);
+		out.color.a = 255;
+		out.color.r = (uint8_t)core_min(core_max(gr * temp3, 0), 255 - maxa);
+		out.color.g = (uint8_t)core_min(core_max(gg * temp3, 0), 255 - maxa);
+		out.color.b = (uint8_t)core_min(core_max(gb * temp3, 0), 255 - maxa);
+		out.hgt = csamp[0];
 	}
+};
 
-	const double freq = (1.0 / 64.0);
-	const double twoPi = 2.0 * glm::pi<double>();
-	const bool wantRivers = settings.river && settings.numRivers >= 1 && settings.riverWidth != 0.0;
-	// TODO: PERF: FOR_PARALLEL
-	for (int z = 0; z < settings.size; z++) {
-		for (int x = 0; x < settings.size; x++) {
-			double samp[3];
-			double csamp[3];
-			// Get 3 samples (0,0), (EPS,0), (0,EPS):
-			for (int i = 0; i < lengthof(samp); i++) {
-				double dx = ((settings.offset[0] + x) * (256.0 / (double)(settings.offset[0] + settings.size)) + (double)(i & 1) * EPS) * freq;
-				double dy = ((settings.offset[1] + z) * (256.0 / (double)(settings.offset[1] + settings.size)) + (double)(i >> 1) * EPS) * freq;
-				double temp1 = 0.0;
-				double river = 0.0;
-				for (long o = 0; o < settings.octaves; o++) {
-					temp1 += noise3d(dx, dy, settings.freqGround, msklut[o]) * amplut[o] * (temp1 * 1.6 + 1.0); // multi-fractal
-					river += noise3d(dx, dy, settings.freqRiver, msklut[o]) * amplut[o];
-					dx *= 2.0;
-					dy *= 2.0;
-				}
-				samp[i] = (temp1 * -settings.amplitude) + settings.baseHeight;
-				if (wantRivers) {
-					temp1 = sin((settings.offset[0] + x) * ((twoPi * (double)settings.numRivers) / (double)settings.size) +
-								river * settings.riverMeander +
-								(((1.0 - settings.riverPhase) * twoPi) + (1.5 * glm::pi<double>()))) *
-								(0.5 + settings.riverWidth) +
-							(0.5 - settings.riverWidth);
-					if (temp1 > 1.0) {
-						temp1 = 1.0;
-					}
-					csamp[i] = samp[i] * temp1;
-					if (temp1 < 0.0) {
-						temp1 = 0.0;
-					}
-					samp[i] *= temp1;
-				} else {
-					csamp[i] = samp[i];
-				}
-				if (csamp[i] < samp[i]) {
-					csamp[i] = -log(1.0 - csamp[i]); // simulate water normal ;)
+template<typename F>
+static inline void genlandFor(bool parallel, int start, int end, const F &f) {
+	if (parallel) {
+		app::for_parallel(start, end, f);
+	} else {
+		app::for_not_parallel(start, end, f);
+	}
+}
+
+/**
+ * @brief Generate the columns @c x0 to @c x0+w and @c z0 to @c z0+d into a new volume at this position
+ * @param parallel Split the rows of the tile over the thread pool - don't use this if the tiles are already
+ * generated in parallel
+ */
+static voxel::RawVolume *genlandTile(const GenlandContext &ctx, int x0, int z0, int w, int d, bool parallel) {
+	const GenlandSettings &settings = ctx.settings;
+	const int mask = ctx.mask;
+
+	core::Buffer<GenlandContext::Column> columns;
+	columns.resize(w * d);
+
+	// the heights for the shadow rays - the rays go to the negative x and z and the smoothing uses the
+	// shadows of the columns at the positive sides - this is the overlap with the neighbour tiles
+	const int reach = ctx.shadowReach;
+	const int smoothing = ctx.smoothing;
+	const int sw = w + smoothing;
+	const int sd = d + smoothing;
+	const int hx0 = x0 - core_max(reach - 1, 0);
+	const int hz0 = z0 - (core_max(reach - 1, 0) >> 1);
+	// the map wraps around - there is no need to compute more than the whole map
+	const int hw = core_min(sw + (x0 - hx0), settings.size);
+	const int hd = core_min(sd + (z0 - hz0), settings.size);
+	core::Buffer<float> hgt;
+	if (settings.shadow) {
+		hgt.resize(hw * hd);
+	}
+	auto hgtIndex = [=](int x, int z) { return ((z - hz0) & mask) * hw + ((x - hx0) & mask); };
+
+	genlandFor(parallel, 0, d, [&](int start, int end) {
+		for (int z = start; z < end; ++z) {
+			for (int x = 0; x < w; ++x) {
+				GenlandContext::Column &c = columns[z * w + x];
+				ctx.column(x0 + x, z0 + z, c);
+				if (settings.shadow) {
+					hgt[hgtIndex(x0 + x, z0 + z)] = c.hgt;
 				}
 			}
-			// Get normal using cross-product
-			double nx = csamp[1] - csamp[0];
-			double ny = csamp[2] - csamp[0];
-			double nz = -EPS;
-			const double temp2 = 1.0 / sqrt(nx * nx + ny * ny + nz * nz);
-			nx *= temp2;
-			ny *= temp2;
-			nz *= temp2;
-
-			// Ground colors
-			double gr = settings.ground.r;
-			double gg = settings.ground.g;
-			double gb = settings.ground.b;
-			// blend factor
-			double g = core_min(core_max(core_max(-nz, 0.0) * 1.4 - csamp[0] / 32.0 +
-											 noise3d((settings.offset[0] + x) * freq, (settings.offset[1] + z) * freq, 0.3, 15) * 0.3 +
-											 settings.grassBias,
-										 0),
-								1);
-			// Grass
-			gr += (settings.grass.r - gr) * g;
-			gg += (settings.grass.g - gg) * g;
-			gb += (settings.grass.b - gb) * g;
-
-			// Grass2
-			double g2 = (1.0 - fabs(g - 0.5) * 2.0) * 0.7;
-			gr += (settings.grass2.r - gr) * g2;
-			gg += (settings.grass2.g - gg) * g2;
-			gb += (settings.grass2.b - gb) * g2;
-
-			// Water
-			g2 = core_max(core_min((samp[0] - csamp[0]) * 1.5, 1), 0);
-			g = 1.0 - g2 * 0.2;
-			gr += (settings.water.r * g - gr) * g2;
-			gg += (settings.water.g * g - gg) * g2;
-			gb += (settings.water.b * g - gb) * g2;
-
-			const int k = z * settings.size + x;
-			const double ambScale = settings.ambience ? settings.ambienceFactor : 0.0;
-			tempBuffer.amb[k].r = (uint8_t)core_min(core_max(gr * ambScale, 0), 255);
-			tempBuffer.amb[k].g = (uint8_t)core_min(core_max(gg * ambScale, 0), 255);
-			tempBuffer.amb[k].b = (uint8_t)core_min(core_max(gb * ambScale, 0), 255);
-			const uint8_t maxa = core_max(core_max(tempBuffer.amb[k].r, tempBuffer.amb[k].g), tempBuffer.amb[k].b);
-
-			// lighting
-			double temp3 = (nx * 0.5 + ny * 0.25 - nz) / sqrt(0.5 * 0.5 + 0.25 * 0.25 + 1.0 * 1.0);
-			temp3 *= 1.2;
-			// Clip to volume height; never wrap via uint8 storage.
-			tempBuffer.heights[k] = glm::clamp((int)samp[0], 0, settings.height);
-			tempBuffer.buf[k].a = 255;
-			tempBuffer.buf[k].r = (uint8_t)core_min(core_max(gr * temp3, 0), 255 - maxa);
-			tempBuffer.buf[k].g = (uint8_t)core_min(core_max(gg * temp3, 0), 255 - maxa);
-			tempBuffer.buf[k].b = (uint8_t)core_min(core_max(gb * temp3, 0), 255 - maxa);
-
-			tempBuffer.hgt[k] = csamp[0];
 		}
-		Log::debug("%i percent done", (int)(((z + 1) * 100) / settings.size));
-	}
+	});
 
-	tempBuffer.clearShadow();
+	core::Buffer<uint8_t> sh;
+	sh.resize(w * d);
+	core_memset(sh.data(), 0, sh.size());
 	if (settings.shadow) {
-		Log::debug("Applying shadows");
+		// the heights of the overlap - the columns of the tile itself are already known
+		genlandFor(parallel, 0, hd, [&](int start, int end) {
+			for (int bz = start; bz < end; ++bz) {
+				const int z = hz0 + bz;
+				const bool insideZ = ((z - z0) & mask) < d;
+				for (int bx = 0; bx < hw; ++bx) {
+					const int x = hx0 + bx;
+					if (insideZ && ((x - x0) & mask) < w) {
+						continue;
+					}
+					hgt[bz * hw + bx] = ctx.shadowHeight(x, z);
+				}
+			}
+		});
+
 		const int shadowStrength = glm::clamp(settings.shadowFactor, 0, 255);
-		const int VSHL = glm::findMSB(settings.size);
-		for (int z = 0; z < settings.size; z++) {
-			for (int x = 0; x < settings.size; x++) {
-				const int k = z * settings.size + x;
-				float f = tempBuffer.hgt[k] + 0.44f;
-				int i, j;
-				for (i = j = 1; i < (settings.size >> 2); j++, i++, f += 0.44f) {
-					const int heightz = ((z - (j >> 1)) & (settings.size - 1));
-					const int heightx = ((x - i) & (settings.size - 1));
-					const int heightidx = (heightz << VSHL) + heightx;
-					if (tempBuffer.hgt[heightidx] > f) {
-						tempBuffer.sh[k] = (uint8_t)shadowStrength;
-						break;
+		core::Buffer<uint8_t> shadows;
+		shadows.resize(sw * sd);
+		genlandFor(parallel, 0, sd, [&](int start, int end) {
+			for (int z = start; z < end; ++z) {
+				for (int x = 0; x < sw; ++x) {
+					const int wx = x0 + x;
+					const int wz = z0 + z;
+					float f = hgt[hgtIndex(wx, wz)] + 0.44f;
+					uint8_t shadow = 0;
+					for (int i = 1; i < reach; i++, f += 0.44f) {
+						if (hgt[hgtIndex(wx - i, wz - (i >> 1))] > f) {
+							shadow = (uint8_t)shadowStrength;
+							break;
+						}
 					}
+					shadows[z * sw + x] = shadow;
 				}
 			}
-		}
-		for (int i = settings.smoothing; i > 0; i--) {
-			for (int z = 0; z < settings.size; z++) {
-				for (int x = 0; x < settings.size; x++) {
-					const int k = z * settings.size + x;
-					tempBuffer.sh[k] =
-						(tempBuffer.sh[k] + tempBuffer.sh[(((z + 1) & (settings.size - 1)) << VSHL) + x] +
-						tempBuffer.sh[(z << VSHL) + ((x + 1) & (settings.size - 1))] +
-						tempBuffer.sh[(((z + 1) & (settings.size - 1)) << VSHL) + ((x + 1) & (settings.size - 1))] + 2) >>
-						2;
+		});
+		// every iteration needs one more column and row of the last iteration
+		core::Buffer<uint8_t> smoothed;
+		smoothed.resize(sw * sd);
+		uint8_t *src = shadows.data();
+		uint8_t *dst = smoothed.data();
+		for (int i = smoothing; i > 0; i--) {
+			const int iw = w + i - 1;
+			const int id = d + i - 1;
+			for (int z = 0; z < id; z++) {
+				for (int x = 0; x < iw; x++) {
+					const int k = z * sw + x;
+					dst[k] = (src[k] + src[k + sw] + src[k + 1] + src[k + sw + 1] + 2) >> 2;
 				}
 			}
+			core::exchange(src, dst);
+		}
+		for (int z = 0; z < d; z++) {
+			core_memcpy(&sh[z * w], &src[z * sw], w);
 		}
 	}
 
 	if (settings.ambience || settings.shadow) {
-		for (int y = 0; y < settings.size; y++) {
-			for (int x = 0; x < settings.size; x++) {
-				const int k = y * settings.size + x;
-				const int i = 256 - (tempBuffer.sh[k] << 2);
-				tempBuffer.buf[k].r = (uint8_t)core_min(core_max(((tempBuffer.buf[k].r * i) >> 8) + tempBuffer.amb[k].r, 0), 255);
-				tempBuffer.buf[k].g = (uint8_t)core_min(core_max(((tempBuffer.buf[k].g * i) >> 8) + tempBuffer.amb[k].g, 0), 255);
-				tempBuffer.buf[k].b = (uint8_t)core_min(core_max(((tempBuffer.buf[k].b * i) >> 8) + tempBuffer.amb[k].b, 0), 255);
-			}
+		for (int k = 0; k < w * d; k++) {
+			color::RGBA &color = columns[k].color;
+			const color::RGBA &amb = columns[k].amb;
+			const int i = 256 - (sh[k] << 2);
+			color.r = (uint8_t)core_min(core_max(((color.r * i) >> 8) + amb.r, 0), 255);
+			color.g = (uint8_t)core_min(core_max(((color.g * i) >> 8) + amb.g, 0), 255);
+			color.b = (uint8_t)core_min(core_max(((color.b * i) >> 8) + amb.b, 0), 255);
 		}
 	}
 
-	palette::Palette palette;
-	palette.nippon();
-
-	const voxel::Region region(0, 0, 0, settings.size - 1, settings.height - 1, settings.size - 1);
+	const voxel::Region region(x0, 0, z0, x0 + w - 1, settings.height - 1, z0 + d - 1);
 	voxel::RawVolume *volume = new voxel::RawVolume(region);
-	palette::PaletteLookup paletteLookup(palette);
-	app::for_parallel(0, settings.size, [&paletteLookup, &tempBuffer, &settings, volume] (int start, int end) {
-		const color::RGBA *heightmap = tempBuffer.buf + start * settings.size;
-		const int *heights = tempBuffer.heights + start * settings.size;
+	genlandFor(parallel, 0, d, [&ctx, &columns, &settings, volume, x0, z0, w](int start, int end) {
+		const GenlandContext::Column *column = columns.data() + start * w;
 		voxel::RawVolume::Sampler sampler(*volume);
 		for (int vz = start; vz < end; ++vz) {
-			for (int vx = 0; vx < settings.size; ++vx, ++heightmap, ++heights) {
-				const int maxsy = glm::clamp(*heights, 0, settings.height);
+			for (int vx = 0; vx < w; ++vx, ++column) {
+				const int maxsy = glm::clamp(column->height, 0, settings.height);
 				if (maxsy < 0) {
 					continue;
 				}
-				const color::RGBA color{heightmap->r, heightmap->g, heightmap->b, 255};
-				const int palIdx = paletteLookup.findClosestIndex(color);
+				// the lookup caches the first match of colors that only differ in the lowest bits - use the same
+				// color for all of them to not depend on the order the tiles and rows are generated in
+				const color::RGBA color{(uint8_t)((column->color.r & 0xF8) | 4), (uint8_t)((column->color.g & 0xF8) | 4),
+										(uint8_t)((column->color.b & 0xF8) | 4), 255};
+				const int palIdx = ctx.paletteLookup.findClosestIndex(color);
 				const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, palIdx);
 				const int amount = maxsy == 0 ? 1 : maxsy;
-				sampler.setPosition(vx, 0, vz);
+				sampler.setPosition(x0 + vx, 0, z0 + vz);
 				for (int y = 0; y < amount; ++y) {
 					sampler.setVoxel(voxel);
 					sampler.movePositiveY();
@@ -403,8 +473,120 @@ voxel::RawVolume *genland(GenlandSettings &settings) {
 			}
 		}
 	});
+	return volume;
+}
+
+static bool validateSettings(const GenlandSettings &settings) {
+	if (!glm::isPowerOfTwo(settings.size)) {
+		Log::error("Size must be a power of two, got %d", settings.size);
+		return false;
+	}
+
+	if (settings.octaves < 1) {
+		Log::error("Octaves must be at least 1, got %d", settings.octaves);
+		return false;
+	}
+
+	if (settings.height < 1) {
+		Log::error("Height must be at least 1, got %d", settings.height);
+		return false;
+	}
+
+	if (settings.offset[0] < 0) {
+		Log::error("Offset X must be at least 0, got %d", settings.offset[0]);
+		return false;
+	}
+	if (settings.offset[1] < 0) {
+		Log::error("Offset Y must be at least 0, got %d", settings.offset[1]);
+		return false;
+	}
+	return true;
+}
+
+voxel::RawVolume *genland(GenlandSettings &settings) {
+	if (!validateSettings(settings)) {
+		return nullptr;
+	}
+	Log::debug("Generating landscape with seed %d, height %d, octaves %d", settings.seed, settings.height,
+			   settings.octaves);
+	const GenlandContext ctx(settings);
+	// the whole map is one tile
+	voxel::RawVolume *volume = genlandTile(ctx, 0, 0, settings.size, settings.size, true);
 	// volume->translate(glm::ivec3(settings.offset[0], 0, settings.offset[1]));
 	return volume;
 }
 
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, const GenlandTileFunc &func) {
+	if (!validateSettings(settings)) {
+		return false;
+	}
+	if (tiling.tileSize < 1) {
+		Log::error("Tile size must be at least 1, got %d", tiling.tileSize);
+		return false;
+	}
+	glm::ivec2 mins = tiling.mins;
+	glm::ivec2 maxs = tiling.maxs;
+	if (maxs.x < mins.x || maxs.y < mins.y) {
+		mins = glm::ivec2(0);
+		maxs = glm::ivec2(settings.size - 1);
+	}
+	const int tilesX = (maxs.x - mins.x + tiling.tileSize) / tiling.tileSize;
+	const int tilesZ = (maxs.y - mins.y + tiling.tileSize) / tiling.tileSize;
+	const int tiles = tilesX * tilesZ;
+	int batchSize = tiling.batchSize;
+	if (batchSize <= 0) {
+		batchSize = core_max(1, app::App::getInstance()->threads());
+	}
+	Log::debug("Generating landscape in %i tiles with seed %d, height %d, octaves %d", tiles, settings.seed,
+			   settings.height, settings.octaves);
+
+	const GenlandContext ctx(settings);
+	core::Buffer<voxel::RawVolume *> batch;
+	batch.resize(core_min(batchSize, tiles));
+	for (int first = 0; first < tiles; first += batchSize) {
+		const int last = core_min(first + batchSize, tiles);
+		app::for_parallel(first, last, [&](int start, int end) {
+			for (int tile = start; tile < end; ++tile) {
+				const int x0 = mins.x + (tile % tilesX) * tiling.tileSize;
+				const int z0 = mins.y + (tile / tilesX) * tiling.tileSize;
+				const int w = core_min(tiling.tileSize, maxs.x - x0 + 1);
+				const int d = core_min(tiling.tileSize, maxs.y - z0 + 1);
+				batch[tile - first] = genlandTile(ctx, x0, z0, w, d, false);
+			}
+		});
+		// hand the tiles over in a stable order
+		for (int tile = first; tile < last; ++tile) {
+			func(batch[tile - first]);
+		}
+		Log::debug("%i percent done", (int)((last * 100) / tiles));
+	}
+	return true;
+}
+
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, voxel::SparseVolume &volume) {
+	return genlandTiles(settings, tiling, [&volume](voxel::RawVolume *tile) {
+		volume.copyFrom(*tile);
+		delete tile;
+	});
+}
+
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, scenegraph::SceneGraph &sceneGraph,
+				  int parent) {
+	palette::Palette palette;
+	palette.nippon();
+	bool success = true;
+	const bool generated = genlandTiles(settings, tiling, [&](voxel::RawVolume *tile) {
+		const voxel::Region &region = tile->region();
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(tile);
+		node.setName(core::String::format("Land %i:%i", region.getLowerX(), region.getLowerZ()));
+		node.setProperty(scenegraph::PropGenerator, "Genland by Tom Dobrowolski");
+		node.setPalette(palette);
+		if (sceneGraph.emplace(core::move(node), parent) == InvalidNodeId) {
+			success = false;
+		}
+	});
+	return generated && success;
+}
+
 } // namespace voxelgenerator
@@ -5,11 +5,17 @@
 #pragma once
 
 #include "color/RGBA.h"
+#include "core/Function.h"
 
 #include <glm/vec2.hpp>
 
 namespace voxel {
 class RawVolume;
+class SparseVolume;
+} // namespace voxel
+
+namespace scenegraph {
+class SceneGraph;
 }
 
 namespace voxelgenerator {
@@ -52,6 +58,9 @@ struct GenlandSettings {
 	bool shadow = true;
 	// Shadow strength when a column is occluded (genland default 32)
 	int shadowFactor = 32;
+	// How many columns a shadow ray travels - 0 uses a quarter of the size. The tiled generation has to compute the
+	// heights of this many columns around each tile
+	int shadowDistance = 0;
 	// Generate rivers in the land
 	bool river = true;
 	bool ambience = true;
@@ -60,6 +69,43 @@ struct GenlandSettings {
 	glm::ivec2 offset{0, 0};
 };
 
+struct GenlandTiling {
+	// Width and depth of the square tiles in voxels
+	int tileSize = 128;
+	// The columns to generate - the map repeats after GenlandSettings::size columns. If maxs is smaller than mins the
+	// whole map is generated
+	glm::ivec2 mins{0, 0};
+	glm::ivec2 maxs{-1, -1};
+	// How many tiles are generated at the same time - 0 uses the amount of threads. This bounds the memory of the
+	// tiles that were not yet handed over
+	int batchSize = 0;
+};
+
+/**
+ * @brief Receives the generated tiles and takes ownership of the volume
+ *
+ * The region of the volume is in world coordinates. The tiles are handed over in rows along the x axis on the calling
+ * thread.
+ */
+using GenlandTileFunc = core::Function<void(voxel::RawVolume *tile)>;
+
 voxel::RawVolume *genland(GenlandSettings &settings);
 
+/**
+ * @brief Generate the land in independent tiles in parallel
+ *
+ * The tiles are seamless - generating a tile always gives the same voxels as the same columns in the volume of
+ * @c genland() for the same settings.
+ */
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, const GenlandTileFunc &func);
+/**
+ * @brief Generate the tiles into a sparse volume - only the voxels of the tiles are kept in memory
+ */
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, voxel::SparseVolume &volume);
+/**
+ * @brief Generate the tiles as model nodes below the given parent node
+ */
+bool genlandTiles(const GenlandSettings &settings, const GenlandTiling &tiling, scenegraph::SceneGraph &sceneGraph,
+				  int parent);
+
 } // namespace voxelgenerator
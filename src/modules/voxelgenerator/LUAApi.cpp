@@ -8,6 +8,7 @@
 #include "commonlua/LUA.h"
 #include "commonlua/LUAFunctions.h"
 #include "color/Color.h"
+#include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
 #include "core/Unicode.h"
 #include "image/Image.h"
@@ -17,6 +18,7 @@
 #include "lauxlib.h"
 #include "math/Axis.h"
 #include "math/Random.h"
+#include "noise/NoiseGrid.h"
 #include "noise/Simplex.h"
 #include "palette/NormalPalette.h"
 #include "palette/PaletteFormatDescription.h"
@@ -44,6 +46,7 @@
 #include "voxelgenerator/LSystem.h"
 #include "voxelgenerator/ShapeGenerator.h"
 #include "voxelutil/AStarPathfinder.h"
+#include "voxelutil/NavigationGrid.h"
 #include "voxelutil/FillHollow.h"
 #include "voxelutil/Hollow.h"
 #include "voxelutil/ImageUtils.h"
@@ -53,7 +56,6 @@
 #include "voxelutil/VolumeMerger.h"
 #include "voxelutil/VolumeMover.h"
 #include "voxelutil/VolumeRescaler.h"
-#include "voxelutil/VolumeResizer.h"
 #include "voxelutil/VolumeRotator.h"
 #include "voxelutil/VolumeSplitter.h"
 #include "voxelutil/VolumeSculpt.h"
@@ -90,6 +92,7 @@ private:
 	using Super = voxel::RawVolumeWrapper;
 	scenegraph::SceneGraphNode *_node;
 	scenegraph::SceneGraph *_sceneGraph;
+	core::ScopedPtr<voxelutil::NavigationGrid> _navigation;
 public:
 	LuaRawVolumeWrapper(scenegraph::SceneGraphNode *node, scenegraph::SceneGraph *sceneGraph)
 		: Super(node->volume()), _node(node), _sceneGraph(sceneGraph) {
@@ -103,6 +106,41 @@ public:
 		return _node;
 	}
 
+	/**
+	 * @brief The navigation grid for the hierarchical pathfinder - it's built on the first call and afterwards only
+	 * the clusters of the regions that were modified since the last call are evaluated again
+	 */
+	template<class FUNC>
+	const voxelutil::NavigationGrid &navigation(voxel::Connectivity connectivity, FUNC &&isWalkable) {
+		const voxel::Region &modified = takeModifiedRegion();
+		const voxel::RawVolume *v = volume();
+		if (_navigation == nullptr || _navigation->connectivity() != connectivity ||
+			_navigation->region() != v->region()) {
+			_navigation = new voxelutil::NavigationGrid(connectivity);
+			_navigation->build(*v, isWalkable);
+		} else if (modified.isValid()) {
+			_navigation->update(*v, modified, isWalkable);
+		}
+		return *_navigation;
+	}
+
+	/**
+	 * @brief Changes the region of the node volume in place
+	 */
+	bool resize(const voxel::Region &region) {
+		const voxel::Region &current = volume()->region();
+		if (!current.containsRegion(region) && !app::App::getInstance()->hasEnoughMemory(voxel::RawVolume::size(region))) {
+			return false;
+		}
+		if (!Super::resize(region)) {
+			return false;
+		}
+		if (_sceneGraph) {
+			_sceneGraph->markDirty();
+		}
+		return true;
+	}
+
 	void update() {
 		if (_node->volume() == volume()) {
 			return;
@@ -502,12 +540,14 @@ static int luaVoxel_volumewrapper_resize(lua_State *s) {
 	const int h = (int)luaL_optinteger(s, 3, 0);
 	const int d = (int)luaL_optinteger(s, 4, 0);
 	const bool extendMins = (int)clua_optboolean(s, 5, false);
-	voxel::RawVolume *v = voxelutil::resize(volume->volume(), glm::ivec3(w, h, d), extendMins);
-	if (v == nullptr) {
+	voxel::Region region = volume->volume()->region();
+	region.shiftUpperCorner(w, h, d);
+	if (extendMins) {
+		region.shiftLowerCorner(w, h, d);
+	}
+	if (!region.isValid() || !volume->resize(region)) {
 		return clua_error(s, "Failed to resize the volume");
 	}
-	volume->setVolume(v);
-	volume->update();
 	return 0;
 }
 
@@ -710,6 +750,12 @@ static int luaVoxel_volumewrapper_isselected(lua_State* s) {
 	const int x = (int)luaL_checkinteger(s, 2);
 	const int y = (int)luaL_checkinteger(s, 3);
 	const int z = (int)luaL_checkinteger(s, 4);
+	const scenegraph::SceneGraphNode *node = volume->node();
+	if (node->volume() == volume->volume()) {
+		lua_pushboolean(s, node->selection().test(glm::ivec3(x, y, z)) ? 1 : 0);
+		return 1;
+	}
+	// the script replaced the volume - it's not yet known to the node
 	const voxel::Voxel& voxel = volume->voxel(x, y, z);
 	lua_pushboolean(s, (voxel.getFlags() & voxel::FlagOutline) != 0 ? 1 : 0);
 	return 1;
@@ -726,6 +772,18 @@ static int luaVoxel_volumewrapper_setselected(lua_State* s) {
 		lua_pushboolean(s, 0);
 		return 1;
 	}
+	scenegraph::SceneGraphNode *node = volume->node();
+	if (node->volume() == volume->volume()) {
+		const glm::ivec3 pos(x, y, z);
+		if (selected) {
+			node->select(pos);
+		} else {
+			node->unselect(pos);
+		}
+		volume->addToDirtyRegion(pos);
+		lua_pushboolean(s, 1);
+		return 1;
+	}
 	if (selected) {
 		voxel.setFlags(voxel.getFlags() | voxel::FlagOutline);
 	} else {
@@ -970,6 +1028,7 @@ static int luaVoxel_volumewrapper_pathfinder(lua_State *s) {
 	}
 	const float hBias = (float)luaL_optnumber(s, 9, 4.0);
 	const int maxNodes = (int)luaL_optinteger(s, 10, 10000);
+	const bool hierarchical = lua_toboolean(s, 11) != 0;
 
 	const glm::ivec3 start(startX, startY, startZ);
 	const glm::ivec3 end(endX, endY, endZ);
@@ -987,6 +1046,10 @@ static int luaVoxel_volumewrapper_pathfinder(lua_State *s) {
 	};
 	voxelutil::AStarPathfinderParams<voxel::RawVolume> params(vol, start, end, &listResult,
 															  func, hBias, (uint32_t)maxNodes, connectivity);
+	if (hierarchical) {
+		// the grid is cached in the volume wrapper - further queries only update the modified clusters
+		params.navigation = &volume->navigation(connectivity, func);
+	}
 	voxelutil::AStarPathfinder pathfinder(params);
 	if (!pathfinder.execute()) {
 		lua_pushnil(s);
@@ -1192,13 +1255,11 @@ static int luaVoxel_volumewrapper_gc(lua_State *s) {
 	if (volume->dirtyRegion().isValid()) {
 		LuaDirtyRegions* dirtyRegions = luaVoxel_globalData<LuaDirtyRegions>(s, luaVoxel_globaldirtyregions());
 		const int nodeId = volume->node()->id();
-		if (dirtyRegions->hasKey(nodeId)) {
-			voxel::Region region;
-			dirtyRegions->get(nodeId, region);
-			region.accumulate(volume->dirtyRegion());
-			dirtyRegions->put(nodeId, region);
+		auto iter = dirtyRegions->find(nodeId);
+		if (iter == dirtyRegions->end()) {
+			dirtyRegions->put(nodeId, volume->dirtyRegions());
 		} else {
-			dirtyRegions->put(nodeId, volume->dirtyRegion());
+			iter->value.append(volume->dirtyRegions());
 		}
 	}
 	delete volume;
@@ -2378,6 +2439,70 @@ static int luaVoxel_noise_worley3(lua_State* s) {
 	return 1;
 }
 
+static bool luaVoxel_noise_gridparams(lua_State* s, int n, noise::NoiseGrid &grid) {
+	const char *type = luaL_checkstring(s, 1);
+	grid.type = noise::toNoiseGridType(type);
+	if (grid.type == noise::NoiseGridType::Max) {
+		return false;
+	}
+	grid.step = glm::vec3((float)luaL_optnumber(s, n, 1.0f));
+	grid.octaves = luaL_optinteger(s, n + 1, 4);
+	grid.lacunarity = (float)luaL_optnumber(s, n + 2, 2.0f);
+	grid.gain = (float)luaL_optnumber(s, n + 3, 0.5f);
+	return true;
+}
+
+static void luaVoxel_noise_pushgrid(lua_State* s, const core::DynamicArray<float> &values) {
+	lua_createtable(s, (int)values.size(), 0);
+	for (size_t i = 0; i < values.size(); ++i) {
+		lua_pushnumber(s, values[i]);
+		lua_rawseti(s, -2, (int)(i + 1));
+	}
+}
+
+static constexpr int64_t MaxNoiseGridSize = 1024 * 1024 * 16;
+
+static int luaVoxel_noise_grid2(lua_State* s) {
+	int n = 2;
+	const glm::vec2 pos = to_vec2(s, n);
+	const int width = (int)luaL_checkinteger(s, n + 1);
+	const int height = (int)luaL_checkinteger(s, n + 2);
+	if (width <= 0 || height <= 0 || (int64_t)width * height > MaxNoiseGridSize) {
+		return clua_error(s, "Invalid noise grid size %i:%i", width, height);
+	}
+	noise::NoiseGrid grid;
+	if (!luaVoxel_noise_gridparams(s, n + 3, grid)) {
+		return clua_error(s, "Unknown noise type %s", lua_tostring(s, 1));
+	}
+	grid.origin = glm::vec3(pos, 0.0f);
+	core::DynamicArray<float> values;
+	values.resize((size_t)width * height);
+	noise::fillNoise2D(values.data(), width, height, grid);
+	luaVoxel_noise_pushgrid(s, values);
+	return 1;
+}
+
+static int luaVoxel_noise_grid3(lua_State* s) {
+	int n = 2;
+	const glm::vec3 pos = to_vec3(s, n);
+	const int width = (int)luaL_checkinteger(s, n + 1);
+	const int height = (int)luaL_checkinteger(s, n + 2);
+	const int depth = (int)luaL_checkinteger(s, n + 3);
+	if (width <= 0 || height <= 0 || depth <= 0 || (int64_t)width * height * depth > MaxNoiseGridSize) {
+		return clua_error(s, "Invalid noise grid size %i:%i:%i", width, height, depth);
+	}
+	noise::NoiseGrid grid;
+	if (!luaVoxel_noise_gridparams(s, n + 4, grid)) {
+		return clua_error(s, "Unknown noise type %s", lua_tostring(s, 1));
+	}
+	grid.origin = pos;
+	core::DynamicArray<float> values;
+	values.resize((size_t)width * height * depth);
+	noise::fillNoise3D(values.data(), width, height, depth, grid);
+	luaVoxel_noise_pushgrid(s, values);
+	return 1;
+}
+
 // LSystem bindings
 
 static int luaVoxel_lsystem_generate(lua_State *s) {
@@ -4142,7 +4267,8 @@ static int luaVoxel_volumewrapper_pathfinder_jsonhelp(lua_State* s) {
 			{"name": "endZ", "type": "integer", "description": "The z coordinate of the end position."},
 			{"name": "connectivity", "type": "string", "description": "Connectivity type: '6' (faces), '18' (faces+edges), '26' (faces+edges+corners) (optional, default '18')."},
 			{"name": "hBias", "type": "number", "description": "Heuristic bias for pathfinding. Higher values find paths faster but may be less optimal (optional, default 4.0)."},
-			{"name": "maxNodes", "type": "integer", "description": "Maximum number of nodes to explore before giving up (optional, default 10000)."}
+			{"name": "maxNodes", "type": "integer", "description": "Maximum number of nodes to explore before giving up (optional, default 10000)."},
+			{"name": "hierarchical", "type": "boolean", "description": "Search the path on clusters of the volume first - this is faster for long paths and repeated queries, but the path may be less optimal. The clusters are built on the first query and only updated for the modified parts of the volume afterwards (optional, default false)."}
 		],
 		"returns": [
 			{"type": "table", "description": "An array of tables with x, y, z fields representing the path positions, or nil if no path was found."}
@@ -5025,6 +5151,49 @@ static int luaVoxel_noise_worley3_jsonhelp(lua_State* s) {
 	return 1;
 }
 
+static int luaVoxel_noise_grid2_jsonhelp(lua_State* s) {
+	const char *json = R"({
+		"name": "grid2",
+		"summary": "Generate 2D noise for a whole grid of positions at once - e.g. a heightmap.",
+		"parameters": [
+			{"name": "type", "type": "string", "description": "The noise type: simplex, fbm, ridgedmf, worley or voronoi."},
+			{"name": "pos", "type": "vec2", "description": "The position of the first sample."},
+			{"name": "width", "type": "integer", "description": "The amount of samples on the x axis."},
+			{"name": "height", "type": "integer", "description": "The amount of samples on the y axis."},
+			{"name": "step", "type": "number", "description": "The distance between two samples (optional, default 1.0)."},
+			{"name": "octaves", "type": "integer", "description": "Number of octaves for fbm and ridgedmf (optional, default 4)."},
+			{"name": "lacunarity", "type": "number", "description": "Lacunarity for fbm and ridgedmf (optional, default 2.0)."},
+			{"name": "gain", "type": "number", "description": "Gain for fbm and ridgedmf (optional, default 0.5)."}
+		],
+		"returns": [
+			{"type": "table", "description": "The width*height noise values - the sample x,y is at index y*width+x+1."}
+		]})";
+	lua_pushstring(s, json);
+	return 1;
+}
+
+static int luaVoxel_noise_grid3_jsonhelp(lua_State* s) {
+	const char *json = R"({
+		"name": "grid3",
+		"summary": "Generate 3D noise for a whole grid of positions at once - e.g. a density volume.",
+		"parameters": [
+			{"name": "type", "type": "string", "description": "The noise type: simplex, fbm, ridgedmf, worley or voronoi."},
+			{"name": "pos", "type": "vec3", "description": "The position of the first sample."},
+			{"name": "width", "type": "integer", "description": "The amount of samples on the x axis."},
+			{"name": "height", "type": "integer", "description": "The amount of samples on the y axis."},
+			{"name": "depth", "type": "integer", "description": "The amount of samples on the z axis."},
+			{"name": "step", "type": "number", "description": "The distance between two samples (optional, default 1.0)."},
+			{"name": "octaves", "type": "integer", "description": "Number of octaves for fbm and ridgedmf (optional, default 4)."},
+			{"name": "lacunarity", "type": "number", "description": "Lacunarity for fbm and ridgedmf (optional, default 2.0)."},
+			{"name": "gain", "type": "number", "description": "Gain for fbm and ridgedmf (optional, default 0.5)."}
+		],
+		"returns": [
+			{"type": "table", "description": "The width*height*depth noise values - the sample x,y,z is at index (z*height+y)*width+x+1."}
+		]})";
+	lua_pushstring(s, json);
+	return 1;
+}
+
 static int luaVoxel_palette_colors_jsonhelp(lua_State* s) {
 	const char *json = R"({
 		"name": "colors",
@@ -7035,6 +7204,8 @@ void luaVoxel_prepareState(lua_State* s) {
 		{"ridgedMF4", luaVoxel_noise_ridgedMF4, luaVoxel_noise_ridgedMF4_jsonhelp},
 		{"worley2", luaVoxel_noise_worley2, luaVoxel_noise_worley2_jsonhelp},
 		{"worley3", luaVoxel_noise_worley3, luaVoxel_noise_worley3_jsonhelp},
+		{"grid2", luaVoxel_noise_grid2, luaVoxel_noise_grid2_jsonhelp},
+		{"grid3", luaVoxel_noise_grid3, luaVoxel_noise_grid3_jsonhelp},
 		{nullptr, nullptr, nullptr}
 	};
 	clua_registerfuncsglobal(s, noiseFuncs, luaVoxel_metanoise(), "g_noise");
@@ -84,7 +84,11 @@ struct LUAScript {
 
 enum class ScriptState { Running, Finished, Inactive, Error };
 
-using LuaDirtyRegions = core::DynamicMap<int, voxel::Region>;
+/**
+ * @brief The modified parts of the volumes per node id - only the touched chunks of a volume are covered
+ * @sa voxel::RawVolumeWrapper::dirtyRegions()
+ */
+using LuaDirtyRegions = core::DynamicMap<int, core::DynamicArray<voxel::Region>>;
 
 class LUAApi : public core::IComponent {
 private:
@@ -0,0 +1,32 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/RawVolume.h"
+#include "voxelgenerator/Genland.h"
+
+class GenlandBenchmark : public app::AbstractBenchmark {};
+
+BENCHMARK_DEFINE_F(GenlandBenchmark, Map)(benchmark::State &state) {
+	voxelgenerator::GenlandSettings settings;
+	settings.size = (int)state.range(0);
+	for (auto _ : state) {
+		voxel::RawVolume *volume = voxelgenerator::genland(settings);
+		benchmark::DoNotOptimize(volume);
+		delete volume;
+	}
+}
+
+BENCHMARK_DEFINE_F(GenlandBenchmark, Tiles)(benchmark::State &state) {
+	voxelgenerator::GenlandSettings settings;
+	settings.size = (int)state.range(0);
+	voxelgenerator::GenlandTiling tiling;
+	tiling.tileSize = 64;
+	for (auto _ : state) {
+		voxelgenerator::genlandTiles(settings, tiling, [](voxel::RawVolume *tile) { delete tile; });
+	}
+}
+
+BENCHMARK_REGISTER_F(GenlandBenchmark, Map)->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(GenlandBenchmark, Tiles)->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
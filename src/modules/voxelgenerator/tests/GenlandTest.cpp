@@ -4,7 +4,9 @@
 
 #include "app/tests/AbstractTest.h"
 #include "core/ScopedPtr.h"
+#include "scenegraph/SceneGraph.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SparseVolume.h"
 #include "voxelgenerator/Genland.h"
 #include "voxelutil/VolumeVisitor.h"
 
@@ -38,6 +40,32 @@ protected:
 		}
 		return true;
 	}
+
+	// compare the tiles with the same columns of the whole map
+	static void expectTilesMatch(const GenlandSettings &settings, const GenlandTiling &tiling, int expectedTiles) {
+		GenlandSettings copy = settings;
+		core::ScopedPtr<voxel::RawVolume> map(genland(copy));
+		ASSERT_NE(nullptr, map);
+		const int mask = settings.size - 1;
+		int tiles = 0;
+		int mismatches = 0;
+		ASSERT_TRUE(genlandTiles(settings, tiling, [&](voxel::RawVolume *tile) {
+			++tiles;
+			const voxel::Region &region = tile->region();
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+					for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+						if (!(tile->voxel(x, y, z) == map->voxel(x & mask, y, z & mask))) {
+							++mismatches;
+						}
+					}
+				}
+			}
+			delete tile;
+		}));
+		EXPECT_EQ(expectedTiles, tiles);
+		EXPECT_EQ(0, mismatches);
+	}
 };
 
 TEST_F(GenlandTest, testDefaultsProduceVolume) {
@@ -162,6 +190,68 @@ TEST_F(GenlandTest, testNumRiversChangesLayout) {
 	EXPECT_FALSE(volumesEqual(*oneRiver, *fourRivers));
 }
 
+TEST_F(GenlandTest, testTilesMatchMap) {
+	GenlandSettings settings;
+	settings.size = 64;
+	settings.height = 64;
+	settings.seed = 3;
+	settings.smoothing = 2;
+	GenlandTiling tiling;
+	// the last tiles are smaller
+	tiling.tileSize = 24;
+	expectTilesMatch(settings, tiling, 9);
+}
+
+TEST_F(GenlandTest, testTilesMatchMapShadowDistance) {
+	GenlandSettings settings;
+	settings.size = 128;
+	settings.height = 64;
+	settings.seed = 5;
+	settings.shadowDistance = 8;
+	GenlandTiling tiling;
+	tiling.tileSize = 32;
+	tiling.batchSize = 3;
+	expectTilesMatch(settings, tiling, 16);
+}
+
+TEST_F(GenlandTest, testTilesArea) {
+	GenlandSettings settings;
+	settings.size = 32;
+	settings.height = 32;
+	settings.seed = 9;
+	GenlandTiling tiling;
+	tiling.tileSize = 16;
+	// the map repeats after size columns
+	tiling.mins = glm::ivec2(8, 24);
+	tiling.maxs = glm::ivec2(55, 39);
+	expectTilesMatch(settings, tiling, 3);
+}
+
+TEST_F(GenlandTest, testTilesSparseVolume) {
+	GenlandSettings settings;
+	settings.size = 32;
+	settings.height = 32;
+	settings.seed = 4;
+	core::ScopedPtr<voxel::RawVolume> map(genland(settings));
+	ASSERT_NE(nullptr, map);
+	GenlandTiling tiling;
+	tiling.tileSize = 16;
+	voxel::SparseVolume volume;
+	ASSERT_TRUE(genlandTiles(settings, tiling, volume));
+	EXPECT_EQ((size_t)voxelutil::countVoxels(*map), volume.size());
+}
+
+TEST_F(GenlandTest, testTilesSceneGraph) {
+	GenlandSettings settings;
+	settings.size = 32;
+	settings.height = 16;
+	GenlandTiling tiling;
+	tiling.tileSize = 16;
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_TRUE(genlandTiles(settings, tiling, sceneGraph, sceneGraph.root().id()));
+	EXPECT_EQ(4u, sceneGraph.size(scenegraph::SceneGraphNodeType::Model));
+}
+
 TEST_F(GenlandTest, testRejectInvalidSettings) {
 	{
 		GenlandSettings settings;
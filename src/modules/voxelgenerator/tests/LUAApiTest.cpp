@@ -121,6 +121,34 @@ TEST_F(LUAApiTest, testExecute) {
 	EXPECT_NE(0u, volume->voxel(1, 0, 0).getColor());
 }
 
+TEST_F(LUAApiTest, testNoiseGrid) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local w = 5
+			local h = 3
+			local pos = g_vec2.new(2, 3)
+			local values = g_noise.grid2("fbm", pos, w, h, 0.5)
+			local match = #values == w * h
+			for y = 0, h - 1 do
+				for x = 0, w - 1 do
+					local expected = g_noise.fBm2(g_vec2.new(2 + x * 0.5, 3 + y * 0.5))
+					if math.abs(values[y * w + x + 1] - expected) > 0.00001 then
+						match = false
+					end
+				end
+			end
+			if match then
+				node:volume():setVoxel(0, 0, 0, color)
+			end
+		end
+	)";
+
+	scenegraph::SceneGraph sceneGraph;
+	run(sceneGraph, script);
+	voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNodeUUID()).volume();
+	EXPECT_EQ(42u, volume->voxel(0, 0, 0).getColor());
+}
+
 TEST_F(LUAApiTest, testYield) {
 	const core::String script = R"(
 		function main(node, region, color)
@@ -1217,6 +1245,44 @@ TEST_F(LUAApiTest, testVoxelUtilBindings) {
 	run(sceneGraph, script);
 }
 
+TEST_F(LUAApiTest, testPathfinderHierarchical) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local volume = node:volume()
+			volume:clear()
+			for x = 0, 7 do
+				for z = 0, 7 do
+					volume:setVoxel(x, 0, z, 1)
+				end
+			end
+			local path = volume:pathfinder(0, 1, 0, 7, 1, 7, "18", 1.0, 10000)
+			assert(path ~= nil, "expected a path")
+			local hpath = volume:pathfinder(0, 1, 0, 7, 1, 7, "18", 1.0, 10000, true)
+			assert(hpath ~= nil, "expected a hierarchical path")
+			assert(hpath[1].x == 0 and hpath[1].y == 1 and hpath[1].z == 0, "unexpected start")
+			local last = hpath[#hpath]
+			assert(last.x == 7 and last.y == 1 and last.z == 7, "unexpected end")
+			assert(#hpath == #path, "the paths should have the same length: " .. #hpath .. " vs " .. #path)
+			assert(volume:pathfinder(0, 1, 0, 7, 5, 7, "18", 1.0, 10000, true) == nil, "end is not walkable")
+			-- the cached clusters must be updated for the modifications
+			for x = 3, 5 do
+				for z = 0, 7 do
+					volume:setVoxel(x, 0, z, -1)
+				end
+			end
+			assert(volume:pathfinder(0, 1, 0, 7, 1, 7, "18", 1.0, 10000, true) == nil, "the trench should block the path")
+			volume:setVoxel(4, 0, 3, 1)
+			local bridged = volume:pathfinder(0, 1, 0, 7, 1, 7, "18", 1.0, 10000, true)
+			assert(bridged ~= nil, "expected a path over the bridge")
+			for _, p in ipairs(bridged) do
+				assert(p.x ~= 4 or math.abs(p.z - 3) <= 1, "the path must cross the trench on the bridge")
+			end
+		end
+	)";
+	scenegraph::SceneGraph sceneGraph;
+	run(sceneGraph, script);
+}
+
 TEST_F(LUAApiTest, testVolumeMergeBinding) {
 	const core::String script = R"(
 		function main(node, region, color)
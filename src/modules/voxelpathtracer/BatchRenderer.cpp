@@ -0,0 +1,466 @@
+/**
+ * @file
+ */
+
+#include "BatchRenderer.h"
+#include "PathTracer.h"
+#include "PathTracerState.h"
+#include "VoxelTracer.h"
+#include "app/App.h"
+#include "app/ForParallel.h"
+#include "core/Common.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/TimeProvider.h"
+#include "core/Trace.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/FileStream.h"
+#include "io/Filesystem.h"
+#include "voxel/RawVolume.h"
+#include <atomic>
+#include <glm/exponential.hpp>
+
+namespace voxelpathtracer {
+
+#define wrap(read)                                                                                                     \
+	if ((read) != 0) {                                                                                                 \
+		Log::error("Could not load checkpoint: Not enough data in stream " CORE_STRINGIFY(read) " (line %i)",          \
+				   (int)__LINE__);                                                                                     \
+		return false;                                                                                                  \
+	}
+
+#define wrapSave(write)                                                                                                \
+	if ((write) == false) {                                                                                            \
+		Log::error("Could not save checkpoint: " CORE_STRINGIFY(write) " failed");                                     \
+		return false;                                                                                                  \
+	}
+
+namespace {
+
+constexpr uint32_t CheckpointMagic = FourCC('V', 'P', 'T', 'C');
+// written at the end to detect checkpoints that were not completely written
+constexpr uint32_t CheckpointEndMagic = FourCC('V', 'P', 'T', 'E');
+constexpr uint32_t CheckpointVersion = 2;
+
+// the error of dark pixels is relative to this value - otherwise they would never converge
+constexpr float DarkPixelLuminance = 0.1f;
+
+template<class T>
+inline uint32_t hashValue(const T &value, uint32_t seed) {
+	return core::hash(&value, (int)sizeof(value), seed);
+}
+
+/**
+ * @brief Hash everything that the traced radiance depends on - a checkpoint of a different scene, camera or animation
+ * frame must not be resumed
+ *
+ * The tone mapping settings are not part of it - they are applied to the traced image.
+ */
+uint32_t sceneHash(const PathTracerState &pt) {
+	// the node order of the map is not stable - the hashes of the nodes are summed up
+	uint32_t nodes = 0u;
+	for (const auto &e : pt.nodes) {
+		const PathTracerNode &node = e->value;
+		uint32_t h = hashValue(node.region.getLowerCorner(), 0u);
+		h = hashValue(node.region.getUpperCorner(), h);
+		h = hashValue(node.paletteHash, h);
+		h = hashValue(node.transform, h);
+		if (node.volume != nullptr && node.volume->contiguous()) {
+			h = core::hash(node.volume->data(), (int)voxel::RawVolume::size(node.volume->region()), h);
+		} else if (node.volume != nullptr) {
+			// a grown volume has gaps between the rows
+			const voxel::Region &region = node.volume->region();
+			const int rowSize = region.getWidthInVoxels() * (int)sizeof(voxel::Voxel);
+			for (int z = 0; z < region.getDepthInVoxels(); ++z) {
+				for (int y = 0; y < region.getHeightInVoxels(); ++y) {
+					const voxel::Voxel *row = node.volume->voxels() + z * node.volume->strideZ() + y * node.volume->strideY();
+					h = core::hash(row, rowSize, h);
+				}
+			}
+		}
+		nodes += h;
+	}
+	uint32_t h = hashValue(nodes, 0u);
+	h = hashValue(pt.frame, h);
+	h = hashValue(pt.voxelTraversal, h);
+	if (pt.params.camera >= 0 && pt.params.camera < (int)pt.scene.cameras.size()) {
+		const yocto::camera_data &camera = pt.scene.cameras[pt.params.camera];
+		h = hashValue(camera.frame, h);
+		h = hashValue(camera.orthographic, h);
+		h = hashValue(camera.lens, h);
+		h = hashValue(camera.film, h);
+		h = hashValue(camera.aspect, h);
+		h = hashValue(camera.focus, h);
+		h = hashValue(camera.aperture, h);
+	}
+	for (const yocto::material_data &material : pt.scene.materials) {
+		h = hashValue(material, h);
+	}
+	for (const yocto::environment_data &environment : pt.scene.environments) {
+		h = hashValue(environment, h);
+	}
+	// the sun and sky of the environment
+	for (const yocto::texture_data &texture : pt.scene.textures) {
+		h = hashValue(texture.width, h);
+		h = hashValue(texture.height, h);
+		if (!texture.pixelsf.empty()) {
+			h = core::hash(texture.pixelsf.data(), (int)(texture.pixelsf.size() * sizeof(yocto::vec4f)), h);
+		}
+		if (!texture.pixelsb.empty()) {
+			h = core::hash(texture.pixelsb.data(), (int)(texture.pixelsb.size() * sizeof(yocto::vec4b)), h);
+		}
+	}
+	h = hashValue(pt.params.clamp, h);
+	h = hashValue(pt.params.nocaustics, h);
+	h = hashValue(pt.params.envhidden, h);
+	h = hashValue(pt.params.tentfilter, h);
+	return h;
+}
+
+double secondsSince(uint64_t start) {
+	const uint64_t delta = core::TimeProvider::highResTime() - start;
+	return (double)delta / (double)core::TimeProvider::highResTimeResolution();
+}
+
+} // namespace
+
+BatchRenderer::BatchRenderer(PathTracer &pathTracer, const BatchRenderOptions &options)
+	: _pathTracer(pathTracer), _options(options) {
+	_options.tileSize = core_max(1, _options.tileSize);
+	_options.samplesPerPass = core_max(1, _options.samplesPerPass);
+}
+
+void BatchRenderer::reset() {
+	PathTracerState &pt = _pathTracer.state();
+	pt.state = yocto::make_trace_state(pt.scene, pt.params);
+	const yocto::trace_state &state = pt.state;
+	_tiles.clear();
+	for (int y = 0; y < state.height; y += _options.tileSize) {
+		for (int x = 0; x < state.width; x += _options.tileSize) {
+			Tile tile;
+			tile.x = x;
+			tile.y = y;
+			tile.w = core_min(_options.tileSize, state.width - x);
+			tile.h = core_min(_options.tileSize, state.height - y);
+			_tiles.push_back(tile);
+		}
+	}
+	const size_t pixels = (size_t)state.width * (size_t)state.height;
+	_mean.resize(pixels);
+	_m2.resize(pixels);
+	for (size_t i = 0; i < pixels; ++i) {
+		_mean[i] = 0.0f;
+		_m2[i] = 0.0f;
+	}
+}
+
+void BatchRenderer::traceTile(Tile &tile) {
+	PathTracerState &pt = _pathTracer.state();
+	yocto::trace_state &state = pt.state;
+	const yocto::trace_params &params = pt.params;
+	const int samples = core_min(_options.samplesPerPass, params.samples - tile.samples);
+	for (int j = tile.y; j < tile.y + tile.h; ++j) {
+		for (int i = tile.x; i < tile.x + tile.w; ++i) {
+			const int idx = state.width * j + i;
+			for (int sample = tile.samples; sample < tile.samples + samples; ++sample) {
+				const yocto::vec4f before = state.image[idx];
+				if (pt.voxelTraversal) {
+					traceVoxelSample(state, pt.scene, pt.voxelScene, pt.lights, i, j, sample, params);
+				} else {
+					yocto::trace_sample(state, pt.scene, pt.bvh, pt.lights, i, j, sample, params);
+				}
+				// the image is the running mean of the samples - get the value of this sample back
+				const float n = (float)(sample + 1);
+				const yocto::vec4f &after = state.image[idx];
+				const yocto::vec3f radiance{before.x + (after.x - before.x) * n, before.y + (after.y - before.y) * n,
+											before.z + (after.z - before.z) * n};
+				const float value = yocto::luminance(radiance);
+				const float delta = value - _mean[idx];
+				_mean[idx] += delta / n;
+				_m2[idx] += delta * (value - _mean[idx]);
+			}
+		}
+	}
+	tile.samples += samples;
+
+	if (_options.adaptiveThreshold <= 0.0f || tile.samples < core_max(2, _options.minSamples)) {
+		return;
+	}
+	const float n = (float)tile.samples;
+	float error = 0.0f;
+	for (int j = tile.y; j < tile.y + tile.h; ++j) {
+		for (int i = tile.x; i < tile.x + tile.w; ++i) {
+			const int idx = state.width * j + i;
+			const float variance = _m2[idx] / (n - 1.0f);
+			error += glm::sqrt(variance / n) / (_mean[idx] + DarkPixelLuminance);
+		}
+	}
+	error /= (float)(tile.w * tile.h);
+	tile.converged = error < _options.adaptiveThreshold;
+}
+
+bool BatchRenderer::render() {
+	core_trace_scoped(BatchRender);
+	PathTracerState &pt = _pathTracer.state();
+	if (pt.scene.cameras.empty()) {
+		Log::error("No path tracer scene was set up");
+		return false;
+	}
+	const uint64_t start = core::TimeProvider::highResTime();
+	_finished = false;
+	if (_options.checkpointFile.empty()) {
+		reset();
+	} else if (loadCheckpointFile()) {
+		Log::info("Resume rendering from checkpoint %s with %i samples per pixel", _options.checkpointFile.c_str(),
+				  minTileSamples());
+	}
+
+	const double timeBudget = _options.timeBudget;
+	const int threads = core_max(1, app::App::getInstance()->threads());
+	double lastCheckpoint = 0.0;
+	core::DynamicArray<int> active;
+	active.reserve(_tiles.size());
+	for (;;) {
+		active.clear();
+		for (size_t i = 0; i < _tiles.size(); ++i) {
+			const Tile &tile = _tiles[i];
+			if (!tile.converged && tile.samples < pt.params.samples) {
+				active.push_back((int)i);
+			}
+		}
+		if (active.empty()) {
+			_finished = true;
+			break;
+		}
+		if (timeBudget > 0.0 && secondsSince(start) >= timeBudget) {
+			Log::info("Time budget of %.1f seconds reached with %i active tiles", timeBudget, (int)active.size());
+			break;
+		}
+
+		// the workers pick the next tile from the queue - tiles differ a lot in their costs
+		std::atomic_int next{0};
+		auto fn = [&](int, int) {
+			for (;;) {
+				if (timeBudget > 0.0 && secondsSince(start) >= timeBudget) {
+					return;
+				}
+				const int idx = next++;
+				if (idx >= (int)active.size()) {
+					return;
+				}
+				traceTile(_tiles[active[idx]]);
+			}
+		};
+		if (pt.params.noparallel) {
+			fn(0, 1);
+		} else {
+			app::for_parallel(0, threads, fn);
+		}
+
+		const double elapsed = secondsSince(start);
+		if (!_options.checkpointFile.empty() && elapsed - lastCheckpoint >= _options.checkpointInterval) {
+			saveCheckpointFile();
+			lastCheckpoint = elapsed;
+		}
+	}
+
+	pt.state.samples = minTileSamples();
+	if (!_options.checkpointFile.empty()) {
+		if (_finished) {
+			if (io::Filesystem::sysExists(_options.checkpointFile)) {
+				io::Filesystem::sysRemoveFile(_options.checkpointFile);
+			}
+		} else {
+			saveCheckpointFile();
+		}
+	}
+	if (pt.params.denoise && !pt.state.denoised.empty()) {
+		yocto::denoise_image(pt.state.denoised, pt.state.width, pt.state.height, pt.state.image, pt.state.albedo,
+							 pt.state.normal);
+	}
+	_seconds = secondsSince(start);
+	Log::info("Rendered %i tiles (%i converged) with %i to %i samples per pixel in %.2f seconds", (int)_tiles.size(),
+			  convergedTiles(), minTileSamples(), pt.params.samples, _seconds);
+	return true;
+}
+
+int BatchRenderer::convergedTiles() const {
+	int n = 0;
+	for (const Tile &tile : _tiles) {
+		if (tile.converged) {
+			++n;
+		}
+	}
+	return n;
+}
+
+int BatchRenderer::minTileSamples() const {
+	if (_tiles.empty()) {
+		return 0;
+	}
+	int samples = _tiles[0].samples;
+	for (const Tile &tile : _tiles) {
+		samples = core_min(samples, tile.samples);
+	}
+	return samples;
+}
+
+uint64_t BatchRenderer::totalSamples() const {
+	uint64_t samples = 0u;
+	for (const Tile &tile : _tiles) {
+		samples += (uint64_t)tile.samples * (uint64_t)(tile.w * tile.h);
+	}
+	return samples;
+}
+
+bool BatchRenderer::saveCheckpointFile() const {
+	core_trace_scoped(SaveCheckpoint);
+	io::BufferedReadWriteStream stream;
+	if (!saveCheckpoint(stream)) {
+		return false;
+	}
+	// the file is written in one go to keep the window small in which a killed job leaves a partial checkpoint
+	if (!io::Filesystem::sysWrite(_options.checkpointFile, stream.getBuffer(), (size_t)stream.size())) {
+		Log::warn("Failed to write checkpoint %s", _options.checkpointFile.c_str());
+		return false;
+	}
+	Log::debug("Wrote checkpoint %s", _options.checkpointFile.c_str());
+	return true;
+}
+
+bool BatchRenderer::loadCheckpointFile() {
+	if (!io::Filesystem::sysExists(_options.checkpointFile)) {
+		reset();
+		return false;
+	}
+	const io::FilePtr &file = io::filesystem()->open(_options.checkpointFile, io::FileMode::SysRead);
+	io::FileStream stream(file);
+	if (!stream.valid() || !loadCheckpoint(stream)) {
+		Log::warn("Ignoring checkpoint %s", _options.checkpointFile.c_str());
+		reset();
+		return false;
+	}
+	return true;
+}
+
+bool BatchRenderer::saveCheckpoint(io::WriteStream &stream) const {
+	const PathTracerState &pt = _pathTracer.state();
+	const yocto::trace_state &state = pt.state;
+	wrapSave(stream.writeUInt32(CheckpointMagic))
+	wrapSave(stream.writeUInt32(CheckpointVersion))
+	wrapSave(stream.writeInt32(state.width))
+	wrapSave(stream.writeInt32(state.height))
+	wrapSave(stream.writeInt32(_options.tileSize))
+	wrapSave(stream.writeInt32((int32_t)pt.params.sampler))
+	wrapSave(stream.writeInt32(pt.params.bounces))
+	wrapSave(stream.writeUInt32((uint32_t)_tiles.size()))
+	wrapSave(stream.writeUInt32(sceneHash(pt)))
+	for (const Tile &tile : _tiles) {
+		wrapSave(stream.writeInt32(tile.samples))
+		wrapSave(stream.writeBool(tile.converged))
+	}
+	const size_t pixels = (size_t)state.width * (size_t)state.height;
+	for (size_t i = 0; i < pixels; ++i) {
+		const yocto::vec4f &color = state.image[i];
+		const yocto::vec3f &albedo = state.albedo[i];
+		const yocto::vec3f &normal = state.normal[i];
+		wrapSave(stream.writeFloat(color.x))
+		wrapSave(stream.writeFloat(color.y))
+		wrapSave(stream.writeFloat(color.z))
+		wrapSave(stream.writeFloat(color.w))
+		wrapSave(stream.writeFloat(albedo.x))
+		wrapSave(stream.writeFloat(albedo.y))
+		wrapSave(stream.writeFloat(albedo.z))
+		wrapSave(stream.writeFloat(normal.x))
+		wrapSave(stream.writeFloat(normal.y))
+		wrapSave(stream.writeFloat(normal.z))
+		wrapSave(stream.writeInt32(state.hits[i]))
+		wrapSave(stream.writeUInt64(state.rngs[i].state))
+		wrapSave(stream.writeUInt64(state.rngs[i].inc))
+		wrapSave(stream.writeFloat(_mean[i]))
+		wrapSave(stream.writeFloat(_m2[i]))
+	}
+	wrapSave(stream.writeUInt32(CheckpointEndMagic))
+	return true;
+}
+
+bool BatchRenderer::loadCheckpoint(io::ReadStream &stream) {
+	reset();
+	PathTracerState &pt = _pathTracer.state();
+	yocto::trace_state &state = pt.state;
+	uint32_t magic;
+	wrap(stream.readUInt32(magic))
+	if (magic != CheckpointMagic) {
+		Log::error("Invalid checkpoint magic");
+		return false;
+	}
+	uint32_t version;
+	wrap(stream.readUInt32(version))
+	if (version != CheckpointVersion) {
+		Log::error("Unsupported checkpoint version %u", version);
+		return false;
+	}
+	int32_t width;
+	int32_t height;
+	int32_t tileSize;
+	int32_t sampler;
+	int32_t bounces;
+	uint32_t tiles;
+	uint32_t hash;
+	wrap(stream.readInt32(width))
+	wrap(stream.readInt32(height))
+	wrap(stream.readInt32(tileSize))
+	wrap(stream.readInt32(sampler))
+	wrap(stream.readInt32(bounces))
+	wrap(stream.readUInt32(tiles))
+	wrap(stream.readUInt32(hash))
+	if (width != state.width || height != state.height || tileSize != _options.tileSize ||
+		sampler != (int32_t)pt.params.sampler || bounces != pt.params.bounces || tiles != (uint32_t)_tiles.size()) {
+		Log::error("The checkpoint was written for different render settings");
+		return false;
+	}
+	if (hash != sceneHash(pt)) {
+		Log::error("The checkpoint was written for a different scene, camera or animation frame");
+		return false;
+	}
+	for (Tile &tile : _tiles) {
+		wrap(stream.readInt32(tile.samples))
+		uint8_t converged;
+		wrap(stream.readUInt8(converged))
+		tile.converged = converged != 0u;
+	}
+	const size_t pixels = (size_t)state.width * (size_t)state.height;
+	for (size_t i = 0; i < pixels; ++i) {
+		yocto::vec4f &color = state.image[i];
+		yocto::vec3f &albedo = state.albedo[i];
+		yocto::vec3f &normal = state.normal[i];
+		wrap(stream.readFloat(color.x))
+		wrap(stream.readFloat(color.y))
+		wrap(stream.readFloat(color.z))
+		wrap(stream.readFloat(color.w))
+		wrap(stream.readFloat(albedo.x))
+		wrap(stream.readFloat(albedo.y))
+		wrap(stream.readFloat(albedo.z))
+		wrap(stream.readFloat(normal.x))
+		wrap(stream.readFloat(normal.y))
+		wrap(stream.readFloat(normal.z))
+		wrap(stream.readInt32(state.hits[i]))
+		wrap(stream.readUInt64(state.rngs[i].state))
+		wrap(stream.readUInt64(state.rngs[i].inc))
+		wrap(stream.readFloat(_mean[i]))
+		wrap(stream.readFloat(_m2[i]))
+	}
+	wrap(stream.readUInt32(magic))
+	if (magic != CheckpointEndMagic) {
+		Log::error("The checkpoint is incomplete");
+		return false;
+	}
+	state.samples = minTileSamples();
+	return true;
+}
+
+#undef wrap
+#undef wrapSave
+
+} // namespace voxelpathtracer
@@ -0,0 +1,133 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+
+namespace io {
+class ReadStream;
+class WriteStream;
+} // namespace io
+
+namespace voxelpathtracer {
+
+class PathTracer;
+
+/**
+ * @brief Options for the headless rendering of @c BatchRenderer
+ */
+struct BatchRenderOptions {
+	/** the width and height of the tiles the image is split into - the tiles are distributed over all cores */
+	int tileSize = 32;
+	/** the samples per pixel that are traced for a tile before its convergence is checked again */
+	int samplesPerPass = 8;
+	/** the minimum samples per pixel before a tile may count as converged */
+	int minSamples = 16;
+	/**
+	 * a tile is converged once the mean relative standard error of the luminance of its pixels drops below this
+	 * value - @c 0 disables adaptive sampling
+	 */
+	float adaptiveThreshold = 0.01f;
+	/** stop rendering after this many seconds - @c 0 means no limit. The sample budget is @c yocto::trace_params::samples */
+	double timeBudget = 0.0;
+	/** the file the progress is saved to - allows to resume a killed render. Empty disables checkpoints */
+	core::String checkpointFile;
+	/** the seconds between two checkpoints */
+	double checkpointInterval = 60.0;
+};
+
+/**
+ * @brief Renders the scene of a @c PathTracer without a ui
+ *
+ * The image is split into tiles and the worker threads pick the next tile from a shared queue. Tiles whose pixels
+ * converged stop sampling early (adaptive sampling) - the others are traced until the sample budget is reached.
+ *
+ * @code
+ * PathTracer pathTracer;
+ * pathTracer.setup(sceneGraph);
+ * BatchRenderer renderer(pathTracer, options);
+ * renderer.render();
+ * image::ImagePtr image = pathTracer.image();
+ * @endcode
+ */
+class BatchRenderer {
+private:
+	struct Tile {
+		int x = 0;
+		int y = 0;
+		int w = 0;
+		int h = 0;
+		int samples = 0;
+		bool converged = false;
+	};
+
+	PathTracer &_pathTracer;
+	BatchRenderOptions _options;
+	core::DynamicArray<Tile> _tiles;
+	/** the running mean and the sum of squared differences of the luminance of each pixel (Welford) */
+	core::Buffer<float> _mean;
+	core::Buffer<float> _m2;
+	bool _finished = false;
+	double _seconds = 0.0;
+
+	/** reset the render state and split the image into tiles */
+	void reset();
+	void traceTile(Tile &tile);
+	bool saveCheckpointFile() const;
+	bool loadCheckpointFile();
+
+public:
+	BatchRenderer(PathTracer &pathTracer, const BatchRenderOptions &options);
+
+	/**
+	 * @brief Render the image of the scene that was created by @c PathTracer::setup() or @c PathTracer::syncScene()
+	 *
+	 * The render state is reset - or restored from the checkpoint file if one exists for the same image layout and
+	 * scene.
+	 * @return @c false on errors. Use @c finished() to check whether the time budget ran out before all samples were
+	 * traced.
+	 */
+	bool render();
+
+	/**
+	 * @return @c true if all tiles either converged or reached the sample budget
+	 */
+	bool finished() const {
+		return _finished;
+	}
+
+	/**
+	 * @return The seconds the last @c render() call took
+	 */
+	double seconds() const {
+		return _seconds;
+	}
+
+	int tiles() const {
+		return (int)_tiles.size();
+	}
+
+	int convergedTiles() const;
+	/**
+	 * @return The lowest amount of samples per pixel of all tiles
+	 */
+	int minTileSamples() const;
+	/**
+	 * @return The samples that were traced for all pixels
+	 */
+	uint64_t totalSamples() const;
+
+	bool saveCheckpoint(io::WriteStream &stream) const;
+	/**
+	 * @brief Reset the render state and restore the progress of the checkpoint
+	 * @note The checkpoint must have been written for the same resolution, tile size and sampler settings - and for
+	 * the same scene, camera and animation frame
+	 */
+	bool loadCheckpoint(io::ReadStream &stream);
+};
+
+} // namespace voxelpathtracer
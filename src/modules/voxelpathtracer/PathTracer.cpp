@@ -4,8 +4,11 @@
 
 #include "color/ColorUtil.h"
 #include "PathTracer.h"
+#include "app/ForParallel.h"
+#include "core/GLMConst.h"
 #include "core/Log.h"
 #include "core/StringUtil.h"
+#include "core/TimeProvider.h"
 #include "core/Var.h"
 #include "image/Image.h"
 #include "io/Stream.h"
@@ -13,14 +16,16 @@
 #include "palette/PaletteView.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "scenegraph/SceneGraphNodeCamera.h"
 #include "scenegraph/SceneGraphNodeProperties.h"
-#include "video/Camera.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/Mesh.h"
 #include "voxel/RawVolume.h"
 #include "voxel/SurfaceExtractor.h"
-#include "voxelrender/RenderUtil.h"
 #include "PathTracerState.h"
+#include "VoxelTracer.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #define PATHTRACER_TEXTURES 0
 
@@ -32,6 +37,10 @@ static inline yocto::vec3f toVec3f(const glm::vec3 &in) {
 	return yocto::vec3f{in.x, in.y, in.z};
 }
 
+static inline yocto::frame3f toFrame(const glm::mat4 &in) {
+	return yocto::frame3f{toVec3f(in[0]), toVec3f(in[1]), toVec3f(in[2]), toVec3f(in[3])};
+}
+
 static inline yocto::vec4f toColor(const glm::vec4 &in, float ambientOcclusion_unused) {
 	return yocto::vec4f{in.r, in.g, in.b, in.a};
 }
@@ -88,40 +97,29 @@ PathTracer::~PathTracer() {
 	delete _state;
 }
 
-bool PathTracer::addNode(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-						 const voxel::Mesh &mesh, bool opaque) {
+void PathTracer::addMesh(const voxel::Mesh &mesh, const palette::Palette &palette, yocto::shape_data *shapes) {
 	const voxel::IndexArray &indices = mesh.getIndexVector();
 	if (indices.empty()) {
-		return true;
+		return;
 	}
 	core_assert((int)indices.size() % 3 == 0);
 	const int tris = (int)indices.size() / 3;
-	yocto::shape_data shapes[palette::PaletteMaxColors];
 	const voxel::VertexArray &vertices = mesh.getVertexVector();
 	const voxel::NormalArray &normals = mesh.getNormalVector();
 	const bool useNormals = normals.size() == vertices.size();
 
-	const palette::Palette &palette = sceneGraph.resolvePalette(node);
-	scenegraph::KeyFrameIndex keyFrameIdx = 0;
-	const scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
-	const voxel::Region &region = sceneGraph.resolveRegion(node);
-	const glm::vec3 size(region.getDimensionsInVoxels());
-	const glm::vec3 &pivot = node.pivot();
-	const glm::vec3 objPivot = pivot * size;
+	// the vertices stay in the local space of the volume - the node transform is the frame of the instances
 	for (int i = 0; i < tris; i++) {
 		const voxel::VoxelVertex &vertex0 = vertices[indices[i * 3 + 0]];
 		const voxel::VoxelVertex &vertex1 = vertices[indices[i * 3 + 1]];
 		const voxel::VoxelVertex &vertex2 = vertices[indices[i * 3 + 2]];
 
-		const glm::vec3 pos0 = transform.apply(vertex0.position, objPivot);
-		const glm::vec3 pos1 = transform.apply(vertex1.position, objPivot);
-		const glm::vec3 pos2 = transform.apply(vertex2.position, objPivot);
 		// uv is the same for all three vertices
 		yocto::shape_data *shape = &shapes[vertex0.colorIndex];
 
-		shape->positions.push_back(priv::toVec3f(pos0));
-		shape->positions.push_back(priv::toVec3f(pos1));
-		shape->positions.push_back(priv::toVec3f(pos2));
+		shape->positions.push_back(priv::toVec3f(vertex0.position));
+		shape->positions.push_back(priv::toVec3f(vertex1.position));
+		shape->positions.push_back(priv::toVec3f(vertex2.position));
 		const color::RGBA rgba = palette.color(vertex0.colorIndex);
 		const glm::vec4 &color = color::fromRGBA(rgba);
 		shape->colors.push_back(priv::toColor(color, vertex0.ambientOcclusion));
@@ -143,61 +141,46 @@ bool PathTracer::addNode(const scenegraph::SceneGraph &sceneGraph, const scenegr
 		const yocto::vec3i vidx{offsetStart + 0, offsetStart + 1, offsetStart + 2};
 		shape->triangles.push_back(vidx);
 	}
-	// const glm::vec3 &mins = mesh.getOffset();
-	_state->scene.shapes.reserve(palette.colorCount());
-	for (int i = 0; i < palette.colorCount(); ++i) {
-		yocto::shape_data &shape = shapes[i];
-		if (shape.triangles.empty()) {
-			continue;
-		}
-		_state->scene.shapes.push_back(shape);
-
-		yocto::instance_data instance_data;
-		// instance_data.frame = yocto::translation_frame(priv::toVec3f(mins));
-		instance_data.material = _state->scene.materials.size() + i;
-		instance_data.shape = (int)_state->scene.shapes.size() - 1;
-		_state->scene.instances.push_back(instance_data);
-	}
-
-	return true;
 }
 
 void PathTracer::addCamera(const scenegraph::SceneGraphNodeCamera &node) {
-	addCamera(node.name().c_str(), voxelrender::toCamera({}, node));
+	const scenegraph::SceneGraphTransform &transform = node.transform(0);
+	const glm::quat orientation = glm::conjugate(transform.worldOrientation());
+	PathTracerCamera cam;
+	cam.eye = transform.worldTranslation();
+	cam.target = cam.eye + orientation * glm::forward();
+	cam.up = orientation * glm::up();
+	cam.orthographic = node.isOrthographic();
+	if (node.fieldOfView() > 0) {
+		cam.fieldOfView = (float)node.fieldOfView();
+	}
+	cam.focus = node.farPlane();
+	addCamera(node.name().c_str(), cam);
 }
 
-void PathTracer::addCamera(const char *name, const video::Camera &cam) {
+void PathTracer::addCamera(const char *name, const PathTracerCamera &cam) {
 	yocto::scene_data &scene = _state->scene;
 	scene.camera_names.emplace_back(name);
 	yocto::camera_data &camera = scene.cameras.emplace_back();
 
-	const yocto::vec3f &from = priv::toVec3f(cam.eye());
-	const yocto::vec3f &to = priv::toVec3f(cam.target());
-	const yocto::vec3f &up = priv::toVec3f(cam.up());
+	const yocto::vec3f &from = priv::toVec3f(cam.eye);
+	const yocto::vec3f &to = priv::toVec3f(cam.target);
+	const yocto::vec3f &up = priv::toVec3f(cam.up);
 	camera.frame = yocto::lookat_frame(from, to, up);
-	camera.aspect = (float)cam.size().x / (float)cam.size().y;
+	camera.aspect = (float)cam.size.x / (float)cam.size.y;
 	camera.aperture = _state->aperture;
+	camera.focus = cam.focus;
 
-	camera.orthographic = cam.isOrthographic();
+	camera.orthographic = cam.orthographic;
 	if (camera.orthographic) {
-		camera.film = cam.size().x;
-		if (cam.rotationType() == video::CameraRotationType::Target) {
-			camera.focus = cam.targetDistance();
-		} else {
-			camera.focus = cam.farPlane();
-		}
+		camera.film = cam.size.x;
 		camera.lens = camera.film / camera.focus;
 	} else {
 		camera.film = 0.036f;
-		float distance = camera.film / (2.0f * glm::tan(cam.fieldOfView() / 2.0f));
+		float distance = camera.film / (2.0f * glm::tan(cam.fieldOfView / 2.0f));
 		if (camera.aspect > 1.0f) {
 			distance /= camera.aspect;
 		}
-		if (cam.rotationType() == video::CameraRotationType::Target) {
-			camera.focus = cam.targetDistance();
-		} else {
-			camera.focus = cam.farPlane();
-		}
 		camera.lens = camera.focus * distance / (camera.focus + distance);
 	}
 }
@@ -221,7 +204,7 @@ static yocto::material_type mapMaterialType(palette::MaterialType type) {
 	return yocto::material_type::matte;
 }
 
-static void setupMaterial(yocto::scene_data &scene, const palette::Palette &palette, int i) {
+static void setupMaterial(std::vector<yocto::material_data> &materials, const palette::Palette &palette, int i) {
 	const palette::Material &ownMaterial = palette.material(i);
 
 	yocto::material_data material;
@@ -254,7 +237,7 @@ static void setupMaterial(yocto::scene_data &scene, const palette::Palette &pale
 #if PATHTRACER_TEXTURES
 	#error "TODO: add texture support"
 #endif
-	scene.materials.push_back(material);
+	materials.push_back(material);
 }
 
 #if PATHTRACER_TEXTURES
@@ -289,12 +272,22 @@ static int addPaletteTexture(yocto::scene_data &scene, const palette::Palette &p
 }
 #endif
 
-bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
-	_state->scene = {};
-	_state->lights = {};
+static glm::mat4 nodeTransform(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
+							   const voxel::Region &region, scenegraph::FrameIndex frameIdx) {
+	// the same as SceneGraphTransform::apply() for the vertices
+	const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+	return transform.calculateWorldMatrix(node.pivot(), glm::vec3(region.getDimensionsInVoxels()));
+}
 
-	voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::getVar(cfg::VoxformatMeshMode)->intVal();
-	voxel::ChunkMesh mesh(65536, 65536, true);
+static double millisSince(uint64_t start) {
+	const uint64_t delta = core::TimeProvider::highResTime() - start;
+	return (double)delta * 1000.0 / (double)core::TimeProvider::highResTimeResolution();
+}
+
+bool PathTracer::updateNodes(const scenegraph::SceneGraph &sceneGraph, bool force) {
+	core_trace_scoped(PathTracerUpdateNodes);
+	PathTracerState &state = *_state;
+	core::DynamicArray<const scenegraph::SceneGraphNode *> traced;
 	for (const auto &e : sceneGraph.nodes()) {
 		const scenegraph::SceneGraphNode &node = e->value;
 		if (!node.isAnyModelNode()) {
@@ -303,24 +296,148 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 		if (!node.visible()) {
 			continue;
 		}
-		const voxel::RawVolume *v = sceneGraph.resolveVolume(node);
-		if (v == nullptr) {
+		if (sceneGraph.resolveVolume(node) == nullptr) {
 			continue;
 		}
+		traced.push_back(&node);
+	}
 
-		const voxel::Region &region = v->region();
+	// find out what was changed - nodes that were added, removed or modified change the layout of the scene, moved
+	// nodes only update their transform
+	bool relayout = force || traced.size() != state.nodes.size();
+	core::DynamicArray<const scenegraph::SceneGraphNode *> moved;
+	for (const scenegraph::SceneGraphNode *node : traced) {
+		auto iter = state.nodes.find(node->uuid());
+		if (iter == state.nodes.end()) {
+			relayout = true;
+			continue;
+		}
+		PathTracerNode &entry = iter->value;
+		const voxel::RawVolume *volume = sceneGraph.resolveVolume(*node);
+		if (entry.volume != volume || entry.region != volume->region() ||
+			entry.paletteHash != sceneGraph.resolvePalette(*node).hash()) {
+			entry.dirty = true;
+		}
+		if (entry.dirty) {
+			relayout = true;
+		} else if (entry.transform != nodeTransform(sceneGraph, *node, entry.region, state.frame)) {
+			moved.push_back(node);
+		}
+	}
+	if (!relayout && moved.empty()) {
+		return false;
+	}
 
-		const palette::Palette &palette = sceneGraph.resolvePalette(node);
-		voxel::SurfaceExtractionContext ctx =
-			voxel::createContext(type, v, region, palette, mesh, region.getLowerCorner(), true, true, false, true);
+	// the scene is modified - the worker must not access it anymore
+	yocto::trace_cancel(state.context);
+
+	PathTracerTimings &timings = state.timings;
+	timings = {};
+	yocto::scene_data &scene = state.scene;
+	const bool embree = state.params.embreebvh && yocto::embree_supported();
+
+	if (!relayout) {
+		for (const scenegraph::SceneGraphNode *node : moved) {
+			PathTracerNode &entry = state.nodes.find(node->uuid())->value;
+			entry.transform = nodeTransform(sceneGraph, *node, entry.region, state.frame);
+			if (state.voxelTraversal) {
+				state.voxelScene.setTransform(entry.voxelInstance, entry.transform);
+			} else {
+				const yocto::frame3f frame = priv::toFrame(entry.transform);
+				for (size_t i = 0; i < entry.colors.size(); ++i) {
+					scene.instances[entry.firstShape + i].frame = frame;
+				}
+			}
+		}
+		timings.movedNodes = (int)moved.size();
+		const uint64_t bvhStart = core::TimeProvider::highResTime();
+		if (state.voxelTraversal) {
+			state.voxelScene.refit();
+		} else if (embree) {
+			state.bvh = yocto::make_trace_bvh(scene, state.params);
+		} else {
+			yocto::update_scene_bvh(state.bvh.bvh, scene, {}, {});
+		}
+		timings.bvh = millisSince(bvhStart);
+		return true;
+	}
 
-		voxel::extractSurface(ctx);
+	const uint64_t meshStart = core::TimeProvider::highResTime();
+	std::vector<yocto::shape_data> shapes;
+	std::vector<yocto::shape_bvh> shapeBvhs;
+	std::vector<yocto::instance_data> instances;
+	std::vector<yocto::material_data> materials;
+	// the shapes that need a new bvh
+	core::DynamicArray<int> meshed;
+	core::DynamicMap<core::UUID, PathTracerNode, 251, core::UUIDHash> nodes;
+	if (state.voxelTraversal) {
+		state.voxelScene.clearInstances();
+	}
 
-		if (!addNode(sceneGraph, node, mesh.mesh[0], true)) {
-			return false;
+	voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)core::getVar(cfg::VoxformatMeshMode)->intVal();
+	voxel::ChunkMesh mesh(65536, 65536, true);
+	for (const scenegraph::SceneGraphNode *node : traced) {
+		const voxel::RawVolume *volume = sceneGraph.resolveVolume(*node);
+		const voxel::Region &region = volume->region();
+		const palette::Palette &palette = sceneGraph.resolvePalette(*node);
+		auto iter = state.nodes.find(node->uuid());
+		const bool cached = iter != state.nodes.end() && !iter->value.dirty;
+
+		PathTracerNode entry;
+		entry.volume = volume;
+		entry.region = region;
+		entry.paletteHash = palette.hash();
+		entry.transform = nodeTransform(sceneGraph, *node, region, state.frame);
+		const int materialOffset = (int)materials.size();
+		if (!cached) {
+			++timings.rebuiltNodes;
 		}
-		if (!addNode(sceneGraph, node, mesh.mesh[1], false)) {
-			return false;
+		if (state.voxelTraversal) {
+			if (!cached) {
+				state.voxelScene.invalidate(volume);
+			}
+			entry.voxelInstance = state.voxelScene.addInstance(volume, entry.transform, materialOffset);
+		} else {
+			entry.firstShape = (int)shapes.size();
+			if (cached) {
+				// the shapes and their bvh are moved over from the previous scene
+				const PathTracerNode &previous = iter->value;
+				entry.colors = previous.colors;
+				for (size_t i = 0; i < entry.colors.size(); ++i) {
+					const int shapeIdx = previous.firstShape + (int)i;
+					if (embree) {
+						shapeBvhs.emplace_back();
+					} else {
+						shapeBvhs.push_back(core::move(state.bvh.bvh.shapes[shapeIdx]));
+					}
+					shapes.push_back(core::move(scene.shapes[shapeIdx]));
+				}
+			} else {
+				voxel::SurfaceExtractionContext ctx = voxel::createContext(type, volume, region, palette, mesh,
+																		   region.getLowerCorner(), true, true, false, true);
+				voxel::extractSurface(ctx);
+
+				yocto::shape_data colorShapes[palette::PaletteMaxColors];
+				addMesh(mesh.mesh[0], palette, colorShapes);
+				addMesh(mesh.mesh[1], palette, colorShapes);
+				for (int i = 0; i < palette.colorCount(); ++i) {
+					if (colorShapes[i].triangles.empty()) {
+						continue;
+					}
+					entry.colors.push_back((uint8_t)i);
+					meshed.push_back((int)shapes.size());
+					shapes.push_back(core::move(colorShapes[i]));
+					shapeBvhs.emplace_back();
+				}
+			}
+			const yocto::frame3f frame = priv::toFrame(entry.transform);
+			for (size_t i = 0; i < entry.colors.size(); ++i) {
+				yocto::instance_data instance;
+				instance.frame = frame;
+				instance.shape = entry.firstShape + (int)i;
+				instance.material = materialOffset + entry.colors[i];
+				instances.push_back(instance);
+			}
 		}
 
 #if PATHTRACER_TEXTURES
@@ -328,9 +445,130 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 		const int emissiveTextureIdx = addEmissiveTexture(_state->scene, palette);
 #endif
 		for (int i = 0; i < palette.colorCount(); ++i) {
-			setupMaterial(_state->scene, palette, i);
+			setupMaterial(materials, palette, i);
+		}
+		nodes.emplace(node->uuid(), core::move(entry));
+	}
+	scene.shapes = core::move(shapes);
+	scene.instances = core::move(instances);
+	scene.materials = core::move(materials);
+	state.nodes = core::move(nodes);
+	if (state.voxelTraversal) {
+		// the brick maps are the counterpart of the meshes
+		state.voxelScene.build();
+	}
+	timings.mesh = millisSince(meshStart);
+
+	const uint64_t bvhStart = core::TimeProvider::highResTime();
+	if (embree) {
+		state.bvh = yocto::make_trace_bvh(scene, state.params);
+	} else if (!state.voxelTraversal) {
+		state.bvh.bvh.shapes = core::move(shapeBvhs);
+		const bool highquality = state.params.highqualitybvh;
+		app::for_parallel(0, (int)meshed.size(), [&state, &scene, &meshed, highquality](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				const int shapeIdx = meshed[i];
+				state.bvh.bvh.shapes[shapeIdx] = yocto::make_shape_bvh(scene.shapes[shapeIdx], highquality);
+			}
+		});
+		yocto::rebuild_scene_bvh(state.bvh.bvh, scene, highquality);
+	}
+	timings.bvh = millisSince(bvhStart);
+	return true;
+}
+
+void PathTracer::updateLights(bool environment) {
+	const uint64_t lightsStart = core::TimeProvider::highResTime();
+	PathTracerState &state = *_state;
+	const yocto::scene_data &scene = state.scene;
+	if (environment) {
+		state.lights = yocto::make_trace_lights(scene, state.params);
+	}
+	// keep the environment lights - their distribution is expensive to compute and doesn't change with the nodes. The
+	// voxel traversal doesn't have any instances and only samples these.
+	std::vector<yocto::trace_light> lights;
+	for (yocto::trace_light &light : state.lights.lights) {
+		if (light.environment != yocto::invalidid) {
+			lights.push_back(core::move(light));
+		}
+	}
+	for (size_t i = 0; i < scene.instances.size(); ++i) {
+		const yocto::instance_data &instance = scene.instances[i];
+		const yocto::material_data &material = scene.materials[instance.material];
+		const yocto::shape_data &shape = scene.shapes[instance.shape];
+		if (material.emission == yocto::vec3f{0, 0, 0} || shape.triangles.empty()) {
+			continue;
+		}
+		yocto::trace_light &light = lights.emplace_back();
+		light.instance = (int)i;
+		// the shapes are in the local space of the nodes - but the light sampling needs the area in world space
+		light.elements_cdf.resize(shape.triangles.size());
+		for (size_t idx = 0; idx < shape.triangles.size(); ++idx) {
+			const yocto::vec3i &t = shape.triangles[idx];
+			light.elements_cdf[idx] =
+				yocto::triangle_area(yocto::transform_point(instance.frame, shape.positions[t.x]),
+									 yocto::transform_point(instance.frame, shape.positions[t.y]),
+									 yocto::transform_point(instance.frame, shape.positions[t.z]));
+			if (idx != 0) {
+				light.elements_cdf[idx] += light.elements_cdf[idx - 1];
+			}
 		}
 	}
+	state.lights.lights = core::move(lights);
+	state.timings.lights = millisSince(lightsStart);
+}
+
+void PathTracer::resetState() {
+	const uint64_t stateStart = core::TimeProvider::highResTime();
+	_state->state = yocto::make_trace_state(_state->scene, _state->params);
+	_state->timings.state = millisSince(stateStart);
+}
+
+void PathTracer::nodeModified(const core::UUID &nodeUUID) {
+	auto iter = _state->nodes.find(nodeUUID);
+	if (iter == _state->nodes.end()) {
+		return;
+	}
+	// reference nodes share the volume
+	const voxel::RawVolume *volume = iter->value.volume;
+	for (const auto &e : _state->nodes) {
+		if (e->value.volume == volume) {
+			e->value.dirty = true;
+		}
+	}
+}
+
+bool PathTracer::syncScene(const scenegraph::SceneGraph &sceneGraph) {
+	if (!updateNodes(sceneGraph, false)) {
+		// nothing that is traced was changed - keep the accumulated samples
+		return false;
+	}
+	Log::debug("Updated pathtracer scene: %i nodes rebuilt, %i nodes moved", _state->timings.rebuiltNodes,
+			   _state->timings.movedNodes);
+	updateLights(false);
+	resetState();
+	return true;
+}
+
+bool PathTracer::updateScene(const scenegraph::SceneGraph &sceneGraph) {
+	if (!_state->started) {
+		return false;
+	}
+	if (!syncScene(sceneGraph)) {
+		return false;
+	}
+	traceStart();
+	return true;
+}
+
+bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera) {
+	_state->scene = {};
+	_state->bvh = {};
+	_state->lights = {};
+	_state->nodes.clear();
+	_state->voxelScene.clear();
+
+	updateNodes(sceneGraph, true);
 
 	if (camera) {
 		addCamera("default", *camera);
@@ -343,6 +581,18 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 
 	if (_state->scene.cameras.size() <= 1) {
 		yocto::add_camera(_state->scene);
+		glm::vec3 mins;
+		glm::vec3 maxs;
+		if (_state->voxelTraversal && _state->voxelScene.bounds(mins, maxs)) {
+			// there are no shapes the camera could get placed by - use the same framing for the voxel bounds
+			yocto::camera_data &cam = _state->scene.cameras.back();
+			const yocto::vec3f center = priv::toVec3f((mins + maxs) * 0.5f);
+			const float radius = glm::length(maxs - mins) / 2.0f;
+			const float distance = 2.0f * radius * cam.lens / (cam.film / cam.aspect);
+			const yocto::vec3f from = yocto::vec3f{0, 0, 1} * distance + center;
+			cam.frame = yocto::lookat_frame(from, center, yocto::vec3f{0, 1, 0});
+			cam.focus = yocto::length(from - center);
+		}
 	}
 
 	const scenegraph::SceneGraphNode &root = sceneGraph.root();
@@ -368,19 +618,38 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 	return true;
 }
 
-bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
+bool PathTracer::setup(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera) {
 	Log::debug("Create scene");
-	createScene(sceneGraph, camera);
-	_state->bvh = yocto::make_trace_bvh(_state->scene, _state->params);
-	_state->lights = yocto::make_trace_lights(_state->scene, _state->params);
-	_state->state = yocto::make_trace_state(_state->scene, _state->params);
-	yocto::trace_start(_state->context, _state->state, _state->scene, _state->bvh, _state->lights, _state->params);
+	yocto::trace_cancel(_state->context);
+	_state->started = false;
+	if (!createScene(sceneGraph, camera)) {
+		return false;
+	}
+	updateLights(true);
+	resetState();
+	return true;
+}
+
+bool PathTracer::start(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera) {
+	if (!setup(sceneGraph, camera)) {
+		return false;
+	}
+	traceStart();
 	_state->started = true;
 	Log::debug("Started pathtracer");
 	return true;
 }
 
-bool PathTracer::restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera) {
+void PathTracer::traceStart() {
+	if (_state->voxelTraversal) {
+		traceVoxelStart(_state->context, _state->state, _state->scene, _state->voxelScene, _state->lights,
+						_state->params);
+	} else {
+		yocto::trace_start(_state->context, _state->state, _state->scene, _state->bvh, _state->lights, _state->params);
+	}
+}
+
+bool PathTracer::restart(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera) {
 	if (!started()) {
 		return false;
 	}
@@ -415,7 +684,7 @@ bool PathTracer::update(int *currentSample) {
 			*currentSample = _state->state.samples;
 		}
 		Log::debug("PathTracer sample: %i", _state->state.samples);
-		yocto::trace_start(_state->context, _state->state, _state->scene, _state->bvh, _state->lights, _state->params);
+		traceStart();
 	}
 	return false;
 }
@@ -5,9 +5,11 @@
 #pragma once
 
 #include "core/SharedPtr.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 
-namespace video {
-class Camera;
+namespace core {
+class UUID;
 }
 
 namespace image {
@@ -29,20 +31,52 @@ class SceneGraphNode;
 class SceneGraphNodeCamera;
 } // namespace scenegraph
 
+namespace yocto {
+struct shape_data;
+}
+
 namespace voxelpathtracer {
 
 struct PathTracerState;
 
+/**
+ * @brief The view that is traced
+ *
+ * The path tracer doesn't depend on the renderer - the callers convert their camera into this.
+ */
+struct PathTracerCamera {
+	glm::vec3 eye{0.0f};
+	glm::vec3 target{0.0f, 0.0f, -1.0f};
+	glm::vec3 up{0.0f, 1.0f, 0.0f};
+	/** only the aspect ratio is used - the resolution of the image is @c yocto::trace_params::resolution */
+	glm::ivec2 size{1, 1};
+	bool orthographic = false;
+	float fieldOfView = 45.0f;
+	/** the distance to the plane that is in focus */
+	float focus = 1.0f;
+};
+
 class PathTracer {
 private:
 	PathTracerState *_state;
 
 	void addCamera(const scenegraph::SceneGraphNodeCamera &node);
-	void addCamera(const char *name, const video::Camera &cam);
+	void addCamera(const char *name, const PathTracerCamera &cam);
 
-	bool addNode(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-				 const voxel::Mesh &mesh, bool opaque);
-	bool createScene(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera);
+	void addMesh(const voxel::Mesh &mesh, const palette::Palette &palette, yocto::shape_data *shapes);
+	/**
+	 * @brief Sync the traced model nodes with the scene graph
+	 * @param[in] force Rebuild the layout of the scene even if no node was changed
+	 * @return @c false if nothing that is traced was changed
+	 */
+	bool updateNodes(const scenegraph::SceneGraph &sceneGraph, bool force);
+	/**
+	 * @param[in] environment Also compute the distribution of the environment lights
+	 */
+	void updateLights(bool environment);
+	void resetState();
+	bool createScene(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera);
+	void traceStart();
 
 public:
 	PathTracer();
@@ -50,11 +84,36 @@ public:
 	PathTracerState &state() {
 		return *_state;
 	}
-	bool start(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr);
-	bool restart(const scenegraph::SceneGraph &sceneGraph, const video::Camera *camera = nullptr);
+	/**
+	 * @brief Create the scene and the render state without starting to trace - see @c syncScene() and
+	 * @c PathTracerState::frame
+	 */
+	bool setup(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera = nullptr);
+	bool start(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera = nullptr);
+	bool restart(const scenegraph::SceneGraph &sceneGraph, const PathTracerCamera *camera = nullptr);
 	bool stop();
 	bool started() const;
 
+	/**
+	 * @brief Mark the voxels of the node as modified - the node is meshed again with the next @c updateScene()
+	 */
+	void nodeModified(const core::UUID &nodeUUID);
+	/**
+	 * @brief Apply the changes of the scene graph to the running path tracer without restarting it
+	 *
+	 * Only nodes that were added, modified (see @c nodeModified()) or got a new volume, region or palette are meshed
+	 * again and get a new bvh. Nodes that were moved only update the transform of their instances and the instance
+	 * bvh is refitted. The accumulated samples are kept if nothing that is traced was changed. The timings of the
+	 * stages are available in @c PathTracerState::timings
+	 * @return @c true if the scene was changed and the sampling was restarted
+	 */
+	bool updateScene(const scenegraph::SceneGraph &sceneGraph);
+	/**
+	 * @brief Like @c updateScene() but for a scene that was created with @c setup() - nothing is traced
+	 * @return @c true if the scene was changed and the render state was reset
+	 */
+	bool syncScene(const scenegraph::SceneGraph &sceneGraph);
+
 	/**
 	 * @brief Update the path tracer. This will render a batch of samples and must get called until either stop() was
 	 * called or @c false is returned.
@@ -4,11 +4,58 @@
 
 #pragma once
 
+#include "VoxelScene.h"
+#include "core/UUID.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include "scenegraph/SceneGraphAnimation.h"
+#include "voxel/Region.h"
+#include <glm/mat4x4.hpp>
 #include <yocto_scene.h>
 #include <yocto_trace.h>
 
+namespace voxel {
+class RawVolume;
+}
+
 namespace voxelpathtracer {
 
+/**
+ * @brief The state of a traced model node from the last scene update - used to only rebuild the nodes that were changed
+ */
+struct PathTracerNode {
+	const voxel::RawVolume *volume = nullptr;
+	voxel::Region region;
+	uint64_t paletteHash = 0u;
+	glm::mat4 transform{1.0f};
+	/** the voxels were modified - the node is meshed again or the brick map is rebuilt */
+	bool dirty = false;
+	/**
+	 * the index of the first shape and instance in the yocto scene - there is one shape for each palette color that
+	 * is used by the node
+	 */
+	int firstShape = 0;
+	/** the palette color index of each shape */
+	core::DynamicArray<uint8_t> colors;
+	/** the instance index in the @c VoxelScene */
+	int voxelInstance = -1;
+};
+
+/**
+ * @brief Timings of the stages of the last scene (re-)build in milliseconds
+ */
+struct PathTracerTimings {
+	/** meshing the nodes or building the brick maps */
+	double mesh = 0.0;
+	double bvh = 0.0;
+	double lights = 0.0;
+	double state = 0.0;
+	/** the amount of nodes that were meshed again in the last update */
+	int rebuiltNodes = 0;
+	/** the amount of nodes whose transform was updated in the last update */
+	int movedNodes = 0;
+};
+
 struct PathTracerState {
 	yocto::trace_context context;
 	yocto::scene_data scene;
@@ -16,6 +63,16 @@ struct PathTracerState {
 	yocto::trace_params params;
 	yocto::trace_lights lights;
 	yocto::trace_state state;
+	/**
+	 * @brief Trace the voxels with a 3D-DDA over sparse bricks instead of building triangle meshes for the yocto bvh
+	 */
+	bool voxelTraversal = false;
+	VoxelScene voxelScene;
+	/** the traced model nodes by their uuid */
+	core::DynamicMap<core::UUID, PathTracerNode, 251, core::UUIDHash> nodes;
+	PathTracerTimings timings;
+	/** the animation frame the transforms of the nodes are taken from */
+	scenegraph::FrameIndex frame = 0;
 	bool started = false;
 	float aperture = 0.0f;
 	float sunIntensity = 1.0f;
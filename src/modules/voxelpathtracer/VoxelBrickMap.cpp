@@ -0,0 +1,261 @@
+/**
+ * @file
+ */
+
+#include "VoxelBrickMap.h"
+#include "app/ForParallel.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+#include <float.h>
+#include <glm/common.hpp>
+
+namespace voxelpathtracer {
+
+namespace {
+
+/**
+ * @brief Clip the ray parameter interval against the given box
+ * @param[out] axis The axis of the box face the ray enters through or @c -1 if the ray starts inside the box
+ */
+bool clipRay(const glm::vec3 &origin, const glm::vec3 &invDirection, const glm::vec3 &mins, const glm::vec3 &maxs,
+			 float &tmin, float &tmax, int &axis) {
+	axis = -1;
+	for (int i = 0; i < 3; ++i) {
+		float t0 = (mins[i] - origin[i]) * invDirection[i];
+		float t1 = (maxs[i] - origin[i]) * invDirection[i];
+		if (t0 > t1) {
+			core::exchange(t0, t1);
+		}
+		if (t0 > tmin) {
+			tmin = t0;
+			axis = i;
+		}
+		if (t1 < tmax) {
+			tmax = t1;
+		}
+		if (tmin > tmax) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief 3D-DDA over the cells of a grid with a cell size of 1 - origin and direction are given in grid coordinates
+ *
+ * @param[in] func Callable(cell, tEnter, tExit, axis) -> bool - returning @c true stops the traversal. The axis is
+ * the one the ray crossed to enter the cell.
+ * @return @c true if the traversal was stopped by the callable
+ */
+template<class Func>
+bool traverseGrid(const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax, const glm::ivec3 &dims,
+				  int axis, Func &&func) {
+	const glm::vec3 start = origin + direction * tmin;
+	glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(start)), glm::ivec3(0), dims - 1);
+	glm::ivec3 step;
+	glm::vec3 tDelta;
+	glm::vec3 tNext;
+	for (int i = 0; i < 3; ++i) {
+		if (direction[i] > 0.0f) {
+			step[i] = 1;
+			tDelta[i] = 1.0f / direction[i];
+			tNext[i] = tmin + ((float)(cell[i] + 1) - start[i]) * tDelta[i];
+		} else if (direction[i] < 0.0f) {
+			step[i] = -1;
+			tDelta[i] = -1.0f / direction[i];
+			tNext[i] = tmin + (start[i] - (float)cell[i]) * tDelta[i];
+		} else {
+			step[i] = 0;
+			tDelta[i] = FLT_MAX;
+			tNext[i] = FLT_MAX;
+		}
+	}
+	float t = tmin;
+	for (;;) {
+		const int next = tNext.x < tNext.y ? (tNext.x < tNext.z ? 0 : 2) : (tNext.y < tNext.z ? 1 : 2);
+		if (func(cell, t, core_min(tNext[next], tmax), axis)) {
+			return true;
+		}
+		if (tNext[next] >= tmax) {
+			return false;
+		}
+		cell[next] += step[next];
+		if (cell[next] < 0 || cell[next] >= dims[next]) {
+			return false;
+		}
+		t = tNext[next];
+		tNext[next] += tDelta[next];
+		axis = next;
+	}
+}
+
+glm::vec3 faceNormal(const glm::vec3 &direction, int axis) {
+	if (axis == -1) {
+		// the ray started inside the voxel - use the dominant axis of the direction
+		const glm::vec3 a = glm::abs(direction);
+		axis = a.x > a.y ? (a.x > a.z ? 0 : 2) : (a.y > a.z ? 1 : 2);
+	}
+	glm::vec3 normal(0.0f);
+	normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+	return normal;
+}
+
+} // namespace
+
+void VoxelBrickMap::clear() {
+	_region = voxel::Region::InvalidRegion;
+	_brickDims = glm::ivec3(0);
+	_directory.clear();
+	_bricks.clear();
+}
+
+void VoxelBrickMap::build(const voxel::RawVolume &volume) {
+	core_trace_scoped(VoxelBrickMapBuild);
+	clear();
+	_region = volume.region();
+	if (!_region.isValid()) {
+		return;
+	}
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	const glm::ivec3 &maxs = _region.getUpperCorner();
+	_brickDims = (_region.getDimensionsInVoxels() + BrickSize - 1) / BrickSize;
+	_directory.resize((size_t)_brickDims.x * _brickDims.y * _brickDims.z);
+
+	// the brick layers along the z axis are built in parallel - the directory entries are local to the layer first
+	core::DynamicArray<core::DynamicArray<Brick>> layers;
+	layers.resize(_brickDims.z);
+	auto fn = [&](int start, int end) {
+		voxel::RawVolume::Sampler sampler(volume);
+		Brick b;
+		for (int bz = start; bz < end; ++bz) {
+			core::DynamicArray<Brick> &layer = layers[bz];
+			for (int by = 0; by < _brickDims.y; ++by) {
+				for (int bx = 0; bx < _brickDims.x; ++bx) {
+					const glm::ivec3 base = mins + glm::ivec3(bx, by, bz) * BrickSize;
+					core_memset(&b, 0, sizeof(b));
+					bool solid = false;
+					for (int lz = 0; lz < BrickSize && base.z + lz <= maxs.z; ++lz) {
+						for (int ly = 0; ly < BrickSize && base.y + ly <= maxs.y; ++ly) {
+							sampler.setPosition(base.x, base.y + ly, base.z + lz);
+							for (int lx = 0; lx < BrickSize && base.x + lx <= maxs.x; ++lx) {
+								const voxel::Voxel &voxel = sampler.voxel();
+								if (!voxel::isAir(voxel.getMaterial())) {
+									const int bit = lx + ly * BrickSize;
+									b.occupancy[lz] |= (uint64_t)1 << bit;
+									b.colors[bit + lz * BrickSize * BrickSize] = voxel.getColor();
+									solid = true;
+								}
+								sampler.movePositiveX();
+							}
+						}
+					}
+					const int idx = brickIndex(bx, by, bz);
+					if (!solid) {
+						_directory[idx] = -1;
+						continue;
+					}
+					_directory[idx] = (int32_t)layer.size();
+					layer.push_back(b);
+				}
+			}
+		}
+	};
+	app::for_parallel(0, _brickDims.z, fn);
+
+	size_t total = 0u;
+	for (const core::DynamicArray<Brick> &layer : layers) {
+		total += layer.size();
+	}
+	_bricks.reserve(total);
+	const int layerSize = _brickDims.x * _brickDims.y;
+	for (int bz = 0; bz < _brickDims.z; ++bz) {
+		const int32_t offset = (int32_t)_bricks.size();
+		for (int i = bz * layerSize; i < (bz + 1) * layerSize; ++i) {
+			if (_directory[i] != -1) {
+				_directory[i] += offset;
+			}
+		}
+		for (const Brick &b : layers[bz]) {
+			_bricks.push_back(b);
+		}
+	}
+}
+
+const VoxelBrickMap::Brick *VoxelBrickMap::brick(const glm::ivec3 &brickPos) const {
+	const int32_t idx = _directory[brickIndex(brickPos.x, brickPos.y, brickPos.z)];
+	if (idx < 0) {
+		return nullptr;
+	}
+	return &_bricks[idx];
+}
+
+bool VoxelBrickMap::solid(int x, int y, int z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return false;
+	}
+	const glm::ivec3 local = glm::ivec3(x, y, z) - _region.getLowerCorner();
+	const Brick *b = brick(local >> BrickBits);
+	if (b == nullptr) {
+		return false;
+	}
+	const glm::ivec3 inner = local & (BrickSize - 1);
+	return (b->occupancy[inner.z] >> (inner.x + inner.y * BrickSize)) & 1u;
+}
+
+uint8_t VoxelBrickMap::colorIndex(int x, int y, int z) const {
+	if (!solid(x, y, z)) {
+		return 0u;
+	}
+	const glm::ivec3 local = glm::ivec3(x, y, z) - _region.getLowerCorner();
+	const glm::ivec3 inner = local & (BrickSize - 1);
+	return brick(local >> BrickBits)->colors[inner.x + inner.y * BrickSize + inner.z * BrickSize * BrickSize];
+}
+
+bool VoxelBrickMap::intersectBrick(const Brick &b, const glm::ivec3 &brickPos, const glm::vec3 &origin,
+								   const glm::vec3 &direction, float tmin, float tmax, int axis,
+								   VoxelBrickHit &hit) const {
+	const glm::vec3 brickOrigin = origin - glm::vec3(brickPos * BrickSize);
+	auto fn = [&](const glm::ivec3 &cell, float tEnter, float tExit, int enterAxis) {
+		const int bit = cell.x + cell.y * BrickSize;
+		if (((b.occupancy[cell.z] >> bit) & 1u) == 0u) {
+			return false;
+		}
+		hit.distance = tEnter;
+		hit.exitDistance = tExit;
+		hit.voxel = _region.getLowerCorner() + brickPos * BrickSize + cell;
+		hit.normal = faceNormal(direction, enterAxis);
+		hit.colorIndex = b.colors[bit + cell.z * BrickSize * BrickSize];
+		return true;
+	};
+	return traverseGrid(brickOrigin, direction, tmin, tmax, glm::ivec3(BrickSize), axis, fn);
+}
+
+bool VoxelBrickMap::intersect(const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax,
+							  VoxelBrickHit &hit) const {
+	if (_bricks.empty()) {
+		return false;
+	}
+	const glm::vec3 mins(_region.getLowerCorner());
+	const glm::vec3 maxs(_region.getUpperCorner() + 1);
+	const glm::vec3 invDirection = 1.0f / direction;
+	int axis;
+	if (!clipRay(origin, invDirection, mins, maxs, tmin, tmax, axis)) {
+		return false;
+	}
+	// the ray relative to the lower corner of the region
+	const glm::vec3 localOrigin = origin - mins;
+	auto fn = [&](const glm::ivec3 &brickPos, float tEnter, float tExit, int enterAxis) {
+		const Brick *b = brick(brickPos);
+		if (b == nullptr) {
+			return false;
+		}
+		return intersectBrick(*b, brickPos, localOrigin, direction, tEnter, tExit, enterAxis, hit);
+	};
+	const float scale = 1.0f / (float)BrickSize;
+	return traverseGrid(localOrigin * scale, direction * scale, tmin, tmax, _brickDims, axis, fn);
+}
+
+} // namespace voxelpathtracer
@@ -0,0 +1,117 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelpathtracer {
+
+/**
+ * @brief The result of a ray intersection with a @c VoxelBrickMap
+ */
+struct VoxelBrickHit {
+	/** the ray parameter where the ray enters the voxel */
+	float distance = 0.0f;
+	/** the ray parameter where the ray leaves the voxel again */
+	float exitDistance = 0.0f;
+	/** the voxel position in volume coordinates */
+	glm::ivec3 voxel{0};
+	/** the axis aligned normal of the voxel face that was hit */
+	glm::vec3 normal{0.0f};
+	/** the palette color index of the voxel */
+	uint8_t colorIndex = 0u;
+};
+
+/**
+ * @brief Sparse two level voxel acceleration structure for ray traversal
+ *
+ * The region of the volume is split into bricks of 8x8x8 voxels. Only the bricks that contain at least one solid voxel
+ * are stored - with one occupancy bit and one palette color index per voxel. Rays are traversed with a 3D-DDA over the
+ * brick grid (skipping the empty bricks) and a second 3D-DDA over the voxels of the non-empty bricks.
+ *
+ * The voxel at position (x, y, z) covers the space [x, x + 1) on every axis - this matches the meshes that are
+ * extracted for the volume.
+ */
+class VoxelBrickMap {
+public:
+	static constexpr int BrickBits = 3;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+	struct Brick {
+		// one word per z layer of the brick - the bit index is x + y * BrickSize
+		uint64_t occupancy[BrickSize];
+		uint8_t colors[BrickVoxels];
+	};
+
+private:
+	voxel::Region _region = voxel::Region::InvalidRegion;
+	glm::ivec3 _brickDims{0};
+	// one entry per brick of the region - the index into _bricks or -1 for empty bricks
+	core::Buffer<int32_t> _directory;
+	core::DynamicArray<Brick> _bricks;
+
+	inline int brickIndex(int bx, int by, int bz) const {
+		return bx + by * _brickDims.x + bz * _brickDims.x * _brickDims.y;
+	}
+
+	const Brick *brick(const glm::ivec3 &brickPos) const;
+	bool intersectBrick(const Brick &brick, const glm::ivec3 &brickPos, const glm::vec3 &origin,
+						const glm::vec3 &direction, float tmin, float tmax, int axis, VoxelBrickHit &hit) const;
+
+public:
+	/**
+	 * @brief Build the bricks for all non-air voxels of the given volume
+	 */
+	void build(const voxel::RawVolume &volume);
+	void clear();
+
+	/**
+	 * @brief Intersect the ray with the solid voxels
+	 * @param[in] origin The ray origin in volume coordinates
+	 * @param[in] direction The ray direction in volume coordinates - doesn't have to be normalized, the distance of
+	 * the hit is given in multiples of this vector
+	 * @param[in] tmin The ray parameter interval that is checked
+	 * @param[in] tmax The ray parameter interval that is checked
+	 * @return @c true if a solid voxel was hit - the hit contains the closest voxel along the ray
+	 */
+	bool intersect(const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax,
+				   VoxelBrickHit &hit) const;
+
+	bool solid(int x, int y, int z) const;
+	uint8_t colorIndex(int x, int y, int z) const;
+
+	inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	inline bool empty() const {
+		return _bricks.empty();
+	}
+
+	/**
+	 * @return The amount of non-empty bricks
+	 */
+	inline size_t bricks() const {
+		return _bricks.size();
+	}
+
+	/**
+	 * @return The memory in bytes that is used by the bricks and the brick directory
+	 */
+	inline size_t memory() const {
+		return _bricks.size() * sizeof(Brick) + _directory.size() * sizeof(int32_t);
+	}
+};
+
+} // namespace voxelpathtracer
@@ -0,0 +1,273 @@
+/**
+ * @file
+ */
+
+#include "VoxelScene.h"
+#include "core/Algorithm.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include "voxel/RawVolume.h"
+#include <float.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+namespace voxelpathtracer {
+
+namespace {
+
+constexpr int MaxLeafInstances = 2;
+
+bool intersectBox(const glm::vec3 &origin, const glm::vec3 &invDirection, const glm::vec3 &mins,
+				  const glm::vec3 &maxs, float tmin, float tmax) {
+	const glm::vec3 t0 = (mins - origin) * invDirection;
+	const glm::vec3 t1 = (maxs - origin) * invDirection;
+	const glm::vec3 tnear = glm::min(t0, t1);
+	const glm::vec3 tfar = glm::max(t0, t1);
+	tmin = core_max(tmin, core_max(tnear.x, core_max(tnear.y, tnear.z)));
+	tmax = core_min(tmax, core_min(tfar.x, core_min(tfar.y, tfar.z)));
+	return tmin <= tmax;
+}
+
+} // namespace
+
+void VoxelScene::clear() {
+	_volumes.clear();
+	_brickMaps.clear();
+	_built.clear();
+	clearInstances();
+}
+
+void VoxelScene::clearInstances() {
+	_instances.clear();
+	_nodes.clear();
+	_order.clear();
+}
+
+void VoxelScene::invalidate(const voxel::RawVolume *volume) {
+	for (size_t i = 0; i < _volumes.size(); ++i) {
+		if (_volumes[i] == volume) {
+			_built[i] = false;
+		}
+	}
+}
+
+size_t VoxelScene::memory() const {
+	size_t bytes = 0u;
+	for (const VoxelBrickMap &brickMap : _brickMaps) {
+		bytes += brickMap.memory();
+	}
+	return bytes;
+}
+
+bool VoxelScene::bounds(glm::vec3 &mins, glm::vec3 &maxs) const {
+	if (_nodes.empty()) {
+		return false;
+	}
+	mins = _nodes[0].mins;
+	maxs = _nodes[0].maxs;
+	return true;
+}
+
+int VoxelScene::addInstance(const voxel::RawVolume *volume, const glm::mat4 &localToWorld, int materialOffset) {
+	Instance instance;
+	for (size_t i = 0; i < _volumes.size(); ++i) {
+		if (_volumes[i] == volume) {
+			instance.brickMap = (int)i;
+			break;
+		}
+	}
+	if (instance.brickMap == -1) {
+		instance.brickMap = (int)_volumes.size();
+		_volumes.push_back(volume);
+		_brickMaps.emplace_back();
+		_built.push_back(false);
+	}
+	instance.materialOffset = materialOffset;
+	updateTransform(instance, localToWorld);
+	_instances.push_back(instance);
+	return (int)_instances.size() - 1;
+}
+
+void VoxelScene::updateTransform(Instance &instance, const glm::mat4 &localToWorld) {
+	const voxel::Region &region = _volumes[instance.brickMap]->region();
+	instance.localToWorld = localToWorld;
+	instance.worldToLocal = glm::inverse(instance.localToWorld);
+	instance.normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.localToWorld)));
+
+	const glm::vec3 mins(region.getLowerCorner());
+	const glm::vec3 maxs(region.getUpperCorner() + 1);
+	instance.mins = glm::vec3(FLT_MAX);
+	instance.maxs = glm::vec3(-FLT_MAX);
+	for (int i = 0; i < 8; ++i) {
+		const glm::vec3 corner((i & 1) ? maxs.x : mins.x, (i & 2) ? maxs.y : mins.y, (i & 4) ? maxs.z : mins.z);
+		const glm::vec3 world(instance.localToWorld * glm::vec4(corner, 1.0f));
+		instance.mins = glm::min(instance.mins, world);
+		instance.maxs = glm::max(instance.maxs, world);
+	}
+}
+
+void VoxelScene::setTransform(int instanceIdx, const glm::mat4 &localToWorld) {
+	updateTransform(_instances[instanceIdx], localToWorld);
+}
+
+void VoxelScene::refit() {
+	core_trace_scoped(VoxelSceneRefit);
+	// the children are always stored behind their parent
+	for (int i = (int)_nodes.size() - 1; i >= 0; --i) {
+		BVHNode &node = _nodes[i];
+		if (node.count == 0) {
+			node.mins = glm::min(_nodes[node.first].mins, _nodes[node.first + 1].mins);
+			node.maxs = glm::max(_nodes[node.first].maxs, _nodes[node.first + 1].maxs);
+			continue;
+		}
+		node.mins = glm::vec3(FLT_MAX);
+		node.maxs = glm::vec3(-FLT_MAX);
+		for (int j = node.first; j < node.first + node.count; ++j) {
+			const Instance &instance = _instances[_order[j]];
+			node.mins = glm::min(node.mins, instance.mins);
+			node.maxs = glm::max(node.maxs, instance.maxs);
+		}
+	}
+}
+
+void VoxelScene::build() {
+	core_trace_scoped(VoxelSceneBuild);
+	// drop the brick maps of volumes that are no longer referenced and compact the remaining ones
+	core::DynamicArray<int> remap;
+	remap.resize(_volumes.size());
+	for (size_t i = 0; i < _volumes.size(); ++i) {
+		remap[i] = -1;
+	}
+	for (const Instance &instance : _instances) {
+		remap[instance.brickMap] = 0;
+	}
+	int used = 0;
+	for (size_t i = 0; i < _volumes.size(); ++i) {
+		if (remap[i] == -1) {
+			continue;
+		}
+		remap[i] = used;
+		if ((int)i != used) {
+			_volumes[used] = _volumes[i];
+			_brickMaps[used] = core::move(_brickMaps[i]);
+			_built[used] = _built[i];
+		}
+		++used;
+	}
+	_volumes.resize(used);
+	_brickMaps.resize(used);
+	_built.resize(used);
+	for (Instance &instance : _instances) {
+		instance.brickMap = remap[instance.brickMap];
+	}
+
+	for (size_t i = 0; i < _volumes.size(); ++i) {
+		if (!_built[i]) {
+			_brickMaps[i].build(*_volumes[i]);
+			_built[i] = true;
+		}
+	}
+
+	_nodes.clear();
+	_order.clear();
+	if (_instances.empty()) {
+		return;
+	}
+	_order.reserve(_instances.size());
+	for (size_t i = 0; i < _instances.size(); ++i) {
+		_order.push_back((int)i);
+	}
+	_nodes.reserve(_instances.size() * 2);
+	_nodes.emplace_back();
+	buildNode(0, 0, (int)_instances.size());
+}
+
+void VoxelScene::buildNode(int nodeIdx, int first, int count) {
+	BVHNode node;
+	node.mins = glm::vec3(FLT_MAX);
+	node.maxs = glm::vec3(-FLT_MAX);
+	glm::vec3 centerMins(FLT_MAX);
+	glm::vec3 centerMaxs(-FLT_MAX);
+	for (int i = first; i < first + count; ++i) {
+		const Instance &instance = _instances[_order[i]];
+		node.mins = glm::min(node.mins, instance.mins);
+		node.maxs = glm::max(node.maxs, instance.maxs);
+		const glm::vec3 center = (instance.mins + instance.maxs) * 0.5f;
+		centerMins = glm::min(centerMins, center);
+		centerMaxs = glm::max(centerMaxs, center);
+	}
+	if (count <= MaxLeafInstances) {
+		node.first = first;
+		node.count = count;
+		_nodes[nodeIdx] = node;
+		return;
+	}
+
+	// median split along the longest axis of the instance centers
+	const glm::vec3 extent = centerMaxs - centerMins;
+	const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+	core::sort(_order.begin() + first, _order.begin() + first + count, [this, axis](int a, int b) {
+		return _instances[a].mins[axis] + _instances[a].maxs[axis] < _instances[b].mins[axis] + _instances[b].maxs[axis];
+	});
+	const int half = count / 2;
+	// the children are stored next to each other
+	node.first = (int)_nodes.size();
+	node.count = 0;
+	_nodes[nodeIdx] = node;
+	_nodes.emplace_back();
+	_nodes.emplace_back();
+	buildNode(node.first, first, half);
+	buildNode(node.first + 1, first + half, count - half);
+}
+
+bool VoxelScene::intersectInstance(int instanceIdx, const glm::vec3 &origin, const glm::vec3 &direction, float tmin,
+								   float tmax, VoxelHit &hit) const {
+	const Instance &instance = _instances[instanceIdx];
+	// the transform is affine - the ray parameter is the same in local and world space
+	const glm::vec3 localOrigin(instance.worldToLocal * glm::vec4(origin, 1.0f));
+	const glm::vec3 localDirection(glm::mat3(instance.worldToLocal) * direction);
+	VoxelBrickHit brickHit;
+	if (!_brickMaps[instance.brickMap].intersect(localOrigin, localDirection, tmin, tmax, brickHit)) {
+		return false;
+	}
+	hit.instance = instanceIdx;
+	hit.distance = brickHit.distance;
+	hit.exitDistance = brickHit.exitDistance;
+	hit.voxel = brickHit.voxel;
+	hit.normal = glm::normalize(instance.normalMatrix * brickHit.normal);
+	hit.colorIndex = brickHit.colorIndex;
+	return true;
+}
+
+bool VoxelScene::intersect(const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax,
+						   VoxelHit &hit) const {
+	if (_nodes.empty()) {
+		return false;
+	}
+	const glm::vec3 invDirection = 1.0f / direction;
+	bool found = false;
+	int stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const BVHNode &node = _nodes[stack[--stackSize]];
+		if (!intersectBox(origin, invDirection, node.mins, node.maxs, tmin, tmax)) {
+			continue;
+		}
+		if (node.count == 0) {
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+			continue;
+		}
+		for (int i = node.first; i < node.first + node.count; ++i) {
+			if (intersectInstance(_order[i], origin, direction, tmin, tmax, hit)) {
+				tmax = hit.distance;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+} // namespace voxelpathtracer
@@ -0,0 +1,149 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "VoxelBrickMap.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelpathtracer {
+
+/**
+ * @brief The result of a ray intersection with a @c VoxelScene
+ */
+struct VoxelHit {
+	/** the index of the instance that was hit */
+	int instance = -1;
+	/** the ray parameter of the hit - in multiples of the ray direction */
+	float distance = 0.0f;
+	/** the ray parameter where the ray leaves the voxel that was hit */
+	float exitDistance = 0.0f;
+	/** the voxel position in the volume of the instance */
+	glm::ivec3 voxel{0};
+	/** the world space normal of the voxel face that was hit */
+	glm::vec3 normal{0.0f};
+	uint8_t colorIndex = 0u;
+};
+
+/**
+ * @brief Voxel-native scene for the path tracer
+ *
+ * Every model node is an instance of a @c VoxelBrickMap that is placed by the world transform of the node. Nodes that
+ * resolve to the same volume (reference nodes) share the brick map. The instances are organized in a bounding volume
+ * hierarchy over their world space bounds.
+ */
+class VoxelScene {
+public:
+	struct Instance {
+		int brickMap = -1;
+		/** the index of the material for palette color 0 - the voxel color index is added to it */
+		int materialOffset = 0;
+		glm::mat4 localToWorld{1.0f};
+		glm::mat4 worldToLocal{1.0f};
+		glm::mat3 normalMatrix{1.0f};
+		glm::vec3 mins{0.0f};
+		glm::vec3 maxs{0.0f};
+	};
+
+private:
+	struct BVHNode {
+		glm::vec3 mins{0.0f};
+		glm::vec3 maxs{0.0f};
+		/** the index of the first child node - or the first instance index in @c _order for leaf nodes */
+		int first = 0;
+		/** the amount of instances for leaf nodes - @c 0 for inner nodes */
+		int count = 0;
+	};
+
+	core::DynamicArray<const voxel::RawVolume *> _volumes;
+	core::DynamicArray<VoxelBrickMap> _brickMaps;
+	/** @c false if the brick map must get (re-)built from the volume with the next @c build() */
+	core::DynamicArray<bool> _built;
+	core::DynamicArray<Instance> _instances;
+	core::DynamicArray<BVHNode> _nodes;
+	core::DynamicArray<int> _order;
+
+	void buildNode(int nodeIdx, int first, int count);
+	void updateTransform(Instance &instance, const glm::mat4 &localToWorld);
+	bool intersectInstance(int instanceIdx, const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax,
+						   VoxelHit &hit) const;
+
+public:
+	/**
+	 * @brief Add an instance of the volume
+	 * @param[in] localToWorld The transform from volume coordinates into world space - this is the world matrix of the
+	 * node including the pivot offset
+	 * @param[in] materialOffset The index of the first material for the palette of the node
+	 * @return The instance index
+	 * @note Call @c build() after all instances were added
+	 */
+	int addInstance(const voxel::RawVolume *volume, const glm::mat4 &localToWorld, int materialOffset);
+
+	/**
+	 * @brief Build the brick maps of the new or invalidated volumes and the hierarchy of the instances
+	 *
+	 * Brick maps of volumes that are no longer used by any instance are removed.
+	 */
+	void build();
+	void clear();
+	/**
+	 * @brief Remove all instances but keep the brick maps - they are reused by @c build() if the same volumes are
+	 * added again
+	 */
+	void clearInstances();
+	/**
+	 * @brief Rebuild the brick map of the given volume with the next @c build() because the voxels were modified
+	 */
+	void invalidate(const voxel::RawVolume *volume);
+	/**
+	 * @brief Move the instance - see @c addInstance() for the transform
+	 * @note Call @c refit() after all transforms were updated
+	 */
+	void setTransform(int instanceIdx, const glm::mat4 &localToWorld);
+	/**
+	 * @brief Update the bounds of the hierarchy for moved instances without changing its topology
+	 */
+	void refit();
+
+	/**
+	 * @brief Find the closest voxel that is hit by the ray in the given ray parameter interval
+	 */
+	bool intersect(const glm::vec3 &origin, const glm::vec3 &direction, float tmin, float tmax, VoxelHit &hit) const;
+
+	/**
+	 * @brief The world space bounds of all instances
+	 * @return @c false if the scene is empty
+	 */
+	bool bounds(glm::vec3 &mins, glm::vec3 &maxs) const;
+
+	inline const Instance &instance(int idx) const {
+		return _instances[idx];
+	}
+
+	inline int instances() const {
+		return (int)_instances.size();
+	}
+
+	inline const VoxelBrickMap &brickMap(int idx) const {
+		return _brickMaps[idx];
+	}
+
+	inline int brickMaps() const {
+		return (int)_brickMaps.size();
+	}
+
+	/**
+	 * @return The memory in bytes that is used by the brick maps
+	 */
+	size_t memory() const;
+};
+
+} // namespace voxelpathtracer
@@ -0,0 +1,428 @@
+/**
+ * @file
+ */
+
+#include "VoxelTracer.h"
+#include "VoxelScene.h"
+#include "app/ForParallel.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include <float.h>
+#include <future>
+#include <glm/geometric.hpp>
+#include <yocto_sampling.h>
+#include <yocto_shading.h>
+
+namespace voxelpathtracer {
+
+namespace {
+
+// the offset for rays that leave a voxel surface - to not hit the voxel again
+constexpr float RayEpsilon = 1e-3f;
+
+struct VoxelTraceResult {
+	yocto::vec3f radiance{0, 0, 0};
+	bool hit = false;
+	yocto::vec3f albedo{0, 0, 0};
+	yocto::vec3f normal{0, 0, 0};
+};
+
+inline yocto::vec3f toVec3f(const glm::vec3 &in) {
+	return yocto::vec3f{in.x, in.y, in.z};
+}
+
+inline glm::vec3 toVec3(const yocto::vec3f &in) {
+	return glm::vec3(in.x, in.y, in.z);
+}
+
+// the bsdf helpers of the yocto tracer are private - these are the parts for the material types that are mapped from
+// the palette materials
+
+yocto::vec3f evalEmission(const yocto::material_point &material, const yocto::vec3f &normal,
+						  const yocto::vec3f &outgoing) {
+	return yocto::dot(normal, outgoing) >= 0 ? material.emission : yocto::vec3f{0, 0, 0};
+}
+
+yocto::vec3f evalBsdfcos(const yocto::material_point &material, const yocto::vec3f &normal,
+						 const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	if (material.roughness == 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case yocto::material_type::matte:
+		return yocto::eval_matte(material.color, normal, outgoing, incoming);
+	case yocto::material_type::reflective:
+		return yocto::eval_reflective(material.color, material.roughness, normal, outgoing, incoming);
+	case yocto::material_type::transparent:
+		return yocto::eval_transparent(material.color, material.ior, material.roughness, normal, outgoing, incoming);
+	case yocto::material_type::refractive:
+		return yocto::eval_refractive(material.color, material.ior, material.roughness, normal, outgoing, incoming);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+yocto::vec3f sampleBsdfcos(const yocto::material_point &material, const yocto::vec3f &normal,
+						   const yocto::vec3f &outgoing, float rnl, const yocto::vec2f &rn) {
+	if (material.roughness == 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case yocto::material_type::matte:
+		return yocto::sample_matte(material.color, normal, outgoing, rn);
+	case yocto::material_type::reflective:
+		return yocto::sample_reflective(material.color, material.roughness, normal, outgoing, rn);
+	case yocto::material_type::transparent:
+		return yocto::sample_transparent(material.color, material.ior, material.roughness, normal, outgoing, rnl, rn);
+	case yocto::material_type::refractive:
+		return yocto::sample_refractive(material.color, material.ior, material.roughness, normal, outgoing, rnl, rn);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+float sampleBsdfcosPdf(const yocto::material_point &material, const yocto::vec3f &normal,
+					   const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	if (material.roughness == 0) {
+		return 0;
+	}
+	switch (material.type) {
+	case yocto::material_type::matte:
+		return yocto::sample_matte_pdf(material.color, normal, outgoing, incoming);
+	case yocto::material_type::reflective:
+		return yocto::sample_reflective_pdf(material.color, material.roughness, normal, outgoing, incoming);
+	case yocto::material_type::transparent:
+		return yocto::sample_tranparent_pdf(material.color, material.ior, material.roughness, normal, outgoing,
+											incoming);
+	case yocto::material_type::refractive:
+		return yocto::sample_refractive_pdf(material.color, material.ior, material.roughness, normal, outgoing,
+											incoming);
+	default:
+		return 0;
+	}
+}
+
+yocto::vec3f evalDelta(const yocto::material_point &material, const yocto::vec3f &normal,
+					   const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	if (material.roughness != 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case yocto::material_type::reflective:
+		return yocto::eval_reflective(material.color, normal, outgoing, incoming);
+	case yocto::material_type::transparent:
+		return yocto::eval_transparent(material.color, material.ior, normal, outgoing, incoming);
+	case yocto::material_type::refractive:
+		return yocto::eval_refractive(material.color, material.ior, normal, outgoing, incoming);
+	case yocto::material_type::volumetric:
+		return yocto::eval_passthrough(material.color, normal, outgoing, incoming);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+yocto::vec3f sampleDelta(const yocto::material_point &material, const yocto::vec3f &normal,
+						 const yocto::vec3f &outgoing, float rnl) {
+	if (material.roughness != 0) {
+		return {0, 0, 0};
+	}
+	switch (material.type) {
+	case yocto::material_type::reflective:
+		return yocto::sample_reflective(material.color, normal, outgoing);
+	case yocto::material_type::transparent:
+		return yocto::sample_transparent(material.color, material.ior, normal, outgoing, rnl);
+	case yocto::material_type::refractive:
+		return yocto::sample_refractive(material.color, material.ior, normal, outgoing, rnl);
+	case yocto::material_type::volumetric:
+		return yocto::sample_passthrough(material.color, normal, outgoing);
+	default:
+		return {0, 0, 0};
+	}
+}
+
+float sampleDeltaPdf(const yocto::material_point &material, const yocto::vec3f &normal,
+					 const yocto::vec3f &outgoing, const yocto::vec3f &incoming) {
+	if (material.roughness != 0) {
+		return 0;
+	}
+	switch (material.type) {
+	case yocto::material_type::reflective:
+		return yocto::sample_reflective_pdf(material.color, normal, outgoing, incoming);
+	case yocto::material_type::transparent:
+		return yocto::sample_tranparent_pdf(material.color, material.ior, normal, outgoing, incoming);
+	case yocto::material_type::refractive:
+		return yocto::sample_refractive_pdf(material.color, material.ior, normal, outgoing, incoming);
+	case yocto::material_type::volumetric:
+		return yocto::sample_passthrough_pdf(material.color, normal, outgoing, incoming);
+	default:
+		return 0;
+	}
+}
+
+// the light sampling of the yocto tracer is private, too - the voxel tracer only gets the environment lights (see
+// PathTracer::updateLights()). The emissive voxels are only hit by the bsdf samples.
+
+yocto::vec3f sampleLights(const yocto::scene_data &scene, const yocto::trace_lights &lights, float rl, float rel,
+						  const yocto::vec2f &ruv) {
+	const int lightId = yocto::sample_uniform((int)lights.lights.size(), rl);
+	const yocto::trace_light &light = lights.lights[lightId];
+	if (light.environment == yocto::invalidid) {
+		return {0, 0, 0};
+	}
+	const yocto::environment_data &environment = scene.environments[light.environment];
+	if (environment.emission_tex == yocto::invalidid) {
+		return yocto::sample_sphere(ruv);
+	}
+	const yocto::texture_data &texture = scene.textures[environment.emission_tex];
+	const int idx = yocto::sample_discrete(light.elements_cdf, rel);
+	const yocto::vec2f uv{((idx % texture.width) + 0.5f) / texture.width,
+						  ((idx / texture.width) + 0.5f) / texture.height};
+	return yocto::transform_direction(environment.frame, {yocto::cos(uv.x * 2 * yocto::pif) * yocto::sin(uv.y * yocto::pif),
+														  yocto::cos(uv.y * yocto::pif),
+														  yocto::sin(uv.x * 2 * yocto::pif) * yocto::sin(uv.y * yocto::pif)});
+}
+
+float sampleLightsPdf(const yocto::scene_data &scene, const yocto::trace_lights &lights,
+					  const yocto::vec3f &direction) {
+	float pdf = 0.0f;
+	for (const yocto::trace_light &light : lights.lights) {
+		if (light.environment == yocto::invalidid) {
+			continue;
+		}
+		const yocto::environment_data &environment = scene.environments[light.environment];
+		if (environment.emission_tex == yocto::invalidid) {
+			pdf += 1 / (4 * yocto::pif);
+			continue;
+		}
+		const yocto::texture_data &texture = scene.textures[environment.emission_tex];
+		const yocto::vec3f wl = yocto::transform_direction(yocto::inverse(environment.frame), direction);
+		yocto::vec2f texcoord{yocto::atan2(wl.z, wl.x) / (2 * yocto::pif),
+							  yocto::acos(yocto::clamp(wl.y, -1.0f, 1.0f)) / yocto::pif};
+		if (texcoord.x < 0) {
+			texcoord.x += 1;
+		}
+		const int i = yocto::clamp((int)(texcoord.x * texture.width), 0, texture.width - 1);
+		const int j = yocto::clamp((int)(texcoord.y * texture.height), 0, texture.height - 1);
+		const float prob =
+			yocto::sample_discrete_pdf(light.elements_cdf, j * texture.width + i) / light.elements_cdf.back();
+		const float angle = (2 * yocto::pif / texture.width) * (yocto::pif / texture.height) *
+							yocto::sin(yocto::pif * (j + 0.5f) / texture.height);
+		pdf += prob / angle;
+	}
+	return pdf * yocto::sample_uniform_pdf((int)lights.lights.size());
+}
+
+yocto::material_point evalMaterial(const yocto::scene_data &scene, const VoxelScene &voxelScene, const VoxelHit &hit) {
+	const VoxelScene::Instance &instance = voxelScene.instance(hit.instance);
+	const size_t idx = (size_t)instance.materialOffset + hit.colorIndex;
+	if (idx >= scene.materials.size()) {
+		return yocto::eval_material(scene, yocto::material_data{}, {0, 0});
+	}
+	const yocto::material_data &material = scene.materials[idx];
+	// the mesh based scene multiplies the material with the vertex colors - which are the palette colors, too
+	const yocto::vec4f shapeColor{material.color.x, material.color.y, material.color.z, material.opacity};
+	return yocto::eval_material(scene, material, {0, 0}, shapeColor);
+}
+
+VoxelTraceResult traceVoxelPath(const yocto::scene_data &scene, const VoxelScene &voxelScene,
+								const yocto::trace_lights &lights, glm::vec3 origin, glm::vec3 direction,
+								yocto::rng_state &rng, const yocto::trace_params &params) {
+	VoxelTraceResult result;
+	yocto::vec3f weight{1, 1, 1};
+	int opbounce = 0;
+	const bool eyelight = params.sampler == yocto::trace_sampler_type::eyelight;
+	const int bounces = eyelight ? core_max(params.bounces, 4) : params.bounces;
+	// next event estimation - like the path sampler of yocto the bsdf and the light samples are combined with the
+	// balance heuristic by sampling the mixture of both distributions
+	const bool lightSampling = params.sampler != yocto::trace_sampler_type::naive && !lights.lights.empty();
+
+	for (int bounce = 0; bounce < bounces; ++bounce) {
+		VoxelHit hit;
+		if (!voxelScene.intersect(origin, direction, 0.0f, FLT_MAX, hit)) {
+			if (bounce > 0 || !params.envhidden) {
+				result.radiance += weight * yocto::eval_environment(scene, toVec3f(direction));
+			}
+			break;
+		}
+
+		const yocto::vec3f outgoing = -toVec3f(direction);
+		const glm::vec3 position = origin + direction * hit.distance;
+		const yocto::vec3f normal = toVec3f(hit.normal);
+		const yocto::material_point material = evalMaterial(scene, voxelScene, hit);
+		// the position behind the voxel for rays that pass through it
+		const glm::vec3 behind = origin + direction * (hit.exitDistance + RayEpsilon);
+
+		// handle opacity
+		if (material.opacity < 1 && yocto::rand1f(rng) >= material.opacity) {
+			if (opbounce++ > 128) {
+				break;
+			}
+			origin = behind;
+			bounce -= 1;
+			continue;
+		}
+
+		if (bounce == 0) {
+			result.hit = true;
+			result.albedo = material.color;
+			result.normal = normal;
+		}
+
+		result.radiance += weight * evalEmission(material, normal, outgoing);
+
+		yocto::vec3f incoming{0, 0, 0};
+		if (eyelight) {
+			result.radiance += weight * yocto::pif * evalBsdfcos(material, normal, outgoing, outgoing);
+			if (!yocto::is_delta(material)) {
+				break;
+			}
+			incoming = sampleDelta(material, normal, outgoing, yocto::rand1f(rng));
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= evalDelta(material, normal, outgoing, incoming) /
+					  sampleDeltaPdf(material, normal, outgoing, incoming);
+		} else if (material.roughness != 0 && lightSampling) {
+			if (yocto::rand1f(rng) < 0.5f) {
+				incoming = sampleBsdfcos(material, normal, outgoing, yocto::rand1f(rng), yocto::rand2f(rng));
+			} else {
+				incoming = sampleLights(scene, lights, yocto::rand1f(rng), yocto::rand1f(rng), yocto::rand2f(rng));
+			}
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= evalBsdfcos(material, normal, outgoing, incoming) /
+					  (0.5f * sampleBsdfcosPdf(material, normal, outgoing, incoming) +
+					   0.5f * sampleLightsPdf(scene, lights, incoming));
+		} else if (material.roughness != 0) {
+			incoming = sampleBsdfcos(material, normal, outgoing, yocto::rand1f(rng), yocto::rand2f(rng));
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= evalBsdfcos(material, normal, outgoing, incoming) /
+					  sampleBsdfcosPdf(material, normal, outgoing, incoming);
+		} else {
+			incoming = sampleDelta(material, normal, outgoing, yocto::rand1f(rng));
+			if (incoming == yocto::vec3f{0, 0, 0}) {
+				break;
+			}
+			weight *= evalDelta(material, normal, outgoing, incoming) /
+					  sampleDeltaPdf(material, normal, outgoing, incoming);
+		}
+
+		if (weight == yocto::vec3f{0, 0, 0} || !yocto::isfinite(weight)) {
+			break;
+		}
+
+		if (!eyelight && bounce > 3) {
+			const float rrProb = yocto::min(0.99f, yocto::max(weight));
+			if (yocto::rand1f(rng) >= rrProb) {
+				break;
+			}
+			weight *= 1 / rrProb;
+		}
+
+		if (yocto::dot(incoming, normal) < 0) {
+			// transmitted - the voxel is a slab with parallel faces, the ray leaves it in the same direction
+			origin = behind;
+		} else {
+			origin = position + hit.normal * RayEpsilon;
+			direction = toVec3(incoming);
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+void traceVoxelSample(yocto::trace_state &state, const yocto::scene_data &scene, const VoxelScene &voxelScene,
+					  const yocto::trace_lights &lights, int i, int j, int sample, const yocto::trace_params &params) {
+	const yocto::camera_data &camera = scene.cameras[params.camera];
+	const int idx = state.width * j + i;
+	yocto::rng_state &rng = state.rngs[idx];
+	const yocto::vec2f puv = yocto::rand2f(rng);
+	const yocto::vec2f luv = yocto::rand2f(rng);
+	const yocto::vec2f uv{(i + puv.x) / state.width, (j + puv.y) / state.height};
+	const yocto::ray3f ray = yocto::eval_camera(camera, uv, yocto::sample_disk(luv));
+	VoxelTraceResult result = traceVoxelPath(scene, voxelScene, lights, toVec3(ray.o), toVec3(ray.d), rng, params);
+	if (!yocto::isfinite(result.radiance)) {
+		result.radiance = {0, 0, 0};
+	}
+	if (yocto::max(result.radiance) > params.clamp) {
+		result.radiance = result.radiance * (params.clamp / yocto::max(result.radiance));
+	}
+	const float weight = 1.0f / (float)(sample + 1);
+	if (result.hit || (!params.envhidden && !scene.environments.empty())) {
+		const yocto::vec3f &radiance = result.radiance;
+		state.image[idx] = yocto::lerp(state.image[idx], {radiance.x, radiance.y, radiance.z, 1}, weight);
+		state.albedo[idx] = yocto::lerp(state.albedo[idx], result.hit ? result.albedo : yocto::vec3f{1, 1, 1}, weight);
+		state.normal[idx] = yocto::lerp(state.normal[idx], result.hit ? result.normal : -ray.d, weight);
+		state.hits[idx] += 1;
+	} else {
+		state.image[idx] = yocto::lerp(state.image[idx], {0, 0, 0, 0}, weight);
+		state.albedo[idx] = yocto::lerp(state.albedo[idx], {0, 0, 0}, weight);
+		state.normal[idx] = yocto::lerp(state.normal[idx], -ray.d, weight);
+	}
+}
+
+namespace {
+
+void traceVoxelBatch(yocto::trace_state &state, const yocto::scene_data &scene, const VoxelScene &voxelScene,
+					 const yocto::trace_lights &lights, const yocto::trace_params &params,
+					 const std::atomic<bool> *stop) {
+	core_trace_scoped(TraceVoxelBatch);
+	auto fn = [&](int start, int end) {
+		for (int j = start; j < end; ++j) {
+			if (stop != nullptr && *stop) {
+				return;
+			}
+			for (int i = 0; i < state.width; ++i) {
+				for (int sample = state.samples; sample < state.samples + params.batch; ++sample) {
+					traceVoxelSample(state, scene, voxelScene, lights, i, j, sample, params);
+				}
+			}
+		}
+	};
+	if (params.noparallel) {
+		fn(0, state.height);
+	} else {
+		app::for_parallel(0, state.height, fn);
+	}
+}
+
+} // namespace
+
+void traceVoxelSamples(yocto::trace_state &state, const yocto::scene_data &scene, const VoxelScene &voxelScene,
+					   const yocto::trace_lights &lights, const yocto::trace_params &params) {
+	if (state.samples >= params.samples) {
+		return;
+	}
+	traceVoxelBatch(state, scene, voxelScene, lights, params, nullptr);
+	state.samples += params.batch;
+}
+
+void traceVoxelStart(yocto::trace_context &context, yocto::trace_state &state, const yocto::scene_data &scene,
+					 const VoxelScene &voxelScene, const yocto::trace_lights &lights,
+					 const yocto::trace_params &params) {
+	if (state.samples >= params.samples) {
+		return;
+	}
+	context.stop = false;
+	context.done = false;
+	context.worker = std::async(std::launch::async, [&]() {
+		if (context.stop) {
+			return;
+		}
+		traceVoxelBatch(state, scene, voxelScene, lights, params, &context.stop);
+		if (context.stop) {
+			return;
+		}
+		state.samples += params.batch;
+		if (params.denoise && !state.denoised.empty()) {
+			yocto::denoise_image(state.denoised, state.width, state.height, state.image, state.albedo, state.normal);
+		}
+		context.done = true;
+	});
+}
+
+} // namespace voxelpathtracer
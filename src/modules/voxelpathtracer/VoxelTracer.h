@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @brief Path tracing on top of the voxel-native @c VoxelScene instead of the triangle bvh of yocto
+ */
+
+#pragma once
+
+#include <yocto_scene.h>
+#include <yocto_trace.h>
+
+namespace voxelpathtracer {
+
+class VoxelScene;
+
+/**
+ * @brief Trace one batch of samples for every pixel of the state
+ *
+ * The materials of the voxels are taken from the yocto scene (@c VoxelScene::Instance::materialOffset plus the palette
+ * color index) - and so are the cameras and the environment. The eyelight sampler is supported for quick previews,
+ * the naive sampler only samples the bsdf. All other samplers add next event estimation for the environment lights
+ * and combine it with the bsdf samples by multiple importance sampling. Emissive voxels are not sampled as lights -
+ * small emitters converge slowly. Transparent voxels are treated as thin slabs - the rays that are transmitted
+ * continue behind the voxel.
+ *
+ * @param[in] lights The environment lights - see @c yocto::make_trace_lights()
+ */
+void traceVoxelSamples(yocto::trace_state &state, const yocto::scene_data &scene, const VoxelScene &voxelScene,
+					   const yocto::trace_lights &lights, const yocto::trace_params &params);
+
+/**
+ * @brief Trace one sample for the given pixel - see @c yocto::trace_sample()
+ * @param[in] sample The sample index of the pixel - the image is the running mean over the samples of a pixel
+ */
+void traceVoxelSample(yocto::trace_state &state, const yocto::scene_data &scene, const VoxelScene &voxelScene,
+					  const yocto::trace_lights &lights, int i, int j, int sample, const yocto::trace_params &params);
+
+/**
+ * @brief Asynchronous version of @c traceVoxelSamples() - see @c yocto::trace_start()
+ */
+void traceVoxelStart(yocto::trace_context &context, yocto::trace_state &state, const yocto::scene_data &scene,
+					 const VoxelScene &voxelScene, const yocto::trace_lights &lights,
+					 const yocto::trace_params &params);
+
+} // namespace voxelpathtracer
@@ -0,0 +1,136 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
+#include "voxelpathtracer/PathTracer.h"
+#include "voxelpathtracer/PathTracerState.h"
+#include "voxelpathtracer/VoxelTracer.h"
+#include "voxelformat/FormatConfig.h"
+#include <glm/trigonometric.hpp>
+
+/**
+ * @brief Compares the triangle bvh of yocto with the voxel-native traversal on a synthetic terrain scene with a few
+ * emissive voxels.
+ */
+class PathTracerBenchmark : public app::AbstractBenchmark {
+private:
+	using Super = app::AbstractBenchmark;
+
+protected:
+	scenegraph::SceneGraph _sceneGraph;
+
+	void SetUp(::benchmark::State &state) override {
+		Super::SetUp(state);
+		voxelformat::FormatConfig::init();
+		if (!_sceneGraph.empty()) {
+			return;
+		}
+		palette::Palette palette;
+		palette.nippon();
+		const voxel::Region region(0, 0, 0, 127, 63, 127);
+		voxel::RawVolume *v = new voxel::RawVolume(region);
+		for (int z = 0; z <= region.getUpperZ(); ++z) {
+			for (int x = 0; x <= region.getUpperX(); ++x) {
+				const float h = 24.0f + 12.0f * glm::sin((float)x * 0.1f) * glm::cos((float)z * 0.07f);
+				for (int y = 0; y <= (int)h; ++y) {
+					const uint8_t color = (x % 32 == 0 && z % 32 == 0) ? 1 : (uint8_t)(2 + y % 8);
+					v->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+				}
+			}
+		}
+		palette.setEmit(1, 1.0f);
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(v);
+		node.setPalette(palette);
+		_sceneGraph.emplace(core::move(node));
+		_sceneGraph.updateTransforms();
+	}
+
+	void createScene(benchmark::State &state, bool voxelTraversal) {
+		for (auto _ : state) {
+			voxelpathtracer::PathTracer pathTracer;
+			pathTracer.state().voxelTraversal = voxelTraversal;
+			pathTracer.state().params.resolution = 16;
+			pathTracer.start(_sceneGraph);
+			pathTracer.stop();
+		}
+	}
+
+	// only the transform of the node is changed - the meshes or brick maps are kept
+	void moveNode(benchmark::State &state, bool voxelTraversal) {
+		voxelpathtracer::PathTracer pathTracer;
+		pathTracer.state().voxelTraversal = voxelTraversal;
+		pathTracer.state().params.resolution = 16;
+		pathTracer.state().params.samples = 1 << 30;
+		pathTracer.start(_sceneGraph);
+		scenegraph::SceneGraphTransform &transform = _sceneGraph.firstModelNode()->transform();
+		const glm::vec3 translation = transform.worldTranslation();
+		int n = 0;
+		for (auto _ : state) {
+			transform.setWorldTranslation(translation + glm::vec3((float)(++n % 2), 0.0f, 0.0f));
+			_sceneGraph.updateTransforms();
+			pathTracer.updateScene(_sceneGraph);
+		}
+		pathTracer.stop();
+		transform.setWorldTranslation(translation);
+		_sceneGraph.updateTransforms();
+	}
+
+	void traceSamples(benchmark::State &state, bool voxelTraversal) {
+		voxelpathtracer::PathTracer pathTracer;
+		voxelpathtracer::PathTracerState &pt = pathTracer.state();
+		pt.voxelTraversal = voxelTraversal;
+		pt.params.resolution = (int)state.range(0);
+		pt.params.samples = 1 << 30;
+		pathTracer.start(_sceneGraph);
+		pathTracer.stop();
+		for (auto _ : state) {
+			if (voxelTraversal) {
+				voxelpathtracer::traceVoxelSamples(pt.state, pt.scene, pt.voxelScene, pt.lights, pt.params);
+			} else {
+				yocto::trace_samples(pt.state, pt.scene, pt.bvh, pt.lights, pt.params);
+			}
+		}
+		const int64_t pixels = (int64_t)pt.state.width * pt.state.height;
+		state.counters["samples/s"] =
+			benchmark::Counter((double)(pixels * state.iterations()), benchmark::Counter::kIsRate);
+	}
+};
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, CreateSceneMesh)(benchmark::State &state) {
+	createScene(state, false);
+}
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, CreateSceneVoxel)(benchmark::State &state) {
+	createScene(state, true);
+}
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, MoveNodeMesh)(benchmark::State &state) {
+	moveNode(state, false);
+}
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, MoveNodeVoxel)(benchmark::State &state) {
+	moveNode(state, true);
+}
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, SamplesMesh)(benchmark::State &state) {
+	traceSamples(state, false);
+}
+
+BENCHMARK_DEFINE_F(PathTracerBenchmark, SamplesVoxel)(benchmark::State &state) {
+	traceSamples(state, true);
+}
+
+BENCHMARK_REGISTER_F(PathTracerBenchmark, CreateSceneMesh)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(PathTracerBenchmark, CreateSceneVoxel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(PathTracerBenchmark, MoveNodeMesh)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(PathTracerBenchmark, MoveNodeVoxel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(PathTracerBenchmark, SamplesMesh)->Arg(128)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(PathTracerBenchmark, SamplesVoxel)->Arg(128)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
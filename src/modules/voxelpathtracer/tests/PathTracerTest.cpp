@@ -2,18 +2,29 @@
  * @file
  */
 
+#include "voxelpathtracer/BatchRenderer.h"
 #include "voxelpathtracer/PathTracer.h"
 #include "voxelpathtracer/PathTracerState.h"
+#include "voxelpathtracer/VoxelScene.h"
+#include "voxelpathtracer/VoxelTracer.h"
 #include "app/App.h"
 #include "app/tests/AbstractTest.h"
 #include "image/Image.h"
+#include "io/BufferedReadWriteStream.h"
 #include "io/FileStream.h"
+#include "io/Filesystem.h"
 #include "io/FilesystemArchive.h"
 #include "io/FormatDescription.h"
 #include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/RawVolume.h"
 #include "voxelformat/FormatConfig.h"
 #include "voxelformat/VolumeFormat.h"
 #include "core/GLM.h"
+#include <float.h>
+#include <glm/geometric.hpp>
+#include <yocto_bvh.h>
+#include <yocto_sampling.h>
 
 class PathTracerTest : public app::AbstractTest {
 private:
@@ -27,6 +38,107 @@ public:
 		voxelformat::FormatConfig::init();
 		return true;
 	}
+
+	void load(scenegraph::SceneGraph &sceneGraph) {
+		const io::ArchivePtr &archive = io::openFilesystemArchive(_testApp->filesystem());
+		io::FileDescription fileDesc;
+		fileDesc.set("hmec.vxl");
+		voxelformat::LoadContext testLoadCtx;
+		ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, testLoadCtx))
+			<< "Could not load " << fileDesc.name.c_str();
+	}
+
+	// shoot rays through both scenes and count the rays that hit something different
+	int compareScenes(const voxelpathtracer::PathTracerState &state, const voxelpathtracer::PathTracerState &reference) {
+		glm::vec3 mins;
+		glm::vec3 maxs;
+		if (reference.voxelTraversal) {
+			reference.voxelScene.bounds(mins, maxs);
+		} else {
+			const yocto::bbox3f bbox = yocto::compute_bounds(reference.scene);
+			mins = glm::vec3(bbox.min.x, bbox.min.y, bbox.min.z);
+			maxs = glm::vec3(bbox.max.x, bbox.max.y, bbox.max.z);
+		}
+		const glm::vec3 center = (mins + maxs) * 0.5f;
+		const float radius = glm::length(maxs - mins);
+		yocto::rng_state rng = yocto::make_rng(1337);
+		int mismatches = 0;
+		for (int i = 0; i < 500; ++i) {
+			const yocto::vec3f dir = yocto::sample_sphere(yocto::rand2f(rng));
+			const glm::vec3 origin = center + glm::vec3(dir.x, dir.y, dir.z) * radius;
+			const glm::vec3 target =
+				mins + (maxs - mins) * glm::vec3(yocto::rand1f(rng), yocto::rand1f(rng), yocto::rand1f(rng));
+			const glm::vec3 direction = glm::normalize(target - origin);
+			float distance = 0.0f;
+			float referenceDistance = 0.0f;
+			bool hit;
+			bool referenceHit;
+			if (state.voxelTraversal) {
+				voxelpathtracer::VoxelHit voxelHit;
+				hit = state.voxelScene.intersect(origin, direction, 0.0f, FLT_MAX, voxelHit);
+				distance = voxelHit.distance;
+				referenceHit = reference.voxelScene.intersect(origin, direction, 0.0f, FLT_MAX, voxelHit);
+				referenceDistance = voxelHit.distance;
+			} else {
+				const yocto::ray3f ray{{origin.x, origin.y, origin.z}, {direction.x, direction.y, direction.z}};
+				yocto::scene_intersection meshHit = yocto::intersect_scene_bvh(state.bvh.bvh, state.scene, ray);
+				hit = meshHit.hit;
+				distance = meshHit.distance;
+				meshHit = yocto::intersect_scene_bvh(reference.bvh.bvh, reference.scene, ray);
+				referenceHit = meshHit.hit;
+				referenceDistance = meshHit.distance;
+			}
+			if (hit != referenceHit || (hit && glm::abs(distance - referenceDistance) > 0.001f)) {
+				++mismatches;
+			}
+		}
+		return mismatches;
+	}
+
+	void incrementalUpdate(bool voxelTraversal) {
+		scenegraph::SceneGraph sceneGraph;
+		load(sceneGraph);
+
+		voxelpathtracer::PathTracer pathTracer;
+		voxelpathtracer::PathTracerState &state = pathTracer.state();
+		state.voxelTraversal = voxelTraversal;
+		state.params.resolution = 16;
+		state.params.samples = 1 << 20;
+		ASSERT_TRUE(pathTracer.start(sceneGraph));
+		const int nodes = (int)state.nodes.size();
+		ASSERT_GT(nodes, 1);
+		EXPECT_EQ(nodes, state.timings.rebuiltNodes);
+
+		// nothing was changed - the accumulated samples are kept
+		EXPECT_FALSE(pathTracer.updateScene(sceneGraph));
+
+		scenegraph::SceneGraphNode *node = sceneGraph.firstModelNode();
+		ASSERT_NE(nullptr, node);
+		scenegraph::SceneGraphTransform &transform = node->transform();
+		transform.setWorldTranslation(transform.worldTranslation() + glm::vec3(10.0f, 0.0f, 0.0f));
+		sceneGraph.updateTransforms();
+		ASSERT_TRUE(pathTracer.updateScene(sceneGraph));
+		EXPECT_EQ(0, state.timings.rebuiltNodes);
+		EXPECT_GE(state.timings.movedNodes, 1);
+		EXPECT_LT(state.timings.movedNodes, nodes);
+
+		pathTracer.nodeModified(node->uuid());
+		ASSERT_TRUE(pathTracer.updateScene(sceneGraph));
+		EXPECT_GE(state.timings.rebuiltNodes, 1);
+		EXPECT_LT(state.timings.rebuiltNodes, nodes);
+		EXPECT_EQ(0, state.timings.movedNodes);
+		ASSERT_TRUE(pathTracer.stop());
+
+		// the incrementally updated scene must match a scene that is created from scratch
+		voxelpathtracer::PathTracer reference;
+		reference.state().voxelTraversal = voxelTraversal;
+		reference.state().params.resolution = 16;
+		reference.state().params.samples = 1;
+		ASSERT_TRUE(reference.start(sceneGraph));
+		ASSERT_TRUE(reference.stop());
+		EXPECT_EQ(reference.state().scene.instances.size(), state.scene.instances.size());
+		EXPECT_EQ(0, compareScenes(state, reference.state()));
+	}
 };
 
 TEST_F(PathTracerTest, testHMec) {
@@ -55,3 +167,249 @@ TEST_F(PathTracerTest, testHMec) {
 	EXPECT_TRUE(image::writePNG(img, stream));
 	ASSERT_TRUE(pathTracer.stop());
 }
+
+TEST_F(PathTracerTest, testHMecVoxelTraversal) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracer pathTracer;
+	pathTracer.state().voxelTraversal = true;
+	pathTracer.state().params.resolution = 256;
+	pathTracer.state().params.samples = 4;
+	ASSERT_TRUE(pathTracer.start(sceneGraph));
+	while (!pathTracer.update()) {
+		_testApp->wait(100);
+	}
+	EXPECT_GT(pathTracer.state().voxelScene.instances(), 0);
+	const image::ImagePtr &img = pathTracer.image();
+	ASSERT_TRUE(img);
+	ASSERT_TRUE(img->isLoaded());
+	ASSERT_EQ(256, img->width());
+	ASSERT_TRUE(pathTracer.stop());
+}
+
+// the light sampling must not change the expected value of the image - but reduce the noise
+TEST_F(PathTracerTest, testVoxelTraversalLightSampling) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	auto render = [&](yocto::trace_sampler_type sampler, int samples, std::vector<yocto::vec4f> &image) {
+		voxelpathtracer::PathTracer pathTracer;
+		voxelpathtracer::PathTracerState &pt = pathTracer.state();
+		pt.voxelTraversal = true;
+		pt.params.resolution = 32;
+		pt.params.samples = samples;
+		pt.params.sampler = sampler;
+		pt.params.noparallel = true;
+		// a small and bright light source is where the light sampling helps
+		pt.sunDisk = true;
+		ASSERT_TRUE(pathTracer.setup(sceneGraph));
+		ASSERT_FALSE(pt.lights.lights.empty()) << "The environment must be sampled";
+		while (pt.state.samples < samples) {
+			voxelpathtracer::traceVoxelSamples(pt.state, pt.scene, pt.voxelScene, pt.lights, pt.params);
+		}
+		image = pt.state.image;
+	};
+	std::vector<yocto::vec4f> reference;
+	render(yocto::trace_sampler_type::path, 1024, reference);
+	std::vector<yocto::vec4f> naive;
+	render(yocto::trace_sampler_type::naive, 64, naive);
+	std::vector<yocto::vec4f> path;
+	render(yocto::trace_sampler_type::path, 64, path);
+
+	double referenceSum = 0.0;
+	double naiveSum = 0.0;
+	double pathSum = 0.0;
+	double naiveError = 0.0;
+	double pathError = 0.0;
+	for (size_t i = 0; i < reference.size(); ++i) {
+		const float r = yocto::mean(yocto::xyz(reference[i]));
+		const float n = yocto::mean(yocto::xyz(naive[i]));
+		const float p = yocto::mean(yocto::xyz(path[i]));
+		referenceSum += r;
+		naiveSum += n;
+		pathSum += p;
+		naiveError += (n - r) * (n - r);
+		pathError += (p - r) * (p - r);
+	}
+	EXPECT_NEAR(referenceSum, naiveSum, referenceSum * 0.05);
+	EXPECT_NEAR(referenceSum, pathSum, referenceSum * 0.05);
+	EXPECT_LT(pathError, naiveError);
+}
+
+// the voxel traversal must find the same surfaces as the triangle bvh of the meshes
+TEST_F(PathTracerTest, testVoxelTraversalMatchesMesh) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracer meshTracer;
+	meshTracer.state().params.resolution = 16;
+	meshTracer.state().params.samples = 1;
+	ASSERT_TRUE(meshTracer.start(sceneGraph));
+	ASSERT_TRUE(meshTracer.stop());
+	voxelpathtracer::PathTracer voxelTracer;
+	voxelTracer.state().voxelTraversal = true;
+	voxelTracer.state().params.resolution = 16;
+	voxelTracer.state().params.samples = 1;
+	ASSERT_TRUE(voxelTracer.start(sceneGraph));
+	ASSERT_TRUE(voxelTracer.stop());
+
+	const voxelpathtracer::PathTracerState &meshState = meshTracer.state();
+	const voxelpathtracer::VoxelScene &voxelScene = voxelTracer.state().voxelScene;
+	glm::vec3 mins;
+	glm::vec3 maxs;
+	ASSERT_TRUE(voxelScene.bounds(mins, maxs));
+	const glm::vec3 center = (mins + maxs) * 0.5f;
+	const float radius = glm::length(maxs - mins);
+
+	yocto::rng_state rng = yocto::make_rng(4711);
+	const int rays = 2000;
+	int hits = 0;
+	int mismatches = 0;
+	for (int i = 0; i < rays; ++i) {
+		const yocto::vec3f dir = yocto::sample_sphere(yocto::rand2f(rng));
+		const glm::vec3 origin = center + glm::vec3(dir.x, dir.y, dir.z) * radius;
+		const glm::vec3 target = mins + (maxs - mins) * glm::vec3(yocto::rand1f(rng), yocto::rand1f(rng), yocto::rand1f(rng));
+		const glm::vec3 direction = glm::normalize(target - origin);
+
+		const yocto::ray3f ray{{origin.x, origin.y, origin.z}, {direction.x, direction.y, direction.z}};
+		const yocto::scene_intersection meshHit = yocto::intersect_scene_bvh(meshState.bvh.bvh, meshState.scene, ray);
+		voxelpathtracer::VoxelHit voxelHit;
+		const bool hit = voxelScene.intersect(origin, direction, 0.0f, FLT_MAX, voxelHit);
+		if (hit != meshHit.hit || (hit && glm::abs(voxelHit.distance - meshHit.distance) > 0.01f)) {
+			++mismatches;
+		}
+		if (hit) {
+			++hits;
+		}
+	}
+	EXPECT_GT(hits, rays / 4);
+	// rays that graze voxel edges may be resolved differently
+	EXPECT_LE(mismatches, rays / 100) << "hits: " << hits;
+}
+
+TEST_F(PathTracerTest, testIncrementalUpdate) {
+	incrementalUpdate(false);
+}
+
+TEST_F(PathTracerTest, testIncrementalUpdateVoxelTraversal) {
+	incrementalUpdate(true);
+}
+
+TEST_F(PathTracerTest, testCamera) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracerCamera camera;
+	camera.eye = glm::vec3(0.0f, 0.0f, 100.0f);
+	camera.target = glm::vec3(0.0f);
+	camera.size = glm::ivec2(200, 100);
+	camera.focus = 100.0f;
+	voxelpathtracer::PathTracer pathTracer;
+	ASSERT_TRUE(pathTracer.setup(sceneGraph, &camera));
+	const yocto::camera_data &cam = pathTracer.state().scene.cameras.front();
+	EXPECT_FLOAT_EQ(100.0f, cam.frame.o.z);
+	EXPECT_FLOAT_EQ(1.0f, cam.frame.z.z) << "The camera must look at the target";
+	EXPECT_FLOAT_EQ(2.0f, cam.aspect);
+	EXPECT_FLOAT_EQ(100.0f, cam.focus);
+}
+
+TEST_F(PathTracerTest, testBatchRender) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracer pathTracer;
+	pathTracer.state().params.resolution = 64;
+	pathTracer.state().params.samples = 64;
+	ASSERT_TRUE(pathTracer.setup(sceneGraph));
+	voxelpathtracer::BatchRenderOptions options;
+	options.tileSize = 16;
+	options.samplesPerPass = 4;
+	options.minSamples = 8;
+	// the background tiles converge immediately
+	options.adaptiveThreshold = 0.05f;
+	voxelpathtracer::BatchRenderer renderer(pathTracer, options);
+	ASSERT_TRUE(renderer.render());
+	EXPECT_TRUE(renderer.finished());
+	EXPECT_GT(renderer.convergedTiles(), 0);
+	EXPECT_GE(renderer.minTileSamples(), options.minSamples);
+	const int pixels = pathTracer.state().state.width * pathTracer.state().state.height;
+	EXPECT_LT(renderer.totalSamples(), (uint64_t)pixels * 64u);
+	const image::ImagePtr &img = pathTracer.image();
+	ASSERT_TRUE(img);
+	ASSERT_EQ(64, img->width());
+}
+
+TEST_F(PathTracerTest, testBatchRenderResume) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracer pathTracer;
+	voxelpathtracer::PathTracerState &pt = pathTracer.state();
+	pt.params.resolution = 32;
+	pt.params.samples = 4;
+	ASSERT_TRUE(pathTracer.setup(sceneGraph));
+	voxelpathtracer::BatchRenderOptions options;
+	options.tileSize = 8;
+	options.adaptiveThreshold = 0.0f;
+	io::BufferedReadWriteStream checkpoint;
+	{
+		voxelpathtracer::BatchRenderer renderer(pathTracer, options);
+		ASSERT_TRUE(renderer.render());
+		EXPECT_EQ(4, renderer.minTileSamples());
+		ASSERT_TRUE(renderer.saveCheckpoint(checkpoint));
+	}
+	const yocto::vec4f color = pt.state.image[pt.state.width * pt.state.height / 2];
+
+	// restore the checkpoint and continue with a higher sample budget
+	pt.params.samples = 8;
+	options.checkpointFile = _testApp->filesystem()->homeWritePath("batchrender.checkpoint");
+	ASSERT_TRUE(io::Filesystem::sysWrite(options.checkpointFile, checkpoint.getBuffer(), (size_t)checkpoint.size()));
+	checkpoint.seek(0);
+	voxelpathtracer::BatchRenderer renderer(pathTracer, options);
+	ASSERT_TRUE(renderer.loadCheckpoint(checkpoint));
+	EXPECT_EQ(4, renderer.minTileSamples());
+	EXPECT_EQ(color.x, pt.state.image[pt.state.width * pt.state.height / 2].x);
+	ASSERT_TRUE(renderer.render());
+	EXPECT_TRUE(renderer.finished());
+	EXPECT_EQ(8, renderer.minTileSamples());
+	EXPECT_EQ((uint64_t)pt.state.width * pt.state.height * 8u, renderer.totalSamples());
+	// a finished render removes its checkpoint
+	EXPECT_FALSE(io::Filesystem::sysExists(options.checkpointFile));
+}
+
+TEST_F(PathTracerTest, testBatchRenderResumeChangedScene) {
+	scenegraph::SceneGraph sceneGraph;
+	load(sceneGraph);
+
+	voxelpathtracer::PathTracer pathTracer;
+	voxelpathtracer::PathTracerState &pt = pathTracer.state();
+	pt.params.resolution = 32;
+	pt.params.samples = 4;
+	ASSERT_TRUE(pathTracer.setup(sceneGraph));
+	voxelpathtracer::BatchRenderOptions options;
+	options.tileSize = 8;
+	options.adaptiveThreshold = 0.0f;
+	voxelpathtracer::BatchRenderer renderer(pathTracer, options);
+	ASSERT_TRUE(renderer.render());
+	io::BufferedReadWriteStream checkpoint;
+	ASSERT_TRUE(renderer.saveCheckpoint(checkpoint));
+	checkpoint.seek(0);
+	ASSERT_TRUE(renderer.loadCheckpoint(checkpoint));
+
+	// the camera was moved
+	pt.scene.cameras[pt.params.camera].frame.o.x += 1.0f;
+	checkpoint.seek(0);
+	EXPECT_FALSE(renderer.loadCheckpoint(checkpoint));
+	pt.scene.cameras[pt.params.camera].frame.o.x -= 1.0f;
+
+	// the voxels were modified
+	scenegraph::SceneGraphNode *node = sceneGraph.firstModelNode();
+	ASSERT_NE(nullptr, node);
+	voxel::RawVolume *volume = node->volume();
+	const glm::ivec3 &pos = volume->region().getLowerCorner();
+	const bool air = voxel::isAir(volume->voxel(pos).getMaterial());
+	volume->setVoxel(pos, air ? voxel::createVoxel(voxel::VoxelType::Generic, 1) : voxel::Voxel());
+	checkpoint.seek(0);
+	EXPECT_FALSE(renderer.loadCheckpoint(checkpoint));
+}
@@ -204,6 +204,7 @@ static void saveOptionsMesh(const io::FormatDescription *desc) {
 	if (*desc == voxelformat::GLTFFormat::format()) {
 		ImGui::CheckboxVar(						   cfg::VoxformatGLTF_KHR_materials_pbrSpecularGlossiness);
 		ImGui::CheckboxVar(cfg::VoxformatGLTF_KHR_materials_specular);
+		ImGui::CheckboxVar(cfg::VoxformatGLTFStreaming);
 	}
 	ImGui::CheckboxVar(cfg::VoxformatWithMaterials);
 
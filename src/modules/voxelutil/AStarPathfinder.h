@@ -5,10 +5,13 @@
 #pragma once
 
 #include "AStarPathfinderImpl.h"
+#include "NavigationGrid.h"
+#include "app/ForParallel.h"
 #include "core/Common.h"
 #include "core/Assert.h"
 #include "core/GLM.h"
 #include "core/Log.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/List.h"
 #include "voxel/Connectivity.h"
 #include <glm/gtc/constants.hpp>
@@ -84,6 +87,28 @@ public:
 	/// end node. This progress value is guaranteed to never decrease, but it may stop increasing
 	/// for short periods of time. It may even stop increasing altogether if a path cannot be found.
 	core::Function<void(float)> progressCallback;
+
+	/// Optional navigation grid that was built with the same rules as isVoxelValidForPath and the same
+	/// connectivity. The path is searched on the clusters of the grid first - and the voxel search afterwards
+	/// only visits the voxels of the clusters along that path. This replaces isVoxelValidForPath, allows
+	/// much longer paths with the same maxNumberOfNodes and the grid can be shared between several queries.
+	/// The found path is not guaranteed to be the shortest one.
+	const NavigationGrid* navigation = nullptr;
+
+	/// The maximum number of components of the navigation grid that are considered when searching the
+	/// clusters along the path. A component covers up to a whole cluster - so this is a different budget
+	/// than maxNumberOfNodes.
+	uint32_t maxNumberOfComponents = 10000;
+};
+
+/**
+ * @brief A single path query for findPaths()
+ */
+struct AStarPathQuery {
+	glm::ivec3 start{0};
+	glm::ivec3 end{0};
+	core::List<glm::ivec3> result;
+	bool found = false;
 };
 
 /**
@@ -118,6 +143,7 @@ public:
 	bool execute();
 
 private:
+	bool isValid(const glm::ivec3& pos) const;
 	void processNeighbour(const glm::ivec3& neighbourPos, float neighbourGVal);
 
 	float SixConnectedCost(const glm::ivec3& a, const glm::ivec3& b);
@@ -129,7 +155,9 @@ private:
 	// Node containers
 	AllNodesContainer _allNodes;
 	OpenNodesContainer _openNodes;
-	ClosedNodesContainer _closedNodes;
+
+	// The components of the navigation grid the path may pass
+	NavigationGrid::Corridor _corridor;
 
 	// The current node
 	AllNodesContainer::iterator _current;
@@ -152,11 +180,19 @@ bool AStarPathfinder<VolumeType>::execute() {
 	//Clear any existing nodes
 	_allNodes.clear();
 	_openNodes.clear();
-	_closedNodes.clear();
 
 	//Clear the result
 	_params.result->clear();
 
+	if (_params.navigation != nullptr) {
+		core_assert_msg(_params.navigation->connectivity() == _params.connectivity,
+						"The navigation grid was built with a different connectivity");
+		if (!_params.navigation->corridor(_params.start, _params.end, _corridor, _params.maxNumberOfComponents)) {
+			Log::debug("There is no connection in the navigation grid.");
+			return false;
+		}
+	}
+
 	//Iterators to start and end node.
 	AllNodesContainer::iterator startNode = _allNodes.insert(Node(_params.start.x, _params.start.y, _params.start.z)).first;
 	AllNodesContainer::iterator endNode = _allNodes.insert(Node(_params.end.x, _params.end.y, _params.end.z)).first;
@@ -185,7 +221,7 @@ bool AStarPathfinder<VolumeType>::execute() {
 		//Move the first node from open to closed.
 		_current = _openNodes.getFirst();
 		_openNodes.removeFirst();
-		_closedNodes.insert(_current);
+		const_cast<Node*>(&(*_current))->closed = true;
 
 		//Update the user on our progress
 		if (_params.progressCallback) {
@@ -271,10 +307,17 @@ bool AStarPathfinder<VolumeType>::execute() {
 	return true;
 }
 
+template<typename VolumeType>
+bool AStarPathfinder<VolumeType>::isValid(const glm::ivec3& pos) const {
+	if (_params.navigation != nullptr) {
+		return _corridor.has(_params.navigation->componentKey(pos));
+	}
+	return _params.isVoxelValidForPath(_params.volume, pos);
+}
+
 template<typename VolumeType>
 void AStarPathfinder<VolumeType>::processNeighbour(const glm::ivec3& neighbourPos, float neighbourGVal) {
-	bool bIsVoxelValidForPath = _params.isVoxelValidForPath(_params.volume, neighbourPos);
-	if (!bIsVoxelValidForPath) {
+	if (!isValid(neighbourPos)) {
 		return;
 	}
 
@@ -283,37 +326,27 @@ void AStarPathfinder<VolumeType>::processNeighbour(const glm::ivec3& neighbourPo
 	std::pair<AllNodesContainer::iterator, bool> insertResult = _allNodes.insert(Node(neighbourPos.x, neighbourPos.y, neighbourPos.z));
 	AllNodesContainer::iterator neighbour = insertResult.first;
 
+	//Regarding the const_cast - normally you should not modify an object which is in an std::set.
+	//The reason is that objects in a set are stored sorted in a tree so they can be accessed quickly,
+	//and changing the object directly can break the sorting. However, in our case we have provided a
+	//custom sort operator for the set which we know only uses the position to sort. Hence we can safely
+	//modify other properties of the object while it is in the set.
+	Node* temp = const_cast<Node*>(&(*neighbour));
 	if (insertResult.second) {
 		//New node, compute h.
-		Node* tempNeighbour = const_cast<Node*>(&(*neighbour));
-		tempNeighbour->hVal = computeH(neighbour->position, _params.end);
+		temp->hVal = computeH(neighbour->position, _params.end);
 	}
 
-	OpenNodesContainer::iterator openIter = _openNodes.find(neighbour);
-	if (openIter != _openNodes.end()) {
-		if (cost < neighbour->gVal) {
-			_openNodes.remove(openIter);
-			openIter = _openNodes.end();
-		}
+	if (neighbour->open && cost < neighbour->gVal) {
+		_openNodes.remove(neighbour);
 	}
 
-	//TODO - Nodes could keep track of if they are in open or closed? And a pointer to where they are?
-	ClosedNodesContainer::iterator closedIter = _closedNodes.find(neighbour);
-	if (closedIter != _closedNodes.end()) {
-		if (cost < neighbour->gVal) {
-			//Probably shouldn't happen?
-			_closedNodes.remove(closedIter);
-			closedIter = _closedNodes.end();
-		}
+	if (neighbour->closed && cost < neighbour->gVal) {
+		//Probably shouldn't happen?
+		temp->closed = false;
 	}
 
-	if (openIter == _openNodes.end() && closedIter == _closedNodes.end()) {
-		//Regarding the const_cast - normally you should not modify an object which is in an std::set.
-		//The reason is that objects in a set are stored sorted in a tree so they can be accessed quickly,
-		//and changing the object directly can break the sorting. However, in our case we have provided a
-		//custom sort operator for the set which we know only uses the position to sort. Hence we can safely
-		//modify other properties of the object while it is in the set.
-		Node* temp = const_cast<Node*>(&(*neighbour));
+	if (!neighbour->open && !neighbour->closed) {
 		temp->gVal = cost;
 		_openNodes.insert(neighbour);
 		temp->parent = const_cast<Node*>(&(*_current));
@@ -431,4 +464,27 @@ uint32_t AStarPathfinder<VolumeType>::hash(uint32_t a) {
 	return a;
 }
 
+/**
+ * @brief Execute the given queries in parallel
+ *
+ * @param params The configuration for all queries - the start, the end and the result are taken from the queries.
+ * The progress callback is not used.
+ * @note The volume, the navigation grid and the isVoxelValidForPath function are used from several threads
+ */
+template<typename VolumeType>
+void findPaths(const AStarPathfinderParams<VolumeType>& params, core::DynamicArray<AStarPathQuery>& queries) {
+	app::for_parallel(0, (int)queries.size(), [&params, &queries](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			AStarPathQuery& query = queries[i];
+			AStarPathfinderParams<VolumeType> queryParams(params);
+			queryParams.start = query.start;
+			queryParams.end = query.end;
+			queryParams.result = &query.result;
+			queryParams.progressCallback = nullptr;
+			AStarPathfinder<VolumeType> pathfinder(queryParams);
+			query.found = pathfinder.execute();
+		}
+	});
+}
+
 }
@@ -13,13 +13,11 @@
 
 namespace voxelutil {
 
-class OpenNodesContainer;
-class ClosedNodesContainer;
-
 struct Node {
 	Node(int x, int y, int z) :
 			// Initialise with NaNs so that we will know if we forget to set these properly.
-			gVal(std::numeric_limits<float>::quiet_NaN()), hVal(std::numeric_limits<float>::quiet_NaN()), parent(nullptr) {
+			gVal(std::numeric_limits<float>::quiet_NaN()), hVal(std::numeric_limits<float>::quiet_NaN()), parent(nullptr),
+			open(false), closed(false) {
 		position = {x, y, z};
 	}
 
@@ -50,6 +48,9 @@ struct Node {
 	float gVal;
 	float hVal;
 	Node* parent;
+	// Tracking the state in the node itself saves the lookups in the open and closed containers
+	bool open;
+	bool closed;
 
 	inline float f() const {
 		return gVal + hVal;
@@ -58,95 +59,74 @@ struct Node {
 
 typedef std::set<Node> AllNodesContainer;
 
-class AllNodesContainerIteratorComparator {
-public:
-	bool operator()(const AllNodesContainer::iterator& lhs, const AllNodesContainer::iterator& rhs) const {
-		return (&(*lhs)) < (&(*rhs));
+/**
+ * @brief Binary heap of the open nodes
+ *
+ * Nodes are not removed from the heap directly - they are just flagged. Entries of nodes that were removed or inserted
+ * again with a lower cost are dropped once they reach the top of the heap.
+ */
+class OpenNodesContainer {
+private:
+	struct Entry {
+		AllNodesContainer::iterator node;
+		float f;
+	};
+
+	struct EntrySort {
+		bool operator()(const Entry& lhs, const Entry& rhs) const {
+			return lhs.f > rhs.f;
+		}
+	};
+
+	std::vector<Entry> open;
+
+	static inline Node* mutableNode(AllNodesContainer::iterator node) {
+		// only the position is used to sort the nodes in the set - see AStarPathfinder
+		return const_cast<Node*>(&(*node));
 	}
-};
 
-class NodeSort {
-public:
-	bool operator()(const AllNodesContainer::iterator& lhs, const AllNodesContainer::iterator& rhs) const {
-		return lhs->f() > rhs->f();
+	inline bool isStale(const Entry& entry) const {
+		return !entry.node->open || entry.node->f() != entry.f;
 	}
-};
 
-class OpenNodesContainer {
-public:
-	typedef std::vector<AllNodesContainer::iterator>::iterator iterator;
+	void pruneStale() {
+		while (!open.empty() && isStale(open.front())) {
+			std::pop_heap(open.begin(), open.end(), EntrySort());
+			open.pop_back();
+		}
+	}
 
 public:
 	inline void clear() {
 		open.clear();
 	}
 
-	inline bool empty() const {
+	inline bool empty() {
+		pruneStale();
 		return open.empty();
 	}
 
 	void insert(AllNodesContainer::iterator node) {
-		open.push_back(node);
-		std::push_heap(open.begin(), open.end(), NodeSort());
+		mutableNode(node)->open = true;
+		open.push_back({node, node->f()});
+		std::push_heap(open.begin(), open.end(), EntrySort());
 	}
 
 	inline AllNodesContainer::iterator getFirst() {
-		return open[0];
+		pruneStale();
+		return open[0].node;
 	}
 
 	void removeFirst() {
-		std::pop_heap(open.begin(), open.end(), NodeSort());
+		pruneStale();
+		mutableNode(open[0].node)->open = false;
+		std::pop_heap(open.begin(), open.end(), EntrySort());
 		open.pop_back();
 	}
 
-	void remove(iterator iterToRemove) {
-		open.erase(iterToRemove);
-		std::make_heap(open.begin(), open.end(), NodeSort());
-	}
-
-	inline iterator begin() {
-		return open.begin();
-	}
-
-	inline iterator end() {
-		return open.end();
-	}
-
-	iterator find(AllNodesContainer::iterator node) {
-		return std::find(open.begin(), open.end(), node);
-	}
-
-private:
-	std::vector<AllNodesContainer::iterator> open;
-};
-
-class ClosedNodesContainer {
-public:
-	typedef std::set<AllNodesContainer::iterator, AllNodesContainerIteratorComparator>::iterator iterator;
-
-public:
-	inline void clear() {
-		closed.clear();
-	}
-
-	inline void insert(AllNodesContainer::iterator node) {
-		closed.insert(node);
-	}
-
-	inline void remove(iterator iterToRemove) {
-		closed.erase(iterToRemove);
-	}
-
-	inline iterator end() {
-		return closed.end();
-	}
-
-	inline iterator find(AllNodesContainer::iterator node) {
-		return closed.find(node);
+	inline void remove(AllNodesContainer::iterator node) {
+		mutableNode(node)->open = false;
 	}
-
-private:
-	std::set<AllNodesContainer::iterator, AllNodesContainerIteratorComparator> closed;
 };
 
 }
@@ -0,0 +1,210 @@
+/**
+ * @file
+ */
+
+#include "ConnectedComponents.h"
+#include "app/ForParallel.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "voxel/BitVolume.h"
+#include "voxelutil/FloodFill.h"
+
+namespace voxelutil {
+
+namespace {
+
+// the slabs are labeled in parallel - this is the max amount of slabs along the z axis
+constexpr int MaxSlabs = 32;
+
+struct Slab {
+	int zStart = 0;
+	int zEnd = 0;
+	// the first provisional label of this slab - the labels of different slabs never overlap
+	uint32_t base = 0u;
+	// the index of the first component of this slab in the union-find
+	size_t offset = 0u;
+	core::DynamicArray<voxel::Region> regions;
+
+	inline uint32_t dense(uint32_t label) const {
+		return (uint32_t)(offset + (label - base));
+	}
+};
+
+uint32_t findRoot(core::Buffer<uint32_t> &parents, uint32_t i) {
+	while (parents[i] != i) {
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+
+// the root is always the smaller index - this is the component that was found first
+void unite(core::Buffer<uint32_t> &parents, uint32_t a, uint32_t b) {
+	a = findRoot(parents, a);
+	b = findRoot(parents, b);
+	if (a < b) {
+		parents[b] = a;
+	} else if (b < a) {
+		parents[a] = b;
+	}
+}
+
+} // namespace
+
+int labelComponents(const voxel::BitVolume &mask, ConnectedComponents &components, voxel::Connectivity connectivity) {
+	core_trace_scoped(LabelComponents);
+	const voxel::Region &region = mask.region();
+	components.region = region;
+	components.regions.clear();
+	components.labels.clear();
+	if (!region.isValid()) {
+		return 0;
+	}
+	const int64_t voxels = region.voxels();
+	if (voxels >= (int64_t)UINT32_MAX) {
+		Log::error("Region %s is too big to label the connected components", region.toString().c_str());
+		return 0;
+	}
+	components.labels.resize((size_t)voxels);
+
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const int depth = region.getDepthInVoxels();
+	const int slabDepth = (depth + core_min(depth, MaxSlabs) - 1) / core_min(depth, MaxSlabs);
+	const int slabCount = (depth + slabDepth - 1) / slabDepth;
+	core::DynamicArray<Slab> slabs;
+	slabs.resize(slabCount);
+	for (int s = 0; s < slabCount; ++s) {
+		Slab &slab = slabs[s];
+		slab.zStart = mins.z + s * slabDepth;
+		slab.zEnd = core_min(maxs.z, slab.zStart + slabDepth - 1);
+		slab.base = (uint32_t)region.index(mins.x, mins.y, slab.zStart) + 1u;
+	}
+
+	const core::DynamicBitSet &maskBits = mask.data();
+	uint32_t *labels = components.labels.data();
+	auto isMask = [&region, &maskBits](int x, int y, int z) { return maskBits[region.index(x, y, z)]; };
+	auto isReached = [&region, labels](int x, int y, int z) { return labels[region.index(x, y, z)] != 0u; };
+
+	auto labelSlabs = [&](int start, int end) {
+		core::DynamicArray<glm::ivec3> work;
+		for (int s = start; s < end; ++s) {
+			Slab &slab = slabs[s];
+			const voxel::Region slabRegion(mins.x, mins.y, slab.zStart, maxs.x, maxs.y, slab.zEnd);
+			const int64_t first = region.index(mins.x, mins.y, slab.zStart);
+			const int64_t last = region.index(maxs.x, maxs.y, slab.zEnd);
+			core_memset(labels + first, 0, (size_t)(last - first + 1) * sizeof(uint32_t));
+			uint32_t current = 0u;
+			size_t currentRegion = 0u;
+			auto mark = [&](int x0, int x1, int y, int z) {
+				const int64_t idx = region.index(x0, y, z);
+				for (int i = 0; i <= x1 - x0; ++i) {
+					labels[idx + i] = current;
+				}
+				voxel::Region &componentRegion = slab.regions[currentRegion];
+				componentRegion.accumulate(x0, y, z);
+				componentRegion.accumulate(x1, y, z);
+			};
+			for (int64_t idx = first; idx <= last; ++idx) {
+				// skip whole words of empty mask bits
+				if ((idx & 63) == 0 && idx + 63 <= last && maskBits.word((size_t)idx / 64) == 0u) {
+					idx += 63;
+					continue;
+				}
+				if (!maskBits[idx] || labels[idx] != 0u) {
+					continue;
+				}
+				const glm::ivec3 &pos = region.fromIndex(idx);
+				current = slab.base + (uint32_t)slab.regions.size();
+				currentRegion = slab.regions.size();
+				slab.regions.push_back(voxel::Region(pos, pos));
+				work.push_back(pos);
+				priv::floodFillSpans(slabRegion, isMask, isReached, mark, work, connectivity);
+			}
+		}
+	};
+	app::for_parallel(0, slabCount, labelSlabs);
+
+	size_t provisional = 0u;
+	for (Slab &slab : slabs) {
+		slab.offset = provisional;
+		provisional += slab.regions.size();
+	}
+	core::Buffer<uint32_t> parents(provisional);
+	for (size_t i = 0; i < provisional; ++i) {
+		parents[i] = (uint32_t)i;
+	}
+
+	// merge the components that touch each other across the slab borders
+	for (int s = 1; s < slabCount; ++s) {
+		const Slab &slab = slabs[s];
+		const Slab &prev = slabs[s - 1];
+		const int z = slab.zStart;
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				const uint32_t label = labels[region.index(x, y, z)];
+				if (label == 0u) {
+					continue;
+				}
+				for (int dy = -1; dy <= 1; ++dy) {
+					const int ny = y + dy;
+					if (ny < mins.y || ny > maxs.y) {
+						continue;
+					}
+					for (int dx = -1; dx <= 1; ++dx) {
+						const int nx = x + dx;
+						if (nx < mins.x || nx > maxs.x) {
+							continue;
+						}
+						if (connectivity == voxel::Connectivity::SixConnected && (dx != 0 || dy != 0)) {
+							continue;
+						}
+						if (connectivity == voxel::Connectivity::EighteenConnected && dx != 0 && dy != 0) {
+							continue;
+						}
+						const uint32_t neighbour = labels[region.index(nx, ny, z - 1)];
+						if (neighbour != 0u) {
+							unite(parents, slab.dense(label), prev.dense(neighbour));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// assign the final labels in the order the components were found
+	core::Buffer<uint32_t> compact(provisional);
+	uint32_t i = 0u;
+	for (const Slab &slab : slabs) {
+		for (const voxel::Region &componentRegion : slab.regions) {
+			const uint32_t root = findRoot(parents, i);
+			if (root == i) {
+				components.regions.push_back(componentRegion);
+				compact[i] = (uint32_t)components.regions.size();
+			} else {
+				compact[i] = compact[root];
+				components.regions[compact[i] - 1].accumulate(componentRegion);
+			}
+			++i;
+		}
+	}
+
+	auto relabel = [&](int start, int end) {
+		for (int s = start; s < end; ++s) {
+			const Slab &slab = slabs[s];
+			const int64_t first = region.index(mins.x, mins.y, slab.zStart);
+			const int64_t last = region.index(maxs.x, maxs.y, slab.zEnd);
+			for (int64_t idx = first; idx <= last; ++idx) {
+				if (labels[idx] != 0u) {
+					labels[idx] = compact[slab.dense(labels[idx])];
+				}
+			}
+		}
+	};
+	app::for_parallel(0, slabCount, relabel);
+
+	return components.count();
+}
+
+} // namespace voxelutil
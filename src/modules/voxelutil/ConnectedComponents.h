@@ -0,0 +1,58 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Connectivity.h"
+#include "voxel/Region.h"
+#include <stdint.h>
+
+namespace voxel {
+class BitVolume;
+}
+
+namespace voxelutil {
+
+/**
+ * @brief The result of @c labelComponents()
+ */
+struct ConnectedComponents {
+	voxel::Region region = voxel::Region::InvalidRegion;
+	/**
+	 * @brief One label per voxel of the region (indexed by @c Region::index()) - @c 0 means the voxel is not part of
+	 * any component. The components are numbered from @c 1 in the order of their first voxel in the region.
+	 */
+	core::Buffer<uint32_t> labels;
+	/**
+	 * @brief The bounding box of each component - indexed by @c label-1
+	 */
+	core::DynamicArray<voxel::Region> regions;
+
+	inline int count() const {
+		return (int)regions.size();
+	}
+
+	inline uint32_t label(int x, int y, int z) const {
+		if (!region.containsPoint(x, y, z)) {
+			return 0u;
+		}
+		return labels[region.index(x, y, z)];
+	}
+};
+
+/**
+ * @brief Label the connected components of the voxels that are set in the given mask.
+ *
+ * The region is split into slabs along the z axis that are labeled in parallel with a span based flood fill. The
+ * components that touch each other across the slab borders are merged with a union-find afterwards.
+ *
+ * @note The region may not contain more than @c UINT32_MAX voxels
+ * @return The amount of components that were found
+ */
+int labelComponents(const voxel::BitVolume &mask, ConnectedComponents &components,
+					voxel::Connectivity connectivity = voxel::Connectivity::SixConnected);
+
+} // namespace voxelutil
@@ -0,0 +1,360 @@
+/**
+ * @file
+ * @brief Span based flood fill on top of @c voxel::BitVolume
+ *
+ * The flood fill doesn't recurse and doesn't use hash sets to remember the visited voxels. It operates on horizontal
+ * spans (along the x axis) and keeps the start positions of the not yet visited spans on an explicit work list. The
+ * visited state is stored with one bit per voxel.
+ */
+
+#pragma once
+
+#include "app/ForParallel.h"
+#include "core/Assert.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include "voxel/BitVolume.h"
+#include "voxel/Connectivity.h"
+#include "voxel/Region.h"
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxelutil {
+
+namespace priv {
+
+/**
+ * @brief Process the work list of span seeds until it's empty
+ *
+ * @param[in] region The bounds the flood fill is not allowed to leave
+ * @param[in] mask Callable(x, y, z) -> bool - @c true if the flood fill may enter the voxel
+ * @param[in] reached Callable(x, y, z) -> bool - @c true if the voxel was already visited
+ * @param[in] mark Callable(x0, x1, y, z) - marks the span [x0, x1] as visited
+ * @return The amount of voxels that were marked
+ */
+template<class Mask, class Reached, class Mark>
+int64_t floodFillSpans(const voxel::Region &region, const Mask &mask, const Reached &reached, const Mark &mark,
+					   core::DynamicArray<glm::ivec3> &work, voxel::Connectivity connectivity) {
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	int64_t n = 0;
+	while (!work.empty()) {
+		const glm::ivec3 p = work.back();
+		work.pop();
+		if (!region.containsPoint(p) || reached(p.x, p.y, p.z) || !mask(p.x, p.y, p.z)) {
+			continue;
+		}
+		int x0 = p.x;
+		while (x0 > mins.x && !reached(x0 - 1, p.y, p.z) && mask(x0 - 1, p.y, p.z)) {
+			--x0;
+		}
+		int x1 = p.x;
+		while (x1 < maxs.x && !reached(x1 + 1, p.y, p.z) && mask(x1 + 1, p.y, p.z)) {
+			++x1;
+		}
+		mark(x0, x1, p.y, p.z);
+		n += x1 - x0 + 1;
+
+		// the neighbouring rows - for diagonal neighbours along x the span is extended by one voxel
+		for (int dz = -1; dz <= 1; ++dz) {
+			const int z = p.z + dz;
+			if (z < mins.z || z > maxs.z) {
+				continue;
+			}
+			for (int dy = -1; dy <= 1; ++dy) {
+				if (dy == 0 && dz == 0) {
+					continue;
+				}
+				const int y = p.y + dy;
+				if (y < mins.y || y > maxs.y) {
+					continue;
+				}
+				const bool edge = dy != 0 && dz != 0;
+				int extend = 1;
+				if (connectivity == voxel::Connectivity::SixConnected) {
+					if (edge) {
+						continue;
+					}
+					extend = 0;
+				} else if (connectivity == voxel::Connectivity::EighteenConnected && edge) {
+					extend = 0;
+				}
+				const int startX = glm::max(mins.x, x0 - extend);
+				const int endX = glm::min(maxs.x, x1 + extend);
+				bool inSpan = false;
+				for (int x = startX; x <= endX; ++x) {
+					if (!reached(x, y, z) && mask(x, y, z)) {
+						if (!inSpan) {
+							work.emplace_back(x, y, z);
+							inSpan = true;
+						}
+					} else {
+						inSpan = false;
+					}
+				}
+			}
+		}
+	}
+	return n;
+}
+
+/**
+ * @brief Sparse set of the visited voxels with one bit per voxel
+ *
+ * The bits are allocated in bricks of 8x8x8 voxels - and only for the bricks that were reached. The memory depends on
+ * the reached area and not on the size of the region. The last brick is cached, as the spans are mostly inside the
+ * same brick.
+ */
+class SparseReachedSet {
+private:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickMask = (1 << BrickShift) - 1;
+	static constexpr uint64_t InvalidKey = ~(uint64_t)0;
+	struct Brick {
+		uint64_t bits[8]{};
+	};
+	glm::ivec3 _mins;
+	core::DynamicMap<uint64_t, int, 1031> _lookup;
+	core::Buffer<Brick> _bricks;
+	uint64_t _lastKey = InvalidKey;
+	int _lastBrick = -1;
+
+	inline uint64_t key(const glm::ivec3 &local) const {
+		const glm::ivec3 brick = local >> BrickShift;
+		return ((uint64_t)brick.z << 42) | ((uint64_t)brick.y << 21) | (uint64_t)brick.x;
+	}
+
+	static inline int bit(const glm::ivec3 &local) {
+		return ((local.z & BrickMask) << (2 * BrickShift)) | ((local.y & BrickMask) << BrickShift) | (local.x & BrickMask);
+	}
+
+	int brick(uint64_t k, bool create) {
+		if (k == _lastKey) {
+			return _lastBrick;
+		}
+		auto iter = _lookup.find(k);
+		int idx = -1;
+		if (iter != _lookup.end()) {
+			idx = iter->value;
+		} else if (create) {
+			idx = (int)_bricks.size();
+			_bricks.push_back(Brick());
+			_lookup.put(k, idx);
+		} else {
+			return -1;
+		}
+		_lastKey = k;
+		_lastBrick = idx;
+		return idx;
+	}
+
+public:
+	SparseReachedSet(const voxel::Region &region) : _mins(region.getLowerCorner()) {
+	}
+
+	bool test(int x, int y, int z) {
+		const glm::ivec3 local = glm::ivec3(x, y, z) - _mins;
+		const int idx = brick(key(local), false);
+		if (idx == -1) {
+			return false;
+		}
+		const int b = bit(local);
+		return (_bricks[idx].bits[b >> 6] >> (b & 63)) & 1u;
+	}
+
+	void set(int x, int y, int z) {
+		const glm::ivec3 local = glm::ivec3(x, y, z) - _mins;
+		const int idx = brick(key(local), true);
+		const int b = bit(local);
+		_bricks[idx].bits[b >> 6] |= (uint64_t)1 << (b & 63);
+	}
+};
+
+} // namespace priv
+
+/**
+ * @brief Flood fill from the given seed and call the visitor for every reached voxel
+ *
+ * The visited voxels are remembered in a sparse set - this is meant for selections and other local fills in large
+ * volumes. Use @c floodFill() with a @c voxel::BitVolume if most of the region is going to be reached.
+ *
+ * @param[in] region The bounds of the flood fill
+ * @param[in] mask Callable(x, y, z) -> bool - @c true if the flood fill may enter the voxel
+ * @param[in] visitor Callable(x, y, z) - called exactly once for every reached voxel (including the seed)
+ * @return The amount of reached voxels
+ */
+template<class Mask, class Visitor>
+int64_t visitFloodFill(const voxel::Region &region, const Mask &mask, const glm::ivec3 &seed, Visitor &&visitor,
+					   voxel::Connectivity connectivity = voxel::Connectivity::SixConnected) {
+	if (!region.containsPoint(seed)) {
+		return 0;
+	}
+	priv::SparseReachedSet reached(region);
+	auto isReached = [&reached](int x, int y, int z) { return reached.test(x, y, z); };
+	auto mark = [&reached, &visitor](int x0, int x1, int y, int z) {
+		for (int x = x0; x <= x1; ++x) {
+			reached.set(x, y, z);
+			visitor(x, y, z);
+		}
+	};
+	core::DynamicArray<glm::ivec3> work;
+	work.push_back(seed);
+	return priv::floodFillSpans(region, mask, isReached, mark, work, connectivity);
+}
+
+/**
+ * @brief Flood fill the voxels that are set in @p mask starting at @p seed
+ *
+ * @param[out] reached Receives all voxels that were reached. Must have the same region as the mask. Already set
+ * voxels are treated as visited - this allows to run several flood fills into the same target.
+ * @return The amount of newly reached voxels
+ */
+inline int64_t floodFill(const voxel::BitVolume &mask, const glm::ivec3 &seed, voxel::BitVolume &reached,
+						 voxel::Connectivity connectivity = voxel::Connectivity::SixConnected) {
+	const voxel::Region &region = mask.region();
+	core_assert(region == reached.region());
+	const core::DynamicBitSet &maskBits = mask.data();
+	core::DynamicBitSet &reachedBits = reached.data();
+	auto isMask = [&region, &maskBits](int x, int y, int z) { return maskBits[region.index(x, y, z)]; };
+	auto isReached = [&region, &reachedBits](int x, int y, int z) { return reachedBits[region.index(x, y, z)]; };
+	auto mark = [&region, &reachedBits](int x0, int x1, int y, int z) {
+		const int64_t idx = region.index(x0, y, z);
+		for (int x = 0; x <= x1 - x0; ++x) {
+			reachedBits.set(idx + x, true);
+		}
+	};
+	core::DynamicArray<glm::ivec3> work;
+	work.push_back(seed);
+	return priv::floodFillSpans(region, isMask, isReached, mark, work, connectivity);
+}
+
+/**
+ * @brief Flood fill the voxels that are set in @p mask starting at every mask voxel on the border of the region.
+ *
+ * This is e.g. used to find the outside air of a volume.
+ * @return The amount of newly reached voxels
+ */
+inline int64_t floodFillFromBorder(const voxel::BitVolume &mask, voxel::BitVolume &reached,
+								   voxel::Connectivity connectivity = voxel::Connectivity::SixConnected) {
+	const voxel::Region &region = mask.region();
+	if (!region.isValid()) {
+		return 0;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	int64_t n = 0;
+	auto seed = [&](int x, int y, int z) {
+		if (mask.hasValue(x, y, z) && !reached.hasValue(x, y, z)) {
+			n += floodFill(mask, glm::ivec3(x, y, z), reached, connectivity);
+		}
+	};
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			if (z == mins.z || z == maxs.z || y == mins.y || y == maxs.y) {
+				for (int x = mins.x; x <= maxs.x; ++x) {
+					seed(x, y, z);
+				}
+			} else {
+				seed(mins.x, y, z);
+				seed(maxs.x, y, z);
+			}
+		}
+	}
+	return n;
+}
+
+/**
+ * @brief Call the visitor for every voxel that is set in the given bit volume. Words without any bit set are skipped.
+ * @return The amount of visited voxels
+ */
+template<class Visitor>
+int64_t visitBitVolume(const voxel::BitVolume &bits, Visitor &&visitor) {
+	const voxel::Region &region = bits.region();
+	if (!region.isValid()) {
+		return 0;
+	}
+	const core::DynamicBitSet &data = bits.data();
+	const int64_t width = region.getWidthInVoxels();
+	const int64_t stride = width * region.getHeightInVoxels();
+	const int64_t total = (int64_t)data.bits();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	int64_t n = 0;
+	const size_t words = data.words();
+	for (size_t w = 0; w < words; ++w) {
+		core::DynamicBitSet::Type word = data.word(w);
+		const int64_t base = (int64_t)w * 64;
+		while (word != 0u) {
+			int bit = 0;
+			while ((word & ((core::DynamicBitSet::Type)1 << bit)) == 0u) {
+				++bit;
+			}
+			word &= ~((core::DynamicBitSet::Type)1 << bit);
+			const int64_t idx = base + bit;
+			if (idx >= total) {
+				break;
+			}
+			const int z = (int)(idx / stride);
+			const int64_t plane = idx - (int64_t)z * stride;
+			const int y = (int)(plane / width);
+			const int x = (int)(plane - (int64_t)y * width);
+			visitor(mins.x + x, mins.y + y, mins.z + z);
+			++n;
+		}
+	}
+	return n;
+}
+
+/**
+ * @brief Set the bits of the given bit volume for every voxel of the volume that matches the condition.
+ *
+ * The work is distributed over the threads in whole words of the bit volume - so no locking is needed.
+ *
+ * @param[out] bits Is resized to the region of the volume
+ * @param[in] condition Callable(const Volume::Sampler &) -> bool - see e.g. @c VisitSolid
+ */
+template<class Volume, class Condition>
+void fillBitVolume(const Volume &volume, voxel::BitVolume &bits, const Condition &condition) {
+	const voxel::Region &region = volume.region();
+	if (bits.region() != region) {
+		bits.resize(region);
+	}
+	if (!region.isValid()) {
+		return;
+	}
+	core::DynamicBitSet &data = bits.data();
+	const int64_t total = (int64_t)data.bits();
+	const int width = region.getWidthInVoxels();
+	const int64_t stride = (int64_t)width * region.getHeightInVoxels();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	auto fn = [&](int start, int end) {
+		typename Volume::Sampler sampler(volume);
+		int64_t idx = (int64_t)start * 64;
+		int z = (int)(idx / stride);
+		int y = (int)((idx - (int64_t)z * stride) / width);
+		int x = (int)(idx - (int64_t)z * stride - (int64_t)y * width);
+		sampler.setPosition(mins.x + x, mins.y + y, mins.z + z);
+		for (int w = start; w < end; ++w) {
+			core::DynamicBitSet::Type word = 0u;
+			for (int bit = 0; bit < 64 && idx < total; ++bit, ++idx) {
+				if (condition(sampler)) {
+					word |= (core::DynamicBitSet::Type)1 << bit;
+				}
+				if (++x < width) {
+					sampler.movePositiveX();
+					continue;
+				}
+				x = 0;
+				if (++y >= region.getHeightInVoxels()) {
+					y = 0;
+					++z;
+				}
+				sampler.setPosition(mins.x, mins.y + y, mins.z + z);
+			}
+			data.setWord(w, word);
+		}
+	};
+	app::for_parallel(0, (int)data.words(), fn);
+}
+
+} // namespace voxelutil
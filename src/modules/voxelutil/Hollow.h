@@ -4,30 +4,26 @@
 
 #pragma once
 
-#include "core/collection/DynamicArray.h"
 #include "core/ProgressScope.h"
+#include "voxel/BitVolume.h"
+#include "voxelutil/FloodFill.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxelutil {
 
 template<class VOLUME>
 inline void hollow(VOLUME &volume) {
-	core::DynamicArray<glm::ivec3> toHollow;
-	toHollow.reserve(volume.region().voxels());
 	core::IProgress &progress = core::currentProgress();
 	progress.setProgress(0.0f);
-	voxelutil::visitInvisibleVolume(volume, [&toHollow](int x, int y, int z, const voxel::Voxel &voxel) {
-		toHollow.emplace_back(x, y, z);
-	});
+	// remember the enclosed voxels with one bit per voxel - they can't be removed while they are still checked
+	voxel::BitVolume enclosed;
+	fillBitVolume(volume, enclosed, VisitInvisible());
 	progress.setProgress(0.5f);
-	const int n = (int)toHollow.size();
-	const int progressStep = 1024;
-	for (int i = 0; i < n; ++i) {
-		volume.setVoxel(toHollow[i], voxel::Voxel());
-		if (i % progressStep == 0) {
-			progress.setProgress(0.5f + 0.5f * ((float)(i + 1) / (float)core_max(1, n)));
-		}
-	}
+	typename VOLUME::Sampler sampler(&volume);
+	visitBitVolume(enclosed, [&sampler](int x, int y, int z) {
+		sampler.setPosition(x, y, z);
+		sampler.setVoxel(voxel::Voxel());
+	});
 	progress.setProgress(1.0f);
 }
 
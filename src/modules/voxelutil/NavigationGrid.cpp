@@ -0,0 +1,280 @@
+/**
+ * @file
+ */
+
+#include "NavigationGrid.h"
+#include "core/Log.h"
+#include "core/collection/DynamicMap.h"
+#include "core/collection/PriorityQueue.h"
+#include <algorithm>
+#include <float.h>
+#include <glm/geometric.hpp>
+
+namespace voxelutil {
+
+static int neighbourOffsets(voxel::Connectivity connectivity, glm::ivec3 *offsets) {
+	int n = 0;
+	for (const glm::ivec3 &offset : voxel::arrayPathfinderFaces) {
+		offsets[n++] = offset;
+	}
+	if (connectivity == voxel::Connectivity::SixConnected) {
+		return n;
+	}
+	for (const glm::ivec3 &offset : voxel::arrayPathfinderEdges) {
+		offsets[n++] = offset;
+	}
+	if (connectivity == voxel::Connectivity::EighteenConnected) {
+		return n;
+	}
+	for (const glm::ivec3 &offset : voxel::arrayPathfinderCorners) {
+		offsets[n++] = offset;
+	}
+	return n;
+}
+
+NavigationGrid::NavigationGrid(voxel::Connectivity connectivity) : _connectivity(connectivity) {
+}
+
+void NavigationGrid::init(const voxel::Region &region) {
+	_region = region;
+	_clusters.clear();
+	if (!_region.isValid()) {
+		_clusterCount = glm::ivec3(0);
+		return;
+	}
+	_clusterCount = (_region.getDimensionsInVoxels() + (ClusterSize - 1)) >> ClusterShift;
+	_clusters.resize((size_t)_clusterCount.x * _clusterCount.y * _clusterCount.z);
+}
+
+uint16_t NavigationGrid::component(const Cluster &cluster, uint16_t cell) const {
+	const uint16_t *begin = cluster.cells.data();
+	const uint16_t *end = begin + cluster.cells.size();
+	const uint16_t *iter = std::lower_bound(begin, end, cell);
+	if (iter == end || *iter != cell) {
+		return InvalidComponent;
+	}
+	return cluster.labels[iter - begin];
+}
+
+const glm::ivec3 &NavigationGrid::center(uint64_t key) const {
+	return _clusters[(size_t)(key >> 16)].components[key & 0xFFFF].center;
+}
+
+uint64_t NavigationGrid::componentKey(const glm::ivec3 &pos) const {
+	if (!_region.containsPoint(pos)) {
+		return InvalidKey;
+	}
+	const glm::ivec3 local = pos - _region.getLowerCorner();
+	const int clusterIdx = clusterIndex(local >> ClusterShift);
+	const uint16_t comp = component(_clusters[clusterIdx], cellIndex(local & (ClusterSize - 1)));
+	if (comp == InvalidComponent) {
+		return InvalidKey;
+	}
+	return key(clusterIdx, comp);
+}
+
+int NavigationGrid::components() const {
+	int n = 0;
+	for (const Cluster &cluster : _clusters) {
+		n += (int)cluster.components.size();
+	}
+	return n;
+}
+
+void NavigationGrid::buildComponents(int clusterIdx) {
+	Cluster &cluster = _clusters[clusterIdx];
+	cluster.components.clear();
+	const size_t n = cluster.cells.size();
+	if (n == 0) {
+		cluster.cells.release();
+		cluster.labels.release();
+		return;
+	}
+	cluster.labels.resize(n);
+	cluster.labels.fill(InvalidComponent);
+
+	// maps the cell index to the position in the list of walkable cells
+	uint16_t lookup[ClusterSize * ClusterSize * ClusterSize];
+	for (uint16_t &l : lookup) {
+		l = InvalidComponent;
+	}
+	for (size_t i = 0; i < n; ++i) {
+		lookup[cluster.cells[i]] = (uint16_t)i;
+	}
+
+	glm::ivec3 offsets[26];
+	const int offsetCount = neighbourOffsets(_connectivity, offsets);
+	const glm::ivec3 mins = clusterMins(clusterPosition(clusterIdx));
+	core::Buffer<uint16_t> todo;
+	core::Buffer<uint16_t> members;
+	for (size_t i = 0; i < n; ++i) {
+		if (cluster.labels[i] != InvalidComponent) {
+			continue;
+		}
+		const uint16_t label = (uint16_t)cluster.components.size();
+		cluster.labels[i] = label;
+		todo.push_back((uint16_t)i);
+		members.clear();
+		glm::ivec3 sum(0);
+		while (!todo.empty()) {
+			const uint16_t current = todo.back();
+			todo.pop();
+			members.push_back(current);
+			const glm::ivec3 pos = cellPosition(cluster.cells[current]);
+			sum += pos;
+			for (int o = 0; o < offsetCount; ++o) {
+				const glm::ivec3 neighbour = pos + offsets[o];
+				if (glm::any(glm::lessThan(neighbour, glm::ivec3(0))) ||
+					glm::any(glm::greaterThanEqual(neighbour, glm::ivec3(ClusterSize)))) {
+					continue;
+				}
+				const uint16_t idx = lookup[cellIndex(neighbour)];
+				if (idx == InvalidComponent || cluster.labels[idx] != InvalidComponent) {
+					continue;
+				}
+				cluster.labels[idx] = label;
+				todo.push_back(idx);
+			}
+		}
+
+		// the center must be a walkable cell - the distances between the centers are the costs of the links
+		const glm::vec3 centroid = glm::vec3(sum) / (float)members.size();
+		Component comp;
+		float bestDistance = FLT_MAX;
+		for (uint16_t member : members) {
+			const glm::ivec3 pos = cellPosition(cluster.cells[member]);
+			const float distance = glm::distance(glm::vec3(pos), centroid);
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				comp.center = mins + pos;
+			}
+		}
+		cluster.components.emplace_back(core::move(comp));
+	}
+}
+
+void NavigationGrid::linkClusters(const glm::ivec3 &mins, const glm::ivec3 &maxs) {
+	const glm::ivec3 size = maxs - mins + 1;
+	app::for_parallel(0, size.x * size.y * size.z, [&](int start, int end) {
+		glm::ivec3 offsets[26];
+		const int offsetCount = neighbourOffsets(_connectivity, offsets);
+		for (int i = start; i < end; ++i) {
+			const glm::ivec3 clusterPos = mins + glm::ivec3(i % size.x, (i / size.x) % size.y, i / (size.x * size.y));
+			Cluster &cluster = _clusters[clusterIndex(clusterPos)];
+			for (Component &comp : cluster.components) {
+				comp.links.clear();
+			}
+			for (size_t c = 0; c < cluster.cells.size(); ++c) {
+				const glm::ivec3 pos = cellPosition(cluster.cells[c]);
+				// only the cells at the border of the cluster have neighbours in other clusters
+				if (glm::all(glm::greaterThan(pos, glm::ivec3(0))) &&
+					glm::all(glm::lessThan(pos, glm::ivec3(ClusterSize - 1)))) {
+					continue;
+				}
+				Component &comp = cluster.components[cluster.labels[c]];
+				for (int o = 0; o < offsetCount; ++o) {
+					const glm::ivec3 neighbour = pos + offsets[o];
+					const glm::ivec3 neighbourClusterPos = clusterPos + (neighbour >> ClusterShift);
+					if (neighbourClusterPos == clusterPos ||
+						glm::any(glm::lessThan(neighbourClusterPos, glm::ivec3(0))) ||
+						glm::any(glm::greaterThanEqual(neighbourClusterPos, _clusterCount))) {
+						continue;
+					}
+					const int neighbourIdx = clusterIndex(neighbourClusterPos);
+					const Cluster &neighbourCluster = _clusters[neighbourIdx];
+					const uint16_t neighbourComp =
+						component(neighbourCluster, cellIndex(neighbour & (ClusterSize - 1)));
+					if (neighbourComp == InvalidComponent) {
+						continue;
+					}
+					bool known = false;
+					for (const Link &link : comp.links) {
+						if (link.cluster == neighbourIdx && link.component == neighbourComp) {
+							known = true;
+							break;
+						}
+					}
+					if (known) {
+						continue;
+					}
+					const glm::ivec3 &neighbourCenter = neighbourCluster.components[neighbourComp].center;
+					comp.links.push_back(
+						{neighbourIdx, neighbourComp, glm::distance(glm::vec3(comp.center), glm::vec3(neighbourCenter))});
+				}
+			}
+		}
+	});
+}
+
+bool NavigationGrid::corridor(const glm::ivec3 &start, const glm::ivec3 &end, Corridor &corridor,
+							  uint32_t maxNodes) const {
+	corridor.clear();
+	const uint64_t startKey = componentKey(start);
+	const uint64_t endKey = componentKey(end);
+	if (startKey == InvalidKey || endKey == InvalidKey) {
+		return false;
+	}
+	if (startKey == endKey) {
+		corridor.insert(startKey);
+		return true;
+	}
+
+	struct SearchNode {
+		float g;
+		uint64_t parent;
+		bool closed;
+	};
+	struct OpenNode {
+		float f;
+		uint64_t key;
+		inline bool operator>(const OpenNode &rhs) const {
+			return f > rhs.f;
+		}
+	};
+	// the costs of the links are the distances between the centers - so this heuristic never overestimates
+	const glm::vec3 target(center(endKey));
+	core::DynamicMap<uint64_t, SearchNode, 1031> nodes;
+	core::PriorityQueue<OpenNode, core::Greater<OpenNode>> open;
+	nodes.put(startKey, {0.0f, InvalidKey, false});
+	open.push({glm::distance(glm::vec3(center(startKey)), target), startKey});
+
+	OpenNode current;
+	while (open.pop(current)) {
+		SearchNode &node = nodes.find(current.key)->value;
+		// outdated entry of a node that was reached on a shorter path
+		if (node.closed) {
+			continue;
+		}
+		node.closed = true;
+		if (current.key == endKey) {
+			for (uint64_t k = endKey; k != InvalidKey; k = nodes.find(k)->value.parent) {
+				corridor.insert(k);
+			}
+			return true;
+		}
+		if (nodes.size() > maxNodes) {
+			Log::debug("Reached the maximum number of components while searching the corridor");
+			return false;
+		}
+		const float g = node.g;
+		const Component &comp = _clusters[(size_t)(current.key >> 16)].components[current.key & 0xFFFF];
+		for (const Link &link : comp.links) {
+			const uint64_t linkKey = key(link.cluster, link.component);
+			const float linkG = g + link.cost;
+			auto iter = nodes.find(linkKey);
+			if (iter != nodes.end()) {
+				if (iter->value.closed || linkG >= iter->value.g) {
+					continue;
+				}
+				iter->value.g = linkG;
+				iter->value.parent = current.key;
+			} else {
+				nodes.put(linkKey, {linkG, current.key, false});
+			}
+			open.push({linkG + glm::distance(glm::vec3(center(linkKey)), target), linkKey});
+		}
+	}
+	return false;
+}
+
+} // namespace voxelutil
@@ -0,0 +1,211 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/ForParallel.h"
+#include "core/GLM.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicSet.h"
+#include "voxel/Connectivity.h"
+#include "voxel/Region.h"
+
+namespace voxelutil {
+
+/**
+ * @brief Walkable cells of a volume grouped into clusters for hierarchical pathfinding (HPA*)
+ *
+ * The volume region is split into clusters of @c ClusterSize voxels per axis. The walkable cells of a cluster are
+ * grouped into components - cells that are connected inside the cluster. Components of neighbouring clusters are
+ * linked if any of their cells are neighbours. A path query first searches the graph of the components with
+ * @c corridor() and afterwards only the cells of the found components have to be searched voxel by voxel.
+ *
+ * Only the walkable cells are stored - the clusters without any walkable cell don't need more than the cluster
+ * itself. Edits only need to update the clusters of the modified region - see @c update().
+ *
+ * @note The queries can be executed concurrently - but not while the grid is updated
+ * @sa AStarPathfinderParams::navigation
+ */
+class NavigationGrid {
+public:
+	static constexpr int ClusterShift = 4;
+	static constexpr int ClusterSize = 1 << ClusterShift;
+	static constexpr uint16_t InvalidComponent = 0xFFFF;
+	static constexpr uint64_t InvalidKey = ~(uint64_t)0;
+
+	/**
+	 * @brief The components that a path is allowed to pass
+	 */
+	using Corridor = core::DynamicSet<uint64_t, 101>;
+
+private:
+	struct Link {
+		int cluster;
+		uint16_t component;
+		float cost;
+	};
+
+	struct Component {
+		/** the walkable cell that is closest to the center of all cells of the component */
+		glm::ivec3 center{0};
+		core::Buffer<Link, 8> links;
+	};
+
+	struct Cluster {
+		/** the sorted cell indices of the walkable cells - see @c cellIndex() */
+		core::Buffer<uint16_t> cells;
+		/** the component of each walkable cell */
+		core::Buffer<uint16_t> labels;
+		core::DynamicArray<Component, 4> components;
+	};
+
+	voxel::Region _region = voxel::Region::InvalidRegion;
+	voxel::Connectivity _connectivity;
+	/** the amount of clusters per axis */
+	glm::ivec3 _clusterCount{0};
+	core::DynamicArray<Cluster> _clusters;
+
+	static inline uint16_t cellIndex(const glm::ivec3 &local) {
+		return (uint16_t)((local.z << (2 * ClusterShift)) | (local.y << ClusterShift) | local.x);
+	}
+	static inline glm::ivec3 cellPosition(uint16_t cell) {
+		return glm::ivec3(cell & (ClusterSize - 1), (cell >> ClusterShift) & (ClusterSize - 1),
+						  cell >> (2 * ClusterShift));
+	}
+	static inline uint64_t key(int cluster, uint16_t component) {
+		return ((uint64_t)cluster << 16) | component;
+	}
+
+	inline int clusterIndex(const glm::ivec3 &cluster) const {
+		return (cluster.z * _clusterCount.y + cluster.y) * _clusterCount.x + cluster.x;
+	}
+	inline glm::ivec3 clusterPosition(int index) const {
+		return glm::ivec3(index % _clusterCount.x, (index / _clusterCount.x) % _clusterCount.y,
+						  index / (_clusterCount.x * _clusterCount.y));
+	}
+	inline glm::ivec3 clusterMins(const glm::ivec3 &cluster) const {
+		return _region.getLowerCorner() + (cluster << ClusterShift);
+	}
+	/**
+	 * @return The component of the given cell or @c InvalidComponent if the cell is not walkable
+	 */
+	uint16_t component(const Cluster &cluster, uint16_t cell) const;
+	const glm::ivec3 &center(uint64_t key) const;
+
+	/**
+	 * @brief Group the walkable cells of the cluster into components
+	 */
+	void buildComponents(int clusterIdx);
+	/**
+	 * @brief Rebuild the links of all components of the given inclusive cluster range to their neighbours
+	 */
+	void linkClusters(const glm::ivec3 &mins, const glm::ivec3 &maxs);
+
+public:
+	NavigationGrid(voxel::Connectivity connectivity = voxel::Connectivity::EighteenConnected);
+
+	/**
+	 * @brief Set up the clusters for the given volume region - no cell is walkable
+	 */
+	void init(const voxel::Region &region);
+
+	/**
+	 * @brief Evaluate the walkable cells of all clusters that intersect the given region again
+	 *
+	 * The region is grown by one voxel because the walkability of a cell usually depends on its neighbours.
+	 *
+	 * @param isWalkable Called with the volume and the position of each cell - this is called from several threads
+	 */
+	template<class Volume, class FUNC>
+	void update(const Volume &volume, const voxel::Region &region, FUNC &&isWalkable);
+
+	/**
+	 * @brief Set up the clusters for the region of the given volume and evaluate all cells
+	 * @sa update()
+	 */
+	template<class Volume, class FUNC>
+	void build(const Volume &volume, FUNC &&isWalkable) {
+		init(volume.region());
+		update(volume, volume.region(), isWalkable);
+	}
+
+	inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	inline voxel::Connectivity connectivity() const {
+		return _connectivity;
+	}
+
+	/**
+	 * @return The component of the given position or @c InvalidKey if the position is not walkable
+	 */
+	uint64_t componentKey(const glm::ivec3 &pos) const;
+
+	inline bool isWalkable(const glm::ivec3 &pos) const {
+		return componentKey(pos) != InvalidKey;
+	}
+
+	/**
+	 * @return The amount of components of all clusters
+	 */
+	int components() const;
+
+	/**
+	 * @brief Search the components that connect the given positions
+	 *
+	 * The components are searched with A* on the graph of the linked components. Every path between the positions
+	 * that only passes the returned components is valid.
+	 *
+	 * @param maxNodes The maximum amount of components that are visited before giving up
+	 * @return @c false if one of the positions is not walkable or if they are not connected
+	 */
+	bool corridor(const glm::ivec3 &start, const glm::ivec3 &end, Corridor &corridor, uint32_t maxNodes = 10000) const;
+};
+
+template<class Volume, class FUNC>
+void NavigationGrid::update(const Volume &volume, const voxel::Region &region, FUNC &&isWalkable) {
+	voxel::Region dirty = region;
+	dirty.grow(1);
+	if (!_region.isValid() || !dirty.cropTo(_region)) {
+		return;
+	}
+	const glm::ivec3 mins = (dirty.getLowerCorner() - _region.getLowerCorner()) >> ClusterShift;
+	const glm::ivec3 maxs = (dirty.getUpperCorner() - _region.getLowerCorner()) >> ClusterShift;
+	const glm::ivec3 size = maxs - mins + 1;
+	app::for_parallel(0, size.x * size.y * size.z, [&](int start, int end) {
+		// collect the cells in a scratch buffer to only allocate the needed memory for the cluster
+		core::Buffer<uint16_t> scratch;
+		scratch.reserve(ClusterSize * ClusterSize * ClusterSize);
+		for (int i = start; i < end; ++i) {
+			const glm::ivec3 cluster = mins + glm::ivec3(i % size.x, (i / size.x) % size.y, i / (size.x * size.y));
+			const int clusterIdx = clusterIndex(cluster);
+			const glm::ivec3 cmins = clusterMins(cluster);
+			const glm::ivec3 cmaxs = glm::min(cmins + (ClusterSize - 1), _region.getUpperCorner());
+			scratch.clear();
+			// iterating z, y, x keeps the cell indices sorted
+			for (int z = cmins.z; z <= cmaxs.z; ++z) {
+				for (int y = cmins.y; y <= cmaxs.y; ++y) {
+					for (int x = cmins.x; x <= cmaxs.x; ++x) {
+						const glm::ivec3 pos(x, y, z);
+						if (isWalkable(&volume, pos)) {
+							scratch.push_back(cellIndex(pos - cmins));
+						}
+					}
+				}
+			}
+			core::Buffer<uint16_t> &cells = _clusters[clusterIdx].cells;
+			cells.release();
+			if (!scratch.empty()) {
+				cells.append(scratch.data(), scratch.size());
+			}
+			buildComponents(clusterIdx);
+		}
+	});
+	// the links of the neighbours point to the components of the modified clusters
+	linkClusters(glm::max(mins - 1, glm::ivec3(0)), glm::min(maxs + 1, _clusterCount - 1));
+}
+
+} // namespace voxelutil
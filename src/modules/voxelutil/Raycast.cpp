@@ -4,6 +4,7 @@
 
 #include "Raycast.h"
 #include "core/Common.h"
+#include <float.h>
 
 namespace voxelutil {
 
@@ -45,6 +46,147 @@ glm::vec3 RaycastResult::projectOnPlane(const glm::vec3 &v) const {
 	return v - glm::dot(v, n) * n;
 }
 
+RaycastDDA::RaycastDDA(const glm::vec3 &start, const glm::vec3 &end) : _start(start), _end(end) {
+	const glm::vec3 floorStart(glm::floor(start));
+	_startPos = glm::ivec3(floorStart);
+	_endPos = glm::ivec3(glm::floor(end));
+	_pos = _startPos;
+	const glm::vec3 dist = glm::abs(end - start);
+	const glm::vec3 maxs = floorStart + 1.0f;
+	for (int i = 0; i < 3; ++i) {
+		_dir[i] = ((start[i] < end[i]) ? 1 : ((start[i] > end[i]) ? -1 : 0));
+		// the distance between cell boundaries
+		_tDelta[i] = dist[i] < glm::epsilon<float>() ? 1.0f : 1.0f / dist[i];
+		_tStart[i] = ((_dir[i] == -1) ? (start[i] - floorStart[i]) : (maxs[i] - start[i])) * _tDelta[i];
+	}
+}
+
+int RaycastDDA::crossingsBefore(int axis, float t, bool inclusive, int limit) const {
+	auto before = [&](int crossing) {
+		const float p = param(axis, crossing);
+		return inclusive ? p <= t : p < t;
+	};
+	const int current = _crossings[axis];
+	if (before(limit)) {
+		return limit;
+	}
+	if (!before(current)) {
+		return current;
+	}
+	// estimate the amount and fix it up to get the same result as comparing the parameters one by one
+	int crossing = current + (int)((t - param(axis, current)) / _tDelta[axis]);
+	crossing = core_max(current, core_min(crossing, limit));
+	while (crossing < limit && before(crossing)) {
+		++crossing;
+	}
+	while (crossing > current && !before(crossing - 1)) {
+		--crossing;
+	}
+	return crossing;
+}
+
+float RaycastDDA::crossingParam(int axis, int coord) const {
+	const int crossing = (coord - _startPos[axis]) * _dir[axis] - 1;
+	return param(axis, crossing);
+}
+
+bool RaycastDDA::skip(float t) {
+	// the stepping stops at the first crossing that would move beyond the end of the ray
+	int stopAxis = -1;
+	float stopParam = t;
+	for (int i = 0; i < 3; ++i) {
+		const float p = param(i, _crossings[i] + remaining(i));
+		if (p < stopParam) {
+			stopParam = p;
+			stopAxis = i;
+		}
+	}
+	glm::ivec3 crossings;
+	for (int i = 0; i < 3; ++i) {
+		const int limit = _crossings[i] + remaining(i);
+		if (i == stopAxis) {
+			crossings[i] = limit;
+		} else {
+			// on equal parameters the axis with the lower index is stepped first
+			crossings[i] = crossingsBefore(i, stopParam, i < stopAxis, limit);
+		}
+	}
+	int lastAxis = -1;
+	float lastParam = 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		if (crossings[i] == _crossings[i]) {
+			continue;
+		}
+		const float p = param(i, crossings[i] - 1);
+		if (lastAxis == -1 || p >= lastParam) {
+			lastAxis = i;
+			lastParam = p;
+		}
+	}
+	if (lastAxis != -1) {
+		_lastNormal = glm::ivec3(0);
+		_lastNormal[lastAxis] = -_dir[lastAxis];
+	}
+	_crossings = crossings;
+	_pos = _startPos + _dir * _crossings;
+	return stopAxis == -1;
+}
+
+float RaycastDDA::exitParam(const voxel::Region &region) const {
+	float t = FLT_MAX;
+	for (int i = 0; i < 3; ++i) {
+		if (_dir[i] == 1) {
+			t = core_min(t, crossingParam(i, region.getUpperCorner()[i] + 1));
+		} else if (_dir[i] == -1) {
+			t = core_min(t, crossingParam(i, region.getLowerCorner()[i] - 1));
+		}
+	}
+	return t;
+}
+
+float RaycastDDA::entryParam(const voxel::Region &region) const {
+	float t = 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		const int mins = region.getLowerCorner()[i];
+		const int maxs = region.getUpperCorner()[i];
+		if (_pos[i] >= mins && _pos[i] <= maxs) {
+			continue;
+		}
+		if (_pos[i] < mins && _dir[i] == 1) {
+			t = core_max(t, crossingParam(i, mins));
+		} else if (_pos[i] > maxs && _dir[i] == -1) {
+			t = core_max(t, crossingParam(i, maxs));
+		} else {
+			return FLT_MAX;
+		}
+	}
+	return t;
+}
+
+RaycastResult RaycastDDA::interrupted() const {
+	if (_pos == _startPos) {
+		return RaycastResult::interrupted(0.0f, 0.0f, _lastNormal);
+	}
+
+	// hitting a voxel is returing the voxel position - but the voxel geometry at voxel 0,0,0 goes from 0,0,0
+	// to 1,1,1 - we actually want to return the position of the face we hit
+	glm::vec3 r(_pos);
+	for (int i = 0; i < 3; ++i) {
+		if (_dir[i] == -1) {
+			r[i] += (1.0f - RaycastOffset);
+		}
+	}
+
+	const float length = glm::length(r - _start);
+	const float fract = length / glm::length(_end - _start);
+	return RaycastResult::interrupted(length, fract, _lastNormal);
+}
+
+RaycastResult RaycastDDA::completed() const {
+	const float length = glm::distance(_start, glm::vec3(_pos) + RaycastOffset);
+	return RaycastResult::completed(length);
+}
+
 RaycastHit raycastFaceDetection(const glm::vec3 &rayOrigin, const glm::vec3 &hitPos, float offsetMins,
 								float offsetMaxs) {
 	const glm::vec3 &rayDirection = glm::normalize(hitPos - rayOrigin);
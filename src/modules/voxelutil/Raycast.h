@@ -71,6 +71,8 @@
 #include "core/Common.h"
 #include "core/Trace.h"
 #include "voxel/Face.h"
+#include "voxel/Region.h"
+#include "voxel/VolumeOccupancy.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/geometric.hpp>
 
@@ -116,6 +118,152 @@ struct RaycastResult {
 	glm::vec3 projectOnPlane(const glm::vec3 &v) const;
 };
 
+/**
+ * @brief The 3D-DDA that walks along the voxels between the two end points of a ray
+ *
+ * The parameter of the next cell boundary crossing is calculated from the amount of crossings per axis instead of
+ * being accumulated. This allows @c skip() to jump over a lot of voxels at once and still end up in exactly the same
+ * state as stepping voxel by voxel.
+ *
+ * The parameters are fractions of the ray - @c 0.0 is the start and @c 1.0 is the end.
+ */
+class RaycastDDA {
+private:
+	glm::vec3 _start;
+	glm::vec3 _end;
+	/** the parameter of the first cell boundary crossing per axis */
+	glm::vec3 _tStart;
+	/** the parameter distance between two cell boundaries per axis */
+	glm::vec3 _tDelta;
+	glm::ivec3 _startPos;
+	glm::ivec3 _endPos;
+	glm::ivec3 _dir;
+	glm::ivec3 _crossings{0};
+	glm::ivec3 _pos;
+	glm::ivec3 _lastNormal{0};
+
+	inline float param(int axis, int crossing) const {
+		return _tStart[axis] + (float)crossing * _tDelta[axis];
+	}
+	/**
+	 * @brief The amount of crossings that can still be done along the axis before the end of the ray is reached
+	 */
+	inline int remaining(int axis) const {
+		return (_endPos[axis] - _pos[axis]) * _dir[axis];
+	}
+	/**
+	 * @return The smallest amount of crossings (not more than @c limit) along the axis whose next crossing has a
+	 * parameter that is not below (or if @c inclusive is @c true above) the given one
+	 */
+	int crossingsBefore(int axis, float t, bool inclusive, int limit) const;
+	/**
+	 * @return The parameter of the crossing that moves the position along the axis onto the given coordinate
+	 */
+	float crossingParam(int axis, int coord) const;
+
+public:
+	RaycastDDA(const glm::vec3 &start, const glm::vec3 &end);
+
+	inline const glm::ivec3 &position() const {
+		return _pos;
+	}
+
+	/**
+	 * @return The axis aligned normal of the face that was crossed last
+	 */
+	inline const glm::ivec3 &lastNormal() const {
+		return _lastNormal;
+	}
+
+	/**
+	 * @return The axis of the next crossing - on equal parameters x is crossed before y and y before z
+	 */
+	inline int nextAxis() const {
+		const float tx = param(0, _crossings.x);
+		const float ty = param(1, _crossings.y);
+		const float tz = param(2, _crossings.z);
+		if (tx <= ty && tx <= tz) {
+			return 0;
+		}
+		if (ty <= tz) {
+			return 1;
+		}
+		return 2;
+	}
+
+	/**
+	 * @return The parameter of the next crossing
+	 */
+	inline float nextParam() const {
+		const int axis = nextAxis();
+		return param(axis, _crossings[axis]);
+	}
+
+	/**
+	 * @brief Move into the next voxel along the ray
+	 * @return The axis that was stepped along or @c -1 if the end of the ray was reached
+	 */
+	inline int step() {
+		const int axis = nextAxis();
+		if (_pos[axis] == _endPos[axis]) {
+			return -1;
+		}
+		++_crossings[axis];
+		_pos[axis] += _dir[axis];
+		_lastNormal = glm::ivec3(0);
+		_lastNormal[axis] = -_dir[axis];
+		return axis;
+	}
+
+	/**
+	 * @brief Do all crossings with a parameter below the given one at once
+	 * @return @c false if the end of the ray was reached on the way - the position is the last one of the ray then
+	 */
+	bool skip(float t);
+
+	/**
+	 * @return The parameter of the crossing that leaves the given region - the position must be inside of it
+	 */
+	float exitParam(const voxel::Region &region) const;
+	/**
+	 * @return The parameter of the crossing that enters the given region - or @c FLT_MAX if the ray doesn't enter it
+	 * @note The position must be outside of the region
+	 */
+	float entryParam(const voxel::Region &region) const;
+
+	template<class Sampler>
+	inline void moveSampler(Sampler &sampler, int axis) const {
+		if (axis == 0) {
+			if (_dir.x == 1) {
+				sampler.movePositiveX();
+			} else {
+				sampler.moveNegativeX();
+			}
+		} else if (axis == 1) {
+			if (_dir.y == 1) {
+				sampler.movePositiveY();
+			} else {
+				sampler.moveNegativeY();
+			}
+		} else {
+			if (_dir.z == 1) {
+				sampler.movePositiveZ();
+			} else {
+				sampler.moveNegativeZ();
+			}
+		}
+	}
+
+	/**
+	 * @brief The result for a ray that was interrupted at the current position
+	 */
+	RaycastResult interrupted() const;
+	/**
+	 * @brief The result for a ray that reached its end at the current position
+	 */
+	RaycastResult completed() const;
+};
+
 /**
  * Cast a ray through a volume by specifying the start and end positions
  *
@@ -136,118 +284,78 @@ RaycastResult raycastWithEndpoints(Volume *volData, const glm::vec3 &start, cons
 	core_trace_scoped(raycastWithEndpoints);
 	typename Volume::Sampler sampler(volData);
 
-	const glm::vec3 v3dStart = start + RaycastOffset;
-	const glm::vec3 v3dEnd = end + RaycastOffset;
-	const float x1 = v3dStart.x;
-	const float y1 = v3dStart.y;
-	const float z1 = v3dStart.z;
-	const float x2 = v3dEnd.x;
-	const float y2 = v3dEnd.y;
-	const float z2 = v3dEnd.z;
-
-	const glm::ivec3 floorEnd(glm::floor(v3dEnd));
-	const int iend = floorEnd.x;
-	const int jend = floorEnd.y;
-	const int kend = floorEnd.z;
-
-	const int di = ((x1 < x2) ? 1 : ((x1 > x2) ? -1 : 0));
-	const int dj = ((y1 < y2) ? 1 : ((y1 > y2) ? -1 : 0));
-	const int dk = ((z1 < z2) ? 1 : ((z1 > z2) ? -1 : 0));
-
-	const glm::vec3 dist = glm::abs(v3dEnd - v3dStart);
-	// the distance between cell boundaries
-	const float deltatx = dist.x < glm::epsilon<float>() ? 1.0f : 1.0f / dist.x;
-	const float deltaty = dist.y < glm::epsilon<float>() ? 1.0f : 1.0f / dist.y;
-	const float deltatz = dist.z < glm::epsilon<float>() ? 1.0f : 1.0f / dist.z;
-
-	const glm::vec3 floorStart(glm::floor(v3dStart));
-	const glm::vec3 maxs = floorStart + 1.0f;
-
-	float tx = ((di == -1) ? (x1 - floorStart.x) : (maxs.x - x1)) * deltatx;
-	float ty = ((dj == -1) ? (y1 - floorStart.y) : (maxs.y - y1)) * deltaty;
-	float tz = ((dk == -1) ? (z1 - floorStart.z) : (maxs.z - z1)) * deltatz;
-
-	int i = (int)floorStart.x;
-	int j = (int)floorStart.y;
-	int k = (int)floorStart.z;
-	sampler.setPosition(i, j, k);
+	RaycastDDA dda(start + RaycastOffset, end + RaycastOffset);
+	sampler.setPosition(dda.position());
 
-	// Track the last stepped face normal so we can report which face was hit when interrupted
-	glm::ivec3 lastNormal{0, 0, 0};
 	for (;;) {
 		if (!callback(sampler)) {
-			if (i == (int)floorStart.x && j == (int)floorStart.y && k == (int)floorStart.z) {
-				return RaycastResult::interrupted(0.0f, 0.0f, lastNormal);
-			}
-
-			// hitting a voxel is returing the voxel position - but the voxel geometry at voxel 0,0,0 goes from 0,0,0
-			// to 1,1,1 - we actually want to return the position of the face we hit
-			glm::vec3 r = sampler.position();
-			if (di == -1) {
-				r.x += (1.0f - RaycastOffset);
-			}
-			if (dj == -1) {
-				r.y += (1.0f - RaycastOffset);
-			}
-			if (dk == -1) {
-				r.z += (1.0f - RaycastOffset);
-			}
-
-			const float length = glm::length(r - v3dStart);
-			const float fract = length / glm::length(v3dEnd - v3dStart);
-			return RaycastResult::interrupted(length, fract, lastNormal);
+			return dda.interrupted();
 		}
+		const int axis = dda.step();
+		if (axis == -1) {
+			break;
+		}
+		dda.moveSampler(sampler, axis);
+	}
+	return dda.completed();
+}
 
-		if (tx <= ty && tx <= tz) {
-			if (i == iend) {
-				break;
-			}
-			tx += deltatx;
-			i += di;
+/**
+ * Cast a ray through a volume and skip the empty space
+ *
+ * This visits the voxels in the same order as the other @c raycastWithEndpoints() - but empty bricks of the
+ * occupancy and the space outside of the volume region are skipped. For each skipped span the @a callback is only
+ * called for the first and the last voxel. This keeps the callbacks working that keep track of where the ray entered
+ * or left the volume. A callback that interrupts the ray on a voxel that is not air gets the same result as without
+ * skipping.
+ *
+ * @param occupancy The occupancy of @a volData - it must be up to date
+ * @sa voxel::VolumeOccupancy
+ */
+template<typename Callback, class Volume>
+RaycastResult raycastWithEndpoints(Volume *volData, const voxel::VolumeOccupancy &occupancy, const glm::vec3 &start,
+								   const glm::vec3 &end, Callback &&callback) {
+	core_trace_scoped(raycastWithEndpointsOccupancy);
+	typename Volume::Sampler sampler(volData);
+	const voxel::Region &region = occupancy.region();
 
-			// we stepped along the x-axis; set normal accordingly
-			lastNormal = glm::ivec3(-di, 0, 0);
+	RaycastDDA dda(start + RaycastOffset, end + RaycastOffset);
+	sampler.setPosition(dda.position());
 
-			if (di == 1) {
-				sampler.movePositiveX();
-			} else if (di == -1) {
-				sampler.moveNegativeX();
-			}
-		} else if (ty <= tz) {
-			if (j == jend) {
-				break;
-			}
-			ty += deltaty;
-			j += dj;
+	for (;;) {
+		const glm::ivec3 &pos = dda.position();
+		float skipParam = -1.0f;
+		if (!region.containsPoint(pos)) {
+			skipParam = dda.entryParam(region);
+		} else if (occupancy.isSuperBrickEmpty(pos)) {
+			skipParam = dda.exitParam(occupancy.superBrickRegion(pos));
+		} else if (occupancy.isBrickEmpty(pos)) {
+			skipParam = dda.exitParam(occupancy.brickRegion(pos));
+		}
 
-			if (dj == 1) {
-				sampler.movePositiveY();
-			} else if (dj == -1) {
-				sampler.moveNegativeY();
+		if (!callback(sampler)) {
+			return dda.interrupted();
+		}
+		if (skipParam >= 0.0f) {
+			const glm::ivec3 first = pos;
+			const bool reachedEnd = !dda.skip(skipParam);
+			if (dda.position() != first) {
+				sampler.setPosition(dda.position());
+				if (!callback(sampler)) {
+					return dda.interrupted();
+				}
 			}
-
-			// we stepped along the y-axis; set normal accordingly
-			lastNormal = glm::ivec3(0, -dj, 0);
-		} else {
-			if (k == kend) {
+			if (reachedEnd) {
 				break;
 			}
-			tz += deltatz;
-			k += dk;
-
-			if (dk == 1) {
-				sampler.movePositiveZ();
-			} else if (dk == -1) {
-				sampler.moveNegativeZ();
-			}
-
-			// we stepped along the z-axis; set normal accordingly
-			lastNormal = glm::ivec3(0, 0, -dk);
 		}
+		const int axis = dda.step();
+		if (axis == -1) {
+			break;
+		}
+		dda.moveSampler(sampler, axis);
 	}
-
-	float length = glm::distance(v3dStart, glm::vec3(i + RaycastOffset, j + RaycastOffset, k + RaycastOffset));
-	return RaycastResult::completed(length);
+	return dda.completed();
 }
 
 /**
@@ -281,4 +389,18 @@ RaycastResult raycastWithDirection(Volume *volData, const glm::vec3 &v3dStart, c
 	return raycastWithEndpoints<Callback, Volume>(volData, v3dStart, v3dEnd, core::forward<Callback>(callback));
 }
 
+/**
+ * Cast a ray through a volume by specifying the start and a direction and skip the empty space
+ *
+ * @sa raycastWithEndpoints() for the occupancy
+ */
+template<typename Callback, class Volume>
+RaycastResult raycastWithDirection(Volume *volData, const voxel::VolumeOccupancy &occupancy,
+								   const glm::vec3 &v3dStart, const glm::vec3 &v3dDirectionAndLength,
+								   Callback &&callback) {
+	const glm::vec3 v3dEnd = v3dStart + v3dDirectionAndLength;
+	return raycastWithEndpoints<Callback, Volume>(volData, occupancy, v3dStart, v3dEnd,
+												  core::forward<Callback>(callback));
+}
+
 } // namespace voxelutil
@@ -36,8 +36,8 @@ namespace voxelutil {
 	const int width = region.getWidthInVoxels();
 	const int height = region.getHeightInVoxels();
 	const int depth = region.getDepthInVoxels();
-	const int64_t yStride = width;
-	const int64_t zStride = (int64_t)width * height;
+	const int64_t yStride = volume->strideY();
+	const int64_t zStride = volume->strideZ();
 	const voxel::Voxel *data = volume->voxels();
 	const size_t lineSize = sizeof(voxel::Voxel) * width;
 
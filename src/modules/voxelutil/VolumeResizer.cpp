@@ -4,8 +4,7 @@
 
 #include "VolumeResizer.h"
 #include "app/App.h"
-#include "voxelutil/VolumeMerger.h"
-#include "voxel/RawVolumeWrapper.h"
+#include "voxel/RawVolume.h"
 
 namespace voxelutil {
 
@@ -17,22 +16,41 @@ voxel::RawVolume* resize(const voxel::RawVolume* source, const voxel::Region &re
 		return nullptr;
 	}
 	voxel::RawVolume* newVolume = new voxel::RawVolume(region);
-	const voxel::Region& srcRegion = source->region();
-	voxel::RawVolumeWrapper wrapper(newVolume);
-	voxelutil::mergeVolumes(&wrapper, source, srcRegion, srcRegion);
+	// the new volume is empty - copy the intersecting rows instead of merging voxel by voxel
+	newVolume->copyInto(*source);
 	return newVolume;
 }
 
-voxel::RawVolume* resize(const voxel::RawVolume* source, const glm::ivec3& size, bool extendMins) {
-	voxel::Region region = source->region();
+static voxel::Region resizeRegion(const voxel::Region &current, const glm::ivec3 &size, bool extendMins) {
+	voxel::Region region = current;
 	region.shiftUpperCorner(size);
 	if (extendMins) {
 		region.shiftLowerCorner(size);
 	}
+	return region;
+}
+
+voxel::RawVolume* resize(const voxel::RawVolume* source, const glm::ivec3& size, bool extendMins) {
+	const voxel::Region &region = resizeRegion(source->region(), size, extendMins);
 	if (!region.isValid()) {
 		return nullptr;
 	}
 	return resize(source, region);
 }
 
+bool resize(voxel::RawVolume &volume, const voxel::Region &region) {
+	if (!region.isValid()) {
+		return false;
+	}
+	const voxel::Region &current = volume.region();
+	if (!current.containsRegion(region) && !app::App::getInstance()->hasEnoughMemory(voxel::RawVolume::size(region))) {
+		return false;
+	}
+	return volume.resize(region);
+}
+
+bool resize(voxel::RawVolume &volume, const glm::ivec3 &size, bool extendMins) {
+	return resize(volume, resizeRegion(volume.region(), size, extendMins));
+}
+
 }
@@ -19,4 +19,11 @@ namespace voxelutil {
 [[nodiscard]] voxel::RawVolume *resize(const voxel::RawVolume *source, const voxel::Region &region);
 [[nodiscard]] voxel::RawVolume *resize(const voxel::RawVolume *source, const glm::ivec3 &size, bool extendMins = false);
 
+/**
+ * @brief Changes the region of the given volume in place - growing it step by step doesn't copy all voxels every time
+ * @sa voxel::RawVolume::resize()
+ */
+bool resize(voxel::RawVolume &volume, const voxel::Region &region);
+bool resize(voxel::RawVolume &volume, const glm::ivec3 &size, bool extendMins = false);
+
 } // namespace voxelutil
@@ -12,6 +12,7 @@
 #include "core/collection/DynamicSet.h"
 #include "math/Axis.h"
 #include "voxel/BitVolume.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/Connectivity.h"
 #include "voxel/Face.h"
 #include "voxel/RawVolume.h"
@@ -1631,6 +1632,13 @@ void sculptSmoothWall(voxel::BitVolume &solid, voxel::RawVolume &colorVolume, co
 	sculptSmoothWallImpl(solid, colorVolume, anchors, face, iterations, fillVoxel, removeAboveDepth, interp, fillHoles, addedPositions);
 }
 
+void sculptSmoothWall(voxel::BitVolume &solid, voxel::BrickedVolume &colorVolume, const voxel::BitVolume &anchors,
+					  voxel::FaceNames face, int iterations, const voxel::Voxel &fillVoxel,
+					  int removeAboveDepth, SmoothWallInterp interp, bool fillHoles,
+					  core::DynamicArray<glm::ivec3> &addedPositions) {
+	sculptSmoothWallImpl(solid, colorVolume, anchors, face, iterations, fillVoxel, removeAboveDepth, interp, fillHoles, addedPositions);
+}
+
 
 void sculptSquashToPlane(voxel::BitVolume &solid, voxel::SparseVolume &voxelMap, voxel::FaceNames face,
 						 int planeCoord) {
@@ -16,6 +16,7 @@ class Palette;
 }
 
 namespace voxel {
+class BrickedVolume;
 class RawVolume;
 class Region;
 } // namespace voxel
@@ -344,6 +345,14 @@ void sculptSmoothWall(voxel::BitVolume &solid, voxel::RawVolume &colorVolume, co
 					  int removeAboveDepth, SmoothWallInterp interp, bool fillHoles,
 					  core::DynamicArray<glm::ivec3> &addedPositions);
 
+/**
+ * @brief Smooth wall using the bricked storage layout as color source - the neighbour lookups stay in the same brick.
+ */
+void sculptSmoothWall(voxel::BitVolume &solid, voxel::BrickedVolume &colorVolume, const voxel::BitVolume &anchors,
+					  voxel::FaceNames face, int iterations, const voxel::Voxel &fillVoxel,
+					  int removeAboveDepth, SmoothWallInterp interp, bool fillHoles,
+					  core::DynamicArray<glm::ivec3> &addedPositions);
+
 
 /**
  * @brief Smooth wall on a volume region along a face normal.
@@ -5,88 +5,62 @@
 #include "VolumeSplitter.h"
 #include "app/Async.h"
 #include "core/Log.h"
+#include "voxel/BitVolume.h"
 #include "voxel/Connectivity.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
-#include "voxelutil/VolumeCropper.h"
+#include "voxelutil/ConnectedComponents.h"
+#include "voxelutil/FloodFill.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxelutil {
 
-namespace priv {
-
-// special voxel to mark already visited voxels
-const uint8_t visitedFlag = 1u;
-const voxel::Voxel visited(voxel::VoxelType::Air, 1, visitedFlag);
-
-} // namespace priv
-
-static void processNeighbours(voxel::RawVolume &volume, voxel::RawVolume &object, const glm::ivec3 &position, voxel::Connectivity connectivity) {
-	if (!volume.region().containsPoint(position)) {
-		return;
-	}
-	voxel::Voxel voxel = volume.voxel(position);
-	if (voxel.getFlags() == priv::visitedFlag) {
-		return;
-	}
-	if (voxel::isAir(voxel.getMaterial())) {
-		volume.setVoxelUnsafe(position, priv::visited);
-		return;
-	}
-
-	object.setVoxel(position, voxel);
-	volume.setVoxelUnsafe(position, priv::visited);
-
-	switch (connectivity) {
-	case voxel::Connectivity::TwentySixConnected:
-		for (int i = 0; i < lengthof(voxel::arrayPathfinderCorners); ++i) {
-			const glm::ivec3 p = position + voxel::arrayPathfinderCorners[i];
-			processNeighbours(volume, object, p, connectivity);
-		}
-		/* fallthrough */
-
-	case voxel::Connectivity::EighteenConnected:
-		for (int i = 0; i < lengthof(voxel::arrayPathfinderEdges); ++i) {
-			const glm::ivec3 p = position + voxel::arrayPathfinderEdges[i];
-			processNeighbours(volume, object, p, connectivity);
-		}
-		/* fallthrough */
-
-	case voxel::Connectivity::SixConnected:
-		for (int i = 0; i < lengthof(voxel::arrayPathfinderFaces); ++i) {
-			const glm::ivec3 p = position + voxel::arrayPathfinderFaces[i];
-			processNeighbours(volume, object, p, connectivity);
-		}
-		break;
-	}
-}
-
 core::Buffer<voxel::RawVolume *> splitObjects(const voxel::RawVolume *volume, VisitorOrder order,
 											  voxel::Connectivity connectivity) {
-	voxel::RawVolume copy(*volume);
-	copy.setBorderValue(priv::visited);
-
-	core::Buffer<voxel::RawVolume *> rawVolumes;
-
-	visitVolume(copy, [&](int x, int y, int z, const voxel::Voxel &voxel) {
-		if (voxel.getFlags() == priv::visitedFlag) {
-			return;
-		}
-		const glm::ivec3 position(x, y, z);
-		if (voxel::isAir(voxel.getMaterial())) {
-			copy.setVoxelUnsafe(position, priv::visited);
-			return;
+	voxel::BitVolume solid;
+	fillBitVolume(*volume, solid, VisitSolid());
+	ConnectedComponents components;
+	const int n = labelComponents(solid, components, connectivity);
+
+	// the objects are returned in the order their first voxel is found with the given visitor order
+	core::Buffer<int> slots(n);
+	for (int i = 0; i < n; ++i) {
+		slots[i] = -1;
+	}
+	int nextSlot = 0;
+	visitVolume(*volume, [&](int x, int y, int z, const voxel::Voxel &) {
+		const uint32_t label = components.label(x, y, z);
+		if (label != 0u && slots[label - 1] == -1) {
+			slots[label - 1] = nextSlot++;
 		}
+	}, VisitSolid(), order);
 
-		voxel::RawVolume object(copy.region());
-		processNeighbours(copy, object, position, connectivity);
-		if (voxel::RawVolume *v = voxelutil::cropVolume(&object)) {
-			rawVolumes.push_back(v);
-		} else {
-			rawVolumes.push_back(new voxel::RawVolume(object));
+	core::Buffer<voxel::RawVolume *> rawVolumes;
+	rawVolumes.resize(n);
+	auto fn = [volume, &components, &slots, &rawVolumes](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			const uint32_t label = (uint32_t)i + 1u;
+			const voxel::Region &objectRegion = components.regions[i];
+			voxel::RawVolume *object = new voxel::RawVolume(objectRegion);
+			voxel::RawVolume::Sampler srcSampler(volume);
+			voxel::RawVolume::Sampler dstSampler(object);
+			for (int z = objectRegion.getLowerZ(); z <= objectRegion.getUpperZ(); ++z) {
+				for (int y = objectRegion.getLowerY(); y <= objectRegion.getUpperY(); ++y) {
+					srcSampler.setPosition(objectRegion.getLowerX(), y, z);
+					dstSampler.setPosition(objectRegion.getLowerX(), y, z);
+					for (int x = objectRegion.getLowerX(); x <= objectRegion.getUpperX(); ++x) {
+						if (components.label(x, y, z) == label) {
+							dstSampler.setVoxel(srcSampler.voxel());
+						}
+						srcSampler.movePositiveX();
+						dstSampler.movePositiveX();
+					}
+				}
+			}
+			rawVolumes[slots[i]] = object;
 		}
-	}, VisitAll(), order);
-
+	};
+	app::for_parallel(0, n, fn);
 	return rawVolumes;
 }
 
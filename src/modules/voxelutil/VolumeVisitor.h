@@ -18,6 +18,7 @@
 #include "voxel/Face.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
+#include "voxelutil/FloodFill.h"
 #include <stdint.h>
 
 namespace voxelutil {
@@ -1096,45 +1097,36 @@ int countVoxelsByColor(const Volume &volume, const voxel::Voxel &voxel) {
 
 typedef core::DynamicSet<glm::ivec3, 1031, glm::hash<glm::ivec3>> VisitedSet;
 
+/**
+ * @brief Visit all voxels that are connected to the given position (face neighbours) and match the condition.
+ * The start position itself is visited, too - if it matches the condition. A start position that doesn't match the
+ * condition visits nothing. The recursive implementation before only visited the start position if one of its
+ * neighbours matched the condition - the callers don't have to handle the start position on their own anymore.
+ * @note The memory for the visited voxels depends on the amount of connected voxels - not on the volume size
+ * @sa visitFloodFill()
+ */
 template<class Volume, class Visitor, class Condition>
-static int visitConnectedByVoxel_r(const Volume &volume, const voxel::Voxel &voxel, const glm::ivec3 &position, Visitor &visitor, Condition &condition, VisitedSet &visited) {
+int visitConnected(const Volume &volume, const voxel::Voxel &voxel, const glm::ivec3 &position, Visitor &visitor,
+				   Condition &condition) {
 	typename Volume::Sampler sampler(volume);
-	if (!sampler.setPosition(position)) {
-		return 0;
-	}
-	int n = 0;
-	// visit all connected voxels of the same color
-	for (const glm::ivec3 &offset : voxel::arrayPathfinderFaces) {
-		const glm::ivec3 &volPos = position + offset;
-		if (!sampler.setPosition(volPos)) {
-			continue;
-		}
-		if (!condition(sampler)) {
-			continue;
-		}
-		if (!visited.insert(volPos)) {
-			continue;
-		}
-		visitor(volPos.x, volPos.y, volPos.z, voxel);
-		++n;
-		n += visitConnectedByVoxel_r(volume, voxel, volPos, visitor, condition, visited);
-	}
-	return n;
+	auto mask = [&sampler, &condition](int x, int y, int z) {
+		return sampler.setPosition(x, y, z) && condition(sampler);
+	};
+	auto visit = [&visitor, &voxel](int x, int y, int z) { visitor(x, y, z, voxel); };
+	return (int)visitFloodFill(volume.region(), mask, position, visit, voxel::Connectivity::SixConnected);
 }
 
 template<class Volume, class Visitor = EmptyVisitor>
 int visitConnectedByVoxel(const Volume &volume, const glm::ivec3 &position, Visitor &&visitor = Visitor()) {
 	const voxel::Voxel voxel = volume.voxel(position);
-	VisitedSet visited;
 	VisitVoxelColor condition(voxel);
-	return visitConnectedByVoxel_r(volume, voxel, position, visitor, condition, visited);
+	return visitConnected(volume, voxel, position, visitor, condition);
 }
 
 template<class Volume, class Visitor = EmptyVisitor, class Condition = VisitSolid>
 int visitConnectedByCondition(const Volume &volume, const glm::ivec3 &position, Visitor &&visitor = Visitor(), Condition &&condition = Condition()) {
 	const voxel::Voxel voxel = volume.voxel(position);
-	VisitedSet visited;
-	return visitConnectedByVoxel_r(volume, voxel, position, visitor, condition, visited);
+	return visitConnected(volume, voxel, position, visitor, condition);
 }
 
 /**
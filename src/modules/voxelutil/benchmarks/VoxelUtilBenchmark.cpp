@@ -4,23 +4,56 @@
 
 #include "app/benchmark/AbstractBenchmark.h"
 #include "core/ScopedPtr.h"
+#include "math/Random.h"
 #include "palette/Palette.h"
 #include "palette/PaletteView.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
+#include "voxel/BitVolume.h"
+#include "voxel/SparseVolume.h"
+#include "voxel/VolumeOccupancy.h"
 #include "voxel/Voxel.h"
+#include "voxelutil/AStarPathfinder.h"
+#include "voxelutil/ConnectedComponents.h"
 #include "voxelutil/FillHollow.h"
+#include "voxelutil/FloodFill.h"
+#include "voxelutil/NavigationGrid.h"
+#include "voxelutil/Raycast.h"
 #include "voxelutil/Shadow.h"
 #include "voxelutil/VolumeCropper.h"
 #include "voxelutil/VolumeMerger.h"
 #include "voxelutil/VolumeMover.h"
 #include "voxelutil/VolumeRescaler.h"
+#include "voxelutil/VolumeResizer.h"
 #include "voxelutil/VolumeVisitor.h"
 #include "voxelutil/VoxelUtil.h"
+#include <glm/trigonometric.hpp>
 
 class VoxelUtilBenchmark : public app::AbstractBenchmark {
 protected:
 	voxel::RawVolume v{voxel::Region{-20, 20}};
+
+	// rolling hills without steps higher than one voxel
+	static void createTerrain(voxel::RawVolume &volume) {
+		const voxel::Region &region = volume.region();
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const int height = 12 + (int)(6.0f * glm::sin((float)x / 23.0f) + 6.0f * glm::cos((float)z / 31.0f));
+				for (int y = 0; y <= height; ++y) {
+					volume.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+	}
+
+	static bool isWalkable(const voxel::RawVolume *volume, const glm::ivec3 &pos) {
+		const glm::ivec3 below(pos.x, pos.y - 1, pos.z);
+		if (!volume->region().containsPoint(pos) || !volume->region().containsPoint(below)) {
+			return false;
+		}
+		return voxel::isAir(volume->voxel(pos).getMaterial()) && !voxel::isAir(volume->voxel(below).getMaterial());
+	}
 };
 
 BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Crop)(benchmark::State &state) {
@@ -157,6 +190,49 @@ BENCHMARK_DEFINE_F(VoxelUtilBenchmark, FillHollow)(benchmark::State &state) {
 	}
 }
 
+// bit volumes only - a 1024^3 RawVolume would need 4GB
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, FloodFill)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	const voxel::Region region(0, size - 1);
+	voxel::BitVolume mask(region);
+	mask.fill();
+	// walls with a single hole each - the flood fill has to find its way through them
+	for (int z = 16; z < size; z += 32) {
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				mask.setVoxel(x, y, z, x == (z * 7) % size && y == (z * 13) % size);
+			}
+		}
+	}
+	voxel::BitVolume reached(region);
+	for (auto _ : state) {
+		reached.clear();
+		int64_t n = voxelutil::floodFill(mask, glm::ivec3(0), reached);
+		benchmark::DoNotOptimize(n);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * region.voxels());
+}
+
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, LabelComponents)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	const voxel::Region region(0, size - 1);
+	voxel::BitVolume mask(region);
+	// a lot of small boxes
+	for (int z = 0; z < size; ++z) {
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				mask.setVoxel(x, y, z, (x % 8) < 6 && (y % 8) < 6 && (z % 8) < 6);
+			}
+		}
+	}
+	for (auto _ : state) {
+		voxelutil::ConnectedComponents components;
+		int n = voxelutil::labelComponents(mask, components);
+		benchmark::DoNotOptimize(n);
+	}
+	state.SetItemsProcessed((int64_t)state.iterations() * region.voxels());
+}
+
 BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Merge)(benchmark::State &state) {
 	for (auto _ : state) {
 		voxel::RawVolume out(voxel::Region{-20, 20});
@@ -218,6 +294,46 @@ BENCHMARK_DEFINE_F(VoxelUtilBenchmark, CopyViaRawVolumeSameDim)(benchmark::State
 	}
 }
 
+// draw past the upper x edge a few times - like the auto resize every step grows the volume by a few voxels
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, ResizeIncremental)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	voxel::RawVolume in(voxel::Region{0, size - 1});
+	createTerrain(in);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (auto _ : state) {
+		state.PauseTiming();
+		core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(in));
+		state.ResumeTiming();
+		for (int i = 0; i < 16; ++i) {
+			voxel::Region region = volume->region();
+			region.shiftUpperCorner(4, 0, 0);
+			volume = voxelutil::resize(volume, region);
+			volume->setVoxel(region.getUpperX(), 0, 0, voxel);
+		}
+		benchmark::DoNotOptimize(volume->region());
+	}
+}
+
+// same as ResizeIncremental - but the volume is grown in place
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, ResizeIncrementalInPlace)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	voxel::RawVolume in(voxel::Region{0, size - 1});
+	createTerrain(in);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (auto _ : state) {
+		state.PauseTiming();
+		core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(in));
+		state.ResumeTiming();
+		for (int i = 0; i < 16; ++i) {
+			voxel::Region region = volume->region();
+			region.shiftUpperCorner(4, 0, 0);
+			voxelutil::resize(*volume, region);
+			volume->setVoxel(region.getUpperX(), 0, 0, voxel);
+		}
+		benchmark::DoNotOptimize(volume->region());
+	}
+}
+
 BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Shadow)(benchmark::State &state) {
 	voxel::RawVolume in(voxel::Region{0, 20});
 	voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 0);
@@ -233,6 +349,104 @@ BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Shadow)(benchmark::State &state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Raycast)(benchmark::State &state) {
+	// a mostly empty 1024^3 volume with a few small objects
+	const voxel::Region region(0, 1023);
+	voxel::SparseVolume volume(region);
+	voxel::VolumeOccupancy occupancy(region);
+	math::Random random(1);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (int i = 0; i < 64; ++i) {
+		const glm::ivec3 mins(random.random(0, 1000), random.random(0, 1000), random.random(0, 1000));
+		const voxel::Region object(mins, mins + 15);
+		for (int z = object.getLowerZ(); z <= object.getUpperZ(); ++z) {
+			for (int y = object.getLowerY(); y <= object.getUpperY(); ++y) {
+				for (int x = object.getLowerX(); x <= object.getUpperX(); ++x) {
+					volume.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+		occupancy.update(volume, object);
+	}
+	// rays from outside of the volume through it
+	core::DynamicArray<glm::vec3> starts;
+	core::DynamicArray<glm::vec3> ends;
+	for (int i = 0; i < 64; ++i) {
+		starts.push_back(glm::vec3(random.randomf(-200.0f, -10.0f), random.randomf(0.0f, 1024.0f), random.randomf(0.0f, 1024.0f)));
+		ends.push_back(glm::vec3(random.randomf(1034.0f, 1200.0f), random.randomf(0.0f, 1024.0f), random.randomf(0.0f, 1024.0f)));
+	}
+	const bool useOccupancy = state.range(0) != 0;
+	int hits = 0;
+	for (auto _ : state) {
+		for (size_t i = 0; i < starts.size(); ++i) {
+			auto callback = [](voxel::SparseVolume::Sampler &sampler) {
+				return voxel::isAir(sampler.voxel().getMaterial());
+			};
+			const voxelutil::RaycastResult &result =
+				useOccupancy ? voxelutil::raycastWithEndpoints(&volume, occupancy, starts[i], ends[i], callback)
+							 : voxelutil::raycastWithEndpoints(&volume, starts[i], ends[i], callback);
+			if (result.isInterrupted()) {
+				++hits;
+			}
+		}
+	}
+	benchmark::DoNotOptimize(hits);
+	state.SetItemsProcessed(state.iterations() * (int64_t)starts.size());
+}
+
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, NavigationGridBuild)(benchmark::State &state) {
+	const int size = (int)state.range(0);
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, size - 1, 31, size - 1));
+	createTerrain(volume);
+	for (auto _ : state) {
+		voxelutil::NavigationGrid navigation;
+		navigation.build(volume, isWalkable);
+		benchmark::DoNotOptimize(navigation);
+	}
+}
+
+BENCHMARK_DEFINE_F(VoxelUtilBenchmark, Pathfinder)(benchmark::State &state) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 511, 31, 511));
+	createTerrain(volume);
+	voxelutil::NavigationGrid navigation;
+	navigation.build(volume, isWalkable);
+
+	// from the west to the east side of the terrain
+	auto surface = [&volume](int x, int z) {
+		int y = volume.region().getUpperY();
+		while (!isWalkable(&volume, glm::ivec3(x, y, z))) {
+			--y;
+		}
+		return glm::ivec3(x, y, z);
+	};
+	core::DynamicArray<voxelutil::AStarPathQuery> queries;
+	math::Random random(1);
+	for (int i = 0; i < 16; ++i) {
+		voxelutil::AStarPathQuery query;
+		query.start = surface(random.random(0, 15), random.random(0, 511));
+		query.end = surface(random.random(496, 511), random.random(0, 511));
+		queries.push_back(query);
+	}
+
+	core::List<glm::ivec3> listResult;
+	voxelutil::AStarPathfinderParams<voxel::RawVolume> params(
+		&volume, glm::ivec3(0), glm::ivec3(0), &listResult,
+		[](const voxel::RawVolume *v, const glm::ivec3 &pos) { return isWalkable(v, pos); }, 1.0f, 1000000,
+		navigation.connectivity());
+	if (state.range(0) != 0) {
+		params.navigation = &navigation;
+	}
+	int found = 0;
+	for (auto _ : state) {
+		voxelutil::findPaths(params, queries);
+		for (const voxelutil::AStarPathQuery &query : queries) {
+			found += query.found ? 1 : 0;
+		}
+	}
+	benchmark::DoNotOptimize(found);
+	state.SetItemsProcessed(state.iterations() * (int64_t)queries.size());
+}
+
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ScaleDown);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ScaleUp);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ScaleVolumeDouble);
@@ -240,12 +454,19 @@ BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ScaleVolumeHalf);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ScaleVolumeFractional);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Crop);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, FillHollow);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, FloodFill)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, LabelComponents)->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Move);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Merge);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, MergeSameDim);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Shadow);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ResizeIncremental)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, ResizeIncrementalInPlace)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, CopyIntoRegion);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, CopyViaRawVolume);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, CopyIntoRegionSameDim);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, CopyViaRawVolumeSameDim);
 BENCHMARK_REGISTER_F(VoxelUtilBenchmark, CopyViaRawVolumeMultipleRegions);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Raycast)->ArgName("occupancy")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, NavigationGridBuild)->Arg(256)->Arg(512)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(VoxelUtilBenchmark, Pathfinder)->ArgName("hierarchical")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,56 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/ConnectedComponents.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/BitVolume.h"
+
+namespace voxelutil {
+
+class ConnectedComponentsTest : public app::AbstractTest {};
+
+TEST_F(ConnectedComponentsTest, testLabel) {
+	const voxel::Region region(0, 0, 0, 7, 7, 99);
+	voxel::BitVolume mask(region);
+	// a pillar along the z axis that spans all slabs
+	for (int z = 0; z <= 99; ++z) {
+		mask.setVoxel(0, 0, z, true);
+	}
+	// a u shape that is only connected in the last slab
+	for (int z = 10; z <= 99; ++z) {
+		mask.setVoxel(4, 4, z, true);
+		mask.setVoxel(6, 4, z, true);
+	}
+	mask.setVoxel(5, 4, 99, true);
+	// a single voxel
+	mask.setVoxel(7, 7, 50, true);
+
+	ConnectedComponents components;
+	ASSERT_EQ(3, labelComponents(mask, components));
+	EXPECT_EQ(1u, components.label(0, 0, 0));
+	EXPECT_EQ(1u, components.label(0, 0, 99));
+	EXPECT_EQ(2u, components.label(4, 4, 10));
+	EXPECT_EQ(2u, components.label(6, 4, 10));
+	EXPECT_EQ(3u, components.label(7, 7, 50));
+	EXPECT_EQ(0u, components.label(1, 1, 1));
+	EXPECT_EQ(voxel::Region(0, 0, 0, 0, 0, 99), components.regions[0]);
+	EXPECT_EQ(voxel::Region(4, 4, 10, 6, 4, 99), components.regions[1]);
+	EXPECT_EQ(voxel::Region(7, 7, 50, 7, 7, 50), components.regions[2]);
+}
+
+TEST_F(ConnectedComponentsTest, testConnectivity) {
+	const voxel::Region region(0, 0, 0, 3, 3, 63);
+	voxel::BitVolume mask(region);
+	// a zigzag line that is only connected via corners - crossing all slab borders
+	for (int z = 0; z <= 63; ++z) {
+		mask.setVoxel(z % 2, z % 2, z, true);
+	}
+	ConnectedComponents components;
+	EXPECT_EQ(64, labelComponents(mask, components, voxel::Connectivity::SixConnected));
+	EXPECT_EQ(64, labelComponents(mask, components, voxel::Connectivity::EighteenConnected));
+	EXPECT_EQ(1, labelComponents(mask, components, voxel::Connectivity::TwentySixConnected));
+	EXPECT_EQ(voxel::Region(0, 0, 0, 1, 1, 63), components.regions[0]);
+}
+
+} // namespace voxelutil
@@ -0,0 +1,105 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/FloodFill.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/BitVolume.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/VolumeVisitor.h"
+
+namespace voxelutil {
+
+class FloodFillTest : public app::AbstractTest {};
+
+TEST_F(FloodFillTest, testFloodFillConnectivity) {
+	const voxel::Region region(0, 3);
+	voxel::BitVolume mask(region);
+	// a diagonal line - only connected via edges in the xy plane and via corners in xyz
+	mask.setVoxel(0, 0, 0, true);
+	mask.setVoxel(1, 1, 0, true);
+	mask.setVoxel(2, 2, 1, true);
+
+	voxel::BitVolume reached6(region);
+	EXPECT_EQ(1, floodFill(mask, glm::ivec3(0, 0, 0), reached6, voxel::Connectivity::SixConnected));
+
+	voxel::BitVolume reached18(region);
+	EXPECT_EQ(2, floodFill(mask, glm::ivec3(0, 0, 0), reached18, voxel::Connectivity::EighteenConnected));
+	EXPECT_TRUE(reached18.hasValue(1, 1, 0));
+	EXPECT_FALSE(reached18.hasValue(2, 2, 1));
+
+	voxel::BitVolume reached26(region);
+	EXPECT_EQ(3, floodFill(mask, glm::ivec3(0, 0, 0), reached26, voxel::Connectivity::TwentySixConnected));
+	EXPECT_TRUE(reached26.hasValue(2, 2, 1));
+}
+
+TEST_F(FloodFillTest, testVisitFloodFillSparse) {
+	// a region of 2^48 voxels - the visited voxels can't be stored in a dense bit volume
+	const voxel::Region region(-65536, -65536, -65536, 65535, 65535, 65535);
+	const voxel::Region box(-5, -5, -5, 4, 4, 4);
+	auto mask = [&box](int x, int y, int z) { return box.containsPoint(x, y, z); };
+	int64_t visited = 0;
+	auto visitor = [&visited, &box](int x, int y, int z) {
+		EXPECT_TRUE(box.containsPoint(x, y, z));
+		++visited;
+	};
+	EXPECT_EQ(1000, visitFloodFill(region, mask, glm::ivec3(0, 0, 0), visitor));
+	EXPECT_EQ(1000, visited);
+}
+
+TEST_F(FloodFillTest, testFloodFillSpiral) {
+	// a serpentine path that forces the flood fill to go back and forth between the spans
+	const voxel::Region region(0, 0, 0, 15, 15, 0);
+	voxel::BitVolume mask(region);
+	int expected = 0;
+	for (int y = 0; y <= 15; y += 2) {
+		for (int x = 0; x <= 15; ++x) {
+			mask.setVoxel(x, y, 0, true);
+			++expected;
+		}
+		if (y < 15) {
+			mask.setVoxel((y / 2) % 2 == 0 ? 15 : 0, y + 1, 0, true);
+			++expected;
+		}
+	}
+	voxel::BitVolume reached(region);
+	EXPECT_EQ(expected, floodFill(mask, glm::ivec3(0, 0, 0), reached));
+	EXPECT_EQ(0, floodFill(mask, glm::ivec3(5, 0, 0), reached)) << "Already reached voxels are not visited again";
+}
+
+TEST_F(FloodFillTest, testFloodFillFromBorder) {
+	const voxel::Region region(0, 4);
+	voxel::BitVolume air(region);
+	air.fill();
+	// a closed shell around the center voxel
+	for (int z = 1; z <= 3; ++z) {
+		for (int y = 1; y <= 3; ++y) {
+			for (int x = 1; x <= 3; ++x) {
+				air.setVoxel(x, y, z, x == 2 && y == 2 && z == 2);
+			}
+		}
+	}
+	voxel::BitVolume outside(region);
+	EXPECT_EQ(region.voxels() - 27, floodFillFromBorder(air, outside));
+	EXPECT_FALSE(outside.hasValue(2, 2, 2));
+	EXPECT_TRUE(outside.hasValue(0, 0, 0));
+}
+
+TEST_F(FloodFillTest, testFillBitVolume) {
+	const voxel::Region region(-3, 5);
+	voxel::RawVolume volume(region);
+	volume.setVoxel(-3, -3, -3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	volume.setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	volume.setVoxel(5, 5, 5, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	voxel::BitVolume bits;
+	fillBitVolume(volume, bits, VisitSolid());
+	EXPECT_EQ(region, bits.region());
+	int n = 0;
+	visitBitVolume(bits, [&](int x, int y, int z) {
+		EXPECT_FALSE(voxel::isAir(volume.voxel(x, y, z).getMaterial())) << x << ":" << y << ":" << z;
+		++n;
+	});
+	EXPECT_EQ(3, n);
+}
+
+} // namespace voxelutil
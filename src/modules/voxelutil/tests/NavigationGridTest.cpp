@@ -0,0 +1,185 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/NavigationGrid.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/AStarPathfinder.h"
+
+namespace voxelutil {
+
+class NavigationGridTest : public app::AbstractTest {
+protected:
+	static bool standOnSolid(const voxel::RawVolume *v, const glm::ivec3 &pos) {
+		if (!v->region().containsPoint(pos) || voxel::isBlocked(v->voxel(pos).getMaterial())) {
+			return false;
+		}
+		const glm::ivec3 below(pos.x, pos.y - 1, pos.z);
+		return v->region().containsPoint(below) && voxel::isBlocked(v->voxel(below).getMaterial());
+	}
+
+	static void fillGround(voxel::RawVolume &volume) {
+		const voxel::Region &region = volume.region();
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				volume.setVoxel(x, 0, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+
+	// a wall of holes in the ground along x=20 with a gap at z=30
+	static void digTrench(voxel::RawVolume &volume) {
+		for (int z = 0; z <= volume.region().getUpperZ(); ++z) {
+			if (z != 30) {
+				volume.setVoxel(20, 0, z, voxel::Voxel());
+			}
+		}
+	}
+
+	static AStarPathfinderParams<voxel::RawVolume> params(const voxel::RawVolume &volume,
+														  const NavigationGrid &navigation,
+														  core::List<glm::ivec3> *result) {
+		AStarPathfinderParams<voxel::RawVolume> params(&volume, glm::ivec3(0, 1, 0), glm::ivec3(40, 1, 0), result,
+													   [](const voxel::RawVolume *v, const glm::ivec3 &pos) {
+														   return standOnSolid(v, pos);
+													   },
+													   1.0f, 10000, navigation.connectivity());
+		params.navigation = &navigation;
+		return params;
+	}
+
+	static void validatePath(const voxel::RawVolume &volume, const core::List<glm::ivec3> &path) {
+		const glm::ivec3 *prev = nullptr;
+		for (const glm::ivec3 &p : path) {
+			EXPECT_TRUE(standOnSolid(&volume, p));
+			if (prev != nullptr) {
+				const glm::ivec3 delta = glm::abs(p - *prev);
+				// 18 connected
+				EXPECT_LE(delta.x + delta.y + delta.z, 2);
+				EXPECT_LE(glm::max(delta.x, glm::max(delta.y, delta.z)), 1);
+			}
+			prev = &p;
+		}
+	}
+};
+
+TEST_F(NavigationGridTest, testComponents) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 40, 3, 40));
+	fillGround(volume);
+	NavigationGrid navigation;
+	navigation.build(volume, standOnSolid);
+	// 3x3 clusters on the ground
+	EXPECT_EQ(9, navigation.components());
+	EXPECT_TRUE(navigation.isWalkable(glm::ivec3(5, 1, 5)));
+	EXPECT_FALSE(navigation.isWalkable(glm::ivec3(5, 0, 5)));
+	EXPECT_FALSE(navigation.isWalkable(glm::ivec3(5, 2, 5)));
+	EXPECT_FALSE(navigation.isWalkable(glm::ivec3(50, 1, 5)));
+	EXPECT_EQ(navigation.componentKey(glm::ivec3(0, 1, 0)), navigation.componentKey(glm::ivec3(15, 1, 15)));
+	EXPECT_NE(navigation.componentKey(glm::ivec3(0, 1, 0)), navigation.componentKey(glm::ivec3(16, 1, 15)));
+
+	// the trench splits the clusters at x=16..31 into two components - except the one with the gap
+	digTrench(volume);
+	navigation.update(volume, voxel::Region(20, 0, 0, 20, 0, 40), standOnSolid);
+	EXPECT_EQ(11, navigation.components());
+}
+
+TEST_F(NavigationGridTest, testCorridor) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 40, 3, 40));
+	fillGround(volume);
+	digTrench(volume);
+	NavigationGrid navigation;
+	navigation.build(volume, standOnSolid);
+	NavigationGrid::Corridor corridor;
+	ASSERT_TRUE(navigation.corridor(glm::ivec3(0, 1, 0), glm::ivec3(40, 1, 0), corridor));
+	EXPECT_TRUE(corridor.has(navigation.componentKey(glm::ivec3(0, 1, 0))));
+	EXPECT_TRUE(corridor.has(navigation.componentKey(glm::ivec3(20, 1, 30))));
+	EXPECT_TRUE(corridor.has(navigation.componentKey(glm::ivec3(40, 1, 0))));
+	EXPECT_FALSE(navigation.corridor(glm::ivec3(0, 1, 0), glm::ivec3(20, 1, 0), corridor));
+}
+
+TEST_F(NavigationGridTest, testPathfinder) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 40, 3, 40));
+	fillGround(volume);
+	digTrench(volume);
+	NavigationGrid navigation;
+	navigation.build(volume, standOnSolid);
+
+	core::List<glm::ivec3> listResult;
+	AStarPathfinder pathfinder(params(volume, navigation, &listResult));
+	ASSERT_TRUE(pathfinder.execute());
+	EXPECT_EQ(glm::ivec3(0, 1, 0), *listResult.begin());
+	EXPECT_EQ(glm::ivec3(40, 1, 0), *listResult.back());
+	validatePath(volume, listResult);
+	bool crossedGap = false;
+	for (const glm::ivec3 &p : listResult) {
+		if (p.x == 20) {
+			crossedGap = true;
+			EXPECT_EQ(30, p.z);
+		}
+	}
+	EXPECT_TRUE(crossedGap);
+}
+
+TEST_F(NavigationGridTest, testUpdate) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 40, 3, 40));
+	fillGround(volume);
+	digTrench(volume);
+	NavigationGrid navigation;
+	navigation.build(volume, standOnSolid);
+
+	core::List<glm::ivec3> listResult;
+	volume.setVoxel(20, 0, 30, voxel::Voxel());
+	navigation.update(volume, voxel::Region(20, 0, 30, 20, 0, 30), standOnSolid);
+	{
+		AStarPathfinder pathfinder(params(volume, navigation, &listResult));
+		EXPECT_FALSE(pathfinder.execute());
+	}
+
+	// a bridge over the trench
+	volume.setVoxel(20, 0, 5, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	navigation.update(volume, voxel::Region(20, 0, 5, 20, 0, 5), standOnSolid);
+	{
+		AStarPathfinder pathfinder(params(volume, navigation, &listResult));
+		ASSERT_TRUE(pathfinder.execute());
+		validatePath(volume, listResult);
+		EXPECT_LT(listResult.size(), 50u);
+	}
+}
+
+TEST_F(NavigationGridTest, testFindPaths) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 40, 3, 40));
+	fillGround(volume);
+	digTrench(volume);
+	NavigationGrid navigation;
+	navigation.build(volume, standOnSolid);
+
+	core::DynamicArray<AStarPathQuery> queries;
+	for (int i = 0; i < 8; ++i) {
+		AStarPathQuery query;
+		query.start = glm::ivec3(i, 1, 40 - i * 5);
+		query.end = glm::ivec3(40 - i, 1, i * 5);
+		queries.push_back(query);
+	}
+	AStarPathQuery unreachable;
+	unreachable.start = glm::ivec3(0, 1, 0);
+	unreachable.end = glm::ivec3(20, 1, 0);
+	queries.push_back(unreachable);
+
+	core::List<glm::ivec3> listResult;
+	const AStarPathfinderParams<voxel::RawVolume> &queryParams = params(volume, navigation, &listResult);
+	findPaths(queryParams, queries);
+	for (const AStarPathQuery &query : queries) {
+		AStarPathfinderParams<voxel::RawVolume> singleParams(queryParams);
+		singleParams.start = query.start;
+		singleParams.end = query.end;
+		AStarPathfinder pathfinder(singleParams);
+		ASSERT_EQ(pathfinder.execute(), query.found);
+		EXPECT_EQ(listResult.size(), query.result.size());
+		validatePath(volume, query.result);
+	}
+	EXPECT_TRUE(queries[0].found);
+	EXPECT_FALSE(queries.back().found);
+}
+
+} // namespace voxelutil
@@ -6,7 +6,9 @@
 #include "app/tests/AbstractTest.h"
 #include "core/GLMConst.h"
 #include "core/collection/DynamicArray.h"
+#include "math/Random.h"
 #include "voxel/RawVolume.h"
+#include "voxel/VolumeOccupancy.h"
 #include <gtest/gtest.h>
 
 namespace voxelutil {
@@ -548,4 +550,118 @@ TEST_F(RaycastTest, testRaycastCornerHitFraction) {
 	EXPECT_NEAR(result.length, glm::length(dir) * 0.375f, 0.0001f);
 }
 
+TEST_F(RaycastTest, testDDASkipMatchesStepping) {
+	math::Random random(42);
+	for (int n = 0; n < 1000; ++n) {
+		const glm::vec3 start(random.randomf(-20.0f, 20.0f), random.randomf(-20.0f, 20.0f),
+							  random.randomf(-20.0f, 20.0f));
+		const glm::vec3 end(random.randomf(-20.0f, 20.0f), random.randomf(-20.0f, 20.0f),
+							random.randomf(-20.0f, 20.0f));
+		const float t = random.randomf(0.0f, 1.2f);
+		// do the crossings below the parameter one by one
+		RaycastDDA stepped(start, end);
+		bool steppedEnd = false;
+		while (stepped.nextParam() < t) {
+			if (stepped.step() == -1) {
+				steppedEnd = true;
+				break;
+			}
+		}
+		RaycastDDA skipped(start, end);
+		const bool reachedEnd = !skipped.skip(t);
+		ASSERT_EQ(stepped.position(), skipped.position()) << "ray " << n;
+		ASSERT_EQ(steppedEnd, reachedEnd) << "ray " << n;
+		ASSERT_EQ(stepped.lastNormal(), skipped.lastNormal()) << "ray " << n;
+	}
+}
+
+TEST_F(RaycastTest, testOccupancyMatchesRaycast) {
+	voxel::RawVolume volume({0, 127});
+	math::Random random(1);
+	for (int n = 0; n < 20; ++n) {
+		const glm::ivec3 center(random.random(0, 127), random.random(0, 127), random.random(0, 127));
+		const int size = random.random(0, 4);
+		for (int z = -size; z <= size; ++z) {
+			for (int y = -size; y <= size; ++y) {
+				for (int x = -size; x <= size; ++x) {
+					volume.setVoxel(center + glm::ivec3(x, y, z), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+				}
+			}
+		}
+	}
+	voxel::VolumeOccupancy occupancy;
+	occupancy.build(volume);
+
+	int hits = 0;
+	for (int n = 0; n < 2000; ++n) {
+		const glm::vec3 start(random.randomf(-50.0f, 180.0f), random.randomf(-50.0f, 180.0f),
+							  random.randomf(-50.0f, 180.0f));
+		const glm::vec3 end(random.randomf(-50.0f, 180.0f), random.randomf(-50.0f, 180.0f),
+							random.randomf(-50.0f, 180.0f));
+		SimpleRaycastFunctor expected;
+		const RaycastResult expectedResult = raycastWithEndpoints(&volume, start, end, expected);
+		SimpleRaycastFunctor functor;
+		const RaycastResult result = raycastWithEndpoints(&volume, occupancy, start, end, functor);
+		ASSERT_EQ(expected.hitSolid, functor.hitSolid) << "ray " << n;
+		ASSERT_EQ(expected.hitPosition, functor.hitPosition) << "ray " << n;
+		ASSERT_EQ(expectedResult.type, result.type) << "ray " << n;
+		ASSERT_EQ(expectedResult.normal, result.normal) << "ray " << n;
+		ASSERT_FLOAT_EQ(expectedResult.length, result.length) << "ray " << n;
+		ASSERT_FLOAT_EQ(expectedResult.fract, result.fract) << "ray " << n;
+		ASSERT_LE(functor.visitedVoxels, expected.visitedVoxels) << "ray " << n;
+		if (functor.hitSolid) {
+			++hits;
+		}
+	}
+	EXPECT_GT(hits, 0);
+}
+
+TEST_F(RaycastTest, testOccupancyEntryAndExit) {
+	voxel::RawVolume volume({0, 127});
+	volume.setVoxel(glm::ivec3(100, 100, 100), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	voxel::VolumeOccupancy occupancy;
+	occupancy.build(volume);
+
+	// the first and the last voxel inside the volume and the first one after leaving it are visited
+	struct TrackingFunctor {
+		bool entered = false;
+		bool left = false;
+		glm::ivec3 firstPosition{0};
+		glm::ivec3 lastPosition{0};
+		glm::ivec3 leftPosition{0};
+		int visitedVoxels = 0;
+
+		bool operator()(voxel::RawVolume::Sampler &sampler) {
+			++visitedVoxels;
+			if (sampler.currentPositionValid()) {
+				if (!entered) {
+					entered = true;
+					firstPosition = sampler.position();
+				}
+				lastPosition = sampler.position();
+			} else if (entered) {
+				left = true;
+				leftPosition = sampler.position();
+				return false;
+			}
+			return true;
+		}
+	};
+
+	const glm::vec3 start(-500.5f, 10.3f, 20.7f);
+	const glm::vec3 end(600.5f, 60.1f, 40.2f);
+	TrackingFunctor expected;
+	const RaycastResult expectedResult = raycastWithEndpoints(&volume, start, end, expected);
+	TrackingFunctor functor;
+	const RaycastResult result = raycastWithEndpoints(&volume, occupancy, start, end, functor);
+	ASSERT_TRUE(expected.left);
+	EXPECT_TRUE(functor.left);
+	EXPECT_EQ(expected.firstPosition, functor.firstPosition);
+	EXPECT_EQ(expected.lastPosition, functor.lastPosition);
+	EXPECT_EQ(expected.leftPosition, functor.leftPosition);
+	EXPECT_EQ(expectedResult.normal, result.normal);
+	EXPECT_FLOAT_EQ(expectedResult.length, result.length);
+	EXPECT_LT(functor.visitedVoxels, expected.visitedVoxels / 10);
+}
+
 } // namespace voxelutil
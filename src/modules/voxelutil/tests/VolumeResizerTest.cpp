@@ -28,4 +28,17 @@ TEST_F(VolumeResizerTest, testResize) {
 	ASSERT_TRUE(newRegion.voxels() == v->region().voxels());
 }
 
+TEST_F(VolumeResizerTest, testResizeInPlace) {
+	voxel::RawVolume volume({-8, 8});
+	const voxel::Region oldRegion = volume.region();
+	volume.setVoxel(oldRegion.getLowerCorner(), voxel::createVoxel(voxel::VoxelType::Generic, 0));
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(voxelutil::resize(volume, glm::ivec3(1, 0, 0)));
+	}
+	EXPECT_EQ(oldRegion.getUpperX() + 8, volume.region().getUpperX());
+	EXPECT_TRUE(voxel::isBlocked(volume.voxel(oldRegion.getLowerCorner()).getMaterial()));
+	EXPECT_FALSE(voxel::isBlocked(volume.voxel(volume.region().getUpperCorner()).getMaterial()));
+	EXPECT_FALSE(voxelutil::resize(volume, voxel::Region::InvalidRegion));
+}
+
 } // namespace voxelutil
@@ -5,6 +5,7 @@
 #include "voxelutil/VolumeSculpt.h"
 #include "app/tests/AbstractTest.h"
 #include "voxel/BitVolume.h"
+#include "voxel/BrickedVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/SparseVolume.h"
 #include "voxel/Voxel.h"
@@ -1678,6 +1679,48 @@ TEST_F(VolumeSculptTest, testSmoothWallFillsValley) {
 	EXPECT_TRUE(voxel::isBlocked(volume.voxel(4, 5, 4).getMaterial()));
 }
 
+TEST_F(VolumeSculptTest, testSmoothWallBrickedColorSource) {
+	// the bricked color source must give the same result as the linear one
+	const voxel::Region region(0, 11);
+	voxel::RawVolume volume(region);
+	fillRegion(volume, voxel::Region(glm::ivec3(1, 3, 1), glm::ivec3(10, 5, 10)), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	fillRegion(volume, voxel::Region(glm::ivec3(4, 6, 4), glm::ivec3(5, 8, 5)), voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	volume.setVoxel(8, 5, 8, voxel::Voxel());
+	volume.setVoxel(8, 4, 8, voxel::Voxel());
+
+	voxel::BitVolume solidLinear(region);
+	for (int z = 0; z <= 11; ++z) {
+		for (int y = 0; y <= 11; ++y) {
+			for (int x = 0; x <= 11; ++x) {
+				if (voxel::isBlocked(volume.voxel(x, y, z).getMaterial())) {
+					solidLinear.setVoxel(glm::ivec3(x, y, z), true);
+				}
+			}
+		}
+	}
+	voxel::BitVolume solidBricked = solidLinear;
+	const voxel::BitVolume anchors(region);
+	voxel::BrickedVolume bricked(volume);
+	const voxel::Voxel fill = voxel::createVoxel(voxel::VoxelType::Generic, 3);
+
+	core::DynamicArray<glm::ivec3> addedLinear;
+	sculptSmoothWall(solidLinear, volume, anchors, voxel::FaceNames::PositiveY, 5, fill, 256,
+					 SmoothWallInterp::InverseDistance, true, addedLinear);
+	core::DynamicArray<glm::ivec3> addedBricked;
+	sculptSmoothWall(solidBricked, bricked, anchors, voxel::FaceNames::PositiveY, 5, fill, 256,
+					 SmoothWallInterp::InverseDistance, true, addedBricked);
+
+	EXPECT_EQ(addedLinear.size(), addedBricked.size());
+	for (int z = 0; z <= 11; ++z) {
+		for (int y = 0; y <= 11; ++y) {
+			for (int x = 0; x <= 11; ++x) {
+				ASSERT_EQ(solidLinear.hasValue(x, y, z), solidBricked.hasValue(x, y, z)) << x << ":" << y << ":" << z;
+				ASSERT_EQ(volume.voxel(x, y, z), bricked.voxel(x, y, z)) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+}
+
 TEST_F(VolumeSculptTest, testSmoothWallPreservesEdges) {
 	// Edge columns should never be modified even when they differ
 	voxel::Region region(0, 9);
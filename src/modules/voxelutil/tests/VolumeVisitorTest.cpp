@@ -127,6 +127,24 @@ TEST_F(VolumeVisitorTest, testVisitConnectedByVoxel) {
 	EXPECT_EQ(3, cnt);
 }
 
+TEST_F(VolumeVisitorTest, testVisitConnectedStartPosition) {
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 3, 3, 3));
+	const voxel::Voxel voxel1 = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	EXPECT_TRUE(volume.setVoxel(1, 1, 1, voxel1));
+
+	// a single voxel without any matching neighbour is visited, too
+	int visited = 0;
+	auto visitor = [&visited](int x, int y, int z, const voxel::Voxel &) {
+		EXPECT_EQ(glm::ivec3(1, 1, 1), glm::ivec3(x, y, z));
+		++visited;
+	};
+	EXPECT_EQ(1, visitConnectedByCondition(volume, {1, 1, 1}, visitor));
+	EXPECT_EQ(1, visited);
+
+	// the start position doesn't match the condition
+	EXPECT_EQ(0, visitConnectedByCondition(volume, {0, 0, 0}));
+}
+
 TEST_F(VolumeVisitorTest, testVisitVisibleSurface) {
 	const voxel::Region region(0, 0, 0, 3, 5, 3);
 	const voxel::Voxel voxel1 = voxel::createVoxel(voxel::VoxelType::Generic, 1);
@@ -43,6 +43,9 @@
 #include "voxelformat/VolumeFormat.h"
 #include "voxelformat/private/mesh/gis/OSMDataLoader.h"
 #include "voxelgenerator/LUAApi.h"
+#include "voxelpathtracer/BatchRenderer.h"
+#include "voxelpathtracer/PathTracer.h"
+#include "voxelpathtracer/PathTracerState.h"
 #include "voxelutil/Hollow.h"
 #include "voxelutil/ImageUtils.h"
 #include "voxelutil/VolumeCropper.h"
@@ -54,6 +57,7 @@
 #ifndef GLM_ENABLE_EXPERIMENTAL
 #define GLM_ENABLE_EXPERIMENTAL
 #endif
+#include <glm/common.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/trigonometric.hpp>
@@ -82,6 +86,8 @@ app::AppState VoxConvert::onConstruct() {
 	registerArg("--wildcard")
 		.setShort("-w")
 		.setDescription("Allow to specify input file filter if --input is a directory");
+	registerArg("--load-region")
+		.setDescription("Only load the given world space box <x1:y1:z1:x2:y2:z2> (minecraft regions and worlds)");
 	registerArg("--merge").setShort("-m").setDescription("Merge models into one volume").addFlag(ARGUMENT_FLAG_BOOL);
 	registerArg("--mirror").setDescription("Mirror by the given axis (x, y or z)");
 	registerArg("--output")
@@ -91,6 +97,24 @@ app::AppState VoxConvert::onConstruct() {
 	registerArg("--rotate")
 		.setDescription(
 			"Rotate by 90 degree at the given axis (x, y or z), specify e.g. x:180 to rotate around x by 180 degree.");
+	registerArg("--render")
+		.setDescription("Render the scene with the path tracer into the png output file")
+		.addFlag(ARGUMENT_FLAG_BOOL);
+	registerArg("--render-animation")
+		.setDescription("Render all frames of the given animation into <output>-<frame>.png when --render is used");
+	registerArg("--render-checkpoint")
+		.setDescription("Save the render progress every given seconds to <output>.checkpoint - an interrupted render "
+						"is resumed from there");
+	registerArg("--render-resolution").setDefaultValue("1024").setDescription("The image size of --render");
+	registerArg("--render-samples").setDefaultValue("256").setDescription("The samples per pixel of --render");
+	registerArg("--render-threshold")
+		.setDefaultValue("0.01")
+		.setDescription("Stop sampling image tiles whose relative noise level dropped below this value - 0 disables "
+						"the adaptive sampling of --render");
+	registerArg("--render-time").setDescription("Stop --render after the given seconds per image");
+	registerArg("--render-voxel")
+		.setDescription("Use the voxel traversal instead of the triangle meshes for --render")
+		.addFlag(ARGUMENT_FLAG_BOOL);
 	registerArg("--resize").setDescription("Resize the volume by the given x (right), y (up) and z (back) values");
 	registerArg("--scale").setShort("-s").setDescription("Scale model to 50% of its original size").addFlag(ARGUMENT_FLAG_BOOL);
 	registerArg("--script").setDescription("Apply the given lua script to the output volume");
@@ -315,7 +339,21 @@ app::AppState VoxConvert::onInit() {
 	_splitModels = hasArg("--split");
 	_outputJson = hasArg("--json");
 	_outputImage = hasArg("--image");
+	_renderImage = hasArg("--render");
 	_resizeModels = hasArg("--resize");
+	_loadRegion = hasArg("--load-region");
+	if (_loadRegion) {
+		const core::String &arguments = getArgVal("--load-region");
+		glm::ivec3 mins(0);
+		glm::ivec3 maxs(0);
+		if (SDL_sscanf(arguments.c_str(), "%i:%i:%i:%i:%i:%i", &mins.x, &mins.y, &mins.z, &maxs.x, &maxs.y,
+					   &maxs.z) != 6) {
+			Log::error("Invalid --load-region argument '%s' - expected x1:y1:z1:x2:y2:z2", arguments.c_str());
+			return app::AppState::InitFailure;
+		}
+		_loadRegionMins = glm::min(mins, maxs);
+		_loadRegionMaxs = glm::max(mins, maxs);
+	}
 
 	Log::info("Options");
 	if (inputIsMesh || outputIsMesh) {
@@ -355,6 +393,7 @@ app::AppState VoxConvert::onInit() {
 
 	Log::info("* show scene graph:  - %s", (_outputJson ? "true" : "false"));
 	Log::info("* scene graph image: - %s", (_outputImage ? "true" : "false"));
+	Log::info("* render image:      - %s", (_renderImage ? "true" : "false"));
 	Log::info("* merge models:      - %s", (_mergeModels ? "true" : "false"));
 	Log::info("* scale models:      - %s", (_scaleModels ? "true" : "false"));
 	Log::info("* crop models:       - %s", (_cropModels ? "true" : "false"));
@@ -366,6 +405,10 @@ app::AppState VoxConvert::onInit() {
 	Log::info("* export palette:    - %s", (_exportPalette ? "true" : "false"));
 	Log::info("* export models:     - %s", (_exportModels ? "true" : "false"));
 	Log::info("* resize models:     - %s", (_resizeModels ? "true" : "false"));
+	if (_loadRegion) {
+		Log::info("* load region:       - %i:%i:%i:%i:%i:%i", _loadRegionMins.x, _loadRegionMins.y, _loadRegionMins.z,
+				  _loadRegionMaxs.x, _loadRegionMaxs.y, _loadRegionMaxs.z);
+	}
 
 	if (core::getVar(cfg::MetricFlavor)->strVal().empty()) {
 		Log::info(
@@ -387,6 +430,10 @@ app::AppState VoxConvert::onInit() {
 		Log::error("No output specified");
 		return app::AppState::InitFailure;
 	}
+	if (_renderImage && (outfiles.empty() || !io::isA(outfiles[0], io::format::png()))) {
+		Log::error("--render needs a png output file");
+		return app::AppState::InitFailure;
+	}
 
 	static image::ImagePtr thumbnail;
 	if (infiles.size() == 1) {
@@ -679,6 +726,13 @@ app::AppState VoxConvert::onInit() {
 		}
 	}
 
+	if (_renderImage) {
+		if (!render(sceneGraph, outfiles[0])) {
+			return app::AppState::InitFailure;
+		}
+		return state;
+	}
+
 	for (const core::String &outfile : outfiles) {
 		if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, palette::palettes()))) {
 			// if the given format is a palette only format (some voxel formats might have the same
@@ -711,6 +765,74 @@ app::AppState VoxConvert::onInit() {
 	return state;
 }
 
+bool VoxConvert::render(scenegraph::SceneGraph &sceneGraph, const core::String &outfile) {
+	voxelpathtracer::PathTracer pathTracer;
+	voxelpathtracer::PathTracerState &pt = pathTracer.state();
+	pt.voxelTraversal = hasArg("--render-voxel");
+	pt.params.resolution = core::string::toInt(getArgVal("--render-resolution", "1024"));
+	pt.params.samples = core::string::toInt(getArgVal("--render-samples", "256"));
+
+	voxelpathtracer::BatchRenderOptions options;
+	options.adaptiveThreshold = core::string::toFloat(getArgVal("--render-threshold", "0.01"));
+	options.timeBudget = core::string::toDouble(getArgVal("--render-time", "0"));
+	if (hasArg("--render-checkpoint")) {
+		options.checkpointInterval = core::string::toDouble(getArgVal("--render-checkpoint"));
+	}
+
+	core::DynamicArray<core::String> outputs;
+	scenegraph::FrameIndex frames = 1;
+	if (hasArg("--render-animation")) {
+		const core::String &animation = getArgVal("--render-animation");
+		if (!sceneGraph.setAnimation(animation)) {
+			Log::error("Failed to activate the animation '%s'", animation.c_str());
+			return false;
+		}
+		frames = core_max(1, sceneGraph.maxFrames());
+		const core::String &base = core::string::stripExtension(outfile);
+		const core::String &ext = core::string::extractExtension(outfile);
+		for (scenegraph::FrameIndex frame = 0; frame < frames; ++frame) {
+			outputs.push_back(core::String::format("%s-%04i.%s", base.c_str(), frame, ext.c_str()));
+		}
+	} else {
+		outputs.push_back(outfile);
+	}
+
+	if (!pathTracer.setup(sceneGraph)) {
+		Log::error("Failed to create the path tracer scene");
+		return false;
+	}
+	for (scenegraph::FrameIndex frame = 0; frame < frames; ++frame) {
+		const core::String &output = outputs[frame];
+		if (frame > 0) {
+			// only the transforms of the nodes change between the frames - the meshes are reused
+			pt.frame = frame;
+			pathTracer.syncScene(sceneGraph);
+		}
+		if (hasArg("--render-checkpoint")) {
+			options.checkpointFile = output + ".checkpoint";
+		}
+		voxelpathtracer::BatchRenderer renderer(pathTracer, options);
+		if (!renderer.render()) {
+			Log::error("Failed to render %s", output.c_str());
+			return false;
+		}
+		const image::ImagePtr &image = pathTracer.image();
+		io::FilePtr outputFile = filesystem()->open(output, io::FileMode::SysWrite);
+		if (!outputFile->validHandle()) {
+			Log::error("Could not open target file: %s", output.c_str());
+			return false;
+		}
+		io::FileStream outStream(outputFile);
+		if (!image || !image::writePNG(image, outStream)) {
+			Log::error("Failed to write image to %s", output.c_str());
+			return false;
+		}
+		Log::info("Wrote image to %s (%i samples in %.1f seconds)", output.c_str(), renderer.minTileSamples(),
+				  renderer.seconds());
+	}
+	return true;
+}
+
 void VoxConvert::applyFilters(scenegraph::SceneGraph &sceneGraph, const core::DynamicArray<core::String> &infiles,
 							  const core::DynamicArray<core::String> &outfiles) {
 	const bool applyFilter = hasArg("--filter");
@@ -779,6 +901,9 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 	scenegraph::SceneGraph newSceneGraph;
 	voxelformat::LoadContext loadCtx;
 	loadCtx.progress = progressSink();
+	if (_loadRegion) {
+		loadCtx.setRegionFilter(_loadRegionMins, _loadRegionMaxs);
+	}
 	io::FileDescription fileDesc;
 	fileDesc.set(infile);
 	if (!voxelformat::loadFormat(fileDesc, archive, newSceneGraph, loadCtx)) {
@@ -948,12 +1073,9 @@ void VoxConvert::resize(const glm::ivec3 &size, scenegraph::SceneGraph &sceneGra
 	Log::info("Resize models");
 	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
 		scenegraph::SceneGraphNode &node = *iter;
-		voxel::RawVolume *v = voxelutil::resize(node.volume(), size);
-		if (v == nullptr) {
+		if (!voxelutil::resize(*node.volume(), size)) {
 			Log::warn("Failed to resize volume");
-			continue;
 		}
-		node.setVolume(v);
 	}
 }
 
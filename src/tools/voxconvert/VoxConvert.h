@@ -41,7 +41,11 @@ private:
 	bool _splitModels = false;
 	bool _outputJson = false;
 	bool _outputImage = false;
+	bool _renderImage = false;
 	bool _resizeModels = false;
+	bool _loadRegion = false;
+	glm::ivec3 _loadRegionMins{0};
+	glm::ivec3 _loadRegionMaxs{0};
 	core::ProgressBar _progressBar;
 
 	core::IProgress *progressSink() {
@@ -77,6 +81,7 @@ protected:
 	void exportModelsIntoSingleObjects(scenegraph::SceneGraph &sceneGraph, const core::String &inputfile,
 									   const core::String &ext);
 	void split(const glm::ivec3 &size, scenegraph::SceneGraph &sceneGraph);
+	bool render(scenegraph::SceneGraph &sceneGraph, const core::String &outfile);
 
 public:
 	VoxConvert(const io::FilesystemPtr &filesystem, const core::TimeProviderPtr &timeProvider);
@@ -188,7 +188,7 @@ bool BrushTool::executeBrush(ToolContext &ctx, const core::UUID &nodeUUID, Brush
 
 	const voxel::Region &region = wrapper.dirtyRegion();
 	if (region.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), region);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id, "Brush executed successfully", false);
 	}
 
@@ -164,7 +164,7 @@ bool ExtrudeBrushTool::execute(const json::Json &id, const json::Json &args, Too
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id,
 						  core::String::format("Extrude executed successfully (face=%s, depth=%d)",
 											   faceStr.c_str(), depth),
@@ -116,7 +116,7 @@ bool LineBrushTool::execute(const json::Json &id, const json::Json &args, ToolCo
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id, "Line drawn successfully", false);
 	}
 
@@ -179,7 +179,7 @@ bool PaintBrushTool::execute(const json::Json &id, const json::Json &args, ToolC
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id, core::String::format("Paint brush '%s' executed successfully", paintModeStr.c_str()),
 						  false);
 	}
@@ -59,7 +59,7 @@ bool PlaceVoxelsTool::execute(const json::Json &id, const json::Json &args, Tool
 
 	const voxel::Region &region = wrapper.dirtyRegion();
 	if (region.isValid()) {
-		ctx.sceneMgr->modified(nodeUUID, region);
+		ctx.sceneMgr->modified(nodeUUID, wrapper.dirtyChunks());
 		return ctx.result(id, "Voxels placed successfully", false);
 	}
 	return ctx.result(id, "No voxels were placed", true);
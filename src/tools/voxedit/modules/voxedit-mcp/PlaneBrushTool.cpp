@@ -157,7 +157,7 @@ bool PlaneBrushTool::execute(const json::Json &id, const json::Json &args, ToolC
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id, "Plane extrusion executed successfully", false);
 	}
 
@@ -198,7 +198,7 @@ bool SculptBrushTool::execute(const json::Json &id, const json::Json &args, Tool
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id,
 						  core::String::format("Sculpt '%s' executed successfully (strength=%.2f, iterations=%d)",
 											   sculptModeStr.c_str(), strength, iterations),
@@ -155,7 +155,7 @@ bool SelectBrushTool::execute(const json::Json &id, const json::Json &args, Tool
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		const char *action = clearSelection ? "cleared" : "created";
 		return ctx.result(
 			id, core::String::format("Selection %s successfully with mode '%s'", action, selectModeStr.c_str()), false);
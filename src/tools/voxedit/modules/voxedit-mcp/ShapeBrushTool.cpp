@@ -128,7 +128,7 @@ bool ShapeBrushTool::execute(const json::Json &id, const json::Json &args, ToolC
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id, core::String::format("Shape '%s' created successfully", shapeTypeStr.c_str()), false);
 	}
 
@@ -202,7 +202,7 @@ bool TransformBrushTool::execute(const json::Json &id, const json::Json &args, T
 
 	const voxel::Region &dirtyRegion = wrapper.dirtyRegion();
 	if (dirtyRegion.isValid()) {
-		ctx.sceneMgr->modified(node->uuid(), dirtyRegion);
+		ctx.sceneMgr->modified(node->uuid(), wrapper.dirtyChunks());
 		return ctx.result(id,
 						  core::String::format("Transform '%s' executed successfully", transformModeStr.c_str()),
 						  false);
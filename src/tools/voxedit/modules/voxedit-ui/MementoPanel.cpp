@@ -31,7 +31,7 @@ static void stateTooltip(const memento::MementoState &state) {
 		ImGui::Text(" - parent: %s", parentUUIDStr.c_str());
 		ImGui::Text(" - name: %s", state.name.c_str());
 		ImGui::Text(" - type: %s", _(scenegraph::SceneGraphNodeTypeStr[(int)state.nodeType]));
-		ImGui::Text(" - volume: %s", state.data.hasVolume() ? "volume" : "empty");
+		ImGui::Text(" - volume: %s", !state.data.hasVolume() ? "empty" : (state.data.spilled() ? "spilled" : "volume"));
 		const glm::ivec3 &dataMins = state.dataRegion().getLowerCorner();
 		const glm::ivec3 &dataMaxs = state.dataRegion().getUpperCorner();
 		ImGui::Text(" - dataregion: mins(%i:%i:%i)/maxs(%i:%i:%i)", dataMins.x, dataMins.y, dataMins.z, dataMaxs.x, dataMaxs.y, dataMaxs.z);
@@ -82,6 +82,16 @@ void MementoPanel::update(const char *id, command::CommandExecutionListener &lis
 		const memento::MementoHandler &mementoHandler = _sceneMgr->mementoHandler();
 		const int currentStatePos = mementoHandler.statePosition();
 		ImGui::Text(_("Current state: %i / %i"), currentStatePos, (int)mementoHandler.stateSize());
+		const memento::MementoStatistics &stats = mementoHandler.statistics();
+		const core::String &resident = core::string::humanSize(stats.residentBytes);
+		const core::String &spilled = core::string::humanSize(stats.spilledBytes);
+		ImGui::Text(_("Memory: %s (%i states), on disk: %s (%i states)%s"), resident.c_str(), stats.residentStates,
+					spilled.c_str(), stats.spilledStates, stats.spilling ? " ..." : "");
+		if (ImGui::BeginItemTooltip()) {
+			const core::String &journal = core::string::humanSize(stats.journalBytes);
+			ImGui::Text(_("Journal file size: %s"), journal.c_str());
+			ImGui::EndTooltip();
+		}
 
 		if (ImGui::BeginListBox("##history-actions", ImVec2(-FLT_MIN, -FLT_MIN))) {
 			struct State {
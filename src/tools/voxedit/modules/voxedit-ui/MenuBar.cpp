@@ -183,6 +183,7 @@ bool MenuBar::update(ui::IMGUIApp *app, command::CommandExecutionListener &liste
 			ImGui::CommandIconMenuItem(ICON_LC_SCAN, _("Select Only Corners"), "selectonlycorners", true, &listener);
 			ImGui::Separator();
 			ImGui::CommandIconMenuItem(ICON_LC_EXPAND, _("Grow Selection"), "selectiongrow", true, &listener);
+			ImGui::CommandIconMenuItem(ICON_LC_SHRINK, _("Shrink Selection"), "selectionshrink", true, &listener);
 			ImGui::CheckboxVar(cfg::VoxEditAutoSelect);
 			ImGui::EndMenu();
 		}
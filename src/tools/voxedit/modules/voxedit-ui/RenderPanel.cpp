@@ -10,6 +10,7 @@
 #include "ui/IMGUIEx.h"
 #include "ui/IconsLucide.h"
 #include "ui/ScopedPanel.h"
+#include "video/Camera.h"
 #include "video/Texture.h"
 #include "voxedit-util/Config.h"
 #include "voxedit-util/SceneManager.h"
@@ -18,6 +19,25 @@
 
 namespace voxedit {
 
+static const voxelpathtracer::PathTracerCamera *toPathTracerCamera(const video::Camera *camera,
+																	voxelpathtracer::PathTracerCamera &out) {
+	if (camera == nullptr) {
+		return nullptr;
+	}
+	out.eye = camera->eye();
+	out.target = camera->target();
+	out.up = camera->up();
+	out.size = camera->size();
+	out.orthographic = camera->isOrthographic();
+	out.fieldOfView = camera->fieldOfView();
+	if (camera->rotationType() == video::CameraRotationType::Target) {
+		out.focus = camera->targetDistance();
+	} else {
+		out.focus = camera->farPlane();
+	}
+	return &out;
+}
+
 bool RenderPanel::init() {
 	_texture = video::createEmptyTexture("pathtracer");
 	return true;
@@ -118,13 +138,35 @@ void RenderPanel::renderSettings(const scenegraph::SceneGraph &sceneGraph) {
 	if (ImGui::BeginIconMenu(ICON_LC_WRENCH, _("Advanced"))) {
 		changed += ImGui::Checkbox(_("No caustics"), &params.nocaustics);
 		ImGui::TooltipTextUnformatted(_("Removes certain paths that cause caustics"));
+		changed += ImGui::Checkbox(_("Voxel traversal"), &state.voxelTraversal);
+		ImGui::TooltipTextUnformatted(_("Trace the voxels directly instead of building triangle meshes"));
 		changed += ImGui::Checkbox(_("High Quality BVH"), &params.highqualitybvh);
 		ImGui::TooltipTextUnformatted(_("High quality bounding volume hierarchy"));
 		ImGui::EndMenu();
 	}
 
 	if (changed > 0) {
-		_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera());
+		voxelpathtracer::PathTracerCamera camera;
+		_pathTracer.restart(sceneGraph, toPathTracerCamera(_sceneMgr->activeCamera(), camera));
+	}
+}
+
+void RenderPanel::syncScene(const scenegraph::SceneGraph &sceneGraph) {
+	const uint64_t modificationCounter = _sceneMgr->modificationCounter();
+	if (modificationCounter == _modificationCounter) {
+		// nothing was changed - don't compare the nodes of the scene with the path tracer scene
+		return;
+	}
+	for (auto iter = sceneGraph.beginAllModels(); iter != sceneGraph.end(); ++iter) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		if (_sceneMgr->nodeModifiedSince(node.uuid(), _modificationCounter)) {
+			_pathTracer.nodeModified(node.uuid());
+		}
+	}
+	_sceneMgr->pruneNodeModifications(modificationCounter);
+	_modificationCounter = modificationCounter;
+	if (_pathTracer.updateScene(sceneGraph)) {
+		_currentSample = 0;
 	}
 }
 
@@ -147,12 +189,14 @@ void RenderPanel::renderMenuBar(const scenegraph::SceneGraph &sceneGraph) {
 		}
 		if (_pathTracer.started()) {
 			if (ImGui::IconMenuItem(ICON_LC_REFRESH_CW, _("Sync camera"))) {
-				_pathTracer.restart(sceneGraph, _sceneMgr->activeCamera());
+				voxelpathtracer::PathTracerCamera camera;
+				_pathTracer.restart(sceneGraph, toPathTracerCamera(_sceneMgr->activeCamera(), camera));
 			}
 			ImGui::TooltipTextUnformatted(_("Restart with the current viewport camera"));
 			if (ImGui::IconMenuItem(ICON_LC_CIRCLE_STOP, _("Stop path tracer"))) {
 				_pathTracer.stop();
 			}
+			syncScene(sceneGraph);
 			const voxelpathtracer::PathTracerState &state = _pathTracer.state();
 			const yocto::trace_params &params = state.params;
 			ImGui::Text(_("Sample %i / %i"), _currentSample, params.samples);
@@ -163,7 +207,9 @@ void RenderPanel::renderMenuBar(const scenegraph::SceneGraph &sceneGraph) {
 			}
 		} else {
 			if (ImGui::IconMenuItem(ICON_LC_PLAY, _("Start path tracer"))) {
-				_pathTracer.start(sceneGraph, _sceneMgr->activeCamera());
+				_modificationCounter = _sceneMgr->modificationCounter();
+				voxelpathtracer::PathTracerCamera camera;
+				_pathTracer.start(sceneGraph, toPathTracerCamera(_sceneMgr->activeCamera(), camera));
 			}
 		}
 		ImGui::EndMenuBar();
@@ -26,8 +26,14 @@ private:
 	image::ImagePtr _image;
 	SceneManagerPtr _sceneMgr;
 	int _currentSample = 0;
+	/** the @c SceneManager::modificationCounter() value of the last scene sync */
+	uint64_t _modificationCounter = 0u;
 
 	void renderSettings(const scenegraph::SceneGraph &sceneGraph);
+	/**
+	 * @brief Forward the modifications of the scene to the path tracer - only the changed nodes are rebuilt
+	 */
+	void syncScene(const scenegraph::SceneGraph &sceneGraph);
 	void renderMenuBar(const scenegraph::SceneGraph &sceneGraph);
 
 public:
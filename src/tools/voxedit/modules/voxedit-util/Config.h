@@ -15,6 +15,8 @@ constexpr const char *VoxEditLocalSpace = "ve_localspace";
 constexpr const char *VoxEditGrayInactive = "ve_grayinactive";
 constexpr const char *VoxEditHideInactive = "ve_hideinactive";
 constexpr const char *VoxEditAutoSaveSeconds = "ve_autosaveseconds";
+constexpr const char *VoxEditMementoBudget = "ve_mementobudget";
+constexpr const char *VoxEditMementoHotStates = "ve_mementohotstates";
 constexpr const char *VoxEditAnimationPlaying = "ve_animationplaying";
 constexpr const char *VoxEditTransformUpdateChildren = "ve_transformupdatechildren";
 constexpr const char *VoxEditAmbientColor = "ve_ambientcolor";
@@ -12,7 +12,6 @@
 #include "voxel/RawVolumeWrapper.h"
 #include "voxelutil/FillHollow.h"
 #include "voxelutil/Hollow.h"
-#include "voxelutil/VolumeVisitor.h"
 #include "voxelutil/VoxelUtil.h"
 
 namespace voxedit {
@@ -214,7 +213,7 @@ voxel::Region sceneJobModifiedRegionForResize(const voxel::Region &oldRegion, co
 }
 
 SceneJobResult makeVolumeOperationSceneJobResult(SceneJobType type, const core::UUID &nodeUUID, voxel::RawVolume *snapshot,
-												 const voxel::Region &selectionRegion, const voxel::Voxel &voxel,
+												 const voxel::SelectionMask &selection, const voxel::Voxel &voxel,
 												 bool overrideVoxels) {
 	SceneJobResult result;
 	result.type = type;
@@ -232,14 +231,14 @@ SceneJobResult makeVolumeOperationSceneJobResult(SceneJobType type, const core::
 		voxelutil::clear(wrapper);
 		break;
 	case SceneJobType::DeleteSelectedVolume:
-		if (!selectionRegion.isValid()) {
+		if (selection.empty()) {
 			result.error = "No selected voxels to delete";
 			delete snapshot;
 			return result;
 		}
-		voxelutil::visitVolume(*snapshot, selectionRegion, [&](int x, int y, int z, const voxel::Voxel &) {
+		selection.visit([&](int x, int y, int z) {
 			wrapper.setVoxel(x, y, z, voxel::Voxel());
-		}, voxelutil::VisitSolidOutline());
+		});
 		break;
 	case SceneJobType::HollowVolume:
 		voxelutil::hollow(wrapper);
@@ -11,6 +11,7 @@
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraphAnimation.h"
 #include "voxel/Region.h"
+#include "voxel/SelectionMask.h"
 #include "voxel/Voxel.h"
 #include <stdint.h>
 
@@ -152,7 +153,7 @@ struct SceneJobResult {
 
 voxel::Region sceneJobModifiedRegionForResize(const voxel::Region &oldRegion, const voxel::Region &newRegion);
 SceneJobResult makeVolumeOperationSceneJobResult(SceneJobType type, const core::UUID &nodeUUID, voxel::RawVolume *snapshot,
-												 const voxel::Region &selectionRegion, const voxel::Voxel &voxel,
+												 const voxel::SelectionMask &selection, const voxel::Voxel &voxel,
 												 bool overrideVoxels);
 
 } // namespace voxedit
@@ -246,7 +246,7 @@ bool SceneManager::nodeCalculateNormals(int nodeId, voxel::Connectivity connecti
 		if (fillAndHollow) {
 			voxelutil::hollow(wrapper);
 		}
-		modified(nodeId, wrapper.dirtyRegion(), SceneModifiedFlags::NoResetTrace);
+		modified(nodeId, wrapper.dirtyChunks(), SceneModifiedFlags::NoResetTrace);
 		return true;
 	}
 
@@ -320,7 +320,7 @@ void SceneManager::nodeGroupFillHollow() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
 		voxelutil::fillHollow(wrapper, _modifier->cursorVoxel());
-		modified(node.uuid(), wrapper.dirtyRegion());
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -335,7 +335,7 @@ void SceneManager::nodeGroupFill() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
 		voxelutil::fill(wrapper, _modifier->cursorVoxel(), _modifier->isMode(ModifierType::Override));
-		modified(node.uuid(), wrapper.dirtyRegion());
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -350,7 +350,7 @@ void SceneManager::nodeGroupClear() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
 		voxelutil::clear(wrapper);
-		modified(node.uuid(), wrapper.dirtyRegion());
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -363,15 +363,16 @@ void SceneManager::nodeGroupDeleteSelected() {
 		if (v == nullptr) {
 			return;
 		}
-		const voxel::Region selRegion = selectionCalculateRegion(node);
-		if (!selRegion.isValid()) {
+		if (!node.hasSelection()) {
 			return;
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
-		voxelutil::visitVolume(*v, selRegion, [&](int x, int y, int z, const voxel::Voxel &voxel) {
+		node.selection().visit([&](int x, int y, int z) {
 			wrapper.setVoxel(x, y, z, voxel::Voxel());
-		}, voxelutil::VisitSolidOutline());
-		modified(node.uuid(), wrapper.dirtyRegion());
+		});
+		// the deleted voxels are no longer selected
+		node.clearSelection();
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -390,7 +391,7 @@ void SceneManager::nodeGroupColorSelected(uint8_t colorIndex) {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
 		voxelutil::recolorSelected(wrapper, *v, selRegion, colorIndex);
-		modified(node.uuid(), wrapper.dirtyRegion());
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -407,14 +408,20 @@ void SceneManager::nodeGroupFilterSelection(uint8_t colorIndex, bool deselectMat
 		if (v == nullptr) {
 			return;
 		}
-		voxelutil::visitVolume(*v, selRegion, [&](int x, int y, int z, const voxel::Voxel &voxel) {
+		core::DynamicArray<glm::ivec3> toUnselect;
+		node.selection().visit([&](int x, int y, int z) {
+			const voxel::Voxel &voxel = v->voxel(x, y, z);
+			if (voxel::isAir(voxel.getMaterial())) {
+				return;
+			}
 			const bool matches = voxel.getColor() == colorIndex;
 			if (matches == deselectMatching) {
-				voxel::Voxel updated = voxel;
-				updated.setFlags(voxel.getFlags() & ~voxel::FlagOutline);
-				v->setVoxel(x, y, z, updated);
+				toUnselect.emplace_back(x, y, z);
 			}
-		}, voxelutil::VisitSolidOutline());
+		});
+		for (const glm::ivec3 &pos : toUnselect) {
+			node.unselect(pos);
+		}
 		modified(node.uuid(), selRegion, SceneModifiedFlags::NoUndo);
 	});
 }
@@ -441,7 +448,11 @@ void SceneManager::nodeGroupSelectByAirAxes(int minAxes) {
 			return;
 		}
 		const voxel::Region &volRegion = v->region();
-		voxelutil::visitVolume(*v, selRegion, [&](int x, int y, int z, const voxel::Voxel &voxel) {
+		core::DynamicArray<glm::ivec3> toUnselect;
+		node.selection().visit([&](int x, int y, int z) {
+			if (voxel::isAir(v->voxel(x, y, z).getMaterial())) {
+				return;
+			}
 			int axesWithAir = 0;
 			for (const glm::ivec3 &offset : voxel::arrayPathfinderFaces) {
 				const glm::ivec3 neighbor(x + offset.x, y + offset.y, z + offset.z);
@@ -457,11 +468,12 @@ void SceneManager::nodeGroupSelectByAirAxes(int minAxes) {
 			}
 			const int axisCount = (axesWithAir & 1) + ((axesWithAir >> 1) & 1) + ((axesWithAir >> 2) & 1);
 			if (axisCount < minAxes) {
-				voxel::Voxel updated = voxel;
-				updated.setFlags(voxel.getFlags() & ~voxel::FlagOutline);
-				v->setVoxel(x, y, z, updated);
+				toUnselect.emplace_back(x, y, z);
 			}
-		}, voxelutil::VisitSolidOutline());
+		});
+		for (const glm::ivec3 &pos : toUnselect) {
+			node.unselect(pos);
+		}
 		modified(node.uuid(), selRegion, SceneModifiedFlags::NoUndo);
 	});
 }
@@ -502,8 +514,12 @@ void SceneManager::nodeGroupSelectOnlyWallEdges() {
 			return;
 		}
 		const voxel::Region &volRegion = v->region();
-		voxelutil::visitVolume(*v, selRegion, [&](int x, int y, int z, const voxel::Voxel &voxel) {
+		core::DynamicArray<glm::ivec3> toUnselect;
+		node.selection().visit([&](int x, int y, int z) {
 			const glm::ivec3 pos(x, y, z);
+			if (voxel::isAir(v->voxel(pos).getMaterial())) {
+				return;
+			}
 			bool isWallEdge = false;
 			static constexpr int ringSize = lengthof(ringX);
 			const glm::ivec3 *rings[] = {ringX, ringY, ringZ};
@@ -522,11 +538,12 @@ void SceneManager::nodeGroupSelectOnlyWallEdges() {
 				}
 			}
 			if (!isWallEdge) {
-				voxel::Voxel updated = voxel;
-				updated.setFlags(voxel.getFlags() & ~voxel::FlagOutline);
-				v->setVoxel(x, y, z, updated);
+				toUnselect.push_back(pos);
 			}
-		}, voxelutil::VisitSolidOutline());
+		});
+		for (const glm::ivec3 &pos : toUnselect) {
+			node.unselect(pos);
+		}
 		modified(node.uuid(), selRegion, SceneModifiedFlags::NoUndo);
 	});
 }
@@ -546,49 +563,40 @@ void SceneManager::nodeGroupSelectionGrow() {
 		}
 		const voxel::Region &volRegion = v->region();
 
-		// expand selection region by 1 voxel in each direction, clamped to volume
-		const glm::ivec3 expandedMins = glm::max(selRegion.getLowerCorner() - 1, volRegion.getLowerCorner());
-		const glm::ivec3 expandedMaxs = glm::min(selRegion.getUpperCorner() + 1, volRegion.getUpperCorner());
-		const voxel::Region expandedRegion(expandedMins, expandedMaxs);
-
-		// iterate the expanded shell: for each unselected solid voxel, check if
-		// any of its 26 neighbors (within original selRegion) is selected.
-		// This avoids collecting source positions and produces no duplicates.
+		// visit the 26 neighbors of each selected voxel and collect the unselected solid ones.
+		// The added mask filters the duplicates of voxels that are shared by several selected voxels.
+		const voxel::SelectionMask &selection = node.selection();
+		voxel::SelectionMask added;
 		core::DynamicArray<glm::ivec3> toSelect;
-		voxelutil::visitVolume(*v, expandedRegion, [&](int x, int y, int z, const voxel::Voxel &voxel) {
-			if ((voxel.getFlags() & voxel::FlagOutline) != 0) {
-				return;
-			}
-			auto hasSelectedNeighbor = [&](const glm::ivec3 *offsets, int count) {
-				for (int idx = 0; idx < count; ++idx) {
-					const glm::ivec3 neighbor(x + offsets[idx].x, y + offsets[idx].y, z + offsets[idx].z);
-					if (!selRegion.containsPoint(neighbor)) {
-						continue;
-					}
-					const voxel::Voxel &nv = v->voxel(neighbor);
-					if ((nv.getFlags() & voxel::FlagOutline) != 0) {
-						return true;
-					}
+		auto collect = [&](const glm::ivec3 &pos, const glm::ivec3 *offsets, int count) {
+			for (int idx = 0; idx < count; ++idx) {
+				const glm::ivec3 neighbor = pos + offsets[idx];
+				if (!volRegion.containsPoint(neighbor) || selection.test(neighbor)) {
+					continue;
+				}
+				if (voxel::isAir(v->voxel(neighbor).getMaterial())) {
+					continue;
+				}
+				if (added.set(neighbor)) {
+					toSelect.push_back(neighbor);
 				}
-				return false;
-			};
-			if (hasSelectedNeighbor(voxel::arrayPathfinderFaces, 6) ||
-				hasSelectedNeighbor(voxel::arrayPathfinderEdges, 12) ||
-				hasSelectedNeighbor(voxel::arrayPathfinderCorners, 8)) {
-				toSelect.push_back(glm::ivec3(x, y, z));
 			}
-		}, voxelutil::VisitSolid());
+		};
+		selection.visit([&](int x, int y, int z) {
+			const glm::ivec3 pos(x, y, z);
+			collect(pos, voxel::arrayPathfinderFaces, lengthof(voxel::arrayPathfinderFaces));
+			collect(pos, voxel::arrayPathfinderEdges, lengthof(voxel::arrayPathfinderEdges));
+			collect(pos, voxel::arrayPathfinderCorners, lengthof(voxel::arrayPathfinderCorners));
+		});
 
 		if (toSelect.empty()) {
 			return;
 		}
 
-		// apply selection flags from the destination list
+		// apply the selection from the destination list
 		voxel::Region dirtyRegion = selRegion;
 		for (const glm::ivec3 &pos : toSelect) {
-			voxel::Voxel updated = v->voxel(pos);
-			updated.setFlags(updated.getFlags() | voxel::FlagOutline);
-			v->setVoxel(pos, updated);
+			node.select(pos);
 			dirtyRegion.accumulate(pos);
 		}
 
@@ -596,6 +604,19 @@ void SceneManager::nodeGroupSelectionGrow() {
 	});
 }
 
+void SceneManager::nodeGroupSelectionShrink() {
+	nodeForeachGroup([&](scenegraph::SceneGraphNode &node) {
+		if (!node.isModelNode()) {
+			return;
+		}
+		const voxel::Region &dirtyRegion = node.shrinkSelection();
+		if (!dirtyRegion.isValid()) {
+			return;
+		}
+		modified(node.uuid(), dirtyRegion);
+	});
+}
+
 void SceneManager::nodeGroupHollow() {
 	nodeForeachGroup([&](scenegraph::SceneGraphNode &node) {
 		if (!node.isModelNode()) {
@@ -607,7 +628,7 @@ void SceneManager::nodeGroupHollow() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifier->createRawVolumeWrapper(v);
 		voxelutil::hollow(wrapper);
-		modified(node.uuid(), wrapper.dirtyRegion());
+		modified(node.uuid(), wrapper.dirtyChunks());
 	});
 }
 
@@ -638,7 +659,7 @@ void SceneManager::fillPlane(const image::ImagePtr &image) {
 	}
 	const voxel::Voxel hitVoxel/* = hitCursorVoxel()*/; // TODO: should be an option
 	voxelutil::fillPlane(wrapper, image, hitVoxel, pos, face);
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyChunks());
 }
 
 void SceneManager::nodeUpdateVoxelType(int nodeId, uint8_t palIdx, voxel::VoxelType newType) {
@@ -654,7 +675,7 @@ void SceneManager::nodeUpdateVoxelType(int nodeId, uint8_t palIdx, voxel::VoxelT
 		wrapper.setVoxel(x, y, z, voxel::createVoxel(newType, palIdx));
 	};
 	voxelutil::visitVolumeParallel(wrapper, func, voxelutil::VisitVoxelColor(palIdx));
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyChunks());
 }
 
 bool SceneManager::saveModels(const core::String& dir) {
@@ -886,10 +907,11 @@ void SceneManager::modified(int nodeId, const voxel::Region& modifiedRegion, Sce
 	}
 	const bool invalidateNodeCache = (flags & SceneModifiedFlags::InvalidateNodeCache) == SceneModifiedFlags::InvalidateNodeCache;
 	if (invalidateNodeCache) {
-		// TODO: SELECTION: TODO: PERF this invalidates the cache too often - if nothing regarding selection was changed, we should keep the cache.
-		_selectionRegionCache.invalidate(_sceneGraph.node(nodeId).uuid());
+		// only the modified region is synced into the occupancy of the node
+		_sceneGraph.node(nodeId).occupancyModified(modifiedRegion);
 	}
 	markDirty();
+	_nodeModifications.put(_sceneGraph.node(nodeId).uuid(), _modificationCounter);
 	const bool resetTrace = (flags & SceneModifiedFlags::ResetTrace) == SceneModifiedFlags::ResetTrace;
 	if (resetTrace) {
 		resetLastTrace();
@@ -903,6 +925,32 @@ void SceneManager::modified(const core::UUID &nodeUUID, const voxel::Region &mod
 	}
 }
 
+void SceneManager::modified(int nodeId, const voxel::DirtyChunks &dirtyChunks, SceneModifiedFlags flags) {
+	const core::DynamicArray<voxel::Region> &regions = dirtyChunks.regions();
+	// the chunks were written by a plain voxel::RawVolumeWrapper that bypasses the selection functions of the node -
+	// the written voxels bring their selection flags along
+	if (scenegraph::SceneGraphNode *node = sceneGraphModelNode(nodeId)) {
+		for (const voxel::Region &region : regions) {
+			node->selectionFromFlags(region);
+		}
+	}
+	if (regions.size() <= 1) {
+		modified(nodeId, dirtyChunks.region(), flags);
+		return;
+	}
+	memento::ScopedMementoGroup mementoGroup(*_mementoHandler, "modified");
+	for (const voxel::Region &region : regions) {
+		modified(nodeId, region, flags);
+	}
+}
+
+void SceneManager::modified(const core::UUID &nodeUUID, const voxel::DirtyChunks &dirtyChunks,
+							SceneModifiedFlags flags) {
+	if (const scenegraph::SceneGraphNode *node = sceneGraphNodeByUUID(nodeUUID)) {
+		modified(node->id(), dirtyChunks, flags);
+	}
+}
+
 int SceneManager::nodeColorToNewNode(const voxel::Voxel voxelColor) {
 	const int nodeId = _sceneGraph.activeNode();
 	return nodeColorToNewNode(nodeId, voxelColor);
@@ -922,7 +970,7 @@ int SceneManager::nodeColorToNewNode(int nodeId, const voxel::Voxel voxelColor)
 		wrapper.setVoxel(x, y, z, voxel::Voxel());
 	};
 	voxelutil::visitVolumeParallel(wrapper, func, voxelutil::VisitVoxelColor(voxelColor.getColor()));
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyChunks());
 	scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
 	copyNode(node, newNode, false, true);
 	newNode.setVolume(newVolume);
@@ -966,7 +1014,7 @@ int SceneManager::nodeColorToNewNode(int nodeId, const core::Buffer<uint8_t> &pa
 		return wanted[voxel.getColor()];
 	};
 	voxelutil::visitVolumeParallel(wrapper, func, condition);
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyChunks());
 	scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
 	copyNode(node, newNode, false, true);
 	newNode.setVolume(newVolume);
@@ -1158,14 +1206,14 @@ bool SceneManager::startResizeSceneJob(const SceneJobRequest &request) {
 		result.nodeUUID = nodeUUID;
 
 		progress->setProgress(0.0f);
-		voxel::RawVolume *newVolume = voxelutil::resize(snapshot, newRegion);
-		delete snapshot;
-		if (newVolume == nullptr) {
+		// the job already works on a copy - resize it in place instead of copying it again
+		if (!voxelutil::resize(*snapshot, newRegion)) {
+			delete snapshot;
 			result.error = "Failed to resize volume";
 			return result;
 		}
 		progress->setProgress(1.0f);
-		result.volume = newVolume;
+		result.volume = snapshot;
 		result.modifiedRegion = sceneJobModifiedRegionForResize(oldRegion, newRegion);
 		result.success = true;
 		return result;
@@ -1178,19 +1226,20 @@ bool SceneManager::startVolumeOperationSceneJob(const SceneJobRequest &request)
 	if (node == nullptr || node->volume() == nullptr) {
 		return false;
 	}
-	voxel::Region selectionRegion = voxel::Region::InvalidRegion;
+	voxel::SelectionMask selection;
 	if (request.type == SceneJobType::DeleteSelectedVolume) {
-		selectionRegion = selectionCalculateRegion(*node);
-		if (!selectionRegion.isValid()) {
+		if (!node->hasSelection()) {
 			return false;
 		}
+		// the job works on a copy - the selection of the node may change while it's running
+		selection = node->selection();
 	}
 
 	voxel::RawVolume *snapshot = new voxel::RawVolume(*node->volume());
 	core::SharedProgress *progress = &_sceneJobProgress;
-	core::Future<SceneJobResult> future = app::async([request, snapshot, selectionRegion, progress]() {
+	core::Future<SceneJobResult> future = app::async([request, snapshot, selection, progress]() {
 		core::ProgressScope scope(*progress);
-		return makeVolumeOperationSceneJobResult(request.type, request.nodeUUID, snapshot, selectionRegion,
+		return makeVolumeOperationSceneJobResult(request.type, request.nodeUUID, snapshot, selection,
 												 request.voxel, request.overrideVoxels);
 	});
 	return startActiveSceneJob(request.type, request.text, core::move(future));
@@ -1467,21 +1516,19 @@ void SceneManager::nodeResize(int nodeId, const voxel::Region &region) {
 	if (!region.isValid()) {
 		return;
 	}
-	voxel::RawVolume* v = volume(nodeId);
-	if (v == nullptr) {
+	scenegraph::SceneGraphNode *node = sceneGraphModelNode(nodeId);
+	if (node == nullptr || node->volume() == nullptr) {
 		Log::error("Failed to lookup volume for node %i", nodeId);
 		return;
 	}
+	voxel::RawVolume* v = node->volume();
 	const voxel::Region oldRegion = v->region();
 	Log::debug("Resize volume from %s to %s", oldRegion.toString().c_str(), region.toString().c_str());
-	voxel::RawVolume* newVolume = voxelutil::resize(v, region);
-	if (newVolume == nullptr) {
-		return;
-	}
-	if (!setNewVolume(nodeId, newVolume, false)) {
-		delete newVolume;
+	// growing the volume in place only copies the voxels if the allocated array is exceeded
+	if (!voxelutil::resize(*v, region)) {
 		return;
 	}
+	nodeVolumeChanged(*node);
 	// Use the enclosing region of old and new to ensure the memento captures all changes
 	// and the undo/redo can properly restore the volume in both directions
 	const voxel::Region modifiedRegion(
@@ -1747,6 +1794,12 @@ bool SceneManager::mementoModification(const memento::MementoState& s) {
 			}
 			if (s.hasVolumeData()) {
 				_mementoHandler->extractVolumeRegion(node->volume(), s);
+				// the restored voxels bring their selection flags back
+				voxel::Region restoredRegion = s.data.modifiedRegion();
+				if (!s.data.volumeRegion().containsRegion(restoredRegion)) {
+					restoredRegion = s.data.dataRegion();
+				}
+				node->selectionFromFlags(restoredRegion);
 			}
 		}
 		node->setName(s.name);
@@ -1989,23 +2042,14 @@ voxel::ClipboardData SceneManager::nodeClipboardCopy(scenegraph::SceneGraphNode
 
 	// Create a new volume with the selected voxels
 	voxel::RawVolume *v = new voxel::RawVolume(selectionRegion);
-	const glm::ivec3 &selMins = selectionRegion.getLowerCorner();
-	const glm::ivec3 &selMaxs = selectionRegion.getUpperCorner();
-
-	// TODO: PERF: use a sampler
-	for (int32_t z = selMins.z; z <= selMaxs.z; ++z) {
-		for (int32_t y = selMins.y; y <= selMaxs.y; ++y) {
-			for (int32_t x = selMins.x; x <= selMaxs.x; ++x) {
-				const voxel::Voxel &voxel = node.volume()->voxel(x, y, z);
-				if ((voxel.getFlags() & voxel::FlagOutline) != 0) {
-					// Copy voxel without the outline flag
-					voxel::Voxel copiedVoxel = voxel::createVoxel(voxel.getMaterial(), voxel.getColor(),
-																  voxel.getNormal(), 0, voxel.getBoneIdx());
-					v->setVoxel(x, y, z, copiedVoxel);
-				}
-			}
-		}
-	}
+	const voxel::RawVolume *volume = node.volume();
+	node.selection().visit([&](int x, int y, int z) {
+		const voxel::Voxel &voxel = volume->voxel(x, y, z);
+		// Copy voxel without the outline flag
+		const voxel::Voxel copiedVoxel = voxel::createVoxel(voxel.getMaterial(), voxel.getColor(), voxel.getNormal(),
+															0, voxel.getBoneIdx());
+		v->setVoxel(x, y, z, copiedVoxel);
+	});
 	return voxel::ClipboardData(v, node.palette(), true);
 }
 
@@ -2088,12 +2132,10 @@ void SceneManager::autoSelectSolidVoxels(scenegraph::SceneGraphNode *node, const
 		return;
 	}
 	node->clearSelection();
-	voxel::RawVolume *volume = node->volume();
-	voxelutil::visitVolumeParallel(*volume, region,
-		[volume](int x, int y, int z, const voxel::Voxel &srcVoxel) {
-			voxel::Voxel selected = srcVoxel;
-			selected.setFlags(selected.getFlags() | voxel::FlagOutline);
-			volume->setVoxel(x, y, z, selected);
+	// not in parallel - the selection mask of the node is not thread safe
+	voxelutil::visitVolume(*node->volume(), region,
+		[node](int x, int y, int z, const voxel::Voxel &) {
+			node->select(glm::ivec3(x, y, z));
 		},
 		voxelutil::VisitSolid());
 }
@@ -2152,6 +2194,8 @@ bool SceneManager::nodePaste(int nodeId, const glm::ivec3& pos) {
 	region.shift(pos);
 	modifiedRegion = region;
 	voxelutil::mergeVolumes(node->volume(), node->palette(), _copy.volume, *_copy.palette, region, _copy.volume->region());
+	// the pasted voxels replace the selected ones
+	node->selectionFromFlags(modifiedRegion);
 	Log::debug("Pasted %s", modifiedRegion.toString().c_str());
 	if (!modifiedRegion.isValid()) {
 		Log::warn("paste: modifiedRegion is invalid after paste");
@@ -2184,23 +2228,15 @@ bool SceneManager::nodeCut(int nodeId) {
 	}
 
 	voxel::RawVolume *v = new voxel::RawVolume(selectionRegion);
-	const glm::ivec3 &selMins = selectionRegion.getLowerCorner();
-	const glm::ivec3 &selMaxs = selectionRegion.getUpperCorner();
-
-	// TODO: PERF: use a sampler
-	for (int32_t z = selMins.z; z <= selMaxs.z; ++z) {
-		for (int32_t y = selMins.y; y <= selMaxs.y; ++y) {
-			for (int32_t x = selMins.x; x <= selMaxs.x; ++x) {
-				voxel::Voxel voxel = volume->voxel(x, y, z);
-				if ((voxel.getFlags() & voxel::FlagOutline) != 0) {
-					voxel::Voxel copiedVoxel = voxel::createVoxel(voxel.getMaterial(), voxel.getColor(),
-																  voxel.getNormal(), 0, voxel.getBoneIdx());
-					v->setVoxel(x, y, z, copiedVoxel);
-					volume->setVoxel(x, y, z, voxel::Voxel());
-				}
-			}
-		}
-	}
+	node->selection().visit([&](int x, int y, int z) {
+		const voxel::Voxel &voxel = volume->voxel(x, y, z);
+		const voxel::Voxel copiedVoxel = voxel::createVoxel(voxel.getMaterial(), voxel.getColor(), voxel.getNormal(),
+															0, voxel.getBoneIdx());
+		v->setVoxel(x, y, z, copiedVoxel);
+		volume->setVoxel(x, y, z, voxel::Voxel());
+	});
+	// the cut voxels are gone - and so is their selection
+	node->clearSelection();
 
 	voxel::Region modifiedRegion;
 	if (modifiedRegion.isValid()) {
@@ -2423,6 +2459,7 @@ bool SceneManager::splatMerge(int sourceNodeId) {
 		const int count = voxelutil::mergeVolumes(targetVolume, targetNode.palette(),
 			worldSource, sourcePalette, targetLocalOverlap, worldOverlap);
 		if (count > 0) {
+			targetNode.selectionFromFlags(targetLocalOverlap);
 			modified(targetNode.id(), targetLocalOverlap, SceneModifiedFlags::All);
 			mergedCount += count;
 		}
@@ -2578,13 +2615,12 @@ bool SceneManager::mergeActiveToBackground() {
 				const voxel::Region expandedRegion(
 					glm::min(currentLocalRegion.getLowerCorner(), neededLocalRegion.getLowerCorner()),
 					glm::max(currentLocalRegion.getUpperCorner(), neededLocalRegion.getUpperCorner()));
-				voxel::RawVolume *newVolume = voxelutil::resize(targetVolume, expandedRegion);
-				if (newVolume == nullptr) {
+				if (!voxelutil::resize(*targetVolume, expandedRegion)) {
 					Log::warn("mergeactivetobackground: failed to expand node %i", cell.existingNodeId);
 					continue;
 				}
-				targetNode.setVolume(newVolume);
-				targetVolume = newVolume;
+				// the meshes were extracted for the old region
+				_sceneRenderer->removeNode(targetNode.uuid());
 			}
 
 			// Add missing source colors to the target palette before mapping
@@ -2844,25 +2880,11 @@ bool SceneManager::isSelected(const core::UUID &nodeUUID, const glm::ivec3 &pos)
 	if (node == nullptr) {
 		return false;
 	}
-	const voxel::RawVolume *volume = node->volume();
-	if (volume == nullptr) {
-		return false;
-	}
-	const voxel::Voxel &voxel = volume->voxel(pos);
-	return (voxel.getFlags() & voxel::FlagOutline) != 0;
+	return node->selection().test(pos);
 }
 
 voxel::Region SceneManager::selectionCalculateRegion(const scenegraph::SceneGraphNode &node) const {
-	if (_selectionRegionCache.valid(node.uuid())) {
-		return *_selectionRegionCache.value(node.uuid());
-	}
-	const voxel::RawVolume *volume = node.volume();
-	if (volume == nullptr) {
-		return voxel::Region::InvalidRegion;
-	}
-	const voxel::Region &region = volume->regionForFlag(voxel::FlagOutline);
-	_selectionRegionCache.set(node.uuid(), region);
-	return region;
+	return node.selection().region();
 }
 
 voxel::Region SceneManager::selectionCalculateRegion(const core::UUID &nodeUUID) const {
@@ -2950,24 +2972,18 @@ void SceneManager::selectionSetEllipse(const core::UUID &nodeUUID) {
 	voxel::Region dirtyRegion = ellipseRegion;
 	core::DynamicArray<glm::ivec3> &history = brush.circle().history();
 	for (const glm::ivec3 &pos : history) {
-		const voxel::Voxel &v = volume->voxel(pos);
-		if (!voxel::isAir(v.getMaterial())) {
-			voxel::Voxel modified = v;
-			modified.setFlags(modified.getFlags() & ~voxel::FlagOutline);
-			volume->setVoxel(pos, modified);
+		if (!voxel::isAir(volume->voxel(pos).getMaterial()) && node->unselect(pos)) {
 			dirtyRegion.accumulate(pos);
 		}
 	}
 	history.clear();
 
 	// Apply the new ellipse selection and record positions
-	auto selectFunc = [&](int x, int y, int z, const voxel::Voxel &v) {
+	auto selectFunc = [&](int x, int y, int z, const voxel::Voxel &) {
 		const glm::ivec3 pos(x, y, z);
 		if (select::Circle::insideSelection(pos, center, radiusU, radiusV, depth, is3D,
 										  uAxis, vAxis, faceAxisIdx, positiveNormal)) {
-			voxel::Voxel modified = v;
-			modified.setFlags(modified.getFlags() | voxel::FlagOutline);
-			volume->setVoxel(x, y, z, modified);
+			node->select(pos);
 			history.push_back(pos);
 		}
 	};
@@ -3156,7 +3172,6 @@ void SceneManager::resetSceneState() {
 			break;
 		}
 	}
-	_selectionRegionCache.invalidate();
 	scenegraph::SceneGraphNode &node = _sceneGraph.node(nodeId);
 	// ensure that the first model node is active and re-select the first model node.
 	// therefore we first "select" the root node, then switch back to the first model node.
@@ -3165,6 +3180,8 @@ void SceneManager::resetSceneState() {
 	_mementoHandler->clearStates();
 	Log::debug("New volume for node %i", nodeId);
 	_mementoHandler->markInitialSceneState(_sceneGraph);
+	_nodeModifications.clear();
+	++_modificationCounter;
 	_dirty = false;
 	*_result = voxelutil::PickResult();
 	_modifier->setCursorVoxel(voxel::createVoxel(node.palette(), 0));
@@ -3398,17 +3415,21 @@ bool SceneManager::setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, vox
 	}
 
 	node.setVolume(volume);
-	// the old volume pointer might no longer be used
+	nodeVolumeChanged(node);
+	return true;
+}
+
+void SceneManager::nodeVolumeChanged(scenegraph::SceneGraphNode &node) {
+	// the old volume pointer or the old region might no longer be used
 	_sceneRenderer->removeNode(node.uuid());
 
-	const voxel::Region& region = volume->region();
+	const voxel::Region& region = node.region();
 
 	_dirty = false; // TODO: why is this not dirty? should it be dirty when the volume changes?
 	*_result = voxelutil::PickResult();
 	setCursorPosition(cursorPosition(), _modifier->cursorFace(), true);
 	setReferencePosition(region.getLowerCenter());
 	resetLastTrace();
-	return true;
 }
 
 bool SceneManager::newScene(bool force, const core::String &name, voxel::RawVolume *v) {
@@ -3567,32 +3588,29 @@ void SceneManager::nodeMoveVoxels(int nodeId, const glm::ivec3& m) {
 		return;
 	}
 	if (hasSelection(_sceneGraph.uuid(nodeId))) {
-		// Move only the selected voxels (those with FlagOutline set)
+		// Move only the selected voxels - and their selection
+		scenegraph::SceneGraphNode &node = _sceneGraph.node(nodeId);
 		const voxel::Region &region = v->region();
-		const glm::ivec3 &mins = region.getLowerCorner();
-		const glm::ivec3 &maxs = region.getUpperCorner();
 
 		// First pass: collect selected voxels and clear them
 		core::DynamicArray<glm::ivec3> positions;
 		core::DynamicArray<voxel::Voxel> voxels;
-		for (int32_t z = mins.z; z <= maxs.z; ++z) {
-			for (int32_t y = mins.y; y <= maxs.y; ++y) {
-				for (int32_t x = mins.x; x <= maxs.x; ++x) {
-					const voxel::Voxel &voxel = v->voxel(x, y, z);
-					if ((voxel.getFlags() & voxel::FlagOutline) != 0) {
-						positions.push_back(glm::ivec3(x, y, z));
-						voxels.push_back(voxel);
-						v->setVoxel(x, y, z, voxel::Voxel());
-					}
-				}
-			}
-		}
+		const voxel::SelectionMask &selection = node.selection();
+		positions.reserve(selection.count());
+		voxels.reserve(selection.count());
+		selection.visit([&](int x, int y, int z) {
+			positions.emplace_back(x, y, z);
+			voxels.push_back(v->voxel(x, y, z));
+			v->setVoxel(x, y, z, voxel::Voxel());
+		});
+		node.clearSelection();
 
 		// Second pass: place voxels at new positions
 		for (size_t i = 0; i < positions.size(); ++i) {
 			const glm::ivec3 newPos = positions[i] + m;
 			if (region.containsPoint(newPos)) {
 				v->setVoxel(newPos, voxels[i]);
+				node.select(newPos);
 			}
 		}
 	} else {
@@ -3854,6 +3872,10 @@ void SceneManager::construct() {
 	core::Var::registerVar(voxEditAnimationPlaying);
 	const core::VarDef voxEditAutoSaveSeconds(cfg::VoxEditAutoSaveSeconds, 180, N_("Autosave delay in seconds"), N_("Delay in second between autosaves - 0 disables autosaves"));
 	_autoSaveSecondsDelay = core::Var::registerVar(voxEditAutoSaveSeconds);
+	const core::VarDef voxEditMementoBudget(cfg::VoxEditMementoBudget, 512, 0, 65536, N_("Undo memory budget"), N_("Megabytes of undo data to keep in memory - older undo states are moved to disk. 0 disables the budget"));
+	_mementoBudget = core::Var::registerVar(voxEditMementoBudget);
+	const core::VarDef voxEditMementoHotStates(cfg::VoxEditMementoHotStates, 8, 1, 64, N_("Undo states in memory"), N_("The amount of the most recent undo steps that are always kept in memory"));
+	_mementoHotStates = core::Var::registerVar(voxEditMementoHotStates);
 	const core::VarDef voxEditTransformUpdateChildren(cfg::VoxEditTransformUpdateChildren, true, N_("Update children"), N_("Update the children of a node when the transform of the node changes"));
 	_transformUpdateChildren = core::Var::registerVar(voxEditTransformUpdateChildren);
 	_maxSuggestedVolumeSize = core::getVar(cfg::VoxEditMaxSuggestedVolumeSize);
@@ -4121,57 +4143,10 @@ void SceneManager::construct() {
 			}
 			const math::Ray &ray = _camera->mouseRay(_mouseCursor);
 			const float rayLength = _camera->farPlane();
-
-			struct OBBHit {
-				int nodeId;
-				float distance;
-			};
-			core::DynamicArray<OBBHit> hits;
-			hits.reserve(_sceneGraph.size());
-
-			for (auto entry : _sceneGraph.nodes()) {
-				const scenegraph::SceneGraphNode &node = entry->second;
-				if (!node.isAnyModelNode() || !node.visible()) {
-					continue;
-				}
-				float distance = 0.0f;
-				const voxel::Region &region = _sceneGraph.resolveRegion(node);
-				const glm::vec3 pivot = node.pivot();
-				const scenegraph::FrameTransform &transform = _sceneGraph.transformForFrame(node, _currentFrameIdx);
-				const math::OBBF &obb = scenegraph::toOBB(true, region, pivot, transform);
-				if (obb.intersect(ray.origin, ray.direction, distance)) {
-					hits.push_back({node.id(), distance});
-				}
-			}
-
-			hits.sort([] (const OBBHit &a, const OBBHit &b) {
-				return a.distance > b.distance;
-			});
-
-			for (const OBBHit &hit : hits) {
-				const scenegraph::SceneGraphNode &node = _sceneGraph.node(hit.nodeId);
-				const voxel::RawVolume *v = _sceneRenderer->volumeForNode(node);
-				if (v == nullptr) {
-					continue;
-				}
-				const glm::mat4 model = _sceneGraph.worldMatrix(node, _currentFrameIdx, true);
-				const glm::mat4 invModel = glm::inverse(model);
-				const glm::vec3 localOrigin = glm::vec3(invModel * glm::vec4(ray.origin, 1.0f));
-				const glm::vec3 localDir = glm::normalize(glm::vec3(invModel * glm::vec4(ray.direction, 0.0f)));
-				static constexpr voxel::Voxel air;
-				bool didHit = false;
-				voxelutil::raycastWithEndpoints(v, localOrigin - voxelutil::RaycastOffset, localOrigin + localDir * rayLength - voxelutil::RaycastOffset, [&] (voxel::RawVolume::Sampler &sampler) {
-					if (!sampler.voxel().isSameType(air)) {
-						didHit = true;
-						return false;
-					}
-					return true;
-				});
-				if (didHit) {
-					scenegraph::SceneGraphNode &hitNode = _sceneGraph.node(hit.nodeId);
-					nodeSetLocked(hit.nodeId, !hitNode.locked());
-					return;
-				}
+			scenegraph::SceneGraphRaycastHit hit;
+			if (_sceneGraph.raycast(ray, rayLength, _currentFrameIdx, hit)) {
+				scenegraph::SceneGraphNode &hitNode = _sceneGraph.node(hit.nodeId);
+				nodeSetLocked(hit.nodeId, !hitNode.locked());
 			}
 		}).setHelp(_("Toggle lock on the hovered node"));
 
@@ -4390,6 +4365,11 @@ void SceneManager::construct() {
 			nodeGroupSelectionGrow();
 		}).setHelp(_("Expand the selection by one voxel in all directions"));
 
+	command::Command::registerCommand("selectionshrink")
+		.setHandler([&] (const command::CommandArgs& args) {
+			nodeGroupSelectionShrink();
+		}).setHelp(_("Remove the selected voxels at the border of the selection"));
+
 	command::Command::registerCommand("setreferenceposition")
 		.addArg({"x", command::ArgType::Int, false, "", "X coordinate"})
 		.addArg({"y", command::ArgType::Int, false, "", "Y coordinate"})
@@ -5426,6 +5406,10 @@ bool SceneManager::init() {
 		Log::error("Failed to initialize the memento handler");
 		return false;
 	}
+	// every instance needs its own journal - it's deleted on shutdown
+	const core::String &journalFile = core::String::format("memento-%s.journal", core::UUID::generate().str().c_str());
+	_mementoHandler->setJournalFile(_filesystem->homeWritePath(journalFile));
+	_mementoHandler->setMemoryBudget((size_t)_mementoBudget->intVal() * 1024u * 1024u, _mementoHotStates->intVal());
 	if (!_sceneRenderer->init()) {
 		Log::error("Failed to initialize the scene renderer");
 		return false;
@@ -5502,9 +5486,12 @@ bool SceneManager::runScriptSync(const core::String &luaCode, const core::Dynami
 			const voxelgenerator::LuaDirtyRegions &dirtyRegions = _luaApi->dirtyRegions();
 			for (const auto &entry : dirtyRegions) {
 				const int dirtyNodeId = entry->key;
-				const voxel::Region &dirtyRegion = entry->value;
-				if (dirtyRegion.isValid()) {
-					modified(dirtyNodeId, dirtyRegion);
+				for (const voxel::Region &dirtyRegion : entry->value) {
+					if (dirtyRegion.isValid()) {
+						// the script wrote the voxels with their selection flags
+						_sceneGraph.node(dirtyNodeId).selectionFromFlags(dirtyRegion);
+						modified(dirtyNodeId, dirtyRegion);
+					}
 				}
 			}
 			_sceneGraph.unregisterListener(&_luaApiListener);
@@ -5947,6 +5934,12 @@ bool SceneManager::update(double nowSeconds) {
 		stepLSystem();
 	}
 	updateDelta(nowSeconds);
+	if (_mementoBudget->isDirty() || _mementoHotStates->isDirty()) {
+		_mementoHandler->setMemoryBudget((size_t)_mementoBudget->intVal() * 1024u * 1024u, _mementoHotStates->intVal());
+		_mementoBudget->markClean();
+		_mementoHotStates->markClean();
+	}
+	_mementoHandler->update();
 	_server.update(nowSeconds);
 	_client.update(nowSeconds);
 	_soundManager->update(nowSeconds);
@@ -5981,9 +5974,12 @@ bool SceneManager::update(double nowSeconds) {
 		const voxelgenerator::LuaDirtyRegions &dirtyRegions = _luaApi->dirtyRegions();
 		for (const auto &entry : dirtyRegions) {
 			const int nodeId = entry->key;
-			const voxel::Region &region = entry->value;
-			if (region.isValid()) {
-				modified(nodeId, region);
+			for (const voxel::Region &region : entry->value) {
+				if (region.isValid()) {
+					// the script wrote the voxels with their selection flags
+					_sceneGraph.node(nodeId).selectionFromFlags(region);
+					modified(nodeId, region);
+				}
 			}
 		}
 		_sceneGraph.unregisterListener(&_luaApiListener);
@@ -6071,7 +6067,6 @@ void SceneManager::shutdown() {
 		Log::error("Lua api listener still registered");
 		_sceneGraph.unregisterListener(&_luaApiListener);
 	}
-	_selectionRegionCache.invalidate();
 	_sceneGraph.clear();
 
 	_camMovement->shutdown();
@@ -6139,7 +6134,7 @@ void SceneManager::stepLSystem() {
 		_lsystemRunning = false;
 		_mementoHandler->endGroup();
 	}
-	modified(_lsystem->nodeId, wrapper.dirtyRegion());
+	modified(_lsystem->nodeId, wrapper.dirtyChunks());
 }
 
 float SceneManager::lsystemProgress() const {
@@ -6339,7 +6334,7 @@ bool SceneManager::mouseRayTrace(bool force, const glm::mat4 &invModel) {
 	// TODO: we could optionally limit the raycast to the selection
 
 	const float offset = voxelutil::RaycastOffset;
-	voxelutil::raycastWithEndpoints(v, ray.origin - offset, ray.origin + dirWithLength - offset, [&] (voxel::RawVolume::Sampler& sampler) {
+	auto visitor = [&] (voxel::RawVolume::Sampler& sampler) {
 		if (!_result->firstValidPosition && sampler.currentPositionValid()) {
 			_result->firstPosition = sampler.position();
 			_result->firstValidPosition = true;
@@ -6396,7 +6391,17 @@ bool SceneManager::mouseRayTrace(bool force, const glm::mat4 &invModel) {
 			return false;
 		}
 		return true;
-	});
+	};
+	// the empty space can only be skipped if the ray doesn't need to detect leaving the locked plane
+	const voxel::VolumeOccupancy *occupancy = nullptr;
+	if (lockedAxis == math::Axis::None && _sceneGraph.resolveVolume(*node) == v) {
+		occupancy = _sceneGraph.resolveOccupancy(*node);
+	}
+	if (occupancy != nullptr) {
+		voxelutil::raycastWithEndpoints(v, *occupancy, ray.origin - offset, ray.origin + dirWithLength - offset, visitor);
+	} else {
+		voxelutil::raycastWithEndpoints(v, ray.origin - offset, ray.origin + dirWithLength - offset, visitor);
+	}
 
 	if (_result->firstInvalidPosition) {
 		if (lockedAxis != math::Axis::None && !_result->didHit) {
@@ -7091,7 +7096,28 @@ bool SceneManager::exceedsMaxSuggestedVolumeSize(const voxel::Region &region) co
 	return region.voxels() > maxVoxels;
 }
 
+bool SceneManager::nodeModifiedSince(const core::UUID &nodeUUID, uint64_t modificationCounter) const {
+	uint64_t counter = 0u;
+	if (!_nodeModifications.get(nodeUUID, counter)) {
+		return false;
+	}
+	return counter > modificationCounter;
+}
+
+void SceneManager::pruneNodeModifications(uint64_t modificationCounter) {
+	core::DynamicArray<core::UUID> removals;
+	for (auto iter = _nodeModifications.begin(); iter != _nodeModifications.end(); ++iter) {
+		if (iter->value <= modificationCounter) {
+			removals.push_back(iter->key);
+		}
+	}
+	for (const core::UUID &nodeUUID : removals) {
+		_nodeModifications.remove(nodeUUID);
+	}
+}
+
 void SceneManager::markDirty() {
+	++_modificationCounter;
 	if (isLocked()) {
 		return;
 	}
@@ -7138,6 +7164,7 @@ bool SceneManager::nodeRemove(scenegraph::SceneGraphNode &node, bool recursive)
 		return false;
 	}
 	_sceneRenderer->removeNode(nodeUUID);
+	_nodeModifications.remove(nodeUUID);
 	if (_sceneGraph.empty()) {
 		const voxel::Region &region = voxel::Region::fromSize(32);
 		scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
@@ -7235,7 +7262,7 @@ bool SceneManager::nodeReduceColors(scenegraph::SceneGraphNode &node, const core
 		}
 	};
 	voxelutil::visitVolumeParallel(wrapper, func);
-	modified(node.id(), wrapper.dirtyRegion());
+	modified(node.id(), wrapper.dirtyChunks());
 	return true;
 }
 
@@ -7256,7 +7283,7 @@ bool SceneManager::nodeRemoveColor(scenegraph::SceneGraphNode &node, uint8_t pal
 			wrapper.setVoxel(x, y, z, replacementVoxel);
 		};
 		voxelutil::visitVolumeParallel(wrapper, func, voxelutil::VisitVoxelColor(palIdx));
-		modified(node.id(), wrapper.dirtyRegion());
+		modified(node.id(), wrapper.dirtyChunks());
 		if (_modifier->cursorVoxel().getColor() == palIdx) {
 			_modifier->setCursorVoxel(replacementVoxel);
 		}
@@ -7361,7 +7388,7 @@ bool SceneManager::nodeQuantizeColors(scenegraph::SceneGraphNode &node, const co
 				}
 			};
 			voxelutil::visitVolumeParallel(wrapper, func);
-			modified(node.id(), wrapper.dirtyRegion());
+			modified(node.id(), wrapper.dirtyChunks());
 
 			// clear the colors that were quantized away
 			for (uint8_t idx : srcPalIdx) {
@@ -7532,7 +7559,7 @@ bool SceneManager::nodeRemoveNormals(int nodeId) {
 			wrapper.setVoxel(x, y, z, newVoxel);
 		};
 		voxelutil::visitVolumeParallel(wrapper, func);
-		modified(node->id(), wrapper.dirtyRegion(), SceneModifiedFlags::NoResetTrace);
+		modified(node->id(), wrapper.dirtyChunks(), SceneModifiedFlags::NoResetTrace);
 		return true;
 	}
 	return false;
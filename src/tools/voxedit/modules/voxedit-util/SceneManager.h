@@ -17,7 +17,6 @@
 #include "io/Filesystem.h"
 #include "io/FormatDescription.h"
 #include "modifier/SceneModifiedFlags.h"
-#include "scenegraph/SceneGraphNodeValueCache.h"
 #include "scenegraph/SceneGraph.h"
 #include "voxedit-util/network/Client.h"
 #include "voxedit-util/network/Server.h"
@@ -25,6 +24,7 @@
 #include "voxedit-util/network/SessionPlayer.h"
 #include "voxel/ClipboardData.h"
 #include "voxel/Connectivity.h"
+#include "voxel/DirtyChunks.h"
 #include "voxel/Region.h"
 #include "image/ImageFwd.h"
 #include "memento/MementoHandler.h"
@@ -153,6 +153,8 @@ protected:
 	bool _fixedCamera = false;
 
 	core::VarPtr _autoSaveSecondsDelay;
+	core::VarPtr _mementoBudget;
+	core::VarPtr _mementoHotStates;
 	core::VarPtr _gridSize;
 	core::VarPtr _transformUpdateChildren;
 	core::VarPtr _maxSuggestedVolumeSize;
@@ -206,7 +208,10 @@ protected:
 	bool _viewportGizmoActive = false;
 	bool _viewportHudHovered = false;
 
-	mutable SceneGraphNodeValueCache<voxel::Region> _selectionRegionCache;
+	/** increased with every change of the scene - see @c nodeModifiedSince() */
+	uint64_t _modificationCounter = 0u;
+	/** the @c _modificationCounter value of the last voxel modification per node */
+	core::DynamicMap<core::UUID, uint64_t, 251, core::UUIDHash> _nodeModifications;
 
 	void autoSelectSolidVoxels(scenegraph::SceneGraphNode *node, const voxel::Region &region);
 	bool loadGlobalClipboard(voxel::ClipboardData &clipData);
@@ -238,6 +243,11 @@ protected:
 	bool setNewVolume(const core::UUID &nodeUUID, voxel::RawVolume *volume, bool deleteMesh = true);
 	void modified(int nodeId, const voxel::Region &modifiedRegion, SceneModifiedFlags flags = SceneModifiedFlags::All,
 				  uint64_t renderRegionMillis = 0);
+	/**
+	 * @brief Handles each coalesced box of the touched chunks like a single modified region. The undo states of all
+	 * boxes are recorded in one memento group.
+	 */
+	void modified(int nodeId, const voxel::DirtyChunks &dirtyChunks, SceneModifiedFlags flags = SceneModifiedFlags::All);
 	voxel::RawVolume *volume(int nodeId);
 	const voxel::RawVolume *volume(int nodeId) const;
 	int addModelAdjacent(int sourceNodeId, voxel::FaceNames face);
@@ -306,6 +316,10 @@ protected:
 						  const core::String &name = "nodeid") const;
 
 	bool setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, voxel::RawVolume *volume);
+	/**
+	 * @brief Reset the states that depend on the volume pointer or the volume region of the node
+	 */
+	void nodeVolumeChanged(scenegraph::SceneGraphNode &node);
 	bool startSceneJob(SceneJobRequest &&request);
 	bool startSceneJob(SceneJobType type, int nodeId);
 	bool startSceneJob(SceneJobType type, const core::UUID &nodeUUID);
@@ -343,6 +357,10 @@ protected:
 	void nodeGroupSelectOnlyCorners();
 	void nodeGroupSelectOnlyWallEdges();
 	void nodeGroupSelectionGrow();
+	/**
+	 * @brief Remove the selected voxels that have an unselected face neighbour from the selection
+	 */
+	void nodeGroupSelectionShrink();
 	void nodeGroupRotate(math::Axis axis);
 	void nodeGroupFlip(math::Axis axis);
 	void nodeGroupResize(const glm::ivec3 &size);
@@ -512,6 +530,8 @@ public:
 
 	void modified(const core::UUID &nodeUUID, const voxel::Region &modifiedRegion,
 				  SceneModifiedFlags flags = SceneModifiedFlags::All, uint64_t renderRegionMillis = 0);
+	void modified(const core::UUID &nodeUUID, const voxel::DirtyChunks &dirtyChunks,
+				  SceneModifiedFlags flags = SceneModifiedFlags::All);
 	voxel::RawVolume *volume(const core::UUID &nodeUUID);
 	const voxel::RawVolume *volume(const core::UUID &nodeUUID) const;
 	palette::Palette &activePalette() const;
@@ -704,6 +724,23 @@ public:
 	bool newScene(bool force, const core::String &name, const voxel::Region &region);
 	int moveNodeToSceneGraph(scenegraph::SceneGraphNode &node, int parent = 0);
 
+	/**
+	 * @brief Increased with every change of the scene (voxels, nodes, transforms, ...) - allows other components to
+	 * poll for changes
+	 * @sa nodeModifiedSince()
+	 */
+	uint64_t modificationCounter() const;
+	/**
+	 * @return @c true if the voxels of the given node were modified after the given @c modificationCounter() value
+	 */
+	bool nodeModifiedSince(const core::UUID &nodeUUID, uint64_t modificationCounter) const;
+	/**
+	 * @brief Forget the voxel modifications of the nodes up to the given @c modificationCounter() value once they
+	 * were handled
+	 * @note The entries of removed nodes are dropped when the node is removed
+	 */
+	void pruneNodeModifications(uint64_t modificationCounter);
+
 	/**
 	 * @return @c true if the scene was modified and not saved yet
 	 */
@@ -949,6 +986,10 @@ inline video::Camera *SceneManager::activeCamera() const {
 	return _camera;
 }
 
+inline uint64_t SceneManager::modificationCounter() const {
+	return _modificationCounter;
+}
+
 inline bool SceneManager::dirty() const {
 	return _dirty;
 }
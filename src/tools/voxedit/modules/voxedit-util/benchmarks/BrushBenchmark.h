@@ -52,6 +52,7 @@ protected:
 		ctx.cursorVoxel = selectedVoxel();
 		ctx.cursorFace = face;
 		ctx.targetVolumeRegion = node->region();
+		ctx.targetSelection = &node->selection();
 
 		voxedit::ModifierVolumeWrapper wrapper(*node, modifierType);
 		scenegraph::SceneGraph sceneGraph;
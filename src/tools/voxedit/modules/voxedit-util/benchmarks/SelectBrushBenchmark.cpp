@@ -43,8 +43,8 @@ class SelectStrategyBenchmark : public BrushBenchmark {
 BENCHMARK_DEFINE_F(SelectBrushBenchmark, All)(benchmark::State &state) {
 	brush.setSelectMode(voxedit::SelectMode::All);
 	for (auto _ : state) {
-		// Clear selection flags before each iteration
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		// Clear the selection before each iteration
+		node->clearSelection();
 		runBrushLifecycle(brush);
 	}
 }
@@ -52,7 +52,7 @@ BENCHMARK_DEFINE_F(SelectBrushBenchmark, All)(benchmark::State &state) {
 BENCHMARK_DEFINE_F(SelectBrushBenchmark, Surface)(benchmark::State &state) {
 	brush.setSelectMode(voxedit::SelectMode::Surface);
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		runBrushLifecycle(brush);
 	}
 }
@@ -60,7 +60,7 @@ BENCHMARK_DEFINE_F(SelectBrushBenchmark, Surface)(benchmark::State &state) {
 BENCHMARK_DEFINE_F(SelectBrushBenchmark, Connected)(benchmark::State &state) {
 	brush.setSelectMode(voxedit::SelectMode::Connected);
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		runBrushLifecycle(brush);
 	}
 }
@@ -100,7 +100,7 @@ BENCHMARK_DEFINE_F(SelectStrategyBenchmark, AllGenerate)(benchmark::State &state
 	voxedit::select::AABBBrushState brushState;
 
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 		strategy.generate(sceneGraph, wrapper, ctx, node->region(), brushState);
 	}
@@ -114,7 +114,7 @@ BENCHMARK_DEFINE_F(SelectStrategyBenchmark, SurfaceGenerate)(benchmark::State &s
 	voxedit::select::AABBBrushState brushState;
 
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 		strategy.generate(sceneGraph, wrapper, ctx, node->region(), brushState);
 	}
@@ -130,7 +130,7 @@ BENCHMARK_DEFINE_F(SelectStrategyBenchmark, ConnectedGenerate)(benchmark::State
 	voxedit::select::AABBBrushState brushState;
 
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 		strategy.generate(sceneGraph, wrapper, ctx, node->region(), brushState);
 	}
@@ -189,7 +189,7 @@ BENCHMARK_DEFINE_F(CircleSelectLargeBenchmark, Radius80)(benchmark::State &state
 	const voxel::Region circleRegion = strategy.calcRegion(ctx, brushState);
 
 	for (auto _ : state) {
-		node->volume()->removeFlags(node->region(), voxel::FlagOutline);
+		node->clearSelection();
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 		strategy.generate(sceneGraph, wrapper, ctx, circleRegion, brushState);
 	}
@@ -55,7 +55,7 @@ public:
 BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, CaptureSnapshot)(benchmark::State &state) {
 	for (auto _ : state) {
 		voxedit::SnapshotHelper helper;
-		helper.captureSnapshot(node->volume(), node->region());
+		helper.captureSnapshot(node->volume(), node->selection(), node->region());
 		benchmark::DoNotOptimize(helper.snapshotVoxelCount());
 	}
 }
@@ -76,9 +76,10 @@ BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, WriteAndRevert)(benchmark::State &st
 			}
 		}
 		fillSurface(*vol, _halfSize);
+		node->selectionFromFlags(region);
 
 		voxedit::SnapshotHelper helper;
-		helper.captureSnapshot(vol, region);
+		helper.captureSnapshot(vol, node->selection(), region);
 
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 		state.ResumeTiming();
@@ -112,9 +113,10 @@ BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, RestoreHistory)(benchmark::State &st
 			}
 		}
 		fillSurface(*vol, _halfSize);
+		node->selectionFromFlags(region);
 
 		voxedit::SnapshotHelper helper;
-		helper.captureSnapshot(vol, region);
+		helper.captureSnapshot(vol, node->selection(), region);
 
 		voxedit::ModifierVolumeWrapper wrapper(*node, ModifierType::Override);
 
@@ -126,7 +128,7 @@ BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, RestoreHistory)(benchmark::State &st
 		}
 		state.ResumeTiming();
 
-		helper.restoreHistory(vol, wrapper);
+		helper.restoreHistory(wrapper);
 		voxel::Voxel voxel = vol->voxel(0, 0, 0);
 		benchmark::DoNotOptimize(voxel);
 	}
@@ -134,7 +136,7 @@ BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, RestoreHistory)(benchmark::State &st
 
 BENCHMARK_DEFINE_F(SnapshotHelperBenchmark, AdjustForRegionShift)(benchmark::State &state) {
 	voxedit::SnapshotHelper helper;
-	helper.captureSnapshot(node->volume(), node->region());
+	helper.captureSnapshot(node->volume(), node->selection(), node->region());
 
 	int shift = 1;
 	for (auto _ : state) {
@@ -207,12 +209,12 @@ public:
 BENCHMARK_DEFINE_F(SnapshotHelperLargeBenchmark, CaptureSnapshot)(benchmark::State &state) {
 	for (auto _ : state) {
 		voxedit::SnapshotHelper helper;
-		helper.captureSnapshot(node->volume(), node->region());
+		helper.captureSnapshot(node->volume(), node->selection(), node->region());
 		benchmark::DoNotOptimize(helper.snapshotVoxelCount());
 	}
 }
 
-// Sequential baseline: uses visitVolume (non-parallel) + one-by-one setVoxel
+// Baseline: scans the whole volume for the selection flags + one-by-one setVoxel
 BENCHMARK_DEFINE_F(SnapshotHelperLargeBenchmark, CaptureSnapshotSequential)(benchmark::State &state) {
 	for (auto _ : state) {
 		voxel::SparseVolume snapshot;
@@ -326,7 +326,7 @@ bool Modifier::execute(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGrap
 		return true;
 	}
 
-	preExecuteBrush(volume);
+	preExecuteBrush(volume, &node.selection());
 	const voxel::Voxel cursorVoxel = _brushContext.cursorVoxel;
 	if (_brushContext.modifierType == ModifierType::NormalPaint) {
 		_brushContext.cursorVoxel.setNormal(_brushContext.normalIndex);
@@ -373,13 +373,14 @@ static glm::ivec3 updateCursor(const voxel::Region &region, const voxel::Region
 	return cursor + delta;
 }
 
-void Modifier::preExecuteBrush(const voxel::RawVolume *volume) {
+void Modifier::preExecuteBrush(const voxel::RawVolume *volume, const voxel::SelectionMask *selection) {
 	core_trace_scoped(ModifierPrepareBrush);
 	Brush *brush = currentBrush();
 	if (!brush) {
 		return;
 	}
 	_brushContext.targetVolumeRegion = volume->region();
+	_brushContext.targetSelection = selection;
 	_brushContext.prevCursorPosition = _brushContext.cursorPosition;
 	if (brush->clampToVolume()) {
 		const voxel::Region brushRegion = brush->calcRegion(_brushContext);
@@ -387,6 +388,7 @@ void Modifier::preExecuteBrush(const voxel::RawVolume *volume) {
 			updateCursor(_brushContext.targetVolumeRegion, brushRegion, _brushContext.prevCursorPosition);
 	}
 	brush->preExecute(_brushContext, volume);
+	_brushContext.targetSelection = nullptr;
 }
 
 bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node,
@@ -407,6 +409,10 @@ bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::Scen
 		_brushContext.cursorPosition = updateCursor(_brushContext.targetVolumeRegion, brushRegion, prevCursorPos);
 	}
 	_brushContext.cursorVoxel = voxel;
+	if (!preview) {
+		// the selection belongs to the node - a picked voxel must not bring its selection flag along
+		_brushContext.cursorVoxel.setFlags(voxel.getFlags() & ~voxel::FlagOutline);
+	}
 	brush->execute(sceneGraph, wrapper, _brushContext);
 	const bool isPlacementBrush = brush->type() != BrushType::Select && brush->type() != BrushType::Paint
 		&& brush->type() != BrushType::Normal;
@@ -431,7 +437,11 @@ bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::Scen
 					}
 				}
 			} else {
-				callback(modifiedRegion, _brushContext.modifierType, flags);
+				// only report the touched chunks - two dabs in opposite corners of the volume shouldn't
+				// lead to re-extracting and snapshotting everything in between
+				for (const voxel::Region &r : wrapper.dirtyRegions()) {
+					callback(r, _brushContext.modifierType, flags);
+				}
 			}
 		}
 	}
@@ -537,6 +547,8 @@ void Modifier::abort() {
 			}
 			const voxel::Region dirtyRegion = brush->revertChanges(volume);
 			if (dirtyRegion.isValid()) {
+				// the reverted voxels bring their selection flags back
+				node.selectionFromFlags(dirtyRegion);
 				_sceneMgr->modified(node.uuid(), dirtyRegion, SceneModifiedFlags::NoUndo);
 			}
 		});
@@ -640,7 +652,7 @@ void Modifier::flushPendingBrushChanges() {
 	resetPreview();
 	brush->markClean();
 	voxel::RawVolume *activeVolume = node->volume();
-	preExecuteBrush(activeVolume);
+	preExecuteBrush(activeVolume, &node->selection());
 	executeBrush(sceneGraph, *node, _brushContext.modifierType, _brushContext.cursorVoxel,
 		[this, &sceneGraph](const voxel::Region &region, ModifierType, SceneModifiedFlags flags) {
 			_sceneMgr->modified(sceneGraph.activeNodeUUID(), region, flags);
@@ -180,7 +180,7 @@ public:
 	 */
 	bool beginBrushFromPanel();
 
-	void preExecuteBrush(const voxel::RawVolume *volume);
+	void preExecuteBrush(const voxel::RawVolume *volume, const voxel::SelectionMask *selection);
 
 	/**
 	 * @brief Execute the brush operation on the given node volume
@@ -17,7 +17,7 @@ namespace voxedit {
  * @brief A wrapper for a @c voxel::RawVolume that performs a sanity check for
  * the @c setVoxel() call and uses the @c ModifierType value to perform the
  * desired action for the @c setVoxel() call.
- * The sanity check also includes the voxel's FlagOutline that is used to limit the
+ * The sanity check also includes the selection of the node that is used to limit the
  * area of the @c voxel::RawVolume that is affected by the @c setVoxel() call.
  */
 class ModifierVolumeWrapper : public voxel::RawVolumeWrapper {
@@ -25,6 +25,7 @@ private:
 	using Super = voxel::RawVolumeWrapper;
 	const ModifierType _modifierType;
 	scenegraph::SceneGraphNode &_node;
+	const voxel::SelectionMask &_selection;
 
 	bool _erase;
 	bool _override;
@@ -42,27 +43,29 @@ private:
 		if (_box3DSelectionRegion.isValid() && _box3DSelectionRegion.containsPoint(pos)) {
 			return false;
 		}
-		const voxel::Voxel &voxel = _volume->voxel(pos.x, pos.y, pos.z);
 		// Voxel is explicitly selected
-		if (voxel.getFlags() & voxel::FlagOutline) {
+		if (_selection.test(pos.x, pos.y, pos.z)) {
 			return false;
 		}
 		// Air position: allow only if directly adjacent to a selected solid voxel (Place mode only).
 		// Override/Paint/Erase operate on existing voxels, so air is always skipped.
+		const voxel::Voxel &voxel = _volume->voxel(pos.x, pos.y, pos.z);
 		if (voxel::isAir(voxel.getMaterial())) {
 			if (_override) {
 				return true;
 			}
 			for (const auto &off : voxel::arrayPathfinderFaces) {
 				const glm::ivec3 n(pos.x + off.x, pos.y + off.y, pos.z + off.z);
-				const voxel::Voxel &nv = _volume->voxel(n.x, n.y, n.z);
-				if (!voxel::isAir(nv.getMaterial()) && (nv.getFlags() & voxel::FlagOutline)) {
+				if (!_selection.test(n)) {
+					continue;
+				}
+				if (!voxel::isAir(_volume->voxel(n.x, n.y, n.z).getMaterial())) {
 					return false;
 				}
 			}
 			return true;
 		}
-		// Solid voxel without FlagOutline
+		// Solid voxel that is not selected
 		return true;
 	}
 
@@ -111,128 +114,84 @@ public:
 			if (existingFlags & voxel::FlagOutline) {
 				_currentVoxel->setFlags(existingFlags);
 			}
-			voxel::Region &dirtyRegion = _volume->_dirtyRegion;
-			if (dirtyRegion.isValid()) {
-				dirtyRegion.accumulate(_posInVolume);
-			} else {
-				dirtyRegion = voxel::Region(_posInVolume.x, _posInVolume.y, _posInVolume.z, _posInVolume.x, _posInVolume.y, _posInVolume.z);
-			}
+			_volume->markDirty(_posInVolume);
 			return true;
 		}
 	};
 
 	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType,
 						  const voxel::Region &box3DSelectionRegion = voxel::Region::InvalidRegion)
-		: Super(node.volume()), _modifierType(modifierType), _node(node) {
+		: Super(node.volume()), _modifierType(modifierType), _node(node), _selection(node.selection()) {
 		_erase = _modifierType == ModifierType::Erase;
 		_override = _modifierType == ModifierType::Override;
 		_paint = _modifierType == ModifierType::Paint;
 		_normalPaint = _modifierType == ModifierType::NormalPaint;
-		_hasSelection = _node.hasSelection();
+		_hasSelection = !_selection.empty();
 		_box3DSelectionRegion = box3DSelectionRegion;
 	}
 	scenegraph::SceneGraphNode &node() const {
 		return _node;
 	}
 
-	inline ModifierType modifierType() const {
-		return _modifierType;
+	inline const voxel::SelectionMask &selection() const {
+		return _selection;
 	}
 
-	/**
-	 * @brief Set flags on voxels in the given region and mark it dirty
-	 */
-	void setFlags(const voxel::Region &region, uint8_t flags) {
-		_volume->setFlags(region, flags);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(region);
-		} else {
-			_dirtyRegion = region;
-		}
+	inline bool isSelected(const glm::ivec3 &pos) const {
+		return _selection.test(pos);
 	}
 
-	/**
-	 * @brief Remove flags from voxels in the given region and mark it dirty
-	 */
-	void removeFlags(const voxel::Region &region, uint8_t flags) {
-		_volume->removeFlags(region, flags);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(region);
-		} else {
-			_dirtyRegion = region;
-		}
+	inline ModifierType modifierType() const {
+		return _modifierType;
 	}
 
 	/**
-	 * @brief Toggle flags on voxels in the given region and mark it dirty
+	 * @brief Add the solid voxel at the given position to the selection of the node and mark it dirty
+	 * @note This directly modifies the volume, bypassing the Sampler validation
+	 * @return @c true if the voxel was selected, @c false for air or if it was already selected
 	 */
-	void toggleFlags(const voxel::Region &region, uint8_t flags) {
-		_volume->toggleFlags(region, flags);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(region);
-		} else {
-			_dirtyRegion = region;
+	bool selectAt(int x, int y, int z) {
+		const glm::ivec3 pos(x, y, z);
+		if (voxel::isAir(_volume->voxel(pos).getMaterial())) {
+			return false;
 		}
+		if (!_node.select(pos)) {
+			return false;
+		}
+		markDirty(pos);
+		return true;
 	}
 
 	/**
-	 * @brief Check if any voxel in the given region has the specified flags
-	 */
-	bool hasFlags(const voxel::Region &region, uint8_t flags) const {
-		return _volume->hasFlags(region, flags);
-	}
-
-	/**
-	 * @brief Set flags on a single voxel at the given position and mark it dirty
+	 * @brief Remove the solid voxel at the given position from the selection of the node and mark it dirty
 	 * @note This directly modifies the volume, bypassing the Sampler validation
-	 * @return true if the voxel was modified (not air, or not already set), false otherwise
+	 * @return @c true if the voxel was unselected, @c false for air or if it wasn't selected
 	 */
-	bool setFlagAt(int x, int y, int z, uint8_t flags) {
-		voxel::RawVolume::Sampler sampler(_volume);
-		if (!sampler.setPosition(x, y, z)) {
-			return false;
-		}
-		voxel::Voxel v = sampler.voxel();
-		if (voxel::isAir(v.getMaterial())) {
+	bool unselectAt(int x, int y, int z) {
+		const glm::ivec3 pos(x, y, z);
+		if (voxel::isAir(_volume->voxel(pos).getMaterial())) {
 			return false;
 		}
-		if ((v.getFlags() & flags) == flags) {
+		if (!_node.unselect(pos)) {
 			return false;
 		}
-		v.setFlags(v.getFlags() | flags);
-		sampler.setVoxel(v);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(x, y, z);
-		} else {
-			_dirtyRegion = voxel::Region(x, y, z, x, y, z);
-		}
+		markDirty(pos);
 		return true;
 	}
 
 	/**
-	 * @brief Remove flags from a single voxel at the given position and mark it dirty
+	 * @brief Replace the voxel at the given position and mark it dirty - the selection of the node follows the
+	 * @c voxel::FlagOutline of the new voxel
 	 * @note This directly modifies the volume, bypassing the Sampler validation
-	 * @return true if the voxel was modified (not air, or not already cleared), false otherwise
 	 */
-	bool removeFlagAt(int x, int y, int z, uint8_t flags) {
-		voxel::RawVolume::Sampler sampler(_volume);
-		if (!sampler.setPosition(x, y, z)) {
+	bool writeVoxel(const glm::ivec3 &pos, const voxel::Voxel &voxel) {
+		const bool modified = _volume->setVoxel(pos, voxel);
+		const bool selectionModified =
+			(voxel.getFlags() & voxel::FlagOutline) ? _node.select(pos) : _node.unselect(pos);
+		if (!modified && !selectionModified) {
 			return false;
 		}
-		voxel::Voxel v = sampler.voxel();
-		if (voxel::isAir(v.getMaterial())) {
-			return false;
-		}
-		if ((v.getFlags() & flags) == 0) {
-			return false;
-		}
-		v.setFlags(v.getFlags() & ~flags);
-		sampler.setVoxel(v);
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(x, y, z);
-		} else {
-			_dirtyRegion = voxel::Region(x, y, z, x, y, z);
-		}
+		markDirty(pos);
 		return true;
 	}
 
@@ -241,13 +200,17 @@ public:
 	 * adjacent to an originally selected voxel. Called once per brush execution.
 	 */
 	void growSelectionToNewVoxels() {
-		if (!_hasSelection || !_dirtyRegion.isValid()) {
+		if (!_hasSelection || !dirtyRegion().isValid()) {
 			return;
 		}
 		auto func = [this](int x, int y, int z, const voxel::Voxel & /*solidVoxel*/) {
-			setFlagAt(x, y, z, voxel::FlagOutline);
+			selectAt(x, y, z);
 		};
-		voxelutil::visitVolumeParallel(*this, _dirtyRegion, func, voxelutil::VisitSolid());
+		// only visit the touched chunks - they are already marked dirty, so selectAt() doesn't extend them. The
+		// selection mask is not thread safe - that's why this isn't done in parallel.
+		for (const voxel::Region &region : dirtyRegions()) {
+			voxelutil::visitVolume(*this, region, func, voxelutil::VisitSolid());
+		}
 	}
 
 	/**
@@ -255,16 +218,20 @@ public:
 	 * Used by auto-select to select newly placed shapes.
 	 */
 	void autoSelectNewVoxels() {
-		if (!_dirtyRegion.isValid()) {
+		if (!dirtyRegion().isValid()) {
 			return;
 		}
 		if (_hasSelection) {
 			_node.clearSelection();
 		}
 		auto func = [this](int x, int y, int z, const voxel::Voxel & /*solidVoxel*/) {
-			setFlagAt(x, y, z, voxel::FlagOutline);
+			selectAt(x, y, z);
 		};
-		voxelutil::visitVolumeParallel(*this, _dirtyRegion, func, voxelutil::VisitSolid());
+		// only visit the touched chunks - they are already marked dirty, so selectAt() doesn't extend them. The
+		// selection mask is not thread safe - that's why this isn't done in parallel.
+		for (const voxel::Region &region : dirtyRegions()) {
+			voxelutil::visitVolume(*this, region, func, voxelutil::VisitSolid());
+		}
 	}
 
 	bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) override {
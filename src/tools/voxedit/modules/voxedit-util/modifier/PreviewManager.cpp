@@ -240,7 +240,13 @@ void PreviewManager::updateBrushVolumePreview(Modifier &modifier, palette::Palet
 		return;
 	}
 
-	modifier.preExecuteBrush(activeVolume);
+	const voxel::SelectionMask *selection = nullptr;
+	if (const scenegraph::SceneGraphNode *activeNode = sceneGraph.findNodeByUUID(sceneGraph.activeNodeUUID())) {
+		if (activeNode->volume() == activeVolume) {
+			selection = &activeNode->selection();
+		}
+	}
+	modifier.preExecuteBrush(activeVolume, selection);
 	const voxel::Region &region = brush->calcRegion(brushContext);
 	if (!region.isValid()) {
 		return;
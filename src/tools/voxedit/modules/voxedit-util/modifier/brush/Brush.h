@@ -26,6 +26,10 @@ namespace scenegraph {
 class SceneGraph;
 }
 
+namespace voxel {
+class SelectionMask;
+}
+
 namespace voxedit {
 
 class ModifierVolumeWrapper;
@@ -75,6 +79,11 @@ struct BrushContext {
 
 	/** Used for clamping the brush region to stay within the target volume boundaries */
 	voxel::Region targetVolumeRegion;
+	/**
+	 * The selection of the target node - @c nullptr if it's not known. Only valid
+	 * during @c Brush::preExecute() - the node might not outlive the brush execution.
+	 */
+	const voxel::SelectionMask *targetSelection = nullptr;
 
 	/** The position of the cursor before any clamping or brush execution was applied */
 	glm::ivec3 prevCursorPosition{0};
@@ -3,8 +3,6 @@
  */
 
 #include "ExtrudeBrush.h"
-#include "app/App.h"
-#include "app/ForParallel.h"
 #include "core/Common.h"
 #include "math/Axis.h"
 #include "voxedit-util/modifier/ModifierVolumeWrapper.h"
@@ -13,8 +11,8 @@
 #include "voxel/Face.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
+#include "voxel/SelectionMask.h"
 #include "voxel/Voxel.h"
-#include "voxelutil/VolumeVisitor.h"
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace voxedit {
@@ -110,7 +108,10 @@ void ExtrudeBrush::endBrush(BrushContext &) {
 			}
 		}
 		for (const glm::ivec3 &pos : toPrune) {
-			_lastVolume->setVoxel(pos, air);
+			// keep the selection flag - the node selection isn't available here and must still match the flags
+			voxel::Voxel prunedVoxel = air;
+			prunedVoxel.setFlags(_lastVolume->voxel(pos).getFlags());
+			_lastVolume->setVoxel(pos, prunedVoxel);
 		}
 	}
 	_lastVolume = nullptr;
@@ -139,7 +140,7 @@ void ExtrudeBrush::preExecute(const BrushContext &ctx, const voxel::RawVolume *v
 	// Build the full selection cache (positions + wall candidates) once when
 	// the face is set and no cache exists yet. Subsequent frames reuse it.
 	if (!_hasCachedSelection && _face != voxel::FaceNames::Max) {
-		cacheSelection(volume, volRegion);
+		cacheSelection(volume, ctx.targetSelection, volRegion);
 	}
 
 	// Use cached bbox for calcRegion() if available
@@ -230,53 +231,29 @@ void ExtrudeBrush::setOffsetV(int offset) {
 	markDirty();
 }
 
-void ExtrudeBrush::cacheSelection(const voxel::RawVolume *vol, const voxel::Region &volRegion) {
+void ExtrudeBrush::cacheSelection(const voxel::RawVolume *vol, const voxel::SelectionMask *selection,
+								  const voxel::Region &volRegion) {
 	_cachedSelectedPositions.clear();
 	_cachedWallCandidates.clear();
 	_hasCachedSelection = false;
 
-	if (_face == voxel::FaceNames::Max) {
+	if (_face == voxel::FaceNames::Max || selection == nullptr) {
 		return;
 	}
 
-	// Collect selected (FlagOutline) voxel positions using parallel scan.
-	// Each thread collects into its own array - no locks needed.
-	const int zStart = volRegion.getLowerZ();
-	const int zEnd = volRegion.getUpperZ() + 1;
-	const int zRange = zEnd - zStart;
-	const int threadCount = app::App::getInstance()->threads();
-	const int chunkCount = (threadCount > 1 && zRange > 1) ? core_min(threadCount, zRange) : 1;
-
-	core::DynamicArray<core::DynamicArray<glm::ivec3>> threadResults;
-	threadResults.resize(chunkCount);
-
-	app::for_parallel(0, chunkCount, [&](int chunkStart, int chunkEnd) {
-		for (int chunk = chunkStart; chunk < chunkEnd; ++chunk) {
-			const int sliceStart = zStart + (zRange * chunk) / chunkCount;
-			const int sliceEnd = zStart + (zRange * (chunk + 1)) / chunkCount;
-			const voxel::Region subRegion(
-				volRegion.getLowerX(), volRegion.getLowerY(), sliceStart,
-				volRegion.getUpperX(), volRegion.getUpperY(), sliceEnd - 1);
-			voxelutil::visitVolume(*vol, subRegion,
-				[&threadResults, chunk](int x, int y, int z, const voxel::Voxel &) {
-					threadResults[chunk].push_back(glm::ivec3(x, y, z));
-				},
-				voxelutil::VisitSolidOutline());
-		}
-	});
-
-	// Merge results
+	// Collect the selected solid voxel positions - only the selected bricks are visited
 	glm::ivec3 selLo(volRegion.getUpperCorner());
 	glm::ivec3 selHi(volRegion.getLowerCorner());
-	PositionSet selectedSet;
-	for (auto &arr : threadResults) {
-		for (const glm::ivec3 &pos : arr) {
-			_cachedSelectedPositions.push_back(pos);
-			selectedSet.insert(pos);
-			selLo = glm::min(selLo, pos);
-			selHi = glm::max(selHi, pos);
+	_cachedSelectedPositions.reserve(selection->count());
+	selection->visit([&](int x, int y, int z) {
+		if (!volRegion.containsPoint(x, y, z) || voxel::isAir(vol->voxel(x, y, z).getMaterial())) {
+			return;
 		}
-	}
+		const glm::ivec3 pos(x, y, z);
+		_cachedSelectedPositions.push_back(pos);
+		selLo = glm::min(selLo, pos);
+		selHi = glm::max(selHi, pos);
+	});
 
 	if (_cachedSelectedPositions.empty()) {
 		return;
@@ -310,7 +287,7 @@ void ExtrudeBrush::cacheSelection(const voxel::RawVolume *vol, const voxel::Regi
 			if (voxel::isAir(nv.getMaterial())) {
 				continue;
 			}
-			if (selectedSet.has(neighborPos)) {
+			if (selection->test(neighborPos)) {
 				continue;
 			}
 			_cachedWallCandidates.push_back({selPos, perpOffsets[pi]});
@@ -348,8 +325,7 @@ void ExtrudeBrush::writeVoxel(ModifierVolumeWrapper &wrapper, PositionSet &saved
 		_history.push_back({pos, vol->voxel(pos)});
 		savedPositions.insert(pos);
 	}
-	vol->setVoxel(pos, newVoxel);
-	wrapper.addToDirtyRegion(pos);
+	wrapper.writeVoxel(pos, newVoxel);
 }
 
 void ExtrudeBrush::generate(scenegraph::SceneGraph &, ModifierVolumeWrapper &wrapper, const BrushContext &ctx,
@@ -359,18 +335,8 @@ void ExtrudeBrush::generate(scenegraph::SceneGraph &, ModifierVolumeWrapper &wra
 
 	// Step 1: Restore all positions modified by the previous generate() call.
 	// This makes depth/offset changes fully reversible without touching the undo stack.
-	// Track the bounding box of all restored positions for dirty region.
-	const voxel::Region &volRegion = vol->region();
-	glm::ivec3 dirtyLo(volRegion.getUpperCorner());
-	glm::ivec3 dirtyHi(volRegion.getLowerCorner());
 	for (const voxel::VoxelPosition &entry : _history) {
-		vol->setVoxel(entry.pos, entry.voxel);
-		dirtyLo = glm::min(dirtyLo, entry.pos);
-		dirtyHi = glm::max(dirtyHi, entry.pos);
-	}
-	if (!_history.empty()) {
-		wrapper.addToDirtyRegion(dirtyLo);
-		wrapper.addToDirtyRegion(dirtyHi);
+		wrapper.writeVoxel(entry.pos, entry.voxel);
 	}
 	_history.clear();
 
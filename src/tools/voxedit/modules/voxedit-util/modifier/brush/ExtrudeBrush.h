@@ -55,7 +55,7 @@ private:
 	};
 	core::DynamicArray<WallCandidate> _cachedWallCandidates;
 
-	// Cached bounding box of selected (FlagOutline) voxels, computed in preExecute().
+	// Cached bounding box of the selected voxels, computed in preExecute().
 	// Used by calcRegion() to return a tight preview region instead of the full volume.
 	voxel::Region _cachedSelBBox;
 	bool _cachedSelBBoxValid = false;
@@ -64,7 +64,8 @@ private:
 	// Volume region lower corner when cache was captured (to detect region shifts)
 	glm::ivec3 _capturedVolumeLower{0};
 
-	void cacheSelection(const voxel::RawVolume *vol, const voxel::Region &volRegion);
+	void cacheSelection(const voxel::RawVolume *vol, const voxel::SelectionMask *selection,
+						const voxel::Region &volRegion);
 	void adjustCacheForRegionShift(const glm::ivec3 &delta);
 	void writeVoxel(ModifierVolumeWrapper &wrapper, PositionSet &savedPositions, const glm::ivec3 &pos, const voxel::Voxel &newVoxel);
 
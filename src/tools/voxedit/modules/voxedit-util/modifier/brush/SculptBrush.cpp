@@ -18,10 +18,10 @@
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
+#include "voxel/SelectionMask.h"
 #include "voxel/SparseVolume.h"
 #include "voxel/Voxel.h"
 #include "voxelutil/VolumeSculpt.h"
-#include "voxelutil/VolumeVisitor.h"
 
 namespace voxedit {
 
@@ -42,8 +42,7 @@ void SculptBrush::onSceneChange() {
 void SculptBrush::onActivated() {
 	reset();
 	// Suppress undo registration during preview - only the final commit should create an undo entry.
-	// Also skip InvalidateNodeCache: selection bounding box does not change during sculpt preview,
-	// and regionForFlag() scans the full volume which is very expensive on large models.
+	// Also skip InvalidateNodeCache: the node caches don't need to be rebuilt for every sculpt preview.
 	_sceneModifiedFlags = SceneModifiedFlags::NoUndo & ~SceneModifiedFlags::InvalidateNodeCache;
 }
 
@@ -144,7 +143,7 @@ void SculptBrush::preExecute(const BrushContext &ctx, const voxel::RawVolume *vo
 	if (!_hasSnapshot && volume != nullptr) {
 		// Defer snapshot capture until there is actually work to do.
 		if (_paramsDirty) {
-			captureSnapshot(volume, ctx.targetVolumeRegion);
+			captureSnapshot(volume, ctx.targetSelection, ctx.targetVolumeRegion);
 		}
 	} else if (_hasSnapshot) {
 		const glm::ivec3 delta = ctx.targetVolumeRegion.getLowerCorner() - _capturedVolumeLower;
@@ -211,39 +210,34 @@ voxel::Region SculptBrush::calcRegion(const BrushContext &ctx) const {
 	return ctx.targetVolumeRegion;
 }
 
-void SculptBrush::captureSnapshot(const voxel::RawVolume *volume, const voxel::Region &volRegion) {
+void SculptBrush::captureSnapshot(const voxel::RawVolume *volume, const voxel::SelectionMask *selection,
+								  const voxel::Region &volRegion) {
 	core_trace_scoped(SculptBrushCaptureSnapshot);
 	_snapshotEntries.clear();
 
-	// Use regionForFlag to get tight bounding box of selected voxels first.
-	// This avoids scanning the entire volume (e.g. 256^3 = 16M voxels) when the
-	// selection is a small fraction of the volume (e.g. 100x100x5 = 50K voxels).
-	const voxel::Region selectionBounds = volume->regionForFlag(voxel::FlagOutline);
-	if (!selectionBounds.isValid()) {
+	// Only the selected voxels are visited - this doesn't depend on the size of the volume
+	if (selection == nullptr || selection->empty()) {
 		_hasSnapshot = false;
 		return;
 	}
+	_snapshotEntries.reserve(selection->count());
 
-	// Scan only the tight selection bounding box
-	voxel::Region scanRegion = selectionBounds;
-	scanRegion.cropTo(volRegion);
+	glm::ivec3 selLo(volRegion.getUpperCorner());
+	glm::ivec3 selHi(volRegion.getLowerCorner());
 
-	// Pre-allocate to avoid repeated reallocations during push_back.
-	// The actual count will be <= voxels in the scan region.
-	_snapshotEntries.reserve(scanRegion.voxels());
-
-	glm::ivec3 selLo(scanRegion.getUpperCorner());
-	glm::ivec3 selHi(scanRegion.getLowerCorner());
-
-	voxelutil::visitVolume(
-		*volume, scanRegion,
-		[&](int x, int y, int z, const voxel::Voxel &voxel) {
-			const glm::ivec3 pos(x, y, z);
-			_snapshotEntries.push_back({pos, voxel});
-			selLo = glm::min(selLo, pos);
-			selHi = glm::max(selHi, pos);
-		},
-		voxelutil::VisitSolidOutline());
+	selection->visit([&](int x, int y, int z) {
+		if (!volRegion.containsPoint(x, y, z)) {
+			return;
+		}
+		const voxel::Voxel &voxel = volume->voxel(x, y, z);
+		if (voxel::isAir(voxel.getMaterial())) {
+			return;
+		}
+		const glm::ivec3 pos(x, y, z);
+		_snapshotEntries.push_back({pos, voxel});
+		selLo = glm::min(selLo, pos);
+		selHi = glm::max(selHi, pos);
+	});
 
 	if (_snapshotEntries.empty()) {
 		_hasSnapshot = false;
@@ -296,9 +290,7 @@ void SculptBrush::writeVoxel(ModifierVolumeWrapper &wrapper, const glm::ivec3 &p
 		return;
 	}
 	saveToHistory(volume, pos);
-	if (volume->setVoxel(pos, newVoxel)) {
-		wrapper.addToDirtyRegion(pos);
-	}
+	wrapper.writeVoxel(pos, newVoxel);
 }
 
 void SculptBrush::rebuildCachedBitVolume() {
@@ -360,45 +352,33 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 		voxelutil::sculptReskin(workSolid, voxelMap, *_skinVolume, _flattenFace, _reskinConfig,
 							   skinPal, skinPal != nullptr ? &nodePal : nullptr);
 
-		// Write back directly to volume, bypassing per-voxel writeVoxel/saveToHistory overhead.
+		// Write back bypassing the per-voxel saveToHistory() dedup overhead.
 		// SparseVolume iteration has no duplicates, so no dedup check needed.
 		// Pre-allocate history to avoid repeated reallocations for large entries.
 		voxel::RawVolume *vol = wrapper.volume();
 		const voxel::Region &volRegion = vol->region();
 		_historyEntries.reserve(voxelMap.size());
-		voxel::Region dirtyRegion;
 		struct ReskinWriter {
-			voxel::RawVolume *vol;
+			ModifierVolumeWrapper *wrapper;
 			const voxel::Region *volRegion;
 			voxel::DynamicVoxelArray *historyEntries;
-			voxel::Region *dirtyRegion;
 			bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) {
 				if (!volRegion->containsPoint(x, y, z)) {
 					return true;
 				}
+				const glm::ivec3 pos(x, y, z);
 				// Save original voxel to history (flat array, no hash)
-				historyEntries->push_back({glm::ivec3(x, y, z), vol->voxel(x, y, z)});
-				// Write new voxel directly to volume
+				historyEntries->push_back({pos, wrapper->volume()->voxel(pos)});
 				voxel::Voxel v = voxel;
 				if (voxel::isBlocked(v.getMaterial())) {
 					v.setFlags(voxel::FlagOutline);
 				}
-				vol->setVoxel(x, y, z, v);
-				if (dirtyRegion->isValid()) {
-					dirtyRegion->accumulate(x, y, z);
-				} else {
-					*dirtyRegion = voxel::Region(x, y, z, x, y, z);
-				}
+				wrapper->writeVoxel(pos, v);
 				return true;
 			}
 		};
-		ReskinWriter writer{vol, &volRegion, &_historyEntries, &dirtyRegion};
+		ReskinWriter writer{&wrapper, &volRegion, &_historyEntries};
 		voxelMap.copyTo(writer);
-		// Accumulate dirty bounding box via two corner points (no Region overload exists)
-		if (dirtyRegion.isValid()) {
-			wrapper.addToDirtyRegion(dirtyRegion.getLowerCorner());
-			wrapper.addToDirtyRegion(dirtyRegion.getUpperCorner());
-		}
 		return;
 	}
 
@@ -427,7 +407,7 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 					continue;
 				}
 				const voxel::Voxel &v = vol->voxel(neighbor);
-				if (voxel::isBlocked(v.getMaterial()) && !(v.getFlags() & voxel::FlagOutline)) {
+				if (voxel::isBlocked(v.getMaterial()) && !wrapper.isSelected(neighbor)) {
 					anchorSolid.setVoxel(neighbor, true);
 				}
 			}
@@ -448,7 +428,6 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 									fillVoxel, _smoothWallClearDepth, _smoothWallInterp, _smoothWallFillHoles,
 									addedPositions);
 		const voxel::Voxel air;
-		voxel::Region dirtyRegion;
 		_historyEntries.reserve(_snapshotEntries.size() + addedPositions.size());
 
 		// Removed entries (was in snapshot, no longer in currentSolid)
@@ -458,13 +437,7 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 					continue;
 				}
 				saveToHistory(vol, entry.pos);
-				if (vol->setVoxel(entry.pos, air)) {
-					if (dirtyRegion.isValid()) {
-						dirtyRegion.accumulate(entry.pos);
-					} else {
-						dirtyRegion = voxel::Region(entry.pos, entry.pos);
-					}
-				}
+				wrapper.writeVoxel(entry.pos, air);
 			}
 		}
 		// Added entries: collected during sculptSmoothWall
@@ -482,18 +455,7 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 			voxel::Voxel v = cv;
 			v.setFlags(voxel::FlagOutline);
 			saveToHistory(vol, pos);
-			if (vol->setVoxel(pos, v)) {
-				if (dirtyRegion.isValid()) {
-					dirtyRegion.accumulate(pos);
-				} else {
-					dirtyRegion = voxel::Region(pos, pos);
-				}
-			}
-		}
-		// Single bulk dirty-region update (2 calls instead of N)
-		if (dirtyRegion.isValid()) {
-			wrapper.addToDirtyRegion(dirtyRegion.getLowerCorner());
-			wrapper.addToDirtyRegion(dirtyRegion.getUpperCorner());
+			wrapper.writeVoxel(pos, v);
 		}
 		return;
 	}
@@ -544,7 +506,7 @@ void SculptBrush::applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext
 							continue;
 						}
 						const voxel::Voxel &v = vol->voxel(neighbor);
-						if (voxel::isBlocked(v.getMaterial()) && !(v.getFlags() & voxel::FlagOutline)) {
+						if (voxel::isBlocked(v.getMaterial()) && !wrapper.isSelected(neighbor)) {
 							anchorSolid.setVoxel(neighbor, true);
 						}
 					}
@@ -690,9 +652,7 @@ void SculptBrush::generate(scenegraph::SceneGraph &, ModifierVolumeWrapper &wrap
 	// Restore previously modified state from flat history array (O(N) sequential iteration,
 	// no hash chain traversal). This undoes the previous sculpt so we re-apply from scratch.
 	for (const voxel::VoxelPosition &entry : _historyEntries) {
-		if (vol->setVoxel(entry.pos, entry.voxel)) {
-			wrapper.addToDirtyRegion(entry.pos);
-		}
+		wrapper.writeVoxel(entry.pos, entry.voxel);
 	}
 	_historyEntries.clear();
 
@@ -884,7 +844,7 @@ void SculptBrush::paintExtendPlane(ModifierVolumeWrapper &wrapper, const BrushCo
 						continue;
 					}
 					const voxel::Voxel &vx = vol->voxel(pos);
-					if (!voxel::isAir(vx.getMaterial()) && (vx.getFlags() & voxel::FlagOutline) == 0) {
+					if (!voxel::isAir(vx.getMaterial()) && !wrapper.isSelected(pos)) {
 						writeVoxel(wrapper, pos, air);
 					}
 				}
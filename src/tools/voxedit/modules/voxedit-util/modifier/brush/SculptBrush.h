@@ -147,7 +147,8 @@ private:
 	voxel::Region _cachedRegion;
 	bool _cachedRegionValid = false;
 
-	void captureSnapshot(const voxel::RawVolume *volume, const voxel::Region &volRegion);
+	void captureSnapshot(const voxel::RawVolume *volume, const voxel::SelectionMask *selection,
+						 const voxel::Region &volRegion);
 	void adjustSnapshotForRegionShift(const glm::ivec3 &delta);
 	void applySculpt(ModifierVolumeWrapper &wrapper, const BrushContext &ctx);
 	void saveToHistory(voxel::RawVolume *vol, const glm::ivec3 &pos);
@@ -3,73 +3,39 @@
  */
 
 #include "SnapshotHelper.h"
-#include "app/App.h"
-#include "app/ForParallel.h"
 #include "core/Common.h"
 #include "core/Trace.h"
 #include "voxedit-util/modifier/ModifierVolumeWrapper.h"
 #include "voxel/DynamicVoxelArray.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
-#include "voxelutil/VolumeVisitor.h"
+#include "voxel/SelectionMask.h"
 
 namespace voxedit {
 
-void SnapshotHelper::captureSnapshot(const voxel::RawVolume *volume, const voxel::Region &volRegion) {
+void SnapshotHelper::captureSnapshot(const voxel::RawVolume *volume, const voxel::SelectionMask &selection,
+									 const voxel::Region &volRegion) {
 	core_trace_scoped(SnapshotHelperCaptureSnapshot);
 	_snapshot.clear();
 
-	// Parallel scan: split Z-axis into chunks, each thread collects into its own array.
-	// No locks needed - each thread writes to its own DynamicVoxelArray.
-	const int zStart = volRegion.getLowerZ();
-	const int zEnd = volRegion.getUpperZ() + 1;
-	const int zRange = zEnd - zStart;
-
-	if (zRange <= 0) {
-		_hasSnapshot = false;
-		return;
-	}
-
-	// Determine chunk count based on available threads
-	const int threadCount = app::App::getInstance()->threads();
-	const int chunkCount = (threadCount > 1) ? core_min(threadCount, zRange) : 1;
-
-	core::DynamicArray<voxel::DynamicVoxelArray> threadResults;
-	threadResults.resize(chunkCount);
-
-	app::for_parallel(0, chunkCount, [&](int chunkStart, int chunkEnd) {
-		for (int chunk = chunkStart; chunk < chunkEnd; ++chunk) {
-			const int sliceStart = zStart + (zRange * chunk) / chunkCount;
-			const int sliceEnd = zStart + (zRange * (chunk + 1)) / chunkCount;
-			const voxel::Region subRegion(
-				volRegion.getLowerX(), volRegion.getLowerY(), sliceStart,
-				volRegion.getUpperX(), volRegion.getUpperY(), sliceEnd - 1);
-			voxelutil::visitVolume(*volume, subRegion,
-				[&threadResults, chunk](int x, int y, int z, const voxel::Voxel &voxel) {
-					threadResults[chunk].push_back({glm::ivec3(x, y, z), voxel});
-				},
-				voxelutil::VisitSolidOutline());
+	// Only the selected positions are visited - this scales with the selection and not with the volume size
+	voxel::DynamicVoxelArray collected;
+	collected.reserve(selection.count());
+	selection.visit([&](int x, int y, int z) {
+		if (!volRegion.containsPoint(x, y, z)) {
+			return;
+		}
+		const voxel::Voxel &voxel = volume->voxel(x, y, z);
+		if (voxel::isAir(voxel.getMaterial())) {
+			return;
 		}
+		collected.push_back({glm::ivec3(x, y, z), voxel});
 	});
-
-	// Merge thread-local results
-	size_t totalCount = 0;
-	for (const auto &arr : threadResults) {
-		totalCount += arr.size();
-	}
-	if (totalCount == 0) {
+	if (collected.empty()) {
 		_hasSnapshot = false;
 		return;
 	}
 
-	voxel::DynamicVoxelArray collected;
-	collected.reserve(totalCount);
-	for (auto &arr : threadResults) {
-		for (const voxel::VoxelPosition &vp : arr) {
-			collected.push_back(vp);
-		}
-	}
-
 	// Compute bounding box
 	glm::ivec3 selLo(collected[0].pos);
 	glm::ivec3 selHi(collected[0].pos);
@@ -132,9 +98,7 @@ void SnapshotHelper::writeVoxel(ModifierVolumeWrapper &wrapper, const glm::ivec3
 		return;
 	}
 	saveToHistory(volume, pos);
-	if (volume->setVoxel(pos, newVoxel)) {
-		wrapper.addToDirtyRegion(pos);
-	}
+	wrapper.writeVoxel(pos, newVoxel);
 }
 
 voxel::Region SnapshotHelper::revertChanges(voxel::RawVolume *volume) {
@@ -144,18 +108,15 @@ voxel::Region SnapshotHelper::revertChanges(voxel::RawVolume *volume) {
 	return wrapper.dirtyRegion();
 }
 
-void SnapshotHelper::restoreHistory(voxel::RawVolume *vol, ModifierVolumeWrapper &wrapper) {
+void SnapshotHelper::restoreHistory(ModifierVolumeWrapper &wrapper) {
 	struct HistoryRestorer {
-		voxel::RawVolume *vol;
 		ModifierVolumeWrapper *wrapper;
 		bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) {
-			if (vol->setVoxel(x, y, z, voxel)) {
-				wrapper->addToDirtyRegion(glm::ivec3(x, y, z));
-			}
+			wrapper->writeVoxel(glm::ivec3(x, y, z), voxel);
 			return true;
 		}
 	};
-	HistoryRestorer restorer{vol, &wrapper};
+	HistoryRestorer restorer{&wrapper};
 	_history.copyTo(restorer);
 	_history.clear();
 }
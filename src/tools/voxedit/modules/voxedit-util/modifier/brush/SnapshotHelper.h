@@ -13,6 +13,7 @@
 namespace voxel {
 class RawVolume;
 class RawVolumeWrapper;
+class SelectionMask;
 } // namespace voxel
 
 namespace voxedit {
@@ -53,9 +54,10 @@ public:
 	}
 
 	/**
-	 * @brief Capture selected voxels (FlagOutline) from the volume into the snapshot
+	 * @brief Capture the selected solid voxels of the volume into the snapshot
 	 */
-	void captureSnapshot(const voxel::RawVolume *volume, const voxel::Region &volRegion);
+	void captureSnapshot(const voxel::RawVolume *volume, const voxel::SelectionMask &selection,
+						 const voxel::Region &volRegion);
 
 	/**
 	 * @brief Adjust snapshot and history positions when the volume region shifts
@@ -84,7 +86,7 @@ public:
 	 * Used at the start of generate() to undo the previous frame's changes
 	 * before re-applying the operation from the snapshot.
 	 */
-	void restoreHistory(voxel::RawVolume *vol, ModifierVolumeWrapper &wrapper);
+	void restoreHistory(ModifierVolumeWrapper &wrapper);
 
 	/**
 	 * @brief Clear all snapshot and history state
@@ -144,8 +144,9 @@ void StampBrush::setSize(const glm::ivec3 &size) {
 		return;
 	}
 	if (_volume) {
-		_volume = voxelutil::resize(_volume, voxel::Region(glm::ivec3(0), size - 1));
-		_volume->translate(-_volume->region().getLowerCorner());
+		if (!voxelutil::resize(*_volume, voxel::Region(glm::ivec3(0), size - 1))) {
+			return;
+		}
 		markDirty();
 	}
 }
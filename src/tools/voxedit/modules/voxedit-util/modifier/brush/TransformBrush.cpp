@@ -95,8 +95,8 @@ bool TransformBrush::active() const {
 }
 
 void TransformBrush::preExecute(const BrushContext &ctx, const voxel::RawVolume *volume) {
-	if (!_snapshotHelper.hasSnapshot() && volume != nullptr) {
-		_snapshotHelper.captureSnapshot(volume, ctx.targetVolumeRegion);
+	if (!_snapshotHelper.hasSnapshot() && volume != nullptr && ctx.targetSelection != nullptr) {
+		_snapshotHelper.captureSnapshot(volume, *ctx.targetSelection, ctx.targetVolumeRegion);
 		if (_snapshotHelper.hasSnapshot()) {
 			const voxel::Region &sr = _snapshotHelper.snapshotRegion();
 			_snapshotCenter = glm::vec3(sr.getLowerCorner() + sr.getUpperCorner()) * 0.5f;
@@ -402,7 +402,7 @@ void TransformBrush::generate(scenegraph::SceneGraph &, ModifierVolumeWrapper &w
 	_lastVolume = vol;
 
 	// Restore previously transformed state before re-applying
-	_snapshotHelper.restoreHistory(vol, wrapper);
+	_snapshotHelper.restoreHistory(wrapper);
 
 	// Apply the current transform from the original snapshot
 	applyTransform(wrapper, ctx);
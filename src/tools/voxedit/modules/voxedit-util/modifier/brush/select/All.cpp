@@ -13,13 +13,13 @@ void All::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper &wr
 				   const voxel::Region &region, const AABBBrushState &state) {
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::VisitSolid condition;
-	voxelutil::visitVolumeParallel(wrapper, region, func, condition);
+	voxelutil::visitVolume(wrapper, region, func, condition);
 }
 
 bool All::needsAdditionalAction(const BrushContext &ctx) const {
@@ -17,13 +17,13 @@ void Box3D::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper &
 					 const voxel::Region &region, const AABBBrushState &state) {
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::VisitSolid condition;
-	voxelutil::visitVolumeParallel(wrapper, region, func, condition);
+	voxelutil::visitVolume(wrapper, region, func, condition);
 	if (wrapper.modifierType() == ModifierType::Erase) {
 		_selectionRegion = voxel::Region::InvalidRegion;
 	} else {
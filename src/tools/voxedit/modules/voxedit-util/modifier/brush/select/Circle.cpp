@@ -128,9 +128,9 @@ void Circle::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper
 	auto circleFunc = [&](int x, int y, int z, const voxel::Voxel &v) {
 		if (inBounds(x, y, z)) {
 			if (wrapper.modifierType() == ModifierType::Erase) {
-				wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+				wrapper.unselectAt(x, y, z);
 			} else {
-				wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+				wrapper.selectAt(x, y, z);
 			}
 			_ellipseHistory.push_back(glm::ivec3(x, y, z));
 		}
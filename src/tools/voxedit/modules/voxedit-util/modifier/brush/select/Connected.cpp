@@ -18,16 +18,12 @@ void Connected::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapp
 		return;
 	}
 	const glm::ivec3 &startPos = ctx.cursorPosition;
-	if (wrapper.modifierType() == ModifierType::Erase) {
-		wrapper.removeFlagAt(startPos.x, startPos.y, startPos.z, voxel::FlagOutline);
-	} else {
-		wrapper.setFlagAt(startPos.x, startPos.y, startPos.z, voxel::FlagOutline);
-	}
+	// the span based flood fill also visits the start position
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::visitConnectedByCondition(wrapper, startPos, func);
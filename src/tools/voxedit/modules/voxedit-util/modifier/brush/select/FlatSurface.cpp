@@ -22,9 +22,9 @@ void FlatSurface::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWra
 	}
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::visitFlatSurface(wrapper, startPos, ctx.cursorFace, _flatDeviation, func);
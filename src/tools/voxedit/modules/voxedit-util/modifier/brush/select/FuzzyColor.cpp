@@ -20,14 +20,14 @@ void FuzzyColor::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrap
 	}
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	const palette::Palette &palette = wrapper.node().palette();
 	voxelutil::VisitVoxelFuzzyColor condition(palette, referenceVoxel.getColor(), _colorThreshold);
-	voxelutil::visitVolumeParallel(wrapper, region, func, condition);
+	voxelutil::visitVolume(wrapper, region, func, condition);
 }
 
 } // namespace select
@@ -177,14 +177,14 @@ void Lasso::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper &
 		}
 	});
 
-	// Sequential phase: apply flags from collected positions
+	// Sequential phase: the selection mask is not thread safe
 	const bool erase = wrapper.modifierType() == ModifierType::Erase;
 	for (const auto &results : chunkResults) {
 		for (const glm::ivec3 &pos : results) {
 			if (erase) {
-				wrapper.removeFlagAt(pos.x, pos.y, pos.z, voxel::FlagOutline);
+				wrapper.unselectAt(pos.x, pos.y, pos.z);
 			} else {
-				wrapper.setFlagAt(pos.x, pos.y, pos.z, voxel::FlagOutline);
+				wrapper.selectAt(pos.x, pos.y, pos.z);
 			}
 		}
 	}
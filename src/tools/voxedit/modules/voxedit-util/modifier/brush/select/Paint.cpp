@@ -69,9 +69,9 @@ void Paint::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper &
 		_growRegion && wrapper.modifierType() != ModifierType::Erase && (_hadSelection || _dirtyRegion.isValid());
 	auto func = [&wrapper](int x, int y, int z) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::VisitSolid condition;
@@ -86,10 +86,8 @@ void Paint::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper &
 			bool hasSelectedNeighbor = false;
 			for (const glm::ivec3 &off : ::voxel::arrayPathfinderFaces) {
 				const glm::ivec3 npos(x + off.x, y + off.y, z + off.z);
-				if (ctx.targetVolumeRegion.containsPoint(npos)) {
-					const ::voxel::Voxel &neighborVoxel = wrapper.voxel(npos);
-					if (!::voxel::isAir(neighborVoxel.getMaterial()) &&
-						(neighborVoxel.getFlags() & ::voxel::FlagOutline)) {
+				if (ctx.targetVolumeRegion.containsPoint(npos) && wrapper.isSelected(npos)) {
+					if (!::voxel::isAir(wrapper.voxel(npos).getMaterial())) {
 						hasSelectedNeighbor = true;
 						break;
 					}
@@ -19,13 +19,13 @@ void SameColor::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapp
 	}
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
 	voxelutil::VisitVoxelColor condition(referenceVoxel);
-	voxelutil::visitVolumeParallel(wrapper, region, func, condition);
+	voxelutil::visitVolume(wrapper, region, func, condition);
 }
 
 } // namespace select
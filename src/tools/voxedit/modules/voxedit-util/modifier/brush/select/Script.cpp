@@ -54,11 +54,14 @@ void Script::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper
 	const voxelgenerator::LuaDirtyRegions &dirtyRegions = _activeLuaMode->dirtyRegions();
 	for (const auto &entry : dirtyRegions) {
 		const int dirtyNodeId = entry->key;
-		const voxel::Region &dirtyRegion = entry->value;
-		if (dirtyNodeId == InvalidNodeId || !dirtyRegion.isValid()) {
+		if (dirtyNodeId == InvalidNodeId) {
 			continue;
 		}
-		_sceneManager->modified(_sceneManager->sceneGraph().uuid(dirtyNodeId), dirtyRegion);
+		for (const voxel::Region &dirtyRegion : entry->value) {
+			if (dirtyRegion.isValid()) {
+				_sceneManager->modified(_sceneManager->sceneGraph().uuid(dirtyNodeId), dirtyRegion);
+			}
+		}
 	}
 }
 
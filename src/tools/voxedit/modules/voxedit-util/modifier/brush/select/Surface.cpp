@@ -13,12 +13,12 @@ void Surface::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrapper
 					   const voxel::Region &region, const AABBBrushState &state) {
 	auto func = [&wrapper](int x, int y, int z, const voxel::Voxel &voxel) {
 		if (wrapper.modifierType() == ModifierType::Erase) {
-			wrapper.removeFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.unselectAt(x, y, z);
 		} else {
-			wrapper.setFlagAt(x, y, z, voxel::FlagOutline);
+			wrapper.selectAt(x, y, z);
 		}
 	};
-	voxelutil::visitSurfaceVolumeParallel(wrapper, func);
+	voxelutil::visitSurfaceVolume(wrapper, func);
 }
 
 } // namespace select
@@ -97,6 +97,10 @@ public:
 		nodeGroupSelectionGrow();
 	}
 
+	void testSelectionShrink() {
+		nodeGroupSelectionShrink();
+	}
+
 	void testFlip(math::Axis axis) {
 		nodeGroupFlip(axis);
 	}
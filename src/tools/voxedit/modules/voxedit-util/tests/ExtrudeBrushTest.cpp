@@ -39,6 +39,7 @@ protected:
 		ctx.modifierType = modifierType;
 		scenegraph::SceneGraph sceneGraph;
 		ModifierVolumeWrapper wrapper(node, modifierType);
+		ctx.targetSelection = &node.selection();
 		brush.preExecute(ctx, wrapper.volume());
 		brush.execute(sceneGraph, wrapper, ctx);
 		brush.endBrush(ctx);
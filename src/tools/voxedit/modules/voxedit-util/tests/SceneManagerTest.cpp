@@ -22,6 +22,7 @@
 #include "util/VarUtil.h"
 #include "video/Camera.h"
 #include "voxel/RawVolume.h"
+#include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include "voxelformat/Format.h"
@@ -174,6 +175,33 @@ TEST_F(SceneManagerTest, testNewScene) {
 	EXPECT_TRUE(_sceneMgr->newScene(true, "newscene", voxel::Region{0, 1}));
 }
 
+TEST_F(SceneManagerTest, testNodeModifications) {
+	ASSERT_TRUE(_sceneMgr->newScene(true, "modifications", voxel::Region{0, 3}));
+	const core::UUID nodeUUID = _sceneMgr->sceneGraph().uuid(_sceneMgr->sceneGraph().activeNode());
+	const uint64_t start = _sceneMgr->modificationCounter();
+	_sceneMgr->modified(nodeUUID, voxel::Region{0, 1});
+	EXPECT_GT(_sceneMgr->modificationCounter(), start);
+	EXPECT_TRUE(_sceneMgr->nodeModifiedSince(nodeUUID, start));
+	EXPECT_FALSE(_sceneMgr->nodeModifiedSince(nodeUUID, _sceneMgr->modificationCounter()));
+
+	// other changes of the scene increase the counter but don't count as voxel modification
+	const uint64_t modified = _sceneMgr->modificationCounter();
+	EXPECT_TRUE(_sceneMgr->nodeRename(nodeUUID, "renamed"));
+	EXPECT_GT(_sceneMgr->modificationCounter(), modified);
+	EXPECT_FALSE(_sceneMgr->nodeModifiedSince(nodeUUID, modified));
+
+	_sceneMgr->pruneNodeModifications(_sceneMgr->modificationCounter());
+	EXPECT_FALSE(_sceneMgr->nodeModifiedSince(nodeUUID, 0u)) << "The handled modifications must be removed";
+
+	const int secondNodeId = _sceneMgr->addModelChild("second node", 1, 1, 1);
+	ASSERT_NE(InvalidNodeId, secondNodeId);
+	const core::UUID secondUUID = _sceneMgr->sceneGraph().uuid(secondNodeId);
+	_sceneMgr->modified(secondUUID, voxel::Region{0, 0});
+	EXPECT_TRUE(_sceneMgr->nodeModifiedSince(secondUUID, 0u));
+	ASSERT_TRUE(_sceneMgr->nodeRemove(secondUUID, false));
+	EXPECT_FALSE(_sceneMgr->nodeModifiedSince(secondUUID, 0u)) << "The modifications of removed nodes must be removed";
+}
+
 TEST_F(SceneManagerTest, testNodeCropAsyncMatchesSync) {
 	const voxel::Region sourceRegion(0, 0, 0, 4, 4, 4);
 	ASSERT_TRUE(_sceneMgr->newScene(true, "sync", sourceRegion));
@@ -235,6 +263,31 @@ TEST_F(SceneManagerTest, testNodeCropAsyncUndoRedo) {
 	EXPECT_EQ(croppedRegion, testVolume()->region());
 }
 
+TEST_F(SceneManagerTest, testModifiedDirtyChunksUndo) {
+	const voxel::Region region(0, 127);
+	ASSERT_TRUE(_sceneMgr->newScene(true, "dirtychunks", region));
+	const int nodeId = _sceneMgr->sceneGraph().activeNode();
+	ASSERT_NE(nullptr, testVolume());
+	{
+		voxel::RawVolumeWrapper wrapper(testVolume());
+		wrapper.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		wrapper.setVoxel(126, 126, 126, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+		ASSERT_EQ(2u, wrapper.dirtyRegions().size());
+		_sceneMgr->modified(_sceneMgr->sceneGraph().uuid(nodeId), wrapper.dirtyChunks());
+	}
+	EXPECT_EQ(1, testVolume()->voxel(1, 1, 1).getColor());
+	EXPECT_EQ(2, testVolume()->voxel(126, 126, 126).getColor());
+
+	// both boxes are recorded in one memento group
+	ASSERT_TRUE(_sceneMgr->undo());
+	EXPECT_TRUE(voxel::isAir(testVolume()->voxel(1, 1, 1).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(testVolume()->voxel(126, 126, 126).getMaterial()));
+
+	ASSERT_TRUE(_sceneMgr->redo());
+	EXPECT_EQ(1, testVolume()->voxel(1, 1, 1).getColor());
+	EXPECT_EQ(2, testVolume()->voxel(126, 126, 126).getColor());
+}
+
 TEST_F(SceneManagerTest, testSceneJobQueueCropThenScaleUp) {
 	const voxel::Region sourceRegion(0, 0, 0, 4, 4, 4);
 	ASSERT_TRUE(_sceneMgr->newScene(true, "sync", sourceRegion));
@@ -1923,6 +1976,29 @@ TEST_F(SceneManagerTest, testSelectionGrowNoSelection) {
 	// No-op when no selection exists
 }
 
+TEST_F(SceneManagerTest, testSelectionShrink) {
+	const voxel::Region region{0, 5};
+	ASSERT_TRUE(_sceneMgr->newScene(true, "selectionshrink_test", region));
+	const int nodeId = _sceneMgr->sceneGraph().activeNode();
+	voxel::RawVolume *v = _sceneMgr->volume(_sceneMgr->sceneGraph().uuid(nodeId));
+	ASSERT_NE(nullptr, v);
+	v->fill(voxel::createVoxel(voxel::VoxelType::Generic, 1));
+
+	scenegraph::SceneGraphNode *node = _sceneMgr->sceneGraphModelNode(nodeId);
+	ASSERT_NE(nullptr, node);
+	node->select(voxel::Region(1, 3));
+	EXPECT_EQ(voxel::Region(1, 3), _sceneMgr->selectionCalculateRegion(node->uuid()));
+
+	sceneMgr()->testSelectionShrink();
+	// only the center of the 3x3x3 selection has no unselected face neighbour
+	EXPECT_EQ(voxel::Region(2, 2), _sceneMgr->selectionCalculateRegion(node->uuid()));
+	EXPECT_TRUE(_sceneMgr->isSelected(node->uuid(), glm::ivec3(2)));
+	EXPECT_EQ(0, v->voxel(1, 2, 2).getFlags() & voxel::FlagOutline);
+
+	sceneMgr()->testSelectionShrink();
+	EXPECT_FALSE(_sceneMgr->hasSelection(node->uuid()));
+}
+
 TEST_F(SceneManagerTest, testHollow) {
 	const voxel::Region region{0, 5};
 	ASSERT_TRUE(_sceneMgr->newScene(true, "hollow_test", region));
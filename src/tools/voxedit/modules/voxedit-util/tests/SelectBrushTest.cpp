@@ -363,12 +363,8 @@ TEST_F(SelectBrushTest, testSelectModeFlatSurface_deviation) {
 			<< "Upper voxel at (" << x << ",1,0) should NOT be selected with deviation=0";
 	}
 
-	// Clear selection flags for the next part of the test
-	for (int x = -2; x <= 0; ++x) {
-		voxel::Voxel v = volume.voxel(x, 0, 0);
-		v.setFlags(v.getFlags() & ~voxel::FlagOutline);
-		volume.setVoxel(x, 0, 0, v);
-	}
+	// Clear the selection for the next part of the test
+	node.clearSelection();
 
 	// With deviation=1: both floors should be reachable (step of 1 in Y from start)
 	brush.flatSurface().setDeviation(1);
@@ -8,6 +8,7 @@
 #include "voxedit-util/modifier/ModifierType.h"
 #include "voxedit-util/modifier/ModifierVolumeWrapper.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SelectionMask.h"
 #include "voxel/Voxel.h"
 
 namespace voxedit {
@@ -23,6 +24,12 @@ protected:
 	static voxel::Voxel solidVoxel(uint8_t color = 2) {
 		return voxel::createVoxel(voxel::VoxelType::Generic, color);
 	}
+
+	static voxel::SelectionMask selectionOf(const voxel::RawVolume &volume) {
+		voxel::SelectionMask selection;
+		selection.readFlags(volume, volume.region(), voxel::FlagOutline);
+		return selection;
+	}
 };
 
 TEST_F(SnapshotHelperTest, testCaptureSnapshot) {
@@ -32,7 +39,7 @@ TEST_F(SnapshotHelperTest, testCaptureSnapshot) {
 	volume.setVoxel(2, 0, 0, selectedVoxel());
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	ASSERT_TRUE(helper.hasSnapshot());
 	EXPECT_EQ(3u, helper.snapshotVoxelCount());
@@ -47,17 +54,36 @@ TEST_F(SnapshotHelperTest, testCaptureSnapshotIgnoresNonOutline) {
 	volume.setVoxel(1, 0, 0, selectedVoxel());
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	ASSERT_TRUE(helper.hasSnapshot());
 	EXPECT_EQ(1u, helper.snapshotVoxelCount());
 }
 
+TEST_F(SnapshotHelperTest, testCaptureSnapshotUsesSelection) {
+	voxel::RawVolume volume(voxel::Region(-5, 5));
+	volume.setVoxel(0, 0, 0, selectedVoxel());
+	volume.setVoxel(1, 0, 0, solidVoxel());
+	volume.setVoxel(2, 0, 0, solidVoxel());
+
+	// the flags are not queried - only the solid voxels of the selection are captured
+	voxel::SelectionMask selection;
+	selection.set(glm::ivec3(1, 0, 0));
+	selection.set(glm::ivec3(3, 0, 0));
+
+	SnapshotHelper helper;
+	helper.captureSnapshot(&volume, selection, volume.region());
+
+	ASSERT_TRUE(helper.hasSnapshot());
+	EXPECT_EQ(1u, helper.snapshotVoxelCount());
+	EXPECT_EQ(voxel::Region(1, 0, 0, 1, 0, 0), helper.snapshotRegion());
+}
+
 TEST_F(SnapshotHelperTest, testCaptureEmptyVolume) {
 	voxel::RawVolume volume(voxel::Region(-5, 5));
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	EXPECT_FALSE(helper.hasSnapshot());
 	EXPECT_EQ(0u, helper.snapshotVoxelCount());
@@ -72,7 +98,7 @@ TEST_F(SnapshotHelperTest, testWriteVoxelSavesToHistory) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Write a new voxel at an existing position
 	voxel::Voxel newVoxel = selectedVoxel(5);
@@ -81,6 +107,12 @@ TEST_F(SnapshotHelperTest, testWriteVoxelSavesToHistory) {
 	// History should have the original voxel
 	EXPECT_FALSE(helper.historyEmpty());
 	EXPECT_EQ(5, volume.voxel(0, 0, 0).getColor());
+
+	// the selection of the node follows the written voxels
+	helper.writeVoxel(wrapper, glm::ivec3(1, 0, 0), selectedVoxel(6));
+	EXPECT_TRUE(node.selection().test(1, 0, 0));
+	helper.writeVoxel(wrapper, glm::ivec3(1, 0, 0), solidVoxel());
+	EXPECT_FALSE(node.selection().test(1, 0, 0));
 }
 
 TEST_F(SnapshotHelperTest, testWriteVoxelOutOfBounds) {
@@ -106,7 +138,7 @@ TEST_F(SnapshotHelperTest, testRevertChanges) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Overwrite voxels
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(10));
@@ -132,14 +164,14 @@ TEST_F(SnapshotHelperTest, testRestoreHistory) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Write new voxel
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(10));
 	EXPECT_EQ(10, volume.voxel(0, 0, 0).getColor());
 
 	// Restore history (like generate() does between frames)
-	helper.restoreHistory(&volume, wrapper);
+	helper.restoreHistory(wrapper);
 	EXPECT_EQ(1, volume.voxel(0, 0, 0).getColor());
 	EXPECT_TRUE(helper.historyEmpty());
 }
@@ -150,7 +182,7 @@ TEST_F(SnapshotHelperTest, testAdjustForRegionShift) {
 	volume.setVoxel(1, 0, 0, selectedVoxel());
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	ASSERT_TRUE(helper.hasSnapshot());
 	EXPECT_EQ(glm::ivec3(0, 0, 0), helper.snapshotRegion().getLowerCorner());
@@ -179,7 +211,7 @@ TEST_F(SnapshotHelperTest, testAdjustForRegionShiftWithHistory) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Create history entry by writing
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(10));
@@ -202,7 +234,7 @@ TEST_F(SnapshotHelperTest, testClear) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(10));
 
 	ASSERT_TRUE(helper.hasSnapshot());
@@ -224,7 +256,7 @@ TEST_F(SnapshotHelperTest, testSaveToHistoryDeduplicates) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Write twice to same position
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(10));
@@ -248,7 +280,7 @@ TEST_F(SnapshotHelperTest, testWriteVoxelToAirPosition) {
 	ModifierVolumeWrapper wrapper(node, ModifierType::Override);
 
 	SnapshotHelper helper;
-	helper.captureSnapshot(&volume, volume.region());
+	helper.captureSnapshot(&volume, selectionOf(volume), volume.region());
 
 	// Write to air position - history should track the air voxel
 	helper.writeVoxel(wrapper, glm::ivec3(0, 0, 0), selectedVoxel(5));
@@ -25,6 +25,7 @@ protected:
 		ctx.modifierType = ModifierType::Override;
 		scenegraph::SceneGraph sceneGraph;
 		ModifierVolumeWrapper wrapper(node, ModifierType::Override);
+		ctx.targetSelection = &node.selection();
 		brush.preExecute(ctx, wrapper.volume());
 		brush.execute(sceneGraph, wrapper, ctx);
 	}